@@ -60,6 +60,7 @@
 #include "base/globals.h"
 #include "base/logging.h"
 #include "base/os.h"
+#include "base/time_utils.h"
 #include "cmdline_types.h"
 #include "exec_utils.h"
 #include "file_utils.h"
@@ -963,15 +964,22 @@ ndk::ScopedAStatus Artd::dexopt(
   LOG(INFO) << "Running dex2oat: " << Join(art_exec_args.Get(), /*separator=*/" ")
             << "\nOpened FDs: " << fd_logger;
 
+  // The paused time of `cancellation_signal` when dex2oat starts. Only the time spent paused after
+  // that is excluded from the timeout.
+  int64_t paused_time_at_start_ms = 0;
   ExecCallbacks callbacks{
       .on_start =
           [&](pid_t pid) {
             std::lock_guard<std::mutex> lock(cancellation_signal->mu_);
             cancellation_signal->pids_.insert(pid);
+            paused_time_at_start_ms = cancellation_signal->GetPausedTimeMs();
             // Handle cancellation signals sent before the process starts.
             if (cancellation_signal->is_cancelled_) {
               int res = kill_(pid, SIGKILL);
               DCHECK_EQ(res, 0);
+            } else if (cancellation_signal->is_paused_) {
+              int res = kill_(pid, SIGSTOP);
+              DCHECK_EQ(res, 0);
             }
           },
       .on_end =
@@ -980,6 +988,11 @@ ndk::ScopedAStatus Artd::dexopt(
             // The pid should no longer receive kill signals sent by `cancellation_signal`.
             cancellation_signal->pids_.erase(pid);
           },
+      .get_paused_time_ms =
+          [&](pid_t) {
+            std::lock_guard<std::mutex> lock(cancellation_signal->mu_);
+            return cancellation_signal->GetPausedTimeMs() - paused_time_at_start_ms;
+          },
   };
 
   ProcessStat stat;
@@ -1029,6 +1042,45 @@ ScopedAStatus ArtdCancellationSignal::cancel() {
   return ScopedAStatus::ok();
 }
 
+ScopedAStatus ArtdCancellationSignal::pause() {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (is_cancelled_ || is_paused_) {
+    return ScopedAStatus::ok();
+  }
+  is_paused_ = true;
+  pause_start_ms_ = static_cast<int64_t>(MilliTime());
+  for (pid_t pid : pids_) {
+    int res = kill_(pid, SIGSTOP);
+    DCHECK_EQ(res, 0);
+  }
+  return ScopedAStatus::ok();
+}
+
+ScopedAStatus ArtdCancellationSignal::resume() {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (!is_paused_) {
+    return ScopedAStatus::ok();
+  }
+  paused_time_ms_ = GetPausedTimeMs();
+  is_paused_ = false;
+  if (is_cancelled_) {
+    // The processes have been killed already.
+    return ScopedAStatus::ok();
+  }
+  for (pid_t pid : pids_) {
+    int res = kill_(pid, SIGCONT);
+    DCHECK_EQ(res, 0);
+  }
+  return ScopedAStatus::ok();
+}
+
+int64_t ArtdCancellationSignal::GetPausedTimeMs() {
+  if (!is_paused_) {
+    return paused_time_ms_;
+  }
+  return paused_time_ms_ + static_cast<int64_t>(MilliTime()) - pause_start_ms_;
+}
+
 ScopedAStatus ArtdCancellationSignal::getType(int64_t* _aidl_return) {
   *_aidl_return = reinterpret_cast<intptr_t>(kArtdCancellationSignalType);
   return ScopedAStatus::ok();
@@ -53,12 +53,26 @@ class ArtdCancellationSignal : public aidl::com::android::server::art::BnArtdCan
 
   ndk::ScopedAStatus cancel() override;
 
+  ndk::ScopedAStatus pause() override;
+
+  ndk::ScopedAStatus resume() override;
+
   ndk::ScopedAStatus getType(int64_t* _aidl_return) override;
 
  private:
+  // Returns the total time, in milliseconds, that this signal has been paused, including the
+  // current pause.
+  int64_t GetPausedTimeMs() REQUIRES(mu_);
+
   std::mutex mu_;
   // True if cancellation has been signaled.
   bool is_cancelled_ GUARDED_BY(mu_) = false;
+  // True if the child processes are suspended.
+  bool is_paused_ GUARDED_BY(mu_) = false;
+  // The time, from `MilliTime`, at which the current pause started.
+  int64_t pause_start_ms_ GUARDED_BY(mu_) = 0;
+  // The total time, in milliseconds, of the pauses that have ended.
+  int64_t paused_time_ms_ GUARDED_BY(mu_) = 0;
   // The pids of currently running child processes that are bound to this signal.
   std::unordered_set<pid_t> pids_ GUARDED_BY(mu_);
 
@@ -100,6 +100,7 @@ using ::testing::DoAll;
 using ::testing::ElementsAre;
 using ::testing::Field;
 using ::testing::HasSubstr;
+using ::testing::InSequence;
 using ::testing::IsEmpty;
 using ::testing::Matcher;
 using ::testing::MockFunction;
@@ -1155,6 +1156,42 @@ TEST_F(ArtdTest, dexoptCancelledAfterDex2oat) {
   EXPECT_FALSE(std::filesystem::exists(scratch_path_ + "/a/oat/arm64/b.art"));
 }
 
+TEST_F(ArtdTest, dexoptPausedAndResumed) {
+  std::shared_ptr<IArtdCancellationSignal> cancellation_signal;
+  ASSERT_TRUE(artd_->createCancellationSignal(&cancellation_signal).isOk());
+
+  constexpr pid_t kPid = 123;
+
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(_, _, _))
+      .WillOnce(DoAll(WithArg<0>(WriteToFdFlag("--oat-fd=", "new_oat")),
+                      WithArg<0>(WriteToFdFlag("--output-vdex-fd=", "new_vdex")),
+                      [&](auto, const ExecCallbacks& callbacks, auto) {
+                        // The process is suspended as soon as it starts.
+                        callbacks.on_start(kPid);
+                        // The time spent paused is excluded from the timeout.
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        EXPECT_GE(callbacks.get_paused_time_ms(kPid), 5);
+                        cancellation_signal->resume();
+                        int64_t paused_time_ms = callbacks.get_paused_time_ms(kPid);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        EXPECT_EQ(callbacks.get_paused_time_ms(kPid), paused_time_ms);
+                        callbacks.on_end(kPid);
+                        return 0;
+                      }));
+  {
+    InSequence seq;
+    EXPECT_CALL(mock_kill_, Call(kPid, SIGSTOP));
+    EXPECT_CALL(mock_kill_, Call(kPid, SIGCONT));
+  }
+
+  cancellation_signal->pause();
+
+  RunDexopt(EX_NONE, Field(&ArtdDexoptResult::cancelled, false), cancellation_signal);
+
+  CheckContent(scratch_path_ + "/a/oat/arm64/b.odex", "new_oat");
+  CheckContent(scratch_path_ + "/a/oat/arm64/b.vdex", "new_vdex");
+}
+
 TEST_F(ArtdTest, dexoptDexFileNotOtherReadable) {
   dex_file_other_readable_ = false;
   EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(_, _, _)).Times(0);
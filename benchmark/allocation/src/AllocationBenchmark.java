@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class AllocationBenchmark {
+    public void timeNewObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Object();
+        }
+        result = last;
+    }
+
+    public void timeNewSmallObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new SmallObject();
+        }
+        result = last;
+    }
+
+    public void timeNewLargeObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new LargeObject();
+        }
+        result = last;
+    }
+
+    public void timeNewIntArray8(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new int[8];
+        }
+        result = last;
+    }
+
+    public void timeNewIntArray256(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new int[256];
+        }
+        result = last;
+    }
+
+    public void timeNewObjectArray8(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Object[8];
+        }
+        result = last;
+    }
+
+    public void timeNewStringFromChars(int count) {
+        char[] chars = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new String(chars);
+        }
+        result = last;
+    }
+
+    Object result;
+}
+
+class SmallObject {
+    int i;
+}
+
+class LargeObject {
+    long l0, l1, l2, l3, l4, l5, l6, l7;
+    long l8, l9, l10, l11, l12, l13, l14, l15;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class FieldAccessBenchmark {
+    public void timeInstanceFieldGetInt(int count) {
+        Holder[] holders = this.holders;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += holders[i & 1023].intField;
+        }
+        result = sum;
+    }
+
+    public void timeInstanceFieldSetInt(int count) {
+        Holder[] holders = this.holders;
+        for (int i = 0; i < count; ++i) {
+            holders[i & 1023].intField = i;
+        }
+    }
+
+    public void timeInstanceFieldGetObject(int count) {
+        Holder[] holders = this.holders;
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = holders[i & 1023].objectField;
+        }
+        objectResult = last;
+    }
+
+    public void timeInstanceFieldSetObject(int count) {
+        Holder[] holders = this.holders;
+        Object value = this;
+        for (int i = 0; i < count; ++i) {
+            holders[i & 1023].objectField = value;
+        }
+    }
+
+    public void timeVolatileFieldGetInt(int count) {
+        Holder[] holders = this.holders;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += holders[i & 1023].volatileIntField;
+        }
+        result = sum;
+    }
+
+    public void timeVolatileFieldSetInt(int count) {
+        Holder[] holders = this.holders;
+        for (int i = 0; i < count; ++i) {
+            holders[i & 1023].volatileIntField = i;
+        }
+    }
+
+    public void timeStaticFieldGetInt(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += Holder.staticIntField;
+        }
+        result = sum;
+    }
+
+    public void timeStaticFieldSetInt(int count) {
+        for (int i = 0; i < count; ++i) {
+            Holder.staticIntField = i;
+        }
+    }
+
+    private static Holder[] createHolders() {
+        Holder[] holders = new Holder[1024];
+        for (int i = 0; i < holders.length; ++i) {
+            holders[i] = new Holder();
+        }
+        return holders;
+    }
+
+    Holder[] holders = createHolders();
+    int result;
+    Object objectResult;
+}
+
+class Holder {
+    int intField;
+    volatile int volatileIntField;
+    Object objectField;
+    static int staticIntField;
+}
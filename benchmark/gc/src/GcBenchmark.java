@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.ref.SoftReference;
+
+public class GcBenchmark {
+    // Number of objects kept alive by the survival benchmarks.
+    private static final int RETAINED = 16 * 1024;
+
+    // Depth of the trees built by the tree benchmarks.
+    private static final int TREE_DEPTH = 12;
+
+    // Garbage that dies right away, so each GC has almost nothing to copy or mark.
+    public void timeShortLived(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Node(null, null);
+        }
+        result = last;
+    }
+
+    // Every 10th object replaces an entry of a fixed size table and survives a while.
+    public void timeSurvival10Percent(int count) {
+        survive(count, 10);
+    }
+
+    // Every other object replaces an entry of a fixed size table and survives a while.
+    public void timeSurvival50Percent(int count) {
+        survive(count, 2);
+    }
+
+    private void survive(int count, int period) {
+        Object[] retained = new Object[RETAINED];
+        Object last = null;
+        int next = 0;
+        for (int i = 0; i < count; ++i) {
+            last = new Node(null, null);
+            if (i % period == 0) {
+                retained[next] = last;
+                next = (next + 1) % RETAINED;
+            }
+        }
+        result = retained;
+    }
+
+    // Short-lived binary trees, the classic GCBench shape.
+    public void timeShortLivedTrees(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = makeTree(TREE_DEPTH);
+        }
+        result = last;
+    }
+
+    // Short-lived trees allocated while a long-lived tree stays reachable, so full collections
+    // have to trace a deep object graph.
+    public void timeTreesWithLongLivedTree(int count) {
+        Node longLived = makeTree(TREE_DEPTH + 4);
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = makeTree(TREE_DEPTH);
+        }
+        result = last;
+        retainedTree = longLived;
+    }
+
+    // A long linked list that is extended at the head and cut in the middle, which gives the
+    // collector a long chain of dependent loads to mark.
+    public void timeLinkedList(int count) {
+        Node head = null;
+        int length = 0;
+        for (int i = 0; i < count; ++i) {
+            head = new Node(head, null);
+            if (++length == RETAINED) {
+                // Drop the older half of the list.
+                Node cut = head;
+                for (int j = 1; j < RETAINED / 2; ++j) {
+                    cut = cut.left;
+                }
+                cut.left = null;
+                length = RETAINED / 2;
+            }
+        }
+        result = head;
+    }
+
+    // Large primitive arrays, which go to the large object space.
+    public void timeLargePrimitiveArrays(int count) {
+        Object[] retained = new Object[16];
+        for (int i = 0; i < count; ++i) {
+            retained[i % retained.length] = new int[64 * 1024];
+        }
+        result = retained;
+    }
+
+    // Large reference arrays, which have to be scanned when they survive.
+    public void timeLargeReferenceArrays(int count) {
+        Object[] retained = new Object[16];
+        Object filler = new Object();
+        for (int i = 0; i < count; ++i) {
+            Object[] array = new Object[16 * 1024];
+            for (int j = 0; j < array.length; j += 64) {
+                array[j] = filler;
+            }
+            retained[i % retained.length] = array;
+        }
+        result = retained;
+    }
+
+    // SoftReferences to small arrays, cleared only when the heap gets tight.
+    public void timeSoftReferences(int count) {
+        Object[] references = new Object[RETAINED];
+        for (int i = 0; i < count; ++i) {
+            references[i % RETAINED] = new SoftReference<Object>(new int[16]);
+        }
+        result = references;
+    }
+
+    // Short-lived trees allocated from 4 threads.
+    public void timeShortLivedTrees4Threads(int count) throws InterruptedException {
+        allocateFromThreads(count, 4);
+    }
+
+    private void allocateFromThreads(final int count, int numThreads) throws InterruptedException {
+        Thread[] threads = new Thread[numThreads];
+        final Object[] results = new Object[numThreads];
+        for (int t = 0; t < numThreads; ++t) {
+            final int index = t;
+            threads[t] = new Thread() {
+                public void run() {
+                    Object last = null;
+                    for (int i = index; i < count; i += results.length) {
+                        last = makeTree(TREE_DEPTH);
+                    }
+                    results[index] = last;
+                }
+            };
+            threads[t].start();
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+        result = results;
+    }
+
+    private static Node makeTree(int depth) {
+        if (depth == 0) {
+            return new Node(null, null);
+        }
+        return new Node(makeTree(depth - 1), makeTree(depth - 1));
+    }
+
+    Object result;
+    Object retainedTree;
+}
+
+class Node {
+    Node left;
+    Node right;
+
+    Node(Node left, Node right) {
+        this.left = left;
+        this.right = right;
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class InvokeBenchmark {
+    public void timeInvokeStatic(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$staticMethod(i);
+        }
+        result = sum;
+    }
+
+    public void timeInvokeDirect(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$privateMethod(i);
+        }
+        result = sum;
+    }
+
+    public void timeInvokeVirtualMonomorphic(int count) {
+        Base[] receivers = monomorphicReceivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += receivers[i & 1023].virtualMethod(i);
+        }
+        result = sum;
+    }
+
+    public void timeInvokeVirtualMegamorphic(int count) {
+        Base[] receivers = megamorphicReceivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += receivers[i & 1023].virtualMethod(i);
+        }
+        result = sum;
+    }
+
+    public void timeInvokeInterfaceMonomorphic(int count) {
+        Itf[] receivers = monomorphicReceivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += receivers[i & 1023].interfaceMethod(i);
+        }
+        result = sum;
+    }
+
+    public void timeInvokeInterfaceMegamorphic(int count) {
+        Itf[] receivers = megamorphicReceivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += receivers[i & 1023].interfaceMethod(i);
+        }
+        result = sum;
+    }
+
+    public void timeInvokeInterfaceDefault(int count) {
+        Itf[] receivers = megamorphicReceivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += receivers[i & 1023].defaultMethod(i);
+        }
+        result = sum;
+    }
+
+    static int $noinline$staticMethod(int i) {
+        if (doThrow) { throw new Error(); }
+        return i;
+    }
+
+    private int $noinline$privateMethod(int i) {
+        if (doThrow) { throw new Error(); }
+        return i;
+    }
+
+    private static Base[] createReceivers(int kinds) {
+        Base[] receivers = new Base[1024];
+        for (int i = 0; i < receivers.length; ++i) {
+            switch (i % kinds) {
+                case 0: receivers[i] = new Impl0(); break;
+                case 1: receivers[i] = new Impl1(); break;
+                case 2: receivers[i] = new Impl2(); break;
+                default: receivers[i] = new Impl3(); break;
+            }
+        }
+        return receivers;
+    }
+
+    public static boolean doThrow = false;
+
+    Base[] monomorphicReceivers = createReceivers(1);
+    Base[] megamorphicReceivers = createReceivers(4);
+    int result;
+}
+
+interface Itf {
+    int interfaceMethod(int i);
+
+    default int defaultMethod(int i) {
+        return i + 1;
+    }
+}
+
+abstract class Base implements Itf {
+    abstract int virtualMethod(int i);
+}
+
+class Impl0 extends Base {
+    int virtualMethod(int i) { return i; }
+    public int interfaceMethod(int i) { return i; }
+}
+
+class Impl1 extends Base {
+    int virtualMethod(int i) { return i + 1; }
+    public int interfaceMethod(int i) { return i + 1; }
+}
+
+class Impl2 extends Base {
+    int virtualMethod(int i) { return i + 2; }
+    public int interfaceMethod(int i) { return i + 2; }
+}
+
+class Impl3 extends Base {
+    int virtualMethod(int i) { return i + 3; }
+    public int interfaceMethod(int i) { return i + 3; }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class MonitorBenchmark {
+    public void timeSynchronizedBlock(int count) {
+        Object lock = this.lock;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            synchronized (lock) {
+                ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeNestedSynchronizedBlock(int count) {
+        Object lock = this.lock;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            synchronized (lock) {
+                synchronized (lock) {
+                    ++sum;
+                }
+            }
+        }
+        result = sum;
+    }
+
+    public void timeSynchronizedBlockTwoLocks(int count) {
+        Object lock = this.lock;
+        Object otherLock = this.otherLock;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            synchronized (lock) {
+                synchronized (otherLock) {
+                    ++sum;
+                }
+            }
+        }
+        result = sum;
+    }
+
+    public void timeSynchronizedMethod(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$synchronizedIncrement();
+        }
+    }
+
+    public void timeSynchronizedStaticMethod(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$synchronizedStaticIncrement();
+        }
+    }
+
+    synchronized void $noinline$synchronizedIncrement() {
+        if (doThrow) { throw new Error(); }
+        ++result;
+    }
+
+    static synchronized void $noinline$synchronizedStaticIncrement() {
+        if (doThrow) { throw new Error(); }
+        ++staticResult;
+    }
+
+    public static boolean doThrow = false;
+
+    final Object lock = new Object();
+    final Object otherLock = new Object();
+    int result;
+    static int staticResult;
+}
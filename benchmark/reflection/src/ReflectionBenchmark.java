@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+
+public class ReflectionBenchmark {
+    public void timeFieldGetInt(int count) throws Exception {
+        Field field = intField;
+        Target target = this.target;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += field.getInt(target);
+        }
+        result = sum;
+    }
+
+    public void timeFieldSetInt(int count) throws Exception {
+        Field field = intField;
+        Target target = this.target;
+        for (int i = 0; i < count; ++i) {
+            field.setInt(target, i);
+        }
+    }
+
+    public void timeMethodInvokeNoArgs(int count) throws Exception {
+        Method method = noArgsMethod;
+        Target target = this.target;
+        for (int i = 0; i < count; ++i) {
+            method.invoke(target);
+        }
+    }
+
+    public void timeMethodInvokeStaticIntArg(int count) throws Exception {
+        Method method = staticIntArgMethod;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += (Integer) method.invoke(null, i);
+        }
+        result = sum;
+    }
+
+    public void timeClassGetDeclaredField(int count) throws Exception {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = Target.class.getDeclaredField("intField");
+        }
+        objectResult = last;
+    }
+
+    public void timeClassGetDeclaredMethod(int count) throws Exception {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = Target.class.getDeclaredMethod("noArgs");
+        }
+        objectResult = last;
+    }
+
+    public void timeClassNewInstance(int count) throws Exception {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = Target.class.newInstance();
+        }
+        objectResult = last;
+    }
+
+    private static Field getField(String name) {
+        try {
+            return Target.class.getDeclaredField(name);
+        } catch (Exception unexpected) {
+            throw new Error("Initialization failure!");
+        }
+    }
+
+    private static Method getMethod(String name, Class<?>... parameterTypes) {
+        try {
+            return Target.class.getDeclaredMethod(name, parameterTypes);
+        } catch (Exception unexpected) {
+            throw new Error("Initialization failure!");
+        }
+    }
+
+    Field intField = getField("intField");
+    Method noArgsMethod = getMethod("noArgs");
+    Method staticIntArgMethod = getMethod("staticIntArg", int.class);
+    Target target = new Target();
+    int result;
+    Object objectResult;
+}
+
+class Target {
+    public int intField;
+
+    public void noArgs() { }
+
+    public static int staticIntArg(int i) {
+        return i;
+    }
+}
@@ -64,6 +64,19 @@ public class StringBuilderAppendBenchmark {
         }
     }
 
+    public void timeAppendStringAndIntWithCapacity(int count) {
+        String s1 = string1;
+        int i1 = int1;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            String result = new StringBuilder(32).append(s1).append(i1).toString();
+            sum += result.length();  // Make sure the append is not optimized away.
+        }
+        if (sum != count * (s1.length() + Integer.toString(i1).length())) {
+            throw new AssertionError();
+        }
+    }
+
     public void timeAppendStringAndDouble(int count) {
         String s1 = string1;
         double d1 = double1;
@@ -43,6 +43,7 @@ CompilerOptions::CompilerOptions()
       large_method_threshold_(kDefaultLargeMethodThreshold),
       num_dex_methods_threshold_(kDefaultNumDexMethodsThreshold),
       inline_max_code_units_(kUnsetInlineMaxCodeUnits),
+      inline_cache_sampling_interval_(kDefaultInlineCacheSamplingInterval),
       instruction_set_(kRuntimeISA == InstructionSet::kArm ? InstructionSet::kThumb2 : kRuntimeISA),
       instruction_set_features_(nullptr),
       no_inline_from_(),
@@ -72,6 +73,7 @@ CompilerOptions::CompilerOptions()
       init_failure_output_(nullptr),
       dump_cfg_file_name_(""),
       dump_cfg_append_(false),
+      dump_pass_profile_file_name_(""),
       force_determinism_(false),
       check_linkage_conditions_(false),
       crash_on_linkage_violation_(false),
@@ -42,6 +42,7 @@ class VerifierDepsTest;
 
 namespace linker {
 class Arm64RelativePatcherTest;
+class Riscv64RelativePatcherTest;
 }  // namespace linker
 
 class ArtMethod;
@@ -68,6 +69,7 @@ class CompilerOptions final {
   static const bool kDefaultGenerateMiniDebugInfo = true;
   static const size_t kDefaultInlineMaxCodeUnits = 32;
   static constexpr size_t kUnsetInlineMaxCodeUnits = -1;
+  static constexpr uint32_t kDefaultInlineCacheSamplingInterval = 1u;
 
   enum class CompilerType : uint8_t {
     kAotCompiler,             // AOT compiler.
@@ -115,9 +117,7 @@ class CompilerOptions final {
   }
 
   bool IsAnyCompilationEnabled() const {
-    return CompilerFilter::IsAnyCompilationEnabled(compiler_filter_) &&
-           // TODO(riscv64): remove this when we have compiler support for RISC-V
-           GetInstructionSet() != InstructionSet::kRiscv64;
+    return CompilerFilter::IsAnyCompilationEnabled(compiler_filter_);
   }
 
   size_t GetHugeMethodThreshold() const {
@@ -147,6 +147,12 @@ class CompilerOptions final {
     inline_max_code_units_ = units;
   }
 
+  // Baseline compiled code updates its inline caches once every `GetInlineCacheSamplingInterval()`
+  // calls executed by a thread.
+  uint32_t GetInlineCacheSamplingInterval() const {
+    return inline_cache_sampling_interval_;
+  }
+
   double GetTopKProfileThreshold() const {
     return top_k_profile_threshold_;
   }
@@ -318,6 +324,10 @@ class CompilerOptions final {
     return dump_cfg_append_;
   }
 
+  const std::string& GetDumpPassProfileFileName() const {
+    return dump_pass_profile_file_name_;
+  }
+
   bool IsForceDeterminism() const {
     return force_determinism_;
   }
@@ -398,6 +408,7 @@ class CompilerOptions final {
   size_t large_method_threshold_;
   size_t num_dex_methods_threshold_;
   size_t inline_max_code_units_;
+  uint32_t inline_cache_sampling_interval_;
 
   InstructionSet instruction_set_;
   std::unique_ptr<const InstructionSetFeatures> instruction_set_features_;
@@ -456,6 +467,9 @@ class CompilerOptions final {
   std::string dump_cfg_file_name_;
   bool dump_cfg_append_;
 
+  // File receiving the time and arena memory spent in each pass, one JSON object per method.
+  std::string dump_pass_profile_file_name_;
+
   // Whether the compiler should trade performance for determinism to guarantee exactly reproducible
   // outcomes.
   bool force_determinism_;
@@ -504,6 +518,7 @@ class CompilerOptions final {
   friend class jit::JitCompiler;
   friend class verifier::VerifierDepsTest;
   friend class linker::Arm64RelativePatcherTest;
+  friend class linker::Riscv64RelativePatcherTest;
 
   template <class Base>
   friend bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string* error_msg);
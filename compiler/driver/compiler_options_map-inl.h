@@ -19,6 +19,7 @@
 
 #include "compiler_options_map.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "android-base/logging.h"
@@ -60,6 +61,10 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   map.AssignIfExists(Base::LargeMethodMaxThreshold, &options->large_method_threshold_);
   map.AssignIfExists(Base::NumDexMethodsThreshold, &options->num_dex_methods_threshold_);
   map.AssignIfExists(Base::InlineMaxCodeUnitsThreshold, &options->inline_max_code_units_);
+  if (map.Exists(Base::InlineCacheSamplingInterval)) {
+    options->inline_cache_sampling_interval_ =
+        std::max(*map.Get(Base::InlineCacheSamplingInterval), 1u);
+  }
   map.AssignIfExists(Base::GenerateDebugInfo, &options->generate_debug_info_);
   map.AssignIfExists(Base::GenerateMiniDebugInfo, &options->generate_mini_debug_info_);
   map.AssignIfExists(Base::GenerateBuildID, &options->generate_build_id_);
@@ -81,6 +86,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::DumpCFGAppend)) {
     options->dump_cfg_append_ = true;
   }
+  map.AssignIfExists(Base::DumpPassProfile, &options->dump_pass_profile_file_name_);
   if (map.Exists(Base::RegisterAllocationStrategy)) {
     if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::DumpInitFailures), error_msg)) {
       return false;
@@ -149,6 +155,11 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                     "A zero value will disable inlining. Honored only by Optimizing. Has priority\n"
                     "over the --compiler-filter option. Intended for development/experimental use.")
           .IntoKey(Map::InlineMaxCodeUnitsThreshold)
+      .Define("--inline-cache-sampling-interval=_")
+          .template WithType<unsigned int>()
+          .WithHelp("update the inline caches of baseline JIT code only once every that many\n"
+                    "calls executed by a thread. Defaults to 1, updating them on every call.")
+          .IntoKey(Map::InlineCacheSamplingInterval)
 
       .Define({"--generate-debug-info", "-g", "--no-generate-debug-info"})
           .WithValues({true, true, false})
@@ -231,6 +242,13 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                     "behavior). This option is only meaningful when used with --dump-cfg.")
           .IntoKey(Map::DumpCFGAppend)
 
+      .Define("--dump-pass-profile=_")
+          .template WithType<std::string>()
+          .WithHelp("Append the time and arena memory used by each optimization pass to the\n"
+                    "specified file, as one JSON object per compiled method. Methods can be\n"
+                    "selected with --verbose-methods.")
+          .IntoKey(Map::DumpPassProfile)
+
       .Define("--register-allocation-strategy=_")
           .template WithType<std::string>()
           .IntoKey(Map::RegisterAllocationStrategy)
@@ -203,6 +203,17 @@ bool JitCompiler::CompileMethod(
     VLOG(jit) << "Compilation of " << method->PrettyMethod() << " took "
               << PrettyDuration(UsToNs(duration_us));
     runtime->GetMetrics()->JitMethodCompileCount()->AddOne();
+    switch (compilation_kind) {
+      case CompilationKind::kBaseline:
+        runtime->GetMetrics()->JitBaselineCompileTotalTime()->Add(duration_us);
+        break;
+      case CompilationKind::kOptimized:
+        runtime->GetMetrics()->JitOptimizedCompileTotalTime()->Add(duration_us);
+        break;
+      case CompilationKind::kOsr:
+        runtime->GetMetrics()->JitOsrCompileTotalTime()->Add(duration_us);
+        break;
+    }
     runtime->GetMetrics()->JitMethodCompileTotalTimeDelta()->Add(duration_us);
     runtime->GetMetrics()->JitMethodCompileCountDelta()->AddOne();
   }
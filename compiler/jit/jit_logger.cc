@@ -23,6 +23,7 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "oat_file-inl.h"
+#include "thread-current-inl.h"
 
 namespace art HIDDEN {
 namespace jit {
@@ -49,6 +50,12 @@ void JitLogger::OpenPerfMapLog() {
   }
 }
 
+void JitLogger::WriteLog(const void* ptr, size_t code_size, ArtMethod* method) {
+  MutexLock mu(Thread::Current(), lock_);
+  WritePerfMapLog(ptr, code_size, method);
+  WriteJitDumpLog(ptr, code_size, method);
+}
+
 void JitLogger::WritePerfMapLog(const void* ptr, size_t code_size, ArtMethod* method) {
   if (perf_file_ != nullptr) {
     std::string method_name = method->PrettyMethod();
@@ -88,18 +88,17 @@ namespace jit {
 //
 class JitLogger {
  public:
-    JitLogger() : code_index_(0), marker_address_(nullptr) {}
+    JitLogger()
+        : lock_("JIT logger lock", kGenericBottomLock), code_index_(0), marker_address_(nullptr) {}
 
     void OpenLog() {
       OpenPerfMapLog();
       OpenJitDumpLog();
     }
 
+    // Thread-safe, methods compiled by different JIT threads are logged one at a time.
     void WriteLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_) {
-      WritePerfMapLog(ptr, code_size, method);
-      WriteJitDumpLog(ptr, code_size, method);
-    }
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
 
     void CloseLog() {
       ClosePerfMapLog();
@@ -110,13 +109,13 @@ class JitLogger {
     // For perf-map profiling
     void OpenPerfMapLog();
     void WritePerfMapLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(lock_);
     void ClosePerfMapLog();
 
     // For perf-inject profiling
     void OpenJitDumpLog();
     void WriteJitDumpLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(lock_);
     void CloseJitDumpLog();
 
     void OpenMarkerFile();
@@ -124,9 +123,11 @@ class JitLogger {
     void WriteJitDumpHeader();
     void WriteJitDumpDebugInfo();
 
+    // Serializes the records written by concurrent JIT compilations.
+    Mutex lock_;
     std::unique_ptr<File> perf_file_;
     std::unique_ptr<File> jit_dump_file_;
-    uint64_t code_index_;
+    uint64_t code_index_ GUARDED_BY(lock_);
     void* marker_address_;
 
     DISALLOW_COPY_AND_ASSIGN(JitLogger);
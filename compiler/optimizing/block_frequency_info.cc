@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "block_frequency_info.h"
+
+#include <algorithm>
+
+#include "base/scoped_arena_allocator.h"
+
+namespace art HIDDEN {
+
+HBlockFrequencyInfo::HBlockFrequencyInfo(const HGraph* graph, ScopedArenaAllocator* allocator)
+    : cold_blocks_(allocator, graph->GetBlocks().size(), false, kArenaAllocLinearOrder),
+      frequencies_(graph->GetBlocks().size(), 0u, allocator->Adapter(kArenaAllocLinearOrder)) {
+  ComputeColdBlocks(graph);
+  ComputeFrequencies(graph);
+}
+
+static bool AlwaysThrows(const HBasicBlock* block) {
+  if (block->GetLastInstruction()->IsThrow()) {
+    return true;
+  }
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    if (it.Current()->AlwaysThrows()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void HBlockFrequencyInfo::ComputeColdBlocks(const HGraph* graph) {
+  // Visit in post order, so that successors are visited first, except through back edges.
+  // Loop headers are never cold, so the back edges can be ignored.
+  for (HBasicBlock* block : ReverseRange(graph->GetReversePostOrder())) {
+    if (block->IsLoopHeader() || block->IsExitBlock()) {
+      continue;
+    }
+    bool cold = AlwaysThrows(block) ||
+                std::all_of(block->GetSuccessors().begin(),
+                            block->GetSuccessors().end(),
+                            [&](HBasicBlock* successor) { return IsCold(successor); });
+    if (cold) {
+      cold_blocks_.SetBit(block->GetBlockId());
+    }
+  }
+}
+
+void HBlockFrequencyInfo::ComputeFrequencies(const HGraph* graph) {
+  frequencies_[graph->GetEntryBlock()->GetBlockId()] = kEntryFrequency;
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    uint64_t frequency = frequencies_[block->GetBlockId()];
+    if (block->IsLoopHeader()) {
+      // All the forward predecessors have been visited. Scale by the number of iterations.
+      frequency = std::min(frequency * kLoopFrequencyScale, kMaxFrequency);
+      frequencies_[block->GetBlockId()] = frequency;
+    }
+    uint64_t total_weight = 0u;
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      total_weight += GetEdgeWeight(successor);
+    }
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (successor->IsLoopHeader() && successor->GetLoopInformation()->IsBackEdge(*block)) {
+        continue;
+      }
+      uint64_t edge_frequency = frequency * GetEdgeWeight(successor) / total_weight;
+      uint64_t& successor_frequency = frequencies_[successor->GetBlockId()];
+      successor_frequency = std::min(successor_frequency + edge_frequency, kMaxFrequency);
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_BLOCK_FREQUENCY_INFO_H_
+#define ART_COMPILER_OPTIMIZING_BLOCK_FREQUENCY_INFO_H_
+
+#include "base/arena_bit_vector.h"
+#include "base/macros.h"
+#include "base/scoped_arena_containers.h"
+#include "nodes.h"
+
+namespace art HIDDEN {
+
+// Estimates how often each basic block of a graph executes, relative to the entry block.
+//
+// The estimate is based on static heuristics:
+// - a loop header executes `kLoopFrequencyScale` times per entry in the loop,
+// - a block is cold if it always ends up throwing, i.e. it throws or all its successors are cold,
+// - branches to cold blocks are taken with a `kColdEdgeWeight / kHotEdgeWeight` relative weight,
+//   other branches are equally likely.
+class HBlockFrequencyInfo : public ValueObject {
+ public:
+  static constexpr uint64_t kEntryFrequency = 1u << 16;
+
+  HBlockFrequencyInfo(const HGraph* graph, ScopedArenaAllocator* allocator);
+
+  // Returns the estimated frequency of `block`, `kEntryFrequency` being the frequency of the
+  // entry block.
+  uint64_t GetFrequency(const HBasicBlock* block) const {
+    return frequencies_[block->GetBlockId()];
+  }
+
+  // Returns whether `block` is statically known to be unlikely to execute.
+  bool IsCold(const HBasicBlock* block) const {
+    return cold_blocks_.IsBitSet(block->GetBlockId());
+  }
+
+ private:
+  static constexpr uint64_t kLoopFrequencyScale = 8u;
+  static constexpr uint64_t kHotEdgeWeight = 64u;
+  static constexpr uint64_t kColdEdgeWeight = 1u;
+  // Maximum frequency, low enough to avoid overflows when scaling and weighting frequencies.
+  static constexpr uint64_t kMaxFrequency = UINT64_C(1) << 48;
+
+  void ComputeColdBlocks(const HGraph* graph);
+  void ComputeFrequencies(const HGraph* graph);
+
+  uint64_t GetEdgeWeight(const HBasicBlock* successor) const {
+    return IsCold(successor) ? kColdEdgeWeight : kHotEdgeWeight;
+  }
+
+  ArenaBitVector cold_blocks_;
+  ScopedArenaVector<uint64_t> frequencies_;
+
+  DISALLOW_COPY_AND_ASSIGN(HBlockFrequencyInfo);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_BLOCK_FREQUENCY_INFO_H_
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "block_frequency_info.h"
+
+#include "base/macros.h"
+#include "base/scoped_arena_allocator.h"
+#include "linear_order.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+
+namespace art HIDDEN {
+
+class BlockFrequencyInfoTest : public OptimizingUnitTest {
+ protected:
+  // Builds the following graph, where `cold` throws:
+  //
+  //        entry
+  //          |
+  //         bif
+  //        /   \
+  //      hot   cold
+  //       |     |
+  //    breturn  |
+  //        \   /
+  //        exit
+  AdjacencyListGraph BuildThrowingBranchGraph() {
+    CreateGraph();
+    AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                   "exit",
+                                                   {{"entry", "bif"},
+                                                    {"bif", "hot"},
+                                                    {"bif", "cold"},
+                                                    {"hot", "breturn"},
+                                                    {"cold", "exit"},
+                                                    {"breturn", "exit"}}));
+    HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+    HInstruction* exception = MakeParam(DataType::Type::kReference);
+    blks.Get("entry")->AddInstruction(new (GetAllocator()) HGoto());
+    blks.Get("bif")->AddInstruction(new (GetAllocator()) HIf(bool_value));
+    blks.Get("hot")->AddInstruction(new (GetAllocator()) HGoto());
+    blks.Get("cold")->AddInstruction(new (GetAllocator()) HThrow(exception, /* dex_pc= */ 0u));
+    blks.Get("breturn")->AddInstruction(new (GetAllocator()) HReturnVoid());
+    SetupExit(blks.Get("exit"));
+    return blks;
+  }
+};
+
+TEST_F(BlockFrequencyInfoTest, ThrowingBranchIsCold) {
+  AdjacencyListGraph blks = BuildThrowingBranchGraph();
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  HBlockFrequencyInfo info(graph_, &allocator);
+
+  EXPECT_FALSE(info.IsCold(blks.Get("entry")));
+  EXPECT_FALSE(info.IsCold(blks.Get("bif")));
+  EXPECT_FALSE(info.IsCold(blks.Get("hot")));
+  EXPECT_FALSE(info.IsCold(blks.Get("breturn")));
+  EXPECT_TRUE(info.IsCold(blks.Get("cold")));
+
+  EXPECT_EQ(info.GetFrequency(blks.Get("entry")), HBlockFrequencyInfo::kEntryFrequency);
+  EXPECT_EQ(info.GetFrequency(blks.Get("bif")), HBlockFrequencyInfo::kEntryFrequency);
+  EXPECT_GT(info.GetFrequency(blks.Get("hot")), info.GetFrequency(blks.Get("cold")));
+  EXPECT_LE(info.GetFrequency(blks.Get("hot")) + info.GetFrequency(blks.Get("cold")),
+            HBlockFrequencyInfo::kEntryFrequency);
+}
+
+TEST_F(BlockFrequencyInfoTest, ColdBlockIsLinearizedLast) {
+  AdjacencyListGraph blks = BuildThrowingBranchGraph();
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HBasicBlock*> linear_order(allocator.Adapter(kArenaAllocLinearOrder));
+  LinearizeGraph(graph_, &linear_order);
+
+  ASSERT_EQ(linear_order.size(), 6u);
+  EXPECT_EQ(linear_order[0], blks.Get("entry"));
+  EXPECT_EQ(linear_order[1], blks.Get("bif"));
+  EXPECT_EQ(linear_order[2], blks.Get("hot"));
+  EXPECT_EQ(linear_order[3], blks.Get("breturn"));
+  EXPECT_EQ(linear_order[4], blks.Get("cold"));
+  EXPECT_EQ(linear_order[5], blks.Get("exit"));
+}
+
+TEST_F(BlockFrequencyInfoTest, LoopIsHot) {
+  CreateGraph();
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "header"},
+                                                  {"header", "body"},
+                                                  {"header", "breturn"},
+                                                  {"body", "header"},
+                                                  {"breturn", "exit"}}));
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  blks.Get("entry")->AddInstruction(new (GetAllocator()) HGoto());
+  blks.Get("header")->AddInstruction(new (GetAllocator()) HIf(bool_value));
+  blks.Get("body")->AddInstruction(new (GetAllocator()) HGoto());
+  blks.Get("breturn")->AddInstruction(new (GetAllocator()) HReturnVoid());
+  SetupExit(blks.Get("exit"));
+  graph_->ClearDominanceInformation();
+  ASSERT_EQ(graph_->BuildDominatorTree(), kAnalysisSuccess);
+  ASSERT_TRUE(blks.Get("header")->IsLoopHeader());
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  HBlockFrequencyInfo info(graph_, &allocator);
+  EXPECT_FALSE(info.IsCold(blks.Get("body")));
+  EXPECT_GT(info.GetFrequency(blks.Get("header")), HBlockFrequencyInfo::kEntryFrequency);
+  EXPECT_GT(info.GetFrequency(blks.Get("body")), HBlockFrequencyInfo::kEntryFrequency);
+  EXPECT_LT(info.GetFrequency(blks.Get("breturn")), info.GetFrequency(blks.Get("header")));
+}
+
+}  // namespace art
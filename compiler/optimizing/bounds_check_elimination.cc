@@ -550,7 +550,8 @@ class BCEVisitor final : public HGraphVisitor {
     }
     // We should never deoptimize from an osr method, otherwise we might wrongly optimize
     // code dominated by the deoptimization.
-    if (!GetGraph()->IsCompilingOsr()) {
+    if (!GetGraph()->IsCompilingOsr() &&
+        !GetGraph()->HasDeoptimizedBefore(DeoptimizationKind::kBlockBCE)) {
       AddComparesWithDeoptimization(block);
     }
   }
@@ -1686,6 +1687,11 @@ class BCEVisitor final : public HGraphVisitor {
       if (GetGraph()->IsCompilingOsr()) {
         return false;
       }
+      // Do not deoptimize again from a method that already deoptimized in a loop.
+      if (GetGraph()->HasDeoptimizedBefore(DeoptimizationKind::kLoopBoundsBCE) ||
+          GetGraph()->HasDeoptimizedBefore(DeoptimizationKind::kLoopNullBCE)) {
+        return false;
+      }
       // A try boundary preheader is hard to handle.
       // TODO: remove this restriction.
       if (loop->GetPreHeader()->GetLastInstruction()->IsTryBoundary()) {
@@ -38,6 +38,7 @@
 #endif
 
 #include "art_method-inl.h"
+#include "base/arena_bit_vector.h"
 #include "base/bit_utils.h"
 #include "base/bit_utils_iterator.h"
 #include "base/casts.h"
@@ -473,13 +474,48 @@ void CodeGenerator::EmitThunkCode(const linker::LinkerPatch& patch ATTRIBUTE_UNU
   LOG(FATAL) << "Unexpected call to EmitThunkCode().";
 }
 
+void CodeGenerator::ComputeCodeBlockOrder(const ArenaVector<HBasicBlock*>& linear_order) {
+  // Exception handlers and the blocks only reachable through them rarely execute. Emit them
+  // after all other blocks, next to the slow paths, to keep the hot code dense. Handlers in
+  // loops are kept in place, so that loops remain contiguous. Every block starts with the
+  // frame set up, so the CFI remains valid whatever the order of blocks.
+  code_block_order_.clear();
+  if (!GetGraph()->HasTryCatch()) {
+    code_block_order_.assign(linear_order.begin(), linear_order.end());
+    return;
+  }
+  ScopedArenaAllocator allocator(GetGraph()->GetArenaStack());
+  ArenaBitVector handler_blocks(&allocator,
+                                GetGraph()->GetBlocks().size(),
+                                /* expandable= */ false,
+                                kArenaAllocCodeGenerator);
+  code_block_order_.reserve(linear_order.size());
+  // The linear order visits blocks after their dominator.
+  for (HBasicBlock* block : linear_order) {
+    HBasicBlock* dominator = block->GetDominator();
+    if ((block->IsCatchBlock() && !block->IsInLoop()) ||
+        (dominator != nullptr && handler_blocks.IsBitSet(dominator->GetBlockId()))) {
+      handler_blocks.SetBit(block->GetBlockId());
+    } else {
+      code_block_order_.push_back(block);
+    }
+  }
+  for (HBasicBlock* block : linear_order) {
+    if (handler_blocks.IsBitSet(block->GetBlockId())) {
+      code_block_order_.push_back(block);
+    }
+  }
+  DCHECK_EQ(code_block_order_.size(), linear_order.size());
+}
+
 void CodeGenerator::InitializeCodeGeneration(size_t number_of_spill_slots,
                                              size_t maximum_safepoint_spill_size,
                                              size_t number_of_out_slots,
                                              const ArenaVector<HBasicBlock*>& block_order) {
-  block_order_ = &block_order;
   DCHECK(!block_order.empty());
   DCHECK(block_order[0] == GetGraph()->GetEntryBlock());
+  ComputeCodeBlockOrder(block_order);
+  block_order_ = &code_block_order_;
   ComputeSpillMask();
   first_register_slot_in_slow_path_ = RoundUp(
       (number_of_out_slots + number_of_spill_slots) * kVRegSize, GetPreferredSlotsAlignment());
@@ -1028,6 +1064,12 @@ std::unique_ptr<CodeGenerator> CodeGenerator::Create(HGraph* graph,
           new (allocator) arm64::CodeGeneratorARM64(graph, compiler_options, stats));
     }
 #endif
+#ifdef ART_ENABLE_CODEGEN_riscv64
+    case InstructionSet::kRiscv64: {
+      return std::unique_ptr<CodeGenerator>(
+          new (allocator) riscv64::CodeGeneratorRISCV64(graph, compiler_options, stats));
+    }
+#endif
 #ifdef ART_ENABLE_CODEGEN_x86
     case InstructionSet::kX86: {
       return std::unique_ptr<CodeGenerator>(
@@ -1077,6 +1119,7 @@ CodeGenerator::CodeGenerator(HGraph* graph,
       graph_(graph),
       compiler_options_(compiler_options),
       current_slow_path_(nullptr),
+      code_block_order_(graph->GetAllocator()->Adapter(kArenaAllocCodeGenerator)),
       current_block_index_(0),
       is_leaf_(true),
       needs_suspend_check_entry_(false),
@@ -851,6 +851,7 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   class CodeGenerationData;
 
   void InitializeCodeGenerationData();
+  void ComputeCodeBlockOrder(const ArenaVector<HBasicBlock*>& linear_order);
   size_t GetStackOffsetOfSavedRegister(size_t index);
   void GenerateSlowPaths();
   void BlockIfInRegister(Location location, bool is_out = false) const;
@@ -879,6 +880,9 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // The current slow-path that we're generating code for.
   SlowPathCode* current_slow_path_;
 
+  // Storage for `block_order_`: the linear order with exception handlers moved to the end.
+  ArenaVector<HBasicBlock*> code_block_order_;
+
   // The current block index in `block_order_` of the block
   // we are generating code for.
   size_t current_block_index_;
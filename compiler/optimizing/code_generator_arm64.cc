@@ -4576,12 +4576,29 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    vixl::aarch64::Label done;
+    vixl::aarch64::Label update_cache, done;
+    uint32_t sampling_interval = GetCompilerOptions().GetInlineCacheSamplingInterval();
+    if (sampling_interval != 1u) {
+      // Only update the inline cache once every `sampling_interval` calls of this thread.
+      MemOperand countdown(
+          tr, Thread::InlineCacheSampleCountdownOffset<kArm64PointerSize>().Int32Value());
+      __ Ldr(w9, countdown);
+      __ Subs(w9, w9, 1);
+      __ Str(w9, countdown);
+      __ B(ne, &done);
+      __ Mov(w9, sampling_interval);
+      __ Str(w9, countdown);
+    }
     __ Mov(x8, address);
     __ Ldr(x9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache: only count the receiver.
     __ Cmp(klass, x9);
-    __ B(eq, &done);
+    __ B(ne, &update_cache);
+    __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ Add(w9, w9, 1);
+    __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&update_cache);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
@@ -17,7 +17,733 @@
 #ifndef ART_COMPILER_OPTIMIZING_CODE_GENERATOR_RISCV64_H_
 #define ART_COMPILER_OPTIMIZING_CODE_GENERATOR_RISCV64_H_
 
+#include "arch/riscv64/registers_riscv64.h"
+#include "base/macros.h"
 #include "code_generator.h"
 #include "driver/compiler_options.h"
+#include "nodes.h"
+#include "parallel_move_resolver.h"
+#include "utils/riscv64/assembler_riscv64.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+// InvokeDexCallingConvention registers.
+static constexpr XRegister kParameterCoreRegisters[] = {A1, A2, A3, A4, A5, A6, A7};
+static constexpr size_t kParameterCoreRegistersLength = arraysize(kParameterCoreRegisters);
+
+static constexpr FRegister kParameterFpuRegisters[] = {FA0, FA1, FA2, FA3, FA4, FA5, FA6, FA7};
+static constexpr size_t kParameterFpuRegistersLength = arraysize(kParameterFpuRegisters);
+
+// InvokeRuntimeCallingConvention registers.
+static constexpr XRegister kRuntimeParameterCoreRegisters[] = {A0, A1, A2, A3, A4, A5, A6, A7};
+static constexpr size_t kRuntimeParameterCoreRegistersLength =
+    arraysize(kRuntimeParameterCoreRegisters);
+
+static constexpr FRegister kRuntimeParameterFpuRegisters[] = {
+    FA0, FA1, FA2, FA3, FA4, FA5, FA6, FA7};
+static constexpr size_t kRuntimeParameterFpuRegistersLength =
+    arraysize(kRuntimeParameterFpuRegisters);
+
+// Callee-saved registers, in the order in which they are stored in the frame: RA at the top,
+// then the other core registers from the highest down to the lowest (see Riscv64Context).
+// S1 is the thread register (TR) and is therefore not allocatable nor spilled.
+static constexpr XRegister kCoreCalleeSaves[] = {
+    S0, S2, S3, S4, S5, S6, S7, S8, S9, S10, S11, RA};  // RA is spilled to mimic Quick.
+static constexpr FRegister kFpuCalleeSaves[] = {
+    FS0, FS1, FS2, FS3, FS4, FS5, FS6, FS7, FS8, FS9, FS10, FS11};
+
+static constexpr XRegister kArtMethodRegister = A0;
+
+// Scratch FP register reserved for the code generator (TMP and TMP2 are in the assembler).
+static constexpr FRegister FTMP = FT11;
+// Scratch vector register. It has the same number as FTMP which is blocked, so the register
+// allocator never assigns it to a SIMD value (vector values live in the V register with the
+// same number as the allocated FP register, see `VRegisterFrom()`).
+static constexpr VRegister VTMP = V31;
+
+// The vectorizer uses a fixed vector length of 128 bits, the minimum VLEN required by
+// the application processor profiles. A `vsetivli` with this length is correct for any
+// VLEN >= 128; wider implementations simply leave the upper elements alone.
+static constexpr size_t kRiscv64VectorRegisterSize = 16;
+
+inline VRegister VRegisterFrom(Location location) {
+  DCHECK(location.IsFpuRegister()) << location;
+  return static_cast<VRegister>(location.reg());
+}
+
+// Intrinsics without handcrafted code on riscv64; these are compiled as regular invokes.
+// SystemArrayCopy (for references) needs the type checks, read barriers and card marking
+// of the runtime copy, and StringStringIndexOf(After) has no `art_quick_indexof` stub to
+// call on riscv64 (arm64 does not intrinsify them either), so these stay out of scope.
+// Of the VarHandle intrinsics, only the get and set access modes are implemented, and only
+// for field VarHandles; the atomic access modes below are compiled as regular invokes.
+#define UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(V) \
+  V(MethodHandleInvokeExact)                    \
+  V(MethodHandleInvoke)                         \
+  V(VarHandleCompareAndExchange)                \
+  V(VarHandleCompareAndExchangeAcquire)         \
+  V(VarHandleCompareAndExchangeRelease)         \
+  V(VarHandleCompareAndSet)                     \
+  V(VarHandleGetAndAdd)                         \
+  V(VarHandleGetAndAddAcquire)                  \
+  V(VarHandleGetAndAddRelease)                  \
+  V(VarHandleGetAndBitwiseAnd)                  \
+  V(VarHandleGetAndBitwiseAndAcquire)           \
+  V(VarHandleGetAndBitwiseAndRelease)           \
+  V(VarHandleGetAndBitwiseOr)                   \
+  V(VarHandleGetAndBitwiseOrAcquire)            \
+  V(VarHandleGetAndBitwiseOrRelease)            \
+  V(VarHandleGetAndBitwiseXor)                  \
+  V(VarHandleGetAndBitwiseXorAcquire)           \
+  V(VarHandleGetAndBitwiseXorRelease)           \
+  V(VarHandleGetAndSet)                         \
+  V(VarHandleGetAndSetAcquire)                  \
+  V(VarHandleGetAndSetRelease)                  \
+  V(VarHandleWeakCompareAndSet)                 \
+  V(VarHandleWeakCompareAndSetAcquire)          \
+  V(VarHandleWeakCompareAndSetPlain)            \
+  V(VarHandleWeakCompareAndSetRelease)          \
+  V(IntegerReverse)                             \
+  V(LongReverse)                                \
+  V(MathCos)                                    \
+  V(MathSin)                                    \
+  V(MathAcos)                                   \
+  V(MathAsin)                                   \
+  V(MathAtan)                                   \
+  V(MathAtan2)                                  \
+  V(MathPow)                                    \
+  V(MathCbrt)                                   \
+  V(MathCosh)                                   \
+  V(MathExp)                                    \
+  V(MathExpm1)                                  \
+  V(MathHypot)                                  \
+  V(MathLog)                                    \
+  V(MathLog10)                                  \
+  V(MathNextAfter)                              \
+  V(MathSinh)                                   \
+  V(MathTan)                                    \
+  V(MathTanh)                                   \
+  V(MathRoundDouble)                            \
+  V(MathRoundFloat)                             \
+  V(SystemArrayCopy)                            \
+  V(FP16Ceil)                                   \
+  V(FP16Compare)                                \
+  V(FP16Floor)                                  \
+  V(FP16Rint)                                   \
+  V(FP16ToFloat)                                \
+  V(FP16ToHalf)                                 \
+  V(FP16Greater)                                \
+  V(FP16GreaterEquals)                          \
+  V(FP16Less)                                   \
+  V(FP16LessEquals)                             \
+  V(FP16Min)                                    \
+  V(FP16Max)                                    \
+  V(StringGetCharsNoCheck)                      \
+  V(StringStringIndexOf)                        \
+  V(StringStringIndexOfAfter)                   \
+  V(StringNewStringFromBytes)                   \
+  V(StringNewStringFromChars)                   \
+  V(StringNewStringFromString)                  \
+  V(StringBufferAppend)                         \
+  V(StringBufferLength)                         \
+  V(StringBufferToString)                       \
+  V(StringBuilderAppendObject)                  \
+  V(StringBuilderAppendString)                  \
+  V(StringBuilderAppendCharSequence)            \
+  V(StringBuilderAppendCharArray)               \
+  V(StringBuilderAppendBoolean)                 \
+  V(StringBuilderAppendChar)                    \
+  V(StringBuilderAppendInt)                     \
+  V(StringBuilderAppendLong)                    \
+  V(StringBuilderAppendFloat)                   \
+  V(StringBuilderAppendDouble)                  \
+  V(StringBuilderLength)                        \
+  V(StringBuilderToString)                      \
+  V(ReferenceGetReferent)                       \
+  V(ReferenceRefersTo)                          \
+  V(IntegerValueOf)                             \
+  V(CRC32Update)                                \
+  V(CRC32UpdateBytes)                           \
+  V(CRC32UpdateByteBuffer)
+
+class CodeGeneratorRISCV64;
+
+class InvokeRuntimeCallingConvention : public CallingConvention<XRegister, FRegister> {
+ public:
+  InvokeRuntimeCallingConvention()
+      : CallingConvention(kRuntimeParameterCoreRegisters,
+                          kRuntimeParameterCoreRegistersLength,
+                          kRuntimeParameterFpuRegisters,
+                          kRuntimeParameterFpuRegistersLength,
+                          kRiscv64PointerSize) {}
+
+  Location GetReturnLocation(DataType::Type return_type);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(InvokeRuntimeCallingConvention);
+};
+
+class InvokeDexCallingConvention : public CallingConvention<XRegister, FRegister> {
+ public:
+  InvokeDexCallingConvention()
+      : CallingConvention(kParameterCoreRegisters,
+                          kParameterCoreRegistersLength,
+                          kParameterFpuRegisters,
+                          kParameterFpuRegistersLength,
+                          kRiscv64PointerSize) {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(InvokeDexCallingConvention);
+};
+
+class InvokeDexCallingConventionVisitorRISCV64 : public InvokeDexCallingConventionVisitor {
+ public:
+  InvokeDexCallingConventionVisitorRISCV64() {}
+  virtual ~InvokeDexCallingConventionVisitorRISCV64() {}
+
+  Location GetNextLocation(DataType::Type type) override;
+  Location GetReturnLocation(DataType::Type type) const override;
+  Location GetMethodLocation() const override;
+
+ private:
+  InvokeDexCallingConvention calling_convention;
+
+  DISALLOW_COPY_AND_ASSIGN(InvokeDexCallingConventionVisitorRISCV64);
+};
+
+class FieldAccessCallingConventionRISCV64 : public FieldAccessCallingConvention {
+ public:
+  FieldAccessCallingConventionRISCV64() {}
+
+  Location GetObjectLocation() const override {
+    return Location::RegisterLocation(A1);
+  }
+  Location GetFieldIndexLocation() const override {
+    return Location::RegisterLocation(A0);
+  }
+  Location GetReturnLocation(DataType::Type type ATTRIBUTE_UNUSED) const override {
+    return Location::RegisterLocation(A0);
+  }
+  Location GetSetValueLocation(DataType::Type type ATTRIBUTE_UNUSED,
+                               bool is_instance) const override {
+    return is_instance
+        ? Location::RegisterLocation(A2)
+        : Location::RegisterLocation(A1);
+  }
+  Location GetFpuLocation(DataType::Type type ATTRIBUTE_UNUSED) const override {
+    return Location::FpuRegisterLocation(FA0);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(FieldAccessCallingConventionRISCV64);
+};
+
+class SlowPathCodeRISCV64 : public SlowPathCode {
+ public:
+  explicit SlowPathCodeRISCV64(HInstruction* instruction)
+      : SlowPathCode(instruction), entry_label_(), exit_label_() {}
+
+  Riscv64Label* GetEntryLabel() { return &entry_label_; }
+  Riscv64Label* GetExitLabel() { return &exit_label_; }
+
+ private:
+  Riscv64Label entry_label_;
+  Riscv64Label exit_label_;
+
+  DISALLOW_COPY_AND_ASSIGN(SlowPathCodeRISCV64);
+};
+
+class ParallelMoveResolverRISCV64 : public ParallelMoveResolverWithSwap {
+ public:
+  ParallelMoveResolverRISCV64(ArenaAllocator* allocator, CodeGeneratorRISCV64* codegen)
+      : ParallelMoveResolverWithSwap(allocator), codegen_(codegen) {}
+
+  void EmitMove(size_t index) override;
+  void EmitSwap(size_t index) override;
+  void SpillScratch(int reg) override;
+  void RestoreScratch(int reg) override;
+
+  void Exchange(int index1, int index2, bool double_slot);
+
+  Riscv64Assembler* GetAssembler() const;
+
+ private:
+  CodeGeneratorRISCV64* const codegen_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMoveResolverRISCV64);
+};
+
+class LocationsBuilderRISCV64 : public HGraphVisitor {
+ public:
+  LocationsBuilderRISCV64(HGraph* graph, CodeGeneratorRISCV64* codegen)
+      : HGraphVisitor(graph), codegen_(codegen) {}
+
+#define DECLARE_VISIT_INSTRUCTION(name, super) void Visit##name(H##name* instr) override;
+
+  FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+  // The only shared instruction used on riscv64, for the Zbb extension.
+  void VisitBitwiseNegatedRight(HBitwiseNegatedRight* instruction) override;
+
+  void VisitInstruction(HInstruction* instruction) override {
+    LOG(FATAL) << "Unreachable instruction " << instruction->DebugName()
+               << " (id " << instruction->GetId() << ")";
+  }
+
+ private:
+  void HandleInvoke(HInvoke* invoke);
+  void HandleBinaryOp(HBinaryOperation* operation);
+  void HandleCondition(HCondition* instruction);
+  void HandleShift(HBinaryOperation* operation);
+  void HandleFieldSet(HInstruction* instruction);
+  void HandleFieldGet(HInstruction* instruction);
+
+  // Unlike other architectures, riscv64 has no instruction which takes an immediate and
+  // subtracts it, so only constants whose negation fits into the 12-bit immediate of
+  // ADDI(W) are encodable for HSub.
+  Location RegisterOrIntConstantForBinaryOp(HBinaryOperation* instruction, HInstruction* input);
+
+  InvokeDexCallingConventionVisitorRISCV64 parameter_visitor_;
+
+  CodeGeneratorRISCV64* const codegen_;
+
+  DISALLOW_COPY_AND_ASSIGN(LocationsBuilderRISCV64);
+};
+
+class InstructionCodeGeneratorRISCV64 : public InstructionCodeGenerator {
+ public:
+  InstructionCodeGeneratorRISCV64(HGraph* graph, CodeGeneratorRISCV64* codegen);
+
+#define DECLARE_VISIT_INSTRUCTION(name, super) void Visit##name(H##name* instr) override;
+
+  FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+  // The only shared instruction used on riscv64, for the Zbb extension.
+  void VisitBitwiseNegatedRight(HBitwiseNegatedRight* instruction) override;
+
+  void VisitInstruction(HInstruction* instruction) override {
+    LOG(FATAL) << "Unreachable instruction " << instruction->DebugName()
+               << " (id " << instruction->GetId() << ")";
+  }
+
+  Riscv64Assembler* GetAssembler() const { return assembler_; }
+
+  void GenerateMemoryBarrier(MemBarrierKind kind);
+
+  // Generate a GC root reference load:
+  //
+  //   root <- *(obj + offset)
+  //
+  // while honoring read barriers based on read_barrier_option. If `label_low` is not null,
+  // it is bound to the load, whose placeholder `offset` is patched later.
+  void GenerateGcRootFieldLoad(HInstruction* instruction,
+                               Location root,
+                               XRegister obj,
+                               uint32_t offset,
+                               ReadBarrierOption read_barrier_option,
+                               Riscv64Label* label_low = nullptr);
+
+ private:
+  // Generate code for the given suspend check. If not null, `successor`
+  // is the block to branch to if the suspend check is not needed, and after
+  // the suspend call.
+  void GenerateSuspendCheck(HSuspendCheck* instruction, HBasicBlock* successor);
+  void GenerateClassInitializationCheck(SlowPathCodeRISCV64* slow_path, XRegister class_reg);
+  void HandleBinaryOp(HBinaryOperation* operation);
+  void HandleCondition(HCondition* instruction);
+  void HandleShift(HBinaryOperation* operation);
+  void HandleFieldSet(HInstruction* instruction,
+                      const FieldInfo& field_info,
+                      bool value_can_be_null,
+                      WriteBarrierKind write_barrier_kind);
+  void HandleFieldGet(HInstruction* instruction, const FieldInfo& field_info);
+  void HandleGoto(HInstruction* instruction, HBasicBlock* successor);
+  void GenerateMethodEntryExitHook(HInstruction* instruction);
+  // Compare the bitstring of the class in `temp` with the one of `check`, leaving zero
+  // in `temp` if the class is a subtype of `check`.
+  void GenerateBitstringTypeCheckCompare(HTypeCheckInstruction* check, XRegister temp);
+
+  void GenerateMinMax(HBinaryOperation* minmax, bool is_min);
+  // Compute `rd = (rs1 << shift) + rs2`, using SH1ADD, SH2ADD or SH3ADD if Zba is available.
+  void ShNAdd(XRegister rd, XRegister rs1, XRegister rs2, size_t shift);
+  void GenerateDivRemIntegral(HBinaryOperation* instruction);
+  void GenerateRemFP(HRem* rem);
+
+  // Materialize the result of an integral or FP condition `cond` with inputs `lhs` and `rhs`
+  // in the core register `dst`.
+  void GenerateIntLongCondition(IfCondition cond,
+                                LocationSummary* locations,
+                                XRegister dst);
+  void GenerateFpCondition(IfCondition cond,
+                           bool gt_bias,
+                           DataType::Type type,
+                           LocationSummary* locations,
+                           XRegister dst);
+  // Branch to `label` if the condition `cond` holds for the integral inputs.
+  void GenerateIntLongCompareAndBranch(IfCondition cond,
+                                       LocationSummary* locations,
+                                       Riscv64Label* label);
+  void GenerateTestAndBranch(HInstruction* instruction,
+                             size_t condition_input_index,
+                             Riscv64Label* true_target,
+                             Riscv64Label* false_target);
+
+  // Generate a heap reference load using one register `out`:
+  //
+  //   out <- *(out + offset)
+  //
+  // while honoring heap poisoning and/or read barriers (if any).
+  //
+  // Location `maybe_temp` is used when generating a read barrier and
+  // shall be a register in that case; it may be an invalid location
+  // otherwise.
+  void GenerateReferenceLoadOneRegister(HInstruction* instruction,
+                                        Location out,
+                                        uint32_t offset,
+                                        Location maybe_temp,
+                                        ReadBarrierOption read_barrier_option);
+  // Generate a heap reference load using two different registers
+  // `out` and `obj`:
+  //
+  //   out <- *(obj + offset)
+  //
+  // while honoring heap poisoning and/or read barriers (if any).
+  //
+  // Location `maybe_temp` is used when generating a Baker's (fast
+  // path) read barrier and shall be a register in that case; it may
+  // be an invalid location otherwise.
+  void GenerateReferenceLoadTwoRegisters(HInstruction* instruction,
+                                         Location out,
+                                         Location obj,
+                                         uint32_t offset,
+                                         Location maybe_temp,
+                                         ReadBarrierOption read_barrier_option);
+
+  // Emit `vsetivli` for the vector length and element type of `instruction`, unless
+  // the immediately preceding vector instruction already set up the same configuration.
+  void SetVectorType(HVecOperation* instruction,
+                     VectorTailPolicy vta = VectorTailPolicy::kAgnostic);
+  // Same as above for a whole-register configuration of another element type, used by
+  // operations whose inputs and result have different packed types.
+  void SetVectorType(HVecOperation* instruction,
+                     DataType::Type type,
+                     size_t vector_length,
+                     VectorTailPolicy vta = VectorTailPolicy::kAgnostic);
+  // Extend the `chunk`-th parts of the narrow vectors `a` and `b` of `narrow_type` to the
+  // packed type of `instruction` in `tmp2` and `tmp0` respectively; `tmp1` is clobbered.
+  void GenerateVecExtendedChunks(HVecOperation* instruction,
+                                 DataType::Type narrow_type,
+                                 bool is_unsigned,
+                                 size_t chunk,
+                                 VRegister a,
+                                 VRegister b,
+                                 VRegister tmp0,
+                                 VRegister tmp1,
+                                 VRegister tmp2);
+  // Compute the address of the first accessed element of a vector load or store in TMP.
+  XRegister VecAddress(HVecMemoryOperation* instruction);
+
+  Riscv64Assembler* const assembler_;
+  CodeGeneratorRISCV64* const codegen_;
+
+  // The last instruction for which `SetVectorType()` emitted a `vsetivli`, with its operands.
+  HInstruction* last_vector_instruction_;
+  uint32_t last_vector_length_;
+  uint32_t last_vtypei_;
+
+  DISALLOW_COPY_AND_ASSIGN(InstructionCodeGeneratorRISCV64);
+};
+
+class CodeGeneratorRISCV64 : public CodeGenerator {
+ public:
+  CodeGeneratorRISCV64(HGraph* graph,
+                       const CompilerOptions& compiler_options,
+                       OptimizingCompilerStats* stats = nullptr);
+  virtual ~CodeGeneratorRISCV64() {}
+
+  void GenerateFrameEntry() override;
+  void GenerateFrameExit() override;
+
+  void Bind(HBasicBlock* block) override;
+
+  size_t GetWordSize() const override { return kRiscv64DoublewordSize; }
+
+  size_t GetSlowPathFPWidth() const override {
+    // V registers do not alias F registers, so a slow path in a graph with SIMD
+    // saves both the F register and the V register with the same number.
+    return GetGraph()->HasSIMD()
+        ? kRiscv64DoublewordSize + GetSIMDRegisterWidth()
+        : kRiscv64DoublewordSize;
+  }
+
+  size_t GetCalleePreservedFPWidth() const override { return kRiscv64DoublewordSize; }
+
+  size_t GetSIMDRegisterWidth() const override {
+    return GetInstructionSetFeatures().HasVector()
+        ? kRiscv64VectorRegisterSize
+        : kRiscv64DoublewordSize;
+  }
+
+  uintptr_t GetAddressOf(HBasicBlock* block) override {
+    return assembler_.GetLabelLocation(GetLabelOf(block));
+  }
+
+  Riscv64Label* GetLabelOf(HBasicBlock* block) const {
+    return CommonGetLabelOf<Riscv64Label>(block_labels_, block);
+  }
+
+  void Initialize() override { block_labels_ = CommonInitializeLabels<Riscv64Label>(); }
+
+  void MoveConstant(Location destination, int32_t value) override;
+  void MoveLocation(Location destination, Location source, DataType::Type dst_type) override;
+  void AddLocationAsTemp(Location location, LocationSummary* locations) override;
+
+  Riscv64Assembler* GetAssembler() override { return &assembler_; }
+  const Riscv64Assembler& GetAssembler() const override { return assembler_; }
+
+  HGraphVisitor* GetLocationBuilder() override { return &location_builder_; }
+
+  HGraphVisitor* GetInstructionVisitor() override { return &instruction_visitor_; }
+
+  InstructionCodeGeneratorRISCV64* GetInstructionCodegen() { return &instruction_visitor_; }
+
+  void SetupBlockedRegisters() const override;
+
+  size_t SaveCoreRegister(size_t stack_index, uint32_t reg_id) override;
+  size_t RestoreCoreRegister(size_t stack_index, uint32_t reg_id) override;
+  size_t SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) override;
+  size_t RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) override;
+
+  void DumpCoreRegister(std::ostream& stream, int reg) const override;
+  void DumpFloatingPointRegister(std::ostream& stream, int reg) const override;
+
+  InstructionSet GetInstructionSet() const override { return InstructionSet::kRiscv64; }
+
+  const Riscv64InstructionSetFeatures& GetInstructionSetFeatures() const;
+
+  // Fix up branches and adjust the native PC offsets recorded before branch promotion.
+  void Finalize(CodeAllocator* allocator) override;
+
+  void EmitLinkerPatches(ArenaVector<linker::LinkerPatch>* linker_patches) override;
+  bool NeedsThunkCode(const linker::LinkerPatch& patch) const override;
+  void EmitThunkCode(const linker::LinkerPatch& patch,
+                     /*out*/ ArenaVector<uint8_t>* code,
+                     /*out*/ std::string* debug_name) override;
+
+  void EmitJitRootPatches(uint8_t* code, const uint8_t* roots_data) override;
+
+  // The PcRelativePatchInfo is used for PC-relative addressing of methods/strings/types,
+  // whether through .data.bimg.rel.ro, .bss, or directly in the boot image.
+  //
+  // The 32-bit PC-relative offset is split into the high 20 bits in the `AUIPC` and the
+  // low 12 bits in the following `ADDI` or load. The patch for the low part records the
+  // label of the `AUIPC` in `pc_insn_label`, the patch for the high part points to itself.
+  struct PcRelativePatchInfo : PatchInfo<Riscv64Label> {
+    PcRelativePatchInfo(const DexFile* dex_file, uint32_t off_or_idx)
+        : PatchInfo<Riscv64Label>(dex_file, off_or_idx), pc_insn_label() {}
+
+    const Riscv64Label* pc_insn_label;
+  };
+
+  // The JitPatchInfo is used for loading GC roots from the JIT roots table. The table is
+  // in the low 4GiB, so its entries are addressed with a `LUI` for the high 20 bits
+  // and a load with the low 12 bits of the absolute address.
+  struct JitPatchInfo {
+    JitPatchInfo(const DexFile& dex_file, uint64_t idx) : target_dex_file(dex_file), index(idx) {}
+
+    const DexFile& target_dex_file;
+    // String or type index.
+    uint64_t index;
+    // Label for the `LUI` of the high part of the address.
+    Riscv64Label lui_label;
+    // Label for the load with the low part of the address.
+    Riscv64Label load_label;
+  };
+
+  // Add a new patch for the `AUIPC` (pass `info_high = null`) or for the `ADDI` or load
+  // (pass `info_high` pointing to the patch of the associated `AUIPC`) of a PC-relative
+  // sequence and return the patch info with the label to bind before the instruction.
+  PcRelativePatchInfo* NewBootImageRelRoPatch(uint32_t boot_image_offset,
+                                              const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageMethodPatch(MethodReference target_method,
+                                               const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewMethodBssEntryPatch(MethodReference target_method,
+                                              const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageTypePatch(const DexFile& dex_file,
+                                             dex::TypeIndex type_index,
+                                             const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBssEntryTypePatch(HLoadClass* load_class,
+                                            const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageStringPatch(const DexFile& dex_file,
+                                               dex::StringIndex string_index,
+                                               const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewStringBssEntryPatch(const DexFile& dex_file,
+                                              dex::StringIndex string_index,
+                                              const PcRelativePatchInfo* info_high = nullptr);
+
+  // Emit the placeholder instructions of a PC-relative sequence, see `PcRelativePatchInfo`.
+  void EmitPcRelativeAuipcPlaceholder(PcRelativePatchInfo* info_high, XRegister out);
+  void EmitPcRelativeAddiPlaceholder(PcRelativePatchInfo* info_low, XRegister rd, XRegister rs1);
+  void EmitPcRelativeLwuPlaceholder(PcRelativePatchInfo* info_low, XRegister rd, XRegister rs1);
+  void EmitPcRelativeLdPlaceholder(PcRelativePatchInfo* info_low, XRegister rd, XRegister rs1);
+
+  // Add a new JIT root patch, reserving the root in the JIT roots table, and emit the
+  // `LUI` for the high part of its address in `out`. The caller binds the `load_label`
+  // of the returned patch info to the load of the root from `out`.
+  JitPatchInfo* NewJitStringPatch(const DexFile& dex_file,
+                                  dex::StringIndex string_index,
+                                  Handle<mirror::String> handle,
+                                  XRegister out);
+  JitPatchInfo* NewJitClassPatch(const DexFile& dex_file,
+                                 dex::TypeIndex type_index,
+                                 Handle<mirror::Class> handle,
+                                 XRegister out);
+
+  void LoadBootImageRelRoEntry(XRegister reg, uint32_t boot_image_offset);
+
+  // Generate code to invoke a runtime entry point.
+  void InvokeRuntime(QuickEntrypointEnum entrypoint,
+                     HInstruction* instruction,
+                     uint32_t dex_pc,
+                     SlowPathCode* slow_path = nullptr) override;
+
+  // Generate code to invoke a runtime entry point, but do not record
+  // PC-related information in a stack map.
+  void InvokeRuntimeWithoutRecordingPcInfo(int32_t entry_point_offset,
+                                           HInstruction* instruction,
+                                           SlowPathCode* slow_path);
+
+  // Emit a `JAL RA` to a shared entrypoint thunk, patched at link time.
+  void EmitEntrypointThunkCall(ThreadOffset64 entrypoint_offset);
+
+  ParallelMoveResolverRISCV64* GetMoveResolver() override { return &move_resolver_; }
+
+  bool NeedsTwoRegisters(DataType::Type type ATTRIBUTE_UNUSED) const override { return false; }
+
+  // Check if the desired_string_load_kind is supported. If it is, return it,
+  // otherwise return a fall-back kind that should be used instead.
+  HLoadString::LoadKind GetSupportedLoadStringKind(
+      HLoadString::LoadKind desired_string_load_kind) override;
+
+  // Check if the desired_class_load_kind is supported. If it is, return it,
+  // otherwise return a fall-back kind that should be used instead.
+  HLoadClass::LoadKind GetSupportedLoadClassKind(
+      HLoadClass::LoadKind desired_class_load_kind) override;
+
+  // Check if the desired_dispatch_info is supported. If it is, return it,
+  // otherwise return a fall-back info that should be used instead.
+  HInvokeStaticOrDirect::DispatchInfo GetSupportedInvokeStaticOrDirectDispatch(
+      const HInvokeStaticOrDirect::DispatchInfo& desired_dispatch_info,
+      ArtMethod* method) override;
+
+  void LoadMethod(MethodLoadKind load_kind, Location temp, HInvoke* invoke);
+  void GenerateStaticOrDirectCall(HInvokeStaticOrDirect* invoke,
+                                  Location temp,
+                                  SlowPathCode* slow_path = nullptr) override;
+  void GenerateVirtualCall(HInvokeVirtual* invoke,
+                           Location temp,
+                           SlowPathCode* slow_path = nullptr) override;
+  void MoveFromReturnRegister(Location trg, DataType::Type type) override;
+
+  // When compiling baseline, count the receiver class of `instruction` in its inline cache.
+  // The class must be in A0.
+  void MaybeGenerateInlineCacheCheck(HInstruction* instruction, XRegister klass);
+  // Decrement the hotness counters, and jump to the optimizing compiler when the baseline
+  // hotness counter reaches zero.
+  void MaybeIncrementHotness(bool is_frame_entry);
+
+  void IncreaseFrame(size_t adjustment) override;
+  void DecreaseFrame(size_t adjustment) override;
+
+  void GenerateNop() override;
+
+  void GenerateImplicitNullCheck(HNullCheck* instruction) override;
+  void GenerateExplicitNullCheck(HNullCheck* instruction) override;
+
+  // Emit a write barrier.
+  void MarkGCCard(XRegister object, XRegister value, bool value_can_be_null);
+
+  // Fast path implementation of ReadBarrier::Barrier for a heap reference load
+  // `ref <- *(obj + offset + (index << 2))` when Baker's read barriers are used.
+  // The `index` is invalid for field loads. The `temp` register receives the lock word.
+  void GenerateReferenceLoadWithBakerReadBarrier(HInstruction* instruction,
+                                                 Location ref,
+                                                 XRegister obj,
+                                                 uint32_t offset,
+                                                 Location index,
+                                                 Location temp,
+                                                 bool needs_null_check);
+
+  // Load or store a value of the given type from/to `base + offset`.
+  void LoadFromMemory(DataType::Type type, Location dst, XRegister base, int32_t offset);
+  void StoreToMemory(DataType::Type type, Location src, XRegister base, int32_t offset);
+
+  // Load or store the `kRiscv64VectorRegisterSize` bytes of a SIMD value from/to `SP + offset`.
+  // Clobbers TMP and the vector configuration.
+  void LoadSIMDRegFromStack(VRegister vd, int32_t offset);
+  void StoreSIMDRegToStack(VRegister vs, int32_t offset);
+
+ private:
+  PcRelativePatchInfo* NewPcRelativePatch(const DexFile* dex_file,
+                                          uint32_t offset_or_index,
+                                          const PcRelativePatchInfo* info_high,
+                                          ArenaDeque<PcRelativePatchInfo>* patches);
+
+  template <linker::LinkerPatch (*Factory)(size_t, const DexFile*, uint32_t, uint32_t)>
+  void EmitPcRelativeLinkerPatches(const ArenaDeque<PcRelativePatchInfo>& infos,
+                                   ArenaVector<linker::LinkerPatch>* linker_patches);
+
+  void PatchJitRootUse(uint8_t* code,
+                       const uint8_t* roots_data,
+                       const JitPatchInfo& info,
+                       uint64_t index_in_table) const;
+
+  // Labels for each block that will be compiled.
+  Riscv64Label* block_labels_;  // Indexed by block id.
+  Riscv64Label frame_entry_label_;
+
+  LocationsBuilderRISCV64 location_builder_;
+  InstructionCodeGeneratorRISCV64 instruction_visitor_;
+  ParallelMoveResolverRISCV64 move_resolver_;
+  Riscv64Assembler assembler_;
+
+  // PC-relative method patch info for kBootImageLinkTimePcRelative.
+  ArenaDeque<PcRelativePatchInfo> boot_image_method_patches_;
+  // PC-relative method patch info for kBssEntry.
+  ArenaDeque<PcRelativePatchInfo> method_bss_entry_patches_;
+  // PC-relative type patch info for kBootImageLinkTimePcRelative.
+  ArenaDeque<PcRelativePatchInfo> boot_image_type_patches_;
+  // PC-relative type patch info for kBssEntry.
+  ArenaDeque<PcRelativePatchInfo> type_bss_entry_patches_;
+  // PC-relative public type patch info for kBssEntryPublic.
+  ArenaDeque<PcRelativePatchInfo> public_type_bss_entry_patches_;
+  // PC-relative package type patch info for kBssEntryPackage.
+  ArenaDeque<PcRelativePatchInfo> package_type_bss_entry_patches_;
+  // PC-relative String patch info for kBootImageLinkTimePcRelative.
+  ArenaDeque<PcRelativePatchInfo> boot_image_string_patches_;
+  // PC-relative String patch info for kBssEntry.
+  ArenaDeque<PcRelativePatchInfo> string_bss_entry_patches_;
+  // PC-relative patch info for method/type/string patches for kBootImageRelRo.
+  ArenaDeque<PcRelativePatchInfo> boot_image_other_patches_;
+  // Patches for entrypoint calls through shared thunks; the label marks the `JAL` to patch.
+  ArenaDeque<PatchInfo<Riscv64Label>> call_entrypoint_patches_;
+
+  // Patches for string root accesses in JIT compiled code.
+  ArenaDeque<JitPatchInfo> jit_string_patches_;
+  // Patches for class root accesses in JIT compiled code.
+  ArenaDeque<JitPatchInfo> jit_class_patches_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeGeneratorRISCV64);
+};
+
+}  // namespace riscv64
+}  // namespace art
 
 #endif  // ART_COMPILER_OPTIMIZING_CODE_GENERATOR_RISCV64_H_
@@ -0,0 +1,1160 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_generator_riscv64.h"
+
+#include "mirror/array-inl.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+// Vector values are kept in the V register with the same number as the FP register assigned
+// by the register allocator. The loop vectorizer needs a compile-time vector length, so every
+// vector operation works on `kRiscv64VectorRegisterSize` bytes set up by `vsetivli` with LMUL=1.
+
+#define __ GetAssembler()->
+
+void InstructionCodeGeneratorRISCV64::SetVectorType(HVecOperation* instruction,
+                                                    VectorTailPolicy vta) {
+  SetVectorType(instruction, instruction->GetPackedType(), instruction->GetVectorLength(), vta);
+}
+
+void InstructionCodeGeneratorRISCV64::SetVectorType(HVecOperation* instruction,
+                                                    DataType::Type type,
+                                                    size_t vector_length,
+                                                    VectorTailPolicy vta) {
+  SelectedElementWidth sew;
+  switch (DataType::Size(type)) {
+    case 1u:
+      sew = SelectedElementWidth::kE8;
+      break;
+    case 2u:
+      sew = SelectedElementWidth::kE16;
+      break;
+    case 4u:
+      sew = SelectedElementWidth::kE32;
+      break;
+    case 8u:
+      sew = SelectedElementWidth::kE64;
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << type;
+      UNREACHABLE();
+  }
+  uint32_t vl = dchecked_integral_cast<uint32_t>(vector_length);
+  DCHECK_EQ(vl * DataType::Size(type), kRiscv64VectorRegisterSize);
+  uint32_t vtypei =
+      VTypeiValue(VectorMaskPolicy::kAgnostic, vta, sew, LengthMultiplier::kM1);
+  // The configuration survives only until the next instruction that may emit code changing
+  // it (moves to and from SIMD stack slots, slow paths, calls), so reuse it only when it was
+  // set up by this instruction or by the vector instruction immediately preceding it.
+  if (last_vector_instruction_ == nullptr ||
+      (last_vector_instruction_ != instruction &&
+       instruction->GetPrevious() != last_vector_instruction_) ||
+      last_vector_length_ != vl ||
+      last_vtypei_ != vtypei) {
+    __ VSetivli(Zero, vl, vtypei);
+    last_vector_length_ = vl;
+    last_vtypei_ = vtypei;
+  }
+  last_vector_instruction_ = instruction;
+}
+
+XRegister InstructionCodeGeneratorRISCV64::VecAddress(HVecMemoryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XRegister base = locations->InAt(0).AsRegister<XRegister>();
+  Location index = locations->InAt(1);
+  size_t size = DataType::Size(instruction->GetPackedType());
+  size_t shift = DataType::SizeShift(instruction->GetPackedType());
+  int32_t offset = mirror::Array::DataOffset(size).Int32Value();
+  DCHECK(!instruction->IsVecLoad() || !instruction->AsVecLoad()->IsStringCharAt());
+  if (index.IsConstant()) {
+    int64_t value = CodeGenerator::GetInt64ValueOf(index.GetConstant());
+    __ AddConst64(TMP, base, (value << shift) + offset);
+  } else {
+    ShNAdd(TMP, index.AsRegister<XRegister>(), base, shift);
+    DCHECK(IsInt<12>(offset));
+    __ Addi(TMP, TMP, offset);
+  }
+  return TMP;
+}
+
+void LocationsBuilderRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  HInstruction* input = instruction->InputAt(0);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      if (input->IsConstant() && IsInt<5>(CodeGenerator::GetInt64ValueOf(input->AsConstant()))) {
+        locations->SetInAt(0, Location::ConstantLocation(input));
+      } else {
+        locations->SetInAt(0, Location::RequiresRegister());
+      }
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      if (IsZeroBitPattern(input)) {
+        locations->SetInAt(0, Location::ConstantLocation(input));
+      } else {
+        locations->SetInAt(0, Location::RequiresFpuRegister());
+      }
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Location src_loc = locations->InAt(0);
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  if (src_loc.IsConstant()) {
+    // Any zero bit pattern of a floating point constant is also an integer zero.
+    __ VMv_vi(dst, dchecked_integral_cast<int32_t>(
+                       CodeGenerator::GetInt64ValueOf(src_loc.GetConstant())));
+    return;
+  }
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMv_vx(dst, src_loc.AsRegister<XRegister>());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFMv_vf(dst, src_loc.AsFpuRegister<FRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMv_xs(locations->Out().AsRegister<XRegister>(), src);  // Sign-extends to 64 bits.
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFMv_fs(locations->Out().AsFpuRegister<FRegister>(), src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector unary operations.
+static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecReduce(HVecReduce* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      switch (instruction->GetReductionKind()) {
+        case HVecReduce::kSum:
+          // The reduction adds the scalar element 0 of the last operand, start from zero.
+          __ VMv_sx(dst, Zero);
+          __ VRedsum_vs(dst, src, dst);
+          break;
+        case HVecReduce::kMin:
+          __ VRedmin_vs(dst, src, src);
+          break;
+        case HVecReduce::kMax:
+          __ VRedmax_vs(dst, src, src);
+          break;
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecCnv(HVecCnv* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecCnv(HVecCnv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  DataType::Type from = instruction->GetInputType();
+  DataType::Type to = instruction->GetResultType();
+  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    DCHECK_EQ(4u, instruction->GetVectorLength());
+    SetVectorType(instruction);
+    __ VFCvt_f_x_v(dst, src);
+  } else {
+    LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecNeg(HVecNeg* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecNeg(HVecNeg* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VNeg_v(dst, src);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFNeg_v(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAbs(HVecAbs* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAbs(HVecAbs* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      // abs(x) = max(x, -x); the output does not overlap the input.
+      __ VRsub_vi(dst, src, 0);
+      __ VMax_vv(dst, src, dst);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFAbs_v(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecNot(HVecNot* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecNot(HVecNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:  // special case boolean-not
+      __ VXor_vi(dst, src, 1);
+      break;
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VNot_v(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector binary operations.
+static void CreateVecBinOpLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAdd(HVecAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAdd(HVecAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VAdd_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFAdd_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kUint16:
+      __ VSaddu_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+      __ VSadd_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  // The averaging adds round according to `vxrm`: round-to-nearest-up adds the carry of
+  // the rounded halving add, round-down truncates.
+  __ Csrwi(kCsrVxrm, instruction->IsRounded() ? kVxrmRnu : kVxrmRdn);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kUint16:
+      __ VAaddu_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+      __ VAadd_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSub(HVecSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSub(HVecSub* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VSub_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFSub_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kUint16:
+      __ VSsubu_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+      __ VSsub_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMul(HVecMul* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMul(HVecMul* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMul_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFMul_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecDiv(HVecDiv* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecDiv(HVecDiv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFDiv_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMin(HVecMin* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMin(HVecMin* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  // Note: `vfmin` does not have the Java semantics for NaN inputs, so there is no FP case.
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kUint16:
+      __ VMinu_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMin_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMax(HVecMax* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMax(HVecMax* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  // Note: `vfmax` does not have the Java semantics for NaN inputs, so there is no FP case.
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kUint16:
+      __ VMaxu_vv(dst, lhs, rhs);
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMax_vv(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAnd(HVecAnd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAnd(HVecAnd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  __ VAnd_vv(dst, lhs, rhs);  // lanes do not matter
+}
+
+void LocationsBuilderRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  __ VNot_v(VTMP, lhs);  // lanes do not matter
+  __ VAnd_vv(dst, VTMP, rhs);
+}
+
+void LocationsBuilderRISCV64::VisitVecOr(HVecOr* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecOr(HVecOr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  __ VOr_vv(dst, lhs, rhs);  // lanes do not matter
+}
+
+void LocationsBuilderRISCV64::VisitVecXor(HVecXor* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecXor(HVecXor* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  __ VXor_vv(dst, lhs, rhs);  // lanes do not matter
+}
+
+// Helper to set up locations for vector shift operations.
+static void CreateVecShiftLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::ConstantLocation(instruction->InputAt(1)));
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecShl(HVecShl* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecShl(HVecShl* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  uint32_t value = dchecked_integral_cast<uint32_t>(
+      CodeGenerator::GetInt64ValueOf(locations->InAt(1).GetConstant()));
+  SetVectorType(instruction);
+  if (IsUint<5>(value)) {
+    __ VSll_vi(dst, lhs, value);
+  } else {
+    __ Li(TMP, value);
+    __ VSll_vx(dst, lhs, TMP);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecShr(HVecShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecShr(HVecShr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  uint32_t value = dchecked_integral_cast<uint32_t>(
+      CodeGenerator::GetInt64ValueOf(locations->InAt(1).GetConstant()));
+  SetVectorType(instruction);
+  if (IsUint<5>(value)) {
+    __ VSra_vi(dst, lhs, value);
+  } else {
+    __ Li(TMP, value);
+    __ VSra_vx(dst, lhs, TMP);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecUShr(HVecUShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecUShr(HVecUShr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  uint32_t value = dchecked_integral_cast<uint32_t>(
+      CodeGenerator::GetInt64ValueOf(locations->InAt(1).GetConstant()));
+  SetVectorType(instruction);
+  if (IsUint<5>(value)) {
+    __ VSrl_vi(dst, lhs, value);
+  } else {
+    __ Li(TMP, value);
+    __ VSrl_vx(dst, lhs, TMP);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  HInstruction* input = instruction->InputAt(0);
+  bool is_zero = IsZeroBitPattern(input);
+
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input)
+                                    : Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input)
+                                    : Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister dst = VRegisterFrom(locations->Out());
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  // Element 0 is set with `vl` = 1 semantics by `vmv.s.x`/`vfmv.s.f`, so the other elements
+  // are tail elements and must be left undisturbed.
+  SetVectorType(instruction, VectorTailPolicy::kUndisturbed);
+
+  // Zero out all other elements first.
+  __ VMv_vi(dst, 0);
+
+  // Shorthand for any type of zero.
+  if (IsZeroBitPattern(instruction->InputAt(0))) {
+    return;
+  }
+
+  // Set required elements.
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMv_sx(dst, locations->InAt(0).AsRegister<XRegister>());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFMv_sf(dst, locations->InAt(0).AsFpuRegister<FRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector accumulations.
+static void CreateVecAccumLocations(ArenaAllocator* allocator, HVecOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetInAt(2, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate* instruction) {
+  CreateVecAccumLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMultiplyAccumulate(
+    HVecMultiplyAccumulate* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister acc = VRegisterFrom(locations->InAt(0));
+  VRegister left = VRegisterFrom(locations->InAt(1));
+  VRegister right = VRegisterFrom(locations->InAt(2));
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  SetVectorType(instruction);
+  if (instruction->GetOpKind() == HInstruction::kAdd) {
+    __ VMacc_vv(acc, left, right);
+  } else {
+    __ VNmsac_vv(acc, left, right);
+  }
+}
+
+// Helper to set up locations for the widening accumulations, which extend the parts of
+// the narrow inputs matching the accumulator lanes one at a time.
+static void CreateVecWideAccumLocations(ArenaAllocator* allocator, HVecOperation* instruction) {
+  CreateVecAccumLocations(allocator, instruction);
+  LocationSummary* locations = instruction->GetLocations();
+  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  if (DataType::Size(a->GetPackedType()) != DataType::Size(instruction->GetPackedType())) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::GenerateVecExtendedChunks(HVecOperation* instruction,
+                                                               DataType::Type narrow_type,
+                                                               bool is_unsigned,
+                                                               size_t chunk,
+                                                               VRegister a,
+                                                               VRegister b,
+                                                               VRegister tmp0,
+                                                               VRegister tmp1,
+                                                               VRegister tmp2) {
+  size_t ratio = DataType::Size(instruction->GetPackedType()) / DataType::Size(narrow_type);
+  DCHECK_LT(chunk, ratio);
+  if (chunk != 0u) {
+    // Move the narrow elements of this chunk to the bottom of the registers.
+    size_t narrow_length = kRiscv64VectorRegisterSize / DataType::Size(narrow_type);
+    SetVectorType(instruction, narrow_type, narrow_length);
+    uint32_t offset = dchecked_integral_cast<uint32_t>(chunk * instruction->GetVectorLength());
+    __ VSlidedown_vi(tmp0, a, offset);
+    __ VSlidedown_vi(tmp1, b, offset);
+    a = tmp0;
+    b = tmp1;
+  }
+  SetVectorType(instruction);
+  switch (ratio) {
+    case 2u:
+      if (is_unsigned) {
+        __ VZext_vf2(tmp2, a);
+        __ VZext_vf2(tmp0, b);
+      } else {
+        __ VSext_vf2(tmp2, a);
+        __ VSext_vf2(tmp0, b);
+      }
+      break;
+    case 4u:
+      if (is_unsigned) {
+        __ VZext_vf4(tmp2, a);
+        __ VZext_vf4(tmp0, b);
+      } else {
+        __ VSext_vf4(tmp2, a);
+        __ VSext_vf4(tmp0, b);
+      }
+      break;
+    case 8u:
+      if (is_unsigned) {
+        __ VZext_vf8(tmp2, a);
+        __ VZext_vf8(tmp0, b);
+      } else {
+        __ VSext_vf8(tmp2, a);
+        __ VSext_vf8(tmp0, b);
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  CreateVecWideAccumLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister acc = VRegisterFrom(locations->InAt(0));
+  VRegister left = VRegisterFrom(locations->InAt(1));
+  VRegister right = VRegisterFrom(locations->InAt(2));
+  VRegister tmp0 = VRegisterFrom(locations->GetTemp(0));
+  VRegister tmp1 = VRegisterFrom(locations->GetTemp(1));
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+
+  // Handle all feasible acc_T += sad(a_S, b_S) type combinations (T x S). The lanes of the
+  // accumulator sum different input lanes than on other architectures, which is fine as
+  // the accumulator is only ever reduced as a whole.
+  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
+  HVecOperation* b = instruction->InputAt(2)->AsVecOperation();
+  DCHECK_EQ(HVecOperation::ToSignedType(a->GetPackedType()),
+            HVecOperation::ToSignedType(b->GetPackedType()));
+  size_t ratio = DataType::Size(instruction->GetPackedType()) / DataType::Size(a->GetPackedType());
+  if (ratio == 1u) {
+    SetVectorType(instruction);
+    __ VSub_vv(tmp0, left, right);
+    __ VNeg_v(tmp1, tmp0);
+    __ VMax_vv(tmp0, tmp0, tmp1);
+    __ VAdd_vv(acc, acc, tmp0);
+    return;
+  }
+  VRegister tmp2 = VRegisterFrom(locations->GetTemp(2));
+  bool is_unsigned = DataType::IsUnsignedType(a->GetPackedType());
+  for (size_t chunk = 0u; chunk != ratio; ++chunk) {
+    GenerateVecExtendedChunks(
+        instruction, a->GetPackedType(), is_unsigned, chunk, left, right, tmp0, tmp1, tmp2);
+    __ VSub_vv(tmp2, tmp2, tmp0);
+    __ VNeg_v(tmp0, tmp2);
+    __ VMax_vv(tmp2, tmp2, tmp0);
+    __ VAdd_vv(acc, acc, tmp2);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
+  DCHECK(instruction->GetPackedType() == DataType::Type::kInt32);
+  CreateVecWideAccumLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  VRegister acc = VRegisterFrom(locations->InAt(0));
+  VRegister left = VRegisterFrom(locations->InAt(1));
+  VRegister right = VRegisterFrom(locations->InAt(2));
+  VRegister tmp0 = VRegisterFrom(locations->GetTemp(0));
+  VRegister tmp1 = VRegisterFrom(locations->GetTemp(1));
+  VRegister tmp2 = VRegisterFrom(locations->GetTemp(2));
+  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
+  HVecOperation* b = instruction->InputAt(2)->AsVecOperation();
+  DCHECK_EQ(HVecOperation::ToSignedType(a->GetPackedType()),
+            HVecOperation::ToSignedType(b->GetPackedType()));
+  DCHECK_EQ(instruction->GetPackedType(), DataType::Type::kInt32);
+  DCHECK_EQ(4u, instruction->GetVectorLength());
+
+  // As for the SAD accumulation, the accumulator lanes need not match other architectures.
+  size_t ratio = DataType::Size(instruction->GetPackedType()) / DataType::Size(a->GetPackedType());
+  DCHECK(ratio == 2u || ratio == 4u) << ratio;
+  for (size_t chunk = 0u; chunk != ratio; ++chunk) {
+    GenerateVecExtendedChunks(instruction,
+                              a->GetPackedType(),
+                              instruction->IsZeroExtending(),
+                              chunk,
+                              left,
+                              right,
+                              tmp0,
+                              tmp1,
+                              tmp2);
+    __ VMacc_vv(acc, tmp2, tmp0);
+  }
+}
+
+// Helper to set up locations for vector memory operations.
+static void CreateVecMemLocations(ArenaAllocator* allocator,
+                                  HVecMemoryOperation* instruction,
+                                  bool is_load) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+      if (is_load) {
+        locations->SetOut(Location::RequiresFpuRegister());
+      } else {
+        locations->SetInAt(2, Location::RequiresFpuRegister());
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecLoad(HVecLoad* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ true);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecLoad(HVecLoad* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister reg = VRegisterFrom(locations->Out());
+  SetVectorType(instruction);
+  XRegister address = VecAddress(instruction);
+  switch (DataType::Size(instruction->GetPackedType())) {
+    case 1u:
+      __ VLe8(reg, address);
+      break;
+    case 2u:
+      __ VLe16(reg, address);
+      break;
+    case 4u:
+      __ VLe32(reg, address);
+      break;
+    case 8u:
+      __ VLe64(reg, address);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecStore(HVecStore* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ false);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecStore(HVecStore* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister reg = VRegisterFrom(locations->InAt(2));
+  SetVectorType(instruction);
+  XRegister address = VecAddress(instruction);
+  switch (DataType::Size(instruction->GetPackedType())) {
+    case 1u:
+      __ VSe8(reg, address);
+      break;
+    case 2u:
+      __ VSe16(reg, address);
+      break;
+    case 4u:
+      __ VSe32(reg, address);
+      break;
+    case 8u:
+      __ VSe64(reg, address);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecPredSetAll(HVecPredSetAll* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  DCHECK(instruction->InputAt(0)->IsIntConstant());
+  locations->SetInAt(0, Location::NoLocation());
+  locations->SetOut(Location::NoLocation());
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredSetAll(HVecPredSetAll*) {
+}
+
+void LocationsBuilderRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // The governing predicate of a whole-register loop is a prefix of the lanes, so it is
+  // kept in a core register as the number of active lanes, ready for use as the AVL of
+  // a `vsetvli`. Mask registers are not exposed to the register allocator.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
+  // Instruction is not predicated, see nodes_vector.h
+  DCHECK(!instruction->IsPredicated());
+  // Current implementation of predicated loop execution only supports kLO condition.
+  DCHECK(instruction->GetCondKind() == HVecPredWhile::CondKind::kLO);
+  LocationSummary* locations = instruction->GetLocations();
+  XRegister left = locations->InAt(0).AsRegister<XRegister>();
+  XRegister right = locations->InAt(1).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  // out = (left <u right) ? min(right - left, vector_length) : 0
+  Riscv64Label done;
+  __ Mv(out, Zero);
+  __ Bgeu(left, right, &done);
+  __ Sub(out, right, left);
+  __ Li(TMP, dchecked_integral_cast<int64_t>(instruction->GetVectorLength()));
+  __ Bltu(out, TMP, &done);
+  __ Mv(out, TMP);
+  __ Bind(&done);
+}
+
+void LocationsBuilderRISCV64::VisitVecPredCondition(HVecPredCondition* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // Result of the operation - a boolean value in a core register.
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredCondition(HVecPredCondition* instruction) {
+  // Instruction is not predicated, see nodes_vector.h
+  DCHECK(!instruction->IsPredicated());
+  LocationSummary* locations = instruction->GetLocations();
+  XRegister active_lanes = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  // Currently VecPredCondition is only used as part of vectorized loop check condition
+  // evaluation. The first lane is inactive exactly when no lane is active.
+  DCHECK(instruction->GetPCondKind() == HVecPredCondition::PCondKind::kNFirst);
+  __ Seqz(out, active_lanes);
+}
+
+#undef __
+
+}  // namespace riscv64
+}  // namespace art
@@ -3005,11 +3005,24 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    NearLabel done;
+    NearLabel update_cache, done;
+    uint32_t sampling_interval = GetCompilerOptions().GetInlineCacheSamplingInterval();
+    if (sampling_interval != 1u) {
+      // Only update the inline cache once every `sampling_interval` calls of this thread.
+      Address countdown = Address::Absolute(
+          Thread::InlineCacheSampleCountdownOffset<kX86_64PointerSize>().Int32Value(),
+          /* no_rip= */ true);
+      __ gs()->addl(countdown, Immediate(-1));
+      __ j(kNotEqual, &done);
+      __ gs()->movl(countdown, Immediate(sampling_interval));
+    }
     __ movq(CpuRegister(TMP), Immediate(address));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache: only count the receiver.
     __ cmpl(Address(CpuRegister(TMP), InlineCache::ClassesOffset().Int32Value()), klass);
-    __ j(kEqual, &done);
+    __ j(kNotEqual, &update_cache);
+    __ addl(Address(CpuRegister(TMP), InlineCache::CountsOffset().Int32Value()), Immediate(1));
+    __ jmp(&done);
+    __ Bind(&update_cache);
     GenerateInvokeRuntime(
         GetThreadOffset<kX86_64PointerSize>(kQuickUpdateInlineCache).Int32Value());
     __ Bind(&done);
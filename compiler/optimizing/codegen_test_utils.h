@@ -334,7 +334,10 @@ inline CodeGenerator* create_codegen_arm64(HGraph* graph, const CompilerOptions&
 #endif
 
 #ifdef ART_ENABLE_CODEGEN_riscv64
-inline CodeGenerator* create_codegen_riscv64(HGraph*, const CompilerOptions&) { return nullptr; }
+inline CodeGenerator* create_codegen_riscv64(HGraph* graph,
+                                            const CompilerOptions& compiler_options) {
+  return new (graph->GetAllocator()) riscv64::CodeGeneratorRISCV64(graph, compiler_options);
+}
 #endif
 
 #ifdef ART_ENABLE_CODEGEN_x86
@@ -631,7 +631,8 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
                                     DataType::ToSigned(arg_type));
   }
 
-#if defined(ART_ENABLE_CODEGEN_arm) || defined(ART_ENABLE_CODEGEN_arm64)
+#if defined(ART_ENABLE_CODEGEN_arm) || defined(ART_ENABLE_CODEGEN_arm64) || \
+    defined(ART_ENABLE_CODEGEN_riscv64)
   void VisitMultiplyAccumulate(HMultiplyAccumulate* instruction) override {
     StartAttributeStream("kind") << instruction->GetOpKind();
   }
@@ -648,6 +649,12 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
   }
 #endif
 
+#if defined(ART_ENABLE_CODEGEN_riscv64)
+  void VisitRiscv64ShiftAdd(HRiscv64ShiftAdd* instruction) override {
+    StartAttributeStream("distance") << instruction->GetDistance();
+  }
+#endif
+
   bool IsPass(const char* name) {
     return strcmp(pass_name_, name) == 0;
   }
@@ -16,6 +16,9 @@
 
 #include "inliner.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"
@@ -69,6 +72,14 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // recursive calls at all.
 static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 
+// Receivers of a polymorphic call that account for less than this percentage of the calls
+// recorded in the inline cache are not worth the code size of inlining their target.
+static constexpr uint64_t kMinimumInlinedTargetWeightPercent = 5;
+
+// Limit the number of targets inlined for a megamorphic call, which always keeps the
+// original invoke as the fallback.
+static constexpr size_t kMaximumNumberOfMegamorphicInlinedTargets = 3;
+
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
@@ -373,6 +384,9 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
     // We do not support HDeoptimize in OSR methods.
     return nullptr;
   }
+  if (outermost_graph_->HasDeoptimizedBefore(DeoptimizationKind::kCHA)) {
+    return nullptr;
+  }
   PointerSize pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
   ArtMethod* single_impl = resolved_method->GetSingleImplementation(pointer_size);
   if (single_impl == nullptr) {
@@ -581,7 +595,12 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  //
+  // For methods that deoptimized on an inline cache guard before:
+  //     Deoptimizing again would lead to a compile and deoptimize loop.
+  return Runtime::Current()->IsAotCompiler() ||
+         outermost_graph_->IsCompilingOsr() ||
+         outermost_graph_->HasDeoptimizedBefore(DeoptimizationKind::kJitInlineCache);
 }
 bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -590,12 +609,13 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 
   StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+  InlineCacheCounts counts = {};
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
           ? GetInlineCacheAOT(invoke_instruction, &classes)
-          : GetInlineCacheJIT(invoke_instruction, &classes);
+          : GetInlineCacheJIT(invoke_instruction, &classes, &counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -616,7 +636,7 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
       if (UseOnlyPolymorphicInliningWithNoDeopt()) {
-        return TryInlinePolymorphicCall(invoke_instruction, classes);
+        return TryInlinePolymorphicCall(invoke_instruction, classes, counts);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, classes);
       }
@@ -624,15 +644,18 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
     case kInlineCachePolymorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kPolymorphicCall);
-      return TryInlinePolymorphicCall(invoke_instruction, classes);
+      return TryInlinePolymorphicCall(invoke_instruction, classes, counts);
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      if (TryInlinePolymorphicCall(invoke_instruction, classes, counts, /*is_megamorphic=*/ true)) {
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << invoke_instruction->GetMethodReference().PrettyMethod()
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -649,7 +672,8 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/InlineCacheCounts* counts) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
   ArtMethod* caller = graph_->GetArtMethod();
@@ -662,7 +686,8 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
 
   Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
       *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-      classes);
+      classes,
+      counts);
   return GetInlineCacheType(*classes);
 }
 
@@ -952,23 +977,64 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
 
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    const InlineCacheCounts& counts,
+    bool is_megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  if (!is_megamorphic && TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
     return true;
   }
 
+  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
+  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+  uint64_t total_count = 0u;
+  for (size_t i = 0; i != number_of_types; ++i) {
+    total_count += counts[i];
+  }
+  // The last entry of a megamorphic cache is overwritten by every new receiver, so its class
+  // is not representative of its count. Only consider the other entries.
+  size_t number_of_candidates = number_of_types;
+  if (is_megamorphic) {
+    DCHECK_EQ(number_of_types, InlineCache::kIndividualCacheSize);
+    if (total_count == 0u) {
+      // No counts, e.g. the inline cache comes from an offline profile.
+      return false;
+    }
+    number_of_candidates = number_of_types - 1u;
+  }
+
+  // Order the candidates by decreasing count so that the type guards of the most frequent
+  // receivers come first. The sort is stable so that, without counts, we keep the order in
+  // which the receivers were first seen.
+  std::array<size_t, InlineCache::kIndividualCacheSize> order;
+  std::iota(order.begin(), order.begin() + number_of_candidates, 0u);
+  std::stable_sort(order.begin(),
+                   order.begin() + number_of_candidates,
+                   [&](size_t lhs, size_t rhs) { return counts[lhs] > counts[rhs]; });
+
   ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
   PointerSize pointer_size = class_linker->GetImagePointerSize();
 
-  bool all_targets_inlined = true;
+  bool all_targets_inlined = !is_megamorphic;
   bool one_target_inlined = false;
-  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
-  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
-  for (size_t i = 0; i != number_of_types; ++i) {
+  size_t number_of_inlined_targets = 0u;
+  for (size_t position = 0; position != number_of_candidates; ++position) {
+    size_t i = order[position];
     DCHECK(classes.GetReference(i) != nullptr);
+    if (total_count != 0u &&
+        uint64_t{counts[i]} * 100u < total_count * kMinimumInlinedTargetWeightPercent) {
+      // This receiver and all the following ones are too rare to be worth inlining.
+      LOG_NOTE() << "Not inlining the " << (number_of_candidates - position)
+                 << " least frequent target(s) of polymorphic call to "
+                 << invoke_instruction->GetMethodReference().PrettyMethod();
+      all_targets_inlined = false;
+      break;
+    }
+    if (is_megamorphic && number_of_inlined_targets == kMaximumNumberOfMegamorphicInlinedTargets) {
+      break;
+    }
     Handle<mirror::Class> handle =
         graph_->GetHandleCache()->NewHandle(classes.GetReference(i)->AsClass());
     ArtMethod* method = ResolveMethodFromInlineCache(handle, invoke_instruction, pointer_size);
@@ -1023,7 +1089,7 @@ bool HInliner::TryInlinePolymorphicCall(
       // we deoptimize instead of keeping the original invoke instruction.
       bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
           all_targets_inlined &&
-          (i + 1 == number_of_types);
+          (position + 1 == number_of_candidates);
 
       HInstruction* compare = AddTypeGuard(receiver,
                                            cursor,
@@ -1037,6 +1103,7 @@ bool HInliner::TryInlinePolymorphicCall(
       } else {
         CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
       }
+      ++number_of_inlined_targets;
     }
   }
 
@@ -1048,7 +1115,9 @@ bool HInliner::TryInlinePolymorphicCall(
     return false;
   }
 
-  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+  MaybeRecordStat(stats_,
+                  is_megamorphic ? MethodCompilationStat::kInlinedMegamorphicCall
+                                 : MethodCompilationStat::kInlinedPolymorphicCall);
 
   // Run type propagation to get the guards typed.
   ReferenceTypePropagation rtp_fixup(graph_,
@@ -1225,7 +1294,8 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->IsCompilingOsr() ||
+      outermost_graph_->HasDeoptimizedBefore(DeoptimizationKind::kJitSameTarget)) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
@@ -2166,6 +2236,11 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
 
   size_t number_of_instructions = 0;
   if (!CanInlineBody(callee_graph, invoke_instruction, &number_of_instructions, is_speculative)) {
+    if (!is_speculative) {
+      // The callee is the only possible target of the invoke, so what it returns for these
+      // arguments is what the invoke returns.
+      MaybeRefineReturnTypeFromCallee(callee_graph, invoke_instruction);
+    }
     return false;
   }
 
@@ -2344,6 +2419,60 @@ bool HInliner::ReturnTypeMoreSpecific(HInstruction* return_replacement,
   return false;
 }
 
+void HInliner::MaybeRefineReturnTypeFromCallee(const HGraph* callee_graph,
+                                               HInvoke* invoke_instruction) {
+  if (invoke_instruction->GetType() != DataType::Type::kReference ||
+      callee_graph->GetExitBlock() == nullptr) {
+    return;
+  }
+  ReferenceTypeInfo invoke_rti = invoke_instruction->GetReferenceTypeInfo();
+  if (!invoke_rti.IsValid() || invoke_rti.IsExact()) {
+    return;
+  }
+
+  // Only refine when all the non-null values returned have the same type.
+  HInstruction* returned_value = nullptr;
+  for (HBasicBlock* predecessor : callee_graph->GetExitBlock()->GetPredecessors()) {
+    HInstruction* last_instruction = predecessor->GetLastInstruction();
+    if (last_instruction->IsTryBoundary()) {
+      last_instruction = predecessor->GetSinglePredecessor()->GetLastInstruction();
+    }
+    if (last_instruction->IsThrow()) {
+      continue;
+    }
+    DCHECK(last_instruction->IsReturn());
+    HInstruction* value = last_instruction->InputAt(0);
+    if (value->IsNullConstant()) {
+      continue;
+    }
+    if (!value->GetReferenceTypeInfo().IsValid()) {
+      return;
+    }
+    if (returned_value == nullptr) {
+      returned_value = value;
+    } else if (!returned_value->GetReferenceTypeInfo().IsEqual(value->GetReferenceTypeInfo())) {
+      return;
+    }
+  }
+
+  if (returned_value == nullptr ||
+      !IsReferenceTypeRefinement(invoke_rti.GetTypeHandle().Get(),
+                                 invoke_rti.IsExact(),
+                                 /*declared_can_be_null=*/ false,
+                                 returned_value)) {
+    return;
+  }
+
+  LOG_NOTE() << "Refined return type of " << callee_graph->GetArtMethod()->PrettyMethod()
+             << " to " << returned_value->GetReferenceTypeInfo();
+  invoke_instruction->SetReferenceTypeInfo(returned_value->GetReferenceTypeInfo());
+  MaybeRecordStat(stats_, MethodCompilationStat::kRefinedReturnTypeFromCallee);
+  // Propagate the new type to the users of the invoke.
+  ReferenceTypePropagation(graph_,
+                           outer_compilation_unit_.GetDexCache(),
+                           /* is_first_run= */ false).Run();
+}
+
 void HInliner::FixUpReturnReferenceType(ArtMethod* resolved_method,
                                         HInstruction* return_replacement) {
   if (return_replacement != nullptr) {
@@ -17,6 +17,8 @@
 #ifndef ART_COMPILER_OPTIMIZING_INLINER_H_
 #define ART_COMPILER_OPTIMIZING_INLINER_H_
 
+#include <array>
+
 #include "base/macros.h"
 #include "dex/dex_file_types.h"
 #include "dex/invoke_type.h"
@@ -73,6 +75,10 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  // Number of times each class of an inline cache has been seen, in the same order as the
+  // classes. All zero when the inline cache comes from an offline profile.
+  using InlineCacheCounts = std::array<uint32_t, InlineCache::kIndividualCacheSize>;
+
   bool TryInline(HInvoke* invoke_instruction);
 
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
@@ -185,7 +191,8 @@ class HInliner : public HOptimization {
   // invoke info was found in the profile info.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
-      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/InlineCacheCounts* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
@@ -209,9 +216,16 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. The targets are tried in decreasing order of
+  // `counts` and the type guards are emitted in that order. Targets seen too rarely are not
+  // inlined and the original invoke is kept as the fallback for them.
+  //
+  // For a megamorphic call, only the most frequent targets are inlined, and the original
+  // invoke is always kept as the fallback.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
-                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                const InlineCacheCounts& counts,
+                                bool is_megamorphic = false)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(
@@ -253,6 +267,11 @@ class HInliner : public HOptimization {
   bool ReturnTypeMoreSpecific(HInstruction* return_replacement, HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Use the types of the values returned by `callee_graph`, which could not be inlined, to
+  // refine the type of `invoke_instruction`.
+  void MaybeRefineReturnTypeFromCallee(const HGraph* callee_graph, HInvoke* invoke_instruction)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Add a type guard on the given `receiver`. This will add to the graph:
   // i0 = HFieldGet(receiver, klass)
   // i1 = HLoadClass(class_index, is_referrer)
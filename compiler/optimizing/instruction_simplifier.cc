@@ -30,6 +30,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "sharpening.h"
 #include "string_builder_append.h"
+#include "well_known_classes.h"
 
 namespace art HIDDEN {
 
@@ -114,6 +115,7 @@ class InstructionSimplifierVisitor final : public HGraphDelegateVisitor {
   void VisitDeoptimize(HDeoptimize* deoptimize) override;
   void VisitVecMul(HVecMul* instruction) override;
   void VisitPredicatedInstanceFieldGet(HPredicatedInstanceFieldGet* instruction) override;
+  void VisitInstanceFieldGet(HInstanceFieldGet* instruction) override;
   void SimplifySystemArrayCopy(HInvoke* invoke);
   void SimplifyStringEquals(HInvoke* invoke);
   void SimplifyFP2Int(HInvoke* invoke);
@@ -1008,6 +1010,28 @@ void InstructionSimplifierVisitor::VisitPredicatedInstanceFieldGet(
   }
 }
 
+void InstructionSimplifierVisitor::VisitInstanceFieldGet(HInstanceFieldGet* instruction) {
+  // Fold `Integer.valueOf(x).intValue()` (with `intValue()` inlined) to `x`. The `Integer` comes
+  // either from the boot image cache or from a new allocation, and its final `value` is `x` in
+  // both cases. The `valueOf()` call is then removed by DCE if it has no other uses.
+  if (instruction->GetType() != DataType::Type::kInt32) {
+    return;
+  }
+  HInstruction* object = instruction->InputAt(0);
+  while (object->IsNullCheck() || object->IsBoundType()) {
+    object = object->InputAt(0);
+  }
+  if (!object->IsInvoke() || object->AsInvoke()->GetIntrinsic() != Intrinsics::kIntegerValueOf) {
+    return;
+  }
+  if (instruction->GetFieldInfo().GetField() != WellKnownClasses::java_lang_Integer_value) {
+    return;
+  }
+  instruction->ReplaceWith(object->InputAt(0));
+  instruction->GetBlock()->RemoveInstruction(instruction);
+  RecordSimplification();
+}
+
 void InstructionSimplifierVisitor::VisitSelect(HSelect* select) {
   HInstruction* replace_with = nullptr;
   HInstruction* condition = select->GetCondition();
@@ -2624,6 +2648,28 @@ static bool NoEscapeForStringBufferReference(HInstruction* reference, HInstructi
   return false;
 }
 
+// Returns whether `input` is known to be a java.lang.String.
+static bool IsKnownString(HInstruction* input) {
+  ReferenceTypeInfo rti = input->GetReferenceTypeInfo();
+  if (!rti.IsValid()) {
+    return false;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  Handle<mirror::Class> input_type = rti.GetTypeHandle();
+  DCHECK(input_type != nullptr);
+  return input_type.Get() == GetClassRoot<mirror::String>();
+}
+
+// Returns the instruction before `instruction` in a chain of blocks starting with `first_block`
+// where each block is the single predecessor of the next one, or null at the start of the chain.
+static HInstruction* GetPreviousInChain(HInstruction* instruction, HBasicBlock* first_block) {
+  if (instruction->GetPrevious() != nullptr) {
+    return instruction->GetPrevious();
+  }
+  HBasicBlock* block = instruction->GetBlock();
+  return (block == first_block) ? nullptr : block->GetSinglePredecessor()->GetLastInstruction();
+}
+
 static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   DCHECK_EQ(invoke->GetIntrinsic(), Intrinsics::kStringBuilderToString);
   if (invoke->CanThrowIntoCatchBlock()) {
@@ -2639,10 +2685,27 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
     return false;
   }
 
-  // For now, we support only single-block recognition.
+  // We support the uses of the StringBuilder being in a chain of blocks from the block of the
+  // StringBuilder to the block of the StringBuilder.toString(), where each block is the single
+  // predecessor of the next one and has no other successor, so that there is no control flow
+  // between the uses. This chain is the path between the two blocks in the dominator tree.
   // (Ternary operators feeding the append could be implemented.)
+  HBasicBlock* sb_block = sb->GetBlock();
+  for (HBasicBlock* current = block; current != sb_block; ) {
+    if (current->GetPredecessors().size() != 1u) {
+      return false;
+    }
+    current = current->GetSinglePredecessor();
+    if (current->GetSuccessors().size() != 1u || current->IsTryBlock()) {
+      return false;
+    }
+  }
+  auto is_in_chain = [&](HBasicBlock* b) {
+    return sb_block->Dominates(b) && b->Dominates(block);
+  };
+
   for (const HUseListNode<HInstruction*>& use : sb->GetUses()) {
-    if (use.GetUser()->GetBlock() != block) {
+    if (!is_in_chain(use.GetUser()->GetBlock()) || use.GetUser()->IsPhi()) {
       return false;
     }
     // The append pattern uses the StringBuilder only as the first argument.
@@ -2661,8 +2724,9 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   uint32_t num_args = 0u;
   bool has_fp_args = false;
   HInstruction* args[StringBuilderAppend::kMaxArgs];  // Added in reverse order.
-  for (HBackwardInstructionIterator iter(block->GetInstructions()); !iter.Done(); iter.Advance()) {
-    HInstruction* user = iter.Current();
+  for (HInstruction* user = block->GetLastInstruction();
+       user != nullptr;
+       user = GetPreviousInChain(user, sb_block)) {
     // Instructions of interest apply to `sb`, skip those that do not involve `sb`.
     if (user->InputCount() == 0u || user->InputAt(0u) != sb) {
       continue;
@@ -2714,14 +2778,7 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
           has_fp_args = true;
           break;
         case Intrinsics::kStringBuilderAppendCharSequence: {
-          ReferenceTypeInfo rti = user->AsInvokeVirtual()->InputAt(1)->GetReferenceTypeInfo();
-          if (!rti.IsValid()) {
-            return false;
-          }
-          ScopedObjectAccess soa(Thread::Current());
-          Handle<mirror::Class> input_type = rti.GetTypeHandle();
-          DCHECK(input_type != nullptr);
-          if (input_type.Get() == GetClassRoot<mirror::String>()) {
+          if (IsKnownString(as_invoke_virtual->InputAt(1))) {
             arg = StringBuilderAppend::Argument::kString;
           } else {
             // TODO: Check and implement for StringBuilder. We could find the StringBuilder's
@@ -2748,11 +2805,35 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
     } else if (user->IsInvokeStaticOrDirect() &&
                user->AsInvokeStaticOrDirect()->GetResolvedMethod() != nullptr &&
                user->AsInvokeStaticOrDirect()->GetResolvedMethod()->IsConstructor() &&
-               user->AsInvokeStaticOrDirect()->GetNumberOfArguments() == 1u) {
+               user->AsInvokeStaticOrDirect()->GetNumberOfArguments() <= 2u) {
       // After arguments, we should see the constructor.
-      // We accept only the constructor with no extra arguments.
+      // We accept the constructor with no extra arguments, the constructor with a capacity if
+      // it cannot throw, and the constructors with initial contents if those are a String that
+      // cannot be null.
       DCHECK(!seen_constructor);
       DCHECK(!seen_constructor_fence);
+      if (user->AsInvokeStaticOrDirect()->GetNumberOfArguments() == 2u) {
+        HInstruction* input = user->InputAt(1u);
+        if (input->GetType() == DataType::Type::kInt32) {
+          // StringBuilder(int) throws for a negative capacity.
+          if (!input->IsIntConstant() || input->AsIntConstant()->GetValue() < 0) {
+            return false;
+          }
+        } else {
+          // StringBuilder(String) and StringBuilder(CharSequence) throw for a null argument.
+          DCHECK_EQ(input->GetType(), DataType::Type::kReference);
+          if (input->CanBeNull() || !IsKnownString(input)) {
+            return false;
+          }
+          if (num_args == StringBuilderAppend::kMaxArgs) {
+            return false;
+          }
+          format = (format << StringBuilderAppend::kBitsPerArg) |
+                   static_cast<uint32_t>(StringBuilderAppend::Argument::kString);
+          args[num_args] = input;
+          ++num_args;
+        }
+      }
       seen_constructor = true;
     } else if (user->IsConstructorFence()) {
       // The last use we see is the constructor fence.
@@ -2771,7 +2852,7 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   // Check environment uses.
   for (const HUseListNode<HEnvironment*>& use : sb->GetEnvUses()) {
     HInstruction* holder = use.GetUser()->GetHolder();
-    if (holder->GetBlock() != block) {
+    if (!is_in_chain(holder->GetBlock())) {
       return false;
     }
     // Accept only calls on the StringBuilder (which shall all be removed).
@@ -2808,10 +2889,11 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   block->RemoveInstruction(invoke);
   // Remove the StringBuilder's uses and StringBuilder.
   while (sb->HasNonEnvironmentUses()) {
-    block->RemoveInstruction(sb->GetUses().front().GetUser());
+    HInstruction* user = sb->GetUses().front().GetUser();
+    user->GetBlock()->RemoveInstruction(user);
   }
   DCHECK(!sb->HasEnvironmentUses());
-  block->RemoveInstruction(sb);
+  sb_block->RemoveInstruction(sb);
   return true;
 }
 
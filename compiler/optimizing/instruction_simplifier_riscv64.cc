@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "instruction_simplifier_riscv64.h"
+
+#include "code_generator_riscv64.h"
+#include "instruction_simplifier_shared.h"
+
+namespace art HIDDEN {
+
+namespace riscv64 {
+
+class InstructionSimplifierRiscv64Visitor final : public HGraphVisitor {
+ public:
+  InstructionSimplifierRiscv64Visitor(HGraph* graph,
+                                      CodeGenerator* codegen,
+                                      OptimizingCompilerStats* stats)
+      : HGraphVisitor(graph),
+        codegen_(down_cast<CodeGeneratorRISCV64*>(codegen)),
+        stats_(stats) {}
+
+  void RecordSimplification() {
+    MaybeRecordStat(stats_, MethodCompilationStat::kInstructionSimplificationsArch);
+  }
+
+  bool HasZba() const {
+    return codegen_->GetInstructionSetFeatures().HasZba();
+  }
+
+  bool HasZbb() const {
+    return codegen_->GetInstructionSetFeatures().HasZbb();
+  }
+
+  void VisitBasicBlock(HBasicBlock* block) override {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsInBlock()) {
+        instruction->Accept(this);
+      }
+    }
+  }
+
+  void VisitAdd(HAdd* instruction) override;
+  void VisitAnd(HAnd* instruction) override;
+  void VisitOr(HOr* instruction) override;
+  void VisitXor(HXor* instruction) override;
+
+ private:
+  bool TryReplaceAddWithShiftAdd(HAdd* add);
+
+  CodeGeneratorRISCV64* codegen_;
+  OptimizingCompilerStats* stats_;
+};
+
+// Replace
+//    SHL tmp, src, #distance   (distance = 1, 2 or 3)
+//    ADD dst, tmp, other
+// with
+//    SHxADD dst, src, other
+bool InstructionSimplifierRiscv64Visitor::TryReplaceAddWithShiftAdd(HAdd* add) {
+  if (add->GetType() != DataType::Type::kInt64) {
+    return false;
+  }
+  auto get_distance = [](HInstruction* instruction) -> uint32_t {
+    if (!instruction->IsShl() || !instruction->HasOnlyOneNonEnvironmentUse()) {
+      return 0u;
+    }
+    HInstruction* distance = instruction->AsShl()->GetRight();
+    if (!distance->IsIntConstant()) {
+      return 0u;
+    }
+    uint32_t value =
+        static_cast<uint32_t>(distance->AsIntConstant()->GetValue()) & kMaxLongShiftDistance;
+    return (value >= 1u && value <= 3u) ? value : 0u;
+  };
+
+  HInstruction* shl = add->GetLeft();
+  HInstruction* other = add->GetRight();
+  uint32_t distance = get_distance(shl);
+  if (distance == 0u) {
+    std::swap(shl, other);
+    distance = get_distance(shl);
+    if (distance == 0u) {
+      return false;
+    }
+  }
+
+  HRiscv64ShiftAdd* shift_add = new (GetGraph()->GetAllocator())
+      HRiscv64ShiftAdd(shl->AsShl()->GetLeft(), other, distance, add->GetDexPc());
+  add->GetBlock()->ReplaceAndRemoveInstructionWith(add, shift_add);
+  shl->GetBlock()->RemoveInstruction(shl);
+  return true;
+}
+
+void InstructionSimplifierRiscv64Visitor::VisitAdd(HAdd* instruction) {
+  if (HasZba() && TryReplaceAddWithShiftAdd(instruction)) {
+    RecordSimplification();
+  }
+}
+
+void InstructionSimplifierRiscv64Visitor::VisitAnd(HAnd* instruction) {
+  if (HasZbb() && TryMergeNegatedInput(instruction)) {
+    RecordSimplification();
+  }
+}
+
+void InstructionSimplifierRiscv64Visitor::VisitOr(HOr* instruction) {
+  if (HasZbb() && TryMergeNegatedInput(instruction)) {
+    RecordSimplification();
+  }
+}
+
+void InstructionSimplifierRiscv64Visitor::VisitXor(HXor* instruction) {
+  if (HasZbb() && TryMergeNegatedInput(instruction)) {
+    RecordSimplification();
+  }
+}
+
+bool InstructionSimplifierRiscv64::Run() {
+  InstructionSimplifierRiscv64Visitor visitor(graph_, codegen_, stats_);
+  if (visitor.HasZba() || visitor.HasZbb()) {
+    visitor.VisitReversePostOrder();
+    return true;
+  }
+  return false;
+}
+
+}  // namespace riscv64
+}  // namespace art
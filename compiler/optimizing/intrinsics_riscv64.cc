@@ -0,0 +1,2387 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "intrinsics_riscv64.h"
+
+#include <limits>
+
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "art_field.h"
+#include "code_generator_riscv64.h"
+#include "intrinsics.h"
+#include "intrinsics_utils.h"
+#include "mirror/array-inl.h"
+#include "mirror/class.h"
+#include "mirror/string.h"
+#include "mirror/var_handle.h"
+#include "thread.h"
+#include "utils/riscv64/assembler_riscv64.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+using IntrinsicSlowPathRISCV64 = IntrinsicSlowPath<InvokeDexCallingConventionVisitorRISCV64,
+                                                   SlowPathCodeRISCV64,
+                                                   Riscv64Assembler>;
+
+// Vector configuration used by the string and array kernels below. Each kernel strip-mines
+// its loop with `vsetvli`, so it works with any VLEN. Only LMUL=1 is used since the data
+// registers are single registers taken from the FP temps (or VTMP).
+static constexpr uint32_t kE8M1VTypei = VTypeiValue(VectorMaskPolicy::kAgnostic,
+                                                    VectorTailPolicy::kAgnostic,
+                                                    SelectedElementWidth::kE8,
+                                                    LengthMultiplier::kM1);
+static constexpr uint32_t kE16M1VTypei = VTypeiValue(VectorMaskPolicy::kAgnostic,
+                                                     VectorTailPolicy::kAgnostic,
+                                                     SelectedElementWidth::kE16,
+                                                     LengthMultiplier::kM1);
+static constexpr uint32_t kE32M1VTypei = VTypeiValue(VectorMaskPolicy::kAgnostic,
+                                                     VectorTailPolicy::kAgnostic,
+                                                     SelectedElementWidth::kE32,
+                                                     LengthMultiplier::kM1);
+
+// Result bits of the FCLASS.S/FCLASS.D instructions.
+static constexpr int32_t kFClassNegativeInfinity = 1 << 0;
+static constexpr int32_t kFClassPositiveInfinity = 1 << 7;
+
+// IEEE 754 double precision layout, used by the rounding intrinsics.
+static constexpr int32_t kDoubleMantissaBits = 52;
+static constexpr int32_t kDoubleExponentBits = 11;
+static constexpr int32_t kDoubleExponentBias = 1023;
+
+// Above this size in bytes, prefer libcore's native implementation of System.arraycopy() for
+// primitive arrays.
+static constexpr int32_t kSystemArrayCopyPrimitiveThresholdBytes = 384;
+
+static constexpr int32_t SystemArrayCopyPrimitiveThreshold(DataType::Type type) {
+  return kSystemArrayCopyPrimitiveThresholdBytes >> DataType::SizeShift(type);
+}
+
+IntrinsicLocationsBuilderRISCV64::IntrinsicLocationsBuilderRISCV64(CodeGeneratorRISCV64* codegen)
+    : allocator_(codegen->GetGraph()->GetAllocator()), codegen_(codegen) {}
+
+bool IntrinsicLocationsBuilderRISCV64::TryDispatch(HInvoke* invoke) {
+  Dispatch(invoke);
+  LocationSummary* res = invoke->GetLocations();
+  if (res == nullptr) {
+    return false;
+  }
+  return res->Intrinsified();
+}
+
+Riscv64Assembler* IntrinsicCodeGeneratorRISCV64::GetAssembler() {
+  return codegen_->GetAssembler();
+}
+
+ArenaAllocator* IntrinsicCodeGeneratorRISCV64::GetAllocator() {
+  return codegen_->GetGraph()->GetAllocator();
+}
+
+#define __ assembler->
+
+static void CreateFPToIntLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+static void CreateIntToFPLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresFpuRegister());
+}
+
+static void CreateIntToIntLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void CreateIntIntToIntLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void CreateIntIntToVoidLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+}
+
+static void CreateFPToFPLocations(ArenaAllocator* allocator,
+                                  HInvoke* invoke,
+                                  Location::OutputOverlap overlaps = Location::kNoOutputOverlap) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresFpuRegister(), overlaps);
+}
+
+static void CreateFPFPFPToFPLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetInAt(2, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitDoubleDoubleToRawLongBits(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitDoubleDoubleToRawLongBits(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMvXD(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsFpuRegister<FRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitDoubleLongBitsToDouble(HInvoke* invoke) {
+  CreateIntToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitDoubleLongBitsToDouble(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMvDX(locations->Out().AsFpuRegister<FRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitFloatFloatToRawIntBits(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitFloatFloatToRawIntBits(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  // FMV.X.W sign-extends the 32-bit result.
+  __ FMvXW(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsFpuRegister<FRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitFloatIntBitsToFloat(HInvoke* invoke) {
+  CreateIntToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitFloatIntBitsToFloat(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMvWX(locations->Out().AsFpuRegister<FRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+static void GenIsInfinite(LocationSummary* locations, bool is64bit, Riscv64Assembler* assembler) {
+  FRegister in = locations->InAt(0).AsFpuRegister<FRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  if (is64bit) {
+    __ FClassD(out, in);
+  } else {
+    __ FClassS(out, in);
+  }
+  __ Andi(out, out, kFClassNegativeInfinity | kFClassPositiveInfinity);
+  __ Snez(out, out);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitDoubleIsInfinite(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitDoubleIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(invoke->GetLocations(), /*is64bit=*/ true, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitFloatIsInfinite(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitFloatIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(invoke->GetLocations(), /*is64bit=*/ false, GetAssembler());
+}
+
+// The byte reversal and bit counting intrinsics need the Zbb extension. Without it,
+// the libcore implementations are used.
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerReverseBytes(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerReverseBytes(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  __ Rev8(out, locations->InAt(0).AsRegister<XRegister>());
+  __ Srai(out, out, 32);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongReverseBytes(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongReverseBytes(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Rev8(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitShortReverseBytes(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitShortReverseBytes(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  __ Rev8(out, locations->InAt(0).AsRegister<XRegister>());
+  __ Srai(out, out, 48);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerBitCount(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerBitCount(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Cpopw(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongBitCount(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongBitCount(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Cpop(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Clzw(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Clz(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Ctzw(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Ctz(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+static void GenHighestOneBit(LocationSummary* locations,
+                             bool is64bit,
+                             Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  // Shift the sign bit right by the number of leading zeros. For a zero input, the shift
+  // distance equals the register width and wraps around to zero; the final AND then
+  // clears the result.
+  if (is64bit) {
+    __ Clz(TMP, in);
+    __ Li(TMP2, std::numeric_limits<int64_t>::min());
+    __ Srl(TMP, TMP2, TMP);
+  } else {
+    __ Clzw(TMP, in);
+    __ Li(TMP2, std::numeric_limits<int32_t>::min());
+    __ Srlw(TMP, TMP2, TMP);
+  }
+  __ And(out, TMP, in);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  GenHighestOneBit(invoke->GetLocations(), /*is64bit=*/ false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongHighestOneBit(HInvoke* invoke) {
+  if (codegen_->GetInstructionSetFeatures().HasZbb()) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongHighestOneBit(HInvoke* invoke) {
+  GenHighestOneBit(invoke->GetLocations(), /*is64bit=*/ true, GetAssembler());
+}
+
+static void GenLowestOneBit(LocationSummary* locations, bool is64bit, Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  if (is64bit) {
+    __ Neg(TMP, in);
+  } else {
+    __ NegW(TMP, in);
+  }
+  __ And(out, TMP, in);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerLowestOneBit(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerLowestOneBit(HInvoke* invoke) {
+  GenLowestOneBit(invoke->GetLocations(), /*is64bit=*/ false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongLowestOneBit(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongLowestOneBit(HInvoke* invoke) {
+  GenLowestOneBit(invoke->GetLocations(), /*is64bit=*/ true, GetAssembler());
+}
+
+static void CreateDivideUnsignedLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void GenDivideUnsigned(HInvoke* invoke, bool is64bit, CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister dividend = locations->InAt(0).AsRegister<XRegister>();
+  XRegister divisor = locations->InAt(1).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  // Let the managed code throw the ArithmeticException for a zero divisor.
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ Beqz(divisor, slow_path->GetEntryLabel());
+
+  if (is64bit) {
+    __ Divu(out, dividend, divisor);
+  } else {
+    __ Divuw(out, dividend, divisor);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  CreateDivideUnsignedLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  GenDivideUnsigned(invoke, /*is64bit=*/ false, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  CreateDivideUnsignedLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  GenDivideUnsigned(invoke, /*is64bit=*/ true, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathSqrt(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathSqrt(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FSqrtD(locations->Out().AsFpuRegister<FRegister>(),
+            locations->InAt(0).AsFpuRegister<FRegister>());
+}
+
+static void GenMathRound(LocationSummary* locations,
+                         FPRoundingMode mode,
+                         Riscv64Assembler* assembler) {
+  FRegister in = locations->InAt(0).AsFpuRegister<FRegister>();
+  FRegister out = locations->Out().AsFpuRegister<FRegister>();
+  DCHECK_NE(in, out);
+  Riscv64Label done;
+
+  // Values with a magnitude of at least 2^52, infinities and NaNs are returned unchanged.
+  // Anything smaller converts exactly to a 64-bit integer and back.
+  __ FMvD(out, in);
+  __ FMvXD(TMP, in);
+  __ Srli(TMP, TMP, kDoubleMantissaBits);
+  __ Andi(TMP, TMP, (1 << kDoubleExponentBits) - 1);
+  __ Li(TMP2, kDoubleExponentBias + kDoubleMantissaBits);
+  __ Bgeu(TMP, TMP2, &done);
+  __ FCvtLD(TMP, in, mode);
+  __ FCvtDL(out, TMP, mode);
+  // Keep the sign of the input for zero results, for example `Math.ceil(-0.5) == -0.0`.
+  __ FSgnjD(out, out, in);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathCeil(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathCeil(HInvoke* invoke) {
+  GenMathRound(invoke->GetLocations(), FPRoundingMode::kRUP, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathFloor(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathFloor(HInvoke* invoke) {
+  GenMathRound(invoke->GetLocations(), FPRoundingMode::kRDN, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathRint(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathRint(HInvoke* invoke) {
+  GenMathRound(invoke->GetLocations(), FPRoundingMode::kRNE, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathFmaDouble(HInvoke* invoke) {
+  CreateFPFPFPToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathFmaDouble(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMAddD(locations->Out().AsFpuRegister<FRegister>(),
+            locations->InAt(0).AsFpuRegister<FRegister>(),
+            locations->InAt(1).AsFpuRegister<FRegister>(),
+            locations->InAt(2).AsFpuRegister<FRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathFmaFloat(HInvoke* invoke) {
+  CreateFPFPFPToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathFmaFloat(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMAddS(locations->Out().AsFpuRegister<FRegister>(),
+            locations->InAt(0).AsFpuRegister<FRegister>(),
+            locations->InAt(1).AsFpuRegister<FRegister>(),
+            locations->InAt(2).AsFpuRegister<FRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathMultiplyHigh(HInvoke* invoke) {
+  CreateIntIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathMultiplyHigh(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Mulh(locations->Out().AsRegister<XRegister>(),
+          locations->InAt(0).AsRegister<XRegister>(),
+          locations->InAt(1).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitThreadCurrentThread(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitThreadCurrentThread(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Loadwu(invoke->GetLocations()->Out().AsRegister<XRegister>(),
+            TR,
+            Thread::PeerOffset<kRiscv64PointerSize>().Int32Value());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitThreadInterrupted(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitThreadInterrupted(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  XRegister out = invoke->GetLocations()->Out().AsRegister<XRegister>();
+  int32_t offset = Thread::InterruptedOffset<kRiscv64PointerSize>().Int32Value();
+  Riscv64Label done;
+
+  // Load-acquire the flag and, if it is set, clear it with a store-release.
+  __ Loadw(out, TR, offset);
+  codegen_->GetInstructionCodegen()->GenerateMemoryBarrier(MemBarrierKind::kLoadAny);
+  __ Beqz(out, &done);
+  codegen_->GetInstructionCodegen()->GenerateMemoryBarrier(MemBarrierKind::kAnyStore);
+  __ Storew(Zero, TR, offset);
+  codegen_->GetInstructionCodegen()->GenerateMemoryBarrier(MemBarrierKind::kAnyAny);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitReachabilityFence(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::Any());
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitReachabilityFence(HInvoke* invoke ATTRIBUTE_UNUSED) { }
+
+static void GenMemoryPeek(HInvoke* invoke, DataType::Type type, CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  codegen->LoadFromMemory(type, locations->Out(), locations->InAt(0).AsRegister<XRegister>(), 0);
+}
+
+static void GenMemoryPoke(HInvoke* invoke, DataType::Type type, CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  codegen->StoreToMemory(type, locations->InAt(1), locations->InAt(0).AsRegister<XRegister>(), 0);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPeekByte(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPeekByte(HInvoke* invoke) {
+  GenMemoryPeek(invoke, DataType::Type::kInt8, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPeekIntNative(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPeekIntNative(HInvoke* invoke) {
+  GenMemoryPeek(invoke, DataType::Type::kInt32, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPeekLongNative(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPeekLongNative(HInvoke* invoke) {
+  GenMemoryPeek(invoke, DataType::Type::kInt64, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPeekShortNative(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPeekShortNative(HInvoke* invoke) {
+  GenMemoryPeek(invoke, DataType::Type::kInt16, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPokeByte(HInvoke* invoke) {
+  CreateIntIntToVoidLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPokeByte(HInvoke* invoke) {
+  GenMemoryPoke(invoke, DataType::Type::kInt8, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPokeIntNative(HInvoke* invoke) {
+  CreateIntIntToVoidLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPokeIntNative(HInvoke* invoke) {
+  GenMemoryPoke(invoke, DataType::Type::kInt32, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPokeLongNative(HInvoke* invoke) {
+  CreateIntIntToVoidLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPokeLongNative(HInvoke* invoke) {
+  GenMemoryPoke(invoke, DataType::Type::kInt64, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMemoryPokeShortNative(HInvoke* invoke) {
+  CreateIntIntToVoidLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMemoryPokeShortNative(HInvoke* invoke) {
+  GenMemoryPoke(invoke, DataType::Type::kInt16, codegen_);
+}
+
+// Unsafe and jdk.internal.misc.Unsafe accessors. Object accessors are intrinsified only
+// without read barriers, which the riscv64 code generator does not support yet.
+
+static void CreateUnsafeGetLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void GenUnsafeGet(HInvoke* invoke,
+                         DataType::Type type,
+                         bool is_acquire,
+                         CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+
+  __ Add(TMP, base, offset);
+  codegen->LoadFromMemory(type, locations->Out(), TMP, 0);
+  if (type == DataType::Type::kReference) {
+    __ MaybeUnpoisonHeapReference(locations->Out().AsRegister<XRegister>());
+  }
+  if (is_acquire) {
+    codegen->GetInstructionCodegen()->GenerateMemoryBarrier(MemBarrierKind::kLoadAny);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGet(HInvoke* invoke) {
+  VisitJdkUnsafeGet(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetVolatile(HInvoke* invoke) {
+  VisitJdkUnsafeGetVolatile(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetLong(HInvoke* invoke) {
+  VisitJdkUnsafeGetLong(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetLongVolatile(HInvoke* invoke) {
+  VisitJdkUnsafeGetLongVolatile(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetObject(HInvoke* invoke) {
+  VisitJdkUnsafeGetObject(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetObjectVolatile(HInvoke* invoke) {
+  VisitJdkUnsafeGetObjectVolatile(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGet(HInvoke* invoke) {
+  CreateUnsafeGetLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetVolatile(HInvoke* invoke) {
+  CreateUnsafeGetLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetAcquire(HInvoke* invoke) {
+  CreateUnsafeGetLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetLong(HInvoke* invoke) {
+  CreateUnsafeGetLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetLongVolatile(HInvoke* invoke) {
+  CreateUnsafeGetLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetLongAcquire(HInvoke* invoke) {
+  CreateUnsafeGetLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetObject(HInvoke* invoke) {
+  if (!gUseReadBarrier) {
+    CreateUnsafeGetLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetObjectVolatile(HInvoke* invoke) {
+  if (!gUseReadBarrier) {
+    CreateUnsafeGetLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetObjectAcquire(HInvoke* invoke) {
+  if (!gUseReadBarrier) {
+    CreateUnsafeGetLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGet(HInvoke* invoke) {
+  VisitJdkUnsafeGet(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetVolatile(HInvoke* invoke) {
+  VisitJdkUnsafeGetVolatile(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetLong(HInvoke* invoke) {
+  VisitJdkUnsafeGetLong(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetLongVolatile(HInvoke* invoke) {
+  VisitJdkUnsafeGetLongVolatile(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetObject(HInvoke* invoke) {
+  VisitJdkUnsafeGetObject(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetObjectVolatile(HInvoke* invoke) {
+  VisitJdkUnsafeGetObjectVolatile(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGet(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kInt32, /*is_acquire=*/ false, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetVolatile(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kInt32, /*is_acquire=*/ true, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetAcquire(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kInt32, /*is_acquire=*/ true, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetLong(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kInt64, /*is_acquire=*/ false, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetLongVolatile(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kInt64, /*is_acquire=*/ true, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetLongAcquire(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kInt64, /*is_acquire=*/ true, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetObject(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kReference, /*is_acquire=*/ false, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetObjectVolatile(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kReference, /*is_acquire=*/ true, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetObjectAcquire(HInvoke* invoke) {
+  GenUnsafeGet(invoke, DataType::Type::kReference, /*is_acquire=*/ true, codegen_);
+}
+
+static void CreateUnsafePutLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+}
+
+static void GenUnsafePut(HInvoke* invoke,
+                         DataType::Type type,
+                         bool is_volatile,
+                         bool is_release,
+                         CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+  Location value = locations->InAt(3);
+
+  if (is_volatile || is_release) {
+    codegen->GetInstructionCodegen()->GenerateMemoryBarrier(MemBarrierKind::kAnyStore);
+  }
+  __ Add(TMP, base, offset);
+  codegen->StoreToMemory(type, value, TMP, 0);
+  if (is_volatile) {
+    codegen->GetInstructionCodegen()->GenerateMemoryBarrier(MemBarrierKind::kAnyAny);
+  }
+
+  if (type == DataType::Type::kReference) {
+    bool value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(base, value.AsRegister<XRegister>(), value_can_be_null);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePut(HInvoke* invoke) {
+  VisitJdkUnsafePut(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutOrdered(HInvoke* invoke) {
+  VisitJdkUnsafePutOrdered(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutVolatile(HInvoke* invoke) {
+  VisitJdkUnsafePutVolatile(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutObject(HInvoke* invoke) {
+  VisitJdkUnsafePutObject(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutObjectOrdered(HInvoke* invoke) {
+  VisitJdkUnsafePutObjectOrdered(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutObjectVolatile(HInvoke* invoke) {
+  VisitJdkUnsafePutObjectVolatile(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutLong(HInvoke* invoke) {
+  VisitJdkUnsafePutLong(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutLongOrdered(HInvoke* invoke) {
+  VisitJdkUnsafePutLongOrdered(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafePutLongVolatile(HInvoke* invoke) {
+  VisitJdkUnsafePutLongVolatile(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePut(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutOrdered(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutRelease(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutVolatile(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutObject(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutObjectOrdered(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutObjectVolatile(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutObjectRelease(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutLong(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutLongOrdered(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutLongVolatile(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafePutLongRelease(HInvoke* invoke) {
+  CreateUnsafePutLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePut(HInvoke* invoke) {
+  VisitJdkUnsafePut(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutOrdered(HInvoke* invoke) {
+  VisitJdkUnsafePutOrdered(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutVolatile(HInvoke* invoke) {
+  VisitJdkUnsafePutVolatile(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutObject(HInvoke* invoke) {
+  VisitJdkUnsafePutObject(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutObjectOrdered(HInvoke* invoke) {
+  VisitJdkUnsafePutObjectOrdered(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutObjectVolatile(HInvoke* invoke) {
+  VisitJdkUnsafePutObjectVolatile(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutLong(HInvoke* invoke) {
+  VisitJdkUnsafePutLong(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutLongOrdered(HInvoke* invoke) {
+  VisitJdkUnsafePutLongOrdered(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafePutLongVolatile(HInvoke* invoke) {
+  VisitJdkUnsafePutLongVolatile(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePut(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt32,
+               /*is_volatile=*/ false,
+               /*is_release=*/ false,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutOrdered(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt32,
+               /*is_volatile=*/ false,
+               /*is_release=*/ true,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutRelease(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt32,
+               /*is_volatile=*/ false,
+               /*is_release=*/ true,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutVolatile(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt32,
+               /*is_volatile=*/ true,
+               /*is_release=*/ false,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutObject(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kReference,
+               /*is_volatile=*/ false,
+               /*is_release=*/ false,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutObjectOrdered(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kReference,
+               /*is_volatile=*/ false,
+               /*is_release=*/ true,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutObjectVolatile(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kReference,
+               /*is_volatile=*/ true,
+               /*is_release=*/ false,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutObjectRelease(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kReference,
+               /*is_volatile=*/ false,
+               /*is_release=*/ true,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutLong(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt64,
+               /*is_volatile=*/ false,
+               /*is_release=*/ false,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutLongOrdered(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt64,
+               /*is_volatile=*/ false,
+               /*is_release=*/ true,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutLongVolatile(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt64,
+               /*is_volatile=*/ true,
+               /*is_release=*/ false,
+               codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafePutLongRelease(HInvoke* invoke) {
+  GenUnsafePut(invoke,
+               DataType::Type::kInt64,
+               /*is_volatile=*/ false,
+               /*is_release=*/ true,
+               codegen_);
+}
+
+static void CreateUnsafeCASLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetInAt(4, Location::RequiresRegister());
+  // The output is written in the LR/SC loop before the inputs are dead.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenUnsafeCas(HInvoke* invoke, DataType::Type type, CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+  XRegister expected = locations->InAt(3).AsRegister<XRegister>();
+  XRegister new_value = locations->InAt(4).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  if (type == DataType::Type::kReference) {
+    // Mark card for object assuming new value is stored. This uses TMP and TMP2,
+    // so it must be done before they are set up for the loop below.
+    bool new_value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(base, new_value, new_value_can_be_null);
+    // LR.W sign-extends the loaded value while references are kept zero-extended.
+    if (kPoisonHeapReferences) {
+      __ NegW(TMP, expected);
+      __ PoisonHeapReference(new_value);
+    } else {
+      __ Addiw(TMP, expected, 0);
+    }
+    expected = TMP;
+  }
+  XRegister address = TMP2;
+  __ Add(address, base, offset);
+
+  // retry:
+  //   lr.{w,d}.aqrl out, (address)
+  //   out = out ^ expected
+  //   bnez out, done
+  //   sc.{w,d}.rl out, new_value, (address)
+  //   bnez out, retry
+  // done:
+  //   out = (out == 0)
+  Riscv64Label retry;
+  Riscv64Label done;
+  __ Bind(&retry);
+  if (type == DataType::Type::kInt64) {
+    __ LrD(out, address, AqRl::kAqRl);
+  } else {
+    __ LrW(out, address, AqRl::kAqRl);
+  }
+  __ Xor(out, out, expected);
+  __ Bnez(out, &done);
+  if (type == DataType::Type::kInt64) {
+    __ ScD(out, new_value, address, AqRl::kRelease);
+  } else {
+    __ ScW(out, new_value, address, AqRl::kRelease);
+  }
+  __ Bnez(out, &retry);
+  __ Bind(&done);
+  __ Seqz(out, out);
+
+  if (kPoisonHeapReferences && type == DataType::Type::kReference) {
+    // Restore the input poisoned above. The comparison used a poisoned copy of `expected`.
+    __ UnpoisonHeapReference(new_value);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeCASInt(HInvoke* invoke) {
+  VisitJdkUnsafeCASInt(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeCASLong(HInvoke* invoke) {
+  VisitJdkUnsafeCASLong(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeCASObject(HInvoke* invoke) {
+  VisitJdkUnsafeCASObject(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeCASInt(HInvoke* invoke) {
+  // `jdk.internal.misc.Unsafe.compareAndSwapInt` has compare-and-set semantics (see javadoc).
+  VisitJdkUnsafeCompareAndSetInt(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeCASLong(HInvoke* invoke) {
+  // `jdk.internal.misc.Unsafe.compareAndSwapLong` has compare-and-set semantics (see javadoc).
+  VisitJdkUnsafeCompareAndSetLong(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeCASObject(HInvoke* invoke) {
+  // `jdk.internal.misc.Unsafe.compareAndSwapObject` has compare-and-set semantics (see javadoc).
+  VisitJdkUnsafeCompareAndSetObject(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeCompareAndSetInt(HInvoke* invoke) {
+  CreateUnsafeCASLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeCompareAndSetLong(HInvoke* invoke) {
+  CreateUnsafeCASLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeCompareAndSetObject(HInvoke* invoke) {
+  if (!gUseReadBarrier) {
+    CreateUnsafeCASLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeCASInt(HInvoke* invoke) {
+  VisitJdkUnsafeCASInt(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeCASLong(HInvoke* invoke) {
+  VisitJdkUnsafeCASLong(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeCASObject(HInvoke* invoke) {
+  VisitJdkUnsafeCASObject(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeCASInt(HInvoke* invoke) {
+  VisitJdkUnsafeCompareAndSetInt(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeCASLong(HInvoke* invoke) {
+  VisitJdkUnsafeCompareAndSetLong(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeCASObject(HInvoke* invoke) {
+  VisitJdkUnsafeCompareAndSetObject(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeCompareAndSetInt(HInvoke* invoke) {
+  GenUnsafeCas(invoke, DataType::Type::kInt32, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeCompareAndSetLong(HInvoke* invoke) {
+  GenUnsafeCas(invoke, DataType::Type::kInt64, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeCompareAndSetObject(HInvoke* invoke) {
+  GenUnsafeCas(invoke, DataType::Type::kReference, codegen_);
+}
+
+enum class GetAndUpdateOp {
+  kSet,
+  kAdd,
+};
+
+static void CreateUnsafeGetAndUpdateLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void GenUnsafeGetAndUpdate(HInvoke* invoke,
+                                  DataType::Type type,
+                                  GetAndUpdateOp get_and_update_op,
+                                  CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+  XRegister arg = locations->InAt(3).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  if (type == DataType::Type::kReference) {
+    DCHECK(get_and_update_op == GetAndUpdateOp::kSet);
+    // Mark card for object as a new value shall be stored.
+    bool new_value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(base, arg, new_value_can_be_null);
+    __ MaybePoisonHeapReference(arg);
+  }
+
+  // A single AMO with both `aq` and `rl` set is sequentially consistent.
+  __ Add(TMP, base, offset);
+  if (get_and_update_op == GetAndUpdateOp::kSet) {
+    if (type == DataType::Type::kInt64) {
+      __ AmoSwapD(out, arg, TMP, AqRl::kAqRl);
+    } else {
+      __ AmoSwapW(out, arg, TMP, AqRl::kAqRl);
+    }
+  } else {
+    if (type == DataType::Type::kInt64) {
+      __ AmoAddD(out, arg, TMP, AqRl::kAqRl);
+    } else {
+      __ AmoAddW(out, arg, TMP, AqRl::kAqRl);
+    }
+  }
+  if (type == DataType::Type::kReference) {
+    if (kPoisonHeapReferences) {
+      if (arg != out) {
+        __ UnpoisonHeapReference(arg);
+      }
+      __ UnpoisonHeapReference(out);
+    } else {
+      __ ZextW(out, out);
+    }
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndAddInt(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndAddLong(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndSetInt(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndSetLong(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndSetObject(invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetAndAddInt(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetAndAddLong(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetAndSetInt(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetAndSetLong(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, invoke);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitJdkUnsafeGetAndSetObject(HInvoke* invoke) {
+  if (!gUseReadBarrier) {
+    CreateUnsafeGetAndUpdateLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndAddInt(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndAddLong(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndSetInt(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndSetLong(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  VisitJdkUnsafeGetAndSetObject(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetAndAddInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt32, GetAndUpdateOp::kAdd, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetAndAddLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt64, GetAndUpdateOp::kAdd, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetAndSetInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt32, GetAndUpdateOp::kSet, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetAndSetLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt64, GetAndUpdateOp::kSet, codegen_);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitJdkUnsafeGetAndSetObject(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kReference, GetAndUpdateOp::kSet, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringEquals(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  if (codegen_->GetInstructionSetFeatures().HasVector()) {
+    // The V registers with the same numbers hold the string data.
+    locations->AddTemp(Location::RequiresFpuRegister());
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringEquals(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  XRegister str = locations->InAt(0).AsRegister<XRegister>();
+  XRegister arg = locations->InAt(1).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  XRegister temp1 = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister temp2 = locations->GetTemp(1).AsRegister<XRegister>();
+
+  Riscv64Label loop;
+  Riscv64Label end;
+  Riscv64Label return_true;
+  Riscv64Label return_false;
+
+  // Get offsets of count, value, and class fields within a string object.
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const int32_t class_offset = mirror::Object::ClassOffset().Int32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  StringEqualsOptimizations optimizations(invoke);
+  if (!optimizations.GetArgumentNotNull()) {
+    // Check if input is null, return false if it is.
+    __ Beqz(arg, &return_false);
+  }
+
+  // Reference equality check, return true if same reference.
+  __ Beq(str, arg, &return_true);
+
+  if (!optimizations.GetArgumentIsString()) {
+    // Instanceof check for the argument by comparing class fields.
+    // All string objects must have the same type since String cannot be subclassed.
+    // Receiver must be a string object, so its class field is equal to all strings' class fields.
+    // If the argument is a string object, its class field must be equal to receiver's class field.
+    //
+    // As the String class is expected to be non-movable, we can read the class
+    // field from String.equals' arguments without read barriers.
+    AssertNonMovableStringClass();
+    // /* HeapReference<Class> */ temp1 = str->klass_
+    __ Loadwu(temp1, str, class_offset);
+    // /* HeapReference<Class> */ temp2 = arg->klass_
+    __ Loadwu(temp2, arg, class_offset);
+    // Also, because we use the previously loaded class references only in the
+    // following comparison, we don't need to unpoison them.
+    __ Bne(temp1, temp2, &return_false);
+  }
+
+  // Load `count` fields of this and argument strings.
+  __ Loadwu(temp1, str, count_offset);
+  __ Loadwu(temp2, arg, count_offset);
+  // Check if `count` fields are equal, return false if they're not.
+  // Also compares the compression style, if differs return false.
+  __ Bne(temp1, temp2, &return_false);
+
+  // Compute the data size in bytes: the length for compressed strings,
+  // twice the length for uncompressed ones.
+  if (mirror::kUseStringCompression) {
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    __ Andi(temp2, temp1, 1);
+    __ Srli(temp1, temp1, 1);
+    __ Sll(temp1, temp1, temp2);
+  } else {
+    __ Slli(temp1, temp1, 1);
+  }
+  // Return true if both strings are empty.
+  __ Beqz(temp1, &return_true);
+
+  XRegister str_ptr = TMP;
+  XRegister arg_ptr = TMP2;
+  __ Addi(str_ptr, str, value_offset);
+  __ Addi(arg_ptr, arg, value_offset);
+
+  if (codegen_->GetInstructionSetFeatures().HasVector()) {
+    VRegister str_data = VRegisterFrom(locations->GetTemp(2));
+    VRegister arg_data = VRegisterFrom(locations->GetTemp(3));
+    // Compare as many bytes as the vector length allows per iteration and look for
+    // the first mismatch with VFIRST.M.
+    __ Bind(&loop);
+    __ VSetvli(temp2, temp1, kE8M1VTypei);
+    __ VLe8(str_data, str_ptr);
+    __ VLe8(arg_data, arg_ptr);
+    __ VMsne_vv(VTMP, str_data, arg_data);
+    __ VFirst_m(out, VTMP);
+    __ Bgez(out, &return_false);
+    __ Add(str_ptr, str_ptr, temp2);
+    __ Add(arg_ptr, arg_ptr, temp2);
+    __ Sub(temp1, temp1, temp2);
+    __ Bnez(temp1, &loop);
+  } else {
+    // Assertions that must hold in order to compare strings 8 bytes at a time.
+    // Ok to do this because strings are zero-padded to kObjectAlignment.
+    DCHECK_ALIGNED(value_offset, 8);
+    static_assert(IsAligned<8>(kObjectAlignment), "String of odd length is not zero padded");
+
+    // Loop to compare strings 8 bytes at a time starting at the beginning of the data.
+    __ Bind(&loop);
+    __ Ld(out, str_ptr, 0);
+    __ Ld(temp2, arg_ptr, 0);
+    __ Bne(out, temp2, &return_false);
+    __ Addi(str_ptr, str_ptr, 8);
+    __ Addi(arg_ptr, arg_ptr, 8);
+    __ Addi(temp1, temp1, -8);
+    __ Bgtz(temp1, &loop);
+  }
+
+  // Return true and exit the function.
+  // If loop does not result in returning false, we return true.
+  __ Bind(&return_true);
+  __ Li(out, 1);
+  __ J(&end);
+
+  // Return false and exit the function.
+  __ Bind(&return_false);
+  __ Li(out, 0);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringCompareTo(HInvoke* invoke) {
+  LocationSummary* locations = new (allocator_) LocationSummary(
+      invoke,
+      invoke->InputAt(1)->CanBeNull() ? LocationSummary::kCallOnSlowPath
+                                      : LocationSummary::kNoCall,
+      kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringCompareTo(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  XRegister str = locations->InAt(0).AsRegister<XRegister>();
+  XRegister arg = locations->InAt(1).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  XRegister remaining = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister arg_length = locations->GetTemp(1).AsRegister<XRegister>();
+  XRegister str_shift = locations->GetTemp(2).AsRegister<XRegister>();
+  XRegister arg_shift = locations->GetTemp(3).AsRegister<XRegister>();
+  XRegister arg_char = locations->GetTemp(4).AsRegister<XRegister>();
+  // The length of `arg` is dead once the common length is known.
+  XRegister str_char = arg_length;
+
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  SlowPathCodeRISCV64* slow_path = nullptr;
+  if (locations->CanCall()) {
+    // Let the managed code throw the NullPointerException for a null argument.
+    slow_path = new (codegen_->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+    codegen_->AddSlowPath(slow_path);
+    __ Beqz(arg, slow_path->GetEntryLabel());
+  }
+
+  Riscv64Label loop;
+  Riscv64Label different;
+  Riscv64Label end;
+
+  // Reference equality check, return 0 if same reference.
+  __ Li(out, 0);
+  __ Beq(str, arg, &end);
+
+  // Load `count` fields of this and argument strings and extract the lengths. For
+  // compressed strings the shift is 0 (8-bit characters), otherwise it is 1.
+  __ Loadwu(remaining, str, count_offset);
+  __ Loadwu(arg_length, arg, count_offset);
+  if (mirror::kUseStringCompression) {
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    __ Andi(str_shift, remaining, 1);
+    __ Andi(arg_shift, arg_length, 1);
+    __ Srli(remaining, remaining, 1);
+    __ Srli(arg_length, arg_length, 1);
+  }
+
+  // The length difference is the result if one string is a prefix of the other.
+  __ Sub(out, remaining, arg_length);
+  // Compare up to the length of the shorter string.
+  Riscv64Label min_length;
+  __ Blez(out, &min_length);
+  __ Mv(remaining, arg_length);
+  __ Bind(&min_length);
+  __ Beqz(remaining, &end);
+
+  XRegister str_ptr = TMP;
+  XRegister arg_ptr = TMP2;
+  __ Addi(str_ptr, str, value_offset);
+  __ Addi(arg_ptr, arg, value_offset);
+
+  // Load one character of each string per iteration, with the width given by the
+  // compression state of the string.
+  auto load_char = [&](XRegister dst, XRegister ptr, XRegister shift) {
+    if (mirror::kUseStringCompression) {
+      Riscv64Label uncompressed;
+      Riscv64Label loaded;
+      __ Bnez(shift, &uncompressed);
+      __ Lbu(dst, ptr, 0);
+      __ Addi(ptr, ptr, 1);
+      __ J(&loaded);
+      __ Bind(&uncompressed);
+      __ Lhu(dst, ptr, 0);
+      __ Addi(ptr, ptr, 2);
+      __ Bind(&loaded);
+    } else {
+      __ Lhu(dst, ptr, 0);
+      __ Addi(ptr, ptr, 2);
+    }
+  };
+
+  __ Bind(&loop);
+  load_char(str_char, str_ptr, str_shift);
+  load_char(arg_char, arg_ptr, arg_shift);
+  __ Bne(str_char, arg_char, &different);
+  __ Addi(remaining, remaining, -1);
+  __ Bnez(remaining, &loop);
+  __ J(&end);
+
+  // Return the difference of the first mismatching characters.
+  __ Bind(&different);
+  __ Sub(out, str_char, arg_char);
+  __ Bind(&end);
+
+  if (slow_path != nullptr) {
+    __ Bind(slow_path->GetExitLabel());
+  }
+}
+
+static void CreateStringIndexOfLocations(HInvoke* invoke,
+                                         ArenaAllocator* allocator,
+                                         CodeGeneratorRISCV64* codegen,
+                                         bool start_at_zero) {
+  // Supplementary code points are handled by the managed code in the slow path.
+  HInstruction* code_point = invoke->InputAt(1);
+  bool needs_slow_path = true;
+  if (code_point->IsIntConstant()) {
+    if (static_cast<uint32_t>(code_point->AsIntConstant()->GetValue()) >
+        std::numeric_limits<uint16_t>::max()) {
+      // Always needs the slow path, so do not intrinsify.
+      return;
+    }
+    needs_slow_path = false;
+  }
+
+  LocationSummary* locations = new (allocator) LocationSummary(
+      invoke,
+      needs_slow_path ? LocationSummary::kCallOnSlowPath : LocationSummary::kNoCall,
+      kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  if (!start_at_zero) {
+    locations->SetInAt(2, Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  if (codegen->GetInstructionSetFeatures().HasVector()) {
+    // The V register with the same number holds the string data.
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenerateStringIndexOf(HInvoke* invoke,
+                                  CodeGeneratorRISCV64* codegen,
+                                  bool start_at_zero) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  bool use_vector = codegen->GetInstructionSetFeatures().HasVector();
+
+  XRegister str = locations->InAt(0).AsRegister<XRegister>();
+  XRegister ch = locations->InAt(1).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  XRegister length = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister temp = locations->GetTemp(1).AsRegister<XRegister>();
+  XRegister data_ptr = TMP2;
+
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  SlowPathCodeRISCV64* slow_path = nullptr;
+  if (locations->CanCall()) {
+    // Let the managed code handle supplementary code points (and invalid negative values).
+    slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+    codegen->AddSlowPath(slow_path);
+    __ Li(TMP, std::numeric_limits<uint16_t>::max());
+    __ Bltu(TMP, ch, slow_path->GetEntryLabel());
+  }
+
+  Riscv64Label not_found;
+  Riscv64Label done;
+
+  __ Loadwu(length, str, count_offset);
+  if (mirror::kUseStringCompression) {
+    __ Andi(temp, length, 1);
+    __ Srli(length, length, 1);
+  }
+
+  // Clamp the start index to zero; a start index at or beyond the length finds nothing.
+  if (start_at_zero) {
+    __ Li(out, 0);
+  } else {
+    XRegister from = locations->InAt(2).AsRegister<XRegister>();
+    if (codegen->GetInstructionSetFeatures().HasZbb()) {
+      __ Max(out, from, Zero);
+    } else {
+      Riscv64Label start_ok;
+      __ Mv(out, from);
+      __ Bgez(out, &start_ok);
+      __ Li(out, 0);
+      __ Bind(&start_ok);
+    }
+  }
+  __ Bge(out, length, &not_found);
+  __ Addi(data_ptr, str, value_offset);
+
+  // Scan `length - out` elements of `elem_size` bytes starting at index `out`, leaving
+  // the index of the first match in `out`. `temp` is free to use once the compression
+  // flag has been tested.
+  auto scan = [&](int32_t elem_size) {
+    if (elem_size == 1) {
+      __ Add(data_ptr, data_ptr, out);
+    } else {
+      __ Slli(TMP, out, 1);
+      __ Add(data_ptr, data_ptr, TMP);
+    }
+    if (use_vector) {
+      VRegister data = VRegisterFrom(locations->GetTemp(2));
+      Riscv64Label loop;
+      Riscv64Label found;
+      XRegister remaining = length;
+      __ Sub(remaining, length, out);
+      __ Bind(&loop);
+      if (elem_size == 1) {
+        __ VSetvli(temp, remaining, kE8M1VTypei);
+        __ VLe8(data, data_ptr);
+      } else {
+        __ VSetvli(temp, remaining, kE16M1VTypei);
+        __ VLe16(data, data_ptr);
+      }
+      __ VMseq_vx(VTMP, data, ch);
+      __ VFirst_m(TMP, VTMP);
+      __ Bgez(TMP, &found);
+      __ Add(out, out, temp);
+      __ Sub(remaining, remaining, temp);
+      if (elem_size != 1) {
+        __ Slli(temp, temp, 1);
+      }
+      __ Add(data_ptr, data_ptr, temp);
+      __ Bnez(remaining, &loop);
+      __ J(&not_found);
+      __ Bind(&found);
+      __ Add(out, out, TMP);
+      __ J(&done);
+    } else {
+      Riscv64Label loop;
+      __ Bind(&loop);
+      if (elem_size == 1) {
+        __ Lbu(TMP, data_ptr, 0);
+      } else {
+        __ Lhu(TMP, data_ptr, 0);
+      }
+      __ Beq(TMP, ch, &done);
+      __ Addi(out, out, 1);
+      __ Addi(data_ptr, data_ptr, elem_size);
+      __ Blt(out, length, &loop);
+      __ J(&not_found);
+    }
+  };
+
+  if (mirror::kUseStringCompression) {
+    Riscv64Label uncompressed;
+    __ Bnez(temp, &uncompressed);
+    // Compressed strings hold only ASCII characters, so a larger `ch` cannot match.
+    // The vector compare truncates `ch` to 8 bits, so this check is also needed there.
+    __ Srli(TMP, ch, 7);
+    __ Bnez(TMP, &not_found);
+    scan(/*elem_size=*/ 1);
+    __ Bind(&uncompressed);
+  }
+  scan(/*elem_size=*/ 2);
+
+  __ Bind(&not_found);
+  __ Li(out, -1);
+  __ Bind(&done);
+
+  if (slow_path != nullptr) {
+    __ Bind(slow_path->GetExitLabel());
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringIndexOf(HInvoke* invoke) {
+  CreateStringIndexOfLocations(invoke, allocator_, codegen_, /*start_at_zero=*/ true);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringIndexOf(HInvoke* invoke) {
+  GenerateStringIndexOf(invoke, codegen_, /*start_at_zero=*/ true);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringIndexOfAfter(HInvoke* invoke) {
+  CreateStringIndexOfLocations(invoke, allocator_, codegen_, /*start_at_zero=*/ false);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringIndexOfAfter(HInvoke* invoke) {
+  GenerateStringIndexOf(invoke, codegen_, /*start_at_zero=*/ false);
+}
+
+static void CreateSystemArrayCopyPrimitiveLocations(ArenaAllocator* allocator,
+                                                   HInvoke* invoke,
+                                                   DataType::Type type) {
+  // Check for known failures that will force us to bail out to the runtime,
+  // just call the function normally then.
+  HIntConstant* length = invoke->InputAt(4)->AsIntConstant();
+  if (length != nullptr) {
+    int32_t len = length->GetValue();
+    if (len < 0 || len > SystemArrayCopyPrimitiveThreshold(type)) {
+      return;
+    }
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  // arraycopy(T[] src, int src_pos, T[] dst, int dst_pos, int length).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetInAt(4, Location::RequiresRegister());
+
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+static void GenSystemArrayCopyPrimitive(HInvoke* invoke,
+                                        CodeGeneratorRISCV64* codegen,
+                                        DataType::Type type) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  XRegister src = locations->InAt(0).AsRegister<XRegister>();
+  XRegister src_pos = locations->InAt(1).AsRegister<XRegister>();
+  XRegister dst = locations->InAt(2).AsRegister<XRegister>();
+  XRegister dst_pos = locations->InAt(3).AsRegister<XRegister>();
+  XRegister length = locations->InAt(4).AsRegister<XRegister>();
+  XRegister src_ptr = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister dst_ptr = locations->GetTemp(1).AsRegister<XRegister>();
+  XRegister remaining = locations->GetTemp(2).AsRegister<XRegister>();
+
+  const size_t element_size = DataType::Size(type);
+  const size_t element_size_shift = DataType::SizeShift(type);
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(element_size).Int32Value();
+
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  // Bail out to the managed code for null arrays, negative positions or length,
+  // long copies and out of bounds ranges; it throws the appropriate exceptions.
+  __ Beqz(src, slow_path->GetEntryLabel());
+  __ Beqz(dst, slow_path->GetEntryLabel());
+  __ Bltz(src_pos, slow_path->GetEntryLabel());
+  __ Bltz(dst_pos, slow_path->GetEntryLabel());
+  __ Bltz(length, slow_path->GetEntryLabel());
+  __ Li(TMP, SystemArrayCopyPrimitiveThreshold(type));
+  __ Bgt(length, TMP, slow_path->GetEntryLabel());
+  __ Loadw(TMP, src, length_offset);
+  __ Sub(TMP, TMP, src_pos);
+  __ Blt(TMP, length, slow_path->GetEntryLabel());
+  __ Loadw(TMP, dst, length_offset);
+  __ Sub(TMP, TMP, dst_pos);
+  __ Blt(TMP, length, slow_path->GetEntryLabel());
+
+  // The copy below goes forward, so overlapping ranges with `src_pos < dst_pos`
+  // within the same array are left to the managed code.
+  Riscv64Label conditions_ok;
+  __ Bne(src, dst, &conditions_ok);
+  __ Blt(src_pos, dst_pos, slow_path->GetEntryLabel());
+  __ Bind(&conditions_ok);
+
+  __ Beqz(length, slow_path->GetExitLabel());
+
+  __ Slli(src_ptr, src_pos, element_size_shift);
+  __ Add(src_ptr, src_ptr, src);
+  __ Addi(src_ptr, src_ptr, data_offset);
+  __ Slli(dst_ptr, dst_pos, element_size_shift);
+  __ Add(dst_ptr, dst_ptr, dst);
+  __ Addi(dst_ptr, dst_ptr, data_offset);
+  __ Mv(remaining, length);
+
+  Riscv64Label loop;
+  __ Bind(&loop);
+  if (codegen->GetInstructionSetFeatures().HasVector()) {
+    // Strip-mined copy through VTMP; TMP holds the number of elements per iteration.
+    switch (type) {
+      case DataType::Type::kInt8:
+        __ VSetvli(TMP, remaining, kE8M1VTypei);
+        __ VLe8(VTMP, src_ptr);
+        __ VSe8(VTMP, dst_ptr);
+        break;
+      case DataType::Type::kUint16:
+        __ VSetvli(TMP, remaining, kE16M1VTypei);
+        __ VLe16(VTMP, src_ptr);
+        __ VSe16(VTMP, dst_ptr);
+        break;
+      case DataType::Type::kInt32:
+        __ VSetvli(TMP, remaining, kE32M1VTypei);
+        __ VLe32(VTMP, src_ptr);
+        __ VSe32(VTMP, dst_ptr);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected type " << type;
+        UNREACHABLE();
+    }
+    __ Sub(remaining, remaining, TMP);
+    __ Slli(TMP, TMP, element_size_shift);
+    __ Add(src_ptr, src_ptr, TMP);
+    __ Add(dst_ptr, dst_ptr, TMP);
+  } else {
+    switch (type) {
+      case DataType::Type::kInt8:
+        __ Lbu(TMP, src_ptr, 0);
+        __ Sb(TMP, dst_ptr, 0);
+        break;
+      case DataType::Type::kUint16:
+        __ Lhu(TMP, src_ptr, 0);
+        __ Sh(TMP, dst_ptr, 0);
+        break;
+      case DataType::Type::kInt32:
+        __ Lw(TMP, src_ptr, 0);
+        __ Sw(TMP, dst_ptr, 0);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected type " << type;
+        UNREACHABLE();
+    }
+    __ Addi(src_ptr, src_ptr, element_size);
+    __ Addi(dst_ptr, dst_ptr, element_size);
+    __ Addi(remaining, remaining, -1);
+  }
+  __ Bnez(remaining, &loop);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(allocator_, invoke, DataType::Type::kInt8);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(allocator_, invoke, DataType::Type::kUint16);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, codegen_, DataType::Type::kUint16);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(allocator_, invoke, DataType::Type::kInt32);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, codegen_, DataType::Type::kInt32);
+}
+
+// VarHandle accessors. Only the get and set access modes of static and instance field
+// VarHandles are intrinsified; array and byte array view VarHandles and the atomic access
+// modes go through the runtime invoke-polymorphic call.
+
+// Generate subtype check without read barriers.
+static void GenerateSubTypeObjectCheckNoReadBarrier(CodeGeneratorRISCV64* codegen,
+                                                    SlowPathCodeRISCV64* slow_path,
+                                                    XRegister object,
+                                                    XRegister type,
+                                                    bool object_can_be_null = true) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+
+  const MemberOffset class_offset = mirror::Object::ClassOffset();
+  const MemberOffset super_class_offset = mirror::Class::SuperClassOffset();
+
+  Riscv64Label success;
+  if (object_can_be_null) {
+    __ Beqz(object, &success);
+  }
+
+  XRegister temp = TMP;
+  __ Loadwu(temp, object, class_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp);
+  Riscv64Label loop;
+  __ Bind(&loop);
+  __ Beq(type, temp, &success);
+  __ Loadwu(temp, temp, super_class_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp);
+  __ Beqz(temp, slow_path->GetEntryLabel());
+  __ J(&loop);
+  __ Bind(&success);
+}
+
+// Check access mode and the primitive type from VarHandle.varType.
+// Check reference arguments against the VarHandle.varType; for references this is a subclass
+// check without read barrier, so it can have false negatives which we handle in the slow path.
+static void GenerateVarHandleAccessModeAndVarTypeChecks(HInvoke* invoke,
+                                                        CodeGeneratorRISCV64* codegen,
+                                                        SlowPathCodeRISCV64* slow_path,
+                                                        DataType::Type type) {
+  mirror::VarHandle::AccessMode access_mode =
+      mirror::VarHandle::GetAccessModeByIntrinsic(invoke->GetIntrinsic());
+  Primitive::Type primitive_type = DataTypeToPrimitive(type);
+
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  XRegister varhandle = locations->InAt(0).AsRegister<XRegister>();
+
+  const MemberOffset var_type_offset = mirror::VarHandle::VarTypeOffset();
+  const MemberOffset access_mode_bit_mask_offset = mirror::VarHandle::AccessModesBitMaskOffset();
+  const MemberOffset primitive_type_offset = mirror::Class::PrimitiveTypeOffset();
+
+  // The subtype checks below use TMP, so keep the var type in TMP2.
+  XRegister var_type_no_rb = TMP2;
+  XRegister temp = TMP;
+
+  // Check that the operation is permitted. Move the access mode bit to the sign bit.
+  __ Loadwu(temp, varhandle, access_mode_bit_mask_offset.Int32Value());
+  __ Slli(temp, temp, 63 - static_cast<uint32_t>(access_mode));
+  __ Bgez(temp, slow_path->GetEntryLabel());
+
+  // Check the primitive type of varhandle.varType. We do not need a read barrier when
+  // loading a reference only for loading constant primitive field through the reference.
+  __ Loadwu(var_type_no_rb, varhandle, var_type_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(var_type_no_rb);
+  __ Loadhu(temp, var_type_no_rb, primitive_type_offset.Int32Value());
+  if (primitive_type == Primitive::kPrimNot) {
+    static_assert(Primitive::kPrimNot == 0);
+    __ Bnez(temp, slow_path->GetEntryLabel());
+  } else {
+    __ Addi(temp, temp, -static_cast<int32_t>(primitive_type));
+    __ Bnez(temp, slow_path->GetEntryLabel());
+  }
+
+  if (type == DataType::Type::kReference) {
+    // Check reference arguments against the varType.
+    // False negatives due to varType being an interface or array type
+    // or due to the missing read barrier are handled by the slow path.
+    size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+    uint32_t arguments_start = /* VarHandle object */ 1u + expected_coordinates_count;
+    uint32_t number_of_arguments = invoke->GetNumberOfArguments();
+    for (size_t arg_index = arguments_start; arg_index != number_of_arguments; ++arg_index) {
+      HInstruction* arg = invoke->InputAt(arg_index);
+      DCHECK_EQ(arg->GetType(), DataType::Type::kReference);
+      if (!arg->IsNullConstant()) {
+        XRegister arg_reg = locations->InAt(arg_index).AsRegister<XRegister>();
+        GenerateSubTypeObjectCheckNoReadBarrier(codegen, slow_path, arg_reg, var_type_no_rb);
+      }
+    }
+  }
+}
+
+static void GenerateVarHandleStaticFieldCheck(HInvoke* invoke,
+                                              CodeGeneratorRISCV64* codegen,
+                                              SlowPathCodeRISCV64* slow_path) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister varhandle = invoke->GetLocations()->InAt(0).AsRegister<XRegister>();
+
+  const MemberOffset coordinate_type0_offset = mirror::VarHandle::CoordinateType0Offset();
+
+  // Check that the VarHandle references a static field by checking that coordinateType0 == null.
+  // Do not emit read barrier for comparing to null.
+  __ Loadwu(TMP, varhandle, coordinate_type0_offset.Int32Value());
+  __ Bnez(TMP, slow_path->GetEntryLabel());
+}
+
+static void GenerateVarHandleInstanceFieldChecks(HInvoke* invoke,
+                                                 CodeGeneratorRISCV64* codegen,
+                                                 SlowPathCodeRISCV64* slow_path) {
+  VarHandleOptimizations optimizations(invoke);
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  XRegister varhandle = locations->InAt(0).AsRegister<XRegister>();
+  XRegister object = locations->InAt(1).AsRegister<XRegister>();
+
+  const MemberOffset coordinate_type0_offset = mirror::VarHandle::CoordinateType0Offset();
+  const MemberOffset coordinate_type1_offset = mirror::VarHandle::CoordinateType1Offset();
+
+  // Null-check the object.
+  if (!optimizations.GetSkipObjectNullCheck()) {
+    __ Beqz(object, slow_path->GetEntryLabel());
+  }
+
+  if (!optimizations.GetUseKnownBootImageVarHandle()) {
+    // Check that the VarHandle references an instance field by checking that
+    // coordinateType1 == null. coordinateType0 should not be null, but this is handled by the
+    // type compatibility check with the source object's type, which will fail for null.
+    // No need for read barrier for comparison with null.
+    __ Loadwu(TMP, varhandle, coordinate_type1_offset.Int32Value());
+    __ Bnez(TMP, slow_path->GetEntryLabel());
+
+    // Check that the object has the correct type.
+    // We deliberately avoid the read barrier, letting the slow path handle the false negatives.
+    XRegister coordinate_type0 = TMP2;
+    __ Loadwu(coordinate_type0, varhandle, coordinate_type0_offset.Int32Value());
+    __ MaybeUnpoisonHeapReference(coordinate_type0);
+    GenerateSubTypeObjectCheckNoReadBarrier(
+        codegen, slow_path, object, coordinate_type0, /*object_can_be_null=*/ false);
+  }
+}
+
+static SlowPathCodeRISCV64* GenerateVarHandleChecks(HInvoke* invoke,
+                                                    CodeGeneratorRISCV64* codegen,
+                                                    DataType::Type type) {
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+  DCHECK_LE(expected_coordinates_count, 1u);
+  VarHandleOptimizations optimizations(invoke);
+  if (optimizations.GetUseKnownBootImageVarHandle()) {
+    if (expected_coordinates_count == 0u || optimizations.GetSkipObjectNullCheck()) {
+      return nullptr;
+    }
+  }
+
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  if (!optimizations.GetUseKnownBootImageVarHandle()) {
+    GenerateVarHandleAccessModeAndVarTypeChecks(invoke, codegen, slow_path, type);
+  }
+  if (expected_coordinates_count == 0u) {
+    GenerateVarHandleStaticFieldCheck(invoke, codegen, slow_path);
+  } else {
+    GenerateVarHandleInstanceFieldChecks(invoke, codegen, slow_path);
+  }
+
+  return slow_path;
+}
+
+struct VarHandleTarget {
+  XRegister object;  // The object holding the value to operate on.
+  XRegister offset;  // The offset of the value to operate on.
+};
+
+static VarHandleTarget GetVarHandleTarget(HInvoke* invoke) {
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+  LocationSummary* locations = invoke->GetLocations();
+
+  VarHandleTarget target;
+  // The temporary allocated for loading the offset.
+  target.offset = locations->GetTemp(0u).AsRegister<XRegister>();
+  // The reference to the object that holds the value to operate on.
+  target.object = (expected_coordinates_count == 0u)
+      ? locations->GetTemp(1u).AsRegister<XRegister>()
+      : locations->InAt(1).AsRegister<XRegister>();
+  return target;
+}
+
+static void GenerateVarHandleTarget(HInvoke* invoke,
+                                    const VarHandleTarget& target,
+                                    CodeGeneratorRISCV64* codegen) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister varhandle = invoke->GetLocations()->InAt(0).AsRegister<XRegister>();
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+
+  // The field is read from the VarHandle even for a known boot image VarHandle; only its
+  // checks are skipped. For static fields, we need to fill the `target.object` with the
+  // declaring class, so we can use `target.object` as temporary for the `ArtField*`. For
+  // instance fields, we do not need the declaring class, so we can forget the `ArtField*`
+  // when we load the `target.offset`, so use the `target.offset` to hold the `ArtField*`.
+  XRegister field = (expected_coordinates_count == 0u) ? target.object : target.offset;
+
+  const MemberOffset art_field_offset = mirror::FieldVarHandle::ArtFieldOffset();
+  const MemberOffset offset_offset = ArtField::OffsetOffset();
+
+  // Load the ArtField, the offset and, if needed, declaring class.
+  __ Loadd(field, varhandle, art_field_offset.Int32Value());
+  __ Loadwu(target.offset, field, offset_offset.Int32Value());
+  if (expected_coordinates_count == 0u) {
+    codegen->GetInstructionCodegen()->GenerateGcRootFieldLoad(
+        invoke,
+        Location::RegisterLocation(target.object),
+        field,
+        ArtField::DeclaringClassOffset().Int32Value(),
+        gCompilerReadBarrierOption);
+  }
+}
+
+static LocationSummary* CreateVarHandleFieldLocations(HInvoke* invoke) {
+  VarHandleOptimizations optimizations(invoke);
+  if (optimizations.GetDoNotIntrinsify()) {
+    return nullptr;
+  }
+
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+  if (expected_coordinates_count > 1u) {
+    // Array and byte array view VarHandles are not intrinsified yet.
+    return nullptr;
+  }
+
+  DataType::Type return_type = invoke->GetType();
+  ArenaAllocator* allocator = invoke->GetBlock()->GetGraph()->GetAllocator();
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // Require the object holding the value to operate on (except for static fields)
+  // in a register.
+  if (expected_coordinates_count == 1u) {
+    locations->SetInAt(1, Location::RequiresRegister());
+  }
+  if (return_type != DataType::Type::kVoid) {
+    if (DataType::IsFloatingPointType(return_type)) {
+      locations->SetOut(Location::RequiresFpuRegister());
+    } else {
+      locations->SetOut(Location::RequiresRegister());
+    }
+  }
+  uint32_t arguments_start = /* VarHandle object */ 1u + expected_coordinates_count;
+  uint32_t number_of_arguments = invoke->GetNumberOfArguments();
+  for (size_t arg_index = arguments_start; arg_index != number_of_arguments; ++arg_index) {
+    HInstruction* arg = invoke->InputAt(arg_index);
+    if (IsZeroBitPattern(arg)) {
+      locations->SetInAt(arg_index, Location::ConstantLocation(arg));
+    } else if (DataType::IsFloatingPointType(arg->GetType())) {
+      locations->SetInAt(arg_index, Location::RequiresFpuRegister());
+    } else {
+      locations->SetInAt(arg_index, Location::RequiresRegister());
+    }
+  }
+
+  // Add a temporary for offset.
+  locations->AddTemp(Location::RequiresRegister());
+  if (expected_coordinates_count == 0u) {
+    // Add a temporary to hold the declaring class.
+    locations->AddTemp(Location::RequiresRegister());
+  }
+
+  return locations;
+}
+
+static void CreateVarHandleGetLocations(HInvoke* invoke) {
+  LocationSummary* locations = CreateVarHandleFieldLocations(invoke);
+  if (locations != nullptr && gUseReadBarrier && invoke->GetType() == DataType::Type::kReference) {
+    DCHECK(kUseBakerReadBarrier);
+    // We need a temporary register for the lock word in
+    // CodeGeneratorRISCV64::GenerateReferenceLoadWithBakerReadBarrier().
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+static void GenerateVarHandleGet(HInvoke* invoke,
+                                 CodeGeneratorRISCV64* codegen,
+                                 std::memory_order order) {
+  DataType::Type type = invoke->GetType();
+  DCHECK_NE(type, DataType::Type::kVoid);
+
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  Location out = locations->Out();
+
+  VarHandleTarget target = GetVarHandleTarget(invoke);
+  SlowPathCodeRISCV64* slow_path = GenerateVarHandleChecks(invoke, codegen, type);
+  GenerateVarHandleTarget(invoke, target, codegen);
+
+  // Load the value from the target location.
+  if (type == DataType::Type::kReference && gUseReadBarrier) {
+    Location lock_word_temp = locations->GetTemp(locations->GetTempCount() - 1u);
+    // Reference fields are 4-byte aligned, so the field offset can be passed to the Baker
+    // read barrier load as an index scaled by the reference size.
+    const size_t shift = DataType::SizeShift(DataType::Type::kReference);
+    __ Srli(target.offset, target.offset, shift);
+    codegen->GenerateReferenceLoadWithBakerReadBarrier(invoke,
+                                                       out,
+                                                       target.object,
+                                                       /*offset=*/ 0u,
+                                                       Location::RegisterLocation(target.offset),
+                                                       lock_word_temp,
+                                                       /*needs_null_check=*/ false);
+  } else {
+    __ Add(TMP, target.object, target.offset);
+    codegen->LoadFromMemory(type, out, TMP, /*offset=*/ 0);
+    if (type == DataType::Type::kReference) {
+      __ MaybeUnpoisonHeapReference(out.AsRegister<XRegister>());
+    }
+  }
+
+  if (order == std::memory_order_acquire || order == std::memory_order_seq_cst) {
+    codegen->GetInstructionCodegen()->GenerateMemoryBarrier(MemBarrierKind::kLoadAny);
+  } else {
+    DCHECK(order == std::memory_order_relaxed);
+  }
+
+  if (slow_path != nullptr) {
+    __ Bind(slow_path->GetExitLabel());
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGet(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGet(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_acquire);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_seq_cst);
+}
+
+static void GenerateVarHandleSet(HInvoke* invoke,
+                                 CodeGeneratorRISCV64* codegen,
+                                 std::memory_order order) {
+  uint32_t value_index = invoke->GetNumberOfArguments() - 1;
+  DataType::Type value_type = GetDataTypeFromShorty(invoke, value_index);
+
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  InstructionCodeGeneratorRISCV64* instruction_codegen = codegen->GetInstructionCodegen();
+  Location value = invoke->GetLocations()->InAt(value_index);
+
+  VarHandleTarget target = GetVarHandleTarget(invoke);
+  SlowPathCodeRISCV64* slow_path = GenerateVarHandleChecks(invoke, codegen, value_type);
+  GenerateVarHandleTarget(invoke, target, codegen);
+
+  // Use the same barriers as volatile field stores for the release and volatile modes.
+  if (order == std::memory_order_release || order == std::memory_order_seq_cst) {
+    instruction_codegen->GenerateMemoryBarrier(MemBarrierKind::kAnyStore);
+  } else {
+    DCHECK(order == std::memory_order_relaxed);
+  }
+  __ Add(TMP, target.object, target.offset);
+  codegen->StoreToMemory(value_type, value, TMP, /*offset=*/ 0);
+  if (order == std::memory_order_seq_cst) {
+    instruction_codegen->GenerateMemoryBarrier(MemBarrierKind::kAnyAny);
+  }
+
+  if (CodeGenerator::StoreNeedsWriteBarrier(value_type, invoke->InputAt(value_index))) {
+    codegen->MarkGCCard(target.object, value.AsRegister<XRegister>(), /*value_can_be_null=*/ true);
+  }
+
+  if (slow_path != nullptr) {
+    __ Bind(slow_path->GetExitLabel());
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSet(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSet(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_release);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_seq_cst);
+}
+
+#define MARK_UNIMPLEMENTED(Name) UNIMPLEMENTED_INTRINSIC(RISCV64, Name)
+UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(MARK_UNIMPLEMENTED);
+#undef MARK_UNIMPLEMENTED
+
+UNREACHABLE_INTRINSICS(RISCV64)
+
+#undef __
+
+}  // namespace riscv64
+}  // namespace art
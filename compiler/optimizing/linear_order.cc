@@ -18,6 +18,7 @@
 
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
+#include "block_frequency_info.h"
 
 namespace art HIDDEN {
 
@@ -87,7 +88,9 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Cold blocks (see `HBlockFrequencyInfo`) outside of loops are moved to the end, to keep
+  //   the hot code dense.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -108,23 +111,39 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   //      iterate over the successors. When all non-back edge predecessors of a
   //      successor block are visited, the successor block is added in the worklist
   //      following an order that satisfies the requirements to build our linear graph.
+  //      Cold blocks are only processed once the worklist is empty. As cold blocks always
+  //      end up throwing, their successors are cold blocks, the exit block or exception
+  //      handlers, so this does not delay the normal flow.
   ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocLinearOrder));
+  ScopedArenaVector<HBasicBlock*> cold_worklist(allocator.Adapter(kArenaAllocLinearOrder));
+  HBlockFrequencyInfo frequency_info(graph, &allocator);
   worklist.push_back(graph->GetEntryBlock());
   size_t num_added = 0u;
+  size_t num_cold_visited = 0u;
   do {
-    HBasicBlock* current = worklist.back();
-    worklist.pop_back();
+    HBasicBlock* current;
+    if (!worklist.empty()) {
+      current = worklist.back();
+      worklist.pop_back();
+    } else {
+      current = cold_worklist[num_cold_visited];
+      ++num_cold_visited;
+    }
     linear_order[num_added] = current;
     ++num_added;
     for (HBasicBlock* successor : current->GetSuccessors()) {
       int block_id = successor->GetBlockId();
       size_t number_of_remaining_predecessors = forward_predecessors[block_id];
       if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+        if (frequency_info.IsCold(successor) && !IsLoop(successor->GetLoopInformation())) {
+          cold_worklist.push_back(successor);
+        } else {
+          AddToListForLinearization(&worklist, successor);
+        }
       }
       forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
-  } while (!worklist.empty());
+  } while (!worklist.empty() || num_cold_visited != cold_worklist.size());
   DCHECK_EQ(num_added, linear_order.size());
 
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
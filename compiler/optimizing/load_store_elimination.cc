@@ -4016,12 +4016,54 @@ class LSEVisitorWrapper : public DeletableArenaObject<kArenaAllocLSE> {
   LSEVisitor lse_visitor_;
 };
 
+// Remove the monitor operations on allocations that are never visible outside of the compiled
+// code. No other thread can ever lock such an object, so entering and exiting its monitor has no
+// effect, and removing them lets LSE eliminate the allocation as well.
+static bool RemoveThreadLocalMonitorOperations(HGraph* graph, OptimizingCompilerStats* stats) {
+  if (!graph->HasMonitorOperations() || graph->IsCompilingOsr()) {
+    // The interpreter may have entered the monitor before the OSR entry.
+    return false;
+  }
+  bool removed = false;
+  bool has_monitor_operations = false;
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (!instruction->IsMonitorOperation()) {
+        continue;
+      }
+      bool is_singleton;
+      bool is_singleton_and_not_returned;
+      bool is_singleton_and_not_deopt_visible;
+      CalculateEscape(instruction->InputAt(0),
+                      /*no_escape_fn=*/ nullptr,
+                      &is_singleton,
+                      &is_singleton_and_not_returned,
+                      &is_singleton_and_not_deopt_visible);
+      // The escape analysis is the same for all monitor operations on an object, so either all
+      // of them are removed or none. A deoptimization would resume in the interpreter without
+      // holding the monitor, so the object must not be visible to one either. Returned objects
+      // could be locked by other threads that would then expect to see our writes.
+      if (is_singleton_and_not_returned && is_singleton_and_not_deopt_visible) {
+        block->RemoveInstruction(instruction);
+        MaybeRecordStat(stats, MethodCompilationStat::kRemovedThreadLocalMonitorOperation);
+        removed = true;
+      } else {
+        has_monitor_operations = true;
+      }
+    }
+  }
+  graph->SetHasMonitorOperations(has_monitor_operations);
+  return removed;
+}
+
 bool LoadStoreElimination::Run(bool enable_partial_lse) {
   if (graph_->IsDebuggable()) {
     // Debugger may set heap values or trigger deoptimization of callers.
     // Skip this optimization.
     return false;
   }
+  bool removed_monitor_operations = RemoveThreadLocalMonitorOperations(graph_, stats_);
   // We need to be able to determine reachability. Clear it just to be safe but
   // this should initially be empty.
   graph_->ClearReachabilityInformation();
@@ -4038,7 +4080,7 @@ bool LoadStoreElimination::Run(bool enable_partial_lse) {
   const HeapLocationCollector& heap_location_collector = lsa.GetHeapLocationCollector();
   if (heap_location_collector.GetNumberOfHeapLocations() == 0) {
     // No HeapLocation information from LSA, skip this optimization.
-    return false;
+    return removed_monitor_operations;
   }
 
   std::unique_ptr<LSEVisitorWrapper> lse_visitor(new (&allocator) LSEVisitorWrapper(
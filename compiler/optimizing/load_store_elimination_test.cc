@@ -1270,6 +1270,115 @@ TEST_F(LoadStoreEliminationTest, DefaultShadowMonitor) {
   EXPECT_INS_EQ(graph_->GetIntConstant(0), return_val->InputAt(0));
 }
 
+// Object o = new Obj();
+// synchronized (o) {
+//   o.foo = 33;
+//   return o.foo;
+// }
+TEST_F(LoadStoreEliminationTest, ThreadLocalMonitor) {
+  CreateGraph();
+  AdjacencyListGraph blocks(
+      graph_, GetAllocator(), "entry", "exit", {{"entry", "main"}, {"main", "exit"}});
+#define GET_BLOCK(name) HBasicBlock* name = blocks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(main);
+  GET_BLOCK(exit);
+#undef GET_BLOCK
+
+  HInstruction* suspend_check = new (GetAllocator()) HSuspendCheck();
+  entry->AddInstruction(suspend_check);
+  entry->AddInstruction(new (GetAllocator()) HGoto());
+  ManuallyBuildEnvFor(suspend_check, {});
+
+  HInstruction* cls = MakeClassLoad();
+  HInstruction* new_inst = MakeNewInstance(cls);
+  HInstruction* const_fence = new (GetAllocator()) HConstructorFence(new_inst, 0, GetAllocator());
+  HInstruction* monitor_enter = new (GetAllocator()) HMonitorOperation(
+      new_inst, HMonitorOperation::OperationKind::kEnter, /* dex_pc= */ 0u);
+  HInstruction* set_field = MakeIFieldSet(new_inst, graph_->GetIntConstant(33), MemberOffset(32));
+  HInstruction* get_field = MakeIFieldGet(new_inst, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* monitor_exit = new (GetAllocator()) HMonitorOperation(
+      new_inst, HMonitorOperation::OperationKind::kExit, /* dex_pc= */ 0u);
+  HInstruction* return_val = new (GetAllocator()) HReturn(get_field);
+  main->AddInstruction(cls);
+  main->AddInstruction(new_inst);
+  main->AddInstruction(const_fence);
+  main->AddInstruction(monitor_enter);
+  main->AddInstruction(set_field);
+  main->AddInstruction(get_field);
+  main->AddInstruction(monitor_exit);
+  main->AddInstruction(return_val);
+  cls->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  new_inst->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  monitor_enter->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  monitor_exit->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  graph_->SetHasMonitorOperations(true);
+
+  SetupExit(exit);
+
+  graph_->ClearDominanceInformation();
+  PerformLSE();
+
+  EXPECT_INS_REMOVED(monitor_enter);
+  EXPECT_INS_REMOVED(monitor_exit);
+  EXPECT_INS_REMOVED(new_inst);
+  EXPECT_INS_REMOVED(get_field);
+  EXPECT_INS_REMOVED(set_field);
+  EXPECT_FALSE(graph_->HasMonitorOperations());
+  EXPECT_INS_EQ(graph_->GetIntConstant(33), return_val->InputAt(0));
+}
+
+// Object o = new Obj();
+// synchronized (o) {
+//   param.foo = o;
+// }
+TEST_F(LoadStoreEliminationTest, EscapingMonitor) {
+  CreateGraph();
+  AdjacencyListGraph blocks(
+      graph_, GetAllocator(), "entry", "exit", {{"entry", "main"}, {"main", "exit"}});
+#define GET_BLOCK(name) HBasicBlock* name = blocks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(main);
+  GET_BLOCK(exit);
+#undef GET_BLOCK
+
+  HInstruction* param = MakeParam(DataType::Type::kReference);
+  HInstruction* suspend_check = new (GetAllocator()) HSuspendCheck();
+  entry->AddInstruction(suspend_check);
+  entry->AddInstruction(new (GetAllocator()) HGoto());
+  ManuallyBuildEnvFor(suspend_check, {});
+
+  HInstruction* cls = MakeClassLoad();
+  HInstruction* new_inst = MakeNewInstance(cls);
+  HInstruction* monitor_enter = new (GetAllocator()) HMonitorOperation(
+      new_inst, HMonitorOperation::OperationKind::kEnter, /* dex_pc= */ 0u);
+  HInstruction* set_field = MakeIFieldSet(param, new_inst, MemberOffset(32));
+  HInstruction* monitor_exit = new (GetAllocator()) HMonitorOperation(
+      new_inst, HMonitorOperation::OperationKind::kExit, /* dex_pc= */ 0u);
+  HInstruction* return_void = new (GetAllocator()) HReturnVoid();
+  main->AddInstruction(cls);
+  main->AddInstruction(new_inst);
+  main->AddInstruction(monitor_enter);
+  main->AddInstruction(set_field);
+  main->AddInstruction(monitor_exit);
+  main->AddInstruction(return_void);
+  cls->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  new_inst->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  monitor_enter->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  monitor_exit->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+  graph_->SetHasMonitorOperations(true);
+
+  SetupExit(exit);
+
+  graph_->ClearDominanceInformation();
+  PerformLSE();
+
+  EXPECT_INS_RETAINED(monitor_enter);
+  EXPECT_INS_RETAINED(monitor_exit);
+  EXPECT_INS_RETAINED(new_inst);
+  EXPECT_TRUE(graph_->HasMonitorOperations());
+}
+
 // void DO_CAL() {
 //   int i = 1;
 //   int[] w = new int[80];
@@ -112,6 +112,8 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
 
   bool IsLoopPeelingEnabled() const override { return true; }
 
+  bool IsLoopVersioningEnabled() const override { return true; }
+
   bool IsFullUnrollingBeneficial(LoopAnalysisInfo* analysis_info) const override {
     int64_t trip_count = analysis_info->GetTripCount();
     // We assume that trip count is known.
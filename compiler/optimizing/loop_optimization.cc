@@ -19,6 +19,7 @@
 #include "arch/arm/instruction_set_features_arm.h"
 #include "arch/arm64/instruction_set_features_arm64.h"
 #include "arch/instruction_set.h"
+#include "arch/riscv64/instruction_set_features_riscv64.h"
 #include "arch/x86/instruction_set_features_x86.h"
 #include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "code_generator.h"
@@ -32,6 +33,9 @@ namespace art HIDDEN {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Maximum number of bounds checks in a loop to be removed by loop versioning.
+static constexpr size_t kMaxVersionedBoundsChecks = 8;
+
 //
 // Static helpers.
 //
@@ -436,6 +440,23 @@ static void PeelByCount(HLoopInformation* loop_info,
   }
 }
 
+// Splits the edge between 'block' and 'successor' with a new block ending in HGoto.
+static HBasicBlock* SplitEdgeWithGoto(HGraph* graph, HBasicBlock* block, HBasicBlock* successor) {
+  HBasicBlock* new_block = graph->SplitEdge(block, successor);
+  new_block->AddInstruction(new (graph->GetAllocator()) HGoto(successor->GetDexPc()));
+  graph->UpdateLoopAndTryInformationOfNewBlock(
+      new_block, block, /* replace_if_back_edge= */ false);
+  return new_block;
+}
+
+// Replaces the HGoto at the end of 'block' with an HIf on 'condition'.
+static void ReplaceGotoWithIf(HBasicBlock* block, HInstruction* condition) {
+  HInstruction* last = block->GetLastInstruction();
+  DCHECK(last->IsGoto());
+  block->RemoveInstruction(last);
+  block->AddInstruction(new (block->GetGraph()->GetAllocator()) HIf(condition, last->GetDexPc()));
+}
+
 // Returns the narrower type out of instructions a and b types.
 static DataType::Type GetNarrowerType(HInstruction* a, HInstruction* b) {
   DataType::Type type = a->GetType();
@@ -967,6 +988,186 @@ bool HLoopOptimization::TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool g
   return true;
 }
 
+HInstruction* HLoopOptimization::GetVersioningCandidateArray(HLoopInformation* loop_info,
+                                                             HBoundsCheck* bounds_check) {
+  if (bounds_check->IsStringCharAt()) {
+    return nullptr;
+  }
+  // The length must be the loop invariant length of a loop invariant array. The in-loop null
+  // check of the array, if any, is replaced with a test in the preheader.
+  HArrayLength* length = bounds_check->InputAt(1)->AsArrayLength();
+  if (length == nullptr || length->IsStringLength()) {
+    return nullptr;
+  }
+  HInstruction* array = length->InputAt(0);
+  if (!loop_info->IsDefinedOutOfTheLoop(length) && array->IsNullCheck()) {
+    array = array->InputAt(0);
+  }
+  if (!loop_info->IsDefinedOutOfTheLoop(array)) {
+    return nullptr;
+  }
+  // The range of the index over the whole loop must be computable in the preheader. A loop
+  // which may not be taken is fine, as the test only selects which of the loops is executed.
+  bool needs_finite_test = false;
+  bool needs_taken_test = false;
+  if (!induction_range_.CanGenerateRange(bounds_check->GetBlock(),
+                                         bounds_check->InputAt(0),
+                                         &needs_finite_test,
+                                         &needs_taken_test) ||
+      needs_finite_test) {
+    return nullptr;
+  }
+  return array;
+}
+
+bool HLoopOptimization::TryVersioningForBoundsCheckElimination(LoopAnalysisInfo* analysis_info,
+                                                               bool generate_code) {
+  if (!arch_loop_helper_->IsLoopVersioningEnabled() || !graph_->HasBoundsChecks()) {
+    return false;
+  }
+
+  // Only version loops which become free of bounds checks.
+  HLoopInformation* loop_info = analysis_info->GetLoopInfo();
+  ScopedArenaVector<HBoundsCheck*> bounds_checks(
+      loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<HInstruction*> arrays(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+  for (HBlocksInLoopIterator block_it(*loop_info); !block_it.Done(); block_it.Advance()) {
+    HBasicBlock* block = block_it.Current();
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HBoundsCheck* bounds_check = it.Current()->AsBoundsCheck();
+      if (bounds_check == nullptr) {
+        continue;
+      }
+      HInstruction* array = GetVersioningCandidateArray(loop_info, bounds_check);
+      if (array == nullptr || bounds_checks.size() == kMaxVersionedBoundsChecks) {
+        return false;
+      }
+      bounds_checks.push_back(bounds_check);
+      arrays.push_back(array);
+    }
+  }
+  if (bounds_checks.empty()) {
+    return false;
+  }
+
+  if (generate_code) {
+    //
+    // Versioning results in the following control flow, where the tests of the slow path
+    // are split in two blocks only when some array is null checked in the loop:
+    //
+    //                  preheader: if (array == null || ...)
+    //                 /                        \
+    //                |            range_block: if (upper >= length || ...)
+    //                |          /                          \
+    //          goto_block  goto_block                 copy_preheader
+    //                 \        /                             |
+    //             orig_preheader                          copy loop
+    //                   |                         (without bounds checks)
+    //               orig loop
+    //
+    HBasicBlock* preheader = loop_info->GetPreHeader();
+
+    // Compute the ranges of the indices while the induction information is valid, and the null
+    // tests of the arrays whose null check is in the loop.
+    ScopedArenaVector<HInstruction*> lowers(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaVector<HInstruction*> uppers(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaSet<HInstruction*> null_checked_arrays(
+        loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    HInstruction* null_test = nullptr;
+    for (size_t i = 0, size = bounds_checks.size(); i < size; ++i) {
+      HBoundsCheck* bounds_check = bounds_checks[i];
+      HInstruction* lower = nullptr;
+      HInstruction* upper = nullptr;
+      induction_range_.GenerateRange(
+          bounds_check->GetBlock(), bounds_check->InputAt(0), graph_, preheader, &lower, &upper);
+      lowers.push_back(lower);
+      uppers.push_back(upper);
+      HInstruction* array = arrays[i];
+      if (!loop_info->IsDefinedOutOfTheLoop(bounds_check->InputAt(1)) &&
+          array->CanBeNull() &&
+          null_checked_arrays.insert(array).second) {
+        HInstruction* test = Insert(preheader, new (global_allocator_) HEqual(
+            array, graph_->GetNullConstant()));
+        null_test = (null_test == nullptr)
+            ? test
+            : Insert(preheader,
+                     new (global_allocator_) HOr(DataType::Type::kBool, null_test, test));
+      }
+    }
+
+    LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+    helper.DoVersioning();
+
+    // After versioning, both loops have their own preheader, split from the common one.
+    HBasicBlock* orig_preheader = loop_info->GetPreHeader();
+    HBasicBlock* copy_header = helper.GetBasicBlockMap()->Get(loop_info->GetHeader());
+    HBasicBlock* copy_preheader = copy_header->GetLoopInformation()->GetPreHeader();
+    DCHECK_EQ(preheader->GetSuccessors()[0], orig_preheader);
+    DCHECK_EQ(preheader->GetSuccessors()[1], copy_preheader);
+
+    HBasicBlock* range_block = preheader;
+    if (null_test != nullptr) {
+      // Lengths can only be loaded once the arrays are known to be non-null: test the ranges
+      // in the block which was the preheader of the copy loop, and add a new one.
+      range_block = copy_preheader;
+      copy_preheader = SplitEdgeWithGoto(graph_, range_block, copy_header);
+      ReplaceGotoWithIf(preheader, null_test);
+      range_block->AddSuccessor(orig_preheader);
+      range_block->SwapSuccessors();
+      SplitEdgeWithGoto(graph_, preheader, orig_preheader);
+      SplitEdgeWithGoto(graph_, range_block, orig_preheader);
+    }
+
+    ScopedArenaSafeMap<HInstruction*, HInstruction*> lengths(
+        std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    HInstruction* range_test = nullptr;
+    for (size_t i = 0, size = bounds_checks.size(); i < size; ++i) {
+      HInstruction* length = bounds_checks[i]->InputAt(1);
+      if (!loop_info->IsDefinedOutOfTheLoop(length)) {
+        auto it = lengths.find(arrays[i]);
+        if (it != lengths.end()) {
+          length = it->second;
+        } else {
+          length = Insert(range_block, new (global_allocator_) HArrayLength(
+              arrays[i], length->GetDexPc()));
+          lengths.Put(arrays[i], length);
+        }
+      }
+      // Unsigned comparisons also catch negative indices.
+      for (HInstruction* bound : {lowers[i], uppers[i]}) {
+        if (bound == nullptr) {
+          continue;
+        }
+        HInstruction* test = Insert(range_block, new (global_allocator_) HAboveOrEqual(
+            bound, length));
+        range_test = (range_test == nullptr)
+            ? test
+            : Insert(range_block,
+                     new (global_allocator_) HOr(DataType::Type::kBool, range_test, test));
+      }
+    }
+    DCHECK(range_test != nullptr);
+    ReplaceGotoWithIf(range_block, range_test);
+
+    graph_->ClearDominanceInformation();
+    graph_->ComputeDominanceInformation();
+
+    // Remove the bounds checks, and the null checks of the tested arrays, from the copy loop.
+    for (auto entry : *helper.GetInstructionMap()) {
+      HInstruction* copy = entry.second;
+      if (copy->IsBoundsCheck() ||
+          (copy->IsNullCheck() && null_checked_arrays.find(copy->InputAt(0)) !=
+                                      null_checked_arrays.end())) {
+        copy->ReplaceWith(copy->InputAt(0));
+        copy->GetBlock()->RemoveInstruction(copy);
+      }
+    }
+    MaybeRecordStat(stats_, MethodCompilationStat::kLoopVersioned);
+  }
+
+  return true;
+}
+
 bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
   HLoopInformation* loop_info = node->loop_info;
   int64_t trip_count = LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_);
@@ -980,6 +1181,7 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   if (!TryFullUnrolling(&analysis_info, /*generate_code*/ false) &&
       !TryPeelingForLoopInvariantExitsElimination(&analysis_info, /*generate_code*/ false) &&
+      !TryVersioningForBoundsCheckElimination(&analysis_info, /*generate_code*/ false) &&
       !TryUnrollingForBranchPenaltyReduction(&analysis_info, /*generate_code*/ false) &&
       !TryToRemoveSuspendCheckFromLoopHeader(&analysis_info, /*generate_code*/ false)) {
     return false;
@@ -997,6 +1199,7 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   return TryFullUnrolling(&analysis_info) ||
          TryPeelingForLoopInvariantExitsElimination(&analysis_info) ||
+         TryVersioningForBoundsCheckElimination(&analysis_info) ||
          TryUnrollingForBranchPenaltyReduction(&analysis_info) || removed_suspend_check;
 }
 
@@ -1764,6 +1967,38 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
         }
         return false;
       }
+    case InstructionSet::kRiscv64:
+      // Allow vectorization for devices with the V extension only. The vector length is
+      // fixed at 128 bits, the minimum VLEN for application processors, which is correct
+      // for any wider implementation as well.
+      if (features->AsRiscv64InstructionSetFeatures()->HasVector()) {
+        switch (type) {
+          case DataType::Type::kBool:
+          case DataType::Type::kUint8:
+          case DataType::Type::kInt8:
+            *restrictions |= kNoDiv | kNoReduction;
+            return TrySetVectorLength(type, 16);
+          case DataType::Type::kUint16:
+          case DataType::Type::kInt16:
+            *restrictions |= kNoDiv | kNoStringCharAt | kNoReduction;
+            return TrySetVectorLength(type, 8);
+          case DataType::Type::kInt32:
+            *restrictions |= kNoDiv;
+            return TrySetVectorLength(type, 4);
+          case DataType::Type::kInt64:
+            *restrictions |= kNoDiv;
+            return TrySetVectorLength(type, 2);
+          case DataType::Type::kFloat32:
+            *restrictions |= kNoReduction;
+            return TrySetVectorLength(type, 4);
+          case DataType::Type::kFloat64:
+            *restrictions |= kNoReduction;
+            return TrySetVectorLength(type, 2);
+          default:
+            break;
+        }
+      }
+      return false;
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
       // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
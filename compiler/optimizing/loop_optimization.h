@@ -185,6 +185,19 @@ class HLoopOptimization : public HOptimization {
   // should be actually applied.
   bool TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool generate_code = true);
 
+  // Tries to apply loop versioning to remove the bounds checks left in the loop: a copy of the
+  // loop without any bounds checks is executed if a single test in the preheader shows that all
+  // the accessed array ranges are in bounds; the original loop is executed otherwise. Returns
+  // whether transformation happened. 'generate_code' determines whether the optimization should
+  // be actually applied.
+  bool TryVersioningForBoundsCheckElimination(LoopAnalysisInfo* analysis_info,
+                                              bool generate_code = true);
+
+  // Returns the loop invariant array whose bounds are checked by 'bounds_check' if the check can
+  // be removed by loop versioning, or nullptr otherwise.
+  HInstruction* GetVersioningCandidateArray(HLoopInformation* loop_info,
+                                            HBoundsCheck* bounds_check);
+
   // Tries to remove SuspendCheck for plain loops with a low trip count. The
   // SuspendCheck in the codegen makes sure that the thread can be interrupted
   // during execution for GC. Not being able to do so might decrease the
@@ -36,6 +36,7 @@
 #include "code_generator.h"
 #include "common_dominator.h"
 #include "intrinsics.h"
+#include "jit/profiling_info.h"
 #include "mirror/class-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "ssa_builder.h"
@@ -299,6 +300,10 @@ static bool UpdateDominatorOfSuccessor(HBasicBlock* block, HBasicBlock* successo
 }
 
 // TODO Consider moving this entirely into LoadStoreAnalysis/Elimination.
+bool HGraph::HasDeoptimizedBefore(DeoptimizationKind kind) const {
+  return profiling_info_ != nullptr && profiling_info_->HasDeoptimized(kind);
+}
+
 bool HGraph::PathBetween(uint32_t source_idx, uint32_t dest_idx) const {
   DCHECK_LT(source_idx, blocks_.size()) << "source not present in graph!";
   DCHECK_LT(dest_idx, blocks_.size()) << "dest not present in graph!";
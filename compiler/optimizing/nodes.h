@@ -729,6 +729,10 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   void SetProfilingInfo(ProfilingInfo* info) { profiling_info_ = info; }
   ProfilingInfo* GetProfilingInfo() const { return profiling_info_; }
 
+  // Returns whether previously compiled code of the method deoptimized because a speculation
+  // of `kind` failed, in which case the compiler should not speculate the same way again.
+  bool HasDeoptimizedBefore(DeoptimizationKind kind) const;
+
   // Returns an instruction with the opposite Boolean value from 'cond'.
   // The instruction has been inserted into the graph, either as a constant, or
   // before cursor.
@@ -1645,7 +1649,8 @@ class HLoopInformationOutwardIterator : public ValueObject {
 /*
  * Instructions, shared across several (not all) architectures.
  */
-#if !defined(ART_ENABLE_CODEGEN_arm) && !defined(ART_ENABLE_CODEGEN_arm64)
+#if !defined(ART_ENABLE_CODEGEN_arm) && !defined(ART_ENABLE_CODEGEN_arm64) && \
+    !defined(ART_ENABLE_CODEGEN_riscv64)
 #define FOR_EACH_CONCRETE_INSTRUCTION_SHARED(M)
 #else
 #define FOR_EACH_CONCRETE_INSTRUCTION_SHARED(M)                         \
@@ -1659,6 +1664,13 @@ class HLoopInformationOutwardIterator : public ValueObject {
 
 #define FOR_EACH_CONCRETE_INSTRUCTION_ARM64(M)
 
+#ifndef ART_ENABLE_CODEGEN_riscv64
+#define FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(M)
+#else
+#define FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(M)                        \
+  M(Riscv64ShiftAdd, Instruction)
+#endif
+
 #ifndef ART_ENABLE_CODEGEN_x86
 #define FOR_EACH_CONCRETE_INSTRUCTION_X86(M)
 #else
@@ -1684,6 +1696,7 @@ class HLoopInformationOutwardIterator : public ValueObject {
   FOR_EACH_CONCRETE_INSTRUCTION_SHARED(M)                               \
   FOR_EACH_CONCRETE_INSTRUCTION_ARM(M)                                  \
   FOR_EACH_CONCRETE_INSTRUCTION_ARM64(M)                                \
+  FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(M)                              \
   FOR_EACH_CONCRETE_INSTRUCTION_X86(M)                                  \
   FOR_EACH_CONCRETE_INSTRUCTION_X86_64(M)                               \
   FOR_EACH_CONCRETE_INSTRUCTION_X86_COMMON(M)
@@ -5022,7 +5035,9 @@ class HInvokeStaticOrDirect final : public HInvoke {
   }
 
   bool CanBeNull() const override {
-    return GetType() == DataType::Type::kReference && !IsStringInit();
+    return GetType() == DataType::Type::kReference &&
+           !IsStringInit() &&
+           GetIntrinsic() != Intrinsics::kIntegerValueOf;
   }
 
   MethodLoadKind GetMethodLoadKind() const { return dispatch_info_.method_load_kind; }
@@ -8532,9 +8547,13 @@ class HIntermediateAddress final : public HExpression<2> {
 
 #include "nodes_vector.h"
 
-#if defined(ART_ENABLE_CODEGEN_arm) || defined(ART_ENABLE_CODEGEN_arm64)
+#if defined(ART_ENABLE_CODEGEN_arm) || defined(ART_ENABLE_CODEGEN_arm64) || \
+    defined(ART_ENABLE_CODEGEN_riscv64)
 #include "nodes_shared.h"
 #endif
+#if defined(ART_ENABLE_CODEGEN_riscv64)
+#include "nodes_riscv64.h"
+#endif
 #if defined(ART_ENABLE_CODEGEN_x86) || defined(ART_ENABLE_CODEGEN_x86_64)
 #include "nodes_x86.h"
 #endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_NODES_RISCV64_H_
+#define ART_COMPILER_OPTIMIZING_NODES_RISCV64_H_
+
+namespace art HIDDEN {
+
+// Shift the left input by `distance` (1, 2 or 3) and add the right input, i.e. compute
+// `(left << distance) + right`. Maps to the Zba instructions SH1ADD, SH2ADD and SH3ADD.
+class HRiscv64ShiftAdd final : public HBinaryOperation {
+ public:
+  HRiscv64ShiftAdd(HInstruction* left,
+                   HInstruction* right,
+                   uint32_t distance,
+                   uint32_t dex_pc = kNoDexPc)
+      : HBinaryOperation(kRiscv64ShiftAdd,
+                         DataType::Type::kInt64,
+                         left,
+                         right,
+                         SideEffects::None(),
+                         dex_pc),
+        distance_(distance) {
+    DCHECK_GE(distance, 1u);
+    DCHECK_LE(distance, 3u);
+  }
+
+  bool IsClonable() const override { return true; }
+  bool InstructionDataEquals(const HInstruction* other) const override {
+    return distance_ == other->AsRiscv64ShiftAdd()->distance_;
+  }
+
+  uint32_t GetDistance() const { return distance_; }
+
+  HConstant* Evaluate(HIntConstant* x ATTRIBUTE_UNUSED,
+                      HIntConstant* y ATTRIBUTE_UNUSED) const override {
+    LOG(FATAL) << DebugName() << " is not defined for int values";
+    UNREACHABLE();
+  }
+  HConstant* Evaluate(HLongConstant* x, HLongConstant* y) const override {
+    uint64_t value = (static_cast<uint64_t>(x->GetValue()) << distance_) +
+                     static_cast<uint64_t>(y->GetValue());
+    return GetBlock()->GetGraph()->GetLongConstant(static_cast<int64_t>(value), GetDexPc());
+  }
+  HConstant* Evaluate(HFloatConstant* x ATTRIBUTE_UNUSED,
+                      HFloatConstant* y ATTRIBUTE_UNUSED) const override {
+    LOG(FATAL) << DebugName() << " is not defined for float values";
+    UNREACHABLE();
+  }
+  HConstant* Evaluate(HDoubleConstant* x ATTRIBUTE_UNUSED,
+                      HDoubleConstant* y ATTRIBUTE_UNUSED) const override {
+    LOG(FATAL) << DebugName() << " is not defined for double values";
+    UNREACHABLE();
+  }
+
+  DECLARE_INSTRUCTION(Riscv64ShiftAdd);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(Riscv64ShiftAdd);
+
+ private:
+  const uint32_t distance_;
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_NODES_RISCV64_H_
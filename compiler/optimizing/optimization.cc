@@ -23,6 +23,9 @@
 #ifdef ART_ENABLE_CODEGEN_arm64
 #include "instruction_simplifier_arm64.h"
 #endif
+#ifdef ART_ENABLE_CODEGEN_riscv64
+#include "instruction_simplifier_riscv64.h"
+#endif
 #ifdef ART_ENABLE_CODEGEN_x86
 #include "pc_relative_fixups_x86.h"
 #include "instruction_simplifier_x86.h"
@@ -55,6 +58,7 @@
 #include "select_generator.h"
 #include "sharpening.h"
 #include "side_effects_analysis.h"
+#include "slp_vectorizer.h"
 #include "write_barrier_elimination.h"
 
 // Decide between default or alternative pass name.
@@ -97,6 +101,8 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return ConstructorFenceRedundancyElimination::kCFREPassName;
     case OptimizationPass::kScheduling:
       return HInstructionScheduling::kInstructionSchedulingPassName;
+    case OptimizationPass::kSlpVectorizer:
+      return HSlpVectorizer::kSlpVectorizerPassName;
     case OptimizationPass::kWriteBarrierElimination:
       return WriteBarrierElimination::kWBEPassName;
 #ifdef ART_ENABLE_CODEGEN_arm
@@ -109,6 +115,10 @@ const char* OptimizationPassName(OptimizationPass pass) {
     case OptimizationPass::kInstructionSimplifierArm64:
       return arm64::InstructionSimplifierArm64::kInstructionSimplifierArm64PassName;
 #endif
+#ifdef ART_ENABLE_CODEGEN_riscv64
+    case OptimizationPass::kInstructionSimplifierRiscv64:
+      return riscv64::InstructionSimplifierRiscv64::kInstructionSimplifierRiscv64PassName;
+#endif
 #ifdef ART_ENABLE_CODEGEN_x86
     case OptimizationPass::kPcRelativeFixupsX86:
       return x86::PcRelativeFixups::kPcRelativeFixupsX86PassName;
@@ -148,6 +158,7 @@ OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kScheduling);
   X(OptimizationPass::kSelectGenerator);
   X(OptimizationPass::kSideEffectsAnalysis);
+  X(OptimizationPass::kSlpVectorizer);
 #ifdef ART_ENABLE_CODEGEN_arm
   X(OptimizationPass::kInstructionSimplifierArm);
   X(OptimizationPass::kCriticalNativeAbiFixupArm);
@@ -280,6 +291,9 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kWriteBarrierElimination:
         opt = new (allocator) WriteBarrierElimination(graph, stats, pass_name);
         break;
+      case OptimizationPass::kSlpVectorizer:
+        opt = new (allocator) HSlpVectorizer(graph, *codegen, stats, pass_name);
+        break;
       case OptimizationPass::kScheduling:
         opt = new (allocator) HInstructionScheduling(
             graph, codegen->GetCompilerOptions().GetInstructionSet(), codegen, pass_name);
@@ -303,6 +317,12 @@ ArenaVector<HOptimization*> ConstructOptimizations(
         opt = new (allocator) arm64::InstructionSimplifierArm64(graph, stats);
         break;
 #endif
+#ifdef ART_ENABLE_CODEGEN_riscv64
+      case OptimizationPass::kInstructionSimplifierRiscv64:
+        DCHECK(alt_name == nullptr) << "arch-specific pass does not support alternative name";
+        opt = new (allocator) riscv64::InstructionSimplifierRiscv64(graph, codegen, stats);
+        break;
+#endif
 #ifdef ART_ENABLE_CODEGEN_x86
       case OptimizationPass::kPcRelativeFixupsX86:
         DCHECK(alt_name == nullptr) << "arch-specific pass does not support alternative name";
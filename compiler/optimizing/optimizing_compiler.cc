@@ -30,6 +30,7 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -68,6 +69,25 @@ static constexpr size_t kArenaAllocatorMemoryReportThreshold = 8 * MB;
 
 static constexpr const char* kPassNameSeparator = "$";
 
+// Number of instruction ids above which the graph is considered too large for the passes
+// returned by `IsExpensiveOnLargeGraphs()`. Their compile time grows faster than linearly with
+// the size of the graph, and such graphs come mostly from generated code where they have little
+// to gain. The instruction count is used rather than a time budget to keep the output of dex2oat
+// deterministic.
+static constexpr uint32_t kLargeGraphInstructionThreshold = 32 * KB;
+
+static bool IsExpensiveOnLargeGraphs(OptimizationPass pass) {
+  switch (pass) {
+    case OptimizationPass::kLoadStoreElimination:
+    case OptimizationPass::kLoopOptimization:
+    case OptimizationPass::kSlpVectorizer:
+    case OptimizationPass::kScheduling:
+      return true;
+    default:
+      return false;
+  }
+}
+
 /**
  * Used by the code generator, to allocate the code in a vector.
  */
@@ -103,6 +123,8 @@ class PassObserver : public ValueObject {
   PassObserver(HGraph* graph,
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
+               std::ostream* pass_profile_output,
+               Mutex* pass_profile_lock,
                const CompilerOptions& compiler_options)
       : graph_(graph),
         last_seen_graph_size_(0),
@@ -115,10 +137,17 @@ class PassObserver : public ValueObject {
         visualizer_enabled_(!compiler_options.GetDumpCfgFileName().empty()),
         visualizer_(&visualizer_oss_, graph, codegen),
         codegen_(codegen),
+        pass_profile_oss_(),
+        pass_profile_output_(pass_profile_output),
+        pass_profile_lock_(pass_profile_lock),
+        pass_profile_enabled_(pass_profile_output != nullptr),
+        pass_profile_first_pass_(true),
+        pass_start_ns_(0u),
+        pass_start_arena_bytes_(0u),
         graph_in_bad_state_(false) {
-    if (timing_logger_enabled_ || visualizer_enabled_) {
+    if (timing_logger_enabled_ || visualizer_enabled_ || pass_profile_enabled_) {
       if (!IsVerboseMethod(compiler_options, GetMethodName())) {
-        timing_logger_enabled_ = visualizer_enabled_ = false;
+        timing_logger_enabled_ = visualizer_enabled_ = pass_profile_enabled_ = false;
       }
       if (visualizer_enabled_) {
         visualizer_.PrintHeader(GetMethodName());
@@ -136,6 +165,9 @@ class PassObserver : public ValueObject {
       FlushVisualizer();
     }
     DCHECK(visualizer_oss_.str().empty());
+    if (pass_profile_enabled_) {
+      FlushPassProfile();
+    }
   }
 
   void DumpDisassembly() {
@@ -166,6 +198,10 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (pass_profile_enabled_) {
+      pass_start_arena_bytes_ = graph_->GetAllocator()->BytesUsed();
+      pass_start_ns_ = NanoTime();
+    }
   }
 
   void FlushVisualizer() {
@@ -175,8 +211,46 @@ class PassObserver : public ValueObject {
     visualizer_oss_.clear();
   }
 
+  // Writes the profile of the method as a single line, so that the output of concurrent
+  // compilations can be aggregated line by line.
+  void FlushPassProfile() {
+    std::ostringstream line;
+    line << "{\"method\":\"" << EscapeJsonString(GetMethodName()) << "\""
+         << ",\"instructions\":" << graph_->GetCurrentInstructionId()
+         << ",\"passes\":[" << pass_profile_oss_.str() << "]}\n";
+    MutexLock mu(Thread::Current(), *pass_profile_lock_);
+    *pass_profile_output_ << line.str();
+    pass_profile_output_->flush();
+  }
+
+  void RecordPassProfile(const char* pass_name, uint64_t duration_ns) {
+    size_t arena_bytes = graph_->GetAllocator()->BytesUsed();
+    // Allocations can only be released by the scoped arenas, report the peak for those.
+    size_t arena_stack_bytes = graph_->GetArenaStack()->ApproximatePeakBytes();
+    pass_profile_oss_ << (pass_profile_first_pass_ ? "" : ",")
+                      << "{\"name\":\"" << EscapeJsonString(pass_name) << "\""
+                      << ",\"time_ns\":" << duration_ns
+                      << ",\"arena_bytes\":" << (arena_bytes - pass_start_arena_bytes_)
+                      << ",\"arena_stack_peak_bytes\":" << arena_stack_bytes << "}";
+    pass_profile_first_pass_ = false;
+  }
+
+  static std::string EscapeJsonString(const char* str) {
+    std::string result;
+    for (const char* c = str; *c != '\0'; ++c) {
+      if (*c == '"' || *c == '\\') {
+        result += '\\';
+      }
+      result += *c;
+    }
+    return result;
+  }
+
   void EndPass(const char* pass_name, bool pass_change) {
     // Pause timer first, then dump graph.
+    if (pass_profile_enabled_) {
+      RecordPassProfile(pass_name, NanoTime() - pass_start_ns_);
+    }
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
@@ -234,6 +308,14 @@ class PassObserver : public ValueObject {
   HGraphVisualizer visualizer_;
   CodeGenerator* codegen_;
 
+  std::ostringstream pass_profile_oss_;
+  std::ostream* pass_profile_output_;
+  Mutex* pass_profile_lock_;
+  bool pass_profile_enabled_;
+  bool pass_profile_first_pass_;
+  uint64_t pass_start_ns_;
+  size_t pass_start_arena_bytes_;
+
   // Flag to be set by the compiler if the pass failed and the graph is not
   // expected to validate.
   bool graph_in_bad_state_;
@@ -326,7 +408,13 @@ class OptimizingCompiler final : public Compiler {
     pass_changes[static_cast<size_t>(OptimizationPass::kNone)] = true;
     bool change = false;
     for (size_t i = 0; i < length; ++i) {
-      if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
+      if (IsExpensiveOnLargeGraphs(definitions[i].pass) &&
+          static_cast<uint32_t>(graph->GetCurrentInstructionId()) >
+              kLargeGraphInstructionThreshold) {
+        // Skip the pass and record that nothing changed.
+        MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kSkippedPassLargeGraph);
+        pass_changes[static_cast<size_t>(definitions[i].pass)] = false;
+      } else if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
         // Execute the pass and record whether it changed anything.
         PassScope scope(optimizations[i]->GetPassName(), pass_observer);
         bool pass_change = optimizations[i]->Run();
@@ -407,6 +495,10 @@ class OptimizingCompiler final : public Compiler {
 
   std::unique_ptr<std::ostream> visualizer_output_;
 
+  // Output of --dump-pass-profile, shared by all the compiling threads.
+  std::unique_ptr<std::ostream> pass_profile_output_;
+  mutable Mutex pass_profile_lock_;
+
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
 };
 
@@ -414,7 +506,8 @@ static const int kMaximumCompilationTimeBeforeWarning = 100; /* ms */
 
 OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
                                        CompiledCodeStorage* storage)
-    : Compiler(compiler_options, storage, kMaximumCompilationTimeBeforeWarning) {
+    : Compiler(compiler_options, storage, kMaximumCompilationTimeBeforeWarning),
+      pass_profile_lock_("pass profile lock", kGenericBottomLock) {
   // Enable C1visualizer output.
   const std::string& cfg_file_name = compiler_options.GetDumpCfgFileName();
   if (!cfg_file_name.empty()) {
@@ -423,6 +516,10 @@ OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
     visualizer_output_.reset(new std::ofstream(cfg_file_name, cfg_file_mode));
     DumpInstructionSetFeaturesToCfg();
   }
+  const std::string& pass_profile_file_name = compiler_options.GetDumpPassProfileFileName();
+  if (!pass_profile_file_name.empty()) {
+    pass_profile_output_.reset(new std::ofstream(pass_profile_file_name, std::ofstream::app));
+  }
   if (compiler_options.GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
@@ -455,6 +552,7 @@ bool OptimizingCompiler::CanCompileMethod(uint32_t method_idx ATTRIBUTE_UNUSED,
 static bool IsInstructionSetSupported(InstructionSet instruction_set) {
   return instruction_set == InstructionSet::kArm
       || instruction_set == InstructionSet::kArm64
+      || instruction_set == InstructionSet::kRiscv64
       || instruction_set == InstructionSet::kThumb2
       || instruction_set == InstructionSet::kX86
       || instruction_set == InstructionSet::kX86_64;
@@ -536,6 +634,21 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                               arm64_optimizations);
     }
 #endif
+#ifdef ART_ENABLE_CODEGEN_riscv64
+    case InstructionSet::kRiscv64: {
+      OptimizationDef riscv64_optimizations[] = {
+        OptDef(OptimizationPass::kInstructionSimplifierRiscv64),
+        OptDef(OptimizationPass::kSideEffectsAnalysis),
+        OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+        OptDef(OptimizationPass::kScheduling)
+      };
+      return RunOptimizations(graph,
+                              codegen,
+                              dex_compilation_unit,
+                              pass_observer,
+                              riscv64_optimizations);
+    }
+#endif
 #ifdef ART_ENABLE_CODEGEN_x86
     case InstructionSet::kX86: {
       OptimizationDef x86_optimizations[] = {
@@ -678,6 +791,7 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
            "dead_code_elimination$after_loop_opt"),
     // Other high-level optimizations.
     OptDef(OptimizationPass::kLoadStoreElimination),
+    OptDef(OptimizationPass::kSlpVectorizer),
     OptDef(OptimizationPass::kCHAGuardOptimization),
     OptDef(OptimizationPass::kCodeSinking),
     // Simplification.
@@ -846,6 +960,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
+                             pass_profile_output_.get(),
+                             &pass_profile_lock_,
                              compiler_options);
 
   {
@@ -971,6 +1087,8 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
+                             pass_profile_output_.get(),
+                             &pass_profile_lock_,
                              compiler_options);
 
   {
@@ -66,6 +66,7 @@ enum class MethodCompilationStat {
   kNotCompiledPhiEquivalentInOsr,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -74,11 +75,14 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopVersioned,
+  kSlpVectorized,
   kSelectGenerated,
   kRemovedInstanceOf,
   kPropagatedIfValue,
   kInlinedInvokeVirtualOrInterface,
   kInlinedLastInvokeVirtualOrInterface,
+  kRefinedReturnTypeFromCallee,
   kImplicitNullCheckGenerated,
   kExplicitNullCheckGenerated,
   kSimplifyIf,
@@ -114,6 +118,7 @@ enum class MethodCompilationStat {
   kNotInlinedPolymorphic,
   kNotInlinedCustom,
   kNotVarAnalyzedPathological,
+  kSkippedPassLargeGraph,
   kTryInline,
   kConstructorFenceGeneratedNew,
   kConstructorFenceGeneratedFinal,
@@ -133,6 +138,7 @@ enum class MethodCompilationStat {
   kPredicatedLoadAdded,
   kPredicatedStoreAdded,
   kDevirtualized,
+  kRemovedThreadLocalMonitorOperation,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
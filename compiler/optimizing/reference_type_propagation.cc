@@ -866,6 +866,16 @@ void ReferenceTypePropagation::RTPVisitor::VisitInvoke(HInvoke* instr) {
   // protoId than the one obtained from the resolved method.
   ArtMethod* method = instr->GetResolvedMethod();
   ObjPtr<mirror::Class> klass = (method == nullptr) ? nullptr : method->LookupResolvedReturnType();
+  // Keep an existing type more specific than the declared return type: the inliner may have
+  // refined it from the body of the callee.
+  ReferenceTypeInfo existing_rti = instr->GetReferenceTypeInfo();
+  if (existing_rti.IsValid() &&
+      klass != nullptr &&
+      IsAdmissible(klass) &&
+      klass->IsAssignableFrom(existing_rti.GetTypeHandle().Get()) &&
+      (existing_rti.IsExact() || klass != existing_rti.GetTypeHandle().Get())) {
+    return;
+  }
   SetClassAsTypeInfo(instr, klass, /* is_exact= */ false);
 }
 
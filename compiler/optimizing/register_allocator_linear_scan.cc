@@ -92,6 +92,7 @@ static bool ShouldProcess(bool processing_core_registers, LiveInterval* interval
 
 void RegisterAllocatorLinearScan::AllocateRegisters() {
   AllocateRegistersInternal();
+  SpillUnusedLoopHeaderSiblings();
   RegisterAllocationResolver(codegen_, liveness_)
       .Resolve(ArrayRef<HInstruction* const>(safepoints_),
                reserved_out_slots_,
@@ -221,6 +222,68 @@ void RegisterAllocatorLinearScan::AllocateRegistersInternal() {
   LinearScan();
 }
 
+// Returns whether `interval` has a non-synthesized use in its range. Environment uses are fine
+// with a stack location.
+static bool HasUseInRange(LiveInterval* interval) {
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+  for (const UsePosition& use : interval->GetUses()) {
+    size_t position = use.GetPosition();
+    if (position > end) {
+      break;
+    }
+    if (position >= start && !use.IsSynthesized()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RegisterAllocatorLinearScan::SpillUnusedLoopHeaderSiblings() {
+  // Linear scan splits an interval being evicted at the position of the interval taking its
+  // register. When that position is in a loop, the interval usually entered the loop in a
+  // register at the loop header (see `SplitBetween`) and is on the stack at the back edges,
+  // leading to a reload on each back edge. If the register is not used in the loop, keep the
+  // interval on the stack for the whole loop instead. The spill slot already holds the value as
+  // values are eagerly spilled at their definition.
+  for (size_t i = 0, e = liveness_.GetNumberOfSsaValues(); i < e; ++i) {
+    LiveInterval* interval = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    if (!interval->HasSpillSlot() || interval->HasHighInterval() || interval->IsHighInterval()) {
+      continue;
+    }
+    for (LiveInterval* sibling = interval->GetNextSibling();
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister() || sibling->GetNextSibling() == nullptr) {
+        continue;
+      }
+      HBasicBlock* header = liveness_.GetBlockFromPosition(sibling->GetStart() / 2);
+      if (header == nullptr ||
+          !header->IsLoopHeader() ||
+          header->GetLoopInformation()->IsIrreducible() ||
+          header->GetLifetimeStart() != sibling->GetStart()) {
+        continue;
+      }
+      size_t loop_end = header->GetLoopInformation()->GetLifetimeEnd();
+      if (sibling->GetEnd() > loop_end || HasUseInRange(sibling)) {
+        continue;
+      }
+      bool spilled_in_loop = true;
+      for (LiveInterval* next = sibling->GetNextSibling();
+           next != nullptr && next->GetStart() < loop_end;
+           next = next->GetNextSibling()) {
+        if (next->HasRegister()) {
+          spilled_in_loop = false;
+          break;
+        }
+      }
+      if (spilled_in_loop) {
+        sibling->ClearRegister();
+      }
+    }
+  }
+}
+
 void RegisterAllocatorLinearScan::ProcessInstruction(HInstruction* instruction) {
   LocationSummary* locations = instruction->GetLocations();
 
@@ -90,6 +90,10 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
 
   // Helper methods.
   void AllocateRegistersInternal();
+  // Moves to the stack the split siblings which enter a loop in a register, have no use in the
+  // loop, and get spilled later in the loop. This removes the reload on the back edges of the
+  // loop: the value is reloaded at the exits of the loop instead.
+  void SpillUnusedLoopHeaderSiblings();
   void ProcessInstruction(HInstruction* instruction);
   bool ValidateInternal(bool log_fatal_on_failure) const;
   void DumpInterval(std::ostream& stream, LiveInterval* interval) const;
@@ -195,6 +199,7 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
 
   ART_FRIEND_TEST(RegisterAllocatorTest, FreeUntil);
   ART_FRIEND_TEST(RegisterAllocatorTest, SpillInactive);
+  ART_FRIEND_TEST(RegisterAllocatorTest, SpillUnusedLoopHeaderSiblings);
 
   DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorLinearScan);
 };
@@ -486,6 +486,76 @@ TEST_F(RegisterAllocatorTest, FreeUntil) {
   ASSERT_EQ(20u, register_allocator.unhandled_->front()->GetStart());
 }
 
+// Test that a value evicted in the middle of a loop is kept on the stack for the whole loop
+// when it has no use there. This test only applies to the linear scan allocator.
+TEST_F(RegisterAllocatorTest, SpillUnusedLoopHeaderSiblings) {
+  // Same code as in `Loop2`: `6 + 7` after the loop uses constants live through the loop.
+  const std::vector<uint16_t> data = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::CONST_4 | 8 << 12 | 1 << 8,
+    Instruction::IF_EQ | 1 << 8, 7,
+    Instruction::CONST_4 | 4 << 12 | 0 << 8,
+    Instruction::CONST_4 | 5 << 12 | 1 << 8,
+    Instruction::ADD_INT, 1 << 8 | 0,
+    Instruction::GOTO | 0xFA00,
+    Instruction::CONST_4 | 6 << 12 | 1 << 8,
+    Instruction::CONST_4 | 7 << 12 | 1 << 8,
+    Instruction::ADD_INT, 1 << 8 | 0,
+    Instruction::RETURN | 1 << 8);
+
+  HGraph* graph = CreateCFG(data);
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  liveness.Analyze();
+  RegisterAllocatorLinearScan register_allocator(GetScopedAllocator(), &codegen, liveness);
+
+  HBasicBlock* loop_header = nullptr;
+  for (HBasicBlock* block : graph->GetBlocks()) {
+    if (block != nullptr && block->IsLoopHeader()) {
+      loop_header = block;
+    }
+  }
+  ASSERT_TRUE(loop_header != nullptr);
+  size_t loop_start = loop_header->GetLifetimeStart();
+  size_t loop_end = loop_header->GetLoopInformation()->GetLifetimeEnd();
+
+  // Find a value defined before the loop and only used after it.
+  LiveInterval* interval = nullptr;
+  for (size_t i = 0, e = liveness.GetNumberOfSsaValues(); i != e; ++i) {
+    LiveInterval* current = liveness.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    if (current->GetStart() < loop_start &&
+        current->GetEnd() > loop_end &&
+        current->FirstUseAfter(loop_start) > loop_end) {
+      interval = current;
+      break;
+    }
+  }
+  ASSERT_TRUE(interval != nullptr);
+
+  // Mimic the eviction of the value in the loop: it enters the loop in a register, is spilled
+  // in the loop, and goes back to a register after the loop.
+  interval->SetSpillSlot(0);
+  interval->SetRegister(0);
+  LiveInterval* header_sibling = interval->SplitAt(loop_start);
+  header_sibling->SetRegister(1);
+  LiveInterval* spilled_sibling = header_sibling->SplitAt(loop_start + 2);
+  LiveInterval* exit_sibling = spilled_sibling->SplitAt(loop_end);
+  exit_sibling->SetRegister(2);
+
+  // While the value goes back to a register in the loop, keep the header sibling as is.
+  spilled_sibling->SetRegister(3);
+  register_allocator.SpillUnusedLoopHeaderSiblings();
+  ASSERT_TRUE(header_sibling->HasRegister());
+
+  // Otherwise, it is spilled for the whole loop and reloaded at the exit only.
+  spilled_sibling->ClearRegister();
+  register_allocator.SpillUnusedLoopHeaderSiblings();
+  ASSERT_FALSE(header_sibling->HasRegister());
+  ASSERT_FALSE(spilled_sibling->HasRegister());
+  ASSERT_TRUE(interval->HasRegister());
+  ASSERT_TRUE(exit_sibling->HasRegister());
+}
+
 HGraph* RegisterAllocatorTest::BuildIfElseWithPhi(HPhi** phi,
                                                   HInstruction** input1,
                                                   HInstruction** input2) {
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_riscv64.h"
+
+#include "code_generator.h"
+#include "driver/compiler_options.h"
+#include "mirror/array-inl.h"
+#include "mirror/string.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+// Conservative latencies for an unknown in-order core. The values favour spacing loads and
+// multiplications from their uses, which is cheap on wide cores and significant on narrow ones.
+static constexpr Riscv64SchedulingLatencies kGenericLatencies = {
+    /* integer_op= */ 1,
+    /* branch= */ 1,
+    /* memory_load= */ 3,
+    /* memory_store= */ 1,
+    /* mul_integer= */ 3,
+    /* div_integer= */ 20,
+    /* floating_point_op= */ 4,
+    /* mul_floating_point= */ 5,
+    /* div_float= */ 20,
+    /* div_double= */ 30,
+    /* type_conversion_floating_point_integer= */ 4,
+    /* call_internal= */ 10,
+    /* call= */ 5,
+    /* simd_integer_op= */ 2,
+    /* simd_floating_point_op= */ 4,
+    /* simd_mul_integer= */ 4,
+    /* simd_mul_floating_point= */ 5,
+    /* simd_div_float= */ 20,
+    /* simd_div_double= */ 30,
+    /* simd_memory_load= */ 4,
+    /* simd_memory_store= */ 1,
+    /* simd_scalar_move= */ 3,
+};
+
+// SiFive U74: dual-issue in-order, 3-cycle load-to-use, 3-cycle multiplier, iterative divider
+// and a 5-cycle FPU pipeline. The core has no vector unit, so the SIMD entries are unused.
+static constexpr Riscv64SchedulingLatencies kSiFiveU74Latencies = {
+    /* integer_op= */ 1,
+    /* branch= */ 1,
+    /* memory_load= */ 3,
+    /* memory_store= */ 1,
+    /* mul_integer= */ 3,
+    /* div_integer= */ 36,
+    /* floating_point_op= */ 5,
+    /* mul_floating_point= */ 5,
+    /* div_float= */ 27,
+    /* div_double= */ 48,
+    /* type_conversion_floating_point_integer= */ 4,
+    /* call_internal= */ 10,
+    /* call= */ 5,
+    /* simd_integer_op= */ 2,
+    /* simd_floating_point_op= */ 4,
+    /* simd_mul_integer= */ 4,
+    /* simd_mul_floating_point= */ 5,
+    /* simd_div_float= */ 20,
+    /* simd_div_double= */ 30,
+    /* simd_memory_load= */ 4,
+    /* simd_memory_store= */ 1,
+    /* simd_scalar_move= */ 3,
+};
+
+// SpacemiT X60: dual-issue in-order with a 256-bit vector unit. Vector instructions have a
+// longer pipeline than their scalar counterparts and moves between register files are slow.
+static constexpr Riscv64SchedulingLatencies kSpacemitX60Latencies = {
+    /* integer_op= */ 1,
+    /* branch= */ 1,
+    /* memory_load= */ 3,
+    /* memory_store= */ 1,
+    /* mul_integer= */ 3,
+    /* div_integer= */ 20,
+    /* floating_point_op= */ 4,
+    /* mul_floating_point= */ 4,
+    /* div_float= */ 15,
+    /* div_double= */ 22,
+    /* type_conversion_floating_point_integer= */ 4,
+    /* call_internal= */ 10,
+    /* call= */ 5,
+    /* simd_integer_op= */ 3,
+    /* simd_floating_point_op= */ 5,
+    /* simd_mul_integer= */ 5,
+    /* simd_mul_floating_point= */ 5,
+    /* simd_div_float= */ 30,
+    /* simd_div_double= */ 45,
+    /* simd_memory_load= */ 6,
+    /* simd_memory_store= */ 2,
+    /* simd_scalar_move= */ 5,
+};
+
+const Riscv64SchedulingLatencies& Riscv64SchedulingLatencies::ForCore(
+    Riscv64InstructionSetFeatures::Core core) {
+  switch (core) {
+    case Riscv64InstructionSetFeatures::Core::kGeneric:
+      return kGenericLatencies;
+    case Riscv64InstructionSetFeatures::Core::kSiFiveU74:
+      return kSiFiveU74Latencies;
+    case Riscv64InstructionSetFeatures::Core::kSpacemitX60:
+      return kSpacemitX60Latencies;
+  }
+  LOG(FATAL) << "Unexpected core " << static_cast<int>(core);
+  UNREACHABLE();
+}
+
+const Riscv64SchedulingLatencies& Riscv64SchedulingLatencies::ForCodeGenerator(
+    const CodeGenerator* codegen) {
+  if (codegen == nullptr) {
+    return kGenericLatencies;
+  }
+  const InstructionSetFeatures* features =
+      codegen->GetCompilerOptions().GetInstructionSetFeatures();
+  return ForCore(features->AsRiscv64InstructionSetFeatures()->GetCore());
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitBinaryOperation(HBinaryOperation* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? latencies_.floating_point_op
+      : latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitBitwiseNegatedRight(
+    HBitwiseNegatedRight* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitIntermediateAddress(
+    HIntermediateAddress* ATTRIBUTE_UNUSED) {
+  // As on arm64, space the `add` from its use in memory accesses.
+  last_visited_latency_ = latencies_.integer_op + 2;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitRiscv64ShiftAdd(HRiscv64ShiftAdd* ATTRIBUTE_UNUSED) {
+  // A single `shNadd` with Zba, otherwise a shift followed by an add.
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArrayGet(HArrayGet* instruction) {
+  if (!instruction->GetIndex()->IsConstant()) {
+    // Take the `shNadd` address computation into account.
+    last_visited_internal_latency_ = latencies_.integer_op;
+  }
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArrayLength(HArrayLength* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArraySet(HArraySet* instruction) {
+  if (!instruction->GetIndex()->IsConstant()) {
+    last_visited_internal_latency_ = latencies_.integer_op;
+  }
+  last_visited_latency_ = latencies_.memory_store;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitBoundsCheck(HBoundsCheck* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.integer_op;
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitDiv(HDiv* instr) {
+  // The code generator emits `div`/`divw` also for constant divisors.
+  switch (instr->GetResultType()) {
+    case DataType::Type::kFloat32:
+      last_visited_latency_ = latencies_.div_float;
+      break;
+    case DataType::Type::kFloat64:
+      last_visited_latency_ = latencies_.div_double;
+      break;
+    default:
+      last_visited_latency_ = latencies_.div_integer;
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInstanceFieldGet(HInstanceFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInstanceOf(HInstanceOf* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInvoke(HInvoke* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitLoadString(HLoadString* instruction) {
+  if (instruction->GetLoadKind() == HLoadString::LoadKind::kRuntimeCall) {
+    last_visited_internal_latency_ = latencies_.call_internal;
+    last_visited_latency_ = latencies_.call;
+  } else {
+    // An `auipc`/`lui` pair followed by the load of the reference.
+    last_visited_internal_latency_ = 2 * latencies_.integer_op;
+    last_visited_latency_ = latencies_.memory_load;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitMul(HMul* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? latencies_.mul_floating_point
+      : latencies_.mul_integer;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitNewArray(HNewArray* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.integer_op + latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitNewInstance(HNewInstance* instruction) {
+  if (instruction->IsStringAlloc()) {
+    last_visited_internal_latency_ = 2 + latencies_.memory_load + latencies_.call_internal;
+  } else {
+    last_visited_internal_latency_ = latencies_.call_internal;
+  }
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitRem(HRem* instruction) {
+  if (DataType::IsFloatingPointType(instruction->GetResultType())) {
+    // Calls `fmod()`/`fmodf()`.
+    last_visited_internal_latency_ = latencies_.call_internal;
+    last_visited_latency_ = latencies_.call;
+  } else {
+    // The code generator emits `rem`/`remw`, which use the same unit as `div`.
+    last_visited_latency_ = latencies_.div_integer;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitStaticFieldGet(HStaticFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitSuspendCheck(HSuspendCheck* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  DCHECK_IMPLIES(block->GetLoopInformation() == nullptr,
+                 block->IsEntryBlock() && instruction->GetNext()->IsGoto());
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitTypeConversion(HTypeConversion* instr) {
+  if (DataType::IsFloatingPointType(instr->GetResultType()) ||
+      DataType::IsFloatingPointType(instr->GetInputType())) {
+    last_visited_latency_ = latencies_.type_conversion_floating_point_integer;
+  } else {
+    last_visited_latency_ = latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::HandleSimpleArithmeticSIMD(HVecOperation* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_floating_point_op;
+  } else {
+    last_visited_latency_ = latencies_.simd_integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecReplicateScalar(
+    HVecReplicateScalar* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_scalar_move;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecExtractScalar(
+    HVecExtractScalar* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_scalar_move;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecReduce(HVecReduce* instr) {
+  // A reduction followed by the move of element 0 to a scalar register.
+  last_visited_internal_latency_ = DataType::IsFloatingPointType(instr->GetPackedType())
+      ? latencies_.simd_floating_point_op
+      : latencies_.simd_integer_op;
+  last_visited_latency_ = latencies_.simd_scalar_move;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecCnv(HVecCnv* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_floating_point_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecNeg(HVecNeg* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecAbs(HVecAbs* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecNot(HVecNot* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecAdd(HVecAdd* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecSub(HVecSub* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMul(HVecMul* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_mul_floating_point;
+  } else {
+    last_visited_latency_ = latencies_.simd_mul_integer;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecDiv(HVecDiv* instr) {
+  if (instr->GetPackedType() == DataType::Type::kFloat32) {
+    last_visited_latency_ = latencies_.simd_div_float;
+  } else {
+    DCHECK(instr->GetPackedType() == DataType::Type::kFloat64);
+    last_visited_latency_ = latencies_.simd_div_double;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMin(HVecMin* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMax(HVecMax* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecAnd(HVecAnd* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecAndNot(HVecAndNot* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecOr(HVecOr* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecXor(HVecXor* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecShl(HVecShl* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecShr(HVecShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecUShr(HVecUShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecSetScalars(HVecSetScalars* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_scalar_move;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMultiplyAccumulate(
+    HVecMultiplyAccumulate* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_mul_integer;
+}
+
+void SchedulingLatencyVisitorRISCV64::HandleVecAddress(HVecMemoryOperation* instruction) {
+  HInstruction* index = instruction->InputAt(1);
+  if (!index->IsConstant()) {
+    last_visited_internal_latency_ += latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecLoad(HVecLoad* instr) {
+  last_visited_internal_latency_ = 0;
+  if (instr->GetPackedType() == DataType::Type::kUint16
+      && mirror::kUseStringCompression
+      && instr->IsStringCharAt()) {
+    // Set latencies for the uncompressed case.
+    last_visited_internal_latency_ += latencies_.memory_load + latencies_.branch;
+  }
+  HandleVecAddress(instr);
+  last_visited_latency_ = latencies_.simd_memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecStore(HVecStore* instr) {
+  last_visited_internal_latency_ = 0;
+  HandleVecAddress(instr);
+  last_visited_latency_ = latencies_.simd_memory_store;
+}
+
+}  // namespace riscv64
+}  // namespace art
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SCHEDULER_RISCV64_H_
+#define ART_COMPILER_OPTIMIZING_SCHEDULER_RISCV64_H_
+
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "base/macros.h"
+#include "scheduler.h"
+
+namespace art HIDDEN {
+
+class CodeGenerator;
+
+namespace riscv64 {
+
+// Instruction latencies of a riscv64 core, in cycles. Unlike on arm64 where all cores share
+// the same list, riscv64 cores differ widely, so there is one table per known core, selected
+// from the `Riscv64InstructionSetFeatures::Core`. To model a new core, add an entry to that
+// enum and a table in `scheduler_riscv64.cc`.
+struct Riscv64SchedulingLatencies {
+  uint32_t integer_op;
+  uint32_t branch;
+  uint32_t memory_load;
+  uint32_t memory_store;
+  uint32_t mul_integer;
+  uint32_t div_integer;
+  uint32_t floating_point_op;
+  uint32_t mul_floating_point;
+  uint32_t div_float;
+  uint32_t div_double;
+  // Conversions between integer and floating-point values, including register moves.
+  uint32_t type_conversion_floating_point_integer;
+  uint32_t call_internal;
+  uint32_t call;
+  uint32_t simd_integer_op;
+  uint32_t simd_floating_point_op;
+  uint32_t simd_mul_integer;
+  uint32_t simd_mul_floating_point;
+  uint32_t simd_div_float;
+  uint32_t simd_div_double;
+  uint32_t simd_memory_load;
+  uint32_t simd_memory_store;
+  // Moves between scalar and vector registers.
+  uint32_t simd_scalar_move;
+
+  // Return the latencies for `core`.
+  static const Riscv64SchedulingLatencies& ForCore(Riscv64InstructionSetFeatures::Core core);
+
+  // Return the latencies for the core targeted by `codegen`, or the generic latencies if
+  // `codegen` is null.
+  static const Riscv64SchedulingLatencies& ForCodeGenerator(const CodeGenerator* codegen);
+};
+
+class SchedulingLatencyVisitorRISCV64 final : public SchedulingLatencyVisitor {
+ public:
+  explicit SchedulingLatencyVisitorRISCV64(const Riscv64SchedulingLatencies& latencies)
+      : latencies_(latencies) {}
+
+  // Default visitor for instructions not handled specifically below.
+  void VisitInstruction(HInstruction* ATTRIBUTE_UNUSED) override {
+    last_visited_latency_ = latencies_.integer_op;
+  }
+
+// We add a second unused parameter to be able to use this macro like the others
+// defined in `nodes.h`.
+#define FOR_EACH_SCHEDULED_COMMON_INSTRUCTION_RISCV64(M) \
+  M(ArrayGet             , unused)                       \
+  M(ArrayLength          , unused)                       \
+  M(ArraySet             , unused)                       \
+  M(BoundsCheck          , unused)                       \
+  M(Div                  , unused)                       \
+  M(InstanceFieldGet     , unused)                       \
+  M(InstanceOf           , unused)                       \
+  M(LoadString           , unused)                       \
+  M(Mul                  , unused)                       \
+  M(NewArray             , unused)                       \
+  M(NewInstance          , unused)                       \
+  M(Rem                  , unused)                       \
+  M(StaticFieldGet       , unused)                       \
+  M(SuspendCheck         , unused)                       \
+  M(TypeConversion       , unused)                       \
+  M(VecReplicateScalar   , unused)                       \
+  M(VecExtractScalar     , unused)                       \
+  M(VecReduce            , unused)                       \
+  M(VecCnv               , unused)                       \
+  M(VecNeg               , unused)                       \
+  M(VecAbs               , unused)                       \
+  M(VecNot               , unused)                       \
+  M(VecAdd               , unused)                       \
+  M(VecHalvingAdd        , unused)                       \
+  M(VecSub               , unused)                       \
+  M(VecMul               , unused)                       \
+  M(VecDiv               , unused)                       \
+  M(VecMin               , unused)                       \
+  M(VecMax               , unused)                       \
+  M(VecAnd               , unused)                       \
+  M(VecAndNot            , unused)                       \
+  M(VecOr                , unused)                       \
+  M(VecXor               , unused)                       \
+  M(VecShl               , unused)                       \
+  M(VecShr               , unused)                       \
+  M(VecUShr              , unused)                       \
+  M(VecSetScalars        , unused)                       \
+  M(VecMultiplyAccumulate, unused)                       \
+  M(VecLoad              , unused)                       \
+  M(VecStore             , unused)
+
+#define FOR_EACH_SCHEDULED_ABSTRACT_INSTRUCTION_RISCV64(M) \
+  M(BinaryOperation      , unused)                         \
+  M(Invoke               , unused)
+
+#define FOR_EACH_SCHEDULED_SHARED_INSTRUCTION_RISCV64(M) \
+  M(BitwiseNegatedRight, unused)                         \
+  M(IntermediateAddress, unused)
+
+#define DECLARE_VISIT_INSTRUCTION(type, unused)  \
+  void Visit##type(H##type* instruction) override;
+
+  FOR_EACH_SCHEDULED_COMMON_INSTRUCTION_RISCV64(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_SCHEDULED_ABSTRACT_INSTRUCTION_RISCV64(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_SCHEDULED_SHARED_INSTRUCTION_RISCV64(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+ private:
+  void HandleSimpleArithmeticSIMD(HVecOperation* instruction);
+  void HandleVecAddress(HVecMemoryOperation* instruction);
+
+  const Riscv64SchedulingLatencies& latencies_;
+};
+
+class HSchedulerRISCV64 : public HScheduler {
+ public:
+  HSchedulerRISCV64(SchedulingNodeSelector* selector, const Riscv64SchedulingLatencies& latencies)
+      : HScheduler(&riscv64_latency_visitor_, selector),
+        riscv64_latency_visitor_(latencies) {}
+  ~HSchedulerRISCV64() override {}
+
+  bool IsSchedulable(const HInstruction* instruction) const override {
+#define CASE_INSTRUCTION_KIND(type, unused) case \
+  HInstruction::InstructionKind::k##type:
+    switch (instruction->GetKind()) {
+      FOR_EACH_SCHEDULED_SHARED_INSTRUCTION_RISCV64(CASE_INSTRUCTION_KIND)
+        return true;
+      FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(CASE_INSTRUCTION_KIND)
+        return true;
+      FOR_EACH_SCHEDULED_COMMON_INSTRUCTION_RISCV64(CASE_INSTRUCTION_KIND)
+        return true;
+      default:
+        return HScheduler::IsSchedulable(instruction);
+    }
+#undef CASE_INSTRUCTION_KIND
+  }
+
+  // As on arm64, treat as scheduling barriers the vector instructions whose live ranges
+  // exceed the vectorized loop boundaries, as the compiler has no notion of SIMD registers
+  // that would let it save and restore them correctly around reordered calls.
+  bool IsSchedulingBarrier(const HInstruction* instr) const override {
+    return HScheduler::IsSchedulingBarrier(instr) ||
+           instr->IsVecReduce() ||
+           instr->IsVecExtractScalar() ||
+           instr->IsVecSetScalars() ||
+           instr->IsVecReplicateScalar();
+  }
+
+ private:
+  SchedulingLatencyVisitorRISCV64 riscv64_latency_visitor_;
+  DISALLOW_COPY_AND_ASSIGN(HSchedulerRISCV64);
+};
+
+}  // namespace riscv64
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SCHEDULER_RISCV64_H_
@@ -35,6 +35,10 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+#include "scheduler_riscv64.h"
+#endif
+
 namespace art HIDDEN {
 
 // Return all combinations of ISA and code generator that are executable on
@@ -420,6 +424,25 @@ TEST_F(SchedulerTest, ArrayAccessAliasingARM) {
 }
 #endif
 
+#if defined(ART_ENABLE_CODEGEN_riscv64)
+TEST_F(SchedulerTest, DependencyGraphAndSchedulerRISCV64) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  riscv64::HSchedulerRISCV64 scheduler(
+      &critical_path_selector,
+      riscv64::Riscv64SchedulingLatencies::ForCore(Riscv64InstructionSetFeatures::Core::kGeneric));
+  TestBuildDependencyGraphAndSchedule(&scheduler);
+}
+
+TEST_F(SchedulerTest, ArrayAccessAliasingRISCV64) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  riscv64::HSchedulerRISCV64 scheduler(
+      &critical_path_selector,
+      riscv64::Riscv64SchedulingLatencies::ForCore(
+          Riscv64InstructionSetFeatures::Core::kSpacemitX60));
+  TestDependencyGraphOnAliasingArrayAccesses(&scheduler);
+}
+#endif
+
 TEST_F(SchedulerTest, RandomScheduling) {
   //
   // Java source: crafted code to make sure (random) scheduling should get correct result.
@@ -0,0 +1,431 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "slp_vectorizer.h"
+
+#include <algorithm>
+
+#include "arch/instruction_set.h"
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "arch/x86/instruction_set_features_x86.h"
+#include "base/arena_bit_vector.h"
+#include "base/scoped_arena_allocator.h"
+#include "code_generator.h"
+#include "driver/compiler_options.h"
+#include "nodes_vector.h"
+
+namespace art HIDDEN {
+
+// Decomposes an array index into `base + offset`, `base` being null for a constant index.
+static HInstruction* DecomposeIndex(HInstruction* index, int64_t* offset) {
+  if (index->IsIntConstant()) {
+    *offset = index->AsIntConstant()->GetValue();
+    return nullptr;
+  }
+  HAdd* add = index->AsAdd();
+  if (add != nullptr && add->GetRight()->IsIntConstant()) {
+    *offset = add->GetRight()->AsIntConstant()->GetValue();
+    return add->GetLeft();
+  }
+  *offset = 0;
+  return index;
+}
+
+// Returns whether `indices[k]` is `indices[0] + k` for all lanes.
+static bool AreConsecutive(const ScopedArenaVector<HInstruction*>& indices) {
+  int64_t first_offset;
+  HInstruction* first_base = DecomposeIndex(indices[0], &first_offset);
+  for (size_t lane = 1; lane < indices.size(); ++lane) {
+    int64_t offset;
+    HInstruction* base = DecomposeIndex(indices[lane], &offset);
+    if (base != first_base || offset != first_offset + static_cast<int64_t>(lane)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool IsSupportedBinaryOperation(HInstruction* instruction, DataType::Type type) {
+  switch (instruction->GetKind()) {
+    case HInstruction::kAdd:
+    case HInstruction::kSub:
+      return true;
+    case HInstruction::kMul:
+      // None of the vector instruction sets has a 64-bit integer multiplication.
+      return type != DataType::Type::kInt64;
+    case HInstruction::kAnd:
+    case HInstruction::kOr:
+    case HInstruction::kXor:
+      return DataType::IsIntegralType(type);
+    default:
+      return false;
+  }
+}
+
+// Returns whether `store` is a store of a primitive value not covered by a bounds check.
+static bool IsCandidateStore(HInstruction* instruction) {
+  HArraySet* store = instruction->AsArraySet();
+  return store != nullptr &&
+         store->GetComponentType() == store->GetValue()->GetType() &&
+         !store->GetIndex()->IsBoundsCheck() &&
+         !store->NeedsEnvironment();
+}
+
+HSlpVectorizer::HSlpVectorizer(HGraph* graph,
+                               const CodeGenerator& codegen,
+                               OptimizingCompilerStats* stats,
+                               const char* name)
+    : HOptimization(graph, name, stats),
+      codegen_(codegen),
+      allocator_(nullptr),
+      positions_(nullptr),
+      vector_length_(0u) {}
+
+size_t HSlpVectorizer::GetVectorLength(DataType::Type type) const {
+  switch (type) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      break;
+    default:
+      return 0u;
+  }
+  // The 128-bit vector length of all the instruction sets but ARM.
+  const size_t vector_length = 16u / DataType::Size(type);
+  const CompilerOptions& compiler_options = codegen_.GetCompilerOptions();
+  const InstructionSetFeatures* features = compiler_options.GetInstructionSetFeatures();
+  switch (compiler_options.GetInstructionSet()) {
+    case InstructionSet::kArm:
+    case InstructionSet::kThumb2:
+      // ARM 32-bit advanced SIMD (64-bit SIMD) only supports integers.
+      return type == DataType::Type::kInt32 ? 2u : 0u;
+    case InstructionSet::kArm64:
+      // Outside of loops there is no governing predicate for SVE operations.
+      return codegen_.SupportsPredicatedSIMD() ? 0u : vector_length;
+    case InstructionSet::kRiscv64:
+      return features->AsRiscv64InstructionSetFeatures()->HasVector() ? vector_length : 0u;
+    case InstructionSet::kX86:
+    case InstructionSet::kX86_64:
+      return features->AsX86InstructionSetFeatures()->HasSSE4_1() ? vector_length : 0u;
+    default:
+      return 0u;
+  }
+}
+
+bool HSlpVectorizer::Run() {
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<size_t> positions(allocator.Adapter(kArenaAllocLoopOptimization));
+  allocator_ = &allocator;
+  positions_ = &positions;
+
+  bool did_vectorize = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    did_vectorize |= TryVectorizeBlock(block);
+  }
+
+  allocator_ = nullptr;
+  positions_ = nullptr;
+  if (did_vectorize) {
+    graph_->SetHasSIMD(true);
+  }
+  return did_vectorize;
+}
+
+void HSlpVectorizer::ComputePositions(HBasicBlock* block) {
+  positions_->resize(graph_->GetCurrentInstructionId());
+  size_t position = 0u;
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    (*positions_)[it.Current()->GetId()] = position++;
+  }
+}
+
+bool HSlpVectorizer::TryVectorizeBlock(HBasicBlock* block) {
+  ScopedArenaVector<HArraySet*> candidates(allocator_->Adapter(kArenaAllocLoopOptimization));
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    if (IsCandidateStore(it.Current()) &&
+        GetVectorLength(it.Current()->AsArraySet()->GetComponentType()) != 0u) {
+      candidates.push_back(it.Current()->AsArraySet());
+    }
+  }
+  if (candidates.size() < 2u) {
+    return false;
+  }
+
+  bool did_vectorize = false;
+  ScopedArenaVector<HArraySet*> group(allocator_->Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<size_t> group_indices(allocator_->Adapter(kArenaAllocLoopOptimization));
+  ArenaBitVector vectorized(
+      allocator_, candidates.size(), /* expandable= */ false, kArenaAllocLoopOptimization);
+  ComputePositions(block);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (vectorized.IsBitSet(i)) {
+      continue;
+    }
+    // Try to form a group of stores to consecutive elements, starting at `candidates[i]`.
+    HArraySet* first = candidates[i];
+    DataType::Type type = first->GetComponentType();
+    size_t vector_length = GetVectorLength(type);
+    int64_t first_offset;
+    HInstruction* first_base = DecomposeIndex(first->GetIndex(), &first_offset);
+    group.clear();
+    group_indices.clear();
+    group.push_back(first);
+    group_indices.push_back(i);
+    for (size_t lane = 1; lane < vector_length; ++lane) {
+      size_t j = 0u;
+      for (; j < candidates.size(); ++j) {
+        HArraySet* store = candidates[j];
+        int64_t offset;
+        if (!vectorized.IsBitSet(j) &&
+            store->GetArray() == first->GetArray() &&
+            store->GetComponentType() == type &&
+            DecomposeIndex(store->GetIndex(), &offset) == first_base &&
+            offset == first_offset + static_cast<int64_t>(lane)) {
+          break;
+        }
+      }
+      if (j == candidates.size()) {
+        break;
+      }
+      group.push_back(candidates[j]);
+      group_indices.push_back(j);
+    }
+    if (group.size() != vector_length) {
+      continue;
+    }
+    vector_length_ = vector_length;
+    if (TryVectorizeStores(block, group)) {
+      for (size_t index : group_indices) {
+        vectorized.SetBit(index);
+      }
+      did_vectorize = true;
+      MaybeRecordStat(stats_, MethodCompilationStat::kSlpVectorized);
+      ComputePositions(block);
+    }
+  }
+  return did_vectorize;
+}
+
+bool HSlpVectorizer::TryVectorizeStores(HBasicBlock* block,
+                                        const ScopedArenaVector<HArraySet*>& stores) {
+  DataType::Type type = stores[0]->GetComponentType();
+  ScopedArenaVector<HInstruction*> members(allocator_->Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<HInstruction*> values(allocator_->Adapter(kArenaAllocLoopOptimization));
+  for (HArraySet* store : stores) {
+    members.push_back(store);
+    values.push_back(store->GetValue());
+  }
+  if (!CanPack(values, type, block, /* depth= */ 0u, &members)) {
+    return false;
+  }
+
+  // The vector operations replace the last store, so that the stored values are available.
+  HArraySet* last_store = *std::max_element(
+      stores.begin(), stores.end(), [&](HArraySet* lhs, HArraySet* rhs) {
+        return (*positions_)[lhs->GetId()] < (*positions_)[rhs->GetId()];
+      });
+  if (!CanMoveTo(members, last_store)) {
+    return false;
+  }
+
+  HInstruction* vector_value = GeneratePack(values, type, last_store);
+  HVecStore* vector_store = new (graph_->GetAllocator()) HVecStore(graph_->GetAllocator(),
+                                                                   stores[0]->GetArray(),
+                                                                   stores[0]->GetIndex(),
+                                                                   vector_value,
+                                                                   type,
+                                                                   stores[0]->GetSideEffects(),
+                                                                   vector_length_,
+                                                                   last_store->GetDexPc());
+  block->InsertInstructionBefore(vector_store, last_store);
+  for (HArraySet* store : stores) {
+    block->RemoveInstruction(store);
+  }
+
+  // Remove the scalar instructions that are not used anymore, users first.
+  std::sort(members.begin(), members.end(), [&](HInstruction* lhs, HInstruction* rhs) {
+    return (*positions_)[lhs->GetId()] > (*positions_)[rhs->GetId()];
+  });
+  members.erase(std::unique(members.begin(), members.end()), members.end());
+  for (HInstruction* member : members) {
+    if (member->GetBlock() != nullptr && member->IsDeadAndRemovable()) {
+      block->RemoveInstruction(member);
+    }
+  }
+  return true;
+}
+
+bool HSlpVectorizer::CanPack(const ScopedArenaVector<HInstruction*>& lanes,
+                             DataType::Type type,
+                             HBasicBlock* block,
+                             size_t depth,
+                             ScopedArenaVector<HInstruction*>* members) {
+  HInstruction* first = lanes[0];
+  if (depth > kMaxPackDepth ||
+      std::any_of(lanes.begin(), lanes.end(), [&](HInstruction* lane) {
+        return lane->GetType() != type;
+      })) {
+    return false;
+  }
+
+  if (std::all_of(lanes.begin(), lanes.end(), [&](HInstruction* lane) { return lane == first; })) {
+    // The same scalar in all lanes is replicated, it stays in place.
+    return true;
+  }
+
+  if (first->IsArrayGet()) {
+    ScopedArenaVector<HInstruction*> indices(allocator_->Adapter(kArenaAllocLoopOptimization));
+    for (HInstruction* lane : lanes) {
+      HArrayGet* load = lane->AsArrayGet();
+      if (load == nullptr ||
+          load->GetBlock() != block ||
+          load->IsStringCharAt() ||
+          load->GetArray() != first->AsArrayGet()->GetArray() ||
+          load->GetIndex()->IsBoundsCheck()) {
+        return false;
+      }
+      indices.push_back(load->GetIndex());
+    }
+    if (!AreConsecutive(indices)) {
+      return false;
+    }
+    members->insert(members->end(), lanes.begin(), lanes.end());
+    return true;
+  }
+
+  if (IsSupportedBinaryOperation(first, type)) {
+    ScopedArenaVector<HInstruction*> lefts(allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaVector<HInstruction*> rights(allocator_->Adapter(kArenaAllocLoopOptimization));
+    for (HInstruction* lane : lanes) {
+      if (lane->GetKind() != first->GetKind() || lane->GetBlock() != block) {
+        return false;
+      }
+      lefts.push_back(lane->InputAt(0));
+      rights.push_back(lane->InputAt(1));
+    }
+    members->insert(members->end(), lanes.begin(), lanes.end());
+    return CanPack(lefts, type, block, depth + 1u, members) &&
+           CanPack(rights, type, block, depth + 1u, members);
+  }
+
+  return false;
+}
+
+bool HSlpVectorizer::CanMoveTo(const ScopedArenaVector<HInstruction*>& members,
+                               HInstruction* last_store) {
+  ScopedArenaVector<HInstruction*> sorted_members(members.begin(),
+                                                  members.end(),
+                                                  allocator_->Adapter(kArenaAllocLoopOptimization));
+  std::sort(sorted_members.begin(), sorted_members.end());
+
+  size_t first_position = (*positions_)[members[0]->GetId()];
+  size_t first_store_position = first_position;
+  for (HInstruction* member : members) {
+    size_t position = (*positions_)[member->GetId()];
+    first_position = std::min(first_position, position);
+    if (member->IsArraySet()) {
+      first_store_position = std::min(first_store_position, position);
+    }
+  }
+
+  for (HInstruction* member : members) {
+    // Loads move after the stores: they must not have read memory written by one of them.
+    if (member->IsArrayGet() && (*positions_)[member->GetId()] > first_store_position) {
+      return false;
+    }
+  }
+
+  // Writes between the members could change the memory read by the loads moved down, or be
+  // overwritten by the delayed stores. After the first store, reads could observe the memory
+  // before the delayed stores, and instructions that may deoptimize or throw could resume
+  // execution without them.
+  HInstruction* instruction = last_store;
+  while ((*positions_)[instruction->GetId()] > first_position) {
+    instruction = instruction->GetPrevious();
+    if (std::binary_search(sorted_members.begin(), sorted_members.end(), instruction)) {
+      continue;
+    }
+    if (instruction->GetSideEffects().DoesAnyWrite()) {
+      return false;
+    }
+    if ((*positions_)[instruction->GetId()] > first_store_position &&
+        (instruction->GetSideEffects().DoesAnyRead() ||
+         instruction->NeedsEnvironment() ||
+         instruction->CanThrow())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HInstruction* HSlpVectorizer::GeneratePack(const ScopedArenaVector<HInstruction*>& lanes,
+                                           DataType::Type type,
+                                           HInstruction* cursor) {
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HInstruction* first = lanes[0];
+  uint32_t dex_pc = first->GetDexPc();
+  HInstruction* vector = nullptr;
+  if (std::all_of(lanes.begin(), lanes.end(), [&](HInstruction* lane) { return lane == first; })) {
+    vector = new (allocator) HVecReplicateScalar(allocator, first, type, vector_length_, dex_pc);
+  } else if (first->IsArrayGet()) {
+    HArrayGet* load = first->AsArrayGet();
+    vector = new (allocator) HVecLoad(allocator,
+                                      load->GetArray(),
+                                      load->GetIndex(),
+                                      type,
+                                      load->GetSideEffects(),
+                                      vector_length_,
+                                      /* is_string_char_at= */ false,
+                                      dex_pc);
+  } else {
+    ScopedArenaVector<HInstruction*> lefts(allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaVector<HInstruction*> rights(allocator_->Adapter(kArenaAllocLoopOptimization));
+    for (HInstruction* lane : lanes) {
+      lefts.push_back(lane->InputAt(0));
+      rights.push_back(lane->InputAt(1));
+    }
+    HInstruction* left = GeneratePack(lefts, type, cursor);
+    HInstruction* right = GeneratePack(rights, type, cursor);
+    switch (first->GetKind()) {
+      case HInstruction::kAdd:
+        vector = new (allocator) HVecAdd(allocator, left, right, type, vector_length_, dex_pc);
+        break;
+      case HInstruction::kSub:
+        vector = new (allocator) HVecSub(allocator, left, right, type, vector_length_, dex_pc);
+        break;
+      case HInstruction::kMul:
+        vector = new (allocator) HVecMul(allocator, left, right, type, vector_length_, dex_pc);
+        break;
+      case HInstruction::kAnd:
+        vector = new (allocator) HVecAnd(allocator, left, right, type, vector_length_, dex_pc);
+        break;
+      case HInstruction::kOr:
+        vector = new (allocator) HVecOr(allocator, left, right, type, vector_length_, dex_pc);
+        break;
+      case HInstruction::kXor:
+        vector = new (allocator) HVecXor(allocator, left, right, type, vector_length_, dex_pc);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected instruction " << first->DebugName();
+        UNREACHABLE();
+    }
+  }
+  cursor->GetBlock()->InsertInstructionBefore(vector, cursor);
+  return vector;
+}
+
+}  // namespace art
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SLP_VECTORIZER_H_
+#define ART_COMPILER_OPTIMIZING_SLP_VECTORIZER_H_
+
+#include "base/macros.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art HIDDEN {
+
+class CodeGenerator;
+
+/**
+ * Superword level parallelism vectorizer for straight-line code. Packs groups of stores to
+ * consecutive elements of an array, together with the isomorphic scalar expressions computing
+ * the stored values, into vector operations. For example:
+ *
+ *   c[i + 0] = a[i + 0] + b[i + 0];
+ *   c[i + 1] = a[i + 1] + b[i + 1];           VecStore(c, i, VecAdd(VecLoad(a, i), VecLoad(b, i)))
+ *   c[i + 2] = a[i + 2] + b[i + 2];    =>
+ *   c[i + 3] = a[i + 3] + b[i + 3];
+ *
+ * Loops are handled by HLoopOptimization, this pass only looks at the accesses of a single block
+ * that are not covered by bounds checks anymore.
+ */
+class HSlpVectorizer : public HOptimization {
+ public:
+  HSlpVectorizer(HGraph* graph,
+                 const CodeGenerator& codegen,
+                 OptimizingCompilerStats* stats,
+                 const char* name = kSlpVectorizerPassName);
+
+  bool Run() override;
+
+  static constexpr const char* kSlpVectorizerPassName = "slp_vectorizer";
+
+ private:
+  // Maximum depth of the packed expression trees.
+  static constexpr size_t kMaxPackDepth = 8;
+
+  // Returns the number of lanes of a vector of `type`, or 0 if `type` cannot be vectorized.
+  size_t GetVectorLength(DataType::Type type) const;
+
+  bool TryVectorizeBlock(HBasicBlock* block);
+  bool TryVectorizeStores(HBasicBlock* block, const ScopedArenaVector<HArraySet*>& stores);
+
+  // Returns whether the instructions in `lanes` can be packed into one vector operation,
+  // recording the scalar instructions that need to move to the insertion point in `members`.
+  bool CanPack(const ScopedArenaVector<HInstruction*>& lanes,
+               DataType::Type type,
+               HBasicBlock* block,
+               size_t depth,
+               ScopedArenaVector<HInstruction*>* members);
+
+  // Generates the vector operation for `lanes` before `cursor`.
+  HInstruction* GeneratePack(const ScopedArenaVector<HInstruction*>& lanes,
+                             DataType::Type type,
+                             HInstruction* cursor);
+
+  // Returns whether the members can be moved to `last_store` without changing the semantics of
+  // the block.
+  bool CanMoveTo(const ScopedArenaVector<HInstruction*>& members, HInstruction* last_store);
+
+  // Numbers the instructions of `block` in program order.
+  void ComputePositions(HBasicBlock* block);
+
+  const CodeGenerator& codegen_;
+
+  // Temporary allocator for the analysis, only valid during Run().
+  ScopedArenaAllocator* allocator_;
+
+  // Position of each instruction of the current block, indexed by instruction id.
+  ScopedArenaVector<size_t>* positions_;
+
+  // Number of lanes of the vectors being generated.
+  size_t vector_length_;
+
+  DISALLOW_COPY_AND_ASSIGN(HSlpVectorizer);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SLP_VECTORIZER_H_
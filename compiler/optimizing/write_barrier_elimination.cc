@@ -17,6 +17,7 @@
 #include "write_barrier_elimination.h"
 
 #include "base/arena_allocator.h"
+#include "base/array_ref.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "optimizing/nodes.h"
@@ -29,13 +30,19 @@ class WBEVisitor final : public HGraphVisitor {
       : HGraphVisitor(graph),
         scoped_allocator_(graph->GetArenaStack()),
         current_write_barriers_(scoped_allocator_.Adapter(kArenaAllocWBE)),
+        exit_write_barriers_(graph->GetBlocks().size(),
+                             nullptr,
+                             scoped_allocator_.Adapter(kArenaAllocWBE)),
         stats_(stats) {}
 
   void VisitBasicBlock(HBasicBlock* block) override {
-    // We clear the map to perform this optimization only in the same block. Doing it across blocks
-    // would entail non-trivial merging of states.
-    current_write_barriers_.clear();
+    MergePredecessorValues(block);
     HGraphVisitor::VisitBasicBlock(block);
+    if (!block->GetSuccessors().empty() && !current_write_barriers_.empty()) {
+      exit_write_barriers_[block->GetBlockId()] =
+          new (&scoped_allocator_) ScopedArenaHashMap<HInstruction*, HInstruction*>(
+              current_write_barriers_);
+    }
   }
 
   void VisitInstanceFieldSet(HInstanceFieldSet* instruction) override {
@@ -54,7 +61,7 @@ class WBEVisitor final : public HGraphVisitor {
       DCHECK(it->second->IsInstanceFieldSet());
       DCHECK(it->second->AsInstanceFieldSet()->GetWriteBarrierKind() !=
              WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->StrictlyDominates(instruction));
       it->second->AsInstanceFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitNoNullCheck);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -80,7 +87,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsStaticFieldSet());
       DCHECK(it->second->AsStaticFieldSet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->StrictlyDominates(instruction));
       it->second->AsStaticFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitNoNullCheck);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -108,7 +115,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsArraySet());
       DCHECK(it->second->AsArraySet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->StrictlyDominates(instruction));
       // We never skip the null check in ArraySets so that value is already set.
       DCHECK(it->second->AsArraySet()->GetWriteBarrierKind() == WriteBarrierKind::kEmitNoNullCheck);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
@@ -129,6 +136,40 @@ class WBEVisitor final : public HGraphVisitor {
  private:
   void ClearCurrentValues() { current_write_barriers_.clear(); }
 
+  // A card marked in a predecessor is still marked at the start of `block` if no instruction that
+  // can trigger GC ran in between. We know that for a receiver if every predecessor has been
+  // visited and ends with the same write barrier for it, which is then the one dominating `block`.
+  // Back edges are not visited yet when we reach a loop header, so loop headers start empty, and
+  // catch blocks are only entered after a throw which can trigger GC.
+  void MergePredecessorValues(HBasicBlock* block) {
+    current_write_barriers_.clear();
+    if (block->IsCatchBlock() || block->GetPredecessors().empty()) {
+      return;
+    }
+    for (HBasicBlock* predecessor : block->GetPredecessors()) {
+      if (exit_write_barriers_[predecessor->GetBlockId()] == nullptr) {
+        return;
+      }
+    }
+    ArrayRef<HBasicBlock* const> predecessors(block->GetPredecessors());
+    for (const auto& [receiver, write_barrier] :
+             *exit_write_barriers_[predecessors[0]->GetBlockId()]) {
+      bool available_on_all_paths = true;
+      for (HBasicBlock* predecessor : predecessors.SubArray(/*pos=*/ 1u)) {
+        const ScopedArenaHashMap<HInstruction*, HInstruction*>* other =
+            exit_write_barriers_[predecessor->GetBlockId()];
+        auto it = other->find(receiver);
+        if (it == other->end() || it->second != write_barrier) {
+          available_on_all_paths = false;
+          break;
+        }
+      }
+      if (available_on_all_paths) {
+        current_write_barriers_.insert({receiver, write_barrier});
+      }
+    }
+  }
+
   HInstruction* HuntForOriginalReference(HInstruction* ref) const {
     // An original reference can be transformed by instructions like:
     //   i0 NewArray
@@ -144,9 +185,14 @@ class WBEVisitor final : public HGraphVisitor {
   ScopedArenaAllocator scoped_allocator_;
 
   // Stores a map of <Receiver, InstructionWhereTheWriteBarrierIs>.
-  // `InstructionWhereTheWriteBarrierIs` is used for DCHECKs only.
+  // `InstructionWhereTheWriteBarrierIs` is used for merging the values of predecessors and for
+  // DCHECKs.
   ScopedArenaHashMap<HInstruction*, HInstruction*> current_write_barriers_;
 
+  // The values of `current_write_barriers_` at the end of each visited block, indexed by block id.
+  // Null if the block has not been visited yet or there were no values.
+  ScopedArenaVector<ScopedArenaHashMap<HInstruction*, HInstruction*>*> exit_write_barriers_;
+
   OptimizingCompilerStats* const stats_;
 
   DISALLOW_COPY_AND_ASSIGN(WBEVisitor);
@@ -32,6 +32,10 @@ namespace art HIDDEN {
 //   o.inner_obj3 = io3;
 // We can keep the write barrier for `inner_obj` and remove the other two.
 //
+// This also works across blocks: a write barrier can be removed if a write barrier for the same
+// receiver is executed on every path leading to it, and no instruction that can trigger GC runs in
+// between. Loop headers and catch blocks always start without known write barriers.
+//
 // In order to do this, we set the WriteBarrierKind of the instruction. The instruction's kind are
 // set to kEmitNoNullCheck (if this write barrier coalesced other write barriers, we don't want to
 // perform the null check optimization), or to kDontEmit (if the write barrier as a whole is not
@@ -142,8 +142,12 @@ class AssemblerTestBase : public testing::Test {
     InstructionSet isa = GetIsa();
     switch (isa) {
       case InstructionSet::kRiscv64:
-        // TODO: Support compression (RV32C) in assembler and tests (add `c` to `-march=`).
-        return {FindTool("clang"), "--compile", "-target", "riscv64-linux-gnu", "-march=rv64imafd"};
+        // Tests for the "C" extension add `c` to `-march=`, see `AssemblerRISCV64CompressedTest`.
+        return {FindTool("clang"),
+                "--compile",
+                "-target",
+                "riscv64-linux-gnu",
+                "-march=rv64imafdv_zba_zbb_zbs"};
       case InstructionSet::kX86:
         return {FindTool("clang"), "--compile", "-target", "i386-linux-gnu"};
       case InstructionSet::kX86_64:
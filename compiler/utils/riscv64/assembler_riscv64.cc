@@ -19,6 +19,7 @@
 #include "base/bit_utils.h"
 #include "base/casts.h"
 #include "base/memory_region.h"
+#include "heap_poisoning.h"
 
 namespace art {
 namespace riscv64 {
@@ -28,15 +29,63 @@ static_assert(static_cast<size_t>(kRiscv64PointerSize) == kRiscv64DoublewordSize
 static_assert(kRiscv64PointerSize == PointerSize::k64, "Unexpected Riscv64 pointer size.");
 
 void Riscv64Assembler::FinalizeCode() {
+  PromoteBranches();
 }
 
 void Riscv64Assembler::FinalizeInstructions(const MemoryRegion& region) {
+  EmitBranches();
   Assembler::FinalizeInstructions(region);
+  PatchCFI();
+}
+
+void Riscv64Assembler::PatchCFI() {
+  if (cfi().NumberOfDelayedAdvancePCs() == 0u) {
+    return;
+  }
+
+  using DelayedAdvancePC = DebugFrameOpCodeWriterForAssembler::DelayedAdvancePC;
+  const auto data = cfi().ReleaseStreamAndPrepareForDelayedAdvancePC();
+  const std::vector<uint8_t>& old_stream = data.first;
+  const std::vector<DelayedAdvancePC>& advances = data.second;
+
+  // Refill our data buffer with patched opcodes.
+  static constexpr size_t kExtraSpace = 16;  // Not every PC advance can be encoded in one byte.
+  cfi().ReserveCFIStream(old_stream.size() + advances.size() + kExtraSpace);
+  size_t stream_pos = 0;
+  for (const DelayedAdvancePC& advance : advances) {
+    DCHECK_GE(advance.stream_pos, stream_pos);
+    // Copy old data up to the point where advance was issued.
+    cfi().AppendRawData(old_stream, stream_pos, advance.stream_pos);
+    stream_pos = advance.stream_pos;
+    // Insert the advance command with its final offset.
+    size_t final_pc = GetAdjustedPosition(advance.pc);
+    cfi().AdvancePC(final_pc);
+  }
+  // Copy the final segment if any.
+  cfi().AppendRawData(old_stream, stream_pos, old_stream.size());
 }
 
 void Riscv64Assembler::Emit(uint32_t value) {
-  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
-  buffer_.Emit<uint32_t>(value);
+  if (overwriting_) {
+    // Branches to labels are emitted into their placeholders here.
+    buffer_.Store<uint32_t>(overwrite_location_, value);
+    overwrite_location_ += sizeof(uint32_t);
+  } else {
+    // Other instructions are simply appended at the end here.
+    AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+    buffer_.Emit<uint32_t>(value);
+  }
+}
+
+void Riscv64Assembler::Emit16(uint32_t value) {
+  DCHECK(IsUint<16>(value)) << value;
+  if (overwriting_) {
+    buffer_.Store<uint16_t>(overwrite_location_, value);
+    overwrite_location_ += sizeof(uint16_t);
+  } else {
+    AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+    buffer_.Emit<uint16_t>(value);
+  }
 }
 
 /////////////////////////////// RV64 VARIANTS extension ///////////////////////////////
@@ -46,6 +95,11 @@ void Riscv64Assembler::Emit(uint32_t value) {
 // LUI/AUIPC (RV32I, with sign-extension on RV64I), opcode = 0x17, 0x37
 
 void Riscv64Assembler::Lui(XRegister rd, uint32_t imm20) {
+  if (IsCompressionEnabled() && rd != Zero && rd != SP && imm20 != 0u &&
+      (IsUint<5>(imm20) || (imm20 >= 0xfffe0u && IsUint<20>(imm20)))) {
+    CLui(rd, imm20);
+    return;
+  }
   EmitU(imm20, rd, 0x37);
 }
 
@@ -60,6 +114,15 @@ void Riscv64Assembler::Jal(XRegister rd, int32_t offset) {
 }
 
 void Riscv64Assembler::Jalr(XRegister rd, XRegister rs1, int32_t offset) {
+  if (IsCompressionEnabled() && offset == 0 && rs1 != Zero) {
+    if (rd == Zero) {
+      CJr(rs1);
+      return;
+    } else if (rd == RA) {
+      CJalr(rs1);
+      return;
+    }
+  }
   EmitI(offset, rs1, 0x0, rd, 0x67);
 }
 
@@ -100,10 +163,28 @@ void Riscv64Assembler::Lh(XRegister rd, XRegister rs1, int32_t offset) {
 }
 
 void Riscv64Assembler::Lw(XRegister rd, XRegister rs1, int32_t offset) {
+  if (IsCompressionEnabled() && IsAligned<4>(offset)) {
+    if (IsShortReg(rd) && IsShortReg(rs1) && IsUint<7>(offset)) {
+      CLw(rd, rs1, offset);
+      return;
+    } else if (rs1 == SP && rd != Zero && IsUint<8>(offset)) {
+      CLwsp(rd, offset);
+      return;
+    }
+  }
   EmitI(offset, rs1, 0x2, rd, 0x03);
 }
 
 void Riscv64Assembler::Ld(XRegister rd, XRegister rs1, int32_t offset) {
+  if (IsCompressionEnabled() && IsAligned<8>(offset)) {
+    if (IsShortReg(rd) && IsShortReg(rs1) && IsUint<8>(offset)) {
+      CLd(rd, rs1, offset);
+      return;
+    } else if (rs1 == SP && rd != Zero && IsUint<9>(offset)) {
+      CLdsp(rd, offset);
+      return;
+    }
+  }
   EmitI(offset, rs1, 0x3, rd, 0x03);
 }
 
@@ -130,16 +211,63 @@ void Riscv64Assembler::Sh(XRegister rs2, XRegister rs1, int32_t offset) {
 }
 
 void Riscv64Assembler::Sw(XRegister rs2, XRegister rs1, int32_t offset) {
+  if (IsCompressionEnabled() && IsAligned<4>(offset)) {
+    if (IsShortReg(rs2) && IsShortReg(rs1) && IsUint<7>(offset)) {
+      CSw(rs2, rs1, offset);
+      return;
+    } else if (rs1 == SP && IsUint<8>(offset)) {
+      CSwsp(rs2, offset);
+      return;
+    }
+  }
   EmitS(offset, rs2, rs1, 0x2, 0x23);
 }
 
 void Riscv64Assembler::Sd(XRegister rs2, XRegister rs1, int32_t offset) {
+  if (IsCompressionEnabled() && IsAligned<8>(offset)) {
+    if (IsShortReg(rs2) && IsShortReg(rs1) && IsUint<8>(offset)) {
+      CSd(rs2, rs1, offset);
+      return;
+    } else if (rs1 == SP && IsUint<9>(offset)) {
+      CSdsp(rs2, offset);
+      return;
+    }
+  }
   EmitS(offset, rs2, rs1, 0x3, 0x23);
 }
 
 // IMM ALU instructions (RV32I): opcode = 0x13, funct3 from 0x0 ~ 0x7
 
 void Riscv64Assembler::Addi(XRegister rd, XRegister rs1, int32_t imm12) {
+  if (IsCompressionEnabled()) {
+    // Check the forms in the same order as the clang assembler so that we make the same
+    // choice when more than one compressed instruction applies (e.g. C.ADDI and C.ADDI16SP).
+    if (rd == Zero) {
+      if (rs1 == Zero && imm12 == 0) {
+        CNop();
+        return;
+      }
+    } else if (rs1 == Zero) {
+      if (IsInt<6>(imm12)) {
+        CLi(rd, imm12);
+        return;
+      }
+    } else if (imm12 == 0) {
+      CMv(rd, rs1);
+      return;
+    } else if (rd == rs1) {
+      if (IsInt<6>(imm12)) {
+        CAddi(rd, imm12);
+        return;
+      } else if (rd == SP && IsInt<10>(imm12) && IsAligned<16>(imm12)) {
+        CAddi16Sp(imm12);
+        return;
+      }
+    } else if (rs1 == SP && IsShortReg(rd) && IsUint<10>(imm12) && IsAligned<4>(imm12)) {
+      CAddi4Spn(rd, static_cast<uint32_t>(imm12));
+      return;
+    }
+  }
   EmitI(imm12, rs1, 0x0, rd, 0x13);
 }
 
@@ -160,34 +288,69 @@ void Riscv64Assembler::Ori(XRegister rd, XRegister rs1, int32_t imm12) {
 }
 
 void Riscv64Assembler::Andi(XRegister rd, XRegister rs1, int32_t imm12) {
+  if (IsCompressionEnabled() && rd == rs1 && IsShortReg(rd) && IsInt<6>(imm12)) {
+    CAndi(rd, imm12);
+    return;
+  }
   EmitI(imm12, rs1, 0x7, rd, 0x13);
 }
 
 // 0x1 Split: 0x0(6b) + imm12(6b)
 void Riscv64Assembler::Slli(XRegister rd, XRegister rs1, int32_t shamt) {
   CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  if (IsCompressionEnabled() && rd == rs1 && rd != Zero && shamt != 0) {
+    CSlli(rd, shamt);
+    return;
+  }
   EmitI6(0x0, shamt, rs1, 0x1, rd, 0x13);
 }
 
 // 0x5 Split: 0x0(6b) + imm12(6b)
 void Riscv64Assembler::Srli(XRegister rd, XRegister rs1, int32_t shamt) {
   CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  if (IsCompressionEnabled() && rd == rs1 && IsShortReg(rd) && shamt != 0) {
+    CSrli(rd, shamt);
+    return;
+  }
   EmitI6(0x0, shamt, rs1, 0x5, rd, 0x13);
 }
 
 // 0x5 Split: 0x10(6b) + imm12(6b)
 void Riscv64Assembler::Srai(XRegister rd, XRegister rs1, int32_t shamt) {
   CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  if (IsCompressionEnabled() && rd == rs1 && IsShortReg(rd) && shamt != 0) {
+    CSrai(rd, shamt);
+    return;
+  }
   EmitI6(0x10, shamt, rs1, 0x5, rd, 0x13);
 }
 
 // ALU instructions (RV32I): opcode = 0x33, funct3 from 0x0 ~ 0x7
 
 void Riscv64Assembler::Add(XRegister rd, XRegister rs1, XRegister rs2) {
+  if (IsCompressionEnabled() && rd != Zero) {
+    if (rs1 == Zero && rs2 != Zero) {
+      CMv(rd, rs2);
+      return;
+    } else if (rs2 == Zero && rs1 != Zero) {
+      CMv(rd, rs1);
+      return;
+    } else if (rd == rs1 && rs2 != Zero) {
+      CAdd(rd, rs2);
+      return;
+    } else if (rd == rs2 && rs1 != Zero) {
+      CAdd(rd, rs1);
+      return;
+    }
+  }
   EmitR(0x0, rs2, rs1, 0x0, rd, 0x33);
 }
 
 void Riscv64Assembler::Sub(XRegister rd, XRegister rs1, XRegister rs2) {
+  if (IsCompressionEnabled() && rd == rs1 && IsShortReg(rd) && IsShortReg(rs2)) {
+    CSub(rd, rs2);
+    return;
+  }
   EmitR(0x20, rs2, rs1, 0x0, rd, 0x33);
 }
 
@@ -200,14 +363,44 @@ void Riscv64Assembler::Sltu(XRegister rd, XRegister rs1, XRegister rs2) {
 }
 
 void Riscv64Assembler::Xor(XRegister rd, XRegister rs1, XRegister rs2) {
+  if (IsCompressionEnabled() && IsShortReg(rd)) {
+    // The operation is commutative, so either source register can match `rd`.
+    if (rd == rs1 && IsShortReg(rs2)) {
+      CXor(rd, rs2);
+      return;
+    } else if (rd == rs2 && IsShortReg(rs1)) {
+      CXor(rd, rs1);
+      return;
+    }
+  }
   EmitR(0x0, rs2, rs1, 0x04, rd, 0x33);
 }
 
 void Riscv64Assembler::Or(XRegister rd, XRegister rs1, XRegister rs2) {
+  if (IsCompressionEnabled() && IsShortReg(rd)) {
+    // The operation is commutative, so either source register can match `rd`.
+    if (rd == rs1 && IsShortReg(rs2)) {
+      COr(rd, rs2);
+      return;
+    } else if (rd == rs2 && IsShortReg(rs1)) {
+      COr(rd, rs1);
+      return;
+    }
+  }
   EmitR(0x0, rs2, rs1, 0x06, rd, 0x33);
 }
 
 void Riscv64Assembler::And(XRegister rd, XRegister rs1, XRegister rs2) {
+  if (IsCompressionEnabled() && IsShortReg(rd)) {
+    // The operation is commutative, so either source register can match `rd`.
+    if (rd == rs1 && IsShortReg(rs2)) {
+      CAnd(rd, rs2);
+      return;
+    } else if (rd == rs2 && IsShortReg(rs1)) {
+      CAnd(rd, rs1);
+      return;
+    }
+  }
   EmitR(0x0, rs2, rs1, 0x07, rd, 0x33);
 }
 
@@ -226,6 +419,15 @@ void Riscv64Assembler::Sra(XRegister rd, XRegister rs1, XRegister rs2) {
 // 32bit Imm ALU instructions (RV64I): opcode = 0x1b, funct3 from 0x0, 0x1, 0x5
 
 void Riscv64Assembler::Addiw(XRegister rd, XRegister rs1, int32_t imm12) {
+  if (IsCompressionEnabled() && rd != Zero && IsInt<6>(imm12)) {
+    if (rd == rs1) {
+      CAddiw(rd, imm12);
+      return;
+    } else if (rs1 == Zero) {
+      CLi(rd, imm12);  // The result is the same as for ADDI.
+      return;
+    }
+  }
   EmitI(imm12, rs1, 0x0, rd, 0x1b);
 }
 
@@ -247,10 +449,23 @@ void Riscv64Assembler::Sraiw(XRegister rd, XRegister rs1, int32_t shamt) {
 // 32bit ALU instructions (RV64I): opcode = 0x3b, funct3 from 0x0 ~ 0x7
 
 void Riscv64Assembler::Addw(XRegister rd, XRegister rs1, XRegister rs2) {
+  if (IsCompressionEnabled() && IsShortReg(rd)) {
+    if (rd == rs1 && IsShortReg(rs2)) {
+      CAddw(rd, rs2);
+      return;
+    } else if (rd == rs2 && IsShortReg(rs1)) {
+      CAddw(rd, rs1);
+      return;
+    }
+  }
   EmitR(0x0, rs2, rs1, 0x0, rd, 0x3b);
 }
 
 void Riscv64Assembler::Subw(XRegister rd, XRegister rs1, XRegister rs2) {
+  if (IsCompressionEnabled() && rd == rs1 && IsShortReg(rd) && IsShortReg(rs2)) {
+    CSubw(rd, rs2);
+    return;
+  }
   EmitR(0x20, rs2, rs1, 0x0, rd, 0x3b);
 }
 
@@ -266,6 +481,24 @@ void Riscv64Assembler::Sraw(XRegister rd, XRegister rs1, XRegister rs2) {
   EmitR(0x20, rs2, rs1, 0x5, rd, 0x3b);
 }
 
+void Riscv64Assembler::Fence(uint32_t pred, uint32_t succ) {
+  DCHECK(IsUint<4>(pred));
+  DCHECK(IsUint<4>(succ));
+  EmitI(static_cast<int32_t>(pred << 4 | succ), Zero, 0x0, Zero, 0x0f);
+}
+
+// Environment call and breakpoint (RV32I), opcode = 0x73
+
+void Riscv64Assembler::Ecall() { EmitI(0x0, Zero, 0x0, Zero, 0x73); }
+
+void Riscv64Assembler::Ebreak() {
+  if (IsCompressionEnabled()) {
+    CEbreak();
+    return;
+  }
+  EmitI(0x1, Zero, 0x0, Zero, 0x73);
+}
+
 // RV32M Standard Extension: opcode = 0x33, funct3 from 0x0 ~ 0x7
 
 void Riscv64Assembler::Mul(XRegister rd, XRegister rs1, XRegister rs2) {
@@ -324,6 +557,101 @@ void Riscv64Assembler::Remuw(XRegister rd, XRegister rs1, XRegister rs2) {
 
 /////////////////////////////// RV64 "IM" Instructions  END ///////////////////////////////
 
+/////////////////////////////// RV64 "A" Instructions  START ///////////////////////////////
+
+// RV32A/RV64A Standard Extension: opcode = 0x2f, funct3 = 0x2 (W) or 0x3 (D)
+// The funct7 field holds the 5-bit operation code followed by the "aq" and "rl" bits.
+
+void Riscv64Assembler::LrW(XRegister rd, XRegister rs1, AqRl aqrl) {
+  EmitR(0x2 << 2 | enum_cast<uint32_t>(aqrl), Zero, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::LrD(XRegister rd, XRegister rs1, AqRl aqrl) {
+  EmitR(0x2 << 2 | enum_cast<uint32_t>(aqrl), Zero, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::ScW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x3 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::ScD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x3 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoSwapW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x1 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoSwapD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x1 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoAddW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x0 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoAddD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x0 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoXorW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x4 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoXorD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x4 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoAndW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0xc << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoAndD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0xc << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoOrW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x8 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoOrD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x8 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMinW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x10 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMinD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x10 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMaxW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x14 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMaxD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x14 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMinuW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x18 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMinuD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x18 << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMaxuW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x1c << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x2, rd, 0x2f);
+}
+
+void Riscv64Assembler::AmoMaxuD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl) {
+  EmitR(0x1c << 2 | enum_cast<uint32_t>(aqrl), rs2, rs1, 0x3, rd, 0x2f);
+}
+
+/////////////////////////////// RV64 "A" Instructions  END ///////////////////////////////
+
 /////////////////////////////// RV64 "FD" Instructions  START ///////////////////////////////
 
 // FP load/store instructions (RV32F+RV32D): opcode = 0x07, 0x27
@@ -333,6 +661,15 @@ void Riscv64Assembler::FLw(FRegister rd, XRegister rs1, int32_t offset) {
 }
 
 void Riscv64Assembler::FLd(FRegister rd, XRegister rs1, int32_t offset) {
+  if (IsCompressionEnabled() && IsAligned<8>(offset)) {
+    if (IsShortReg(rd) && IsShortReg(rs1) && IsUint<8>(offset)) {
+      CFLd(rd, rs1, offset);
+      return;
+    } else if (rs1 == SP && IsUint<9>(offset)) {
+      CFLdsp(rd, offset);
+      return;
+    }
+  }
   EmitI(offset, rs1, 0x3, rd, 0x07);
 }
 
@@ -341,6 +678,15 @@ void Riscv64Assembler::FSw(FRegister rs2, XRegister rs1, int32_t offset) {
 }
 
 void Riscv64Assembler::FSd(FRegister rs2, XRegister rs1, int32_t offset) {
+  if (IsCompressionEnabled() && IsAligned<8>(offset)) {
+    if (IsShortReg(rs2) && IsShortReg(rs1) && IsUint<8>(offset)) {
+      CFSd(rs2, rs1, offset);
+      return;
+    } else if (rs1 == SP && IsUint<9>(offset)) {
+      CFSdsp(rs2, offset);
+      return;
+    }
+  }
   EmitS(offset, rs2, rs1, 0x3, 0x27);
 }
 
@@ -601,117 +947,1896 @@ void Riscv64Assembler::FClassD(XRegister rd, FRegister rs1) {
 
 /////////////////////////////// RV64 "FD" Instructions  END ///////////////////////////////
 
-////////////////////////////// RV64 MACRO Instructions  START ///////////////////////////////
+/////////////////////////////// RV64 "Zicsr" Instructions  START ///////////////////////////////
 
-// Pseudo instructions
+// CSR instructions (Zicsr): opcode = 0x73, funct3 from 0x1 ~ 0x3 and 0x5 ~ 0x7
 
-void Riscv64Assembler::Nop() { Addi(Zero, Zero, 0); }
+void Riscv64Assembler::Csrrw(XRegister rd, uint32_t csr, XRegister rs1) {
+  EmitI(ToInt12(csr), rs1, 0x1, rd, 0x73);
+}
 
-void Riscv64Assembler::Mv(XRegister rd, XRegister rs) { Addi(rd, rs, 0); }
+void Riscv64Assembler::Csrrs(XRegister rd, uint32_t csr, XRegister rs1) {
+  EmitI(ToInt12(csr), rs1, 0x2, rd, 0x73);
+}
 
-void Riscv64Assembler::Not(XRegister rd, XRegister rs) { Xori(rd, rs, -1); }
+void Riscv64Assembler::Csrrc(XRegister rd, uint32_t csr, XRegister rs1) {
+  EmitI(ToInt12(csr), rs1, 0x3, rd, 0x73);
+}
 
-void Riscv64Assembler::Neg(XRegister rd, XRegister rs) { Sub(rd, Zero, rs); }
+void Riscv64Assembler::Csrrwi(XRegister rd, uint32_t csr, uint32_t uimm5) {
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitI(ToInt12(csr), uimm5, 0x5, rd, 0x73);
+}
 
-void Riscv64Assembler::NegW(XRegister rd, XRegister rs) { Subw(rd, Zero, rs); }
+void Riscv64Assembler::Csrrsi(XRegister rd, uint32_t csr, uint32_t uimm5) {
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitI(ToInt12(csr), uimm5, 0x6, rd, 0x73);
+}
 
-void Riscv64Assembler::SextB(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 8u);
-  Srai(rd, rd, kXlen - 8u);
+void Riscv64Assembler::Csrrci(XRegister rd, uint32_t csr, uint32_t uimm5) {
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitI(ToInt12(csr), uimm5, 0x7, rd, 0x73);
 }
 
-void Riscv64Assembler::SextH(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 16u);
-  Srai(rd, rd, kXlen - 16u);
+/////////////////////////////// RV64 "Zicsr" Instructions  END ///////////////////////////////
+
+/////////////////////////////// RV64 "Zb" Instructions  START ///////////////////////////////
+
+void Riscv64Assembler::AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZba());
+  EmitR(0x4, rs2, rs1, 0x0, rd, 0x3b);
 }
 
-void Riscv64Assembler::SextW(XRegister rd, XRegister rs) { Addiw(rd, rs, 0); }
+void Riscv64Assembler::Sh1Add(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZba());
+  EmitR(0x10, rs2, rs1, 0x2, rd, 0x33);
+}
 
-void Riscv64Assembler::ZextB(XRegister rd, XRegister rs) { Andi(rd, rs, 0xff); }
+void Riscv64Assembler::Sh1AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZba());
+  EmitR(0x10, rs2, rs1, 0x2, rd, 0x3b);
+}
 
-void Riscv64Assembler::ZextH(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 16u);
-  Srli(rd, rd, kXlen - 16u);
+void Riscv64Assembler::Sh2Add(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZba());
+  EmitR(0x10, rs2, rs1, 0x4, rd, 0x33);
 }
 
-void Riscv64Assembler::ZextW(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 32u);
-  Srli(rd, rd, kXlen - 32u);
+void Riscv64Assembler::Sh2AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZba());
+  EmitR(0x10, rs2, rs1, 0x4, rd, 0x3b);
 }
 
-void Riscv64Assembler::Seqz(XRegister rd, XRegister rs) { Sltiu(rd, rs, 1); }
+void Riscv64Assembler::Sh3Add(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZba());
+  EmitR(0x10, rs2, rs1, 0x6, rd, 0x33);
+}
 
-void Riscv64Assembler::Snez(XRegister rd, XRegister rs) { Sltu(rd, Zero, rs); }
+void Riscv64Assembler::Sh3AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZba());
+  EmitR(0x10, rs2, rs1, 0x6, rd, 0x3b);
+}
 
-void Riscv64Assembler::Sltz(XRegister rd, XRegister rs) { Slt(rd, rs, Zero); }
+void Riscv64Assembler::SlliUw(XRegister rd, XRegister rs1, int32_t shamt) {
+  DCHECK(HasZba());
+  CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  EmitI6(0x2, shamt, rs1, 0x1, rd, 0x1b);
+}
 
-void Riscv64Assembler::Sgtz(XRegister rd, XRegister rs) { Slt(rd, Zero, rs); }
+void Riscv64Assembler::Andn(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x20, rs2, rs1, 0x7, rd, 0x33);
+}
 
-void Riscv64Assembler::FMvS(FRegister rd, FRegister rs) { FSgnjS(rd, rs, rs); }
+void Riscv64Assembler::Orn(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x20, rs2, rs1, 0x6, rd, 0x33);
+}
 
-void Riscv64Assembler::FAbsS(FRegister rd, FRegister rs) { FSgnjxS(rd, rs, rs); }
+void Riscv64Assembler::Xnor(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x20, rs2, rs1, 0x4, rd, 0x33);
+}
 
-void Riscv64Assembler::FNegS(FRegister rd, FRegister rs) { FSgnjnS(rd, rs, rs); }
+void Riscv64Assembler::Clz(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x0, rs1, 0x1, rd, 0x13);
+}
 
-void Riscv64Assembler::FMvD(FRegister rd, FRegister rs) { FSgnjS(rd, rs, rs); }
+void Riscv64Assembler::Clzw(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x0, rs1, 0x1, rd, 0x1b);
+}
 
-void Riscv64Assembler::FAbsD(FRegister rd, FRegister rs) { FSgnjxS(rd, rs, rs); }
+void Riscv64Assembler::Ctz(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x1, rs1, 0x1, rd, 0x13);
+}
 
-void Riscv64Assembler::FNegD(FRegister rd, FRegister rs) { FSgnjnS(rd, rs, rs); }
+void Riscv64Assembler::Ctzw(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x1, rs1, 0x1, rd, 0x1b);
+}
 
-void Riscv64Assembler::Beqz(XRegister rs, int32_t offset) {
-  Beq(rs, Zero, offset);
+void Riscv64Assembler::Cpop(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x2, rs1, 0x1, rd, 0x13);
 }
 
-void Riscv64Assembler::Bnez(XRegister rs, int32_t offset) {
-  Bne(rs, Zero, offset);
+void Riscv64Assembler::Cpopw(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x2, rs1, 0x1, rd, 0x1b);
 }
 
-void Riscv64Assembler::Blez(XRegister rt, int32_t offset) {
-  Bge(Zero, rt, offset);
+void Riscv64Assembler::Min(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x5, rs2, rs1, 0x4, rd, 0x33);
 }
 
-void Riscv64Assembler::Bgez(XRegister rt, int32_t offset) {
-  Bge(rt, Zero, offset);
+void Riscv64Assembler::Minu(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x5, rs2, rs1, 0x5, rd, 0x33);
 }
 
-void Riscv64Assembler::Bltz(XRegister rt, int32_t offset) {
-  Blt(rt, Zero, offset);
+void Riscv64Assembler::Max(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x5, rs2, rs1, 0x6, rd, 0x33);
 }
 
-void Riscv64Assembler::Bgtz(XRegister rt, int32_t offset) {
-  Blt(Zero, rt, offset);
+void Riscv64Assembler::Maxu(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x5, rs2, rs1, 0x7, rd, 0x33);
 }
 
-void Riscv64Assembler::Bgt(XRegister rs, XRegister rt, int32_t offset) {
-  Blt(rt, rs, offset);
+void Riscv64Assembler::Rol(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x30, rs2, rs1, 0x1, rd, 0x33);
 }
 
-void Riscv64Assembler::Ble(XRegister rs, XRegister rt, int32_t offset) {
-  Bge(rt, rs, offset);
+void Riscv64Assembler::Rolw(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x30, rs2, rs1, 0x1, rd, 0x3b);
 }
 
-void Riscv64Assembler::Bgtu(XRegister rs, XRegister rt, int32_t offset) {
-  Bltu(rt, rs, offset);
+void Riscv64Assembler::Ror(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x30, rs2, rs1, 0x5, rd, 0x33);
 }
 
-void Riscv64Assembler::Bleu(XRegister rs, XRegister rt, int32_t offset) {
-  Bgeu(rt, rs, offset);
+void Riscv64Assembler::Rorw(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbb());
+  EmitR(0x30, rs2, rs1, 0x5, rd, 0x3b);
 }
 
-void Riscv64Assembler::J(int32_t offset) { Jal(Zero, offset); }
+void Riscv64Assembler::Rori(XRegister rd, XRegister rs1, int32_t shamt) {
+  DCHECK(HasZbb());
+  CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  EmitI6(0x18, shamt, rs1, 0x5, rd, 0x13);
+}
 
-void Riscv64Assembler::Jal(int32_t offset) { Jal(RA, offset); }
+void Riscv64Assembler::Roriw(XRegister rd, XRegister rs1, int32_t shamt) {
+  DCHECK(HasZbb());
+  CHECK(static_cast<uint32_t>(shamt) < 32) << shamt;
+  EmitR(0x30, static_cast<uint32_t>(shamt), rs1, 0x5, rd, 0x1b);
+}
 
-void Riscv64Assembler::Jr(XRegister rs) { Jalr(Zero, rs, 0); }
+void Riscv64Assembler::OrcB(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitI(0x287, rs1, 0x5, rd, 0x13);
+}
 
-void Riscv64Assembler::Jalr(XRegister rs) { Jalr(RA, rs, 0); }
+void Riscv64Assembler::Rev8(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitI(0x6b8, rs1, 0x5, rd, 0x13);
+}
 
-void Riscv64Assembler::Jalr(XRegister rd, XRegister rs) { Jalr(rd, rs, 0); }
+void Riscv64Assembler::ZbbSextB(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x4, rs1, 0x1, rd, 0x13);
+}
 
-void Riscv64Assembler::Ret() { Jalr(Zero, RA, 0); }
+void Riscv64Assembler::ZbbSextH(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x30, 0x5, rs1, 0x1, rd, 0x13);
+}
 
-/////////////////////////////// RV64 MACRO Instructions END ///////////////////////////////
+void Riscv64Assembler::ZbbZextH(XRegister rd, XRegister rs1) {
+  DCHECK(HasZbb());
+  EmitR(0x4, 0x0, rs1, 0x4, rd, 0x3b);
+}
+
+void Riscv64Assembler::Bclr(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbs());
+  EmitR(0x24, rs2, rs1, 0x1, rd, 0x33);
+}
+
+void Riscv64Assembler::Bclri(XRegister rd, XRegister rs1, int32_t shamt) {
+  DCHECK(HasZbs());
+  CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  EmitI6(0x12, shamt, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::Bext(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbs());
+  EmitR(0x24, rs2, rs1, 0x5, rd, 0x33);
+}
+
+void Riscv64Assembler::Bexti(XRegister rd, XRegister rs1, int32_t shamt) {
+  DCHECK(HasZbs());
+  CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  EmitI6(0x12, shamt, rs1, 0x5, rd, 0x13);
+}
+
+void Riscv64Assembler::Binv(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbs());
+  EmitR(0x34, rs2, rs1, 0x1, rd, 0x33);
+}
+
+void Riscv64Assembler::Binvi(XRegister rd, XRegister rs1, int32_t shamt) {
+  DCHECK(HasZbs());
+  CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  EmitI6(0x1a, shamt, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::Bset(XRegister rd, XRegister rs1, XRegister rs2) {
+  DCHECK(HasZbs());
+  EmitR(0x14, rs2, rs1, 0x1, rd, 0x33);
+}
+
+void Riscv64Assembler::Bseti(XRegister rd, XRegister rs1, int32_t shamt) {
+  DCHECK(HasZbs());
+  CHECK(static_cast<uint32_t>(shamt) < 64) << shamt;
+  EmitI6(0xa, shamt, rs1, 0x1, rd, 0x13);
+}
+
+/////////////////////////////// RV64 "Zb" Instructions  END ///////////////////////////////
+
+/////////////////////////////// RV64 "V" Instructions  START ///////////////////////////////
+
+// Vector configuration-setting instructions: opcode = 0x57, funct3 = 0x7
+
+void Riscv64Assembler::VSetvli(XRegister rd, XRegister rs1, uint32_t vtypei) {
+  DCHECK(IsUint<11>(vtypei)) << vtypei;
+  EmitI(static_cast<int32_t>(vtypei), rs1, 0x7, rd, 0x57);
+}
+
+void Riscv64Assembler::VSetivli(XRegister rd, uint32_t uimm5, uint32_t vtypei) {
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  DCHECK(IsUint<10>(vtypei)) << vtypei;
+  EmitI(ToInt12(0xc00 | vtypei), uimm5, 0x7, rd, 0x57);
+}
+
+void Riscv64Assembler::VSetvl(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x40, rs2, rs1, 0x7, rd, 0x57);
+}
+
+// Vector unit-stride loads and stores: opcode = 0x07, 0x27, nf = 0, mew = 0, mop = 0
+
+void Riscv64Assembler::VLe8(VRegister vd, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x0, vd, 0x07);
+}
+
+void Riscv64Assembler::VLe16(VRegister vd, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x5, vd, 0x07);
+}
+
+void Riscv64Assembler::VLe32(VRegister vd, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x6, vd, 0x07);
+}
+
+void Riscv64Assembler::VLe64(VRegister vd, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x7, vd, 0x07);
+}
+
+void Riscv64Assembler::VSe8(VRegister vs3, XRegister rs1, VM vm) {
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x0, vs3, 0x27);
+}
+
+void Riscv64Assembler::VSe16(VRegister vs3, XRegister rs1, VM vm) {
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x5, vs3, 0x27);
+}
+
+void Riscv64Assembler::VSe32(VRegister vs3, XRegister rs1, VM vm) {
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x6, vs3, 0x27);
+}
+
+void Riscv64Assembler::VSe64(VRegister vs3, XRegister rs1, VM vm) {
+  EmitR(enum_cast<uint32_t>(vm), 0x0, rs1, 0x7, vs3, 0x27);
+}
+
+// Vector whole register loads and stores: lumop/sumop = 0x8, vm = 1
+
+void Riscv64Assembler::VL1re8(VRegister vd, XRegister rs1) {
+  EmitR(0x1, 0x8, rs1, 0x0, vd, 0x07);
+}
+
+void Riscv64Assembler::VS1r(VRegister vs3, XRegister rs1) {
+  EmitR(0x1, 0x8, rs1, 0x0, vs3, 0x27);
+}
+
+// Vector integer instructions with OPIVV, OPIVI and OPIVX: opcode = 0x57, funct3 = 0x0, 0x3, 0x4
+
+void Riscv64Assembler::VAdd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x00, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VAdd_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x00, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VAdd_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x00, vm), vs2, EncodeInt5(imm5), 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VSub_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x02, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VSub_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x02, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VRsub_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x03, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VRsub_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x03, vm), vs2, EncodeInt5(imm5), 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VMinu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x04, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VMin_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x05, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VMaxu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x06, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VMax_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x07, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VAnd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x09, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VAnd_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x09, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VAnd_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x09, vm), vs2, EncodeInt5(imm5), 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VOr_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x0a, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VOr_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x0a, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VOr_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x0a, vm), vs2, EncodeInt5(imm5), 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VXor_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x0b, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VXor_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x0b, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VXor_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x0b, vm), vs2, EncodeInt5(imm5), 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VSaddu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x20, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VSadd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x21, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VSsubu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x22, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VSsub_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x23, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VSll_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x25, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VSll_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitR(EncodeRVVF7(0x25, vm), vs2, uimm5, 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VSrl_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x28, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VSrl_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitR(EncodeRVVF7(0x28, vm), vs2, uimm5, 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VSra_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x29, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VSra_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitR(EncodeRVVF7(0x29, vm), vs2, uimm5, 0x3, vd, 0x57);
+}
+
+void Riscv64Assembler::VSlidedown_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK_NE(vd, vs2);
+  DCHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitR(EncodeRVVF7(0x0f, vm), vs2, uimm5, 0x3, vd, 0x57);
+}
+
+// The compare instructions write a mask, so unlike other masked instructions they may use
+// V0 as the destination.
+
+void Riscv64Assembler::VMseq_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  EmitR(EncodeRVVF7(0x18, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VMseq_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  EmitR(EncodeRVVF7(0x18, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VMsne_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  EmitR(EncodeRVVF7(0x19, vm), vs2, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VMsne_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  EmitR(EncodeRVVF7(0x19, vm), vs2, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VMv_vv(VRegister vd, VRegister vs1) {
+  EmitR(EncodeRVVF7(0x17, VM::kUnmasked), V0, vs1, 0x0, vd, 0x57);
+}
+
+void Riscv64Assembler::VMv_vx(VRegister vd, XRegister rs1) {
+  EmitR(EncodeRVVF7(0x17, VM::kUnmasked), V0, rs1, 0x4, vd, 0x57);
+}
+
+void Riscv64Assembler::VMv_vi(VRegister vd, int32_t imm5) {
+  EmitR(EncodeRVVF7(0x17, VM::kUnmasked), V0, EncodeInt5(imm5), 0x3, vd, 0x57);
+}
+
+// The `simm5` field of VMV<NR>R.V holds the number of registers to move minus 1.
+void Riscv64Assembler::VMv1r_v(VRegister vd, VRegister vs2) {
+  EmitR(EncodeRVVF7(0x27, VM::kUnmasked), vs2, 0x0, 0x3, vd, 0x57);
+}
+
+// Vector integer instructions with OPMVV and OPMVX: opcode = 0x57, funct3 = 0x2, 0x6
+
+void Riscv64Assembler::VRedsum_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x00, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VRedminu_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x04, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VRedmin_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x05, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VRedmaxu_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x06, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VRedmax_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x07, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VAaddu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x08, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VAadd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x09, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VMul_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x25, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VMul_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x25, vm), vs2, rs1, 0x6, vd, 0x57);
+}
+
+void Riscv64Assembler::VMacc_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x2d, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VNmsac_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x2f, vm), vs2, vs1, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VZext_vf2(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK_NE(vd, vs2);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x6, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VSext_vf2(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK_NE(vd, vs2);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x7, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VZext_vf4(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK_NE(vd, vs2);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x4, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VSext_vf4(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK_NE(vd, vs2);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x5, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VZext_vf8(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK_NE(vd, vs2);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x2, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VSext_vf8(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  DCHECK_NE(vd, vs2);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x3, 0x2, vd, 0x57);
+}
+
+void Riscv64Assembler::VMv_xs(XRegister rd, VRegister vs2) {
+  EmitR(EncodeRVVF7(0x10, VM::kUnmasked), vs2, 0x0, 0x2, rd, 0x57);
+}
+
+void Riscv64Assembler::VMv_sx(VRegister vd, XRegister rs1) {
+  EmitR(EncodeRVVF7(0x10, VM::kUnmasked), V0, rs1, 0x6, vd, 0x57);
+}
+
+void Riscv64Assembler::VCpop_m(XRegister rd, VRegister vs2, VM vm) {
+  EmitR(EncodeRVVF7(0x10, vm), vs2, 0x10, 0x2, rd, 0x57);
+}
+
+void Riscv64Assembler::VFirst_m(XRegister rd, VRegister vs2, VM vm) {
+  EmitR(EncodeRVVF7(0x10, vm), vs2, 0x11, 0x2, rd, 0x57);
+}
+
+// Vector floating-point instructions with OPFVV and OPFVF: opcode = 0x57, funct3 = 0x1, 0x5
+
+void Riscv64Assembler::VFAdd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x00, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFAdd_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x00, vm), vs2, fs1, 0x5, vd, 0x57);
+}
+
+void Riscv64Assembler::VFSub_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x02, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFSub_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x02, vm), vs2, fs1, 0x5, vd, 0x57);
+}
+
+void Riscv64Assembler::VFMul_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x24, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFMul_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x24, vm), vs2, fs1, 0x5, vd, 0x57);
+}
+
+void Riscv64Assembler::VFDiv_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x20, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFDiv_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x20, vm), vs2, fs1, 0x5, vd, 0x57);
+}
+
+void Riscv64Assembler::VFMin_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x04, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFMax_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x06, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFSgnj_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x08, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFSgnjn_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x09, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFSgnjx_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x0a, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFMacc_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x2c, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFNmsac_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x2f, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFRedusum_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x01, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFRedmin_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x05, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFRedmax_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x07, vm), vs2, vs1, 0x1, vd, 0x57);
+}
+
+// Conversions use the VFUNARY0 encoding with the operation selected by the `vs1` field.
+
+void Riscv64Assembler::VFCvt_f_x_v(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x3, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFCvt_rtz_x_f_v(VRegister vd, VRegister vs2, VM vm) {
+  DCHECK(vm == VM::kUnmasked || vd != V0);
+  EmitR(EncodeRVVF7(0x12, vm), vs2, 0x7, 0x1, vd, 0x57);
+}
+
+void Riscv64Assembler::VFMv_vf(VRegister vd, FRegister fs1) {
+  EmitR(EncodeRVVF7(0x17, VM::kUnmasked), V0, fs1, 0x5, vd, 0x57);
+}
+
+void Riscv64Assembler::VFMv_fs(FRegister fd, VRegister vs2) {
+  EmitR(EncodeRVVF7(0x10, VM::kUnmasked), vs2, 0x0, 0x1, fd, 0x57);
+}
+
+void Riscv64Assembler::VFMv_sf(VRegister vd, FRegister fs1) {
+  EmitR(EncodeRVVF7(0x10, VM::kUnmasked), V0, fs1, 0x5, vd, 0x57);
+}
+
+/////////////////////////////// RV64 "V" Instructions  END ///////////////////////////////
+
+/////////////////////////////// RV64 "C" Instructions  START ///////////////////////////////
+
+// Stack-pointer-based loads and stores, opcode = 0x2
+
+void Riscv64Assembler::CLwsp(XRegister rd, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK(IsUint<8>(offset) && IsAligned<4>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm6 = (uimm & 0x20u) | (uimm & 0x1cu) | (uimm & 0xc0u) >> 6;  // [5|4:2|7:6]
+  EmitCI(0x2, rd, imm6, 0x2);
+}
+
+void Riscv64Assembler::CLdsp(XRegister rd, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK(IsUint<9>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm6 = (uimm & 0x38u) | (uimm & 0x1c0u) >> 6;  // [5|4:3|8:6]
+  EmitCI(0x3, rd, imm6, 0x2);
+}
+
+void Riscv64Assembler::CFLdsp(FRegister rd, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<9>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm6 = (uimm & 0x38u) | (uimm & 0x1c0u) >> 6;  // [5|4:3|8:6]
+  EmitCI(0x1, rd, imm6, 0x2);
+}
+
+void Riscv64Assembler::CSwsp(XRegister rs2, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<8>(offset) && IsAligned<4>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm6 = (uimm & 0x3cu) | (uimm & 0xc0u) >> 6;  // [5:2|7:6]
+  EmitCSS(0x6, imm6, rs2, 0x2);
+}
+
+void Riscv64Assembler::CSdsp(XRegister rs2, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<9>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm6 = (uimm & 0x38u) | (uimm & 0x1c0u) >> 6;  // [5:3|8:6]
+  EmitCSS(0x7, imm6, rs2, 0x2);
+}
+
+void Riscv64Assembler::CFSdsp(FRegister rs2, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<9>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm6 = (uimm & 0x38u) | (uimm & 0x1c0u) >> 6;  // [5:3|8:6]
+  EmitCSS(0x5, imm6, rs2, 0x2);
+}
+
+// Register-based loads and stores, opcode = 0x0
+
+void Riscv64Assembler::CLw(XRegister rd_s, XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<7>(offset) && IsAligned<4>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm5 = (uimm & 0x38u) >> 1 | (uimm & 0x4u) >> 1 | (uimm & 0x40u) >> 6;  // [5:3|2|6]
+  EmitCM(0x2, imm5, rs1_s, rd_s, 0x0);
+}
+
+void Riscv64Assembler::CLd(XRegister rd_s, XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<8>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm5 = (uimm & 0x38u) >> 1 | (uimm & 0xc0u) >> 6;  // [5:3|7:6]
+  EmitCM(0x3, imm5, rs1_s, rd_s, 0x0);
+}
+
+void Riscv64Assembler::CFLd(FRegister rd_s, XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<8>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm5 = (uimm & 0x38u) >> 1 | (uimm & 0xc0u) >> 6;  // [5:3|7:6]
+  EmitCM(0x1, imm5, rs1_s, rd_s, 0x0);
+}
+
+void Riscv64Assembler::CSw(XRegister rs2_s, XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<7>(offset) && IsAligned<4>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm5 = (uimm & 0x38u) >> 1 | (uimm & 0x4u) >> 1 | (uimm & 0x40u) >> 6;  // [5:3|2|6]
+  EmitCM(0x6, imm5, rs1_s, rs2_s, 0x0);
+}
+
+void Riscv64Assembler::CSd(XRegister rs2_s, XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<8>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm5 = (uimm & 0x38u) >> 1 | (uimm & 0xc0u) >> 6;  // [5:3|7:6]
+  EmitCM(0x7, imm5, rs1_s, rs2_s, 0x0);
+}
+
+void Riscv64Assembler::CFSd(FRegister rs2_s, XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK(IsUint<8>(offset) && IsAligned<8>(offset)) << offset;
+  uint32_t uimm = static_cast<uint32_t>(offset);
+  uint32_t imm5 = (uimm & 0x38u) >> 1 | (uimm & 0xc0u) >> 6;  // [5:3|7:6]
+  EmitCM(0x5, imm5, rs1_s, rs2_s, 0x0);
+}
+
+// Constant generation and register-immediate operations, opcode = 0x0, 0x1, 0x2
+
+void Riscv64Assembler::CLi(XRegister rd, int32_t imm) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK(IsInt<6>(imm)) << imm;
+  EmitCI(0x2, rd, static_cast<uint32_t>(imm) & 0x3fu, 0x1);
+}
+
+void Riscv64Assembler::CLui(XRegister rd, uint32_t nzimm20) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK_NE(rd, SP);
+  // The 6-bit immediate is sign-extended to 20 bits.
+  DCHECK(nzimm20 != 0u && (IsUint<5>(nzimm20) || (nzimm20 >= 0xfffe0u && IsUint<20>(nzimm20))))
+      << nzimm20;
+  EmitCI(0x3, rd, nzimm20 & 0x3fu, 0x1);
+}
+
+void Riscv64Assembler::CAddi(XRegister rd, int32_t nzimm) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK_NE(nzimm, 0);
+  DCHECK(IsInt<6>(nzimm)) << nzimm;
+  EmitCI(0x0, rd, static_cast<uint32_t>(nzimm) & 0x3fu, 0x1);
+}
+
+void Riscv64Assembler::CAddiw(XRegister rd, int32_t imm) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK(IsInt<6>(imm)) << imm;
+  EmitCI(0x1, rd, static_cast<uint32_t>(imm) & 0x3fu, 0x1);
+}
+
+void Riscv64Assembler::CAddi16Sp(int32_t nzimm) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(nzimm, 0);
+  DCHECK(IsInt<10>(nzimm) && IsAligned<16>(nzimm)) << nzimm;
+  uint32_t imm = static_cast<uint32_t>(nzimm);
+  uint32_t imm6 = (imm & 0x200u) >> 4 | (imm & 0x10u) | (imm & 0x40u) >> 3 |
+                  (imm & 0x180u) >> 6 | (imm & 0x20u) >> 5;  // [9|4|6|8:7|5]
+  EmitCI(0x3, SP, imm6, 0x1);
+}
+
+void Riscv64Assembler::CAddi4Spn(XRegister rd_s, uint32_t nzuimm) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(nzuimm, 0u);
+  DCHECK(IsUint<10>(nzuimm) && IsAligned<4>(nzuimm)) << nzuimm;
+  uint32_t imm8 = (nzuimm & 0x30u) << 2 | (nzuimm & 0x3c0u) >> 4 | (nzuimm & 0x4u) >> 1 |
+                  (nzuimm & 0x8u) >> 3;  // [5:4|9:6|2|3]
+  EmitCIW(0x0, imm8, rd_s, 0x0);
+}
+
+void Riscv64Assembler::CSlli(XRegister rd, int32_t shamt) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK(shamt != 0 && static_cast<uint32_t>(shamt) < 64) << shamt;
+  EmitCI(0x0, rd, static_cast<uint32_t>(shamt), 0x2);
+}
+
+void Riscv64Assembler::CSrli(XRegister rd_s, int32_t shamt) {
+  DCHECK(HasCompressed());
+  DCHECK(shamt != 0 && static_cast<uint32_t>(shamt) < 64) << shamt;
+  uint32_t uimm = static_cast<uint32_t>(shamt);
+  EmitCB(0x4, (uimm & 0x20u) << 2 | 0x0u << 5 | (uimm & 0x1fu), rd_s, 0x1);
+}
+
+void Riscv64Assembler::CSrai(XRegister rd_s, int32_t shamt) {
+  DCHECK(HasCompressed());
+  DCHECK(shamt != 0 && static_cast<uint32_t>(shamt) < 64) << shamt;
+  uint32_t uimm = static_cast<uint32_t>(shamt);
+  EmitCB(0x4, (uimm & 0x20u) << 2 | 0x1u << 5 | (uimm & 0x1fu), rd_s, 0x1);
+}
+
+void Riscv64Assembler::CAndi(XRegister rd_s, int32_t imm) {
+  DCHECK(HasCompressed());
+  DCHECK(IsInt<6>(imm)) << imm;
+  uint32_t uimm = static_cast<uint32_t>(imm);
+  EmitCB(0x4, (uimm & 0x20u) << 2 | 0x2u << 5 | (uimm & 0x1fu), rd_s, 0x1);
+}
+
+// Register-register operations, opcode = 0x1, 0x2
+
+void Riscv64Assembler::CMv(XRegister rd, XRegister rs2) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK_NE(rs2, Zero);
+  EmitCR(0x8, rd, rs2, 0x2);
+}
+
+void Riscv64Assembler::CAdd(XRegister rd, XRegister rs2) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rd, Zero);
+  DCHECK_NE(rs2, Zero);
+  EmitCR(0x9, rd, rs2, 0x2);
+}
+
+void Riscv64Assembler::CAnd(XRegister rd_s, XRegister rs2_s) {
+  DCHECK(HasCompressed());
+  EmitCA(0x23, rd_s, 0x3, rs2_s, 0x1);
+}
+
+void Riscv64Assembler::COr(XRegister rd_s, XRegister rs2_s) {
+  DCHECK(HasCompressed());
+  EmitCA(0x23, rd_s, 0x2, rs2_s, 0x1);
+}
+
+void Riscv64Assembler::CXor(XRegister rd_s, XRegister rs2_s) {
+  DCHECK(HasCompressed());
+  EmitCA(0x23, rd_s, 0x1, rs2_s, 0x1);
+}
+
+void Riscv64Assembler::CSub(XRegister rd_s, XRegister rs2_s) {
+  DCHECK(HasCompressed());
+  EmitCA(0x23, rd_s, 0x0, rs2_s, 0x1);
+}
+
+void Riscv64Assembler::CAddw(XRegister rd_s, XRegister rs2_s) {
+  DCHECK(HasCompressed());
+  EmitCA(0x27, rd_s, 0x1, rs2_s, 0x1);
+}
+
+void Riscv64Assembler::CSubw(XRegister rd_s, XRegister rs2_s) {
+  DCHECK(HasCompressed());
+  EmitCA(0x27, rd_s, 0x0, rs2_s, 0x1);
+}
+
+// Control transfer instructions, opcode = 0x1, 0x2
+
+void Riscv64Assembler::CJ(int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK_ALIGNED(offset, 2);
+  DCHECK(IsInt<12>(offset)) << offset;
+  uint32_t imm = static_cast<uint32_t>(offset);
+  uint32_t imm11 = (imm & 0x800u) >> 1 | (imm & 0x10u) << 5 | (imm & 0x300u) >> 1 |
+                   (imm & 0x400u) >> 4 | (imm & 0x40u) >> 1 | (imm & 0x80u) >> 3 |
+                   (imm & 0xeu) | (imm & 0x20u) >> 5;  // [11|4|9:8|10|6|7|3:1|5]
+  EmitCJ(0x5, imm11, 0x1);
+}
+
+void Riscv64Assembler::CJr(XRegister rs1) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rs1, Zero);
+  EmitCR(0x8, rs1, Zero, 0x2);
+}
+
+void Riscv64Assembler::CJalr(XRegister rs1) {
+  DCHECK(HasCompressed());
+  DCHECK_NE(rs1, Zero);
+  EmitCR(0x9, rs1, Zero, 0x2);
+}
+
+void Riscv64Assembler::CBeqz(XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK_ALIGNED(offset, 2);
+  DCHECK(IsInt<9>(offset)) << offset;
+  uint32_t imm = static_cast<uint32_t>(offset);
+  uint32_t imm8 = (imm & 0x100u) >> 1 | (imm & 0x18u) << 2 | (imm & 0xc0u) >> 3 |
+                  (imm & 0x6u) | (imm & 0x20u) >> 5;  // [8|4:3|7:6|2:1|5]
+  EmitCB(0x6, imm8, rs1_s, 0x1);
+}
+
+void Riscv64Assembler::CBnez(XRegister rs1_s, int32_t offset) {
+  DCHECK(HasCompressed());
+  DCHECK_ALIGNED(offset, 2);
+  DCHECK(IsInt<9>(offset)) << offset;
+  uint32_t imm = static_cast<uint32_t>(offset);
+  uint32_t imm8 = (imm & 0x100u) >> 1 | (imm & 0x18u) << 2 | (imm & 0xc0u) >> 3 |
+                  (imm & 0x6u) | (imm & 0x20u) >> 5;  // [8|4:3|7:6|2:1|5]
+  EmitCB(0x7, imm8, rs1_s, 0x1);
+}
+
+void Riscv64Assembler::CEbreak() {
+  DCHECK(HasCompressed());
+  EmitCR(0x9, Zero, Zero, 0x2);
+}
+
+void Riscv64Assembler::CNop() {
+  DCHECK(HasCompressed());
+  EmitCI(0x0, Zero, 0u, 0x1);
+}
+
+/////////////////////////////// RV64 "C" Instructions  END ///////////////////////////////
+
+////////////////////////////// RV64 MACRO Instructions  START ///////////////////////////////
+
+// Pseudo instructions
+
+void Riscv64Assembler::Nop() { Addi(Zero, Zero, 0); }
+
+// Note: This is the canonical `unimp` encoding `csrrw zero, cycle, zero` (0xc0001073).
+void Riscv64Assembler::Unimp() { EmitI(0xc00 - 0x1000, Zero, 0x1, Zero, 0x73); }
+
+void Riscv64Assembler::Mv(XRegister rd, XRegister rs) { Addi(rd, rs, 0); }
+
+void Riscv64Assembler::Not(XRegister rd, XRegister rs) { Xori(rd, rs, -1); }
+
+void Riscv64Assembler::Neg(XRegister rd, XRegister rs) { Sub(rd, Zero, rs); }
+
+void Riscv64Assembler::NegW(XRegister rd, XRegister rs) { Subw(rd, Zero, rs); }
+
+void Riscv64Assembler::SextB(XRegister rd, XRegister rs) {
+  if (HasZbb()) {
+    ZbbSextB(rd, rs);
+  } else {
+    Slli(rd, rs, kXlen - 8u);
+    Srai(rd, rd, kXlen - 8u);
+  }
+}
+
+void Riscv64Assembler::SextH(XRegister rd, XRegister rs) {
+  if (HasZbb()) {
+    ZbbSextH(rd, rs);
+  } else {
+    Slli(rd, rs, kXlen - 16u);
+    Srai(rd, rd, kXlen - 16u);
+  }
+}
+
+void Riscv64Assembler::SextW(XRegister rd, XRegister rs) { Addiw(rd, rs, 0); }
+
+void Riscv64Assembler::ZextB(XRegister rd, XRegister rs) { Andi(rd, rs, 0xff); }
+
+void Riscv64Assembler::ZextH(XRegister rd, XRegister rs) {
+  if (HasZbb()) {
+    ZbbZextH(rd, rs);
+  } else {
+    Slli(rd, rs, kXlen - 16u);
+    Srli(rd, rd, kXlen - 16u);
+  }
+}
+
+void Riscv64Assembler::ZextW(XRegister rd, XRegister rs) {
+  if (HasZba()) {
+    AddUw(rd, rs, Zero);  // zext.w
+  } else {
+    Slli(rd, rs, kXlen - 32u);
+    Srli(rd, rd, kXlen - 32u);
+  }
+}
+
+void Riscv64Assembler::Seqz(XRegister rd, XRegister rs) { Sltiu(rd, rs, 1); }
+
+void Riscv64Assembler::Snez(XRegister rd, XRegister rs) { Sltu(rd, Zero, rs); }
+
+void Riscv64Assembler::Sltz(XRegister rd, XRegister rs) { Slt(rd, rs, Zero); }
+
+void Riscv64Assembler::Sgtz(XRegister rd, XRegister rs) { Slt(rd, Zero, rs); }
+
+void Riscv64Assembler::FMvS(FRegister rd, FRegister rs) { FSgnjS(rd, rs, rs); }
+
+void Riscv64Assembler::FAbsS(FRegister rd, FRegister rs) { FSgnjxS(rd, rs, rs); }
+
+void Riscv64Assembler::FNegS(FRegister rd, FRegister rs) { FSgnjnS(rd, rs, rs); }
+
+void Riscv64Assembler::FMvD(FRegister rd, FRegister rs) { FSgnjD(rd, rs, rs); }
+
+void Riscv64Assembler::FAbsD(FRegister rd, FRegister rs) { FSgnjxD(rd, rs, rs); }
+
+void Riscv64Assembler::FNegD(FRegister rd, FRegister rs) { FSgnjnD(rd, rs, rs); }
+
+void Riscv64Assembler::VNot_v(VRegister vd, VRegister vs2, VM vm) { VXor_vi(vd, vs2, -1, vm); }
+
+void Riscv64Assembler::VNeg_v(VRegister vd, VRegister vs2, VM vm) { VRsub_vx(vd, vs2, Zero, vm); }
+
+void Riscv64Assembler::VFNeg_v(VRegister vd, VRegister vs) { VFSgnjn_vv(vd, vs, vs); }
+
+void Riscv64Assembler::VFAbs_v(VRegister vd, VRegister vs) { VFSgnjx_vv(vd, vs, vs); }
+
+void Riscv64Assembler::Csrr(XRegister rd, uint32_t csr) { Csrrs(rd, csr, Zero); }
+
+void Riscv64Assembler::Csrw(uint32_t csr, XRegister rs) { Csrrw(Zero, csr, rs); }
+
+void Riscv64Assembler::Csrwi(uint32_t csr, uint32_t uimm5) { Csrrwi(Zero, csr, uimm5); }
+
+void Riscv64Assembler::Beqz(XRegister rs, int32_t offset) {
+  Beq(rs, Zero, offset);
+}
+
+void Riscv64Assembler::Bnez(XRegister rs, int32_t offset) {
+  Bne(rs, Zero, offset);
+}
+
+void Riscv64Assembler::Blez(XRegister rt, int32_t offset) {
+  Bge(Zero, rt, offset);
+}
+
+void Riscv64Assembler::Bgez(XRegister rt, int32_t offset) {
+  Bge(rt, Zero, offset);
+}
+
+void Riscv64Assembler::Bltz(XRegister rt, int32_t offset) {
+  Blt(rt, Zero, offset);
+}
+
+void Riscv64Assembler::Bgtz(XRegister rt, int32_t offset) {
+  Blt(Zero, rt, offset);
+}
+
+void Riscv64Assembler::Bgt(XRegister rs, XRegister rt, int32_t offset) {
+  Blt(rt, rs, offset);
+}
+
+void Riscv64Assembler::Ble(XRegister rs, XRegister rt, int32_t offset) {
+  Bge(rt, rs, offset);
+}
+
+void Riscv64Assembler::Bgtu(XRegister rs, XRegister rt, int32_t offset) {
+  Bltu(rt, rs, offset);
+}
+
+void Riscv64Assembler::Bleu(XRegister rs, XRegister rt, int32_t offset) {
+  Bgeu(rt, rs, offset);
+}
+
+void Riscv64Assembler::J(int32_t offset) { Jal(Zero, offset); }
+
+void Riscv64Assembler::Jal(int32_t offset) { Jal(RA, offset); }
+
+void Riscv64Assembler::Jr(XRegister rs) { Jalr(Zero, rs, 0); }
+
+void Riscv64Assembler::Jalr(XRegister rs) { Jalr(RA, rs, 0); }
+
+void Riscv64Assembler::Jalr(XRegister rd, XRegister rs) { Jalr(rd, rs, 0); }
+
+void Riscv64Assembler::Ret() { Jalr(Zero, RA, 0); }
+
+void Riscv64Assembler::Li(XRegister rd, int64_t imm) {
+  if (IsInt<32>(imm)) {
+    // LUI+ADDIW handles all 32-bit values, using ADDIW for the sign-extension
+    // of the low part (the value may wrap around in the 32-bit addition).
+    int32_t lo12 = static_cast<int32_t>(static_cast<uint32_t>(imm) << 20) >> 20;
+    uint32_t hi20 = static_cast<uint32_t>((imm + 0x800) >> 12) & 0xfffffu;
+    if (hi20 != 0u) {
+      Lui(rd, hi20);
+      if (lo12 != 0) {
+        Addiw(rd, rd, lo12);
+      }
+    } else {
+      Addi(rd, Zero, lo12);
+    }
+    return;
+  }
+
+  // Materialize the upper 52 bits (with trailing zeros shifted out) recursively,
+  // then shift left and add the low 12 bits. The low 12 bits are sign-extended,
+  // so the upper part is biased by 0x800 to compensate.
+  int64_t lo12 = static_cast<int64_t>(static_cast<uint64_t>(imm) << 52) >> 52;
+  int64_t hi52 = static_cast<int64_t>(static_cast<uint64_t>(imm) + 0x800u) >> 12;
+  DCHECK_NE(hi52, 0);
+  uint32_t shift = 12u + CTZ(static_cast<uint64_t>(hi52));
+  hi52 = static_cast<int64_t>(static_cast<uint64_t>(hi52) >> (shift - 12u) << shift) >> shift;
+  Li(rd, hi52);
+  Slli(rd, rd, shift);
+  if (lo12 != 0) {
+    Addi(rd, rd, lo12);
+  }
+}
+
+/////////////////////////////// RV64 MACRO Instructions END ///////////////////////////////
+
+XRegister Riscv64Assembler::AdjustBaseAndOffset(XRegister rs1, int32_t* offset) {
+  if (IsInt<12>(*offset)) {
+    return rs1;
+  }
+  CHECK_NE(rs1, TMP);
+  // Compensate for the sign-extension of the low 12 bits in the final instruction.
+  int64_t high = (static_cast<int64_t>(*offset) + 0x800) & ~INT64_C(0xfff);
+  Li(TMP, high);
+  Add(TMP, TMP, rs1);
+  *offset = static_cast<int32_t>(static_cast<int64_t>(*offset) - high);
+  DCHECK(IsInt<12>(*offset));
+  return TMP;
+}
+
+template <void (Riscv64Assembler::*insn)(XRegister, XRegister, int32_t)>
+void Riscv64Assembler::LoadFromOffset(XRegister rd, XRegister rs1, int32_t offset) {
+  XRegister base = AdjustBaseAndOffset(rs1, &offset);
+  (this->*insn)(rd, base, offset);
+}
+
+template <void (Riscv64Assembler::*insn)(XRegister, XRegister, int32_t)>
+void Riscv64Assembler::StoreToOffset(XRegister rs2, XRegister rs1, int32_t offset) {
+  CHECK_NE(rs2, TMP);
+  XRegister base = AdjustBaseAndOffset(rs1, &offset);
+  (this->*insn)(rs2, base, offset);
+}
+
+template <void (Riscv64Assembler::*insn)(FRegister, XRegister, int32_t)>
+void Riscv64Assembler::FLoadFromOffset(FRegister rd, XRegister rs1, int32_t offset) {
+  XRegister base = AdjustBaseAndOffset(rs1, &offset);
+  (this->*insn)(rd, base, offset);
+}
+
+template <void (Riscv64Assembler::*insn)(FRegister, XRegister, int32_t)>
+void Riscv64Assembler::FStoreToOffset(FRegister rs2, XRegister rs1, int32_t offset) {
+  XRegister base = AdjustBaseAndOffset(rs1, &offset);
+  (this->*insn)(rs2, base, offset);
+}
+
+void Riscv64Assembler::Loadb(XRegister rd, XRegister rs1, int32_t offset) {
+  LoadFromOffset<&Riscv64Assembler::Lb>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::Loadh(XRegister rd, XRegister rs1, int32_t offset) {
+  LoadFromOffset<&Riscv64Assembler::Lh>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::Loadw(XRegister rd, XRegister rs1, int32_t offset) {
+  LoadFromOffset<&Riscv64Assembler::Lw>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::Loadd(XRegister rd, XRegister rs1, int32_t offset) {
+  LoadFromOffset<&Riscv64Assembler::Ld>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::Loadbu(XRegister rd, XRegister rs1, int32_t offset) {
+  LoadFromOffset<&Riscv64Assembler::Lbu>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::Loadhu(XRegister rd, XRegister rs1, int32_t offset) {
+  LoadFromOffset<&Riscv64Assembler::Lhu>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::Loadwu(XRegister rd, XRegister rs1, int32_t offset) {
+  LoadFromOffset<&Riscv64Assembler::Lwu>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::Storeb(XRegister rs2, XRegister rs1, int32_t offset) {
+  StoreToOffset<&Riscv64Assembler::Sb>(rs2, rs1, offset);
+}
+
+void Riscv64Assembler::Storeh(XRegister rs2, XRegister rs1, int32_t offset) {
+  StoreToOffset<&Riscv64Assembler::Sh>(rs2, rs1, offset);
+}
+
+void Riscv64Assembler::Storew(XRegister rs2, XRegister rs1, int32_t offset) {
+  StoreToOffset<&Riscv64Assembler::Sw>(rs2, rs1, offset);
+}
+
+void Riscv64Assembler::Stored(XRegister rs2, XRegister rs1, int32_t offset) {
+  StoreToOffset<&Riscv64Assembler::Sd>(rs2, rs1, offset);
+}
+
+void Riscv64Assembler::FLoadw(FRegister rd, XRegister rs1, int32_t offset) {
+  FLoadFromOffset<&Riscv64Assembler::FLw>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::FLoadd(FRegister rd, XRegister rs1, int32_t offset) {
+  FLoadFromOffset<&Riscv64Assembler::FLd>(rd, rs1, offset);
+}
+
+void Riscv64Assembler::FStorew(FRegister rs2, XRegister rs1, int32_t offset) {
+  FStoreToOffset<&Riscv64Assembler::FSw>(rs2, rs1, offset);
+}
+
+void Riscv64Assembler::FStored(FRegister rs2, XRegister rs1, int32_t offset) {
+  FStoreToOffset<&Riscv64Assembler::FSd>(rs2, rs1, offset);
+}
+
+void Riscv64Assembler::AddConst32(XRegister rd, XRegister rs1, int32_t value) {
+  if (IsInt<12>(value)) {
+    Addiw(rd, rs1, value);
+  } else {
+    CHECK_NE(rs1, TMP);
+    Li(TMP, value);
+    Addw(rd, rs1, TMP);
+  }
+}
+
+void Riscv64Assembler::AddConst64(XRegister rd, XRegister rs1, int64_t value) {
+  if (IsInt<12>(value)) {
+    Addi(rd, rs1, value);
+  } else {
+    CHECK_NE(rs1, TMP);
+    Li(TMP, value);
+    Add(rd, rs1, TMP);
+  }
+}
+
+void Riscv64Assembler::PoisonHeapReference(XRegister reg) {
+  // reg = -reg, keeping the 32-bit reference zero-extended.
+  NegW(reg, reg);
+  ZextW(reg, reg);
+}
+
+void Riscv64Assembler::UnpoisonHeapReference(XRegister reg) {
+  // reg = -reg, keeping the 32-bit reference zero-extended.
+  NegW(reg, reg);
+  ZextW(reg, reg);
+}
+
+void Riscv64Assembler::MaybePoisonHeapReference(XRegister reg) {
+  if (kPoisonHeapReferences) {
+    PoisonHeapReference(reg);
+  }
+}
+
+void Riscv64Assembler::MaybeUnpoisonHeapReference(XRegister reg) {
+  if (kPoisonHeapReferences) {
+    UnpoisonHeapReference(reg);
+  }
+}
+
+/////////////////////////////// Branches to labels ///////////////////////////////
+
+const Riscv64Assembler::Branch::BranchInfo Riscv64Assembler::Branch::branch_info_[] = {
+    // Conditional branches.
+    {2, 0, Riscv64Assembler::Branch::kOffset9},    // kCondCBranch
+    {4, 0, Riscv64Assembler::Branch::kOffset13},   // kCondBranch
+    {6, 2, Riscv64Assembler::Branch::kOffset21},   // kCondCBranch21
+    {8, 4, Riscv64Assembler::Branch::kOffset21},   // kCondBranch21
+    {10, 2, Riscv64Assembler::Branch::kOffset32},  // kLongCondCBranch
+    {12, 4, Riscv64Assembler::Branch::kOffset32},  // kLongCondBranch
+
+    // Unconditional branches and calls.
+    {2, 0, Riscv64Assembler::Branch::kOffset12},  // kUncondCBranch
+    {4, 0, Riscv64Assembler::Branch::kOffset21},  // kUncondBranch
+    {8, 0, Riscv64Assembler::Branch::kOffset32},  // kLongUncondBranch
+};
+
+void Riscv64Assembler::Branch::InitializeType(Type initial_type) {
+  type_ = initial_type;
+  if (IsResolved()) {
+    // Backward branches get their final type right away; forward branches start short
+    // and may be promoted in PromoteBranches() once the target is known.
+    PromoteIfNeeded();
+  }
+  old_type_ = type_;
+}
+
+bool Riscv64Assembler::Branch::IsNop(BranchCondition condition, XRegister lhs, XRegister rhs) {
+  switch (condition) {
+    case kCondNE:
+    case kCondLT:
+    case kCondLTU:
+      return lhs == rhs;
+    default:
+      return false;
+  }
+}
+
+bool Riscv64Assembler::Branch::IsUncond(BranchCondition condition, XRegister lhs, XRegister rhs) {
+  switch (condition) {
+    case kUncond:
+      return true;
+    case kCondEQ:
+    case kCondGE:
+    case kCondGEU:
+      return lhs == rhs;
+    default:
+      return false;
+  }
+}
+
+bool Riscv64Assembler::Branch::IsCompressible(BranchCondition condition,
+                                              XRegister lhs,
+                                              XRegister rhs) {
+  switch (condition) {
+    case kUncond:
+      return lhs == Zero;  // C.J, there is no C.JAL on RV64.
+    case kCondEQ:
+    case kCondNE:
+      return (rhs == Zero && IsShortReg(lhs)) || (lhs == Zero && IsShortReg(rhs));
+    default:
+      return false;
+  }
+}
+
+Riscv64Assembler::Branch::Branch(uint32_t location,
+                                 uint32_t target,
+                                 XRegister rd,
+                                 bool compression_enabled)
+    : old_location_(location),
+      location_(location),
+      target_(target),
+      lhs_reg_(rd),
+      rhs_reg_(Zero),
+      condition_(kUncond),
+      compressible_(compression_enabled && IsCompressible(kUncond, rd, Zero)),
+      prev_linked_branch_(0u) {
+  InitializeType(compressible_ ? kUncondCBranch : kUncondBranch);
+}
+
+Riscv64Assembler::Branch::Branch(uint32_t location,
+                                 uint32_t target,
+                                 Riscv64Assembler::BranchCondition condition,
+                                 XRegister lhs_reg,
+                                 XRegister rhs_reg,
+                                 bool compression_enabled)
+    : old_location_(location),
+      location_(location),
+      target_(target),
+      lhs_reg_(lhs_reg),
+      rhs_reg_(rhs_reg),
+      condition_(condition),
+      compressible_(compression_enabled && IsCompressible(condition, lhs_reg, rhs_reg)),
+      prev_linked_branch_(0u) {
+  DCHECK_NE(condition, kUncond);
+  DCHECK(!IsNop(condition, lhs_reg, rhs_reg));
+  DCHECK(!IsUncond(condition, lhs_reg, rhs_reg));
+  if (compressible_ && lhs_reg_ == Zero) {
+    // C.BEQZ/C.BNEZ compare their only register operand with zero.
+    std::swap(lhs_reg_, rhs_reg_);
+  }
+  InitializeType(compressible_ ? kCondCBranch : kCondBranch);
+}
+
+Riscv64Assembler::BranchCondition Riscv64Assembler::Branch::OppositeCondition(
+    Riscv64Assembler::BranchCondition cond) {
+  switch (cond) {
+    case kCondEQ:
+      return kCondNE;
+    case kCondNE:
+      return kCondEQ;
+    case kCondLT:
+      return kCondGE;
+    case kCondGE:
+      return kCondLT;
+    case kCondLTU:
+      return kCondGEU;
+    case kCondGEU:
+      return kCondLTU;
+    case kUncond:
+      break;
+  }
+  LOG(FATAL) << "Unexpected branch condition " << enum_cast<uint32_t>(cond);
+  UNREACHABLE();
+}
+
+void Riscv64Assembler::Branch::Resolve(uint32_t target) {
+  target_ = target;
+}
+
+void Riscv64Assembler::Branch::Relocate(uint32_t expand_location, uint32_t delta) {
+  if (location_ > expand_location) {
+    location_ += delta;
+  }
+  if (!IsResolved()) {
+    return;  // Don't know the target yet.
+  }
+  if (target_ > expand_location) {
+    target_ += delta;
+  }
+}
+
+uint32_t Riscv64Assembler::Branch::PromoteIfNeeded() {
+  DCHECK(IsResolved());
+  uint32_t old_length = GetLength();
+  while (GetOffsetSize() != kOffset32 && !IsInt(GetOffsetSize(), GetOffset())) {
+    switch (type_) {
+      case kCondCBranch:
+        type_ = kCondBranch;
+        break;
+      case kCondBranch:
+        // The inverted branch skipping the jump can still be compressed.
+        type_ = compressible_ ? kCondCBranch21 : kCondBranch21;
+        break;
+      case kCondCBranch21:
+        type_ = kLongCondCBranch;
+        break;
+      case kCondBranch21:
+        type_ = kLongCondBranch;
+        break;
+      case kUncondCBranch:
+        type_ = kUncondBranch;
+        break;
+      case kUncondBranch:
+        type_ = kLongUncondBranch;
+        break;
+      default:
+        LOG(FATAL) << "Unexpected branch type " << enum_cast<uint32_t>(type_);
+        UNREACHABLE();
+    }
+  }
+  return GetLength() - old_length;
+}
+
+uint32_t Riscv64Assembler::Branch::GetOffsetLocation() const {
+  return location_ + branch_info_[type_].pc_offset;
+}
+
+int32_t Riscv64Assembler::Branch::GetOffset() const {
+  CHECK(IsResolved());
+  // Calculate the byte distance between instructions and also account for
+  // different PC-relative bases.
+  return static_cast<int32_t>(target_ - GetOffsetLocation());
+}
+
+void Riscv64Assembler::EmitBcond(BranchCondition cond,
+                                 XRegister rs,
+                                 XRegister rt,
+                                 int32_t offset) {
+  switch (cond) {
+    case kCondEQ:
+      Beq(rs, rt, offset);
+      break;
+    case kCondNE:
+      Bne(rs, rt, offset);
+      break;
+    case kCondLT:
+      Blt(rs, rt, offset);
+      break;
+    case kCondGE:
+      Bge(rs, rt, offset);
+      break;
+    case kCondLTU:
+      Bltu(rs, rt, offset);
+      break;
+    case kCondGEU:
+      Bgeu(rs, rt, offset);
+      break;
+    case kUncond:
+      LOG(FATAL) << "Unexpected branch condition " << enum_cast<uint32_t>(cond);
+      UNREACHABLE();
+  }
+}
+
+void Riscv64Assembler::EmitCBcond(BranchCondition cond, XRegister rs, int32_t offset) {
+  switch (cond) {
+    case kCondEQ:
+      CBeqz(rs, offset);
+      break;
+    case kCondNE:
+      CBnez(rs, offset);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected branch condition " << enum_cast<uint32_t>(cond);
+      UNREACHABLE();
+  }
+}
+
+void Riscv64Assembler::EmitBranch(Riscv64Assembler::Branch* branch) {
+  CHECK(overwriting_);
+  overwrite_location_ = branch->GetLocation();
+  const int32_t offset = branch->GetOffset();
+  BranchCondition condition = branch->GetCondition();
+  XRegister lhs = branch->GetLeftRegister();
+  XRegister rhs = branch->GetRightRegister();
+
+  // Split the offset for AUIPC+JALR; the JALR offset is sign-extended, so bias the upper part.
+  uint32_t imm20 = static_cast<uint32_t>((static_cast<int64_t>(offset) + 0x800) >> 12) & 0xfffffu;
+  int32_t short_offset = static_cast<int32_t>(static_cast<uint32_t>(offset) << 20) >> 20;
+
+  switch (branch->GetType()) {
+    // Short branches.
+    case Branch::kUncondCBranch:
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      CJ(offset);
+      break;
+    case Branch::kCondCBranch:
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      EmitCBcond(condition, lhs, offset);
+      break;
+    case Branch::kUncondBranch:
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      Jal(lhs, offset);
+      break;
+    case Branch::kCondBranch:
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      EmitBcond(condition, lhs, rhs, offset);
+      break;
+
+    // Medium branches.
+    case Branch::kCondCBranch21:
+      EmitCBcond(Branch::OppositeCondition(condition), lhs, branch->GetLength());
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      Jal(Zero, offset);
+      break;
+    case Branch::kCondBranch21:
+      EmitBcond(Branch::OppositeCondition(condition), lhs, rhs, branch->GetLength());
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      Jal(Zero, offset);
+      break;
+
+    // Long branches.
+    case Branch::kLongCondCBranch:
+      EmitCBcond(Branch::OppositeCondition(condition), lhs, branch->GetLength());
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      Auipc(TMP, imm20);
+      Jalr(Zero, TMP, short_offset);
+      break;
+    case Branch::kLongCondBranch:
+      EmitBcond(Branch::OppositeCondition(condition), lhs, rhs, branch->GetLength());
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      Auipc(TMP, imm20);
+      Jalr(Zero, TMP, short_offset);
+      break;
+    case Branch::kLongUncondBranch: {
+      // Calls can use the return address register for the address calculation.
+      XRegister temp = (lhs == Zero) ? TMP : lhs;
+      CHECK_EQ(overwrite_location_, branch->GetOffsetLocation());
+      Auipc(temp, imm20);
+      Jalr(lhs, temp, short_offset);
+      break;
+    }
+  }
+  CHECK_EQ(overwrite_location_, branch->GetEndLocation());
+  CHECK_LE(branch->GetLength(), static_cast<uint32_t>(Branch::kMaxBranchLength));
+}
+
+void Riscv64Assembler::EmitBranches() {
+  CHECK(!overwriting_);
+  // The placeholders have the exact size of the branch types, so the instructions must not
+  // be compressed implicitly; the compressed branch types emit the C.* instructions directly.
+  ScopedNoCompression no_compression(this);
+  // Switch from appending instructions at the end of the buffer to overwriting
+  // existing instructions (branch placeholders) in the buffer.
+  overwriting_ = true;
+  for (auto& branch : branches_) {
+    EmitBranch(&branch);
+  }
+  overwriting_ = false;
+}
+
+void Riscv64Assembler::FinalizeLabeledBranch(Riscv64Label* label) {
+  Branch& branch = branches_.back();
+  if (!label->IsBound()) {
+    // Branch forward (to a following label), distance is unknown.
+    // The first branch forward will contain 0, serving as the terminator of
+    // the list of forward-reaching branches. The link is kept in the branch rather
+    // than in the placeholder as compressed placeholders are too small to hold it.
+    branch.SetPrevLinkedBranch(label->position_);
+    // Now make the label object point to this branch
+    // (this forms a linked list of branches preceding this label).
+    uint32_t branch_id = branches_.size() - 1;
+    label->LinkTo(branch_id);
+  }
+  // Reserve space for the branch.
+  uint32_t length = branch.GetLength();
+  DCHECK_ALIGNED(length, sizeof(uint16_t));
+  for (length /= sizeof(uint16_t); length != 0u; --length) {
+    Emit16(0u);
+  }
+}
+
+void Riscv64Assembler::Bcond(Riscv64Label* label,
+                             BranchCondition condition,
+                             XRegister lhs,
+                             XRegister rhs) {
+  // If lhs = rhs, this can be a NOP.
+  if (Branch::IsNop(condition, lhs, rhs)) {
+    return;
+  }
+  if (Branch::IsUncond(condition, lhs, rhs)) {
+    Buncond(label, Zero);
+    return;
+  }
+
+  uint32_t target = label->IsBound() ? GetLabelLocation(label) : Branch::kUnresolved;
+  branches_.emplace_back(buffer_.Size(), target, condition, lhs, rhs, IsCompressionEnabled());
+  FinalizeLabeledBranch(label);
+}
+
+void Riscv64Assembler::Buncond(Riscv64Label* label, XRegister rd) {
+  uint32_t target = label->IsBound() ? GetLabelLocation(label) : Branch::kUnresolved;
+  branches_.emplace_back(buffer_.Size(), target, rd, IsCompressionEnabled());
+  FinalizeLabeledBranch(label);
+}
+
+Riscv64Assembler::Branch* Riscv64Assembler::GetBranch(uint32_t branch_id) {
+  CHECK_LT(branch_id, branches_.size());
+  return &branches_[branch_id];
+}
+
+const Riscv64Assembler::Branch* Riscv64Assembler::GetBranch(uint32_t branch_id) const {
+  CHECK_LT(branch_id, branches_.size());
+  return &branches_[branch_id];
+}
+
+void Riscv64Assembler::Bind(Riscv64Label* label) {
+  CHECK(!label->IsBound());
+  uint32_t bound_pc = buffer_.Size();
+
+  // Walk the list of branches referring to and preceding this label.
+  // Store the previously unknown target addresses in them.
+  while (label->IsLinked()) {
+    uint32_t branch_id = label->Position();
+    Branch* branch = GetBranch(branch_id);
+    branch->Resolve(bound_pc);
+
+    // Extract the location of the previous branch in the list (walking the list backwards;
+    // the previous branch ID was stored in this branch).
+    uint32_t prev = branch->GetPrevLinkedBranch();
+
+    // On to the previous branch in the list...
+    label->position_ = prev;
+  }
+
+  // Now make the label object contain its own location (relative to the end of the preceding
+  // branch, if any; it will be used by the branches referring to and following this label).
+  uint32_t prev_branch_id = Riscv64Label::kNoPrevBranchId;
+  if (!branches_.empty()) {
+    prev_branch_id = branches_.size() - 1u;
+    const Branch* prev_branch = GetBranch(prev_branch_id);
+    bound_pc -= prev_branch->GetEndLocation();
+  }
+  label->prev_branch_id_ = prev_branch_id;
+  label->BindTo(bound_pc);
+}
+
+uint32_t Riscv64Assembler::GetLabelLocation(const Riscv64Label* label) const {
+  CHECK(label->IsBound());
+  uint32_t target = label->Position();
+  if (label->prev_branch_id_ != Riscv64Label::kNoPrevBranchId) {
+    // Get label location based on the branch preceding it.
+    const Branch* prev_branch = GetBranch(label->prev_branch_id_);
+    target += prev_branch->GetEndLocation();
+  }
+  return target;
+}
+
+uint32_t Riscv64Assembler::GetAdjustedPosition(uint32_t old_position) {
+  // We can reconstruct the adjustment by going through all the branches from the beginning
+  // up to the `old_position`. Since we expect `GetAdjustedPosition()` to be called in a loop
+  // with increasing `old_position`, we can use the data from last `GetAdjustedPosition()` to
+  // continue where we left off and the whole loop should be O(m+n) where m is the number
+  // of positions to adjust and n is the number of branches.
+  if (old_position < last_old_position_) {
+    last_position_adjustment_ = 0;
+    last_old_position_ = 0;
+    last_branch_id_ = 0;
+  }
+  while (last_branch_id_ != branches_.size()) {
+    const Branch* branch = GetBranch(last_branch_id_);
+    if (branch->GetLocation() >= old_position + last_position_adjustment_) {
+      break;
+    }
+    last_position_adjustment_ += branch->GetLength() - branch->GetOldLength();
+    ++last_branch_id_;
+  }
+  last_old_position_ = old_position;
+  return old_position + last_position_adjustment_;
+}
+
+void Riscv64Assembler::PromoteBranches() {
+  // Promote short branches to long as necessary.
+  bool changed;
+  do {
+    changed = false;
+    for (auto& branch : branches_) {
+      CHECK(branch.IsResolved());
+      uint32_t delta = branch.PromoteIfNeeded();
+      // If this branch has been promoted and needs to expand in size,
+      // relocate all branches by the expansion size.
+      if (delta != 0u) {
+        changed = true;
+        uint32_t expand_location = branch.GetLocation();
+        for (auto& branch2 : branches_) {
+          branch2.Relocate(expand_location, delta);
+        }
+      }
+    }
+  } while (changed);
+
+  // Account for branch expansion by resizing the code buffer
+  // and moving the code in it to its final location.
+  size_t branch_count = branches_.size();
+  if (branch_count > 0) {
+    // Resize.
+    Branch& last_branch = branches_[branch_count - 1];
+    uint32_t size_delta = last_branch.GetEndLocation() - last_branch.GetOldEndLocation();
+    uint32_t old_size = buffer_.Size();
+    buffer_.Resize(old_size + size_delta);
+    // Move the code residing between branch placeholders.
+    uint32_t end = old_size;
+    for (size_t i = branch_count; i > 0;) {
+      Branch& branch = branches_[--i];
+      uint32_t size = end - branch.GetOldEndLocation();
+      buffer_.Move(branch.GetEndLocation(), branch.GetOldEndLocation(), size);
+      end = branch.GetOldLocation();
+    }
+  }
+}
+
+void Riscv64Assembler::Beqz(XRegister rs, Riscv64Label* label) {
+  Beq(rs, Zero, label);
+}
+
+void Riscv64Assembler::Bnez(XRegister rs, Riscv64Label* label) {
+  Bne(rs, Zero, label);
+}
+
+void Riscv64Assembler::Blez(XRegister rs, Riscv64Label* label) {
+  Ble(rs, Zero, label);
+}
+
+void Riscv64Assembler::Bgez(XRegister rs, Riscv64Label* label) {
+  Bge(rs, Zero, label);
+}
+
+void Riscv64Assembler::Bltz(XRegister rs, Riscv64Label* label) {
+  Blt(rs, Zero, label);
+}
+
+void Riscv64Assembler::Bgtz(XRegister rs, Riscv64Label* label) {
+  Bgt(rs, Zero, label);
+}
+
+void Riscv64Assembler::Beq(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondEQ, rs, rt);
+}
+
+void Riscv64Assembler::Bne(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondNE, rs, rt);
+}
+
+void Riscv64Assembler::Ble(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondGE, rt, rs);
+}
+
+void Riscv64Assembler::Bge(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondGE, rs, rt);
+}
+
+void Riscv64Assembler::Blt(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondLT, rs, rt);
+}
+
+void Riscv64Assembler::Bgt(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondLT, rt, rs);
+}
+
+void Riscv64Assembler::Bleu(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondGEU, rt, rs);
+}
+
+void Riscv64Assembler::Bgeu(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondGEU, rs, rt);
+}
+
+void Riscv64Assembler::Bltu(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondLTU, rs, rt);
+}
+
+void Riscv64Assembler::Bgtu(XRegister rs, XRegister rt, Riscv64Label* label) {
+  Bcond(label, kCondLTU, rt, rs);
+}
+
+void Riscv64Assembler::Jal(XRegister rd, Riscv64Label* label) {
+  Buncond(label, rd);
+}
+
+void Riscv64Assembler::J(Riscv64Label* label) {
+  Jal(Zero, label);
+}
+
+void Riscv64Assembler::Jal(Riscv64Label* label) {
+  Jal(RA, label);
+}
 
 /////////////////////////////// RV64 VARIANTS extension end ////////////
 
@@ -18,12 +18,14 @@
 #define ART_COMPILER_UTILS_RISCV64_ASSEMBLER_RISCV64_H_
 
 #include <cstdint>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "arch/riscv64/instruction_set_features_riscv64.h"
 #include "base/arena_containers.h"
+#include "base/casts.h"
 #include "base/enums.h"
 #include "base/globals.h"
 #include "base/macros.h"
@@ -44,19 +46,112 @@ enum class FPRoundingMode : uint32_t {
   kDefault = kDYN
 };
 
+// Ordering bits of the atomic memory operations (the "aq" and "rl" bits of RV32A/RV64A).
+enum class AqRl : uint32_t {
+  kNone    = 0x0,
+  kRelease = 0x1,
+  kAcquire = 0x2,
+  kAqRl    = kRelease | kAcquire
+};
+
+// Mask field of the vector instructions ("vm" bit). Masked instructions use V0 as the mask.
+enum class VM : uint32_t {
+  kV0_t     = 0x0,
+  kUnmasked = 0x1
+};
+
+// Selected element width of the vector `vtype` ("vsew" field).
+enum class SelectedElementWidth : uint32_t {
+  kE8  = 0x0,
+  kE16 = 0x1,
+  kE32 = 0x2,
+  kE64 = 0x3
+};
+
+// Vector register group multiplier of the vector `vtype` ("vlmul" field).
+enum class LengthMultiplier : uint32_t {
+  kM1Over8 = 0x5,
+  kM1Over4 = 0x6,
+  kM1Over2 = 0x7,
+  kM1      = 0x0,
+  kM2      = 0x1,
+  kM4      = 0x2,
+  kM8      = 0x3
+};
+
+// Tail and mask policies of the vector `vtype` ("vta" and "vma" fields).
+enum class VectorTailPolicy : uint32_t {
+  kUndisturbed = 0x0,
+  kAgnostic    = 0x1
+};
+
+enum class VectorMaskPolicy : uint32_t {
+  kUndisturbed = 0x0,
+  kAgnostic    = 0x1
+};
+
+// Encode the `vtypei` immediate of VSETVLI/VSETIVLI.
+constexpr uint32_t VTypeiValue(VectorMaskPolicy vma,
+                               VectorTailPolicy vta,
+                               SelectedElementWidth sew,
+                               LengthMultiplier lmul) {
+  return static_cast<uint32_t>(vma) << 7 | static_cast<uint32_t>(vta) << 6 |
+         static_cast<uint32_t>(sew) << 3 | static_cast<uint32_t>(lmul);
+}
+
+// Vector fixed-point rounding mode CSR and its values.
+static constexpr uint32_t kCsrVxrm = 0x00a;
+static constexpr uint32_t kVxrmRnu = 0x0;  // Round-to-nearest-up (add +0.5 LSB)
+static constexpr uint32_t kVxrmRdn = 0x2;  // Round-down (truncate)
+
 static constexpr size_t kRiscv64HalfwordSize = 2;
 static constexpr size_t kRiscv64WordSize = 4;
 static constexpr size_t kRiscv64DoublewordSize = 8;
 
+// Predecessor/successor sets of the FENCE instruction.
+static constexpr uint32_t kFenceWrite = 0x1;
+static constexpr uint32_t kFenceRead = 0x2;
+static constexpr uint32_t kFenceReadWrite = kFenceRead | kFenceWrite;
+
+// Scratch registers reserved for the assembler and the code generator.
+static constexpr XRegister TMP = T6;
+static constexpr XRegister TMP2 = T5;
+
 class Riscv64Label : public Label {
+ public:
+  Riscv64Label() : prev_branch_id_(kNoPrevBranchId) {}
+
+  Riscv64Label(Riscv64Label&& src) noexcept
+      : Label(std::move(src)), prev_branch_id_(src.prev_branch_id_) {}
+
+ private:
+  static constexpr uint32_t kNoPrevBranchId = std::numeric_limits<uint32_t>::max();
+
+  uint32_t prev_branch_id_;  // To get distance from preceding branch, if any.
+
+  friend class Riscv64Assembler;
+  DISALLOW_COPY_AND_ASSIGN(Riscv64Label);
 };
 
+class ScopedNoCompression;
+
 class Riscv64Assembler final : public Assembler {
  public:
   explicit Riscv64Assembler(ArenaAllocator* allocator,
                             const Riscv64InstructionSetFeatures* instruction_set_features = nullptr)
-      : Assembler(allocator) {
-    UNUSED(instruction_set_features);
+      : Assembler(allocator),
+        branches_(allocator->Adapter(kArenaAllocAssembler)),
+        overwriting_(false),
+        overwrite_location_(0),
+        last_position_adjustment_(0),
+        last_old_position_(0),
+        last_branch_id_(0),
+        has_zba_(instruction_set_features != nullptr && instruction_set_features->HasZba()),
+        has_zbb_(instruction_set_features != nullptr && instruction_set_features->HasZbb()),
+        has_zbs_(instruction_set_features != nullptr && instruction_set_features->HasZbs()),
+        has_c_(instruction_set_features != nullptr && instruction_set_features->HasCompressed()),
+        compression_enabled_(has_c_) {
+    cfi().DelayEmittingAdvancePCs();
   }
 
   virtual ~Riscv64Assembler() {
@@ -65,6 +160,17 @@ class Riscv64Assembler final : public Assembler {
   size_t CodeSize() const override { return Assembler::CodeSize(); }
   DebugFrameOpCodeWriterForAssembler& cfi() { return Assembler::cfi(); }
 
+  // Enabled bit-manipulation extensions. The pseudo instructions below use them when available.
+  bool HasZba() const { return has_zba_; }
+  bool HasZbb() const { return has_zbb_; }
+  bool HasZbs() const { return has_zbs_; }
+
+  // Whether the C extension is available. If it is, instructions with a compressed equivalent
+  // are emitted in the 16-bit form, unless disabled in the scope of a `ScopedNoCompression`.
+  // Branches with raw offsets are never compressed; branches to labels are, when in range.
+  bool HasCompressed() const { return has_c_; }
+  bool IsCompressionEnabled() const { return compression_enabled_; }
+
   // According to "The RISC-V Instruction Set Manual"
 
   // LUI/AUIPC (RV32I, with sign-extension on RV64I), opcode = 0x17, 0x37
@@ -136,6 +242,13 @@ class Riscv64Assembler final : public Assembler {
   void Srlw(XRegister rd, XRegister rs1, XRegister rs2);
   void Sraw(XRegister rd, XRegister rs1, XRegister rs2);
 
+  // Memory ordering instruction (RV32I): opcode = 0x0f, funct3 = 0x0
+  void Fence(uint32_t pred = kFenceReadWrite, uint32_t succ = kFenceReadWrite);
+
+  // Environment call and breakpoint (RV32I), opcode = 0x73
+  void Ecall();
+  void Ebreak();
+
   // RV32M Standard Extension: opcode = 0x33, funct3 from 0x0 ~ 0x7
   void Mul(XRegister rd, XRegister rs1, XRegister rs2);
   void Mulh(XRegister rd, XRegister rs1, XRegister rs2);
@@ -153,6 +266,30 @@ class Riscv64Assembler final : public Assembler {
   void Remw(XRegister rd, XRegister rs1, XRegister rs2);
   void Remuw(XRegister rd, XRegister rs1, XRegister rs2);
 
+  // RV32A/RV64A Standard Extension: opcode = 0x2f, funct3 = 0x2 (W) or 0x3 (D)
+  void LrW(XRegister rd, XRegister rs1, AqRl aqrl);
+  void LrD(XRegister rd, XRegister rs1, AqRl aqrl);
+  void ScW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void ScD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoSwapW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoSwapD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoAddW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoAddD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoXorW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoXorD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoAndW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoAndD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoOrW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoOrD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMinW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMinD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMaxW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMaxD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMinuW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMinuD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMaxuW(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+  void AmoMaxuD(XRegister rd, XRegister rs2, XRegister rs1, AqRl aqrl);
+
   // FP load/store instructions (RV32F+RV32D): opcode = 0x07, 0x27
   void FLw(FRegister rd, XRegister rs1, int32_t offset);
   void FLd(FRegister rd, XRegister rs1, int32_t offset);
@@ -311,10 +448,248 @@ class Riscv64Assembler final : public Assembler {
   void FClassS(XRegister rd, FRegister rs1);
   void FClassD(XRegister rd, FRegister rs1);
 
+  // CSR instructions (Zicsr): opcode = 0x73, funct3 from 0x1 ~ 0x3 and 0x5 ~ 0x7
+  void Csrrw(XRegister rd, uint32_t csr, XRegister rs1);
+  void Csrrs(XRegister rd, uint32_t csr, XRegister rs1);
+  void Csrrc(XRegister rd, uint32_t csr, XRegister rs1);
+  void Csrrwi(XRegister rd, uint32_t csr, uint32_t uimm5);
+  void Csrrsi(XRegister rd, uint32_t csr, uint32_t uimm5);
+  void Csrrci(XRegister rd, uint32_t csr, uint32_t uimm5);
+
+  ////////////////////////////// RV64 "Zb" Instructions  START ///////////////////////////////
+  // Bit-manipulation extensions, version 1.0. These must be used only if the corresponding
+  // extension is enabled in the instruction set features, see `HasZba()` and friends.
+
+  // "Zba" address generation instructions: opcode = 0x33 or 0x3b (for *.uw), funct7 = 0x10
+  void AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh1Add(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh1AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh2Add(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh2AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh3Add(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh3AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void SlliUw(XRegister rd, XRegister rs1, int32_t shamt);
+
+  // "Zbb" basic bit-manipulation instructions: opcode = 0x13, 0x1b, 0x33 or 0x3b
+  void Andn(XRegister rd, XRegister rs1, XRegister rs2);
+  void Orn(XRegister rd, XRegister rs1, XRegister rs2);
+  void Xnor(XRegister rd, XRegister rs1, XRegister rs2);
+  void Clz(XRegister rd, XRegister rs1);
+  void Clzw(XRegister rd, XRegister rs1);
+  void Ctz(XRegister rd, XRegister rs1);
+  void Ctzw(XRegister rd, XRegister rs1);
+  void Cpop(XRegister rd, XRegister rs1);
+  void Cpopw(XRegister rd, XRegister rs1);
+  void Min(XRegister rd, XRegister rs1, XRegister rs2);
+  void Minu(XRegister rd, XRegister rs1, XRegister rs2);
+  void Max(XRegister rd, XRegister rs1, XRegister rs2);
+  void Maxu(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rol(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rolw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Ror(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rorw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rori(XRegister rd, XRegister rs1, int32_t shamt);
+  void Roriw(XRegister rd, XRegister rs1, int32_t shamt);
+  void OrcB(XRegister rd, XRegister rs1);
+  void Rev8(XRegister rd, XRegister rs1);
+  // The `Zbb` prefix distinguishes these from the base ISA pseudo instructions.
+  void ZbbSextB(XRegister rd, XRegister rs1);
+  void ZbbSextH(XRegister rd, XRegister rs1);
+  void ZbbZextH(XRegister rd, XRegister rs1);
+
+  // "Zbs" single-bit instructions: opcode = 0x13 or 0x33, funct3 = 0x1 or 0x5
+  void Bclr(XRegister rd, XRegister rs1, XRegister rs2);
+  void Bclri(XRegister rd, XRegister rs1, int32_t shamt);
+  void Bext(XRegister rd, XRegister rs1, XRegister rs2);
+  void Bexti(XRegister rd, XRegister rs1, int32_t shamt);
+  void Binv(XRegister rd, XRegister rs1, XRegister rs2);
+  void Binvi(XRegister rd, XRegister rs1, int32_t shamt);
+  void Bset(XRegister rd, XRegister rs1, XRegister rs2);
+  void Bseti(XRegister rd, XRegister rs1, int32_t shamt);
+
+  /////////////////////////////// RV64 "Zb" Instructions  END ///////////////////////////////
+
+  /////////////////////////////// RV64 "V" Instructions  START ///////////////////////////////
+  // "V" Standard Extension for Vector Operations, version 1.0.
+  // Operands follow the assembly syntax, for example `VAdd_vv(vd, vs2, vs1)` is
+  // `vadd.vv vd, vs2, vs1`, except for the multiply-add instructions that take `vs1`
+  // (or the scalar) before `vs2`, as in `vmacc.vv vd, vs1, vs2`.
+
+  // Vector configuration-setting instructions: opcode = 0x57, funct3 = 0x7
+  void VSetvli(XRegister rd, XRegister rs1, uint32_t vtypei);
+  void VSetivli(XRegister rd, uint32_t uimm5, uint32_t vtypei);
+  void VSetvl(XRegister rd, XRegister rs1, XRegister rs2);
+
+  // Vector unit-stride loads and stores: opcode = 0x07, 0x27
+  void VLe8(VRegister vd, XRegister rs1, VM vm = VM::kUnmasked);
+  void VLe16(VRegister vd, XRegister rs1, VM vm = VM::kUnmasked);
+  void VLe32(VRegister vd, XRegister rs1, VM vm = VM::kUnmasked);
+  void VLe64(VRegister vd, XRegister rs1, VM vm = VM::kUnmasked);
+  void VSe8(VRegister vs3, XRegister rs1, VM vm = VM::kUnmasked);
+  void VSe16(VRegister vs3, XRegister rs1, VM vm = VM::kUnmasked);
+  void VSe32(VRegister vs3, XRegister rs1, VM vm = VM::kUnmasked);
+  void VSe64(VRegister vs3, XRegister rs1, VM vm = VM::kUnmasked);
+
+  // Vector whole register loads and stores, independent of `vtype`.
+  void VL1re8(VRegister vd, XRegister rs1);
+  void VS1r(VRegister vs3, XRegister rs1);
+
+  // Vector integer instructions with OPIVV, OPIVI and OPIVX: opcode = 0x57, funct3 = 0x0, 0x3, 0x4
+  void VAdd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VAdd_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VAdd_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm = VM::kUnmasked);
+  void VSub_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VSub_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VRsub_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VRsub_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm = VM::kUnmasked);
+  void VMinu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VMin_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VMaxu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VMax_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VAnd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VAnd_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VAnd_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm = VM::kUnmasked);
+  void VOr_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VOr_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VOr_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm = VM::kUnmasked);
+  void VXor_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VXor_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VXor_vi(VRegister vd, VRegister vs2, int32_t imm5, VM vm = VM::kUnmasked);
+  void VSaddu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VSadd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VSsubu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VSsub_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VSll_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VSll_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm = VM::kUnmasked);
+  void VSrl_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VSrl_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm = VM::kUnmasked);
+  void VSra_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VSra_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm = VM::kUnmasked);
+  void VSlidedown_vi(VRegister vd, VRegister vs2, uint32_t uimm5, VM vm = VM::kUnmasked);
+
+  // Vector integer compare instructions, writing a mask to `vd`.
+  void VMseq_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VMseq_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VMsne_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VMsne_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+
+  // Vector integer move instructions (unmasked).
+  void VMv_vv(VRegister vd, VRegister vs1);
+  void VMv_vx(VRegister vd, XRegister rs1);
+  void VMv_vi(VRegister vd, int32_t imm5);
+  void VMv1r_v(VRegister vd, VRegister vs2);
+
+  // Vector integer instructions with OPMVV and OPMVX: opcode = 0x57, funct3 = 0x2, 0x6
+  void VRedsum_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VRedminu_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VRedmin_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VRedmaxu_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VRedmax_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VAaddu_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VAadd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VMul_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VMul_vx(VRegister vd, VRegister vs2, XRegister rs1, VM vm = VM::kUnmasked);
+  void VMacc_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm = VM::kUnmasked);
+  void VNmsac_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm = VM::kUnmasked);
+  // Integer extensions of the low 1/2, 1/4 or 1/8 of `vs2` to SEW; `vd` must not overlap `vs2`.
+  void VZext_vf2(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VSext_vf2(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VZext_vf4(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VSext_vf4(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VZext_vf8(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VSext_vf8(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VMv_xs(XRegister rd, VRegister vs2);
+  void VMv_sx(VRegister vd, XRegister rs1);
+  // Mask population count and find-first-set, -1 if no mask bit is set.
+  void VCpop_m(XRegister rd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VFirst_m(XRegister rd, VRegister vs2, VM vm = VM::kUnmasked);
+
+  // Vector floating-point instructions with OPFVV and OPFVF: opcode = 0x57, funct3 = 0x1, 0x5
+  void VFAdd_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFAdd_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm = VM::kUnmasked);
+  void VFSub_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFSub_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm = VM::kUnmasked);
+  void VFMul_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFMul_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm = VM::kUnmasked);
+  void VFDiv_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFDiv_vf(VRegister vd, VRegister vs2, FRegister fs1, VM vm = VM::kUnmasked);
+  void VFMin_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFMax_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFSgnj_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFSgnjn_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFSgnjx_vv(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFMacc_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm = VM::kUnmasked);
+  void VFNmsac_vv(VRegister vd, VRegister vs1, VRegister vs2, VM vm = VM::kUnmasked);
+  void VFRedusum_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFRedmin_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFRedmax_vs(VRegister vd, VRegister vs2, VRegister vs1, VM vm = VM::kUnmasked);
+  void VFCvt_f_x_v(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VFCvt_rtz_x_f_v(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VFMv_vf(VRegister vd, FRegister fs1);
+  void VFMv_fs(FRegister fd, VRegister vs2);
+  void VFMv_sf(VRegister vd, FRegister fs1);
+
+  /////////////////////////////// RV64 "V" Instructions  END ///////////////////////////////
+
+  ////////////////////////////// RV64 "C" Instructions  START ///////////////////////////////
+  // Explicit 16-bit encodings, see `HasCompressed()`. Registers named `*_s` must be one
+  // of the x8-x15 (f8-f15) registers addressable by the 3-bit register fields.
+
+  // Stack-pointer-based loads and stores, opcode = 0x2
+  void CLwsp(XRegister rd, int32_t offset);
+  void CLdsp(XRegister rd, int32_t offset);
+  void CFLdsp(FRegister rd, int32_t offset);
+  void CSwsp(XRegister rs2, int32_t offset);
+  void CSdsp(XRegister rs2, int32_t offset);
+  void CFSdsp(FRegister rs2, int32_t offset);
+
+  // Register-based loads and stores, opcode = 0x0
+  void CLw(XRegister rd_s, XRegister rs1_s, int32_t offset);
+  void CLd(XRegister rd_s, XRegister rs1_s, int32_t offset);
+  void CFLd(FRegister rd_s, XRegister rs1_s, int32_t offset);
+  void CSw(XRegister rs2_s, XRegister rs1_s, int32_t offset);
+  void CSd(XRegister rs2_s, XRegister rs1_s, int32_t offset);
+  void CFSd(FRegister rs2_s, XRegister rs1_s, int32_t offset);
+
+  // Constant generation and register-immediate operations, opcode = 0x0, 0x1, 0x2
+  void CLi(XRegister rd, int32_t imm);
+  void CLui(XRegister rd, uint32_t nzimm20);
+  void CAddi(XRegister rd, int32_t nzimm);
+  void CAddiw(XRegister rd, int32_t imm);
+  void CAddi16Sp(int32_t nzimm);
+  void CAddi4Spn(XRegister rd_s, uint32_t nzuimm);
+  void CSlli(XRegister rd, int32_t shamt);
+  void CSrli(XRegister rd_s, int32_t shamt);
+  void CSrai(XRegister rd_s, int32_t shamt);
+  void CAndi(XRegister rd_s, int32_t imm);
+
+  // Register-register operations, opcode = 0x1, 0x2
+  void CMv(XRegister rd, XRegister rs2);
+  void CAdd(XRegister rd, XRegister rs2);
+  void CAnd(XRegister rd_s, XRegister rs2_s);
+  void COr(XRegister rd_s, XRegister rs2_s);
+  void CXor(XRegister rd_s, XRegister rs2_s);
+  void CSub(XRegister rd_s, XRegister rs2_s);
+  void CAddw(XRegister rd_s, XRegister rs2_s);
+  void CSubw(XRegister rd_s, XRegister rs2_s);
+
+  // Control transfer instructions, opcode = 0x1, 0x2
+  void CJ(int32_t offset);
+  void CJr(XRegister rs1);
+  void CJalr(XRegister rs1);
+  void CBeqz(XRegister rs1_s, int32_t offset);
+  void CBnez(XRegister rs1_s, int32_t offset);
+
+  void CEbreak();
+  void CNop();
+
+  /////////////////////////////// RV64 "C" Instructions  END ///////////////////////////////
+
   ////////////////////////////// RV64 MACRO Instructions  START ///////////////////////////////
   // These pseudo instructions are from "RISC-V Assembly Programmer's Manual".
 
   void Nop();
+  void Unimp();
   void Mv(XRegister rd, XRegister rs);
   void Not(XRegister rd, XRegister rs);
   void Neg(XRegister rd, XRegister rs);
@@ -336,6 +711,17 @@ class Riscv64Assembler final : public Assembler {
   void FAbsD(FRegister rd, FRegister rs);
   void FNegD(FRegister rd, FRegister rs);
 
+  // Vector pseudo instructions.
+  void VNot_v(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VNeg_v(VRegister vd, VRegister vs2, VM vm = VM::kUnmasked);
+  void VFNeg_v(VRegister vd, VRegister vs);
+  void VFAbs_v(VRegister vd, VRegister vs);
+
+  // CSR pseudo instructions.
+  void Csrr(XRegister rd, uint32_t csr);
+  void Csrw(uint32_t csr, XRegister rs);
+  void Csrwi(uint32_t csr, uint32_t uimm5);
+
   // Branch pseudo instructions
   void Beqz(XRegister rs, int32_t offset);
   void Bnez(XRegister rs, int32_t offset);
@@ -356,19 +742,93 @@ class Riscv64Assembler final : public Assembler {
   void Jalr(XRegister rd, XRegister rs);
   void Ret();
 
+  // Load an arbitrary 64-bit constant, using the shortest sequence of LUI, ADDI(W) and SLLI.
+  void Li(XRegister rd, int64_t imm);
+
   /////////////////////////////// RV64 MACRO Instructions END ///////////////////////////////
 
-  void Bind(Label* label ATTRIBUTE_UNUSED) override {
-    UNIMPLEMENTED(FATAL) << "TODO: Support branches.";
+  // Branches and jumps to labels. These are emitted as placeholders and get their final
+  // form (short, medium or long, depending on the distance to the target) in FinalizeCode().
+  void Beqz(XRegister rs, Riscv64Label* label);
+  void Bnez(XRegister rs, Riscv64Label* label);
+  void Blez(XRegister rs, Riscv64Label* label);
+  void Bgez(XRegister rs, Riscv64Label* label);
+  void Bltz(XRegister rs, Riscv64Label* label);
+  void Bgtz(XRegister rs, Riscv64Label* label);
+  void Beq(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Bne(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Ble(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Bge(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Blt(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Bgt(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Bleu(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Bgeu(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Bltu(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Bgtu(XRegister rs, XRegister rt, Riscv64Label* label);
+  void Jal(XRegister rd, Riscv64Label* label);
+  void J(Riscv64Label* label);
+  void Jal(Riscv64Label* label);
+
+  // Loads and stores with arbitrary 32-bit offsets. Offsets that do not fit into the 12-bit
+  // immediate are materialized in TMP, so `rs1` must not be TMP in that case.
+  void Loadb(XRegister rd, XRegister rs1, int32_t offset);
+  void Loadh(XRegister rd, XRegister rs1, int32_t offset);
+  void Loadw(XRegister rd, XRegister rs1, int32_t offset);
+  void Loadd(XRegister rd, XRegister rs1, int32_t offset);
+  void Loadbu(XRegister rd, XRegister rs1, int32_t offset);
+  void Loadhu(XRegister rd, XRegister rs1, int32_t offset);
+  void Loadwu(XRegister rd, XRegister rs1, int32_t offset);
+  void Storeb(XRegister rs2, XRegister rs1, int32_t offset);
+  void Storeh(XRegister rs2, XRegister rs1, int32_t offset);
+  void Storew(XRegister rs2, XRegister rs1, int32_t offset);
+  void Stored(XRegister rs2, XRegister rs1, int32_t offset);
+  void FLoadw(FRegister rd, XRegister rs1, int32_t offset);
+  void FLoadd(FRegister rd, XRegister rs1, int32_t offset);
+  void FStorew(FRegister rs2, XRegister rs1, int32_t offset);
+  void FStored(FRegister rs2, XRegister rs1, int32_t offset);
+
+  // Add an arbitrary constant. Uses TMP if the constant does not fit into 12 bits.
+  void AddConst32(XRegister rd, XRegister rs1, int32_t value);
+  void AddConst64(XRegister rd, XRegister rs1, int64_t value);
+
+  //
+  // Heap poisoning.
+  //
+
+  // Poison a heap reference contained in `reg`.
+  void PoisonHeapReference(XRegister reg);
+  // Unpoison a heap reference contained in `reg`.
+  void UnpoisonHeapReference(XRegister reg);
+  // Poison a heap reference contained in `reg` if heap poisoning is enabled.
+  void MaybePoisonHeapReference(XRegister reg);
+  // Unpoison a heap reference contained in `reg` if heap poisoning is enabled.
+  void MaybeUnpoisonHeapReference(XRegister reg);
+
+  void Bind(Label* label) override {
+    Bind(down_cast<Riscv64Label*>(label));
   }
-  void Jump(Label* label ATTRIBUTE_UNUSED) override {
-    UNIMPLEMENTED(FATAL) << "Do not use Jump for RISCV64";
+  void Jump(Label* label) override {
+    J(down_cast<Riscv64Label*>(label));
   }
 
+  void Bind(Riscv64Label* label);
+
+  // Get the final position of a label after local fixup based on the old position
+  // recorded before FinalizeCode().
+  uint32_t GetLabelLocation(const Riscv64Label* label) const;
+
+  // Get the final position of a bound label (or any other position) after branch
+  // promotion in FinalizeCode(). Positions passed in must be increasing for best
+  // performance; each call costs amortized O(1) over a sequence of increasing positions.
+  uint32_t GetAdjustedPosition(uint32_t old_position);
+
  public:
   // Emit data (e.g. encoded instruction or immediate) to the instruction stream.
   void Emit(uint32_t value);
 
+  // Emit a 16-bit compressed instruction to the instruction stream.
+  void Emit16(uint32_t value);
+
   // Emit slow paths queued during assembly and promote short branches to long if needed.
   void FinalizeCode() override;
 
@@ -376,6 +836,193 @@ class Riscv64Assembler final : public Assembler {
   void FinalizeInstructions(const MemoryRegion& region) override;
 
  private:
+  enum BranchCondition : uint8_t {
+    kCondEQ,
+    kCondNE,
+    kCondLT,
+    kCondGE,
+    kCondLTU,
+    kCondGEU,
+    kUncond,
+  };
+
+  class Branch {
+   public:
+    enum Type : uint8_t {
+      // C.BEQZ/C.BNEZ with a 9-bit offset (+-256B).
+      kCondCBranch,
+      // B<cond> with a 13-bit offset (+-4KiB).
+      kCondBranch,
+      // Inverted C.BEQZ/C.BNEZ skipping a JAL with a 21-bit offset (+-1MiB).
+      kCondCBranch21,
+      // Inverted B<cond> skipping a JAL with a 21-bit offset (+-1MiB).
+      kCondBranch21,
+      // Inverted C.BEQZ/C.BNEZ skipping an AUIPC+JALR pair with a 32-bit offset.
+      kLongCondCBranch,
+      // Inverted B<cond> skipping an AUIPC+JALR pair with a 32-bit offset.
+      kLongCondBranch,
+      // C.J with a 12-bit offset (+-2KiB).
+      kUncondCBranch,
+      // JAL with a 21-bit offset (+-1MiB).
+      kUncondBranch,
+      // AUIPC+JALR with a 32-bit offset.
+      kLongUncondBranch,
+    };
+
+    // Bit sizes of offsets defined as enums to minimize chance of typos.
+    enum OffsetBits {
+      kOffset9 = 9,
+      kOffset12 = 12,
+      kOffset13 = 13,
+      kOffset21 = 21,
+      kOffset32 = 32,
+    };
+
+    static constexpr uint32_t kUnresolved = 0xffffffff;  // Unresolved target_
+    static constexpr uint32_t kMaxBranchLength = 3 * sizeof(uint32_t);
+
+    struct BranchInfo {
+      // Branch length in bytes.
+      uint32_t length;
+      // The offset in bytes of the PC used in the (only) PC-relative instruction from
+      // the start of the branch sequence.
+      uint32_t pc_offset;
+      // How large (in bits) a PC-relative offset can be for a given type of branch.
+      OffsetBits offset_size;
+    };
+    static const BranchInfo branch_info_[/* Type */];
+
+    // Unconditional branch or call. The compressed types are used only if `compression_enabled`.
+    Branch(uint32_t location, uint32_t target, XRegister rd, bool compression_enabled);
+    // Conditional branch.
+    Branch(uint32_t location,
+           uint32_t target,
+           BranchCondition condition,
+           XRegister lhs_reg,
+           XRegister rhs_reg,
+           bool compression_enabled);
+
+    // Some conditional branches with lhs = rhs are effectively NOPs, while some
+    // others are effectively unconditional.
+    static bool IsNop(BranchCondition condition, XRegister lhs, XRegister rhs);
+    static bool IsUncond(BranchCondition condition, XRegister lhs, XRegister rhs);
+
+    static BranchCondition OppositeCondition(BranchCondition cond);
+
+    // Whether the branch can use C.BEQZ/C.BNEZ or C.J, i.e. compares a register
+    // in x8-x15 for (in)equality with zero or is an unconditional jump without a link.
+    static bool IsCompressible(BranchCondition condition, XRegister lhs, XRegister rhs);
+
+    Type GetType() const { return type_; }
+    BranchCondition GetCondition() const { return condition_; }
+    XRegister GetLeftRegister() const { return lhs_reg_; }
+    XRegister GetRightRegister() const { return rhs_reg_; }
+    uint32_t GetTarget() const { return target_; }
+    uint32_t GetLocation() const { return location_; }
+    uint32_t GetOldLocation() const { return old_location_; }
+    uint32_t GetLength() const { return branch_info_[type_].length; }
+    uint32_t GetOldLength() const { return branch_info_[old_type_].length; }
+    uint32_t GetEndLocation() const { return GetLocation() + GetLength(); }
+    uint32_t GetOldEndLocation() const { return GetOldLocation() + GetOldLength(); }
+    bool IsResolved() const { return target_ != kUnresolved; }
+
+    // The link to the preceding branch in the list of unresolved branches to the same label,
+    // in the `Label::position_` encoding (the first branch in the list holds 0).
+    uint32_t GetPrevLinkedBranch() const { return prev_linked_branch_; }
+    void SetPrevLinkedBranch(uint32_t link) { prev_linked_branch_ = link; }
+
+    // Returns the bit size of the signed offset that the branch instruction can handle.
+    OffsetBits GetOffsetSize() const { return branch_info_[type_].offset_size; }
+
+    // Resolve a branch when the target is known.
+    void Resolve(uint32_t target);
+
+    // Relocate a branch by a given delta if needed due to expansion of this or another
+    // branch at a given location by this delta (just changes location_ and target_).
+    void Relocate(uint32_t expand_location, uint32_t delta);
+
+    // If necessary, updates the type by promoting a short branch to a longer branch
+    // based on the branch location and target. Returns the amount (in bytes) by
+    // which the branch size has increased.
+    uint32_t PromoteIfNeeded();
+
+    // Returns the offset into assembler buffer that shall be used as the base PC for
+    // offset calculation. RISC-V always uses the address of the PC-relative instruction
+    // as the base, possibly after an inverted conditional branch.
+    uint32_t GetOffsetLocation() const;
+
+    // Calculates and returns the offset ready for encoding in the branch instruction(s).
+    int32_t GetOffset() const;
+
+   private:
+    // Completes branch construction by determining and recording its type.
+    void InitializeType(Type initial_type);
+
+    uint32_t old_location_;  // Offset into assembler buffer in bytes.
+    uint32_t location_;      // Offset into assembler buffer in bytes.
+    uint32_t target_;        // Offset into assembler buffer in bytes.
+
+    XRegister lhs_reg_;          // Left-hand side register in conditional branches or
+                                 // destination register in calls.
+    XRegister rhs_reg_;          // Right-hand side register in conditional branches.
+    BranchCondition condition_;  // Condition for conditional branches.
+    bool compressible_;          // Whether the compressed branch types can be used.
+
+    Type type_;      // Current type of the branch.
+    Type old_type_;  // Initial type of the branch.
+
+    uint32_t prev_linked_branch_;  // See `GetPrevLinkedBranch()`.
+  };
+
+  void EmitBcond(BranchCondition cond, XRegister rs, XRegister rt, int32_t offset);
+  void EmitCBcond(BranchCondition cond, XRegister rs, int32_t offset);
+  void Bcond(Riscv64Label* label, BranchCondition condition, XRegister lhs, XRegister rhs);
+  void Buncond(Riscv64Label* label, XRegister rd);
+  void FinalizeLabeledBranch(Riscv64Label* label);
+  Branch* GetBranch(uint32_t branch_id);
+  const Branch* GetBranch(uint32_t branch_id) const;
+
+  void PromoteBranches();
+  void EmitBranch(Branch* branch);
+  void EmitBranches();
+  void PatchCFI();
+
+  // Emit a load or store, materializing the high part of the offset in TMP if needed.
+  template <void (Riscv64Assembler::*insn)(XRegister, XRegister, int32_t)>
+  void LoadFromOffset(XRegister rd, XRegister rs1, int32_t offset);
+  template <void (Riscv64Assembler::*insn)(XRegister, XRegister, int32_t)>
+  void StoreToOffset(XRegister rs2, XRegister rs1, int32_t offset);
+  template <void (Riscv64Assembler::*insn)(FRegister, XRegister, int32_t)>
+  void FLoadFromOffset(FRegister rd, XRegister rs1, int32_t offset);
+  template <void (Riscv64Assembler::*insn)(FRegister, XRegister, int32_t)>
+  void FStoreToOffset(FRegister rs2, XRegister rs1, int32_t offset);
+
+  // Split `offset` into a base adjustment (added to `rs1` in TMP) and a 12-bit remainder
+  // and return the register to use as the base (`rs1` if no adjustment was needed).
+  XRegister AdjustBaseAndOffset(XRegister rs1, int32_t* offset);
+
+  ArenaVector<Branch> branches_;
+
+  // Whether appending instructions at the end of the buffer or overwriting the existing ones.
+  bool overwriting_;
+  // The current overwrite location.
+  uint32_t overwrite_location_;
+
+  // Data for GetAdjustedPosition(), see the description there.
+  uint32_t last_position_adjustment_;
+  uint32_t last_old_position_;
+  uint32_t last_branch_id_;
+
+  // Enabled bit-manipulation extensions.
+  const bool has_zba_;
+  const bool has_zbb_;
+  const bool has_zbs_;
+
+  // Whether the C extension is available and whether it is currently used for
+  // the automatic compression of instructions (see `ScopedNoCompression`).
+  const bool has_c_;
+  bool compression_enabled_;
+
   template <typename Reg1, typename Reg2>
   void EmitI(int32_t imm12, Reg1 rs1, uint32_t funct3, Reg2 rd, uint32_t opcode) {
     DCHECK(IsInt<12>(imm12)) << imm12;
@@ -491,11 +1138,154 @@ class Riscv64Assembler final : public Assembler {
     Emit(encoding);
   }
 
+  // Convert a 12-bit unsigned field (such as a CSR number) to the signed `imm12` of EmitI().
+  static int32_t ToInt12(uint32_t uint12) {
+    DCHECK(IsUint<12>(uint12)) << uint12;
+    return static_cast<int32_t>(uint12) - static_cast<int32_t>((uint12 & 0x800u) << 1);
+  }
+
+  // Encode a signed 5-bit immediate for the `rs1` field of OPIVI vector instructions.
+  static uint32_t EncodeInt5(int32_t imm5) {
+    DCHECK(IsInt<5>(imm5)) << imm5;
+    return static_cast<uint32_t>(imm5) & 0x1fu;
+  }
+
+  // Vector arithmetic instructions use the R-type layout with `funct7 = funct6 << 1 | vm`.
+  static uint32_t EncodeRVVF7(uint32_t funct6, VM vm) {
+    DCHECK(IsUint<6>(funct6)) << funct6;
+    return funct6 << 1 | enum_cast<uint32_t>(vm);
+  }
+
+  // Compressed instructions with 3-bit register fields can only use x8-x15 (f8-f15).
+  template <typename Reg>
+  static bool IsShortReg(Reg reg) {
+    return static_cast<uint32_t>(reg) - 8u < 8u;
+  }
+
+  template <typename Reg>
+  static uint32_t EncodeShortReg(Reg reg) {
+    DCHECK(IsShortReg(reg)) << reg;
+    return static_cast<uint32_t>(reg) - 8u;
+  }
+
+  // The compressed formats below take their immediates already scattered into the bit order
+  // of the instruction fields; the C* instructions do the scattering.
+
+  // CR format: funct4 | rd/rs1 | rs2 | opcode
+  void EmitCR(uint32_t funct4, XRegister rd_rs1, XRegister rs2, uint32_t opcode) {
+    DCHECK(IsUint<4>(funct4));
+    DCHECK(IsUint<5>(static_cast<uint32_t>(rd_rs1)));
+    DCHECK(IsUint<5>(static_cast<uint32_t>(rs2)));
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct4 << 12 | static_cast<uint32_t>(rd_rs1) << 7 |
+                        static_cast<uint32_t>(rs2) << 2 | opcode;
+    Emit16(encoding);
+  }
+
+  // CI format: funct3 | imm[5] | rd/rs1 | imm[4:0] | opcode
+  template <typename Reg>
+  void EmitCI(uint32_t funct3, Reg rd_rs1, uint32_t imm6, uint32_t opcode) {
+    DCHECK(IsUint<3>(funct3));
+    DCHECK(IsUint<5>(static_cast<uint32_t>(rd_rs1)));
+    DCHECK(IsUint<6>(imm6)) << imm6;
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct3 << 13 | (imm6 & 0x20u) << (12 - 5) |
+                        static_cast<uint32_t>(rd_rs1) << 7 | (imm6 & 0x1fu) << 2 | opcode;
+    Emit16(encoding);
+  }
+
+  // CSS format: funct3 | imm[5:0] | rs2 | opcode
+  template <typename Reg>
+  void EmitCSS(uint32_t funct3, uint32_t imm6, Reg rs2, uint32_t opcode) {
+    DCHECK(IsUint<3>(funct3));
+    DCHECK(IsUint<6>(imm6)) << imm6;
+    DCHECK(IsUint<5>(static_cast<uint32_t>(rs2)));
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct3 << 13 | imm6 << 7 | static_cast<uint32_t>(rs2) << 2 | opcode;
+    Emit16(encoding);
+  }
+
+  // CIW format: funct3 | imm[7:0] | rd' | opcode
+  void EmitCIW(uint32_t funct3, uint32_t imm8, XRegister rd_s, uint32_t opcode) {
+    DCHECK(IsUint<3>(funct3));
+    DCHECK(IsUint<8>(imm8)) << imm8;
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct3 << 13 | imm8 << 5 | EncodeShortReg(rd_s) << 2 | opcode;
+    Emit16(encoding);
+  }
+
+  // CL and CS formats: funct3 | imm[4:2] | rs1' | imm[1:0] | rd'/rs2' | opcode
+  template <typename Reg>
+  void EmitCM(uint32_t funct3, uint32_t imm5, XRegister rs1_s, Reg rd_rs2_s, uint32_t opcode) {
+    DCHECK(IsUint<3>(funct3));
+    DCHECK(IsUint<5>(imm5)) << imm5;
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct3 << 13 | (imm5 & 0x1cu) << (10 - 2) | EncodeShortReg(rs1_s) << 7 |
+                        (imm5 & 0x3u) << 5 | EncodeShortReg(rd_rs2_s) << 2 | opcode;
+    Emit16(encoding);
+  }
+
+  // CA format: funct6 | rd'/rs1' | funct2 | rs2' | opcode
+  void EmitCA(uint32_t funct6,
+              XRegister rd_rs1_s,
+              uint32_t funct2,
+              XRegister rs2_s,
+              uint32_t opcode) {
+    DCHECK(IsUint<6>(funct6));
+    DCHECK(IsUint<2>(funct2));
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct6 << 10 | EncodeShortReg(rd_rs1_s) << 7 | funct2 << 5 |
+                        EncodeShortReg(rs2_s) << 2 | opcode;
+    Emit16(encoding);
+  }
+
+  // CB format: funct3 | imm[7:5] | rd'/rs1' | imm[4:0] | opcode
+  void EmitCB(uint32_t funct3, uint32_t imm8, XRegister rd_rs1_s, uint32_t opcode) {
+    DCHECK(IsUint<3>(funct3));
+    DCHECK(IsUint<8>(imm8)) << imm8;
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct3 << 13 | (imm8 & 0xe0u) << (10 - 5) | EncodeShortReg(rd_rs1_s) << 7 |
+                        (imm8 & 0x1fu) << 2 | opcode;
+    Emit16(encoding);
+  }
+
+  // CJ format: funct3 | jump target[10:0] | opcode
+  void EmitCJ(uint32_t funct3, uint32_t imm11, uint32_t opcode) {
+    DCHECK(IsUint<3>(funct3));
+    DCHECK(IsUint<11>(imm11)) << imm11;
+    DCHECK(IsUint<2>(opcode));
+    uint32_t encoding = funct3 << 13 | imm11 << 2 | opcode;
+    Emit16(encoding);
+  }
+
   static constexpr uint32_t kXlen = 64;
 
+  friend class ScopedNoCompression;
+
   DISALLOW_COPY_AND_ASSIGN(Riscv64Assembler);
 };
 
+// Disables the automatic emission of compressed instructions in its scope, for code sequences
+// that need a fixed layout, such as those patched after code generation. Explicitly emitted
+// compressed instructions are not affected.
+class ScopedNoCompression {
+ public:
+  explicit ScopedNoCompression(Riscv64Assembler* assembler)
+      : assembler_(assembler), old_compression_enabled_(assembler->compression_enabled_) {
+    assembler->compression_enabled_ = false;
+  }
+
+  ~ScopedNoCompression() {
+    assembler_->compression_enabled_ = old_compression_enabled_;
+  }
+
+ private:
+  Riscv64Assembler* const assembler_;
+  const bool old_compression_enabled_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedNoCompression);
+};
+
 }  // namespace riscv64
 }  // namespace art
 
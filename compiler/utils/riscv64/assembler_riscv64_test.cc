@@ -19,8 +19,11 @@
 #include <inttypes.h>
 
 #include <map>
+#include <sstream>
+#include <type_traits>
 
 #include "base/bit_utils.h"
+#include "base/string_view_cpp20.h"
 #include "utils/assembler_test.h"
 
 #define __ GetAssembler()->
@@ -43,10 +46,15 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
                              riscv64::FRegister,
                              uint32_t>;
 
+  // The default fixture tests the uncompressed encodings, see `AssemblerRISCV64CompressedTest`.
   AssemblerRISCV64Test()
-      : instruction_set_features_(Riscv64InstructionSetFeatures::FromVariant("default", nullptr)) {}
+      : AssemblerRISCV64Test(Riscv64InstructionSetFeatures::FromBitmap(
+            Riscv64InstructionSetFeatures::kExtGeneric)) {}
 
  protected:
+  explicit AssemblerRISCV64Test(Riscv64FeaturesUniquePtr instruction_set_features)
+      : instruction_set_features_(std::move(instruction_set_features)) {}
+
   riscv64::Riscv64Assembler* CreateAssembler(ArenaAllocator* allocator) override {
     return new (allocator) riscv64::Riscv64Assembler(allocator, instruction_set_features_.get());
   }
@@ -178,7 +186,204 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
 
   uint32_t CreateImmediate(int64_t imm_value) override { return imm_value; }
 
+  // Emit `f` for all `AqRl` orderings with a rotating selection of registers. Emitting all
+  // register combinations for every ordering would make the test unnecessarily slow.
+  template <typename EmitFn>
+  std::string RepeatAqRl(EmitFn&& emit_fn, const std::string& fmt) {
+    static constexpr std::pair<riscv64::AqRl, const char*> kAqRls[] = {
+        {riscv64::AqRl::kNone, ""},
+        {riscv64::AqRl::kRelease, ".rl"},
+        {riscv64::AqRl::kAcquire, ".aq"},
+        {riscv64::AqRl::kAqRl, ".aqrl"},
+    };
+    auto replace = [](std::string* str, const std::string& token, const std::string& value) {
+      for (size_t pos; (pos = str->find(token)) != std::string::npos; ) {
+        str->replace(pos, token.size(), value);
+      }
+    };
+    std::string result;
+    const size_t num_regs = registers_.size();
+    for (auto [aqrl, aqrl_suffix] : kAqRls) {
+      for (size_t i = 0; i != num_regs; ++i) {
+        riscv64::XRegister reg1 = *registers_[i];
+        riscv64::XRegister reg2 = *registers_[(i + 7u) % num_regs];
+        riscv64::XRegister reg3 = *registers_[(i + 13u) % num_regs];
+        emit_fn(reg1, reg2, reg3, aqrl);
+        std::string base = fmt;
+        replace(&base, "{aqrl}", aqrl_suffix);
+        replace(&base, "{reg1}", GetSecondaryRegisterName(reg1));
+        replace(&base, "{reg2}", GetSecondaryRegisterName(reg2));
+        replace(&base, "{reg3}", GetSecondaryRegisterName(reg3));
+        result += base + "\n";
+      }
+    }
+    return result;
+  }
+
+  // Helper for the three-register forms `op rd, rs2, (rs1)`.
+  std::string RepeatRRRAqRl(void (riscv64::Riscv64Assembler::*f)(riscv64::XRegister,
+                                                                 riscv64::XRegister,
+                                                                 riscv64::XRegister,
+                                                                 riscv64::AqRl),
+                            const std::string& fmt) {
+    return RepeatAqRl(
+        [&](riscv64::XRegister reg1,
+            riscv64::XRegister reg2,
+            riscv64::XRegister reg3,
+            riscv64::AqRl aqrl) { (GetAssembler()->*f)(reg1, reg2, reg3, aqrl); },
+        fmt);
+  }
+
+  // Helper for the two-register forms `op rd, (rs1)`.
+  std::string RepeatRRAqRl(void (riscv64::Riscv64Assembler::*f)(riscv64::XRegister,
+                                                                riscv64::XRegister,
+                                                                riscv64::AqRl),
+                           const std::string& fmt) {
+    return RepeatAqRl(
+        [&](riscv64::XRegister reg1,
+            riscv64::XRegister reg2,
+            riscv64::XRegister reg3 ATTRIBUTE_UNUSED,
+            riscv64::AqRl aqrl) { (GetAssembler()->*f)(reg1, reg2, aqrl); },
+        fmt);
+  }
+
+  // Emit `f` for a rotating selection of vector registers, alternating between the unmasked
+  // and masked variants. The `{vm}` token in `fmt` is replaced with the mask operand, if any.
+  template <typename Reg, typename EmitFn>
+  std::string RepeatVectorRegs(EmitFn&& emit_fn,
+                               const std::vector<Reg>& regs3,
+                               std::string (*reg3_name)(Reg),
+                               const std::string& fmt) {
+    std::string result;
+    for (size_t i = 0; i != riscv64::kNumberOfVRegisters; ++i) {
+      riscv64::VRegister reg1 = enum_cast<riscv64::VRegister>(i);
+      riscv64::VRegister reg2 = enum_cast<riscv64::VRegister>((i + 7u) % 32u);
+      Reg reg3 = regs3[(i + 13u) % regs3.size()];
+      bool masked = (i % 2u == 1u);
+      emit_fn(reg1, reg2, reg3, masked ? riscv64::VM::kV0_t : riscv64::VM::kUnmasked);
+      std::string base = fmt;
+      Replace(&base, "{vm}", masked ? ", v0.t" : "");
+      Replace(&base, "{reg1}", VRegisterName(reg1));
+      Replace(&base, "{reg2}", VRegisterName(reg2));
+      Replace(&base, "{reg3}", reg3_name(reg3));
+      result += base + "\n";
+    }
+    return result;
+  }
+
+  // Helper for the forms `op vd, vs2, vs1[, v0.t]`.
+  std::string RepeatVVV(void (riscv64::Riscv64Assembler::*f)(riscv64::VRegister,
+                                                             riscv64::VRegister,
+                                                             riscv64::VRegister,
+                                                             riscv64::VM),
+                        const std::string& fmt) {
+    std::vector<riscv64::VRegister> regs;
+    for (size_t i = 0; i != riscv64::kNumberOfVRegisters; ++i) {
+      regs.push_back(enum_cast<riscv64::VRegister>(i));
+    }
+    return RepeatVectorRegs(
+        [&](riscv64::VRegister reg1,
+            riscv64::VRegister reg2,
+            riscv64::VRegister reg3,
+            riscv64::VM vm) { (GetAssembler()->*f)(reg1, reg2, reg3, vm); },
+        regs,
+        &VRegisterName,
+        fmt);
+  }
+
+  // Helper for the forms `op vd, vs2, rs1[, v0.t]`.
+  std::string RepeatVVR(void (riscv64::Riscv64Assembler::*f)(riscv64::VRegister,
+                                                             riscv64::VRegister,
+                                                             riscv64::XRegister,
+                                                             riscv64::VM),
+                        const std::string& fmt) {
+    std::vector<riscv64::XRegister> regs;
+    for (riscv64::XRegister* reg : registers_) {
+      regs.push_back(*reg);
+    }
+    return RepeatVectorRegs(
+        [&](riscv64::VRegister reg1,
+            riscv64::VRegister reg2,
+            riscv64::XRegister reg3,
+            riscv64::VM vm) { (GetAssembler()->*f)(reg1, reg2, reg3, vm); },
+        regs,
+        &XRegisterName,
+        fmt);
+  }
+
+  // Helper for the forms `op vd, vs2, fs1[, v0.t]`.
+  std::string RepeatVVF(void (riscv64::Riscv64Assembler::*f)(riscv64::VRegister,
+                                                             riscv64::VRegister,
+                                                             riscv64::FRegister,
+                                                             riscv64::VM),
+                        const std::string& fmt) {
+    std::vector<riscv64::FRegister> regs;
+    for (riscv64::FRegister* reg : fp_registers_) {
+      regs.push_back(*reg);
+    }
+    return RepeatVectorRegs(
+        [&](riscv64::VRegister reg1,
+            riscv64::VRegister reg2,
+            riscv64::FRegister reg3,
+            riscv64::VM vm) { (GetAssembler()->*f)(reg1, reg2, reg3, vm); },
+        regs,
+        &FRegisterName,
+        fmt);
+  }
+
+  // Helper for the forms `op vd, vs2, imm[, v0.t]` with a signed or unsigned 5-bit immediate.
+  template <typename ImmType>
+  std::string RepeatVVIb(void (riscv64::Riscv64Assembler::*f)(riscv64::VRegister,
+                                                              riscv64::VRegister,
+                                                              ImmType,
+                                                              riscv64::VM),
+                         const std::string& fmt) {
+    std::vector<ImmType> imms;
+    for (int32_t imm = std::is_signed_v<ImmType> ? -16 : 0;
+         imm != (std::is_signed_v<ImmType> ? 16 : 32);
+         ++imm) {
+      imms.push_back(static_cast<ImmType>(imm));
+    }
+    return RepeatVectorRegs(
+        [&](riscv64::VRegister reg1,
+            riscv64::VRegister reg2,
+            ImmType imm,
+            riscv64::VM vm) { (GetAssembler()->*f)(reg1, reg2, imm, vm); },
+        imms,
+        &ImmName<ImmType>,
+        fmt);
+  }
+
  private:
+  static void Replace(std::string* str, const std::string& token, const std::string& value) {
+    for (size_t pos; (pos = str->find(token)) != std::string::npos; ) {
+      str->replace(pos, token.size(), value);
+    }
+  }
+
+  static std::string VRegisterName(riscv64::VRegister reg) {
+    std::ostringstream oss;
+    oss << reg;
+    return oss.str();
+  }
+
+  static std::string XRegisterName(riscv64::XRegister reg) {
+    std::ostringstream oss;
+    oss << reg;
+    return oss.str();
+  }
+
+  static std::string FRegisterName(riscv64::FRegister reg) {
+    std::ostringstream oss;
+    oss << reg;
+    return oss.str();
+  }
+
+  template <typename ImmType>
+  static std::string ImmName(ImmType imm) {
+    return std::to_string(imm);
+  }
+
   std::vector<riscv64::XRegister*> registers_;
   std::map<riscv64::XRegister, std::string, RISCV64CpuRegisterCompare> secondary_register_names_;
 
@@ -199,7 +404,7 @@ TEST_F(AssemblerRISCV64Test, Auipc) {
 
 TEST_F(AssemblerRISCV64Test, Jal) {
   // TODO(riscv64): Change "-19, 2" to "-20, 1" for "C" Standard Extension.
-  DriverStr(RepeatRIbS(&riscv64::Riscv64Assembler::Jal, -19, 2, "jal {reg}, {imm}\n"),
+  DriverStr(RepeatRIbS<int32_t>(&riscv64::Riscv64Assembler::Jal, -19, 2, "jal {reg}, {imm}\n"),
             "Jal");
 }
 
@@ -211,38 +416,46 @@ TEST_F(AssemblerRISCV64Test, Jalr) {
 
 TEST_F(AssemblerRISCV64Test, Beq) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Beq, -11, 2, "beq {reg1}, {reg2}, {imm}\n"),
-            "Beq");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Beq, -11, 2, "beq {reg1}, {reg2}, {imm}\n"),
+      "Beq");
 }
 
 TEST_F(AssemblerRISCV64Test, Bne) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Bne, -11, 2, "bne {reg1}, {reg2}, {imm}\n"),
-            "Bne");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Bne, -11, 2, "bne {reg1}, {reg2}, {imm}\n"),
+      "Bne");
 }
 
 TEST_F(AssemblerRISCV64Test, Blt) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Blt, -11, 2, "blt {reg1}, {reg2}, {imm}\n"),
-            "Blt");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Blt, -11, 2, "blt {reg1}, {reg2}, {imm}\n"),
+      "Blt");
 }
 
 TEST_F(AssemblerRISCV64Test, Bge) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Bge, -11, 2, "bge {reg1}, {reg2}, {imm}\n"),
-            "Bge");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Bge, -11, 2, "bge {reg1}, {reg2}, {imm}\n"),
+      "Bge");
 }
 
 TEST_F(AssemblerRISCV64Test, Bltu) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Bltu, -11, 2, "bltu {reg1}, {reg2}, {imm}\n"),
-            "Bltu");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Bltu,
+          -11, 2, "bltu {reg1}, {reg2}, {imm}\n"),
+      "Bltu");
 }
 
 TEST_F(AssemblerRISCV64Test, Bgeu) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Bgeu, -11, 2, "bgeu {reg1}, {reg2}, {imm}\n"),
-            "Bgeu");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Bgeu,
+          -11, 2, "bgeu {reg1}, {reg2}, {imm}\n"),
+      "Bgeu");
 }
 
 TEST_F(AssemblerRISCV64Test, Lb) {
@@ -409,6 +622,20 @@ TEST_F(AssemblerRISCV64Test, Sraw) {
   DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sraw, "sraw {reg1}, {reg2}, {reg3}"), "Sraw");
 }
 
+TEST_F(AssemblerRISCV64Test, Fence) {
+  __ Fence();
+  __ Fence(riscv64::kFenceRead, riscv64::kFenceReadWrite);
+  __ Fence(riscv64::kFenceReadWrite, riscv64::kFenceWrite);
+  __ Fence(riscv64::kFenceWrite, riscv64::kFenceWrite);
+  DriverStr("fence rw, rw\nfence r, rw\nfence rw, w\nfence w, w\n", "Fence");
+}
+
+TEST_F(AssemblerRISCV64Test, EcallEbreak) {
+  __ Ecall();
+  __ Ebreak();
+  DriverStr("ecall\nebreak\n", "EcallEbreak");
+}
+
 TEST_F(AssemblerRISCV64Test, Mul) {
   DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Mul, "mul {reg1}, {reg2}, {reg3}"), "Mul");
 }
@@ -461,6 +688,134 @@ TEST_F(AssemblerRISCV64Test, Remuw) {
   DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Remuw, "remuw {reg1}, {reg2}, {reg3}"), "Remuw");
 }
 
+TEST_F(AssemblerRISCV64Test, LrW) {
+  DriverStr(RepeatRRAqRl(&riscv64::Riscv64Assembler::LrW, "lr.w{aqrl} {reg1}, ({reg2})"), "LrW");
+}
+
+TEST_F(AssemblerRISCV64Test, LrD) {
+  DriverStr(RepeatRRAqRl(&riscv64::Riscv64Assembler::LrD, "lr.d{aqrl} {reg1}, ({reg2})"), "LrD");
+}
+
+TEST_F(AssemblerRISCV64Test, ScW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::ScW,
+                          "sc.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "ScW");
+}
+
+TEST_F(AssemblerRISCV64Test, ScD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::ScD,
+                          "sc.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "ScD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoSwapW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoSwapW,
+                          "amoswap.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoSwapW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoSwapD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoSwapD,
+                          "amoswap.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoSwapD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoAddW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoAddW,
+                          "amoadd.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoAddW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoAddD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoAddD,
+                          "amoadd.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoAddD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoXorW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoXorW,
+                          "amoxor.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoXorW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoXorD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoXorD,
+                          "amoxor.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoXorD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoAndW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoAndW,
+                          "amoand.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoAndW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoAndD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoAndD,
+                          "amoand.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoAndD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoOrW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoOrW,
+                          "amoor.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoOrW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoOrD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoOrD,
+                          "amoor.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoOrD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMinW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMinW,
+                          "amomin.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMinW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMinD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMinD,
+                          "amomin.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMinD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMaxW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMaxW,
+                          "amomax.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMaxW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMaxD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMaxD,
+                          "amomax.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMaxD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMinuW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMinuW,
+                          "amominu.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMinuW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMinuD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMinuD,
+                          "amominu.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMinuD");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMaxuW) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMaxuW,
+                          "amomaxu.w{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMaxuW");
+}
+
+TEST_F(AssemblerRISCV64Test, AmoMaxuD) {
+  DriverStr(RepeatRRRAqRl(&riscv64::Riscv64Assembler::AmoMaxuD,
+                          "amomaxu.d{aqrl} {reg1}, {reg2}, ({reg3})"),
+            "AmoMaxuD");
+}
+
 TEST_F(AssemblerRISCV64Test, FLw) {
   DriverStr(RepeatFRIb(&riscv64::Riscv64Assembler::FLw, -12, "flw {reg1}, {imm}({reg2})"), "FLw");
 }
@@ -827,62 +1182,74 @@ TEST_F(AssemblerRISCV64Test, FNegD) {
 
 TEST_F(AssemblerRISCV64Test, Beqz) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRIbS(&riscv64::Riscv64Assembler::Beqz, -11, 2, "beq {reg}, zero, {imm}\n"),
-            "Beqz");
+  DriverStr(
+      RepeatRIbS<int32_t>(&riscv64::Riscv64Assembler::Beqz, -11, 2, "beq {reg}, zero, {imm}\n"),
+      "Beqz");
 }
 
 TEST_F(AssemblerRISCV64Test, Bnez) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRIbS(&riscv64::Riscv64Assembler::Bnez, -11, 2, "bne {reg}, zero, {imm}\n"),
-            "Bnez");
+  DriverStr(
+      RepeatRIbS<int32_t>(&riscv64::Riscv64Assembler::Bnez, -11, 2, "bne {reg}, zero, {imm}\n"),
+      "Bnez");
 }
 
 TEST_F(AssemblerRISCV64Test, Blez) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRIbS(&riscv64::Riscv64Assembler::Blez, -11, 2, "bge zero, {reg}, {imm}\n"),
-            "Blez");
+  DriverStr(
+      RepeatRIbS<int32_t>(&riscv64::Riscv64Assembler::Blez, -11, 2, "bge zero, {reg}, {imm}\n"),
+      "Blez");
 }
 
 TEST_F(AssemblerRISCV64Test, Bgez) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRIbS(&riscv64::Riscv64Assembler::Bgez, -11, 2, "bge {reg}, zero, {imm}\n"),
-            "Bgez");
+  DriverStr(
+      RepeatRIbS<int32_t>(&riscv64::Riscv64Assembler::Bgez, -11, 2, "bge {reg}, zero, {imm}\n"),
+      "Bgez");
 }
 
 TEST_F(AssemblerRISCV64Test, Bltz) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRIbS(&riscv64::Riscv64Assembler::Bltz, -11, 2, "blt {reg}, zero, {imm}\n"),
-            "Bltz");
+  DriverStr(
+      RepeatRIbS<int32_t>(&riscv64::Riscv64Assembler::Bltz, -11, 2, "blt {reg}, zero, {imm}\n"),
+      "Bltz");
 }
 
 TEST_F(AssemblerRISCV64Test, Bgtz) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRIbS(&riscv64::Riscv64Assembler::Bgtz, -11, 2, "blt zero, {reg}, {imm}\n"),
-            "Bgtz");
+  DriverStr(
+      RepeatRIbS<int32_t>(&riscv64::Riscv64Assembler::Bgtz, -11, 2, "blt zero, {reg}, {imm}\n"),
+      "Bgtz");
 }
 
 TEST_F(AssemblerRISCV64Test, Bgt) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Bgt, -11, 2, "blt {reg2}, {reg1}, {imm}\n"),
-            "Bgt");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Bgt, -11, 2, "blt {reg2}, {reg1}, {imm}\n"),
+      "Bgt");
 }
 
 TEST_F(AssemblerRISCV64Test, Ble) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Ble, -11, 2, "bge {reg2}, {reg1}, {imm}\n"),
-            "Bge");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Ble, -11, 2, "bge {reg2}, {reg1}, {imm}\n"),
+      "Bge");
 }
 
 TEST_F(AssemblerRISCV64Test, Bgtu) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Bgtu, -11, 2, "bltu {reg2}, {reg1}, {imm}\n"),
-            "Bgtu");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Bgtu,
+          -11, 2, "bltu {reg2}, {reg1}, {imm}\n"),
+      "Bgtu");
 }
 
 TEST_F(AssemblerRISCV64Test, Bleu) {
   // TODO(riscv64): Change "-11, 2" to "-12, 1" for "C" Standard Extension.
-  DriverStr(RepeatRRIbS(&riscv64::Riscv64Assembler::Bleu, -11, 2, "bgeu {reg2}, {reg1}, {imm}\n"),
-            "Bgeu");
+  DriverStr(
+      RepeatRRIbS<int32_t>(&riscv64::Riscv64Assembler::Bleu,
+          -11, 2, "bgeu {reg2}, {reg1}, {imm}\n"),
+      "Bgeu");
 }
 
 TEST_F(AssemblerRISCV64Test, J) {
@@ -907,11 +1274,1143 @@ TEST_F(AssemblerRISCV64Test, Jalr0) {
   DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Jalr, "jalr {reg1}, {reg2}\n"), "Jalr0");
 }
 
+TEST_F(AssemblerRISCV64Test, Unimp) {
+  __ Unimp();
+  DriverStr("unimp\n", "Unimp");
+}
+
 TEST_F(AssemblerRISCV64Test, Ret) {
   GetAssembler()->Ret();
   DriverStr("ret\n", "Ret");
 }
 
+TEST_F(AssemblerRISCV64Test, Li) {
+  __ Li(riscv64::A0, 0);
+  __ Li(riscv64::A0, -1);
+  __ Li(riscv64::A0, 0x7ff);
+  __ Li(riscv64::A0, -0x800);
+  __ Li(riscv64::A0, 0x800);
+  __ Li(riscv64::A0, 0x12345678);
+  __ Li(riscv64::A0, -0x12345678);
+  __ Li(riscv64::A0, 0x7fffffff);
+  __ Li(riscv64::A0, -INT64_C(0x80000000));
+  __ Li(riscv64::A0, INT64_C(0x80000000));
+  __ Li(riscv64::A0, INT64_C(0xffffffff));
+  __ Li(riscv64::A0, INT64_C(0x123456789abcdef0));
+  __ Li(riscv64::A0, std::numeric_limits<int64_t>::min());
+  __ Li(riscv64::A0, std::numeric_limits<int64_t>::max());
+  std::string expected =
+      "addi a0, zero, 0\n"
+      "addi a0, zero, -1\n"
+      "addi a0, zero, 2047\n"
+      "addi a0, zero, -2048\n"
+      "lui a0, 1\n"
+      "addiw a0, a0, -2048\n"
+      "lui a0, 74565\n"
+      "addiw a0, a0, 1656\n"
+      "lui a0, 974011\n"
+      "addiw a0, a0, -1656\n"
+      "lui a0, 524288\n"
+      "addiw a0, a0, -1\n"
+      "lui a0, 524288\n"
+      "addi a0, zero, 1\n"
+      "slli a0, a0, 31\n"
+      "addi a0, zero, 1\n"
+      "slli a0, a0, 32\n"
+      "addi a0, a0, -1\n"
+      "lui a0, 583\n"
+      "addiw a0, a0, -1875\n"
+      "slli a0, a0, 14\n"
+      "addi a0, a0, -947\n"
+      "slli a0, a0, 12\n"
+      "addi a0, a0, 1511\n"
+      "slli a0, a0, 13\n"
+      "addi a0, a0, -272\n"
+      "addi a0, zero, -1\n"
+      "slli a0, a0, 63\n"
+      "addi a0, zero, -1\n"
+      "slli a0, a0, 63\n"
+      "addi a0, a0, -1\n";
+  DriverStr(expected, "Li");
+}
+
+TEST_F(AssemblerRISCV64Test, Csr) {
+  __ Csrrw(riscv64::A0, 0x00a, riscv64::A1);
+  __ Csrrs(riscv64::A2, 0xc00, riscv64::Zero);
+  __ Csrrc(riscv64::Zero, 0x003, riscv64::T0);
+  __ Csrrwi(riscv64::A0, 0x00a, 2u);
+  __ Csrrsi(riscv64::Zero, 0x001, 31u);
+  __ Csrrci(riscv64::A1, 0x002, 0u);
+  __ Csrr(riscv64::A3, 0xc01);
+  __ Csrw(0x003, riscv64::A4);
+  __ Csrwi(riscv64::kCsrVxrm, riscv64::kVxrmRdn);
+  std::string expected =
+      "csrrw a0, 0xa, a1\n"
+      "csrrs a2, 0xc00, zero\n"
+      "csrrc zero, 0x3, t0\n"
+      "csrrwi a0, 0xa, 2\n"
+      "csrrsi zero, 0x1, 31\n"
+      "csrrci a1, 0x2, 0\n"
+      "csrrs a3, 0xc01, zero\n"
+      "csrrw zero, 0x3, a4\n"
+      "csrrwi zero, 0xa, 2\n";
+  DriverStr(expected, "Csr");
+}
+
+// Tests for the "Zba", "Zbb" and "Zbs" bit-manipulation extensions.
+class AssemblerRISCV64BitManipTest : public AssemblerRISCV64Test {
+ public:
+  AssemblerRISCV64BitManipTest()
+      : AssemblerRISCV64Test(Riscv64InstructionSetFeatures::FromBitmap(
+            Riscv64InstructionSetFeatures::kExtGeneric |
+            Riscv64InstructionSetFeatures::kExtZba |
+            Riscv64InstructionSetFeatures::kExtZbb |
+            Riscv64InstructionSetFeatures::kExtZbs)) {}
+};
+
+TEST_F(AssemblerRISCV64BitManipTest, AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::AddUw, "add.uw {reg1}, {reg2}, {reg3}"),
+            "AddUw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Sh1Add) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh1Add, "sh1add {reg1}, {reg2}, {reg3}"),
+            "Sh1Add");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Sh1AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh1AddUw, "sh1add.uw {reg1}, {reg2}, {reg3}"),
+            "Sh1AddUw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Sh2Add) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh2Add, "sh2add {reg1}, {reg2}, {reg3}"),
+            "Sh2Add");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Sh2AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh2AddUw, "sh2add.uw {reg1}, {reg2}, {reg3}"),
+            "Sh2AddUw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Sh3Add) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh3Add, "sh3add {reg1}, {reg2}, {reg3}"),
+            "Sh3Add");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Sh3AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh3AddUw, "sh3add.uw {reg1}, {reg2}, {reg3}"),
+            "Sh3AddUw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, SlliUw) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::SlliUw, 6, "slli.uw {reg1}, {reg2}, {imm}"),
+            "SlliUw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Andn) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Andn, "andn {reg1}, {reg2}, {reg3}"), "Andn");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Orn) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Orn, "orn {reg1}, {reg2}, {reg3}"), "Orn");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Xnor) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Xnor, "xnor {reg1}, {reg2}, {reg3}"), "Xnor");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Clz) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Clz, "clz {reg1}, {reg2}"), "Clz");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Clzw) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Clzw, "clzw {reg1}, {reg2}"), "Clzw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Ctz) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Ctz, "ctz {reg1}, {reg2}"), "Ctz");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Ctzw) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Ctzw, "ctzw {reg1}, {reg2}"), "Ctzw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Cpop) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Cpop, "cpop {reg1}, {reg2}"), "Cpop");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Cpopw) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Cpopw, "cpopw {reg1}, {reg2}"), "Cpopw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Min) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Min, "min {reg1}, {reg2}, {reg3}"), "Min");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Minu) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Minu, "minu {reg1}, {reg2}, {reg3}"), "Minu");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Max) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Max, "max {reg1}, {reg2}, {reg3}"), "Max");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Maxu) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Maxu, "maxu {reg1}, {reg2}, {reg3}"), "Maxu");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Rol) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Rol, "rol {reg1}, {reg2}, {reg3}"), "Rol");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Rolw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Rolw, "rolw {reg1}, {reg2}, {reg3}"), "Rolw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Ror) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Ror, "ror {reg1}, {reg2}, {reg3}"), "Ror");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Rorw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Rorw, "rorw {reg1}, {reg2}, {reg3}"), "Rorw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Rori) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Rori, 6, "rori {reg1}, {reg2}, {imm}"), "Rori");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Roriw) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Roriw, 5, "roriw {reg1}, {reg2}, {imm}"),
+            "Roriw");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, OrcB) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::OrcB, "orc.b {reg1}, {reg2}"), "OrcB");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Rev8) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Rev8, "rev8 {reg1}, {reg2}"), "Rev8");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Bclr) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Bclr, "bclr {reg1}, {reg2}, {reg3}"), "Bclr");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Bclri) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Bclri, 6, "bclri {reg1}, {reg2}, {imm}"),
+            "Bclri");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Bext) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Bext, "bext {reg1}, {reg2}, {reg3}"), "Bext");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Bexti) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Bexti, 6, "bexti {reg1}, {reg2}, {imm}"),
+            "Bexti");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Binv) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Binv, "binv {reg1}, {reg2}, {reg3}"), "Binv");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Binvi) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Binvi, 6, "binvi {reg1}, {reg2}, {imm}"),
+            "Binvi");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Bset) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Bset, "bset {reg1}, {reg2}, {reg3}"), "Bset");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, Bseti) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Bseti, 6, "bseti {reg1}, {reg2}, {imm}"),
+            "Bseti");
+}
+
+// The extension pseudo instructions use the bit-manipulation instructions when available.
+
+TEST_F(AssemblerRISCV64BitManipTest, SextB) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::SextB, "sext.b {reg1}, {reg2}"), "SextB");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, SextH) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::SextH, "sext.h {reg1}, {reg2}"), "SextH");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, ZextH) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::ZextH, "zext.h {reg1}, {reg2}"), "ZextH");
+}
+
+TEST_F(AssemblerRISCV64BitManipTest, ZextW) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::ZextW, "add.uw {reg1}, {reg2}, zero"), "ZextW");
+}
+
+TEST_F(AssemblerRISCV64Test, VSetvl) {
+  using riscv64::LengthMultiplier;
+  using riscv64::SelectedElementWidth;
+  using riscv64::VectorMaskPolicy;
+  using riscv64::VectorTailPolicy;
+  __ VSetvli(riscv64::A0, riscv64::A1, riscv64::VTypeiValue(VectorMaskPolicy::kUndisturbed,
+                                                             VectorTailPolicy::kUndisturbed,
+                                                             SelectedElementWidth::kE8,
+                                                             LengthMultiplier::kM1));
+  __ VSetvli(riscv64::Zero, riscv64::T0, riscv64::VTypeiValue(VectorMaskPolicy::kAgnostic,
+                                                               VectorTailPolicy::kAgnostic,
+                                                               SelectedElementWidth::kE64,
+                                                               LengthMultiplier::kM8));
+  __ VSetivli(riscv64::Zero, 4u, riscv64::VTypeiValue(VectorMaskPolicy::kAgnostic,
+                                                       VectorTailPolicy::kAgnostic,
+                                                       SelectedElementWidth::kE32,
+                                                       LengthMultiplier::kM1));
+  __ VSetivli(riscv64::A2, 31u, riscv64::VTypeiValue(VectorMaskPolicy::kAgnostic,
+                                                      VectorTailPolicy::kUndisturbed,
+                                                      SelectedElementWidth::kE16,
+                                                      LengthMultiplier::kM1Over2));
+  __ VSetvl(riscv64::A0, riscv64::A1, riscv64::A2);
+  std::string expected =
+      "vsetvli a0, a1, e8, m1, tu, mu\n"
+      "vsetvli zero, t0, e64, m8, ta, ma\n"
+      "vsetivli zero, 4, e32, m1, ta, ma\n"
+      "vsetivli a2, 31, e16, mf2, tu, ma\n"
+      "vsetvl a0, a1, a2\n";
+  DriverStr(expected, "VSetvl");
+}
+
+TEST_F(AssemblerRISCV64Test, VLoadStore) {
+  __ VLe8(riscv64::V1, riscv64::A0);
+  __ VLe16(riscv64::V2, riscv64::A1, riscv64::VM::kV0_t);
+  __ VLe32(riscv64::V31, riscv64::SP);
+  __ VLe64(riscv64::V0, riscv64::T6);
+  __ VSe8(riscv64::V0, riscv64::A0);
+  __ VSe16(riscv64::V7, riscv64::A1);
+  __ VSe32(riscv64::V8, riscv64::SP, riscv64::VM::kV0_t);
+  __ VSe64(riscv64::V30, riscv64::T6);
+  __ VL1re8(riscv64::V3, riscv64::A2);
+  __ VS1r(riscv64::V4, riscv64::SP);
+  std::string expected =
+      "vle8.v v1, (a0)\n"
+      "vle16.v v2, (a1), v0.t\n"
+      "vle32.v v31, (sp)\n"
+      "vle64.v v0, (t6)\n"
+      "vse8.v v0, (a0)\n"
+      "vse16.v v7, (a1)\n"
+      "vse32.v v8, (sp), v0.t\n"
+      "vse64.v v30, (t6)\n"
+      "vl1re8.v v3, (a2)\n"
+      "vs1r.v v4, (sp)\n";
+  DriverStr(expected, "VLoadStore");
+}
+
+TEST_F(AssemblerRISCV64Test, VAdd_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VAdd_vv,
+                      "vadd.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VAdd_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VAdd_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VAdd_vx,
+                      "vadd.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VAdd_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VAdd_vi) {
+  DriverStr(RepeatVVIb<int32_t>(&riscv64::Riscv64Assembler::VAdd_vi,
+                                "vadd.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VAdd_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VSub_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VSub_vv,
+                      "vsub.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VSub_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VSub_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSub_vx,
+                      "vsub.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VSub_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VRsub_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VRsub_vx,
+                      "vrsub.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VRsub_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VRsub_vi) {
+  DriverStr(RepeatVVIb<int32_t>(&riscv64::Riscv64Assembler::VRsub_vi,
+                                "vrsub.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VRsub_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VMinu_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMinu_vv,
+                      "vminu.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VMinu_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VMin_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMin_vv,
+                      "vmin.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VMin_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VMaxu_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMaxu_vv,
+                      "vmaxu.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VMaxu_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VMax_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMax_vv,
+                      "vmax.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VMax_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VAnd_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VAnd_vv,
+                      "vand.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VAnd_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VAnd_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VAnd_vx,
+                      "vand.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VAnd_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VAnd_vi) {
+  DriverStr(RepeatVVIb<int32_t>(&riscv64::Riscv64Assembler::VAnd_vi,
+                                "vand.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VAnd_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VOr_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VOr_vv,
+                      "vor.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VOr_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VOr_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VOr_vx,
+                      "vor.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VOr_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VOr_vi) {
+  DriverStr(RepeatVVIb<int32_t>(&riscv64::Riscv64Assembler::VOr_vi,
+                                "vor.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VOr_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VXor_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VXor_vv,
+                      "vxor.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VXor_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VXor_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VXor_vx,
+                      "vxor.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VXor_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VXor_vi) {
+  DriverStr(RepeatVVIb<int32_t>(&riscv64::Riscv64Assembler::VXor_vi,
+                                "vxor.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VXor_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VSaddu_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VSaddu_vv,
+                      "vsaddu.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VSaddu_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VSadd_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VSadd_vv,
+                      "vsadd.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VSadd_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VSsubu_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VSsubu_vv,
+                      "vssubu.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VSsubu_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VSsub_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VSsub_vv,
+                      "vssub.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VSsub_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VSll_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSll_vx,
+                      "vsll.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VSll_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VSll_vi) {
+  DriverStr(RepeatVVIb<uint32_t>(&riscv64::Riscv64Assembler::VSll_vi,
+                                 "vsll.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VSll_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VSrl_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSrl_vx,
+                      "vsrl.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VSrl_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VSrl_vi) {
+  DriverStr(RepeatVVIb<uint32_t>(&riscv64::Riscv64Assembler::VSrl_vi,
+                                 "vsrl.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VSrl_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VSra_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSra_vx,
+                      "vsra.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VSra_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VSra_vi) {
+  DriverStr(RepeatVVIb<uint32_t>(&riscv64::Riscv64Assembler::VSra_vi,
+                                 "vsra.vi {reg1}, {reg2}, {reg3}{vm}"),
+            "VSra_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VSlidedown_vi) {
+  __ VSlidedown_vi(riscv64::V1, riscv64::V2, 0u);
+  __ VSlidedown_vi(riscv64::V3, riscv64::V4, 8u);
+  __ VSlidedown_vi(riscv64::V5, riscv64::V6, 31u, riscv64::VM::kV0_t);
+  std::string expected =
+      "vslidedown.vi v1, v2, 0\n"
+      "vslidedown.vi v3, v4, 8\n"
+      "vslidedown.vi v5, v6, 31, v0.t\n";
+  DriverStr(expected, "VSlidedown_vi");
+}
+
+TEST_F(AssemblerRISCV64Test, VMseq_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMseq_vv,
+                      "vmseq.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VMseq_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VMseq_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VMseq_vx,
+                      "vmseq.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VMseq_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VMsne_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMsne_vv,
+                      "vmsne.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VMsne_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VMsne_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VMsne_vx,
+                      "vmsne.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VMsne_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedsum_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedsum_vs,
+                      "vredsum.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VRedsum_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedminu_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedminu_vs,
+                      "vredminu.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VRedminu_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedmin_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedmin_vs,
+                      "vredmin.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VRedmin_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedmaxu_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedmaxu_vs,
+                      "vredmaxu.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VRedmaxu_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedmax_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedmax_vs,
+                      "vredmax.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VRedmax_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VAaddu_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VAaddu_vv,
+                      "vaaddu.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VAaddu_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VAadd_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VAadd_vv,
+                      "vaadd.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VAadd_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VMul_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMul_vv,
+                      "vmul.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VMul_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VMul_vx) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VMul_vx,
+                      "vmul.vx {reg1}, {reg2}, {reg3}{vm}"),
+            "VMul_vx");
+}
+
+TEST_F(AssemblerRISCV64Test, VMacc_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMacc_vv,
+                      "vmacc.vv {reg1}, {reg3}, {reg2}{vm}"),
+            "VMacc_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VNmsac_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VNmsac_vv,
+                      "vnmsac.vv {reg1}, {reg3}, {reg2}{vm}"),
+            "VNmsac_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFAdd_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFAdd_vv,
+                      "vfadd.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFAdd_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFAdd_vf) {
+  DriverStr(RepeatVVF(&riscv64::Riscv64Assembler::VFAdd_vf,
+                      "vfadd.vf {reg1}, {reg2}, {reg3}{vm}"),
+            "VFAdd_vf");
+}
+
+TEST_F(AssemblerRISCV64Test, VFSub_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFSub_vv,
+                      "vfsub.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFSub_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFSub_vf) {
+  DriverStr(RepeatVVF(&riscv64::Riscv64Assembler::VFSub_vf,
+                      "vfsub.vf {reg1}, {reg2}, {reg3}{vm}"),
+            "VFSub_vf");
+}
+
+TEST_F(AssemblerRISCV64Test, VFMul_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFMul_vv,
+                      "vfmul.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFMul_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFMul_vf) {
+  DriverStr(RepeatVVF(&riscv64::Riscv64Assembler::VFMul_vf,
+                      "vfmul.vf {reg1}, {reg2}, {reg3}{vm}"),
+            "VFMul_vf");
+}
+
+TEST_F(AssemblerRISCV64Test, VFDiv_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFDiv_vv,
+                      "vfdiv.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFDiv_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFDiv_vf) {
+  DriverStr(RepeatVVF(&riscv64::Riscv64Assembler::VFDiv_vf,
+                      "vfdiv.vf {reg1}, {reg2}, {reg3}{vm}"),
+            "VFDiv_vf");
+}
+
+TEST_F(AssemblerRISCV64Test, VFMin_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFMin_vv,
+                      "vfmin.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFMin_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFMax_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFMax_vv,
+                      "vfmax.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFMax_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFSgnj_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFSgnj_vv,
+                      "vfsgnj.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFSgnj_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFSgnjn_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFSgnjn_vv,
+                      "vfsgnjn.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFSgnjn_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFSgnjx_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFSgnjx_vv,
+                      "vfsgnjx.vv {reg1}, {reg2}, {reg3}{vm}"),
+            "VFSgnjx_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFMacc_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFMacc_vv,
+                      "vfmacc.vv {reg1}, {reg3}, {reg2}{vm}"),
+            "VFMacc_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFNmsac_vv) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFNmsac_vv,
+                      "vfnmsac.vv {reg1}, {reg3}, {reg2}{vm}"),
+            "VFNmsac_vv");
+}
+
+TEST_F(AssemblerRISCV64Test, VFRedusum_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFRedusum_vs,
+                      "vfredusum.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VFRedusum_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VFRedmin_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFRedmin_vs,
+                      "vfredmin.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VFRedmin_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VFRedmax_vs) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFRedmax_vs,
+                      "vfredmax.vs {reg1}, {reg2}, {reg3}{vm}"),
+            "VFRedmax_vs");
+}
+
+TEST_F(AssemblerRISCV64Test, VMoves) {
+  __ VMv_vv(riscv64::V1, riscv64::V2);
+  __ VMv_vx(riscv64::V3, riscv64::A0);
+  __ VMv_vi(riscv64::V4, -16);
+  __ VMv_vi(riscv64::V5, 15);
+  __ VMv1r_v(riscv64::V6, riscv64::V7);
+  __ VMv_xs(riscv64::A1, riscv64::V8);
+  __ VMv_sx(riscv64::V9, riscv64::A2);
+  __ VFMv_vf(riscv64::V10, riscv64::FA0);
+  __ VFMv_fs(riscv64::FA1, riscv64::V11);
+  __ VFMv_sf(riscv64::V12, riscv64::FT11);
+  __ VCpop_m(riscv64::A3, riscv64::V13);
+  __ VFirst_m(riscv64::A4, riscv64::V14, riscv64::VM::kV0_t);
+  std::string expected =
+      "vmv.v.v v1, v2\n"
+      "vmv.v.x v3, a0\n"
+      "vmv.v.i v4, -16\n"
+      "vmv.v.i v5, 15\n"
+      "vmv1r.v v6, v7\n"
+      "vmv.x.s a1, v8\n"
+      "vmv.s.x v9, a2\n"
+      "vfmv.v.f v10, fa0\n"
+      "vfmv.f.s fa1, v11\n"
+      "vfmv.s.f v12, ft11\n"
+      "vcpop.m a3, v13\n"
+      "vfirst.m a4, v14, v0.t\n";
+  DriverStr(expected, "VMoves");
+}
+
+TEST_F(AssemblerRISCV64Test, VFCvt) {
+  __ VFCvt_f_x_v(riscv64::V1, riscv64::V2);
+  __ VFCvt_f_x_v(riscv64::V3, riscv64::V4, riscv64::VM::kV0_t);
+  __ VFCvt_rtz_x_f_v(riscv64::V5, riscv64::V6);
+  __ VFCvt_rtz_x_f_v(riscv64::V7, riscv64::V8, riscv64::VM::kV0_t);
+  std::string expected =
+      "vfcvt.f.x.v v1, v2\n"
+      "vfcvt.f.x.v v3, v4, v0.t\n"
+      "vfcvt.rtz.x.f.v v5, v6\n"
+      "vfcvt.rtz.x.f.v v7, v8, v0.t\n";
+  DriverStr(expected, "VFCvt");
+}
+
+TEST_F(AssemblerRISCV64Test, VExt) {
+  __ VZext_vf2(riscv64::V1, riscv64::V2);
+  __ VSext_vf2(riscv64::V3, riscv64::V4, riscv64::VM::kV0_t);
+  __ VZext_vf4(riscv64::V5, riscv64::V6);
+  __ VSext_vf4(riscv64::V7, riscv64::V8);
+  __ VZext_vf8(riscv64::V9, riscv64::V10, riscv64::VM::kV0_t);
+  __ VSext_vf8(riscv64::V11, riscv64::V12);
+  std::string expected =
+      "vzext.vf2 v1, v2\n"
+      "vsext.vf2 v3, v4, v0.t\n"
+      "vzext.vf4 v5, v6\n"
+      "vsext.vf4 v7, v8\n"
+      "vzext.vf8 v9, v10, v0.t\n"
+      "vsext.vf8 v11, v12\n";
+  DriverStr(expected, "VExt");
+}
+
+TEST_F(AssemblerRISCV64Test, VPseudo) {
+  __ VNot_v(riscv64::V1, riscv64::V2);
+  __ VNeg_v(riscv64::V3, riscv64::V4, riscv64::VM::kV0_t);
+  __ VFNeg_v(riscv64::V5, riscv64::V6);
+  __ VFAbs_v(riscv64::V7, riscv64::V8);
+  std::string expected =
+      "vxor.vi v1, v2, -1\n"
+      "vrsub.vx v3, v4, zero, v0.t\n"
+      "vfsgnjn.vv v5, v6, v6\n"
+      "vfsgnjx.vv v7, v8, v8\n";
+  DriverStr(expected, "VPseudo");
+}
+
+TEST_F(AssemblerRISCV64Test, LoadStoreLargeOffset) {
+  __ Loadw(riscv64::A0, riscv64::A1, 0x7ff);
+  __ Loadd(riscv64::A0, riscv64::A1, 0x800);
+  __ Storew(riscv64::A0, riscv64::A1, -0x801);
+  __ FLoadd(riscv64::FA0, riscv64::SP, 0x12345);
+  std::string expected =
+      "lw a0, 2047(a1)\n"
+      "lui t6, 1\n"
+      "add t6, t6, a1\n"
+      "ld a0, -2048(t6)\n"
+      "lui t6, 1048575\n"
+      "add t6, t6, a1\n"
+      "sw a0, 2047(t6)\n"
+      "lui t6, 18\n"
+      "add t6, t6, sp\n"
+      "fld fa0, 837(t6)\n";
+  DriverStr(expected, "LoadStoreLargeOffset");
+}
+
+TEST_F(AssemblerRISCV64Test, BranchToLabel) {
+  riscv64::Riscv64Label label1, label2;
+  __ Beqz(riscv64::A0, &label1);
+  __ Bind(&label2);
+  __ Addi(riscv64::A1, riscv64::A1, 1);
+  __ Bind(&label1);
+  __ Bltu(riscv64::A0, riscv64::A1, &label2);
+  __ Bgt(riscv64::A0, riscv64::A1, &label2);
+  __ J(&label1);
+  // Branches that are always or never taken.
+  __ Beq(riscv64::A2, riscv64::A2, &label1);
+  __ Bne(riscv64::A2, riscv64::A2, &label1);
+  std::string expected =
+      "beq a0, zero, 1f\n"
+      "2:\n"
+      "addi a1, a1, 1\n"
+      "1:\n"
+      "bltu a0, a1, 2b\n"
+      "blt a1, a0, 2b\n"
+      "j 1b\n"
+      "j 1b\n";
+  DriverStr(expected, "BranchToLabel");
+}
+
+TEST_F(AssemblerRISCV64Test, LongBranchToLabel) {
+  // Forward and backward conditional branches further than +-4KiB are emitted as
+  // an inverted branch over an unconditional jump.
+  constexpr size_t kNopCount = 1100u;
+  riscv64::Riscv64Label label1, label2;
+  __ Bind(&label2);
+  __ Bnez(riscv64::A0, &label1);
+  for (size_t i = 0; i != kNopCount; ++i) {
+    __ Nop();
+  }
+  __ Bind(&label1);
+  __ Bge(riscv64::A0, riscv64::A1, &label2);
+  std::string expected =
+      "2:\n"
+      "beq a0, zero, 8\n"
+      "j 1f\n";
+  for (size_t i = 0; i != kNopCount; ++i) {
+    expected += "nop\n";
+  }
+  expected +=
+      "1:\n"
+      "blt a0, a1, 8\n"
+      "j 2b\n";
+  DriverStr(expected, "LongBranchToLabel");
+}
+
+// Tests for the "C" Standard Extension. Instructions that have a compressed form are
+// compressed automatically, the same way as the reference assembler does it.
+class AssemblerRISCV64CompressedTest : public AssemblerRISCV64Test {
+ public:
+  AssemblerRISCV64CompressedTest()
+      : AssemblerRISCV64Test(Riscv64InstructionSetFeatures::FromBitmap(
+            Riscv64InstructionSetFeatures::kExtGeneric |
+            Riscv64InstructionSetFeatures::kExtCompressed)) {}
+
+ protected:
+  std::vector<std::string> GetAssemblerCommand() override {
+    std::vector<std::string> command = AssemblerRISCV64Test::GetAssemblerCommand();
+    for (std::string& arg : command) {
+      if (StartsWith(arg, "-march=")) {
+        arg = "-march=rv64imafdcv_zba_zbb_zbs";
+      }
+    }
+    // Do not let the linker relaxation leave branches to local labels unresolved.
+    command.push_back("-mno-relax");
+    return command;
+  }
+};
+
+TEST_F(AssemblerRISCV64CompressedTest, Lui) {
+  DriverStr(RepeatRIb(&riscv64::Riscv64Assembler::Lui, 20, "lui {reg}, {imm}"), "Lui");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Jalr) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Jalr, -12, "jalr {reg1}, {reg2}, {imm}\n"),
+            "Jalr");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Lw) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Lw, -12, "lw {reg1}, {imm}({reg2})"), "Lw");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Ld) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Ld, -12, "ld {reg1}, {imm}({reg2})"), "Ld");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Sw) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Sw, -12, "sw {reg1}, {imm}({reg2})"), "Sw");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Sd) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Sd, -12, "sd {reg1}, {imm}({reg2})"), "Sd");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, FLd) {
+  DriverStr(RepeatFRIb(&riscv64::Riscv64Assembler::FLd, -12, "fld {reg1}, {imm}({reg2})"), "FLd");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, FSd) {
+  DriverStr(RepeatFRIb(&riscv64::Riscv64Assembler::FSd, -12, "fsd {reg1}, {imm}({reg2})"), "FSd");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Addi) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Addi, -12, "addi {reg1}, {reg2}, {imm}"),
+            "Addi");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Addiw) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Addiw, -12, "addiw {reg1}, {reg2}, {imm}"),
+            "Addiw");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Andi) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Andi, -12, "andi {reg1}, {reg2}, {imm}"),
+            "Andi");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Slli) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Slli, 6, "slli {reg1}, {reg2}, {imm}"), "Slli");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Srli) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Srli, 6, "srli {reg1}, {reg2}, {imm}"), "Srli");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Srai) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Srai, 6, "srai {reg1}, {reg2}, {imm}"), "Srai");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Add) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Add, "add {reg1}, {reg2}, {reg3}"), "Add");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Sub) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sub, "sub {reg1}, {reg2}, {reg3}"), "Sub");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Xor) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Xor, "xor {reg1}, {reg2}, {reg3}"), "Xor");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Or) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Or, "or {reg1}, {reg2}, {reg3}"), "Or");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, And) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::And, "and {reg1}, {reg2}, {reg3}"), "And");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Addw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Addw, "addw {reg1}, {reg2}, {reg3}"), "Addw");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Subw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Subw, "subw {reg1}, {reg2}, {reg3}"), "Subw");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Pseudo) {
+  __ Nop();
+  __ Mv(riscv64::A0, riscv64::S2);
+  __ Li(riscv64::A1, -32);
+  __ Ebreak();
+  __ Ret();
+  std::string expected =
+      "c.nop\n"
+      "c.mv a0, s2\n"
+      "c.li a1, -32\n"
+      "c.ebreak\n"
+      "c.jr ra\n";
+  DriverStr(expected, "Pseudo");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, Explicit) {
+  __ CLwsp(riscv64::A0, 252);
+  __ CLdsp(riscv64::S2, 504);
+  __ CFLdsp(riscv64::FT11, 8);
+  __ CSwsp(riscv64::RA, 4);
+  __ CSdsp(riscv64::T6, 0);
+  __ CFSdsp(riscv64::FS0, 496);
+  __ CLw(riscv64::A0, riscv64::S1, 124);
+  __ CLd(riscv64::A5, riscv64::S0, 248);
+  __ CFLd(riscv64::FA0, riscv64::A1, 8);
+  __ CSw(riscv64::A2, riscv64::A3, 64);
+  __ CSd(riscv64::S1, riscv64::A4, 16);
+  __ CFSd(riscv64::FS1, riscv64::A5, 240);
+  __ CLi(riscv64::T0, 31);
+  __ CLui(riscv64::A0, 0xfffe0u);
+  __ CLui(riscv64::T1, 31u);
+  __ CAddi(riscv64::SP, -32);
+  __ CAddiw(riscv64::A0, 0);
+  __ CAddi16Sp(-512);
+  __ CAddi16Sp(496);
+  __ CAddi4Spn(riscv64::A0, 1020u);
+  __ CSlli(riscv64::T2, 63);
+  __ CSrli(riscv64::A1, 1);
+  __ CSrai(riscv64::A2, 32);
+  __ CAndi(riscv64::A3, -32);
+  __ CMv(riscv64::S3, riscv64::T4);
+  __ CAdd(riscv64::GP, riscv64::TP);
+  __ CAnd(riscv64::A0, riscv64::A1);
+  __ COr(riscv64::S0, riscv64::S1);
+  __ CXor(riscv64::A4, riscv64::A5);
+  __ CSub(riscv64::A2, riscv64::A3);
+  __ CAddw(riscv64::S1, riscv64::A0);
+  __ CSubw(riscv64::A5, riscv64::S0);
+  __ CJr(riscv64::T0);
+  __ CJalr(riscv64::A7);
+  __ CEbreak();
+  __ CNop();
+  std::string expected =
+      "c.lwsp a0, 252(sp)\n"
+      "c.ldsp s2, 504(sp)\n"
+      "c.fldsp ft11, 8(sp)\n"
+      "c.swsp ra, 4(sp)\n"
+      "c.sdsp t6, 0(sp)\n"
+      "c.fsdsp fs0, 496(sp)\n"
+      "c.lw a0, 124(s1)\n"
+      "c.ld a5, 248(s0)\n"
+      "c.fld fa0, 8(a1)\n"
+      "c.sw a2, 64(a3)\n"
+      "c.sd s1, 16(a4)\n"
+      "c.fsd fs1, 240(a5)\n"
+      "c.li t0, 31\n"
+      "c.lui a0, 1048544\n"
+      "c.lui t1, 31\n"
+      "c.addi sp, -32\n"
+      "c.addiw a0, 0\n"
+      "c.addi16sp sp, -512\n"
+      "c.addi16sp sp, 496\n"
+      "c.addi4spn a0, sp, 1020\n"
+      "c.slli t2, 63\n"
+      "c.srli a1, 1\n"
+      "c.srai a2, 32\n"
+      "c.andi a3, -32\n"
+      "c.mv s3, t4\n"
+      "c.add gp, tp\n"
+      "c.and a0, a1\n"
+      "c.or s0, s1\n"
+      "c.xor a4, a5\n"
+      "c.sub a2, a3\n"
+      "c.addw s1, a0\n"
+      "c.subw a5, s0\n"
+      "c.jr t0\n"
+      "c.jalr a7\n"
+      "c.ebreak\n"
+      "c.nop\n";
+  DriverStr(expected, "Explicit");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, BranchToLabel) {
+  riscv64::Riscv64Label label1, label2;
+  __ Beqz(riscv64::A0, &label1);
+  __ Bind(&label2);
+  __ Bnez(riscv64::S1, &label1);
+  __ Bnez(riscv64::T0, &label2);  // Not a compressible register.
+  __ Beq(riscv64::Zero, riscv64::A5, &label2);
+  __ Bind(&label1);
+  __ Bltu(riscv64::A0, riscv64::A1, &label2);
+  __ J(&label1);
+  std::string expected =
+      "beqz a0, 1f\n"
+      "2:\n"
+      "bnez s1, 1f\n"
+      "bne t0, zero, 2b\n"
+      "beqz a5, 2b\n"
+      "1:\n"
+      "bltu a0, a1, 2b\n"
+      "j 1b\n";
+  DriverStr(expected, "BranchToLabel");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, MediumBranchToLabel) {
+  // Branches further than the compressed range are emitted in the full 32-bit form.
+  constexpr size_t kNopCount = 200u;
+  riscv64::Riscv64Label label1, label2;
+  __ Bind(&label2);
+  __ Beqz(riscv64::A0, &label1);
+  __ J(&label1);
+  for (size_t i = 0; i != kNopCount; ++i) {
+    __ Nop();
+  }
+  __ Bind(&label1);
+  __ Bnez(riscv64::A1, &label2);
+  std::string expected =
+      "2:\n"
+      "beq a0, zero, 1f\n"
+      "c.j 1f\n";
+  for (size_t i = 0; i != kNopCount; ++i) {
+    expected += "c.nop\n";
+  }
+  expected +=
+      "1:\n"
+      "bne a1, zero, 2b\n";
+  DriverStr(expected, "MediumBranchToLabel");
+}
+
+TEST_F(AssemblerRISCV64CompressedTest, LongBranchToLabel) {
+  // Forward and backward conditional branches further than +-4KiB are emitted as
+  // an inverted compressed branch over an unconditional jump.
+  constexpr size_t kNopCount = 2100u;
+  riscv64::Riscv64Label label1, label2;
+  __ Bind(&label2);
+  __ Bnez(riscv64::A0, &label1);
+  for (size_t i = 0; i != kNopCount; ++i) {
+    __ Nop();
+  }
+  __ Bind(&label1);
+  __ Beqz(riscv64::A1, &label2);
+  std::string expected =
+      "2:\n"
+      "c.beqz a0, 3f\n"
+      "jal zero, 1f\n"
+      "3:\n";
+  for (size_t i = 0; i != kNopCount; ++i) {
+    expected += "c.nop\n";
+  }
+  expected +=
+      "1:\n"
+      "c.bnez a1, 4f\n"
+      "jal zero, 2b\n"
+      "4:\n";
+  DriverStr(expected, "LongBranchToLabel");
+}
+
 #undef __
 
 }  // namespace art
@@ -0,0 +1,671 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni_macro_assembler_riscv64.h"
+
+#include "base/bit_utils_iterator.h"
+#include "dwarf/register.h"
+#include "entrypoints/quick/quick_entrypoints.h"
+#include "indirect_reference_table.h"
+#include "lock_word.h"
+#include "managed_register_riscv64.h"
+#include "offsets.h"
+#include "thread.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+static constexpr size_t kSpillSize = 8;  // Both GPRs and FPRs
+
+static std::pair<uint32_t, uint32_t> GetCoreAndFpSpillMasks(
+    ArrayRef<const ManagedRegister> callee_save_regs) {
+  uint32_t core_spill_mask = 0u;
+  uint32_t fp_spill_mask = 0u;
+  for (ManagedRegister r : callee_save_regs) {
+    Riscv64ManagedRegister reg = r.AsRiscv64();
+    if (reg.IsXRegister()) {
+      core_spill_mask |= 1u << reg.AsXRegister();
+    } else {
+      DCHECK(reg.IsFRegister());
+      fp_spill_mask |= 1u << reg.AsFRegister();
+    }
+  }
+  DCHECK_EQ(callee_save_regs.size(),
+            dchecked_integral_cast<size_t>(POPCOUNT(core_spill_mask) + POPCOUNT(fp_spill_mask)));
+  return {core_spill_mask, fp_spill_mask};
+}
+
+#define __ asm_.
+
+Riscv64JNIMacroAssembler::~Riscv64JNIMacroAssembler() {
+}
+
+void Riscv64JNIMacroAssembler::FinalizeCode() {
+  __ FinalizeCode();
+}
+
+void Riscv64JNIMacroAssembler::BuildFrame(size_t frame_size,
+                                          ManagedRegister method_reg,
+                                          ArrayRef<const ManagedRegister> callee_save_regs) {
+  // Increase frame to required size.
+  DCHECK_ALIGNED(frame_size, kStackAlignment);
+  // Must at least have space for Method* if we're going to spill it.
+  DCHECK_GE(frame_size,
+            (callee_save_regs.size() + (method_reg.IsRegister() ? 1u : 0u)) * kSpillSize);
+  IncreaseFrameSize(frame_size);
+
+  // Save callee-saves. The frame layout must match `Riscv64Context::FillCalleeSaves()`:
+  // RA at the top, then other core registers from the highest down to the lowest,
+  // followed by FP registers from the highest down to the lowest.
+  auto [core_spill_mask, fp_spill_mask] = GetCoreAndFpSpillMasks(callee_save_regs);
+  size_t offset = frame_size;
+  if ((core_spill_mask & (1u << RA)) != 0u) {
+    offset -= kSpillSize;
+    __ Stored(RA, SP, offset);
+    __ cfi().RelOffset(dwarf::Reg::Riscv64Core(RA), offset);
+  }
+  for (uint32_t reg : HighToLowBits(core_spill_mask & ~(1u << RA))) {
+    offset -= kSpillSize;
+    __ Stored(enum_cast<XRegister>(reg), SP, offset);
+    __ cfi().RelOffset(dwarf::Reg::Riscv64Core(enum_cast<XRegister>(reg)), offset);
+  }
+  for (uint32_t reg : HighToLowBits(fp_spill_mask)) {
+    offset -= kSpillSize;
+    __ FStored(enum_cast<FRegister>(reg), SP, offset);
+    __ cfi().RelOffset(dwarf::Reg::Riscv64Fp(enum_cast<FRegister>(reg)), offset);
+  }
+
+  if (method_reg.IsRegister()) {
+    // Write ArtMethod*.
+    DCHECK_EQ(A0, method_reg.AsRiscv64().AsXRegister());
+    __ Stored(A0, SP, 0);
+  }
+}
+
+void Riscv64JNIMacroAssembler::RemoveFrame(size_t frame_size,
+                                           ArrayRef<const ManagedRegister> callee_save_regs,
+                                           bool may_suspend ATTRIBUTE_UNUSED) {
+  cfi().RememberState();
+
+  // Restore callee-saves.
+  auto [core_spill_mask, fp_spill_mask] = GetCoreAndFpSpillMasks(callee_save_regs);
+  size_t offset = frame_size;
+  if ((core_spill_mask & (1u << RA)) != 0u) {
+    offset -= kSpillSize;
+    __ Loadd(RA, SP, offset);
+    __ cfi().Restore(dwarf::Reg::Riscv64Core(RA));
+  }
+  for (uint32_t reg : HighToLowBits(core_spill_mask & ~(1u << RA))) {
+    offset -= kSpillSize;
+    __ Loadd(enum_cast<XRegister>(reg), SP, offset);
+    __ cfi().Restore(dwarf::Reg::Riscv64Core(enum_cast<XRegister>(reg)));
+  }
+  for (uint32_t reg : HighToLowBits(fp_spill_mask)) {
+    offset -= kSpillSize;
+    __ FLoadd(enum_cast<FRegister>(reg), SP, offset);
+    __ cfi().Restore(dwarf::Reg::Riscv64Fp(enum_cast<FRegister>(reg)));
+  }
+
+  // Note: There is no marking register to refresh on riscv64; the GC marking state is
+  // always loaded from the Thread when needed, so `may_suspend` does not matter here.
+
+  // Decrease the frame size.
+  DecreaseFrameSize(frame_size);
+
+  // Return to RA.
+  __ Ret();
+
+  // The CFI should be restored for any code that follows the exit block.
+  __ cfi().RestoreState();
+  __ cfi().DefCFAOffset(frame_size);
+}
+
+void Riscv64JNIMacroAssembler::IncreaseFrameSize(size_t adjust) {
+  if (adjust != 0u) {
+    CHECK_ALIGNED(adjust, kStackAlignment);
+    __ AddConst64(SP, SP, -static_cast<int64_t>(adjust));
+    __ cfi().AdjustCFAOffset(adjust);
+  }
+}
+
+void Riscv64JNIMacroAssembler::DecreaseFrameSize(size_t adjust) {
+  if (adjust != 0u) {
+    CHECK_ALIGNED(adjust, kStackAlignment);
+    __ AddConst64(SP, SP, adjust);
+    __ cfi().AdjustCFAOffset(-adjust);
+  }
+}
+
+ManagedRegister Riscv64JNIMacroAssembler::CoreRegisterWithSize(ManagedRegister src, size_t size) {
+  DCHECK(src.AsRiscv64().IsXRegister());
+  DCHECK(size == 4u || size == 8u) << size;
+  // There is no separate 32-bit view of the core registers on riscv64.
+  return src;
+}
+
+void Riscv64JNIMacroAssembler::Store(FrameOffset offs, ManagedRegister m_src, size_t size) {
+  Store(Riscv64ManagedRegister::FromXRegister(SP), MemberOffset(offs.Int32Value()), m_src, size);
+}
+
+void Riscv64JNIMacroAssembler::Store(ManagedRegister m_base,
+                                     MemberOffset offs,
+                                     ManagedRegister m_src,
+                                     size_t size) {
+  Riscv64ManagedRegister base = m_base.AsRiscv64();
+  Riscv64ManagedRegister src = m_src.AsRiscv64();
+  if (src.IsXRegister()) {
+    if (size == 4u) {
+      __ Storew(src.AsXRegister(), base.AsXRegister(), offs.Int32Value());
+    } else {
+      CHECK_EQ(8u, size);
+      __ Stored(src.AsXRegister(), base.AsXRegister(), offs.Int32Value());
+    }
+  } else {
+    CHECK(src.IsFRegister()) << src;
+    if (size == 4u) {
+      __ FStorew(src.AsFRegister(), base.AsXRegister(), offs.Int32Value());
+    } else {
+      CHECK_EQ(8u, size);
+      __ FStored(src.AsFRegister(), base.AsXRegister(), offs.Int32Value());
+    }
+  }
+}
+
+void Riscv64JNIMacroAssembler::StoreRawPtr(FrameOffset offs, ManagedRegister m_src) {
+  Riscv64ManagedRegister sp = Riscv64ManagedRegister::FromXRegister(SP);
+  Store(sp, MemberOffset(offs.Int32Value()), m_src, static_cast<size_t>(kRiscv64PointerSize));
+}
+
+void Riscv64JNIMacroAssembler::StoreStackPointerToThread(ThreadOffset64 offs, bool tag_sp) {
+  XRegister scratch = TMP2;  // Note: TMP may be needed by `Stored()` for a large offset.
+  if (tag_sp) {
+    __ Ori(scratch, SP, 0x2);
+  } else {
+    __ Mv(scratch, SP);
+  }
+  __ Stored(scratch, TR, offs.Int32Value());
+}
+
+void Riscv64JNIMacroAssembler::Load(ManagedRegister m_dest, FrameOffset offs, size_t size) {
+  Load(m_dest.AsRiscv64(), SP, offs.Int32Value(), size);
+}
+
+void Riscv64JNIMacroAssembler::Load(ManagedRegister m_dest,
+                                    ManagedRegister m_base,
+                                    MemberOffset offs,
+                                    size_t size) {
+  Load(m_dest.AsRiscv64(), m_base.AsRiscv64().AsXRegister(), offs.Int32Value(), size);
+}
+
+void Riscv64JNIMacroAssembler::Load(Riscv64ManagedRegister dest,
+                                    XRegister base,
+                                    int32_t offset,
+                                    size_t size) {
+  if (dest.IsXRegister()) {
+    if (size == 4u) {
+      // The only 32-bit values loaded through this interface are references and cookies,
+      // so we zero-extend them. Managed 32-bit arguments are loaded in `MoveArguments()`.
+      __ Loadwu(dest.AsXRegister(), base, offset);
+    } else {
+      CHECK_EQ(8u, size);
+      __ Loadd(dest.AsXRegister(), base, offset);
+    }
+  } else {
+    CHECK(dest.IsFRegister()) << dest;
+    if (size == 4u) {
+      __ FLoadw(dest.AsFRegister(), base, offset);
+    } else {
+      CHECK_EQ(8u, size);
+      __ FLoadd(dest.AsFRegister(), base, offset);
+    }
+  }
+}
+
+void Riscv64JNIMacroAssembler::LoadRawPtrFromThread(ManagedRegister m_dest, ThreadOffset64 offs) {
+  Riscv64ManagedRegister tr = Riscv64ManagedRegister::FromXRegister(TR);
+  Load(m_dest, tr, MemberOffset(offs.Int32Value()), static_cast<size_t>(kRiscv64PointerSize));
+}
+
+void Riscv64JNIMacroAssembler::MoveArguments(ArrayRef<ArgumentLocation> dests,
+                                             ArrayRef<ArgumentLocation> srcs,
+                                             ArrayRef<FrameOffset> refs) {
+  size_t arg_count = dests.size();
+  DCHECK_EQ(arg_count, srcs.size());
+  DCHECK_EQ(arg_count, refs.size());
+
+  auto get_mask = [](ManagedRegister reg) -> uint64_t {
+    Riscv64ManagedRegister riscv64_reg = reg.AsRiscv64();
+    if (riscv64_reg.IsXRegister()) {
+      size_t core_reg_number = static_cast<size_t>(riscv64_reg.AsXRegister());
+      DCHECK_LT(core_reg_number, 32u);
+      return UINT64_C(1) << core_reg_number;
+    } else {
+      DCHECK(riscv64_reg.IsFRegister());
+      size_t fp_reg_number = static_cast<size_t>(riscv64_reg.AsFRegister());
+      DCHECK_LT(fp_reg_number, 32u);
+      return (UINT64_C(1) << 32u) << fp_reg_number;
+    }
+  };
+
+  // Collect registers to move while storing/copying args to stack slots.
+  // Convert all register references and copied stack references to `jobject`.
+  uint64_t src_regs = 0u;
+  uint64_t dest_regs = 0u;
+  for (size_t i = 0; i != arg_count; ++i) {
+    const ArgumentLocation& src = srcs[i];
+    const ArgumentLocation& dest = dests[i];
+    const FrameOffset ref = refs[i];
+    if (ref != kInvalidReferenceOffset) {
+      DCHECK_EQ(src.GetSize(), kObjectReferenceSize);
+      DCHECK_EQ(dest.GetSize(), static_cast<size_t>(kRiscv64PointerSize));
+    } else {
+      DCHECK_EQ(src.GetSize(), dest.GetSize());
+    }
+    if (src.IsRegister() && ref != kInvalidReferenceOffset) {
+      // Note: We can clobber `src` here as the register cannot hold more than one argument.
+      CreateJObject(src.GetRegister(), ref, src.GetRegister(), /*null_allowed=*/ i != 0u);
+    }
+    if (dest.IsRegister()) {
+      // Note: Riscv64ManagedRegister makes no distinction between 32-bit and 64-bit core
+      // registers, so the following `Equals()` can return `true` for references; the
+      // reference has already been converted to `jobject` above.
+      if (src.IsRegister() && src.GetRegister().Equals(dest.GetRegister())) {
+        // Nothing to do.
+      } else {
+        if (src.IsRegister()) {
+          src_regs |= get_mask(src.GetRegister());
+        }
+        dest_regs |= get_mask(dest.GetRegister());
+      }
+    } else {
+      if (src.IsRegister()) {
+        Store(dest.GetFrameOffset(), src.GetRegister(), dest.GetSize());
+      } else if (ref != kInvalidReferenceOffset) {
+        CreateJObject(dest.GetFrameOffset(), ref, /*null_allowed=*/ i != 0u);
+      } else {
+        Copy(dest.GetFrameOffset(), src.GetFrameOffset(), dest.GetSize());
+      }
+    }
+  }
+
+  // Fill destination registers. Convert loaded references to `jobject`.
+  // There should be no cycles, so this simple algorithm should make progress.
+  while (dest_regs != 0u) {
+    uint64_t old_dest_regs = dest_regs;
+    for (size_t i = 0; i != arg_count; ++i) {
+      const ArgumentLocation& src = srcs[i];
+      const ArgumentLocation& dest = dests[i];
+      const FrameOffset ref = refs[i];
+      if (!dest.IsRegister()) {
+        continue;  // Stored in first loop above.
+      }
+      uint64_t dest_reg_mask = get_mask(dest.GetRegister());
+      if ((dest_reg_mask & dest_regs) == 0u) {
+        continue;  // Equals source, or already filled in one of previous iterations.
+      }
+      if ((dest_reg_mask & src_regs) != 0u) {
+        continue;  // Cannot clobber this register yet.
+      }
+      if (src.IsRegister()) {
+        Move(dest.GetRegister(), src.GetRegister(), dest.GetSize());
+        src_regs &= ~get_mask(src.GetRegister());  // Allow clobbering source register.
+      } else if (ref != kInvalidReferenceOffset) {
+        CreateJObject(
+            dest.GetRegister(), ref, ManagedRegister::NoRegister(), /*null_allowed=*/ i != 0u);
+      } else if (dest.GetRegister().AsRiscv64().IsXRegister() && dest.GetSize() == 4u) {
+        // Native ABI requires 32-bit values (including FP values passed in core registers)
+        // to be sign-extended to 64 bits.
+        __ Loadw(dest.GetRegister().AsRiscv64().AsXRegister(),
+                 SP,
+                 src.GetFrameOffset().Int32Value());
+      } else {
+        Load(dest.GetRegister(), src.GetFrameOffset(), dest.GetSize());
+      }
+      dest_regs &= ~get_mask(dest.GetRegister());  // Destination register was filled.
+    }
+    CHECK_NE(old_dest_regs, dest_regs);
+    DCHECK_EQ(0u, dest_regs & ~old_dest_regs);
+  }
+}
+
+void Riscv64JNIMacroAssembler::Move(ManagedRegister m_dest, ManagedRegister m_src, size_t size) {
+  // Note: This function is used to move arguments between registers, including FP arguments
+  // passed in core registers by the native calling convention once all FP registers are used.
+  DCHECK(size == 4u || size == 8u) << size;
+  Riscv64ManagedRegister dest = m_dest.AsRiscv64();
+  Riscv64ManagedRegister src = m_src.AsRiscv64();
+  DCHECK(dest.IsXRegister() || dest.IsFRegister()) << dest;
+  DCHECK(src.IsXRegister() || src.IsFRegister()) << src;
+  if (dest.Equals(src)) {
+    return;
+  }
+  if (dest.IsXRegister()) {
+    if (src.IsXRegister()) {
+      __ Mv(dest.AsXRegister(), src.AsXRegister());
+    } else if (size == 4u) {
+      // Note: FMV.X.W sign-extends the value, as required by the native calling convention.
+      __ FMvXW(dest.AsXRegister(), src.AsFRegister());
+    } else {
+      __ FMvXD(dest.AsXRegister(), src.AsFRegister());
+    }
+  } else {
+    if (src.IsXRegister()) {
+      if (size == 4u) {
+        __ FMvWX(dest.AsFRegister(), src.AsXRegister());
+      } else {
+        __ FMvDX(dest.AsFRegister(), src.AsXRegister());
+      }
+    } else if (size == 4u) {
+      __ FMvS(dest.AsFRegister(), src.AsFRegister());
+    } else {
+      __ FMvD(dest.AsFRegister(), src.AsFRegister());
+    }
+  }
+}
+
+void Riscv64JNIMacroAssembler::Move(ManagedRegister m_dest, size_t value) {
+  DCHECK(m_dest.AsRiscv64().IsXRegister());
+  __ Li(m_dest.AsRiscv64().AsXRegister(), dchecked_integral_cast<int64_t>(value));
+}
+
+void Riscv64JNIMacroAssembler::Copy(FrameOffset dest, FrameOffset src, size_t size) {
+  DCHECK(size == 4u || size == 8u) << size;
+  XRegister scratch = TMP2;  // Note: TMP may be needed by `Storew()`/`Stored()`.
+  if (size == 4u) {
+    __ Loadw(scratch, SP, src.Int32Value());
+    __ Storew(scratch, SP, dest.Int32Value());
+  } else {
+    __ Loadd(scratch, SP, src.Int32Value());
+    __ Stored(scratch, SP, dest.Int32Value());
+  }
+}
+
+void Riscv64JNIMacroAssembler::SignExtend(ManagedRegister mreg, size_t size) {
+  Riscv64ManagedRegister reg = mreg.AsRiscv64();
+  CHECK(size == 1u || size == 2u) << size;
+  CHECK(reg.IsXRegister()) << reg;
+  if (size == 1u) {
+    __ SextB(reg.AsXRegister(), reg.AsXRegister());
+  } else {
+    __ SextH(reg.AsXRegister(), reg.AsXRegister());
+  }
+}
+
+void Riscv64JNIMacroAssembler::ZeroExtend(ManagedRegister mreg, size_t size) {
+  Riscv64ManagedRegister reg = mreg.AsRiscv64();
+  CHECK(size == 1u || size == 2u) << size;
+  CHECK(reg.IsXRegister()) << reg;
+  if (size == 1u) {
+    __ ZextB(reg.AsXRegister(), reg.AsXRegister());
+  } else {
+    __ ZextH(reg.AsXRegister(), reg.AsXRegister());
+  }
+}
+
+void Riscv64JNIMacroAssembler::GetCurrentThread(ManagedRegister dest) {
+  DCHECK(dest.AsRiscv64().IsXRegister());
+  __ Mv(dest.AsRiscv64().AsXRegister(), TR);
+}
+
+void Riscv64JNIMacroAssembler::GetCurrentThread(FrameOffset offset) {
+  __ Stored(TR, SP, offset.Int32Value());
+}
+
+void Riscv64JNIMacroAssembler::DecodeJNITransitionOrLocalJObject(ManagedRegister m_reg,
+                                                                 JNIMacroLabel* slow_path,
+                                                                 JNIMacroLabel* resume) {
+  // This implements the fast-path of `Thread::DecodeJObject()`.
+  constexpr int64_t kGlobalOrWeakGlobalMask = IndirectReferenceTable::GetGlobalOrWeakGlobalMask();
+  DCHECK(IsInt<12>(kGlobalOrWeakGlobalMask));
+  constexpr int64_t kIndirectRefKindMask = IndirectReferenceTable::GetIndirectRefKindMask();
+  DCHECK(IsInt<12>(kIndirectRefKindMask));
+  XRegister reg = m_reg.AsRiscv64().AsXRegister();
+  __ Andi(TMP, reg, kGlobalOrWeakGlobalMask);
+  __ Bnez(TMP, Riscv64JNIMacroLabel::Cast(slow_path)->AsRiscv64());
+  __ Andi(reg, reg, ~kIndirectRefKindMask);
+  __ Beqz(reg, Riscv64JNIMacroLabel::Cast(resume)->AsRiscv64());  // Skip load for null.
+  __ Loadwu(reg, reg, 0);
+}
+
+void Riscv64JNIMacroAssembler::VerifyObject(ManagedRegister m_src ATTRIBUTE_UNUSED,
+                                            bool could_be_null ATTRIBUTE_UNUSED) {
+  // TODO: not validating references.
+}
+
+void Riscv64JNIMacroAssembler::VerifyObject(FrameOffset src ATTRIBUTE_UNUSED,
+                                            bool could_be_null ATTRIBUTE_UNUSED) {
+  // TODO: not validating references.
+}
+
+void Riscv64JNIMacroAssembler::Jump(ManagedRegister m_base, Offset offs) {
+  Riscv64ManagedRegister base = m_base.AsRiscv64();
+  CHECK(base.IsXRegister()) << base;
+  XRegister scratch = TMP;
+  __ Loadd(scratch, base.AsXRegister(), offs.Int32Value());
+  __ Jr(scratch);
+}
+
+void Riscv64JNIMacroAssembler::Call(ManagedRegister m_base, Offset offs) {
+  Riscv64ManagedRegister base = m_base.AsRiscv64();
+  CHECK(base.IsXRegister()) << base;
+  __ Loadd(RA, base.AsXRegister(), offs.Int32Value());
+  __ Jalr(RA);
+}
+
+void Riscv64JNIMacroAssembler::CallFromThread(ThreadOffset64 offset) {
+  Call(Riscv64ManagedRegister::FromXRegister(TR), offset);
+}
+
+void Riscv64JNIMacroAssembler::TryToTransitionFromRunnableToNative(
+    JNIMacroLabel* label,
+    ArrayRef<const ManagedRegister> scratch_regs ATTRIBUTE_UNUSED) {
+  constexpr uint32_t kNativeStateValue = Thread::StoredThreadStateValue(ThreadState::kNative);
+  constexpr uint32_t kRunnableStateValue = Thread::StoredThreadStateValue(ThreadState::kRunnable);
+  constexpr ThreadOffset64 thread_flags_offset = Thread::ThreadFlagsOffset<kRiscv64PointerSize>();
+  constexpr ThreadOffset64 thread_held_mutex_mutator_lock_offset =
+      Thread::HeldMutexOffset<kRiscv64PointerSize>(kMutatorLock);
+
+  XRegister scratch = TMP;
+  XRegister scratch2 = TMP2;
+
+  // CAS release, old_value = kRunnableStateValue, new_value = kNativeStateValue, no flags.
+  Riscv64Label retry;
+  __ Li(scratch2, kNativeStateValue);
+  __ Bind(&retry);
+  static_assert(thread_flags_offset.Int32Value() == 0);  // LR/SC require exact address.
+  __ LrW(scratch, TR, AqRl::kNone);
+  // If any flags are set, go to the slow path.
+  static_assert(kRunnableStateValue == 0u);
+  __ Bnez(scratch, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+  __ ScW(scratch, scratch2, TR, AqRl::kRelease);
+  __ Bnez(scratch, &retry);
+
+  // Clear `self->tlsPtr_.held_mutexes[kMutatorLock]`.
+  __ Stored(Zero, TR, thread_held_mutex_mutator_lock_offset.Int32Value());
+}
+
+void Riscv64JNIMacroAssembler::TryToTransitionFromNativeToRunnable(
+    JNIMacroLabel* label,
+    ArrayRef<const ManagedRegister> scratch_regs ATTRIBUTE_UNUSED,
+    ManagedRegister return_reg ATTRIBUTE_UNUSED) {
+  constexpr uint32_t kNativeStateValue = Thread::StoredThreadStateValue(ThreadState::kNative);
+  constexpr uint32_t kRunnableStateValue = Thread::StoredThreadStateValue(ThreadState::kRunnable);
+  constexpr ThreadOffset64 thread_flags_offset = Thread::ThreadFlagsOffset<kRiscv64PointerSize>();
+  constexpr ThreadOffset64 thread_held_mutex_mutator_lock_offset =
+      Thread::HeldMutexOffset<kRiscv64PointerSize>(kMutatorLock);
+  constexpr ThreadOffset64 thread_mutator_lock_offset =
+      Thread::MutatorLockOffset<kRiscv64PointerSize>();
+
+  // Note: `TMP2` is used for the value stored below as `Stored()` cannot store from `TMP`.
+  XRegister scratch = TMP2;
+  XRegister scratch2 = TMP;
+
+  // CAS acquire, old_value = kNativeStateValue, new_value = kRunnableStateValue, no flags.
+  Riscv64Label retry;
+  __ Li(scratch2, kNativeStateValue);
+  __ Bind(&retry);
+  static_assert(thread_flags_offset.Int32Value() == 0);  // LR/SC require exact address.
+  __ LrW(scratch, TR, AqRl::kAcquire);
+  // If any flags are set, or the state is not Native, go to the slow path.
+  // (While the thread can theoretically transition between different Suspended states,
+  // it would be very unexpected to see a state other than Native at this point.)
+  __ Bne(scratch, scratch2, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+  static_assert(kRunnableStateValue == 0u);
+  __ ScW(scratch, Zero, TR, AqRl::kNone);
+  __ Bnez(scratch, &retry);
+
+  // Set `self->tlsPtr_.held_mutexes[kMutatorLock]` to the mutator lock.
+  __ Loadd(scratch, TR, thread_mutator_lock_offset.Int32Value());
+  __ Stored(scratch, TR, thread_held_mutex_mutator_lock_offset.Int32Value());
+}
+
+void Riscv64JNIMacroAssembler::SuspendCheck(JNIMacroLabel* label) {
+  XRegister scratch = TMP;
+  static_assert(IsInt<12>(Thread::SuspendOrCheckpointRequestFlags()));
+  __ Loadw(scratch, TR, Thread::ThreadFlagsOffset<kRiscv64PointerSize>().Int32Value());
+  __ Andi(scratch, scratch, Thread::SuspendOrCheckpointRequestFlags());
+  __ Bnez(scratch, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+}
+
+void Riscv64JNIMacroAssembler::ExceptionPoll(JNIMacroLabel* label) {
+  XRegister scratch = TMP;
+  __ Loadd(scratch, TR, Thread::ExceptionOffset<kRiscv64PointerSize>().Int32Value());
+  __ Bnez(scratch, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+}
+
+void Riscv64JNIMacroAssembler::DeliverPendingException() {
+  // Pass exception object as argument.
+  // Don't care about preserving A0 as this won't return.
+  // Note: The scratch register from `ExceptionPoll()` may have been clobbered.
+  __ Loadd(A0, TR, Thread::ExceptionOffset<kRiscv64PointerSize>().Int32Value());
+  __ Loadd(RA, TR, QUICK_ENTRYPOINT_OFFSET(kRiscv64PointerSize, pDeliverException).Int32Value());
+  __ Jalr(RA);
+  // Call should never return.
+  __ Unimp();
+}
+
+std::unique_ptr<JNIMacroLabel> Riscv64JNIMacroAssembler::CreateLabel() {
+  return std::unique_ptr<JNIMacroLabel>(new Riscv64JNIMacroLabel());
+}
+
+void Riscv64JNIMacroAssembler::Jump(JNIMacroLabel* label) {
+  CHECK(label != nullptr);
+  __ J(Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+}
+
+void Riscv64JNIMacroAssembler::TestGcMarking(JNIMacroLabel* label, JNIMacroUnaryCondition cond) {
+  CHECK(label != nullptr);
+
+  DCHECK_EQ(Thread::IsGcMarkingSize(), 4u);
+  DCHECK(gUseReadBarrier);
+
+  XRegister test_reg = TMP;
+  int32_t is_gc_marking_offset = Thread::IsGcMarkingOffset<kRiscv64PointerSize>().Int32Value();
+  __ Loadw(test_reg, TR, is_gc_marking_offset);
+  switch (cond) {
+    case JNIMacroUnaryCondition::kZero:
+      __ Beqz(test_reg, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+      break;
+    case JNIMacroUnaryCondition::kNotZero:
+      __ Bnez(test_reg, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+      break;
+    default:
+      LOG(FATAL) << "Not implemented unary condition: " << static_cast<int>(cond);
+      UNREACHABLE();
+  }
+}
+
+void Riscv64JNIMacroAssembler::TestMarkBit(ManagedRegister m_ref,
+                                           JNIMacroLabel* label,
+                                           JNIMacroUnaryCondition cond) {
+  XRegister ref = m_ref.AsRiscv64().AsXRegister();
+  XRegister scratch = TMP;
+  __ Loadw(scratch, ref, mirror::Object::MonitorOffset().Int32Value());
+  // Move the bit we want to check to the sign bit, so that we can use BGEZ/BLTZ
+  // to check it. Extracting the bit for BEQZ/BNEZ would require one more instruction.
+  static_assert(LockWord::kMarkBitStateSize == 1u);
+  __ Slliw(scratch, scratch, 31 - LockWord::kMarkBitStateShift);
+  switch (cond) {
+    case JNIMacroUnaryCondition::kZero:
+      __ Bgez(scratch, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+      break;
+    case JNIMacroUnaryCondition::kNotZero:
+      __ Bltz(scratch, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+      break;
+    default:
+      LOG(FATAL) << "Not implemented unary condition: " << static_cast<int>(cond);
+      UNREACHABLE();
+  }
+}
+
+void Riscv64JNIMacroAssembler::TestByteAndJumpIfNotZero(uintptr_t address, JNIMacroLabel* label) {
+  int32_t small_offset = dchecked_integral_cast<int32_t>(address & 0xfff) -
+                         dchecked_integral_cast<int32_t>((address & 0x800) << 1);
+  int64_t remainder = static_cast<int64_t>(address) - small_offset;
+  XRegister scratch = TMP;
+  __ Li(scratch, remainder);
+  __ Lb(scratch, scratch, small_offset);
+  __ Bnez(scratch, Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+}
+
+void Riscv64JNIMacroAssembler::Bind(JNIMacroLabel* label) {
+  CHECK(label != nullptr);
+  __ Bind(Riscv64JNIMacroLabel::Cast(label)->AsRiscv64());
+}
+
+void Riscv64JNIMacroAssembler::CreateJObject(ManagedRegister m_dest,
+                                             FrameOffset spilled_reference_offset,
+                                             ManagedRegister m_ref,
+                                             bool null_allowed) {
+  Riscv64ManagedRegister dest = m_dest.AsRiscv64();
+  Riscv64ManagedRegister ref = m_ref.AsRiscv64();
+  DCHECK(dest.IsXRegister());
+  DCHECK(ref.IsXRegister() || ref.IsNoRegister());
+
+  Riscv64Label null_label;
+  if (null_allowed) {
+    if (ref.IsNoRegister()) {
+      // Load the reference to check for null.
+      Load(dest, SP, spilled_reference_offset.Int32Value(), kObjectReferenceSize);
+      ref = dest;
+    } else if (!dest.Equals(ref)) {
+      // Null values get a jobject value null. Otherwise, the jobject is
+      // the address of the spilled reference.
+      // e.g. dest = (ref == 0) ? 0 : (SP+spilled_reference_offset)
+      __ Li(dest.AsXRegister(), 0);
+    }
+    __ Beqz(ref.AsXRegister(), &null_label);
+  }
+  __ AddConst64(dest.AsXRegister(), SP, spilled_reference_offset.Int32Value());
+  if (null_allowed) {
+    __ Bind(&null_label);
+  }
+}
+
+void Riscv64JNIMacroAssembler::CreateJObject(FrameOffset out_off,
+                                             FrameOffset spilled_reference_offset,
+                                             bool null_allowed) {
+  // Note: TMP may be needed by `AddConst64()` and `Stored()`, so use `TMP2` for the value.
+  XRegister scratch = TMP2;
+  Riscv64ManagedRegister scratch_reg = Riscv64ManagedRegister::FromXRegister(scratch);
+  CreateJObject(scratch_reg, spilled_reference_offset, ManagedRegister::NoRegister(), null_allowed);
+  __ Stored(scratch, SP, out_off.Int32Value());
+}
+
+#undef __
+
+}  // namespace riscv64
+}  // namespace art
@@ -73,6 +73,7 @@
 #include "compiler_callbacks.h"
 #include "debug/elf_debug_writer.h"
 #include "debug/method_debug_info.h"
+#include "dex/art_dex_file_loader.h"
 #include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
@@ -681,6 +682,10 @@ class Dex2Oat final {
       Usage("Can't have both --input-vdex-fd and --input-vdex");
     }
 
+    if (!input_vdex_dex_file_.empty() && input_vdex_fd_ == -1 && input_vdex_.empty()) {
+      Usage("--input-vdex-dex-file requires --input-vdex-fd or --input-vdex");
+    }
+
     if (output_vdex_fd_ != -1 && !output_vdex_.empty()) {
       Usage("Can't have both --output-vdex-fd and --output-vdex");
     }
@@ -860,6 +865,7 @@ class Dex2Oat final {
         FALLTHROUGH_INTENDED;
       case InstructionSet::kArm:
       case InstructionSet::kThumb2:
+      case InstructionSet::kRiscv64:
       case InstructionSet::kX86:
       case InstructionSet::kX86_64:
         compiler_options_->implicit_null_checks_ = true;
@@ -1080,6 +1086,7 @@ class Dex2Oat final {
     AssignIfExists(args, M::InputVdexFd, &input_vdex_fd_);
     AssignIfExists(args, M::OutputVdexFd, &output_vdex_fd_);
     AssignIfExists(args, M::InputVdex, &input_vdex_);
+    AssignIfExists(args, M::InputVdexDexFile, &input_vdex_dex_file_);
     AssignIfExists(args, M::OutputVdex, &output_vdex_);
     AssignIfExists(args, M::DmFd, &dm_fd_);
     AssignIfExists(args, M::DmFile, &dm_file_location_);
@@ -1502,9 +1509,10 @@ class Dex2Oat final {
         std::vector<MemMap> opened_dex_files_map;
         std::vector<std::unique_ptr<const DexFile>> opened_dex_files;
         // No need to verify the dex file when we have a vdex file, which means it was already
-        // verified.
+        // verified, unless the vdex may be for a previous version of the dex file.
         const bool verify =
-            (input_vdex_file_ == nullptr) && !compiler_options_->AssumeDexFilesAreVerified();
+            (input_vdex_file_ == nullptr || !input_vdex_dex_file_.empty()) &&
+            !compiler_options_->AssumeDexFilesAreVerified();
         if (!oat_writers_[i]->WriteAndOpenDexFiles(
             vdex_files_[i].get(),
             verify,
@@ -1754,7 +1762,26 @@ class Dex2Oat final {
     // Setup VerifierDeps for compilation and report if we fail to parse the data.
     // When we do profile guided optimizations, the compiler currently needs to run
     // full verification.
-    if (!DoProfileGuidedOptimizations() && input_vdex_file_ != nullptr) {
+    if (!DoProfileGuidedOptimizations() && !input_vdex_dex_files_.empty()) {
+      // The input vdex is for a previous version of the dex files. Reuse the verification of
+      // the classes that did not change, the other classes get verified again.
+      std::vector<const DexFile*> old_dex_files = MakeNonOwningPointerVector(input_vdex_dex_files_);
+      verifier::VerifierDeps old_verifier_deps(old_dex_files, /*output_only=*/ false);
+      if (!old_verifier_deps.ParseStoredData(old_dex_files,
+                                             input_vdex_file_->GetVerifierDepsData())) {
+        return dex2oat::ReturnCode::kOther;
+      }
+      std::unique_ptr<verifier::VerifierDeps> verifier_deps(
+          new verifier::VerifierDeps(dex_files));
+      size_t num_reused = 0u;
+      for (size_t i = 0, size = std::min(dex_files.size(), old_dex_files.size()); i != size; ++i) {
+        num_reused += verifier_deps->ReuseUnchangedClasses(
+            *dex_files[i], *old_dex_files[i], old_verifier_deps);
+      }
+      VLOG(compiler) << "Reusing the verification of " << num_reused
+                     << " unchanged classes from the input vdex";
+      callbacks_->SetVerifierDeps(verifier_deps.release());
+    } else if (!DoProfileGuidedOptimizations() && input_vdex_file_ != nullptr) {
       std::unique_ptr<verifier::VerifierDeps> verifier_deps(
           new verifier::VerifierDeps(dex_files, /*output_only=*/ false));
       if (!verifier_deps->ParseStoredData(dex_files, input_vdex_file_->GetVerifierDepsData())) {
@@ -1781,6 +1808,10 @@ class Dex2Oat final {
       // Nothing to validate
       return true;
     }
+    if (!input_vdex_dex_file_.empty() && !InputVdexChecksumsMatch()) {
+      // The input vdex is for a previous version of the dex files.
+      return OpenInputVdexDexFiles();
+    }
     if (input_vdex_file_->GetNumberOfDexFiles()
           != compiler_options_->dex_files_for_oat_file_.size()) {
       LOG(ERROR) << "Vdex file contains a different number of dex files than the source. "
@@ -1805,6 +1836,59 @@ class Dex2Oat final {
     return true;
   }
 
+  bool InputVdexChecksumsMatch() const {
+    const std::vector<const DexFile*>& dex_files = compiler_options_->dex_files_for_oat_file_;
+    if (input_vdex_file_->GetNumberOfDexFiles() != dex_files.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < dex_files.size(); i++) {
+      if (dex_files[i]->GetLocationChecksum() != input_vdex_file_->GetLocationChecksum(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Opens the dex files the input vdex was generated for, so that the verification of the
+  // classes that did not change since can be reused.
+  bool OpenInputVdexDexFiles() {
+    if (use_existing_vdex_) {
+      LOG(ERROR) << "Cannot update the input vdex in place for different dex files";
+      return false;
+    }
+    std::string error_msg;
+    ArtDexFileLoader dex_file_loader(input_vdex_dex_file_);
+    if (!dex_file_loader.Open(/*verify=*/ false,
+                              /*verify_checksum=*/ true,
+                              &error_msg,
+                              &input_vdex_dex_files_)) {
+      LOG(ERROR) << "Failed to open the dex files of the input vdex " << input_vdex_dex_file_
+                 << ": " << error_msg;
+      return false;
+    }
+    if (input_vdex_dex_files_.size() != input_vdex_file_->GetNumberOfDexFiles()) {
+      LOG(ERROR) << "Vdex file contains a different number of dex files than "
+                 << input_vdex_dex_file_
+                 << " vdex_num=" << input_vdex_file_->GetNumberOfDexFiles()
+                 << " dex_num=" << input_vdex_dex_files_.size();
+      return false;
+    }
+    for (size_t i = 0; i < input_vdex_dex_files_.size(); i++) {
+      uint32_t dex_checksum = input_vdex_dex_files_[i]->GetLocationChecksum();
+      uint32_t vdex_checksum = input_vdex_file_->GetLocationChecksum(i);
+      if (dex_checksum != vdex_checksum) {
+        LOG(ERROR) << "Vdex file checksum different than " << input_vdex_dex_file_
+                   << " checksum for position " << i
+                   << std::hex
+                   << " vdex_checksum=0x" << vdex_checksum
+                   << " dex_checksum=0x" << dex_checksum
+                   << std::dec;
+        return false;
+      }
+    }
+    return true;
+  }
+
   // If we need to keep the oat file open for the image writer.
   bool ShouldKeepOatFileOpen() const {
     return IsImage() && oat_fd_ != File::kInvalidFd;
@@ -2222,6 +2306,9 @@ class Dex2Oat final {
         VLOG(compiler) << "Oat file written successfully: " << oat_filenames_[i];
 
         oat_writer.reset();
+        // The code of this oat file has been written out, so its compiled methods are not
+        // needed anymore. Release them before writing the next oat file.
+        driver_->FreeCompiledMethods(dex_files_per_oat_file_[i]);
         // We may still need the ELF writer later for stripping.
       }
     }
@@ -2803,7 +2890,8 @@ class Dex2Oat final {
     }
     if (!image_writer_->Write(IsAppImage() ? app_image_fd_ : image_fd_,
                               image_filenames_,
-                              IsAppImage() ? 1u : dex_locations_.size())) {
+                              IsAppImage() ? 1u : dex_locations_.size(),
+                              thread_count_)) {
       LOG(ERROR) << "Failure during image file creation";
       return false;
     }
@@ -2959,6 +3047,9 @@ class Dex2Oat final {
   std::string input_vdex_;
   std::string output_vdex_;
   std::unique_ptr<VdexFile> input_vdex_file_;
+  std::string input_vdex_dex_file_;
+  // Dex files the input vdex was generated for, if they differ from the ones being compiled.
+  std::vector<std::unique_ptr<const DexFile>> input_vdex_dex_files_;
   int dm_fd_;
   std::string dm_file_location_;
   std::unique_ptr<ZipArchive> dm_file_;
@@ -117,6 +117,12 @@ static void AddGeneratedArtifactMappings(Builder& builder) {
           .WithType<std::string>()
           .WithHelp("specifies the vdex input source via a filename.")
           .IntoKey(M::InputVdex)
+      .Define("--input-vdex-dex-file=_")
+          .WithType<std::string>()
+          .WithHelp("specifies the dex or apk file the input vdex was generated for. If the dex\n"
+                    "files being compiled are a newer version of it, the verification of the\n"
+                    "classes that did not change is reused from the input vdex.")
+          .IntoKey(M::InputVdexDexFile)
       .Define("--output-vdex-fd=_")
           .WithHelp("specifies the vdex output destination via a file descriptor.")
           .WithType<int>()
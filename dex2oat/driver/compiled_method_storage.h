@@ -114,13 +114,17 @@ class CompiledMethodStorage final : public CompiledCodeStorage {
   template <typename T>
   class LengthPrefixedArrayAlloc;
 
+  // Number of independently locked shards of each dedupe set. Every compiled method adds its
+  // code, stack maps, CFI and patches, so with many compiler threads a few shards are contended.
+  static constexpr size_t kDedupeShards = 16u;
+
   template <typename T>
   using ArrayDedupeSet = DedupeSet<ArrayRef<const T>,
                                    LengthPrefixedArray<T>,
                                    LengthPrefixedArrayAlloc<T>,
                                    size_t,
                                    DedupeHashFunc<const T>,
-                                   4>;
+                                   kDedupeShards>;
 
   // Swap pool and allocator used for native allocations. May be file-backed. Needs to be first
   // as other fields rely on this.
@@ -22,6 +22,7 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
 #include <string_view>
 #include <vector>
 
@@ -1490,11 +1491,52 @@ class ParallelCompilationManager {
     thread_pool_->StopWorkers(self);
   }
 
+  // Like ForAll() over the class defs of the dex file, but hands out the classes with the most
+  // dex code first. A few big classes at the end of the dex file would otherwise keep one worker
+  // busy long after the others ran out of work.
+  void ForAllClassDefsByCost(CompilationVisitor* visitor, size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    ForAllClassDefsByCostLambda([visitor](size_t index) { visitor->Visit(index); }, work_units);
+  }
+
+  template <typename Fn>
+  void ForAllClassDefsByCostLambda(Fn fn, size_t work_units) REQUIRES(!*Locks::mutator_lock_) {
+    const size_t num_class_defs = GetDexFile()->NumClassDefs();
+    if (work_units == 1u) {
+      // Keep the dex file order when running single-threaded, there is nothing to balance.
+      ForAllLambda(0, num_class_defs, fn, work_units);
+      return;
+    }
+    std::vector<uint32_t> order = GetClassDefsByDecreasingCost();
+    ForAllLambda(0, num_class_defs, [&order, &fn](size_t i) { fn(order[i]); }, work_units);
+  }
+
   size_t NextIndex() {
     return index_.fetch_add(1, std::memory_order_seq_cst);
   }
 
  private:
+  // Returns the class def indexes sorted by decreasing size of the code of their methods, which
+  // is a cheap estimate of the cost of verifying, initializing or compiling the class. Classes
+  // with the same cost keep their dex file order.
+  std::vector<uint32_t> GetClassDefsByDecreasingCost() const {
+    const DexFile& dex_file = *GetDexFile();
+    const size_t num_class_defs = dex_file.NumClassDefs();
+    std::vector<uint64_t> costs(num_class_defs, 0u);
+    std::vector<uint32_t> order(num_class_defs);
+    for (uint32_t class_def_index = 0; class_def_index != num_class_defs; ++class_def_index) {
+      ClassAccessor accessor(dex_file, class_def_index);
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        costs[class_def_index] += method.GetInstructions().InsnsSizeInCodeUnits();
+      }
+      order[class_def_index] = class_def_index;
+    }
+    std::stable_sort(order.begin(), order.end(), [&costs](uint32_t lhs, uint32_t rhs) {
+      return costs[lhs] > costs[rhs];
+    });
+    return order;
+  }
+
   template <typename Fn>
   class ForAllClosureLambda : public Task {
    public:
@@ -1797,6 +1839,46 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
   return true;
 }
 
+void CompilerDriver::VerifyReusedClasses(jobject jclass_loader,
+                                         const std::vector<const DexFile*>& dex_files,
+                                         TimingLogger* timings) {
+  verifier::VerifierDeps* verifier_deps =
+      Runtime::Current()->GetCompilerCallbacks()->GetVerifierDeps();
+  if (verifier_deps == nullptr) {
+    return;
+  }
+  TimingLogger::ScopedTiming t("Verify Reused Classes", timings);
+
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
+  if (verifier_deps->ValidateReusedClasses(soa.Self(), class_loader, dex_files) == 0u) {
+    return;
+  }
+
+  bool compiler_only_verifies =
+      !GetCompilerOptions().IsAnyCompilationEnabled() &&
+      !GetCompilerOptions().IsGeneratingImage();
+
+  // Like for fast verification, the reused classes may still need access checks.
+  for (const DexFile* dex_file : dex_files) {
+    for (ClassAccessor accessor : dex_file->GetClasses()) {
+      if (!verifier_deps->IsReusedClass(*dex_file, accessor.GetClassDefIndex())) {
+        continue;
+      }
+      if (compiler_only_verifies) {
+        ClassReference ref(dex_file, accessor.GetClassDefIndex());
+        compiled_classes_.Insert(
+            ref, ClassStatus::kNotReady, ClassStatus::kVerifiedNeedsAccessChecks);
+      } else {
+        LoadAndUpdateStatus(
+            accessor, ClassStatus::kVerifiedNeedsAccessChecks, class_loader, soa.Self());
+      }
+    }
+  }
+}
+
 void CompilerDriver::Verify(jobject jclass_loader,
                             const std::vector<const DexFile*>& dex_files,
                             TimingLogger* timings) {
@@ -1804,6 +1886,9 @@ void CompilerDriver::Verify(jobject jclass_loader,
     return;
   }
 
+  // Classes reused from a previous version of the dex files do not need to be verified again.
+  VerifyReusedClasses(jclass_loader, dex_files, timings);
+
   // If there is no existing `verifier_deps` (because of non-existing vdex), or
   // the existing `verifier_deps` is not valid anymore, create a new one. The
   // verifier will need it to record the new dependencies. Then dex2oat can update
@@ -1855,12 +1940,18 @@ class VerifyClassVisitor : public CompilationVisitor {
   VerifyClassVisitor(const ParallelCompilationManager* manager, verifier::HardFailLogMode log_level)
      : manager_(manager),
        log_level_(log_level),
-       sdk_version_(Runtime::Current()->GetTargetSdkVersion()) {}
+       sdk_version_(Runtime::Current()->GetTargetSdkVersion()),
+       main_verifier_deps_(Runtime::Current()->GetCompilerCallbacks()->GetVerifierDeps()) {}
 
   void Visit(size_t class_def_index) REQUIRES(!Locks::mutator_lock_) override {
     ScopedTrace trace(__FUNCTION__);
-    ScopedObjectAccess soa(Thread::Current());
     const DexFile& dex_file = *manager_->GetDexFile();
+    if (main_verifier_deps_ != nullptr &&
+        main_verifier_deps_->IsReusedClass(dex_file, class_def_index)) {
+      // Already handled by CompilerDriver::VerifyReusedClasses().
+      return;
+    }
+    ScopedObjectAccess soa(Thread::Current());
     const dex::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
     const char* descriptor = dex_file.GetClassDescriptor(class_def);
     ClassLinker* class_linker = manager_->GetClassLinker();
@@ -1997,6 +2088,8 @@ class VerifyClassVisitor : public CompilationVisitor {
   const ParallelCompilationManager* const manager_;
   const verifier::HardFailLogMode log_level_;
   const uint32_t sdk_version_;
+  // Main VerifierDeps, only read during verification.
+  const verifier::VerifierDeps* const main_verifier_deps_;
 };
 
 void CompilerDriver::VerifyDexFile(jobject class_loader,
@@ -2015,7 +2108,7 @@ void CompilerDriver::VerifyDexFile(jobject class_loader,
                               ? verifier::HardFailLogMode::kLogInternalFatal
                               : verifier::HardFailLogMode::kLogWarning;
   VerifyClassVisitor visitor(&context, log_level);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  context.ForAllClassDefsByCost(&visitor, thread_count);
 
   // Make initialized classes visibly initialized.
   class_linker->MakeInitializedClassesVisiblyInitialized(Thread::Current(), /*wait=*/ true);
@@ -2207,7 +2300,7 @@ class InitializeClassVisitor : public CompilationVisitor {
                 !self->IsExceptionPending() &&
                 !compiler_options.GetDebuggable() &&
                 (compiler_options.InitializeAppImageClasses() ||
-                 NoClinitInDependency(klass, self, &class_loader));
+                 OnlySelfContainedClinitInDependency(klass, self, &class_loader));
             // TODO The checking for clinit can be removed since it's already
             // checked when init superclass. Currently keep it because it contains
             // processing of intern strings. Will be removed later when intern strings
@@ -2472,13 +2565,88 @@ class InitializeClassVisitor : public CompilationVisitor {
 
   // In this phase the classes containing class initializers are ignored. Make sure no
   // clinit appears in klass's super class chain and interfaces.
-  bool NoClinitInDependency(const Handle<mirror::Class>& klass,
-                            Thread* self,
-                            Handle<mirror::ClassLoader>* class_loader)
+  // Returns whether the class initializer only computes the static fields of its own class out
+  // of constants, so that running it at compile time cannot be observed by other classes. The
+  // strict transaction the initializer runs in still enforces this, the check only avoids
+  // running initializers that would abort it.
+  static bool IsSelfContainedClinit(ArtMethod* clinit, ObjPtr<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    const DexFile& dex_file = *clinit->GetDexFile();
+    dex::TypeIndex class_idx = klass->GetDexTypeIndex();
+    for (const DexInstructionPcPair& inst : clinit->DexInstructions()) {
+      if (inst->IsInvoke()) {
+        return false;
+      }
+      switch (inst->Opcode()) {
+        case Instruction::SGET:
+        case Instruction::SGET_WIDE:
+        case Instruction::SGET_OBJECT:
+        case Instruction::SGET_BOOLEAN:
+        case Instruction::SGET_BYTE:
+        case Instruction::SGET_CHAR:
+        case Instruction::SGET_SHORT:
+        case Instruction::SPUT:
+        case Instruction::SPUT_WIDE:
+        case Instruction::SPUT_OBJECT:
+        case Instruction::SPUT_BOOLEAN:
+        case Instruction::SPUT_BYTE:
+        case Instruction::SPUT_CHAR:
+        case Instruction::SPUT_SHORT:
+          if (dex_file.GetFieldId(inst->VRegB_21c()).class_idx_ != class_idx) {
+            return false;
+          }
+          break;
+        case Instruction::NEW_ARRAY: {
+          // Arrays of primitives and strings, as used for lookup tables.
+          std::string_view descriptor = dex_file.GetTypeDescriptorView(
+              dex_file.GetTypeId(dex::TypeIndex(inst->VRegC_22c())));
+          if (descriptor.size() != 2u && descriptor != "[Ljava/lang/String;") {
+            return false;
+          }
+          break;
+        }
+        case Instruction::IGET:
+        case Instruction::IGET_WIDE:
+        case Instruction::IGET_OBJECT:
+        case Instruction::IGET_BOOLEAN:
+        case Instruction::IGET_BYTE:
+        case Instruction::IGET_CHAR:
+        case Instruction::IGET_SHORT:
+        case Instruction::IPUT:
+        case Instruction::IPUT_WIDE:
+        case Instruction::IPUT_OBJECT:
+        case Instruction::IPUT_BOOLEAN:
+        case Instruction::IPUT_BYTE:
+        case Instruction::IPUT_CHAR:
+        case Instruction::IPUT_SHORT:
+        case Instruction::NEW_INSTANCE:
+        case Instruction::FILLED_NEW_ARRAY:
+        case Instruction::FILLED_NEW_ARRAY_RANGE:
+        case Instruction::CONST_CLASS:
+        case Instruction::CONST_METHOD_HANDLE:
+        case Instruction::CONST_METHOD_TYPE:
+        case Instruction::CHECK_CAST:
+        case Instruction::INSTANCE_OF:
+        case Instruction::MONITOR_ENTER:
+        case Instruction::MONITOR_EXIT:
+        case Instruction::THROW:
+          return false;
+        default:
+          break;
+      }
+    }
+    return true;
+  }
+
+  // Returns whether the class and its superclasses and interfaces either have no class
+  // initializer or only self-contained ones, see `IsSelfContainedClinit()`.
+  bool OnlySelfContainedClinitInDependency(const Handle<mirror::Class>& klass,
+                                           Thread* self,
+                                           Handle<mirror::ClassLoader>* class_loader)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     ArtMethod* clinit =
         klass->FindClassInitializer(manager_->GetClassLinker()->GetImagePointerSize());
-    if (clinit != nullptr) {
+    if (clinit != nullptr && !IsSelfContainedClinit(clinit, klass.Get())) {
       VLOG(compiler) << klass->PrettyClass() << ' ' << clinit->PrettyMethod(true);
       return false;
     }
@@ -2486,7 +2654,7 @@ class InitializeClassVisitor : public CompilationVisitor {
       ObjPtr<mirror::Class> super_class = klass->GetSuperClass();
       StackHandleScope<1> hs(self);
       Handle<mirror::Class> handle_scope_super(hs.NewHandle(super_class));
-      if (!NoClinitInDependency(handle_scope_super, self, class_loader)) {
+      if (!OnlySelfContainedClinitInDependency(handle_scope_super, self, class_loader)) {
         return false;
       }
     }
@@ -2497,7 +2665,7 @@ class InitializeClassVisitor : public CompilationVisitor {
       DCHECK(interface != nullptr);
       StackHandleScope<1> hs(self);
       Handle<mirror::Class> handle_interface(hs.NewHandle(interface));
-      if (!NoClinitInDependency(handle_interface, self, class_loader)) {
+      if (!OnlySelfContainedClinitInDependency(handle_interface, self, class_loader)) {
         return false;
       }
     }
@@ -2534,7 +2702,7 @@ void CompilerDriver::InitializeClasses(jobject jni_class_loader,
     init_thread_count = 1U;
   }
   InitializeClassVisitor visitor(&context);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, init_thread_count);
+  context.ForAllClassDefsByCost(&visitor, init_thread_count);
 
   // Make initialized classes visibly initialized.
   class_linker->MakeInitializedClassesVisiblyInitialized(Thread::Current(), /*wait=*/ true);
@@ -2644,7 +2812,7 @@ static void CompileDexFile(CompilerDriver* driver,
                  profile_index);
     }
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  context.ForAllClassDefsByCostLambda(compile, thread_count);
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -2771,6 +2939,23 @@ CompiledMethod* CompilerDriver::GetCompiledMethod(MethodReference ref) const {
   return compiled_method;
 }
 
+void CompilerDriver::FreeCompiledMethods(const std::vector<const DexFile*>& dex_files) {
+  for (const DexFile* dex_file : dex_files) {
+    if (!compiled_methods_.HaveDexFile(dex_file)) {
+      continue;
+    }
+    const uint32_t num_method_ids = dex_file->NumMethodIds();
+    for (uint32_t method_idx = 0; method_idx != num_method_ids; ++method_idx) {
+      CompiledMethod* compiled_method = nullptr;
+      compiled_methods_.Remove(MethodReference(dex_file, method_idx), &compiled_method);
+      if (compiled_method != nullptr) {
+        CompiledMethod::ReleaseSwapAllocatedCompiledMethod(GetCompiledMethodStorage(),
+                                                           compiled_method);
+      }
+    }
+  }
+}
+
 std::string CompilerDriver::GetMemoryUsageString(bool extended) const {
   std::ostringstream oss;
   const gc::Heap* const heap = Runtime::Current()->GetHeap();
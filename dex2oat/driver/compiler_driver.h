@@ -140,6 +140,9 @@ class CompilerDriver {
   // Add a compiled method.
   void AddCompiledMethod(const MethodReference& method_ref, CompiledMethod* const compiled_method);
   CompiledMethod* RemoveCompiledMethod(const MethodReference& method_ref);
+  // Release the compiled methods of `dex_files`. Used once their oat file has been written
+  // to reduce the peak memory usage when writing multiple oat files.
+  void FreeCompiledMethods(const std::vector<const DexFile*>& dex_files);
 
   // Resolve compiling method's class. Returns null on failure.
   ObjPtr<mirror::Class> ResolveCompilingMethodsClass(const ScopedObjectAccess& soa,
@@ -251,6 +254,12 @@ class CompilerDriver {
                   const std::vector<const DexFile*>& dex_files,
                   TimingLogger* timings);
 
+  // Validate the dependencies of the classes whose verification was reused from a previous
+  // version of the dex files, and update the status of those still reused.
+  void VerifyReusedClasses(jobject class_loader,
+                           const std::vector<const DexFile*>& dex_files,
+                           TimingLogger* timings);
+
   void Verify(jobject class_loader,
               const std::vector<const DexFile*>& dex_files,
               TimingLogger* timings);
@@ -116,6 +116,9 @@ class ImageTest : public CommonCompilerDriverTest {
     return nullptr;
   }
 
+  // Number of threads passed to ImageWriter::Write() for copying and fixing up objects.
+  size_t image_writer_thread_count_ = 1u;
+
  private:
   void DoCompile(ImageHeader::StorageMode storage_mode, /*out*/ CompilationHelper& out_helper);
 
@@ -340,7 +343,8 @@ inline void ImageTest::DoCompile(ImageHeader::StorageMode storage_mode,
 
     bool success_image = writer->Write(File::kInvalidFd,
                                        image_filenames,
-                                       image_filenames.size());
+                                       image_filenames.size(),
+                                       image_writer_thread_count_);
     ASSERT_TRUE(success_image);
   }
 }
@@ -151,10 +151,15 @@ TEST_F(ImageWriteReadTest, WriteReadLZ4HC) {
                 /*max_image_block_size=*/std::numeric_limits<uint32_t>::max());
 }
 
-
 TEST_F(ImageWriteReadTest, WriteReadLZ4HCKBBlock) {
   TestWriteRead(ImageHeader::kStorageModeLZ4HC, /*max_image_block_size=*/KB);
 }
 
+TEST_F(ImageWriteReadTest, WriteReadUncompressedMultiThreaded) {
+  image_writer_thread_count_ = 4u;
+  TestWriteRead(ImageHeader::kStorageModeUncompressed,
+                /*max_image_block_size=*/std::numeric_limits<uint32_t>::max());
+}
+
 }  // namespace linker
 }  // namespace art
@@ -84,6 +84,7 @@
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "subtype_check.h"
+#include "thread_pool.h"
 #include "well_known_classes-inl.h"
 
 using ::art::mirror::Class;
@@ -331,7 +332,8 @@ bool ImageWriter::IsInternedAppImageStringReference(ObjPtr<mirror::Object> refer
 
 bool ImageWriter::Write(int image_fd,
                         const std::vector<std::string>& image_filenames,
-                        size_t component_count) {
+                        size_t component_count,
+                        size_t thread_count) {
   // If image_fd or oat_fd are not File::kInvalidFd then we may have empty strings in
   // image_filenames or oat_filenames.
   CHECK(!image_filenames.empty());
@@ -355,7 +357,7 @@ bool ImageWriter::Write(int image_fd,
     // TODO: heap validation can't handle these fix up passes.
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->DisableObjectValidation();
-    CopyAndFixupObjects();
+    CopyAndFixupObjects(thread_count);
   }
 
   if (compiler_options_.IsAppImage()) {
@@ -1464,7 +1466,7 @@ class ImageWriter::LayoutHelper::CollectClassesVisitor {
       ClassTable* app_class_table = app_class_loader->GetClassTable();
       ReaderMutexLock lock(self, app_class_table->lock_);
       DCHECK_EQ(app_class_table->classes_.size(), 1u);
-      const ClassTable::ClassSet& app_class_set = app_class_table->classes_[0];
+      const ClassTable::ClassSet& app_class_set = app_class_table->classes_.front();
       DCHECK_GE(app_class_set.size(), image_info.class_table_size_);
       boot_image_classes.reserve(app_class_set.size() - image_info.class_table_size_);
       for (const ClassTable::TableSlot& slot : app_class_set) {
@@ -2908,7 +2910,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       MutexLock lock(Thread::Current(), *Locks::intern_table_lock_);
       CHECK(!temp_intern_table.strong_interns_.tables_.empty());
       // The UnorderedSet was inserted at the beginning.
-      CHECK_EQ(temp_intern_table.strong_interns_.tables_[0].Size(), intern_table.size());
+      CHECK_EQ(temp_intern_table.strong_interns_.tables_.front().Size(), intern_table.size());
     }
   }
 
@@ -2937,7 +2939,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       ReaderMutexLock lock(Thread::Current(), temp_class_table.lock_);
       CHECK(!temp_class_table.classes_.empty());
       // The ClassSet was inserted at the beginning.
-      CHECK_EQ(temp_class_table.classes_[0].size(), table.size());
+      CHECK_EQ(temp_class_table.classes_.front().size(), table.size());
     }
   }
 }
@@ -2990,7 +2992,8 @@ inline Object* ImageWriter::CopyObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  bool done = image_info.image_bitmap_.Set(dst);  // Mark the obj as live.
+  // Mark the obj as live. Objects may be copied concurrently, see CopyAndFixupObjects().
+  bool done = image_info.image_bitmap_.AtomicTestAndSet(dst);
   // Check if the object was already copied, unless the caller indicated that it was not.
   if (kCheckIfDone && done) {
     return nullptr;
@@ -3062,7 +3065,30 @@ class ImageWriter::FixupVisitor {
   mirror::Object* const copy_;
 };
 
-void ImageWriter::CopyAndFixupObjects() {
+// Copies and fixes up a range of objects, on one of the threads of CopyAndFixupObjects().
+class ImageWriter::CopyAndFixupObjectsTask final : public Task {
+ public:
+  CopyAndFixupObjectsTask(ImageWriter* image_writer, ArrayRef<mirror::Object* const> objects)
+      : image_writer_(image_writer), objects_(objects) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    for (mirror::Object* obj : objects_) {
+      image_writer_->CopyAndFixupObject(obj);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ImageWriter* const image_writer_;
+  const ArrayRef<mirror::Object* const> objects_;
+};
+
+void ImageWriter::CopyAndFixupObjects(size_t thread_count) {
   // Copy and fix up pointer arrays first as they require special treatment.
   auto method_pointer_array_visitor =
       [&](ObjPtr<mirror::PointerArray> pointer_array) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -3085,11 +3111,42 @@ void ImageWriter::CopyAndFixupObjects() {
     }
   }
 
-  auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
-  };
-  Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  if (thread_count <= 1u) {
+    auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      CopyAndFixupObject(obj);
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  } else {
+    // Copying and fixing up an object only writes to its own copy, apart from the image bitmap
+    // which is updated atomically, so the objects can be processed in parallel.
+    dchecked_vector<mirror::Object*> objects;
+    auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      if (IsImageBinSlotAssigned(obj)) {
+        objects.push_back(obj);
+      }
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(visitor);
+
+    constexpr size_t kObjectsPerTask = 1024u;
+    Thread* self = Thread::Current();
+    ThreadPool thread_pool("Image writer thread pool", thread_count - 1u);
+    for (size_t begin = 0; begin < objects.size(); begin += kObjectsPerTask) {
+      size_t count = std::min(kObjectsPerTask, objects.size() - begin);
+      thread_pool.AddTask(
+          self,
+          new CopyAndFixupObjectsTask(this, ArrayRef<mirror::Object* const>(objects).SubArray(
+              begin, count)));
+    }
+    thread_pool.StartWorkers(self);
+    // The current thread keeps the mutator lock and takes part in the work. This does not block
+    // the workers: they only take the mutator lock shared, and nothing can take it exclusively
+    // while we hold it. Nothing requests a suspend-all meanwhile either, since the compiler
+    // threads are idle and fixing up objects does not allocate, so it cannot trigger a GC.
+    thread_pool.Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+    thread_pool.StopWorkers(self);
+  }
 
   // Fill the padding objects since they are required for in order traversal of the image space.
   for (ImageInfo& image_info : image_infos_) {
@@ -947,6 +947,10 @@ struct OatWriter::BssMappingInfo {
 //
 // See also OrderedMethodVisitor.
 struct OatWriter::OrderedMethodData {
+  static constexpr uint32_t kHotBit = 1u;
+  static constexpr uint32_t kStartupBit = 2u;
+  static constexpr uint32_t kPostStartupBit = 4u;
+
   uint32_t hotness_bits;
   OatClass* oat_class;
   CompiledMethod* compiled_method;
@@ -966,19 +970,25 @@ struct OatWriter::OrderedMethodData {
     return debug_info_idx != kDebugInfoIdxInvalid;
   }
 
-  // Bin each method according to the profile flags.
-  //
-  // Groups by e.g.
-  //  -- not hot at all
-  //  -- hot
-  //  -- hot and startup
-  //  -- hot and post-startup
-  //  -- hot and startup and poststartup
+  // Bin each method according to the profile flags, so that the code executed during startup
+  // is packed together at the beginning of the code section and page faults during startup
+  // touch as few pages as possible. The bins are, in order:
+  //  -- hot and startup (with or without post-startup)
   //  -- startup
-  //  -- startup and post-startup
+  //  -- hot and post-startup
   //  -- post-startup
-  //
-  // (See MethodHotness enum definition for up-to-date binning order.)
+  //  -- hot
+  //  -- not in the profile
+  uint32_t GetBinOrder() const {
+    if ((hotness_bits & kStartupBit) != 0u) {
+      return ((hotness_bits & kHotBit) != 0u) ? 0u : 1u;
+    } else if ((hotness_bits & kPostStartupBit) != 0u) {
+      return ((hotness_bits & kHotBit) != 0u) ? 2u : 3u;
+    } else {
+      return ((hotness_bits & kHotBit) != 0u) ? 4u : 5u;
+    }
+  }
+
   bool operator<(const OrderedMethodData& other) const {
     if (kOatWriterForceOatCodeLayout) {
       // Development flag: Override default behavior by sorting by name.
@@ -989,7 +999,7 @@ struct OatWriter::OrderedMethodData {
     }
 
     // Use the profile's method hotness to determine sort order.
-    if (hotness_bits < other.hotness_bits) {
+    if (GetBinOrder() < other.GetBinOrder()) {
       return true;
     }
 
@@ -1112,12 +1122,9 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
       if (profile_index_ != ProfileCompilationInfo::MaxProfileIndex()) {
         ProfileCompilationInfo* pci = writer_->profile_compilation_info_;
         DCHECK(pci != nullptr);
-        // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
-        // any memory, it only goes into the buffer cache and does not grow the PSS until the
-        // first time that memory is referenced in the process.
-        constexpr uint32_t kHotBit = 1u;
-        constexpr uint32_t kStartupBit = 2u;
-        constexpr uint32_t kPostStartupBit = 4u;
+        constexpr uint32_t kHotBit = OrderedMethodData::kHotBit;
+        constexpr uint32_t kStartupBit = OrderedMethodData::kStartupBit;
+        constexpr uint32_t kPostStartupBit = OrderedMethodData::kPostStartupBit;
         hotness_bits =
             (pci->IsHotMethod(profile_index_, method_index) ? kHotBit : 0u) |
             (pci->IsStartupMethod(profile_index_, method_index) ? kStartupBit : 0u) |
@@ -2264,9 +2271,7 @@ size_t OatWriter::InitOatCode(size_t offset) {
   oat_header_->SetExecutableOffset(offset);
   size_executable_offset_alignment_ = offset - old_offset;
   InstructionSet instruction_set = compiler_options_.GetInstructionSet();
-  if (GetCompilerOptions().IsBootImage() && primary_oat_file_ &&
-      // TODO(riscv64): remove this when we have compiler support for RISC-V.
-      instruction_set != InstructionSet::kRiscv64) {
+  if (GetCompilerOptions().IsBootImage() && primary_oat_file_) {
     const bool generate_debug_info = GetCompilerOptions().GenerateAnyDebugInfo();
     size_t adjusted_offset = offset;
 
@@ -3072,9 +3077,7 @@ size_t OatWriter::WriteBcpBssInfo(OutputStream* out, size_t file_offset, size_t
 
 size_t OatWriter::WriteCode(OutputStream* out, size_t file_offset, size_t relative_offset) {
   InstructionSet instruction_set = compiler_options_.GetInstructionSet();
-  if (GetCompilerOptions().IsBootImage() && primary_oat_file_ &&
-      // TODO(riscv64): remove this when we have compiler support for RISC-V.
-      instruction_set != InstructionSet::kRiscv64) {
+  if (GetCompilerOptions().IsBootImage() && primary_oat_file_) {
     #define DO_TRAMPOLINE(field) \
       do { \
         /* Pad with at least four 0xFFs so we can do DCHECKs in OatQuickMethodHeader */ \
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker/riscv64/relative_patcher_riscv64.h"
+
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "base/bit_utils.h"
+#include "linker/linker_patch.h"
+
+namespace art {
+namespace linker {
+
+namespace {
+
+// Maximum positive and negative displacement for method call measured from the patch location.
+// (Signed 21 bit displacement with the last bit 0 has range [-2^20, 2^20-2] measured from
+// the riscv64 PC pointing to the JAL.)
+constexpr uint32_t kMaxMethodCallPositiveDisplacement = (1u << 20) - 2u;
+constexpr uint32_t kMaxMethodCallNegativeDisplacement = (1u << 20);
+
+// JAL RA, +0 (unpatched).
+constexpr uint32_t kJalRaPlus0 = 0x000000efu;
+
+constexpr uint32_t kOpcodeMask = 0x7fu;
+constexpr uint32_t kAuipcOpcode = 0x17u;
+constexpr uint32_t kLoadOpcode = 0x03u;
+constexpr uint32_t kOpImmOpcode = 0x13u;
+
+inline uint32_t GetRd(uint32_t insn) { return (insn >> 7) & 0x1fu; }
+inline uint32_t GetRs1(uint32_t insn) { return (insn >> 15) & 0x1fu; }
+inline uint32_t GetFunct3(uint32_t insn) { return (insn >> 12) & 0x7u; }
+
+}  // anonymous namespace
+
+Riscv64RelativePatcher::Riscv64RelativePatcher(
+    RelativePatcherThunkProvider* thunk_provider,
+    RelativePatcherTargetProvider* target_provider,
+    const Riscv64InstructionSetFeatures* features ATTRIBUTE_UNUSED)
+    : ArmBaseRelativePatcher(thunk_provider, target_provider, InstructionSet::kRiscv64) {}
+
+void Riscv64RelativePatcher::PatchCall(std::vector<uint8_t>* code,
+                                       uint32_t literal_offset,
+                                       uint32_t patch_offset,
+                                       uint32_t target_offset) {
+  DCHECK_ALIGNED(literal_offset, 2u);
+  DCHECK_ALIGNED(patch_offset, 2u);
+  DCHECK_ALIGNED(target_offset, 2u);
+  uint32_t displacement = CalculateMethodCallDisplacement(patch_offset, target_offset);
+  PatchJal(code, literal_offset, displacement);
+}
+
+void Riscv64RelativePatcher::PatchPcRelativeReference(std::vector<uint8_t>* code,
+                                                      const LinkerPatch& patch,
+                                                      uint32_t patch_offset,
+                                                      uint32_t target_offset) {
+  DCHECK_ALIGNED(patch_offset, 2u);
+  DCHECK_ALIGNED(target_offset, 2u);
+  uint32_t literal_offset = patch.LiteralOffset();
+  uint32_t insn = GetInsn(code, literal_offset);
+  uint32_t pc_insn_offset = patch.PcInsnOffset();
+  // Unsigned arithmetic with its well-defined overflow behavior is just fine here.
+  // The target may precede the oat file (image space), so the displacement is limited
+  // to +-2GiB and the sign is taken from its highest bit.
+  uint32_t disp = target_offset - (patch_offset - literal_offset + pc_insn_offset);
+  if (literal_offset == pc_insn_offset) {
+    // AUIPC takes the high 20 bits, rounded so that the sign-extended low 12 bits
+    // of the paired instruction bring the result to the exact target.
+    DCHECK_EQ(insn & kOpcodeMask, kAuipcOpcode)
+        << literal_offset << ", " << pc_insn_offset << ", 0x" << std::hex << insn;
+    uint32_t imm20 = (disp + 0x800u) >> 12;
+    insn = (insn & 0x00000fffu) | (imm20 << 12);
+  } else {
+    // ADDI for relative references; LD, LW or LWU for .bss and .data.bimg.rel.ro entries.
+    if ((insn & kOpcodeMask) == kOpImmOpcode) {
+      DCHECK_EQ(GetFunct3(insn), 0u) << std::hex << insn;  // ADDI
+      DCHECK(patch.GetType() == LinkerPatch::Type::kIntrinsicReference ||
+             patch.GetType() == LinkerPatch::Type::kMethodRelative ||
+             patch.GetType() == LinkerPatch::Type::kTypeRelative ||
+             patch.GetType() == LinkerPatch::Type::kStringRelative) << patch.GetType();
+    } else {
+      DCHECK_EQ(insn & kOpcodeMask, kLoadOpcode) << std::hex << insn;
+      // LW (2), LD (3) or LWU (6).
+      DCHECK(GetFunct3(insn) == 2u || GetFunct3(insn) == 3u || GetFunct3(insn) == 6u)
+          << std::hex << insn;
+      DCHECK(patch.GetType() == LinkerPatch::Type::kDataBimgRelRo ||
+             patch.GetType() == LinkerPatch::Type::kMethodBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kJniEntrypointRelative ||
+             patch.GetType() == LinkerPatch::Type::kTypeBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kPublicTypeBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kPackageTypeBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kStringBssEntry) << patch.GetType();
+    }
+    if (kIsDebugBuild) {
+      uint32_t auipc = GetInsn(code, pc_insn_offset);
+      CHECK_EQ(auipc & kOpcodeMask, kAuipcOpcode);   // Check that pc_insn_offset points
+      CHECK_EQ(GetRd(auipc), GetRs1(insn));          // to AUIPC with matching register.
+    }
+    insn = (insn & 0x000fffffu) | ((disp & 0xfffu) << 20);
+  }
+  SetInsn(code, literal_offset, insn);
+}
+
+void Riscv64RelativePatcher::PatchEntrypointCall(std::vector<uint8_t>* code,
+                                                 const LinkerPatch& patch,
+                                                 uint32_t patch_offset) {
+  DCHECK_ALIGNED(patch_offset, 2u);
+  ThunkKey key = GetEntrypointCallKey(patch);
+  uint32_t target_offset = GetThunkTargetOffset(key, patch_offset);
+  uint32_t displacement = target_offset - patch_offset;
+  PatchJal(code, patch.LiteralOffset(), displacement);
+}
+
+void Riscv64RelativePatcher::PatchBakerReadBarrierBranch(
+    std::vector<uint8_t>* code ATTRIBUTE_UNUSED,
+    const LinkerPatch& patch ATTRIBUTE_UNUSED,
+    uint32_t patch_offset ATTRIBUTE_UNUSED) {
+  LOG(FATAL) << "Unexpected baker read barrier branch patch.";
+  UNREACHABLE();
+}
+
+uint32_t Riscv64RelativePatcher::MaxPositiveDisplacement(const ThunkKey& key) {
+  switch (key.GetType()) {
+    case ThunkType::kMethodCall:
+    case ThunkType::kEntrypointCall:
+      return kMaxMethodCallPositiveDisplacement;
+    case ThunkType::kBakerReadBarrier:
+      LOG(FATAL) << "Unexpected baker read barrier thunk.";
+      UNREACHABLE();
+  }
+}
+
+uint32_t Riscv64RelativePatcher::MaxNegativeDisplacement(const ThunkKey& key) {
+  switch (key.GetType()) {
+    case ThunkType::kMethodCall:
+    case ThunkType::kEntrypointCall:
+      return kMaxMethodCallNegativeDisplacement;
+    case ThunkType::kBakerReadBarrier:
+      LOG(FATAL) << "Unexpected baker read barrier thunk.";
+      UNREACHABLE();
+  }
+}
+
+void Riscv64RelativePatcher::PatchJal(std::vector<uint8_t>* code,
+                                      uint32_t literal_offset,
+                                      uint32_t displacement) {
+  DCHECK_ALIGNED(displacement, 2u);
+  DCHECK((displacement >> 20) == 0u || (displacement >> 20) == 0xfffu);  // 21-bit signed.
+  uint32_t insn = kJalRaPlus0 |
+      ((displacement & 0x00100000u) << (31 - 20)) |  // imm[20] is at bit 31,
+      ((displacement & 0x000007feu) << (21 - 1)) |   // imm[10:1] is at bits 21-30,
+      ((displacement & 0x00000800u) << (20 - 11)) |  // imm[11] is at bit 20,
+      (displacement & 0x000ff000u);                  // imm[19:12] is at bits 12-19.
+
+  // Check that we're just overwriting an existing JAL RA.
+  DCHECK_EQ(GetInsn(code, literal_offset) & 0x00000fffu, kJalRaPlus0);
+  // Write the new JAL.
+  SetInsn(code, literal_offset, insn);
+}
+
+void Riscv64RelativePatcher::SetInsn(std::vector<uint8_t>* code, uint32_t offset, uint32_t value) {
+  DCHECK_LE(offset + 4u, code->size());
+  DCHECK_ALIGNED(offset, 2u);
+  uint8_t* addr = &(*code)[offset];
+  addr[0] = (value >> 0) & 0xff;
+  addr[1] = (value >> 8) & 0xff;
+  addr[2] = (value >> 16) & 0xff;
+  addr[3] = (value >> 24) & 0xff;
+}
+
+uint32_t Riscv64RelativePatcher::GetInsn(ArrayRef<const uint8_t> code, uint32_t offset) {
+  DCHECK_LE(offset + 4u, code.size());
+  DCHECK_ALIGNED(offset, 2u);
+  const uint8_t* addr = &code[offset];
+  return
+      (static_cast<uint32_t>(addr[0]) << 0) +
+      (static_cast<uint32_t>(addr[1]) << 8) +
+      (static_cast<uint32_t>(addr[2]) << 16)+
+      (static_cast<uint32_t>(addr[3]) << 24);
+}
+
+template <typename Alloc>
+uint32_t Riscv64RelativePatcher::GetInsn(std::vector<uint8_t, Alloc>* code, uint32_t offset) {
+  return GetInsn(ArrayRef<const uint8_t>(*code), offset);
+}
+
+}  // namespace linker
+}  // namespace art
@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker/riscv64/relative_patcher_riscv64.h"
+
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "driver/compiler_options.h"
+#include "linker/relative_patcher_test.h"
+#include "oat_quick_method_header.h"
+#include "optimizing/code_generator_riscv64.h"
+#include "optimizing/optimizing_unit_test.h"
+
+namespace art {
+namespace linker {
+
+class Riscv64RelativePatcherTest : public RelativePatcherTest {
+ public:
+  Riscv64RelativePatcherTest() : RelativePatcherTest(InstructionSet::kRiscv64, "generic") { }
+
+ protected:
+  // NOP instruction, i.e. ADDI zero, zero, 0.
+  static constexpr uint32_t kNopInsn = 0x00000013u;
+
+  // All calls are created from kJalRaPlus0 by adding the encoded displacement.
+  static constexpr uint32_t kJalRaPlus0 = 0x000000efu;
+
+  // AUIPC A0, 0 and its users ADDI A1, A0, 0 and LWU A1, 0(A0).
+  static constexpr uint32_t kAuipcA0 = 0x00000517u;
+  static constexpr uint32_t kAddiA1A0 = 0x00050593u;
+  static constexpr uint32_t kLwuA1A0 = 0x00056583u;
+
+  // Users ADDI A0, A0, 0 and LWU A0, 0(A0) as emitted by the code generator for string loads.
+  static constexpr uint32_t kAddiA0A0 = 0x00050513u;
+  static constexpr uint32_t kLwuA0A0 = 0x00056503u;
+
+  // Immediates of the placeholders emitted by the code generator before link-time patching.
+  static constexpr uint32_t kAuipcPlaceholder = 0x12345000u;
+  static constexpr uint32_t kLowPlaceholder = 0x67800000u;
+
+  static uint32_t EncodeJal(uint32_t disp) {
+    CHECK_ALIGNED(disp, 2u);
+    return kJalRaPlus0 |
+        (((disp >> 20) & 1u) << 31) |
+        (((disp >> 1) & 0x3ffu) << 21) |
+        (((disp >> 11) & 1u) << 20) |
+        (((disp >> 12) & 0xffu) << 12);
+  }
+
+  void PushBackInsn(std::vector<uint8_t>* code, uint32_t insn) {
+    const uint8_t insn_code[] = {
+        static_cast<uint8_t>(insn),
+        static_cast<uint8_t>(insn >> 8),
+        static_cast<uint8_t>(insn >> 16),
+        static_cast<uint8_t>(insn >> 24),
+    };
+    code->insert(code->end(), insn_code, insn_code + sizeof(insn_code));
+  }
+
+  std::vector<uint8_t> RawCode(std::initializer_list<uint32_t> insns) {
+    std::vector<uint8_t> raw_code;
+    raw_code.reserve(insns.size() * 4u);
+    for (uint32_t insn : insns) {
+      PushBackInsn(&raw_code, insn);
+    }
+    return raw_code;
+  }
+
+  std::vector<uint8_t> GenNopsAndJal(size_t num_nops, uint32_t jal) {
+    std::vector<uint8_t> result;
+    result.reserve(num_nops * 4u + 4u);
+    for (size_t i = 0; i != num_nops; ++i) {
+      PushBackInsn(&result, kNopInsn);
+    }
+    PushBackInsn(&result, jal);
+    return result;
+  }
+
+  std::vector<uint8_t> GenNopsAndAuipcAndUse(size_t num_nops,
+                                             uint32_t method_offset,
+                                             uint32_t target_offset,
+                                             uint32_t use_insn) {
+    std::vector<uint8_t> result;
+    result.reserve(num_nops * 4u + 8u);
+    for (size_t i = 0; i != num_nops; ++i) {
+      PushBackInsn(&result, kNopInsn);
+    }
+    uint32_t auipc_offset = method_offset + num_nops * 4u;
+    uint32_t disp = target_offset - auipc_offset;
+    // The low 12 bits are sign-extended by the user, so round the high 20 bits.
+    PushBackInsn(&result, kAuipcA0 | ((disp + 0x800u) & 0xfffff000u));
+    PushBackInsn(&result, use_insn | ((disp & 0xfffu) << 20));
+    return result;
+  }
+
+  uint32_t GetMethodOffset(uint32_t method_idx) {
+    auto result = method_offset_map_.FindMethodOffset(MethodRef(method_idx));
+    CHECK(result.first);
+    CHECK_ALIGNED(result.second, 2u);
+    return result.second;
+  }
+
+  std::vector<uint8_t> CompileThunk(const LinkerPatch& patch,
+                                    /*out*/ std::string* debug_name = nullptr) {
+    OptimizingUnitTestHelper helper;
+    HGraph* graph = helper.CreateGraph();
+    CompilerOptions compiler_options;
+
+    // Set isa to riscv64.
+    compiler_options.instruction_set_ = instruction_set_;
+    compiler_options.instruction_set_features_ =
+        InstructionSetFeatures::FromBitmap(instruction_set_, instruction_set_features_->AsBitmap());
+    CHECK(compiler_options.instruction_set_features_->Equals(instruction_set_features_.get()));
+
+    riscv64::CodeGeneratorRISCV64 codegen(graph, compiler_options);
+    ArenaVector<uint8_t> code(helper.GetAllocator()->Adapter());
+    codegen.EmitThunkCode(patch, &code, debug_name);
+    return std::vector<uint8_t>(code.begin(), code.end());
+  }
+
+  void AddCompiledMethod(
+      MethodReference method_ref,
+      const ArrayRef<const uint8_t>& code,
+      const ArrayRef<const LinkerPatch>& patches = ArrayRef<const LinkerPatch>()) {
+    RelativePatcherTest::AddCompiledMethod(method_ref, code, patches);
+
+    // Make sure the ThunkProvider has all the necessary thunks.
+    for (const LinkerPatch& patch : patches) {
+      if (patch.GetType() == LinkerPatch::Type::kCallEntrypoint ||
+          patch.GetType() == LinkerPatch::Type::kCallRelative) {
+        std::string debug_name;
+        std::vector<uint8_t> thunk_code = CompileThunk(patch, &debug_name);
+        thunk_provider_.SetThunkCode(patch, ArrayRef<const uint8_t>(thunk_code), debug_name);
+      }
+    }
+  }
+
+  // Use the code generator to emit a PC-relative string load into A0 followed by an entrypoint
+  // call and collect the linker patches it records for them.
+  std::vector<uint8_t> CompileStringLoadAndEntrypointCall(
+      uint32_t string_index,
+      bool bss_entry,
+      uint32_t entrypoint_offset,
+      /*out*/ std::vector<LinkerPatch>* patches) {
+    OptimizingUnitTestHelper helper;
+    HGraph* graph = helper.CreateGraph();
+    CompilerOptions compiler_options;
+
+    // Set isa to riscv64.
+    compiler_options.instruction_set_ = instruction_set_;
+    compiler_options.instruction_set_features_ =
+        InstructionSetFeatures::FromBitmap(instruction_set_, instruction_set_features_->AsBitmap());
+    // Relative string patches are emitted only when compiling the boot image.
+    if (!bss_entry) {
+      compiler_options.image_type_ = CompilerOptions::ImageType::kBootImage;
+    }
+
+    using PcRelativePatchInfo = riscv64::CodeGeneratorRISCV64::PcRelativePatchInfo;
+    riscv64::CodeGeneratorRISCV64 codegen(graph, compiler_options);
+    const DexFile& dex_file = graph->GetDexFile();
+    dex::StringIndex string_idx(string_index);
+    if (bss_entry) {
+      PcRelativePatchInfo* info_high = codegen.NewStringBssEntryPatch(dex_file, string_idx);
+      codegen.EmitPcRelativeAuipcPlaceholder(info_high, riscv64::A0);
+      PcRelativePatchInfo* info_low =
+          codegen.NewStringBssEntryPatch(dex_file, string_idx, info_high);
+      codegen.EmitPcRelativeLwuPlaceholder(info_low, riscv64::A0, riscv64::A0);
+    } else {
+      PcRelativePatchInfo* info_high = codegen.NewBootImageStringPatch(dex_file, string_idx);
+      codegen.EmitPcRelativeAuipcPlaceholder(info_high, riscv64::A0);
+      PcRelativePatchInfo* info_low =
+          codegen.NewBootImageStringPatch(dex_file, string_idx, info_high);
+      codegen.EmitPcRelativeAddiPlaceholder(info_low, riscv64::A0, riscv64::A0);
+    }
+    codegen.EmitEntrypointThunkCall(ThreadOffset64(entrypoint_offset));
+
+    riscv64::Riscv64Assembler* assembler = codegen.GetAssembler();
+    assembler->FinalizeCode();
+    std::vector<uint8_t> code(assembler->CodeSize());
+    MemoryRegion code_region(code.data(), code.size());
+    assembler->FinalizeInstructions(code_region);
+
+    ArenaVector<LinkerPatch> linker_patches(helper.GetAllocator()->Adapter());
+    codegen.EmitLinkerPatches(&linker_patches);
+    patches->assign(linker_patches.begin(), linker_patches.end());
+    return code;
+  }
+
+  void TestCodegenStringLoad(bool bss_entry, uint32_t string_entry_offset) {
+    constexpr uint32_t kStringIndex = 1u;
+    constexpr uint32_t kEntrypointOffset = 512u;
+    string_index_to_offset_map_.Put(kStringIndex, string_entry_offset);
+    std::vector<LinkerPatch> patches;
+    std::vector<uint8_t> code =
+        CompileStringLoadAndEntrypointCall(kStringIndex, bss_entry, kEntrypointOffset, &patches);
+    uint32_t use_insn = bss_entry ? kLwuA0A0 : kAddiA0A0;
+    ASSERT_EQ(RawCode({kAuipcA0 | kAuipcPlaceholder, use_insn | kLowPlaceholder, kJalRaPlus0}),
+              code);
+
+    // Both instructions of the PC-relative pair refer to the AUIPC.
+    LinkerPatch::Type string_patch_type =
+        bss_entry ? LinkerPatch::Type::kStringBssEntry : LinkerPatch::Type::kStringRelative;
+    ASSERT_EQ(3u, patches.size());
+    size_t num_string_patches = 0u;
+    for (const LinkerPatch& patch : patches) {
+      if (patch.GetType() == LinkerPatch::Type::kCallEntrypoint) {
+        EXPECT_EQ(8u, patch.LiteralOffset());
+        EXPECT_EQ(kEntrypointOffset, patch.EntrypointOffset());
+      } else {
+        ASSERT_EQ(string_patch_type, patch.GetType());
+        EXPECT_EQ(0u, patch.PcInsnOffset());
+        EXPECT_EQ(kStringIndex, patch.TargetStringIndex().index_);
+        ++num_string_patches;
+      }
+    }
+    EXPECT_EQ(2u, num_string_patches);
+
+    AddCompiledMethod(MethodRef(1u),
+                      ArrayRef<const uint8_t>(code),
+                      ArrayRef<const LinkerPatch>(patches));
+    Link();
+
+    uint32_t method1_offset = GetMethodOffset(1u);
+    uint32_t target_offset =
+        bss_entry ? bss_begin_ + string_entry_offset : string_entry_offset;
+    uint32_t thunk_offset =
+        CompiledCode::AlignCode(method1_offset + code.size(), InstructionSet::kRiscv64);
+    auto expected_code = GenNopsAndAuipcAndUse(0u, method1_offset, target_offset, use_insn);
+    PushBackInsn(&expected_code, EncodeJal(thunk_offset - (method1_offset + 8u)));
+    EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+  }
+
+  std::vector<uint8_t> CompileMethodCallThunk() {
+    LinkerPatch patch = LinkerPatch::RelativeCodePatch(/* literal_offset */ 0u,
+                                                       /* target_dex_file*/ nullptr,
+                                                       /* target_method_idx */ 0u);
+    return CompileThunk(patch);
+  }
+
+  bool CheckThunk(uint32_t thunk_offset, const std::vector<uint8_t>& expected_code) {
+    if (output_.size() < thunk_offset + expected_code.size()) {
+      LOG(ERROR) << "output_.size() == " << output_.size() << " < "
+          << "thunk_offset + expected_code.size() == " << (thunk_offset + expected_code.size());
+      return false;
+    }
+    ArrayRef<const uint8_t> linked_code(&output_[thunk_offset], expected_code.size());
+    if (linked_code == ArrayRef<const uint8_t>(expected_code)) {
+      return true;
+    }
+    // Log failure info.
+    DumpDiff(ArrayRef<const uint8_t>(expected_code), linked_code);
+    return false;
+  }
+
+  // Add method 1 and a filler method so that the last method, added with the next index,
+  // starts `distance` bytes after method 1 unless a thunk is inserted.
+  uint32_t Create2MethodsWithGap(const ArrayRef<const uint8_t>& method1_code,
+                                 const ArrayRef<const LinkerPatch>& method1_patches,
+                                 const ArrayRef<const uint8_t>& last_method_code,
+                                 const ArrayRef<const LinkerPatch>& last_method_patches,
+                                 uint32_t distance) {
+    CHECK_ALIGNED(distance, kRiscv64CodeAlignment);
+    uint32_t method1_offset =
+        kTrampolineSize + CodeAlignmentSize(kTrampolineSize) + sizeof(OatQuickMethodHeader);
+    AddCompiledMethod(MethodRef(1u), method1_code, method1_patches);
+    const uint32_t gap_start = method1_offset + method1_code.size();
+    const uint32_t last_method_offset = method1_offset + distance;
+    CHECK_ALIGNED(last_method_offset, kRiscv64CodeAlignment);
+    const uint32_t gap_end = last_method_offset - sizeof(OatQuickMethodHeader);
+
+    uint32_t filler_code_size =
+        gap_end - gap_start - CodeAlignmentSize(gap_start) - sizeof(OatQuickMethodHeader);
+    std::vector<uint8_t> filler_code(filler_code_size, 0u);
+    AddCompiledMethod(MethodRef(2u), ArrayRef<const uint8_t>(filler_code));
+    AddCompiledMethod(MethodRef(3u), last_method_code, last_method_patches);
+    Link();
+
+    CHECK_EQ(GetMethodOffset(1u), method1_offset);
+    return 3u;
+  }
+};
+
+TEST_F(Riscv64RelativePatcherTest, CallSelf) {
+  const LinkerPatch patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 1u),
+  };
+  auto code = RawCode({kJalRaPlus0});
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  auto expected_code = RawCode({EncodeJal(0u)});
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, CallOther) {
+  const LinkerPatch method1_patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 2u),
+  };
+  auto code = RawCode({kJalRaPlus0});
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(code),
+                    ArrayRef<const LinkerPatch>(method1_patches));
+  const LinkerPatch method2_patches[] = {
+      LinkerPatch::RelativeCodePatch(4u, nullptr, 1u),
+  };
+  auto method2_code = GenNopsAndJal(1u, kJalRaPlus0);
+  AddCompiledMethod(MethodRef(2u),
+                    ArrayRef<const uint8_t>(method2_code),
+                    ArrayRef<const LinkerPatch>(method2_patches));
+  Link();
+
+  uint32_t method1_offset = GetMethodOffset(1u);
+  uint32_t method2_offset = GetMethodOffset(2u);
+  uint32_t diff_after = method2_offset - method1_offset;
+  auto method1_expected_code = RawCode({EncodeJal(diff_after)});
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(method1_expected_code)));
+  uint32_t diff_before = method1_offset - (method2_offset + 4u);
+  auto method2_expected_code = GenNopsAndJal(1u, EncodeJal(diff_before));
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(2u), ArrayRef<const uint8_t>(method2_expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, CallTrampoline) {
+  const LinkerPatch patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 2u),
+  };
+  auto code = RawCode({kJalRaPlus0});
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  uint32_t method1_offset = GetMethodOffset(1u);
+  uint32_t diff = kTrampolineOffset - method1_offset;
+  auto expected_code = RawCode({EncodeJal(diff)});
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, CallOtherAlmostTooFarAfter) {
+  auto method1_code = RawCode({kJalRaPlus0});
+  const LinkerPatch method1_patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 3u),
+  };
+  constexpr uint32_t max_positive_disp = 1 * MB - kRiscv64CodeAlignment;
+  uint32_t last_method_idx = Create2MethodsWithGap(ArrayRef<const uint8_t>(method1_code),
+                                                   ArrayRef<const LinkerPatch>(method1_patches),
+                                                   ArrayRef<const uint8_t>(RawCode({kNopInsn})),
+                                                   ArrayRef<const LinkerPatch>(),
+                                                   max_positive_disp);
+  uint32_t method1_offset = GetMethodOffset(1u);
+  uint32_t last_method_offset = GetMethodOffset(last_method_idx);
+  ASSERT_EQ(method1_offset + max_positive_disp, last_method_offset);
+
+  // No thunk, the call goes directly to the last method.
+  auto expected_code = RawCode({EncodeJal(max_positive_disp)});
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, CallOtherJustTooFarAfter) {
+  auto method1_code = RawCode({kJalRaPlus0});
+  const LinkerPatch method1_patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 3u),
+  };
+  constexpr uint32_t just_over_max_positive_disp = 1 * MB;
+  uint32_t last_method_idx = Create2MethodsWithGap(ArrayRef<const uint8_t>(method1_code),
+                                                   ArrayRef<const LinkerPatch>(method1_patches),
+                                                   ArrayRef<const uint8_t>(RawCode({kNopInsn})),
+                                                   ArrayRef<const LinkerPatch>(),
+                                                   just_over_max_positive_disp);
+  uint32_t method1_offset = GetMethodOffset(1u);
+  uint32_t last_method_offset = GetMethodOffset(last_method_idx);
+  ASSERT_LT(method1_offset + just_over_max_positive_disp, last_method_offset);
+
+  // The thunk is inserted right after method 1, before the filler method.
+  uint32_t thunk_offset =
+      CompiledCode::AlignCode(method1_offset + method1_code.size(), InstructionSet::kRiscv64);
+  uint32_t diff = thunk_offset - method1_offset;
+  auto expected_code = RawCode({EncodeJal(diff)});
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+  EXPECT_TRUE(CheckThunk(thunk_offset, CompileMethodCallThunk()));
+}
+
+TEST_F(Riscv64RelativePatcherTest, StringBssEntry) {
+  bss_begin_ = 0x12345678;
+  constexpr size_t kStringEntryOffset = 0x1234;
+  constexpr uint32_t kStringIndex = 1u;
+  string_index_to_offset_map_.Put(kStringIndex, kStringEntryOffset);
+  auto code = GenNopsAndAuipcAndUse(1u, 0u, 0u, kLwuA1A0);  // Unpatched.
+  const LinkerPatch patches[] = {
+      LinkerPatch::StringBssEntryPatch(4u, nullptr, 4u, kStringIndex),
+      LinkerPatch::StringBssEntryPatch(8u, nullptr, 4u, kStringIndex),
+  };
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  uint32_t method1_offset = GetMethodOffset(1u);
+  uint32_t target_offset = bss_begin_ + kStringEntryOffset;
+  auto expected_code = GenNopsAndAuipcAndUse(1u, method1_offset, target_offset, kLwuA1A0);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, StringReference) {
+  // Use an offset with the bit 11 set to check the rounding of the AUIPC immediate.
+  constexpr uint32_t kStringIndex = 1u;
+  constexpr uint32_t kStringOffset = 0x12345ff8;
+  string_index_to_offset_map_.Put(kStringIndex, kStringOffset);
+  auto code = GenNopsAndAuipcAndUse(0u, 0u, 0u, kAddiA1A0);  // Unpatched.
+  const LinkerPatch patches[] = {
+      LinkerPatch::RelativeStringPatch(0u, nullptr, 0u, kStringIndex),
+      LinkerPatch::RelativeStringPatch(4u, nullptr, 0u, kStringIndex),
+  };
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  uint32_t method1_offset = GetMethodOffset(1u);
+  auto expected_code = GenNopsAndAuipcAndUse(0u, method1_offset, kStringOffset, kAddiA1A0);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, StringReferenceBackward) {
+  // A target before the method gives a negative displacement.
+  constexpr uint32_t kStringIndex = 1u;
+  constexpr uint32_t kStringOffset = 0x10u;
+  string_index_to_offset_map_.Put(kStringIndex, kStringOffset);
+  auto code = GenNopsAndAuipcAndUse(2u, 0u, 0u, kAddiA1A0);  // Unpatched.
+  const LinkerPatch patches[] = {
+      LinkerPatch::RelativeStringPatch(8u, nullptr, 8u, kStringIndex),
+      LinkerPatch::RelativeStringPatch(12u, nullptr, 8u, kStringIndex),
+  };
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  uint32_t method1_offset = GetMethodOffset(1u);
+  ASSERT_LT(kStringOffset, method1_offset);
+  auto expected_code = GenNopsAndAuipcAndUse(2u, method1_offset, kStringOffset, kAddiA1A0);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, EntrypointCall) {
+  constexpr uint32_t kEntrypointOffset = 512;
+  const LinkerPatch patches[] = {
+      LinkerPatch::CallEntrypointPatch(0u, kEntrypointOffset),
+  };
+  auto code = RawCode({kJalRaPlus0});
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  uint32_t method_offset = GetMethodOffset(1u);
+  uint32_t thunk_offset =
+      CompiledCode::AlignCode(method_offset + code.size(), InstructionSet::kRiscv64);
+  uint32_t diff = thunk_offset - method_offset;
+  auto expected_code = RawCode({EncodeJal(diff)});
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+
+  // Verify the thunk loads the entrypoint from the Thread and jumps to it.
+  EXPECT_TRUE(CheckThunk(thunk_offset, CompileThunk(patches[0])));
+}
+
+TEST_F(Riscv64RelativePatcherTest, CodegenStringBssEntry) {
+  bss_begin_ = 0x12345678;
+  TestCodegenStringLoad(/*bss_entry=*/ true, /*string_entry_offset=*/ 0x1234u);
+}
+
+TEST_F(Riscv64RelativePatcherTest, CodegenStringReference) {
+  // Use an offset with the bit 11 set to check the rounding of the AUIPC immediate.
+  TestCodegenStringLoad(/*bss_entry=*/ false, /*string_entry_offset=*/ 0x12345ff8u);
+}
+
+}  // namespace linker
+}  // namespace art
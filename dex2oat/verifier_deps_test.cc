@@ -19,6 +19,7 @@
 
 #include "art_method-inl.h"
 #include "base/indenter.h"
+#include "base/stl_util.h"
 #include "class_linker.h"
 #include "common_compiler_driver_test.h"
 #include "compiler_callbacks.h"
@@ -519,6 +520,86 @@ TEST_F(VerifierDepsTest, EncodeDecodeMulti) {
   decoded_deps.Dump(&os);
 }
 
+TEST_F(VerifierDepsTest, ReuseUnchangedClasses) {
+  VerifyDexFile();
+  ASSERT_EQ(1u, NumberOfCompiledDexFiles());
+
+  std::vector<uint8_t> buffer;
+  verifier_deps_->Encode(dex_files_, &buffer);
+  ASSERT_FALSE(buffer.empty());
+
+  // Decode the dependencies for a separate copy of the dex file, standing in for the previous
+  // version of the dex file. None of its classes changed, so all verified classes are reused.
+  std::vector<std::unique_ptr<const DexFile>> old_dex_files = OpenTestDexFiles("VerifierDeps");
+  ASSERT_EQ(1u, old_dex_files.size());
+  std::vector<const DexFile*> old_dex_file_ptrs = { old_dex_files[0].get() };
+  VerifierDeps old_deps(old_dex_file_ptrs, /*output_only=*/ false);
+  ASSERT_TRUE(old_deps.ParseStoredData(old_dex_file_ptrs, ArrayRef<const uint8_t>(buffer)));
+
+  VerifierDeps reused_deps(dex_files_);
+  size_t num_reused =
+      reused_deps.ReuseUnchangedClasses(*primary_dex_file_, *old_dex_files[0], old_deps);
+
+  const std::vector<bool>& verified_classes =
+      verifier_deps_->GetVerifiedClasses(*primary_dex_file_);
+  size_t num_verified = std::count(verified_classes.begin(), verified_classes.end(), true);
+  ASSERT_EQ(num_verified, num_reused);
+  ASSERT_EQ(verified_classes, reused_deps.GetVerifiedClasses(*primary_dex_file_));
+  const VerifierDeps::DexFileDeps& deps = *verifier_deps_->GetDexFileDeps(*primary_dex_file_);
+  const VerifierDeps::DexFileDeps& reused = *reused_deps.GetDexFileDeps(*primary_dex_file_);
+  for (uint32_t i = 0; i < primary_dex_file_->NumClassDefs(); ++i) {
+    ASSERT_EQ(verified_classes[i], reused_deps.IsReusedClass(*primary_dex_file_, i));
+    if (verified_classes[i]) {
+      ASSERT_EQ(deps.assignable_types_[i].size(), reused.assignable_types_[i].size());
+    } else {
+      ASSERT_TRUE(reused.assignable_types_[i].empty());
+    }
+  }
+}
+
+TEST_F(VerifierDepsTest, ReuseUnchangedClassesAfterDexChange) {
+  // Record the verification of the previous version of the dex files.
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    LoadDexFile(soa, "MultiDex");
+  }
+  SetupCompilerDriver();
+  VerifyWithCompilerDriver(/* verifier_deps= */ nullptr);
+  ASSERT_EQ(2u, dex_files_.size());
+  std::vector<uint8_t> buffer;
+  verifier_deps_->Encode(dex_files_, &buffer);
+  ASSERT_FALSE(buffer.empty());
+
+  std::vector<std::unique_ptr<const DexFile>> old_dex_files = OpenTestDexFiles("MultiDex");
+  std::vector<const DexFile*> old_dex_file_ptrs = MakeNonOwningPointerVector(old_dex_files);
+  VerifierDeps old_deps(old_dex_file_ptrs, /*output_only=*/ false);
+  ASSERT_TRUE(old_deps.ParseStoredData(old_dex_file_ptrs, ArrayRef<const uint8_t>(buffer)));
+
+  // Only the secondary dex file changed: `Second` has a new method, while `Main` in the
+  // primary dex file is the same.
+  std::vector<std::unique_ptr<const DexFile>> new_dex_files =
+      OpenTestDexFiles("MultiDexModifiedSecondary");
+  ASSERT_EQ(2u, new_dex_files.size());
+  std::vector<const DexFile*> new_dex_file_ptrs = MakeNonOwningPointerVector(new_dex_files);
+  VerifierDeps reused_deps(new_dex_file_ptrs);
+
+  const DexFile& new_primary = *new_dex_files[0];
+  uint16_t main_index = GetClassDefIndex("LMain;", new_primary);
+  ASSERT_TRUE(old_deps.GetVerifiedClasses(*old_dex_files[0])[
+      GetClassDefIndex("LMain;", *old_dex_files[0])]);
+  EXPECT_EQ(1u, reused_deps.ReuseUnchangedClasses(new_primary, *old_dex_files[0], old_deps));
+  EXPECT_TRUE(reused_deps.IsReusedClass(new_primary, main_index));
+  EXPECT_TRUE(reused_deps.GetVerifiedClasses(new_primary)[main_index]);
+
+  const DexFile& new_secondary = *new_dex_files[1];
+  uint16_t second_index = GetClassDefIndex("LSecond;", new_secondary);
+  ASSERT_TRUE(old_deps.GetVerifiedClasses(*old_dex_files[1])[
+      GetClassDefIndex("LSecond;", *old_dex_files[1])]);
+  EXPECT_EQ(0u, reused_deps.ReuseUnchangedClasses(new_secondary, *old_dex_files[1], old_deps));
+  EXPECT_FALSE(reused_deps.IsReusedClass(new_secondary, second_index));
+  EXPECT_FALSE(reused_deps.GetVerifiedClasses(new_secondary)[second_index]);
+}
+
 TEST_F(VerifierDepsTest, UnverifiedClasses) {
   VerifyDexFile();
   ASSERT_FALSE(HasUnverifiedClass("LMyThread;"));
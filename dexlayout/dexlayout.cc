@@ -1903,6 +1903,29 @@ void DexLayout::LayoutClassDefsAndClassData(const DexFile* dex_file) {
   }
   CHECK_EQ(class_data_index, class_datas.Size());
 
+  // Static values are read when the class is initialized, so keep those of the profile classes
+  // together as well. The remaining encoded arrays, such as call sites, keep their order.
+  auto& encoded_arrays = header_->EncodedArrayItems();
+  std::vector<dex_ir::EncodedArrayItem*> new_encoded_array_order;
+  std::unordered_set<dex_ir::EncodedArrayItem*> visited_encoded_arrays;
+  for (dex_ir::ClassDef* class_def : new_class_def_order) {
+    dex_ir::EncodedArrayItem* static_values = class_def->StaticValues();
+    if (static_values != nullptr && visited_encoded_arrays.insert(static_values).second) {
+      new_encoded_array_order.push_back(static_values);
+    }
+  }
+  for (auto& encoded_array : encoded_arrays) {
+    if (visited_encoded_arrays.insert(encoded_array.get()).second) {
+      new_encoded_array_order.push_back(encoded_array.get());
+    }
+  }
+  CHECK_EQ(new_encoded_array_order.size(), encoded_arrays.Size());
+  for (size_t i = 0; i < encoded_arrays.Size(); ++i) {
+    // Same as for the class data above, the set of objects does not change.
+    encoded_arrays[i].release();  // NOLINT b/117926937
+    encoded_arrays[i].reset(new_encoded_array_order[i]);
+  }
+
   if (DexLayout::kChangeClassDefOrder) {
     // This currently produces dex files that violate the spec since the super class class_def is
     // supposed to occur before any subclasses.
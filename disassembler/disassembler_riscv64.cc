@@ -0,0 +1,1712 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disassembler_riscv64.h"
+
+#include <inttypes.h>
+
+#include <ostream>
+#include <sstream>
+
+#include "android-base/logging.h"
+#include "android-base/stringprintf.h"
+
+#include "base/bit_utils.h"
+
+using android::base::StringPrintf;
+
+namespace art {
+namespace riscv64 {
+
+class DisassemblerRiscv64::Printer {
+ public:
+  Printer(DisassemblerRiscv64* disassembler, std::ostream& os)
+      : disassembler_(disassembler), os_(os) {}
+
+  void Dump32(const uint8_t* insn);
+  void Dump16(const uint8_t* insn);
+  void Dump2Byte(const uint8_t* data);
+  void DumpByte(const uint8_t* data);
+
+ private:
+  // This enumeration should mirror the declarations in runtime/arch/riscv64/registers_riscv64.h.
+  // We do not include that file to avoid a dependency on libart.
+  enum {
+    Zero = 0,
+    RA = 1,
+    SP = 2,
+    TR = 9,
+  };
+
+  enum class MemAddressMode : uint32_t {
+    kUnitStride = 0x0,
+    kIndexedUnordered = 0x1,
+    kStrided = 0x2,
+    kIndexedOrdered = 0x3,
+  };
+
+  static const char* XRegName(uint32_t regno);
+  static const char* FRegName(uint32_t regno);
+  static const char* VRegName(uint32_t regno);
+  static const char* RoundingModeName(uint32_t rm);
+
+  static int32_t SignExtend(uint32_t value, size_t width) {
+    return BitFieldExtract(static_cast<int32_t>(value), 0, width);
+  }
+
+  static uint32_t GetRd(uint32_t insn32) { return (insn32 >> 7) & 0x1fu; }
+  static uint32_t GetRs1(uint32_t insn32) { return (insn32 >> 15) & 0x1fu; }
+  static uint32_t GetRs2(uint32_t insn32) { return (insn32 >> 20) & 0x1fu; }
+  static uint32_t GetRs3(uint32_t insn32) { return insn32 >> 27; }
+  static uint32_t GetFunct3(uint32_t insn32) { return (insn32 >> 12) & 7u; }
+  static uint32_t GetFunct7(uint32_t insn32) { return insn32 >> 25; }
+  static uint32_t GetRoundingMode(uint32_t insn32) { return GetFunct3(insn32); }
+
+  static int32_t Decode32Imm12(uint32_t insn32) {
+    return SignExtend(insn32 >> 20, 12);
+  }
+
+  static int32_t Decode32StoreOffset(uint32_t insn32) {
+    return SignExtend(((insn32 >> 20) & 0xfe0u) | ((insn32 >> 7) & 0x1fu), 12);
+  }
+
+  static int32_t Decode32BranchOffset(uint32_t insn32) {
+    uint32_t imm = ((insn32 >> 19) & 0x1000u) |  // imm[12] at bit 31
+                   ((insn32 << 4) & 0x800u) |    // imm[11] at bit 7
+                   ((insn32 >> 20) & 0x7e0u) |   // imm[10:5] at bits 30:25
+                   ((insn32 >> 7) & 0x1eu);      // imm[4:1] at bits 11:8
+    return SignExtend(imm, 13);
+  }
+
+  static int32_t Decode32JalOffset(uint32_t insn32) {
+    uint32_t imm = ((insn32 >> 11) & 0x100000u) |  // imm[20] at bit 31
+                   (insn32 & 0xff000u) |           // imm[19:12] at bits 19:12
+                   ((insn32 >> 9) & 0x800u) |      // imm[11] at bit 20
+                   ((insn32 >> 20) & 0x7feu);      // imm[10:1] at bits 30:21
+    return SignExtend(imm, 21);
+  }
+
+  void PrintBranchOffset(int32_t offset, const uint8_t* insn);
+  void PrintLoadStoreAddress(uint32_t rs1, int32_t offset);
+  void PrintThreadOffsetName(uint32_t rs1, int32_t offset);
+  void PrintEntrypointThunkName(const uint8_t* target);
+  void PrintCsrName(uint32_t csr);
+  void PrintVType(uint32_t vtype);
+  void PrintVectorMask(uint32_t insn32);
+
+  void Print32Lui(uint32_t insn32);
+  void Print32Auipc(const uint8_t* insn, uint32_t insn32);
+  void Print32Jal(const uint8_t* insn, uint32_t insn32);
+  void Print32Jalr(uint32_t insn32);
+  void Print32BCond(const uint8_t* insn, uint32_t insn32);
+  void Print32Load(uint32_t insn32);
+  void Print32Store(uint32_t insn32);
+  void Print32FLoad(uint32_t insn32);
+  void Print32FStore(uint32_t insn32);
+  void Print32VLoad(uint32_t insn32);
+  void Print32VStore(uint32_t insn32);
+  void Print32BinOpImm(uint32_t insn32);
+  void Print32BinOp(uint32_t insn32);
+  void Print32Atomic(uint32_t insn32);
+  void Print32FpOp(uint32_t insn32);
+  void Print32RVVOp(uint32_t insn32);
+  void Print32FpFma(uint32_t insn32);
+  void Print32Zicsr(uint32_t insn32);
+  void Print32Fence(uint32_t insn32);
+
+  void Print16Quadrant0(uint32_t insn16);
+  void Print16Quadrant1(const uint8_t* insn, uint32_t insn16);
+  void Print16Quadrant2(uint32_t insn16);
+
+  DisassemblerRiscv64* const disassembler_;
+  std::ostream& os_;
+};
+
+const char* DisassemblerRiscv64::Printer::XRegName(uint32_t regno) {
+  static const char* const kXRegisterNames[] = {
+      "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+      "fp", "tr", "a0", "a1", "a2", "a3", "a4", "a5",
+      "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+      "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6",
+  };
+  static_assert(32u == arraysize(kXRegisterNames));
+  DCHECK_LT(regno, arraysize(kXRegisterNames));
+  return kXRegisterNames[regno];
+}
+
+const char* DisassemblerRiscv64::Printer::FRegName(uint32_t regno) {
+  static const char* const kFRegisterNames[] = {
+      "ft0", "ft1", "ft2", "ft3", "ft4", "ft5", "ft6", "ft7",
+      "fs0", "fs1", "fa0", "fa1", "fa2", "fa3", "fa4", "fa5",
+      "fa6", "fa7", "fs2", "fs3", "fs4", "fs5", "fs6", "fs7",
+      "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11",
+  };
+  static_assert(32u == arraysize(kFRegisterNames));
+  DCHECK_LT(regno, arraysize(kFRegisterNames));
+  return kFRegisterNames[regno];
+}
+
+const char* DisassemblerRiscv64::Printer::VRegName(uint32_t regno) {
+  static const char* const kVRegisterNames[] = {
+      "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7",
+      "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15",
+      "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23",
+      "v24", "v25", "v26", "v27", "v28", "v29", "v30", "v31",
+  };
+  static_assert(32u == arraysize(kVRegisterNames));
+  DCHECK_LT(regno, arraysize(kVRegisterNames));
+  return kVRegisterNames[regno];
+}
+
+const char* DisassemblerRiscv64::Printer::RoundingModeName(uint32_t rm) {
+  // Note: We do not print the rounding mode for DYN.
+  static const char* const kRoundingModeNames[] = {
+      ", rne", ", rtz", ", rdn", ", rup", ", rmm", ", <reserved-rm>", ", <reserved-rm>", ""
+  };
+  static_assert(8u == arraysize(kRoundingModeNames));
+  DCHECK_LT(rm, arraysize(kRoundingModeNames));
+  return kRoundingModeNames[rm];
+}
+
+void DisassemblerRiscv64::Printer::PrintBranchOffset(int32_t offset, const uint8_t* insn) {
+  os_ << StringPrintf("%+d", offset)
+      << " ; " << disassembler_->FormatInstructionPointer(insn + offset);
+}
+
+void DisassemblerRiscv64::Printer::PrintLoadStoreAddress(uint32_t rs1, int32_t offset) {
+  os_ << offset << "(" << XRegName(rs1) << ")";
+}
+
+void DisassemblerRiscv64::Printer::PrintThreadOffsetName(uint32_t rs1, int32_t offset) {
+  if (rs1 == TR && offset >= 0) {
+    // Add entrypoint name.
+    os_ << " ; ";
+    disassembler_->GetDisassemblerOptions()->thread_offset_name_function_(
+        os_, static_cast<uint32_t>(offset));
+  }
+}
+
+void DisassemblerRiscv64::Printer::PrintEntrypointThunkName(const uint8_t* target) {
+  // Entrypoint thunks emitted by `CodeGeneratorRISCV64::EmitThunkCode()` start with
+  // `ld t6, offset(tr)`. Name the entrypoint if we can safely read the thunk.
+  const DisassemblerOptions* options = disassembler_->GetDisassemblerOptions();
+  if (target >= options->base_address_ &&
+      target + 4u <= options->end_address_ &&
+      IsAligned<2u>(target)) {
+    const uint16_t* target_halves = reinterpret_cast<const uint16_t*>(target);
+    uint32_t target_insn = static_cast<uint32_t>(target_halves[0]) |
+                           (static_cast<uint32_t>(target_halves[1]) << 16);
+    constexpr uint32_t kLdTmpFromTrMask = 0x000fffffu;
+    constexpr uint32_t kLdTmpFromTr = 0x0004bf83u;  // ld t6, 0(tr)
+    if ((target_insn & kLdTmpFromTrMask) == kLdTmpFromTr) {
+      PrintThreadOffsetName(TR, Decode32Imm12(target_insn));
+    }
+  }
+}
+
+void DisassemblerRiscv64::Printer::PrintCsrName(uint32_t csr) {
+  switch (csr) {
+    case 0x001: os_ << "fflags"; break;
+    case 0x002: os_ << "frm"; break;
+    case 0x003: os_ << "fcsr"; break;
+    case 0x008: os_ << "vstart"; break;
+    case 0x009: os_ << "vxsat"; break;
+    case 0x00a: os_ << "vxrm"; break;
+    case 0x00f: os_ << "vcsr"; break;
+    case 0xc00: os_ << "cycle"; break;
+    case 0xc01: os_ << "time"; break;
+    case 0xc02: os_ << "instret"; break;
+    case 0xc20: os_ << "vl"; break;
+    case 0xc21: os_ << "vtype"; break;
+    case 0xc22: os_ << "vlenb"; break;
+    default: os_ << StringPrintf("0x%03x", csr); break;
+  }
+}
+
+void DisassemblerRiscv64::Printer::PrintVType(uint32_t vtype) {
+  static const char* const kSewNames[] = {
+      "e8", "e16", "e32", "e64", "<reserved-sew>", "<reserved-sew>", "<reserved-sew>",
+      "<reserved-sew>"
+  };
+  static const char* const kLmulNames[] = {
+      "m1", "m2", "m4", "m8", "<reserved-lmul>", "mf8", "mf4", "mf2"
+  };
+  if ((vtype & ~0xffu) != 0u) {
+    os_ << StringPrintf("0x%x", vtype);
+    return;
+  }
+  os_ << kSewNames[(vtype >> 3) & 7u] << ", " << kLmulNames[vtype & 7u]
+      << (((vtype & 0x40u) != 0u) ? ", ta" : ", tu")
+      << (((vtype & 0x80u) != 0u) ? ", ma" : ", mu");
+}
+
+void DisassemblerRiscv64::Printer::PrintVectorMask(uint32_t insn32) {
+  // The `vm` bit is clear for masked operations.
+  if ((insn32 & (1u << 25)) == 0u) {
+    os_ << ", v0.t";
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print32Lui(uint32_t insn32) {
+  uint32_t imm20 = insn32 >> 12;
+  os_ << "lui " << XRegName(GetRd(insn32)) << ", " << StringPrintf("0x%x", imm20);
+}
+
+void DisassemblerRiscv64::Printer::Print32Auipc(const uint8_t* insn, uint32_t insn32) {
+  // The AUIPC is usually followed by an ADDI, LOAD or STORE completing the PC-relative address,
+  // so we print the high part of the offset and the address it points to with a zero low part.
+  int32_t offset = static_cast<int32_t>(insn32 & 0xfffff000u);
+  os_ << "auipc " << XRegName(GetRd(insn32)) << ", " << StringPrintf("0x%x", insn32 >> 12)
+      << " ; " << disassembler_->FormatInstructionPointer(insn + offset);
+}
+
+void DisassemblerRiscv64::Printer::Print32Jal(const uint8_t* insn, uint32_t insn32) {
+  uint32_t rd = GetRd(insn32);
+  int32_t offset = Decode32JalOffset(insn32);
+  if (rd == Zero) {
+    os_ << "j ";
+  } else if (rd == RA) {
+    os_ << "jal ";
+  } else {
+    os_ << "jal " << XRegName(rd) << ", ";
+  }
+  PrintBranchOffset(offset, insn);
+  if (rd == RA) {
+    PrintEntrypointThunkName(insn + offset);
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print32Jalr(uint32_t insn32) {
+  uint32_t rd = GetRd(insn32);
+  uint32_t rs1 = GetRs1(insn32);
+  int32_t imm12 = Decode32Imm12(insn32);
+  // Print shorter macro instruction notation if available.
+  if (rd == Zero && rs1 == RA && imm12 == 0) {
+    os_ << "ret";
+  } else if (rd == Zero && imm12 == 0) {
+    os_ << "jr " << XRegName(rs1);
+  } else if (rd == RA && imm12 == 0) {
+    os_ << "jalr " << XRegName(rs1);
+  } else {
+    // Note: Printing the full "jalr rd, offset(rs1)" for non-standard uses.
+    os_ << "jalr " << XRegName(rd) << ", ";
+    PrintLoadStoreAddress(rs1, imm12);
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print32BCond(const uint8_t* insn, uint32_t insn32) {
+  static const char* const kOpcodes[] = {
+      "beq", "bne", nullptr, nullptr, "blt", "bge", "bltu", "bgeu"
+  };
+  uint32_t funct3 = GetFunct3(insn32);
+  const char* opcode = kOpcodes[funct3];
+  if (opcode == nullptr) {
+    os_ << "<unknown32>";
+    return;
+  }
+
+  // Print shorter macro instruction notation if available.
+  uint32_t rs1 = GetRs1(insn32);
+  uint32_t rs2 = GetRs2(insn32);
+  if (rs2 == Zero) {
+    os_ << opcode << "z " << XRegName(rs1);
+  } else if (rs1 == Zero && (funct3 == 4u || funct3 == 5u)) {
+    // blt zero, rs2, offset ... bgtz rs2, offset
+    // bge zero, rs2, offset ... blez rs2, offset
+    os_ << (funct3 == 4u ? "bgtz " : "blez ") << XRegName(rs2);
+  } else {
+    os_ << opcode << " " << XRegName(rs1) << ", " << XRegName(rs2);
+  }
+  os_ << ", ";
+  PrintBranchOffset(Decode32BranchOffset(insn32), insn);
+}
+
+void DisassemblerRiscv64::Printer::Print32Load(uint32_t insn32) {
+  static const char* const kOpcodes[] = {
+      "lb", "lh", "lw", "ld", "lbu", "lhu", "lwu", nullptr
+  };
+  uint32_t funct3 = GetFunct3(insn32);
+  const char* opcode = kOpcodes[funct3];
+  if (opcode == nullptr) {
+    os_ << "<unknown32>";
+    return;
+  }
+
+  uint32_t rs1 = GetRs1(insn32);
+  int32_t offset = Decode32Imm12(insn32);
+  os_ << opcode << " " << XRegName(GetRd(insn32)) << ", ";
+  PrintLoadStoreAddress(rs1, offset);
+  PrintThreadOffsetName(rs1, offset);
+}
+
+void DisassemblerRiscv64::Printer::Print32Store(uint32_t insn32) {
+  static const char* const kOpcodes[] = {
+      "sb", "sh", "sw", "sd", nullptr, nullptr, nullptr, nullptr
+  };
+  uint32_t funct3 = GetFunct3(insn32);
+  const char* opcode = kOpcodes[funct3];
+  if (opcode == nullptr) {
+    os_ << "<unknown32>";
+    return;
+  }
+
+  uint32_t rs1 = GetRs1(insn32);
+  int32_t offset = Decode32StoreOffset(insn32);
+  os_ << opcode << " " << XRegName(GetRs2(insn32)) << ", ";
+  PrintLoadStoreAddress(rs1, offset);
+  PrintThreadOffsetName(rs1, offset);
+}
+
+void DisassemblerRiscv64::Printer::Print32FLoad(uint32_t insn32) {
+  uint32_t funct3 = GetFunct3(insn32);
+  if (funct3 != 2u && funct3 != 3u) {
+    Print32VLoad(insn32);
+    return;
+  }
+
+  uint32_t rs1 = GetRs1(insn32);
+  int32_t offset = Decode32Imm12(insn32);
+  os_ << (funct3 == 2u ? "flw " : "fld ") << FRegName(GetRd(insn32)) << ", ";
+  PrintLoadStoreAddress(rs1, offset);
+  PrintThreadOffsetName(rs1, offset);
+}
+
+void DisassemblerRiscv64::Printer::Print32FStore(uint32_t insn32) {
+  uint32_t funct3 = GetFunct3(insn32);
+  if (funct3 != 2u && funct3 != 3u) {
+    Print32VStore(insn32);
+    return;
+  }
+
+  uint32_t rs1 = GetRs1(insn32);
+  int32_t offset = Decode32StoreOffset(insn32);
+  os_ << (funct3 == 2u ? "fsw " : "fsd ") << FRegName(GetRs2(insn32)) << ", ";
+  PrintLoadStoreAddress(rs1, offset);
+  PrintThreadOffsetName(rs1, offset);
+}
+
+// Returns the element width in bits encoded in the `width` field of a vector load or store,
+// or 0 if this is not a vector memory access.
+static uint32_t GetVectorMemoryEew(uint32_t width) {
+  switch (width) {
+    case 0u: return 8u;
+    case 5u: return 16u;
+    case 6u: return 32u;
+    case 7u: return 64u;
+    default: return 0u;
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print32VLoad(uint32_t insn32) {
+  uint32_t eew = GetVectorMemoryEew(GetFunct3(insn32));
+  uint32_t mew = (insn32 >> 28) & 1u;
+  if (eew == 0u || mew != 0u) {
+    os_ << "<unknown32>";
+    return;
+  }
+  uint32_t nf = (insn32 >> 29) + 1u;
+  MemAddressMode mode = static_cast<MemAddressMode>((insn32 >> 26) & 3u);
+  std::string segment = (nf != 1u) ? StringPrintf("seg%u", nf) : std::string();
+  const char* vd = VRegName(GetRd(insn32));
+  const char* rs1 = XRegName(GetRs1(insn32));
+  uint32_t rs2 = GetRs2(insn32);
+  switch (mode) {
+    case MemAddressMode::kUnitStride:
+      switch (rs2) {  // The `lumop` field.
+        case 0x00u:
+          os_ << "vl" << segment << "e" << eew << ".v " << vd << ", (" << rs1 << ")";
+          break;
+        case 0x08u:
+          os_ << "vl" << nf << "re" << eew << ".v " << vd << ", (" << rs1 << ")";
+          return;  // Whole register loads are never masked.
+        case 0x0bu:
+          os_ << "vlm.v " << vd << ", (" << rs1 << ")";
+          return;  // Mask loads are never masked.
+        case 0x10u:
+          os_ << "vl" << segment << "e" << eew << "ff.v " << vd << ", (" << rs1 << ")";
+          break;
+        default:
+          os_ << "<unknown32>";
+          return;
+      }
+      break;
+    case MemAddressMode::kStrided:
+      os_ << "vls" << segment << "e" << eew << ".v " << vd << ", (" << rs1 << "), "
+          << XRegName(rs2);
+      break;
+    case MemAddressMode::kIndexedUnordered:
+    case MemAddressMode::kIndexedOrdered:
+      os_ << (mode == MemAddressMode::kIndexedOrdered ? "vlox" : "vlux") << segment << "ei" << eew
+          << ".v " << vd << ", (" << rs1 << "), " << VRegName(rs2);
+      break;
+  }
+  PrintVectorMask(insn32);
+}
+
+void DisassemblerRiscv64::Printer::Print32VStore(uint32_t insn32) {
+  uint32_t eew = GetVectorMemoryEew(GetFunct3(insn32));
+  uint32_t mew = (insn32 >> 28) & 1u;
+  if (eew == 0u || mew != 0u) {
+    os_ << "<unknown32>";
+    return;
+  }
+  uint32_t nf = (insn32 >> 29) + 1u;
+  MemAddressMode mode = static_cast<MemAddressMode>((insn32 >> 26) & 3u);
+  std::string segment = (nf != 1u) ? StringPrintf("seg%u", nf) : std::string();
+  const char* vs3 = VRegName(GetRd(insn32));
+  const char* rs1 = XRegName(GetRs1(insn32));
+  uint32_t rs2 = GetRs2(insn32);
+  switch (mode) {
+    case MemAddressMode::kUnitStride:
+      switch (rs2) {  // The `sumop` field.
+        case 0x00u:
+          os_ << "vs" << segment << "e" << eew << ".v " << vs3 << ", (" << rs1 << ")";
+          break;
+        case 0x08u:
+          // Whole register stores are always encoded with EEW=8 and are never masked.
+          os_ << "vs" << nf << "r.v " << vs3 << ", (" << rs1 << ")";
+          return;
+        case 0x0bu:
+          os_ << "vsm.v " << vs3 << ", (" << rs1 << ")";
+          return;  // Mask stores are never masked.
+        default:
+          os_ << "<unknown32>";
+          return;
+      }
+      break;
+    case MemAddressMode::kStrided:
+      os_ << "vss" << segment << "e" << eew << ".v " << vs3 << ", (" << rs1 << "), "
+          << XRegName(rs2);
+      break;
+    case MemAddressMode::kIndexedUnordered:
+    case MemAddressMode::kIndexedOrdered:
+      os_ << (mode == MemAddressMode::kIndexedOrdered ? "vsox" : "vsux") << segment << "ei" << eew
+          << ".v " << vs3 << ", (" << rs1 << "), " << VRegName(rs2);
+      break;
+  }
+  PrintVectorMask(insn32);
+}
+
+void DisassemblerRiscv64::Printer::Print32BinOpImm(uint32_t insn32) {
+  // Covers both OP-IMM (0x13) and OP-IMM-32 (0x1b).
+  bool narrow = (insn32 & 0x7fu) == 0x1bu;
+  uint32_t funct3 = GetFunct3(insn32);
+  uint32_t rd = GetRd(insn32);
+  uint32_t rs1 = GetRs1(insn32);
+  int32_t imm = Decode32Imm12(insn32);
+
+  // Print shorter macro instruction notation if available.
+  if (funct3 == /*ADDI*/ 0u && imm == 0) {
+    if (narrow) {
+      os_ << "sext.w " << XRegName(rd) << ", " << XRegName(rs1);
+    } else if (rd == Zero && rs1 == Zero) {
+      os_ << "nop";  // Only canonical nop. Non-Zero `rd == rs1` nops are printed as "mv".
+    } else {
+      os_ << "mv " << XRegName(rd) << ", " << XRegName(rs1);
+    }
+    return;
+  } else if (!narrow && funct3 == /*XORI*/ 4u && imm == -1) {
+    os_ << "not " << XRegName(rd) << ", " << XRegName(rs1);
+    return;
+  } else if (!narrow && funct3 == /*ANDI*/ 7u && imm == 0xff) {
+    os_ << "zext.b " << XRegName(rd) << ", " << XRegName(rs1);
+    return;
+  } else if (!narrow && funct3 == /*ADDI*/ 0u && rs1 == Zero) {
+    os_ << "li " << XRegName(rd) << ", " << imm;
+    return;
+  } else if (!narrow && funct3 == /*SLTIU*/ 3u && imm == 1) {
+    os_ << "seqz " << XRegName(rd) << ", " << XRegName(rs1);
+    return;
+  }
+
+  uint32_t funct6 = insn32 >> 26;
+  uint32_t shamt = (insn32 >> 20) & (narrow ? 0x1fu : 0x3fu);
+  const char* opcode = nullptr;
+  const char* suffix = narrow ? "w" : "";
+  bool print_shamt = false;
+  bool unary = false;
+  switch (funct3) {
+    case 0u:
+      opcode = "addi";
+      break;
+    case 1u:
+      if (narrow ? (GetFunct7(insn32) == 0x00u) : (funct6 == 0x00u)) {
+        opcode = "slli";
+        print_shamt = true;
+      } else if (narrow && funct6 == 0x02u) {
+        opcode = "slli.uw";  // Zba
+        suffix = "";
+        shamt = (insn32 >> 20) & 0x3fu;
+        print_shamt = true;
+      } else if (!narrow && funct6 == 0x0au) {
+        opcode = "bseti";  // Zbs
+        print_shamt = true;
+      } else if (!narrow && funct6 == 0x12u) {
+        opcode = "bclri";  // Zbs
+        print_shamt = true;
+      } else if (!narrow && funct6 == 0x1au) {
+        opcode = "binvi";  // Zbs
+        print_shamt = true;
+      } else if ((insn32 >> 20) == 0x600u) {
+        opcode = "clz";  // Zbb
+        unary = true;
+      } else if ((insn32 >> 20) == 0x601u) {
+        opcode = "ctz";  // Zbb
+        unary = true;
+      } else if ((insn32 >> 20) == 0x602u) {
+        opcode = "cpop";  // Zbb
+        unary = true;
+      } else if (!narrow && (insn32 >> 20) == 0x604u) {
+        opcode = "sext.b";  // Zbb
+        unary = true;
+      } else if (!narrow && (insn32 >> 20) == 0x605u) {
+        opcode = "sext.h";  // Zbb
+        unary = true;
+      }
+      break;
+    case 2u:
+      opcode = narrow ? nullptr : "slti";
+      break;
+    case 3u:
+      opcode = narrow ? nullptr : "sltiu";
+      break;
+    case 4u:
+      opcode = narrow ? nullptr : "xori";
+      break;
+    case 5u:
+      if (narrow ? (GetFunct7(insn32) == 0x00u) : (funct6 == 0x00u)) {
+        opcode = "srli";
+        print_shamt = true;
+      } else if (narrow ? (GetFunct7(insn32) == 0x20u) : (funct6 == 0x10u)) {
+        opcode = "srai";
+        print_shamt = true;
+      } else if (narrow ? (GetFunct7(insn32) == 0x30u) : (funct6 == 0x18u)) {
+        opcode = "rori";  // Zbb
+        print_shamt = true;
+      } else if (!narrow && funct6 == 0x12u) {
+        opcode = "bexti";  // Zbs
+        print_shamt = true;
+      } else if (!narrow && (insn32 >> 20) == 0x287u) {
+        opcode = "orc.b";  // Zbb
+        unary = true;
+      } else if (!narrow && (insn32 >> 20) == 0x6b8u) {
+        opcode = "rev8";  // Zbb
+        unary = true;
+      }
+      break;
+    case 6u:
+      opcode = narrow ? nullptr : "ori";
+      break;
+    case 7u:
+      opcode = narrow ? nullptr : "andi";
+      break;
+  }
+  if (opcode == nullptr) {
+    os_ << "<unknown32>";
+    return;
+  }
+
+  os_ << opcode << suffix << " " << XRegName(rd) << ", " << XRegName(rs1);
+  if (print_shamt) {
+    os_ << ", " << shamt;
+  } else if (!unary) {
+    os_ << ", " << imm;
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print32BinOp(uint32_t insn32) {
+  // Covers both OP (0x33) and OP-32 (0x3b).
+  bool narrow = (insn32 & 0x7fu) == 0x3bu;
+  uint32_t funct7 = GetFunct7(insn32);
+  uint32_t funct3 = GetFunct3(insn32);
+  uint32_t rd = GetRd(insn32);
+  uint32_t rs1 = GetRs1(insn32);
+  uint32_t rs2 = GetRs2(insn32);
+
+  // Print shorter macro instruction notation if available.
+  if (funct7 == 0x20u && funct3 == /*SUB*/ 0u && rs1 == Zero) {
+    os_ << (narrow ? "negw " : "neg ") << XRegName(rd) << ", " << XRegName(rs2);
+    return;
+  } else if (!narrow && funct7 == 0x00u && funct3 == /*SLTU*/ 3u && rs1 == Zero) {
+    os_ << "snez " << XRegName(rd) << ", " << XRegName(rs2);
+    return;
+  } else if (narrow && funct7 == 0x04u && funct3 == /*ADD.UW*/ 0u && rs2 == Zero) {
+    os_ << "zext.w " << XRegName(rd) << ", " << XRegName(rs1);  // Zba
+    return;
+  } else if (funct7 == 0x04u && funct3 == 4u && rs2 == Zero && narrow) {
+    os_ << "zext.h " << XRegName(rd) << ", " << XRegName(rs1);  // Zbb
+    return;
+  }
+
+  const char* opcode = nullptr;
+  const char* suffix = narrow ? "w" : "";
+  switch (funct7) {
+    case 0x00u: {
+      static const char* const kOpcodes[] = {
+          "add", "sll", "slt", "sltu", "xor", "srl", "or", "and"
+      };
+      opcode = kOpcodes[funct3];
+      if (narrow && funct3 != 0u && funct3 != 1u && funct3 != 5u) {
+        opcode = nullptr;
+      }
+      break;
+    }
+    case 0x01u: {  // M extension.
+      static const char* const kOpcodes[] = {
+          "mul", "mulh", "mulhsu", "mulhu", "div", "divu", "rem", "remu"
+      };
+      opcode = kOpcodes[funct3];
+      if (narrow && (funct3 == 1u || funct3 == 2u || funct3 == 3u)) {
+        opcode = nullptr;
+      }
+      break;
+    }
+    case 0x04u:
+      if (narrow && funct3 == 0u) {
+        opcode = "add.uw";  // Zba
+        suffix = "";
+      }
+      break;
+    case 0x05u:  // Zbb
+      if (!narrow) {
+        static const char* const kOpcodes[] = {
+            nullptr, nullptr, nullptr, nullptr, "min", "minu", "max", "maxu"
+        };
+        opcode = kOpcodes[funct3];
+      }
+      break;
+    case 0x10u:  // Zba
+      if (funct3 == 2u || funct3 == 4u || funct3 == 6u) {
+        static const char* const kOpcodes[] = {
+            nullptr, nullptr, "sh1add", nullptr, "sh2add", nullptr, "sh3add", nullptr
+        };
+        opcode = kOpcodes[funct3];
+        suffix = narrow ? ".uw" : "";
+      }
+      break;
+    case 0x14u:  // Zbs
+      if (!narrow && funct3 == 1u) {
+        opcode = "bset";
+      }
+      break;
+    case 0x20u:
+      if (funct3 == 0u) {
+        opcode = "sub";
+      } else if (funct3 == 5u) {
+        opcode = "sra";
+      } else if (!narrow && funct3 == 4u) {
+        opcode = "xnor";  // Zbb
+      } else if (!narrow && funct3 == 6u) {
+        opcode = "orn";  // Zbb
+      } else if (!narrow && funct3 == 7u) {
+        opcode = "andn";  // Zbb
+      }
+      break;
+    case 0x24u:  // Zbs
+      if (!narrow && funct3 == 1u) {
+        opcode = "bclr";
+      } else if (!narrow && funct3 == 5u) {
+        opcode = "bext";
+      }
+      break;
+    case 0x30u:  // Zbb
+      if (funct3 == 1u) {
+        opcode = "rol";
+      } else if (funct3 == 5u) {
+        opcode = "ror";
+      }
+      break;
+    case 0x34u:  // Zbs
+      if (!narrow && funct3 == 1u) {
+        opcode = "binv";
+      }
+      break;
+    default:
+      break;
+  }
+  if (opcode == nullptr) {
+    os_ << "<unknown32>";
+    return;
+  }
+
+  os_ << opcode << suffix << " " << XRegName(rd) << ", " << XRegName(rs1) << ", "
+      << XRegName(rs2);
+}
+
+void DisassemblerRiscv64::Printer::Print32Atomic(uint32_t insn32) {
+  uint32_t funct3 = GetFunct3(insn32);
+  uint32_t funct5 = (insn32 >> 27);
+  if (funct3 != 2u && funct3 != 3u) {  // There are only 32-bit and 64-bit LR/SC/AMO*.
+    os_ << "<unknown32>";
+    return;
+  }
+
+  static const char* const kOpcodes[] = {
+      "amoadd", "amoswap", "lr", "sc", "amoxor", nullptr, nullptr, nullptr,
+      "amoor", nullptr, nullptr, nullptr, "amoand", nullptr, nullptr, nullptr,
+      "amomin", nullptr, nullptr, nullptr, "amomax", nullptr, nullptr, nullptr,
+      "amominu", nullptr, nullptr, nullptr, "amomaxu", nullptr, nullptr, nullptr
+  };
+  static const char* const kAqRlSuffixes[] = {
+      "", ".rl", ".aq", ".aqrl"
+  };
+  const char* opcode = kOpcodes[funct5];
+  if (opcode == nullptr) {
+    os_ << "<unknown32>";
+    return;
+  }
+
+  uint32_t rd = GetRd(insn32);
+  uint32_t rs1 = GetRs1(insn32);
+  uint32_t rs2 = GetRs2(insn32);
+  const char* type = (funct3 == 2u) ? ".w" : ".d";
+  const char* aqrl = kAqRlSuffixes[(insn32 >> 25) & 3u];
+  os_ << opcode << type << aqrl << " " << XRegName(rd) << ", ";
+  if (funct5 == /*LR*/ 2u) {
+    if (rs2 != 0u) {
+      os_ << "<bad2>" << ", ";
+    }
+  } else {
+    os_ << XRegName(rs2) << ", ";
+  }
+  os_ << "(" << XRegName(rs1) << ")";
+}
+
+void DisassemblerRiscv64::Printer::Print32FpOp(uint32_t insn32) {
+  uint32_t fmt = (insn32 >> 25) & 3u;
+  if (fmt >= 2u) {
+    os_ << "<unknown32>";  // No support for half, quad or reserved formats.
+    return;
+  }
+  const char* type = (fmt == 0u) ? ".s" : ".d";
+  uint32_t funct5 = insn32 >> 27;
+  uint32_t funct3 = GetFunct3(insn32);
+  uint32_t rd = GetRd(insn32);
+  uint32_t rs1 = GetRs1(insn32);
+  uint32_t rs2 = GetRs2(insn32);
+  uint32_t rm = GetRoundingMode(insn32);
+  switch (funct5) {
+    case 0x00u:
+    case 0x01u:
+    case 0x02u:
+    case 0x03u: {
+      static const char* const kOpcodes[] = { "fadd", "fsub", "fmul", "fdiv" };
+      os_ << kOpcodes[funct5] << type << " " << FRegName(rd) << ", " << FRegName(rs1) << ", "
+          << FRegName(rs2) << RoundingModeName(rm);
+      return;
+    }
+    case 0x04u: {  // FSGNJ
+      // Print shorter macro instruction notation if available.
+      static const char* const kOpcodes[] = { "fsgnj", "fsgnjn", "fsgnjx" };
+      static const char* const kPseudoOpcodes[] = { "fmv", "fneg", "fabs" };
+      if (funct3 >= 3u) {
+        break;
+      }
+      if (rs1 == rs2) {
+        os_ << kPseudoOpcodes[funct3] << type << " " << FRegName(rd) << ", " << FRegName(rs1);
+      } else {
+        os_ << kOpcodes[funct3] << type << " " << FRegName(rd) << ", " << FRegName(rs1) << ", "
+            << FRegName(rs2);
+      }
+      return;
+    }
+    case 0x05u:  // FMIN/FMAX
+      if (funct3 >= 2u) {
+        break;
+      }
+      os_ << (funct3 == 0u ? "fmin" : "fmax") << type << " " << FRegName(rd) << ", "
+          << FRegName(rs1) << ", " << FRegName(rs2);
+      return;
+    case 0x08u:  // FCVT between FP types.
+      if (fmt == 0u && rs2 == 1u) {
+        os_ << "fcvt.s.d " << FRegName(rd) << ", " << FRegName(rs1) << RoundingModeName(rm);
+        return;
+      } else if (fmt == 1u && rs2 == 0u) {
+        // Note: The rounding mode is irrelevant for FCVT.D.S as the conversion is exact.
+        os_ << "fcvt.d.s " << FRegName(rd) << ", " << FRegName(rs1);
+        return;
+      }
+      break;
+    case 0x0bu:  // FSQRT
+      if (rs2 != 0u) {
+        break;
+      }
+      os_ << "fsqrt" << type << " " << FRegName(rd) << ", " << FRegName(rs1)
+          << RoundingModeName(rm);
+      return;
+    case 0x14u: {  // FLE/FLT/FEQ
+      static const char* const kOpcodes[] = { "fle", "flt", "feq" };
+      if (funct3 >= 3u) {
+        break;
+      }
+      os_ << kOpcodes[funct3] << type << " " << XRegName(rd) << ", " << FRegName(rs1) << ", "
+          << FRegName(rs2);
+      return;
+    }
+    case 0x18u:    // FCVT to integer.
+    case 0x1au: {  // FCVT from integer.
+      static const char* const kIntTypes[] = { ".w", ".wu", ".l", ".lu" };
+      if (rs2 >= 4u) {
+        break;
+      }
+      if (funct5 == 0x18u) {
+        os_ << "fcvt" << kIntTypes[rs2] << type << " " << XRegName(rd) << ", " << FRegName(rs1)
+            << RoundingModeName(rm);
+      } else {
+        os_ << "fcvt" << type << kIntTypes[rs2] << " " << FRegName(rd) << ", " << XRegName(rs1)
+            << RoundingModeName(rm);
+      }
+      return;
+    }
+    case 0x1cu:  // FMV from FPR to GPR, or FCLASS
+      if (rs2 != 0u || funct3 >= 2u) {
+        break;
+      }
+      if (funct3 == 0u) {
+        os_ << (fmt == 0u ? "fmv.x.w " : "fmv.x.d ") << XRegName(rd) << ", " << FRegName(rs1);
+      } else {
+        os_ << "fclass" << type << " " << XRegName(rd) << ", " << FRegName(rs1);
+      }
+      return;
+    case 0x1eu:  // FMV from GPR to FPR
+      if (rs2 != 0u || funct3 != 0u) {
+        break;
+      }
+      os_ << (fmt == 0u ? "fmv.w.x " : "fmv.d.x ") << FRegName(rd) << ", " << XRegName(rs1);
+      return;
+    default:
+      break;
+  }
+  os_ << "<unknown32>";
+}
+
+void DisassemblerRiscv64::Printer::Print32FpFma(uint32_t insn32) {
+  uint32_t fmt = (insn32 >> 25) & 3u;
+  if (fmt >= 2u) {
+    os_ << "<unknown32>";  // No support for half, quad or reserved formats.
+    return;
+  }
+  static const char* const kOpcodes[] = { "fmadd", "fmsub", "fnmsub", "fnmadd" };
+  const char* opcode = kOpcodes[((insn32 & 0x7fu) >> 2) & 3u];
+  os_ << opcode << (fmt == 0u ? ".s " : ".d ") << FRegName(GetRd(insn32)) << ", "
+      << FRegName(GetRs1(insn32)) << ", " << FRegName(GetRs2(insn32)) << ", "
+      << FRegName(GetRs3(insn32)) << RoundingModeName(GetRoundingMode(insn32));
+}
+
+void DisassemblerRiscv64::Printer::Print32RVVOp(uint32_t insn32) {
+  // The funct3 field selects the operand category: OPIVV, OPFVV, OPMVV, OPIVI, OPIVX, OPFVF,
+  // OPMVX or the vector configuration instructions.
+  enum OpCategory : uint32_t {
+    kOPIVV = 0u,
+    kOPFVV = 1u,
+    kOPMVV = 2u,
+    kOPIVI = 3u,
+    kOPIVX = 4u,
+    kOPFVF = 5u,
+    kOPMVX = 6u,
+    kOPCFG = 7u,
+  };
+
+  uint32_t category = GetFunct3(insn32);
+  uint32_t funct6 = insn32 >> 26;
+  uint32_t vm = (insn32 >> 25) & 1u;
+  uint32_t vd = GetRd(insn32);
+  uint32_t vs1 = GetRs1(insn32);
+  uint32_t vs2 = GetRs2(insn32);
+
+  if (category == kOPCFG) {
+    if ((insn32 >> 31) == 0u) {
+      os_ << "vsetvli " << XRegName(vd) << ", " << XRegName(vs1) << ", ";
+      PrintVType((insn32 >> 20) & 0x7ffu);
+    } else if ((insn32 >> 30) == 3u) {
+      os_ << "vsetivli " << XRegName(vd) << ", " << vs1 << ", ";
+      PrintVType((insn32 >> 20) & 0x3ffu);
+    } else if (GetFunct7(insn32) == 0x40u) {
+      os_ << "vsetvl " << XRegName(vd) << ", " << XRegName(vs1) << ", " << XRegName(vs2);
+    } else {
+      os_ << "<unknown32>";
+    }
+    return;
+  }
+
+  // Third operand for OPIVV/OPMVV/OPFVV, OPIVX/OPMVX, OPFVF and OPIVI respectively.
+  auto print_op1 = [&]() {
+    switch (category) {
+      case kOPIVV:
+      case kOPMVV:
+      case kOPFVV:
+        os_ << VRegName(vs1);
+        break;
+      case kOPIVX:
+      case kOPMVX:
+        os_ << XRegName(vs1);
+        break;
+      case kOPFVF:
+        os_ << FRegName(vs1);
+        break;
+      case kOPIVI:
+        os_ << SignExtend(vs1, 5);
+        break;
+    }
+  };
+  static const char* const kVvSuffixes[] = {
+      ".vv", ".vv", ".vv", ".vi", ".vx", ".vf", ".vx"
+  };
+  static const char* const kWvSuffixes[] = {
+      ".wv", ".wv", ".wv", ".wi", ".wx", ".wf", ".wx"
+  };
+  const char* suffix = kVvSuffixes[category];
+
+  if (category == kOPIVV || category == kOPIVX || category == kOPIVI) {
+    static const char* const kOpcodes[] = {
+        "vadd", nullptr, "vsub", "vrsub", "vminu", "vmin", "vmaxu", "vmax",
+        nullptr, "vand", "vor", "vxor", "vrgather", nullptr, "vslideup", "vslidedown",
+        "vadc", "vmadc", "vsbc", "vmsbc", nullptr, nullptr, nullptr, "vmerge",
+        "vmseq", "vmsne", "vmsltu", "vmslt", "vmsleu", "vmsle", "vmsgtu", "vmsgt",
+        "vsaddu", "vsadd", "vssubu", "vssub", nullptr, "vsll", nullptr, "vsmul",
+        "vsrl", "vsra", "vssrl", "vssra", "vnsrl", "vnsra", "vnclipu", "vnclip",
+        "vwredsumu", "vwredsum", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    };
+    static_assert(64u == arraysize(kOpcodes));
+    const char* opcode = kOpcodes[funct6];
+    // Print shorter macro instruction notation if available.
+    if (funct6 == 0x03u && category == kOPIVX && vs1 == Zero) {
+      os_ << "vneg.v " << VRegName(vd) << ", " << VRegName(vs2);
+      PrintVectorMask(insn32);
+      return;
+    } else if (funct6 == 0x0bu && category == kOPIVI && SignExtend(vs1, 5) == -1) {
+      os_ << "vnot.v " << VRegName(vd) << ", " << VRegName(vs2);
+      PrintVectorMask(insn32);
+      return;
+    } else if (funct6 == 0x17u && vm == 1u) {
+      if (vs2 != 0u) {
+        os_ << "<unknown32>";
+      } else {
+        os_ << "vmv.v." << (suffix + 2) << " " << VRegName(vd) << ", ";
+        print_op1();
+      }
+      return;
+    } else if (funct6 == 0x27u && category == kOPIVI) {
+      uint32_t nr = vs1 + 1u;
+      if ((nr & vs1) != 0u) {
+        os_ << "<unknown32>";  // Only 1, 2, 4 and 8 registers can be moved.
+      } else {
+        os_ << "vmv" << nr << "r.v " << VRegName(vd) << ", " << VRegName(vs2);
+      }
+      return;
+    } else if (funct6 == 0x0eu && category == kOPIVV) {
+      opcode = "vrgatherei16";
+    }
+    if (opcode == nullptr ||
+        (category == kOPIVI && (funct6 == 0x02u || funct6 == 0x04u || funct6 == 0x05u ||
+                                funct6 == 0x06u || funct6 == 0x07u || funct6 == 0x12u ||
+                                funct6 == 0x13u || funct6 == 0x1au || funct6 == 0x1bu ||
+                                funct6 == 0x22u || funct6 == 0x23u || funct6 >= 0x30u)) ||
+        (category == kOPIVV && (funct6 == 0x03u || funct6 == 0x0fu || funct6 == 0x1eu ||
+                                funct6 == 0x1fu)) ||
+        (category != kOPIVV && funct6 >= 0x30u)) {
+      os_ << "<unknown32>";
+      return;
+    }
+    bool carry = (funct6 >= 0x10u && funct6 <= 0x13u) || funct6 == 0x17u;
+    if (funct6 >= 0x2cu && funct6 <= 0x2fu) {
+      suffix = kWvSuffixes[category];
+    } else if (funct6 >= 0x30u) {
+      suffix = ".vs";
+    }
+    os_ << opcode << suffix << ((carry && vm == 0u) ? "m " : " ") << VRegName(vd) << ", "
+        << VRegName(vs2) << ", ";
+    // Shift amounts, slide offsets and gather indexes are unsigned immediates.
+    bool unsigned_imm = funct6 == 0x0cu || funct6 == 0x0eu || funct6 == 0x0fu ||
+                        funct6 == 0x25u || (funct6 >= 0x28u && funct6 <= 0x2fu);
+    if (category == kOPIVI && unsigned_imm) {
+      os_ << vs1;
+    } else {
+      print_op1();
+    }
+    if (carry) {
+      if (vm == 0u) {
+        os_ << ", v0";
+      }
+    } else {
+      PrintVectorMask(insn32);
+    }
+    return;
+  }
+
+  if (category == kOPMVV || category == kOPMVX) {
+    static const char* const kOpcodes[] = {
+        "vredsum", "vredand", "vredor", "vredxor", "vredminu", "vredmin", "vredmaxu", "vredmax",
+        "vaaddu", "vaadd", "vasubu", "vasub", nullptr, nullptr, "vslide1up", "vslide1down",
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "vcompress",
+        "vmandn", "vmand", "vmor", "vmxor", "vmorn", "vmnand", "vmnor", "vmxnor",
+        "vdivu", "vdiv", "vremu", "vrem", "vmulhu", "vmul", "vmulhsu", "vmulh",
+        nullptr, "vmadd", nullptr, "vnmsub", nullptr, "vmacc", nullptr, "vnmsac",
+        "vwaddu", "vwadd", "vwsubu", "vwsub", "vwaddu", "vwadd", "vwsubu", "vwsub",
+        "vwmulu", nullptr, "vwmulsu", "vwmul", "vwmaccu", "vwmacc", "vwmaccus", "vwmaccsu",
+    };
+    static_assert(64u == arraysize(kOpcodes));
+    if (funct6 == 0x10u) {  // VWXUNARY0 / VRXUNARY0
+      if (category == kOPMVV && vs1 == 0x00u && vm == 1u) {
+        os_ << "vmv.x.s " << XRegName(vd) << ", " << VRegName(vs2);
+      } else if (category == kOPMVV && (vs1 == 0x10u || vs1 == 0x11u)) {
+        os_ << (vs1 == 0x10u ? "vcpop.m " : "vfirst.m ") << XRegName(vd) << ", "
+            << VRegName(vs2);
+        PrintVectorMask(insn32);
+      } else if (category == kOPMVX && vs2 == 0u && vm == 1u) {
+        os_ << "vmv.s.x " << VRegName(vd) << ", " << XRegName(vs1);
+      } else {
+        os_ << "<unknown32>";
+      }
+      return;
+    } else if (funct6 == 0x12u) {  // VXUNARY0
+      static const char* const kExtOpcodes[] = {
+          nullptr, nullptr, "vzext.vf8", "vsext.vf8", "vzext.vf4", "vsext.vf4", "vzext.vf2",
+          "vsext.vf2"
+      };
+      if (category != kOPMVV || vs1 >= arraysize(kExtOpcodes) || kExtOpcodes[vs1] == nullptr) {
+        os_ << "<unknown32>";
+        return;
+      }
+      os_ << kExtOpcodes[vs1] << " " << VRegName(vd) << ", " << VRegName(vs2);
+      PrintVectorMask(insn32);
+      return;
+    } else if (funct6 == 0x14u) {  // VMUNARY0
+      if (category != kOPMVV) {
+        os_ << "<unknown32>";
+        return;
+      }
+      switch (vs1) {
+        case 0x01u: os_ << "vmsbf.m " << VRegName(vd) << ", " << VRegName(vs2); break;
+        case 0x02u: os_ << "vmsof.m " << VRegName(vd) << ", " << VRegName(vs2); break;
+        case 0x03u: os_ << "vmsif.m " << VRegName(vd) << ", " << VRegName(vs2); break;
+        case 0x10u: os_ << "viota.m " << VRegName(vd) << ", " << VRegName(vs2); break;
+        case 0x11u: os_ << "vid.v " << VRegName(vd); break;
+        default:
+          os_ << "<unknown32>";
+          return;
+      }
+      PrintVectorMask(insn32);
+      return;
+    }
+    const char* opcode = kOpcodes[funct6];
+    if (opcode == nullptr ||
+        (category == kOPMVX && (funct6 < 0x08u || funct6 == 0x17u ||
+                                (funct6 >= 0x18u && funct6 < 0x20u))) ||
+        (category == kOPMVV && (funct6 == 0x0eu || funct6 == 0x0fu || funct6 == 0x3eu))) {
+      os_ << "<unknown32>";
+      return;
+    }
+    if (funct6 < 0x08u) {
+      suffix = ".vs";
+    } else if (funct6 == 0x17u) {
+      suffix = ".vm";
+    } else if (funct6 >= 0x18u && funct6 < 0x20u) {
+      suffix = ".mm";
+    } else if (funct6 >= 0x34u && funct6 < 0x38u) {
+      suffix = kWvSuffixes[category];
+    }
+    // Multiply-add instructions take the multiplier before the multiplicand.
+    bool fused = (funct6 >= 0x28u && funct6 < 0x30u) || funct6 >= 0x3cu;
+    os_ << opcode << suffix << " " << VRegName(vd) << ", ";
+    if (fused) {
+      print_op1();
+      os_ << ", " << VRegName(vs2);
+    } else {
+      os_ << VRegName(vs2) << ", ";
+      print_op1();
+    }
+    if (funct6 < 0x18u || funct6 >= 0x20u) {
+      PrintVectorMask(insn32);
+    }
+    return;
+  }
+
+  DCHECK(category == kOPFVV || category == kOPFVF);
+  static const char* const kOpcodes[] = {
+      "vfadd", "vfredusum", "vfsub", "vfredosum", "vfmin", "vfredmin", "vfmax", "vfredmax",
+      "vfsgnj", "vfsgnjn", "vfsgnjx", nullptr, nullptr, nullptr, "vfslide1up", "vfslide1down",
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "vfmerge",
+      "vmfeq", "vmfle", nullptr, "vmflt", "vmfne", "vmfgt", nullptr, "vmfge",
+      "vfdiv", "vfrdiv", nullptr, nullptr, "vfmul", nullptr, nullptr, "vfrsub",
+      "vfmadd", "vfnmadd", "vfmsub", "vfnmsub", "vfmacc", "vfnmacc", "vfmsac", "vfnmsac",
+      "vfwadd", "vfwredusum", "vfwsub", "vfwredosum", "vfwadd", nullptr, "vfwsub", nullptr,
+      "vfwmul", nullptr, nullptr, nullptr, "vfwmacc", "vfwnmacc", "vfwmsac", "vfwnmsac",
+  };
+  static_assert(64u == arraysize(kOpcodes));
+  if (funct6 == 0x10u) {  // VWFUNARY0 / VRFUNARY0
+    if (category == kOPFVV && vs1 == 0u && vm == 1u) {
+      os_ << "vfmv.f.s " << FRegName(vd) << ", " << VRegName(vs2);
+    } else if (category == kOPFVF && vs2 == 0u && vm == 1u) {
+      os_ << "vfmv.s.f " << VRegName(vd) << ", " << FRegName(vs1);
+    } else {
+      os_ << "<unknown32>";
+    }
+    return;
+  } else if (funct6 == 0x12u || funct6 == 0x13u) {  // VFUNARY0 / VFUNARY1
+    static const char* const kUnary0Opcodes[] = {
+        "vfcvt.xu.f.v", "vfcvt.x.f.v", "vfcvt.f.xu.v", "vfcvt.f.x.v",
+        nullptr, nullptr, "vfcvt.rtz.xu.f.v", "vfcvt.rtz.x.f.v",
+        "vfwcvt.xu.f.v", "vfwcvt.x.f.v", "vfwcvt.f.xu.v", "vfwcvt.f.x.v",
+        "vfwcvt.f.f.v", nullptr, "vfwcvt.rtz.xu.f.v", "vfwcvt.rtz.x.f.v",
+        "vfncvt.xu.f.w", "vfncvt.x.f.w", "vfncvt.f.xu.w", "vfncvt.f.x.w",
+        "vfncvt.f.f.w", "vfncvt.rod.f.f.w", "vfncvt.rtz.xu.f.w", "vfncvt.rtz.x.f.w",
+    };
+    const char* opcode = nullptr;
+    if (category == kOPFVV && funct6 == 0x12u && vs1 < arraysize(kUnary0Opcodes)) {
+      opcode = kUnary0Opcodes[vs1];
+    } else if (category == kOPFVV && funct6 == 0x13u) {
+      opcode = (vs1 == 0x00u) ? "vfsqrt.v"
+             : (vs1 == 0x04u) ? "vfrsqrt7.v"
+             : (vs1 == 0x05u) ? "vfrec7.v"
+             : (vs1 == 0x10u) ? "vfclass.v"
+             : nullptr;
+    }
+    if (opcode == nullptr) {
+      os_ << "<unknown32>";
+      return;
+    }
+    os_ << opcode << " " << VRegName(vd) << ", " << VRegName(vs2);
+    PrintVectorMask(insn32);
+    return;
+  } else if (funct6 == 0x17u) {  // VFMERGE / VFMV
+    if (category != kOPFVF) {
+      os_ << "<unknown32>";
+    } else if (vm == 1u) {
+      if (vs2 != 0u) {
+        os_ << "<unknown32>";
+      } else {
+        os_ << "vfmv.v.f " << VRegName(vd) << ", " << FRegName(vs1);
+      }
+    } else {
+      os_ << "vfmerge.vfm " << VRegName(vd) << ", " << VRegName(vs2) << ", " << FRegName(vs1)
+          << ", v0";
+    }
+    return;
+  }
+
+  const char* opcode = kOpcodes[funct6];
+  bool reduction = (funct6 < 0x08u && (funct6 & 1u) != 0u) || funct6 == 0x31u || funct6 == 0x33u;
+  if (opcode == nullptr ||
+      (category == kOPFVF && reduction) ||
+      (category == kOPFVV && (funct6 == 0x0eu || funct6 == 0x0fu || funct6 == 0x1du ||
+                              funct6 == 0x1fu || funct6 == 0x21u || funct6 == 0x27u))) {
+    os_ << "<unknown32>";
+    return;
+  }
+  // Print shorter macro instruction notation if available.
+  if (category == kOPFVV && (funct6 == 0x09u || funct6 == 0x0au) && vs1 == vs2) {
+    os_ << (funct6 == 0x09u ? "vfneg.v " : "vfabs.v ") << VRegName(vd) << ", " << VRegName(vs2);
+    PrintVectorMask(insn32);
+    return;
+  }
+  if (reduction) {
+    suffix = ".vs";
+  } else if (funct6 == 0x34u || funct6 == 0x36u) {
+    suffix = kWvSuffixes[category];
+  }
+  // Multiply-add instructions take the multiplier before the multiplicand.
+  bool fused = (funct6 >= 0x28u && funct6 < 0x30u) || funct6 >= 0x3cu;
+  os_ << opcode << suffix << " " << VRegName(vd) << ", ";
+  if (fused) {
+    print_op1();
+    os_ << ", " << VRegName(vs2);
+  } else {
+    os_ << VRegName(vs2) << ", ";
+    print_op1();
+  }
+  PrintVectorMask(insn32);
+}
+
+void DisassemblerRiscv64::Printer::Print32Zicsr(uint32_t insn32) {
+  uint32_t funct3 = GetFunct3(insn32);
+  uint32_t rd = GetRd(insn32);
+  uint32_t rs1 = GetRs1(insn32);
+  uint32_t csr = insn32 >> 20;
+  if (funct3 == 0u) {
+    if (insn32 == 0x00000073u) {
+      os_ << "ecall";
+    } else if (insn32 == 0x00100073u) {
+      os_ << "ebreak";
+    } else {
+      os_ << "<unknown32>";
+    }
+    return;
+  } else if (funct3 == 4u) {
+    os_ << "<unknown32>";
+    return;
+  }
+
+  // Print shorter macro instruction notation if available.
+  bool imm = (funct3 & 4u) != 0u;
+  uint32_t op = funct3 & 3u;  // 1 = CSRRW, 2 = CSRRS, 3 = CSRRC.
+  if (!imm && op == 2u && rs1 == Zero) {
+    os_ << "csrr " << XRegName(rd) << ", ";
+    PrintCsrName(csr);
+    return;
+  }
+  static const char* const kOpcodes[] = { nullptr, "csrrw", "csrrs", "csrrc" };
+  static const char* const kPseudoOpcodes[] = { nullptr, "csrw", "csrs", "csrc" };
+  if (rd == Zero) {
+    os_ << kPseudoOpcodes[op] << (imm ? "i " : " ");
+  } else {
+    os_ << kOpcodes[op] << (imm ? "i " : " ") << XRegName(rd) << ", ";
+  }
+  PrintCsrName(csr);
+  os_ << ", ";
+  if (imm) {
+    os_ << rs1;
+  } else {
+    os_ << XRegName(rs1);
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print32Fence(uint32_t insn32) {
+  uint32_t funct3 = GetFunct3(insn32);
+  if (funct3 == 1u) {
+    os_ << "fence.i";
+    return;
+  }
+  if (funct3 != 0u || GetRd(insn32) != Zero || GetRs1(insn32) != Zero) {
+    os_ << "<unknown32>";
+    return;
+  }
+  uint32_t fm = insn32 >> 28;
+  uint32_t pred = (insn32 >> 24) & 0xfu;
+  uint32_t succ = (insn32 >> 20) & 0xfu;
+  if (fm == 8u && pred == 3u && succ == 3u) {
+    os_ << "fence.tso";
+    return;
+  } else if (fm != 0u) {
+    os_ << "<unknown32>";
+    return;
+  } else if (pred == 0x1u && succ == 0x0u) {
+    os_ << "pause";  // Zihintpause
+    return;
+  }
+  auto print_flags = [&](uint32_t flags) {
+    if (flags == 0u) {
+      os_ << "0";
+      return;
+    }
+    if ((flags & 8u) != 0u) os_ << "i";
+    if ((flags & 4u) != 0u) os_ << "o";
+    if ((flags & 2u) != 0u) os_ << "r";
+    if ((flags & 1u) != 0u) os_ << "w";
+  };
+  os_ << "fence ";
+  print_flags(pred);
+  os_ << ", ";
+  print_flags(succ);
+}
+
+void DisassemblerRiscv64::Printer::Dump32(const uint8_t* insn) {
+  // Note: The instruction may be only 2-byte aligned if the C extension is used.
+  const uint16_t* halfwords = reinterpret_cast<const uint16_t*>(insn);
+  uint32_t insn32 = static_cast<uint32_t>(halfwords[0]) |
+                    (static_cast<uint32_t>(halfwords[1]) << 16);
+  DCHECK_EQ(insn32 & 3u, 3u);
+  os_ << disassembler_->FormatInstructionPointer(insn) << StringPrintf(": %08x\t", insn32);
+
+  uint32_t opcode = insn32 & 0x7fu;
+  switch (opcode) {
+    case 0x03u:
+      Print32Load(insn32);
+      break;
+    case 0x07u:
+      Print32FLoad(insn32);
+      break;
+    case 0x0fu:
+      Print32Fence(insn32);
+      break;
+    case 0x13u:
+    case 0x1bu:
+      Print32BinOpImm(insn32);
+      break;
+    case 0x17u:
+      Print32Auipc(insn, insn32);
+      break;
+    case 0x23u:
+      Print32Store(insn32);
+      break;
+    case 0x27u:
+      Print32FStore(insn32);
+      break;
+    case 0x2fu:
+      Print32Atomic(insn32);
+      break;
+    case 0x33u:
+    case 0x3bu:
+      Print32BinOp(insn32);
+      break;
+    case 0x37u:
+      Print32Lui(insn32);
+      break;
+    case 0x43u:
+    case 0x47u:
+    case 0x4bu:
+    case 0x4fu:
+      Print32FpFma(insn32);
+      break;
+    case 0x53u:
+      Print32FpOp(insn32);
+      break;
+    case 0x57u:
+      Print32RVVOp(insn32);
+      break;
+    case 0x63u:
+      Print32BCond(insn, insn32);
+      break;
+    case 0x67u:
+      Print32Jalr(insn32);
+      break;
+    case 0x6fu:
+      Print32Jal(insn, insn32);
+      break;
+    case 0x73u:
+      Print32Zicsr(insn32);
+      break;
+    default:
+      os_ << "<unknown32>";
+      break;
+  }
+  os_ << "\n";
+}
+
+void DisassemblerRiscv64::Printer::Print16Quadrant0(uint32_t insn16) {
+  uint32_t funct3 = insn16 >> 13;
+  uint32_t rs1 = 8u + ((insn16 >> 7) & 7u);   // rs1' in bits 9:7.
+  uint32_t rd = 8u + ((insn16 >> 2) & 7u);    // rd' or rs2' in bits 4:2.
+  // Offsets for doubleword accesses: uimm[5:3] in bits 12:10, uimm[7:6] in bits 6:5.
+  uint32_t offset_d = ((insn16 >> 7) & 0x38u) | ((insn16 << 1) & 0xc0u);
+  // Offsets for word accesses: uimm[5:3] in bits 12:10, uimm[2] in bit 6, uimm[6] in bit 5.
+  uint32_t offset_w = ((insn16 >> 7) & 0x38u) | ((insn16 >> 4) & 0x4u) | ((insn16 << 1) & 0x40u);
+  switch (funct3) {
+    case 0u: {
+      // nzuimm[5:4|9:6|2|3] in bits 12:5.
+      uint32_t nzuimm = ((insn16 >> 7) & 0x30u) | ((insn16 >> 1) & 0x3c0u) |
+                        ((insn16 >> 4) & 0x4u) | ((insn16 >> 2) & 0x8u);
+      if (nzuimm == 0u) {
+        os_ << "<illegal16>";  // Includes the all-zero defined illegal instruction.
+        return;
+      }
+      os_ << "c.addi4spn " << XRegName(rd) << ", sp, " << nzuimm;
+      return;
+    }
+    case 1u:
+      os_ << "c.fld " << FRegName(rd) << ", ";
+      PrintLoadStoreAddress(rs1, offset_d);
+      return;
+    case 2u:
+      os_ << "c.lw " << XRegName(rd) << ", ";
+      PrintLoadStoreAddress(rs1, offset_w);
+      PrintThreadOffsetName(rs1, offset_w);
+      return;
+    case 3u:
+      os_ << "c.ld " << XRegName(rd) << ", ";
+      PrintLoadStoreAddress(rs1, offset_d);
+      PrintThreadOffsetName(rs1, offset_d);
+      return;
+    case 5u:
+      os_ << "c.fsd " << FRegName(rd) << ", ";
+      PrintLoadStoreAddress(rs1, offset_d);
+      return;
+    case 6u:
+      os_ << "c.sw " << XRegName(rd) << ", ";
+      PrintLoadStoreAddress(rs1, offset_w);
+      PrintThreadOffsetName(rs1, offset_w);
+      return;
+    case 7u:
+      os_ << "c.sd " << XRegName(rd) << ", ";
+      PrintLoadStoreAddress(rs1, offset_d);
+      PrintThreadOffsetName(rs1, offset_d);
+      return;
+    default:
+      os_ << "<unknown16>";
+      return;
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print16Quadrant1(const uint8_t* insn, uint32_t insn16) {
+  uint32_t funct3 = insn16 >> 13;
+  uint32_t rd = (insn16 >> 7) & 0x1fu;
+  // imm[5] in bit 12, imm[4:0] in bits 6:2.
+  uint32_t imm6_bits = ((insn16 >> 7) & 0x20u) | ((insn16 >> 2) & 0x1fu);
+  int32_t imm6 = SignExtend(imm6_bits, 6);
+  switch (funct3) {
+    case 0u:
+      if (rd == Zero) {
+        if (imm6 == 0) {
+          os_ << "c.nop";
+        } else {
+          os_ << "<hint16>";
+        }
+      } else {
+        os_ << "c.addi " << XRegName(rd) << ", " << imm6;
+      }
+      return;
+    case 1u:
+      if (rd == Zero) {
+        os_ << "<reserved16>";
+      } else {
+        os_ << "c.addiw " << XRegName(rd) << ", " << imm6;
+      }
+      return;
+    case 2u:
+      os_ << "c.li " << XRegName(rd) << ", " << imm6;
+      return;
+    case 3u:
+      if (rd == SP) {
+        // nzimm[9] in bit 12, nzimm[4|6|8:7|5] in bits 6:2.
+        uint32_t nzimm = ((insn16 >> 3) & 0x200u) | ((insn16 >> 2) & 0x10u) |
+                         ((insn16 << 1) & 0x40u) | ((insn16 << 4) & 0x180u) |
+                         ((insn16 << 3) & 0x20u);
+        if (nzimm == 0u) {
+          os_ << "<reserved16>";
+        } else {
+          os_ << "c.addi16sp sp, " << SignExtend(nzimm, 10);
+        }
+      } else if (imm6_bits == 0u) {
+        os_ << "<reserved16>";
+      } else {
+        os_ << "c.lui " << XRegName(rd) << ", " << StringPrintf("0x%x", imm6 & 0xfffff);
+      }
+      return;
+    case 4u: {
+      uint32_t rd_short = 8u + ((insn16 >> 7) & 7u);
+      uint32_t rs2_short = 8u + ((insn16 >> 2) & 7u);
+      uint32_t funct2 = (insn16 >> 10) & 3u;
+      switch (funct2) {
+        case 0u:
+          os_ << "c.srli " << XRegName(rd_short) << ", " << imm6_bits;
+          return;
+        case 1u:
+          os_ << "c.srai " << XRegName(rd_short) << ", " << imm6_bits;
+          return;
+        case 2u:
+          os_ << "c.andi " << XRegName(rd_short) << ", " << imm6;
+          return;
+        default: {
+          static const char* const kOpcodes[] = {
+              "c.sub", "c.xor", "c.or", "c.and", "c.subw", "c.addw", nullptr, nullptr
+          };
+          const char* opcode = kOpcodes[((insn16 >> 10) & 4u) | ((insn16 >> 5) & 3u)];
+          if (opcode == nullptr) {
+            os_ << "<unknown16>";  // Zcb instructions are not supported.
+          } else {
+            os_ << opcode << " " << XRegName(rd_short) << ", " << XRegName(rs2_short);
+          }
+          return;
+        }
+      }
+    }
+    case 5u: {
+      // offset[11|4|9:8|10|6|7|3:1|5] in bits 12:2.
+      uint32_t offset = ((insn16 >> 1) & 0x800u) | ((insn16 >> 7) & 0x10u) |
+                        ((insn16 >> 1) & 0x300u) | ((insn16 << 2) & 0x400u) |
+                        ((insn16 >> 1) & 0x40u) | ((insn16 << 1) & 0x80u) |
+                        ((insn16 >> 2) & 0xeu) | ((insn16 << 3) & 0x20u);
+      os_ << "c.j ";
+      PrintBranchOffset(SignExtend(offset, 12), insn);
+      return;
+    }
+    default: {
+      // offset[8|4:3] in bits 12:10, offset[7:6|2:1|5] in bits 6:2.
+      uint32_t rs1_short = 8u + ((insn16 >> 7) & 7u);
+      uint32_t offset = ((insn16 >> 4) & 0x100u) | ((insn16 >> 7) & 0x18u) |
+                        ((insn16 << 1) & 0xc0u) | ((insn16 >> 2) & 0x6u) |
+                        ((insn16 << 3) & 0x20u);
+      os_ << (funct3 == 6u ? "c.beqz " : "c.bnez ") << XRegName(rs1_short) << ", ";
+      PrintBranchOffset(SignExtend(offset, 9), insn);
+      return;
+    }
+  }
+}
+
+void DisassemblerRiscv64::Printer::Print16Quadrant2(uint32_t insn16) {
+  uint32_t funct3 = insn16 >> 13;
+  uint32_t rd = (insn16 >> 7) & 0x1fu;
+  uint32_t rs2 = (insn16 >> 2) & 0x1fu;
+  switch (funct3) {
+    case 0u: {
+      uint32_t shamt = ((insn16 >> 7) & 0x20u) | rs2;
+      if (rd == Zero || shamt == 0u) {
+        os_ << "<hint16>";
+      } else {
+        os_ << "c.slli " << XRegName(rd) << ", " << shamt;
+      }
+      return;
+    }
+    case 1u:
+    case 3u: {
+      // uimm[5] in bit 12, uimm[4:3] in bits 6:5, uimm[8:6] in bits 4:2.
+      uint32_t offset = ((insn16 >> 7) & 0x20u) | ((insn16 >> 2) & 0x18u) |
+                        ((insn16 << 4) & 0x1c0u);
+      if (funct3 == 1u) {
+        os_ << "c.fldsp " << FRegName(rd) << ", ";
+      } else if (rd == Zero) {
+        os_ << "<reserved16>";
+        return;
+      } else {
+        os_ << "c.ldsp " << XRegName(rd) << ", ";
+      }
+      PrintLoadStoreAddress(SP, offset);
+      return;
+    }
+    case 2u: {
+      // uimm[5] in bit 12, uimm[4:2] in bits 6:4, uimm[7:6] in bits 3:2.
+      uint32_t offset = ((insn16 >> 7) & 0x20u) | ((insn16 >> 2) & 0x1cu) |
+                        ((insn16 << 4) & 0xc0u);
+      if (rd == Zero) {
+        os_ << "<reserved16>";
+        return;
+      }
+      os_ << "c.lwsp " << XRegName(rd) << ", ";
+      PrintLoadStoreAddress(SP, offset);
+      return;
+    }
+    case 4u:
+      if ((insn16 & 0x1000u) == 0u) {
+        if (rs2 == Zero) {
+          if (rd == Zero) {
+            os_ << "<reserved16>";
+          } else {
+            os_ << "c.jr " << XRegName(rd);
+          }
+        } else {
+          os_ << "c.mv " << XRegName(rd) << ", " << XRegName(rs2);
+        }
+      } else {
+        if (rs2 == Zero) {
+          if (rd == Zero) {
+            os_ << "c.ebreak";
+          } else {
+            os_ << "c.jalr " << XRegName(rd);
+          }
+        } else {
+          os_ << "c.add " << XRegName(rd) << ", " << XRegName(rs2);
+        }
+      }
+      return;
+    case 5u:
+    case 7u: {
+      // uimm[5:3] in bits 12:10, uimm[8:6] in bits 9:7.
+      uint32_t offset = ((insn16 >> 7) & 0x38u) | ((insn16 >> 1) & 0x1c0u);
+      if (funct3 == 5u) {
+        os_ << "c.fsdsp " << FRegName(rs2) << ", ";
+      } else {
+        os_ << "c.sdsp " << XRegName(rs2) << ", ";
+      }
+      PrintLoadStoreAddress(SP, offset);
+      return;
+    }
+    case 6u: {
+      // uimm[5:2] in bits 12:9, uimm[7:6] in bits 8:7.
+      uint32_t offset = ((insn16 >> 7) & 0x3cu) | ((insn16 >> 1) & 0xc0u);
+      os_ << "c.swsp " << XRegName(rs2) << ", ";
+      PrintLoadStoreAddress(SP, offset);
+      return;
+    }
+    default:
+      os_ << "<unknown16>";
+      return;
+  }
+}
+
+void DisassemblerRiscv64::Printer::Dump16(const uint8_t* insn) {
+  uint32_t insn16 = *reinterpret_cast<const uint16_t*>(insn);
+  DCHECK_NE(insn16 & 3u, 3u);
+  os_ << disassembler_->FormatInstructionPointer(insn) << StringPrintf(": %04x    \t", insn16);
+
+  switch (insn16 & 3u) {
+    case 0u:
+      Print16Quadrant0(insn16);
+      break;
+    case 1u:
+      Print16Quadrant1(insn, insn16);
+      break;
+    default:
+      Print16Quadrant2(insn16);
+      break;
+  }
+  os_ << "\n";
+}
+
+void DisassemblerRiscv64::Printer::Dump2Byte(const uint8_t* data) {
+  uint32_t value = *reinterpret_cast<const uint16_t*>(data);
+  os_ << disassembler_->FormatInstructionPointer(data) << StringPrintf(": %04x    \t", value)
+      << ".2byte " << StringPrintf("0x%04x", value) << "\n";
+}
+
+void DisassemblerRiscv64::Printer::DumpByte(const uint8_t* data) {
+  uint32_t value = *data;
+  os_ << disassembler_->FormatInstructionPointer(data) << StringPrintf(": %02x      \t", value)
+      << ".byte " << StringPrintf("0x%02x", value) << "\n";
+}
+
+size_t DisassemblerRiscv64::Dump(std::ostream& os, const uint8_t* begin) {
+  Printer printer(this, os);
+  if (!IsAligned<2u>(begin)) {
+    printer.DumpByte(begin);
+    return 1u;
+  }
+  if ((*begin & 3u) == 3u) {
+    printer.Dump32(begin);
+    return 4u;
+  } else {
+    printer.Dump16(begin);
+    return 2u;
+  }
+}
+
+void DisassemblerRiscv64::Dump(std::ostream& os, const uint8_t* begin, const uint8_t* end) {
+  Printer printer(this, os);
+  const uint8_t* cur = begin;
+  if (cur < end && !IsAligned<2u>(cur)) {
+    // Unaligned, dump as a `.byte` to get to an aligned address.
+    printer.DumpByte(cur);
+    cur += 1;
+  }
+  if (cur >= end) {
+    return;
+  }
+  while (end - cur >= 4) {
+    if ((*cur & 3u) == 3u) {
+      printer.Dump32(cur);
+      cur += 4;
+    } else {
+      printer.Dump16(cur);
+      cur += 2;
+    }
+  }
+  if (end - cur >= 2) {
+    if ((*cur & 3u) == 3u) {
+      // Not enough data for a 32-bit instruction. Dump as `.2byte`.
+      printer.Dump2Byte(cur);
+    } else {
+      printer.Dump16(cur);
+    }
+    cur += 2;
+  }
+  if (end != cur) {
+    CHECK_EQ(end - cur, 1);
+    printer.DumpByte(cur);
+  }
+}
+
+}  // namespace riscv64
+}  // namespace art
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+
+#include <regex>
+#include <sstream>
+#include <vector>
+
+#include "base/common_art_test.h"
+#include "disassembler_riscv64.h"
+#include "thread.h"
+
+namespace art {
+namespace riscv64 {
+
+/**
+ * Fixture class for the ArtDisassemblerRiscv64Test tests.
+ */
+class ArtDisassemblerRiscv64Test : public CommonArtTest {
+ public:
+  ArtDisassemblerRiscv64Test() {
+  }
+
+  // Instructions are specified as a sequence of halfwords, the way they are laid out in memory
+  // with the C extension. A 32-bit instruction takes two halfwords, low halfword first.
+  void SetupCode(std::initializer_list<uint16_t> halfwords) {
+    code_.assign(halfwords);
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(code_.data());
+    disassembler_.reset(new DisassemblerRiscv64(
+        new DisassemblerOptions(/* absolute_addresses= */ false,
+                                begin,
+                                begin + code_.size() * sizeof(uint16_t),
+                                /* can_read_literals_= */ true,
+                                &Thread::DumpThreadOffset<PointerSize::k64>)));
+  }
+
+  // Disassembles the instruction at `offset` (in bytes) and matches the output, without the
+  // address and encoding prefix, against a regex. Fails if no match is found.
+  void CompareInstruction(size_t offset, size_t expected_size, const char* exp) {
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(code_.data()) + offset;
+    std::ostringstream oss;
+    size_t size = disassembler_->Dump(oss, begin);
+    EXPECT_EQ(expected_size, size);
+    std::string disassembly = oss.str();
+    size_t tab_pos = disassembly.find('\t');
+    ASSERT_NE(std::string::npos, tab_pos) << disassembly;
+    disassembly = disassembly.substr(tab_pos + 1u);
+    ASSERT_FALSE(disassembly.empty());
+    ASSERT_EQ('\n', disassembly.back());
+    disassembly.pop_back();
+    if (!std::regex_match(disassembly, std::regex(exp))) {
+      printf("\nExpected: %s\nFound:    %s\n", exp, disassembly.c_str());
+      ADD_FAILURE();
+    }
+  }
+
+  std::vector<uint16_t> code_;
+  std::unique_ptr<DisassemblerRiscv64> disassembler_;
+};
+
+TEST_F(ArtDisassemblerRiscv64Test, BaseInstructions) {
+  SetupCode({
+      0x8513, 0xffb5,  // addi a0, a1, -5
+      0x0013, 0x0000,  // addi zero, zero, 0
+      0xc533, 0x20c5,  // sh2add a0, a1, a2
+      0xd513, 0x6b85,  // rev8 a0, a1
+      0x9553, 0xc205,  // fcvt.w.d a0, fa1, rtz
+  });
+  CompareInstruction(0u, 4u, "addi a0, a1, -5");
+  CompareInstruction(4u, 4u, "nop");
+  CompareInstruction(8u, 4u, "sh2add a0, a1, a2");
+  CompareInstruction(12u, 4u, "rev8 a0, a1");
+  CompareInstruction(16u, 4u, "fcvt.w.d a0, fa1, rtz");
+}
+
+TEST_F(ArtDisassemblerRiscv64Test, CompressedInstructions) {
+  SetupCode({
+      0x157d,          // c.addi a0, -1
+      0xa001,          // c.j +0
+      0x8f82,          // c.jr t6
+      0x8513, 0xffb5,  // addi a0, a1, -5 at a 2-byte aligned address.
+  });
+  CompareInstruction(0u, 2u, "c.addi a0, -1");
+  CompareInstruction(2u, 2u, "c.j \\+0 ; 0x00000002");
+  CompareInstruction(4u, 2u, "c.jr t6");
+  CompareInstruction(6u, 4u, "addi a0, a1, -5");
+}
+
+TEST_F(ArtDisassemblerRiscv64Test, VectorInstructions) {
+  SetupCode({
+      0x7057, 0x0d05,  // vsetvli zero, a0, e32, m1, ta, ma
+      0x40d7, 0x0025,  // vadd.vx v1, v2, a0, v0.t
+      0x50d7, 0xb235,  // vfmacc.vf v1, fa0, v3
+  });
+  CompareInstruction(0u, 4u, "vsetvli zero, a0, e32, m1, ta, ma");
+  CompareInstruction(4u, 4u, "vadd.vx v1, v2, a0, v0.t");
+  CompareInstruction(8u, 4u, "vfmacc.vf v1, fa0, v3");
+}
+
+TEST_F(ArtDisassemblerRiscv64Test, ThreadOffset) {
+  SetupCode({
+      0xb503, 0x0084,  // ld a0, 8(tr)
+      0x6488,          // c.ld a0, 8(tr)
+      0xa283, 0x0005,  // lw t0, 0(a1)
+  });
+  // Test that we do append the field name if the instruction is a load from the address
+  // stored in the TR register.
+  CompareInstruction(0u, 4u, "ld a0, 8\\(tr\\) ; thin_lock_thread_id");
+  CompareInstruction(4u, 2u, "c.ld a0, 8\\(tr\\) ; thin_lock_thread_id");
+  // Test that we do not append anything for ineligible instruction.
+  CompareInstruction(6u, 4u, "lw t0, 0\\(a1\\)$");
+}
+
+TEST_F(ArtDisassemblerRiscv64Test, EntrypointThunkCall) {
+  SetupCode({
+      0x00ef, 0x0060,  // jal +6
+      0x0001,          // c.nop
+      0xbf83, 0x0004,  // ld t6, 0(tr)
+      0x8f82,          // c.jr t6
+  });
+  // Test that we do append the entrypoint name if the instruction is a call to a thunk
+  // that loads the entrypoint from the address in the TR register.
+  CompareInstruction(0u, 4u, "jal \\+6 ; 0x00000006 ; state_and_flags");
+  CompareInstruction(6u, 4u, "ld t6, 0\\(tr\\) ; state_and_flags");
+}
+
+}  // namespace riscv64
+}  // namespace art
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <optional>
@@ -456,16 +457,15 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
     // Attempt to find fields for all dirty bytes.
     mirror::Class* klass = entry->GetClass();
     std::string temp;
+    if (dump_dirty_objects_ && log_dirty_objects) {
+      dirty_object_offsets_.emplace(entry_offset, entry);
+    }
     if (entry->IsClass()) {
       os_ << tabs
           << "Class " << mirror::Class::PrettyClass(entry->AsClass()) << " " << entry << "\n";
-      os_ << tabs << "dirty_obj: " << entry_offset << " class "
-          << entry->AsClass()->DescriptorHash() << "\n";
     } else {
       os_ << tabs
           << "Instance of " << mirror::Class::PrettyClass(klass) << " " << entry << "\n";
-      os_ << tabs << "dirty_obj: " << entry_offset << " instance " << klass->DescriptorHash()
-          << "\n";
     }
     PrintEntryPages(reinterpret_cast<uintptr_t>(entry), EntrySize(entry), os_);
 
@@ -535,6 +535,31 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
         os_ << "Private dirty object: " << obj->AsClass()->GetDescriptor(&temp) << "\n";
       }
     }
+    // Dump all dirty objects in the format expected by dex2oat's --dirty-image-objects, so that
+    // the output can be used directly to pack them into the known dirty bin. dex2oat only uses
+    // these for the primary boot image, with offsets relative to its first component. All objects
+    // get the same sort key, dex2oat then keeps them in their original relative order.
+    const std::vector<gc::space::ImageSpace*>& spaces =
+        Runtime::Current()->GetHeap()->GetBootImageSpaces();
+    const ImageHeader& primary_header = spaces.front()->GetImageHeader();
+    const size_t num_primary_components =
+        std::min<size_t>(primary_header.GetComponentCount(), spaces.size());
+    const ImageHeader& image_header = RegionCommon<mirror::Object>::image_header_;
+    const bool is_primary_component = std::any_of(
+        spaces.begin(),
+        spaces.begin() + num_primary_components,
+        [&](gc::space::ImageSpace* space) { return &space->GetImageHeader() == &image_header; });
+    if (!is_primary_component) {
+      return;
+    }
+    const size_t image_offset = image_header.GetImageBegin() - primary_header.GetImageBegin();
+    for (const auto& [offset, obj] : dirty_object_offsets_) {
+      const bool is_class = obj->IsClass();
+      const uint32_t descriptor_hash =
+          is_class ? obj->AsClass()->DescriptorHash() : obj->GetClass()->DescriptorHash();
+      os_ << "dirty_obj: " << image_offset + offset << (is_class ? " class " : " instance ")
+          << descriptor_hash << " 0\n";
+    }
   }
 
   void DumpDirtyEntries() REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -669,6 +694,8 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
   std::ostream& os_;
   bool dump_dirty_objects_;
   std::unordered_set<mirror::Object*> dirty_objects_;
+  // Dirty objects by offset from the image begin, used for the --dirty-image-objects output.
+  std::map<size_t, mirror::Object*> dirty_object_offsets_;
   std::map<mirror::Class*, ClassData> class_data_;
 
   DISALLOW_COPY_AND_ASSIGN(RegionSpecializedBase);
@@ -1289,30 +1316,52 @@ class ImgDiagDumper {
       }
     }
 
+    // Read the page frame numbers, flags and counts of the whole mapping at once, rather than
+    // with four reads per page.
+    const size_t first_virtual_page_idx = boot_map.start / kPageSize;
+    const size_t num_pages = (boot_map.end - boot_map.start) / kPageSize;
+    std::vector<uint64_t> page_frame_numbers(num_pages);
+    std::vector<uint64_t> clean_page_frame_numbers(num_pages);
+    std::vector<uint64_t> page_flags(num_pages);
+    std::vector<uint64_t> page_counts(num_pages);
+    // TODO: virtual_page_idx needs to be from the same process
+    if (num_pages != 0u &&
+        (!GetPageFrameNumbers(&image_pagemap_file_,  // Image-diff-pid procmap
+                              first_virtual_page_idx,
+                              ArrayRef<uint64_t>(page_frame_numbers),
+                              error_msg) ||
+         !GetPageFrameNumbers(&zygote_pagemap_file_,  // Zygote procmap
+                              first_virtual_page_idx,
+                              ArrayRef<uint64_t>(clean_page_frame_numbers),
+                              error_msg) ||
+         !GetPageFlagsOrCounts(&kpageflags_file_,
+                               ArrayRef<const uint64_t>(page_frame_numbers),
+                               ArrayRef<uint64_t>(page_flags),
+                               error_msg) ||
+         !GetPageFlagsOrCounts(&kpagecount_file_,
+                               ArrayRef<const uint64_t>(page_frame_numbers),
+                               ArrayRef<uint64_t>(page_counts),
+                               error_msg))) {
+      return false;
+    }
+
     for (uintptr_t begin = boot_map.start; begin != boot_map.end; begin += kPageSize) {
       ptrdiff_t offset = begin - boot_map.start;
 
       // Virtual page number (for an absolute memory address)
       size_t virtual_page_idx = begin / kPageSize;
-
-      uint64_t page_count = 0xC0FFEE;
-      // TODO: virtual_page_idx needs to be from the same process
-      int dirtiness = (IsPageDirty(&image_pagemap_file_,     // Image-diff-pid procmap
-                                   &zygote_pagemap_file_,    // Zygote procmap
-                                   &kpageflags_file_,
-                                   &kpagecount_file_,
-                                   virtual_page_idx,  // compare same page in image
-                                   virtual_page_idx,  // and zygote
-                                   &page_count,
-                                   error_msg));
-      if (dirtiness < 0) {
-        return false;
-      } else if (dirtiness > 0) {
+      size_t page_idx = virtual_page_idx - first_virtual_page_idx;
+
+      uint64_t page_count = page_counts[page_idx];
+      const bool is_dirty = IsPageDirty(page_frame_numbers[page_idx],
+                                        clean_page_frame_numbers[page_idx],
+                                        page_flags[page_idx],
+                                        page_count);
+      if (is_dirty) {
         mapping_data->dirty_pages++;
         mapping_data->dirty_page_set.insert(mapping_data->dirty_page_set.end(), virtual_page_idx);
       }
 
-      const bool is_dirty = dirtiness > 0;
       const bool is_private = page_count == 1;
 
       if (is_private) {
@@ -1548,18 +1597,6 @@ class ImgDiagDumper {
     return true;
   }
 
-  // Note: On failure, `*page_frame_number` shall be clobbered.
-  static bool GetPageFrameNumber(File* page_map_file,
-                                 size_t virtual_page_index,
-                                 /*out*/ uint64_t* page_frame_number,
-                                 /*out*/ std::string* error_msg) {
-    CHECK(page_frame_number != nullptr);
-    return GetPageFrameNumbers(page_map_file,
-                               virtual_page_index,
-                               ArrayRef<uint64_t>(page_frame_number, 1u),
-                               error_msg);
-  }
-
   // Note: On failure, `page_frame_numbers[.]` shall be clobbered.
   static bool GetPageFrameNumbers(File* page_map_file,
                                   size_t virtual_page_index,
@@ -1623,54 +1660,14 @@ class ImgDiagDumper {
     return true;
   }
 
-  static int IsPageDirty(File* page_map_file,
-                         File* clean_pagemap_file,
-                         File* kpageflags_file,
-                         File* kpagecount_file,
-                         size_t virtual_page_idx,
-                         size_t clean_virtual_page_idx,
-                         // Out parameters:
-                         uint64_t* page_count, std::string* error_msg) {
-    CHECK(page_map_file != nullptr);
-    CHECK(clean_pagemap_file != nullptr);
-    CHECK_NE(page_map_file, clean_pagemap_file);
-    CHECK(kpageflags_file != nullptr);
-    CHECK(kpagecount_file != nullptr);
-    CHECK(page_count != nullptr);
-    CHECK(error_msg != nullptr);
-
+  // Returns whether the page at `page_frame_number`, with the given /proc/kpageflags entry, has
+  // diverged from the page at `page_frame_number_clean` mapped from the same file.
+  static bool IsPageDirty(uint64_t page_frame_number,
+                          uint64_t page_frame_number_clean,
+                          uint64_t kpage_flags_entry,
+                          uint64_t page_count) {
     // Constants are from https://www.kernel.org/doc/Documentation/vm/pagemap.txt
 
-    uint64_t page_frame_number = 0;
-    if (!GetPageFrameNumber(page_map_file, virtual_page_idx, &page_frame_number, error_msg)) {
-      return -1;
-    }
-
-    uint64_t page_frame_number_clean = 0;
-    if (!GetPageFrameNumber(clean_pagemap_file, clean_virtual_page_idx, &page_frame_number_clean,
-                            error_msg)) {
-      return -1;
-    }
-
-    // Read 64-bit entry from /proc/kpageflags to get the dirty bit for a page
-    uint64_t kpage_flags_entry = 0;
-    if (!kpageflags_file->PreadFully(&kpage_flags_entry,
-                                     kPageFlagsEntrySize,
-                                     page_frame_number * kPageFlagsEntrySize)) {
-      *error_msg = StringPrintf("Failed to read the page flags from %s",
-                                kpageflags_file->GetPath().c_str());
-      return -1;
-    }
-
-    // Read 64-bit entyry from /proc/kpagecount to get mapping counts for a page
-    if (!kpagecount_file->PreadFully(page_count /*out*/,
-                                     kPageCountEntrySize,
-                                     page_frame_number * kPageCountEntrySize)) {
-      *error_msg = StringPrintf("Failed to read the page count from %s",
-                                kpagecount_file->GetPath().c_str());
-      return -1;
-    }
-
     // There must be a page frame at the requested address.
     CHECK_EQ(kpage_flags_entry & kPageFlagsNoPageMask, 0u);
     // The page frame must be memory mapped
@@ -1687,11 +1684,11 @@ class ImgDiagDumper {
         LOG(ERROR) << "Check failed: page_frame_number != page_frame_number_clean "
             << "(page_frame_number=" << page_frame_number
             << ", page_frame_number_clean=" << page_frame_number_clean << ")"
-            << " count: " << *page_count << " flags: 0x" << std::hex << kpage_flags_entry;
+            << " count: " << page_count << " flags: 0x" << std::hex << kpage_flags_entry;
       }
     }
 
-    return (page_frame_number != page_frame_number_clean) ? 1 : 0;
+    return page_frame_number != page_frame_number_clean;
   }
 
   void PrintPidLine(const std::string& kind, pid_t pid) {
@@ -1870,7 +1867,8 @@ struct ImgDiagArgs : public CmdlineArgs {
         "  --zygote-diff-pid=<pid>: provide the PID of the zygote whose boot.art you want to diff "
         "against.\n"
         "      Example: --zygote-diff-pid=$(pid zygote)\n"
-        "  --dump-dirty-objects: additionally output dirty objects of interest.\n"
+        "  --dump-dirty-objects: additionally output dirty objects of interest, including\n"
+        "      'dirty_obj:' lines that can be passed to dex2oat --dirty-image-objects.\n"
         "\n";
 
     return usage;
@@ -43,6 +43,14 @@
   METRIC(ClassLoadingTotalTime, MetricsCounter)                     \
   METRIC(ClassVerificationTotalTime, MetricsCounter)                \
   METRIC(ClassVerificationCount, MetricsCounter)                    \
+  METRIC(ClassVerificationTime, MetricsHistogram, 15, 0, 10'000)    \
+  METRIC(ClassInitializationTotalTime, MetricsCounter)              \
+  METRIC(ClassInitializationCount, MetricsCounter)                  \
+  METRIC(ClassInitializationTime, MetricsHistogram, 15, 0, 10'000)  \
+  METRIC(OpenDexFilesFromOatTotalTime, MetricsCounter)              \
+  METRIC(OpenDexFilesFromOatCount, MetricsCounter)                  \
+  METRIC(AppImageLoadTotalTime, MetricsCounter)                     \
+  METRIC(BootImageLoadTime, MetricsCounter)                         \
   METRIC(WorldStopTimeDuringGCAvg, MetricsAverage)                  \
   METRIC(YoungGcCount, MetricsCounter)                              \
   METRIC(FullGcCount, MetricsCounter)                               \
@@ -54,12 +62,17 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                 \
   METRIC(JitMethodCompileCount, MetricsCounter)                     \
+  METRIC(JitBaselineCompileTotalTime, MetricsCounter)               \
+  METRIC(JitOptimizedCompileTotalTime, MetricsCounter)              \
+  METRIC(JitOsrCompileTotalTime, MetricsCounter)                    \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)    \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)     \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)        \
   METRIC(FullGcThroughput, MetricsHistogram, 15, 0, 10'000)         \
   METRIC(YoungGcTracingThroughput, MetricsHistogram, 15, 0, 10'000) \
   METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)  \
+  METRIC(TimeToSafepoint, MetricsHistogram, 15, 0, 10'000)          \
+  METRIC(LongTimeToSafepointCount, MetricsCounter)                  \
   METRIC(GcWorldStopTime, MetricsCounter)                           \
   METRIC(GcWorldStopCount, MetricsCounter)                          \
   METRIC(YoungGcScannedBytes, MetricsCounter)                       \
@@ -67,7 +80,11 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(NativeGcRequestCount, MetricsCounter)                      \
+  METRIC(NativeGcDeferredCount, MetricsCounter)                     \
+  METRIC(NativeGcReclaimedBytes, MetricsCounter)                    \
+  METRIC(NativeGcExpectedReclaimPercentAvg, MetricsAverage)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
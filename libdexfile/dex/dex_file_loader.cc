@@ -433,6 +433,7 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
                    << "Falling back to extracting file.";
     } else {
       // Map uncompressed files within zip as file-backed to avoid a dirty copy.
+      DEXFILE_SCOPED_TRACE(std::string("Map dex file ") + location);
       map = zip_entry->MapDirectlyFromFile(location.c_str(), /*out*/ error_msg);
       if (!map.IsValid()) {
         LOG(WARNING) << "Can't mmap dex file " << location << "!" << entry_name << " directly; "
@@ -443,7 +444,10 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
     }
   }
   if (!map.IsValid()) {
-    DEXFILE_SCOPED_TRACE(std::string("Extract dex file ") + location);
+    // Separate the time spent inflating compressed entries from plain reads of stored entries.
+    DEXFILE_SCOPED_TRACE(std::string(zip_entry->IsUncompressed() ? "Read dex file "
+                                                                  : "Inflate dex file ") +
+                         location);
 
     // Default path for compressed ZIP entries,
     // and fallback for stored ZIP entries.
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <limits>
 #include <memory>
 
@@ -1643,6 +1644,22 @@ bool DexFileVerifier::CheckIntraStringDataItem() {
       return false;
     }
 
+    // Most string data is ASCII. Skip eight characters at a time while they are all in the range
+    // [0x01, 0x7f], which need no further checks. A byte has its high bit set either in `word`
+    // if it is 0x80 or above, or in `word - kLowBits` if it is zero (or after such a byte).
+    static constexpr uint64_t kLowBits = UINT64_C(0x0101010101010101);
+    static constexpr uint64_t kHighBits = UINT64_C(0x8080808080808080);
+    if (size - i >= sizeof(uint64_t) &&
+        static_cast<size_t>(file_end - ptr_) >= sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, ptr_, sizeof(word));
+      if (((word | (word - kLowBits)) & kHighBits) == 0u) {
+        ptr_ += sizeof(uint64_t);
+        i += sizeof(uint64_t) - 1u;  // The loop increments `i` once more.
+        continue;
+      }
+    }
+
     uint8_t byte = *(ptr_++);
 
     // Switch on the high 4 bits.
@@ -16,6 +16,7 @@
 
 #include "type_lookup_table.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -159,11 +160,17 @@ void TypeLookupTable::Dump(std::ostream& os) const {
 }
 
 uint32_t TypeLookupTable::RawDataLength(uint32_t num_class_defs) {
-  return SupportedSize(num_class_defs) ? RoundUpToPowerOfTwo(num_class_defs) * sizeof(Entry) : 0u;
+  return SupportedSize(num_class_defs) ? (1u << CalculateMaskBits(num_class_defs)) * sizeof(Entry)
+                                       : 0u;
 }
 
 uint32_t TypeLookupTable::CalculateMaskBits(uint32_t num_class_defs) {
-  return SupportedSize(num_class_defs) ? MinimumBitsToStore(num_class_defs - 1u) : 0u;
+  if (!SupportedSize(num_class_defs)) {
+    return 0u;
+  }
+  // Keep the load factor at or below 1/2 so that most lookups find the class in the first probe,
+  // as long as the class def index and next position delta still fit in the entry data.
+  return std::min<uint32_t>(MinimumBitsToStore(2u * num_class_defs - 1u), kMaxMaskBits);
 }
 
 bool TypeLookupTable::SupportedSize(uint32_t num_class_defs) {
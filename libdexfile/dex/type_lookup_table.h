@@ -160,6 +160,9 @@ class TypeLookupTable {
     uint32_t data_;
   };
 
+  // Maximum number of mask bits, limited by the two `mask_bits`-wide fields of `Entry::data_`.
+  static constexpr uint32_t kMaxMaskBits = 16u;
+
   static uint32_t CalculateMaskBits(uint32_t num_class_defs);
   static bool SupportedSize(uint32_t num_class_defs);
 
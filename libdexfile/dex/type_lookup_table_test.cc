@@ -33,7 +33,7 @@ TEST_F(TypeLookupTableTest, CreateLookupTable) {
   TypeLookupTable table = TypeLookupTable::Create(*dex_file);
   ASSERT_TRUE(table.Valid());
   ASSERT_NE(nullptr, table.RawData());
-  ASSERT_EQ(32U, table.RawDataLength());
+  ASSERT_EQ(64U, table.RawDataLength());
 }
 
 TEST_P(TypeLookupTableTest, Find) {
@@ -16,6 +16,8 @@
 
 #include "utf.h"
 
+#include <string.h>
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
@@ -52,6 +54,16 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   size_t len = 0;
   const char* end = utf8 + byte_count;
   for (; utf8 < end; ++utf8) {
+    // Count eight ASCII characters at a time.
+    if (end - utf8 >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+      uint64_t word;
+      memcpy(&word, utf8, sizeof(word));
+      if ((word & UINT64_C(0x8080808080808080)) == 0u) {
+        len += sizeof(uint64_t);
+        utf8 += sizeof(uint64_t) - 1u;  // The loop increments `utf8` once more.
+        continue;
+      }
+    }
     int ic = *utf8;
     len++;
     if (LIKELY((ic & 0x80) == 0)) {
@@ -158,12 +170,7 @@ int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length)
 }
 
 uint32_t ComputeModifiedUtf8Hash(const char* chars) {
-  uint32_t hash = StartModifiedUtf8Hash();
-  while (*chars != '\0') {
-    hash = UpdateModifiedUtf8Hash(hash, *chars);
-    ++chars;
-  }
-  return hash;
+  return ComputeModifiedUtf8Hash(std::string_view(chars));
 }
 
 uint32_t ComputeModifiedUtf8Hash(std::string_view chars) {
@@ -380,6 +380,28 @@ TEST_F(UtfTest, ExhaustiveBidirectionalCodePointCheck) {
   }
 }
 
+TEST_F(UtfTest, LongStrings) {
+  // Exercise the paths that process several characters at once, with non-ASCII characters
+  // at every position relative to them.
+  for (size_t length = 0u; length != 40u; ++length) {
+    for (size_t non_ascii_pos = 0u; non_ascii_pos <= length; ++non_ascii_pos) {
+      std::string input(length, 'a');
+      if (non_ascii_pos != length) {
+        input.insert(non_ascii_pos, "\xc3\xa9");  // U+00E9, two bytes.
+      }
+      size_t expected_chars = length + ((non_ascii_pos != length) ? 1u : 0u);
+      EXPECT_EQ(expected_chars, CountModifiedUtf8Chars(input.c_str(), input.size()));
+
+      uint32_t expected_hash = StartModifiedUtf8Hash();
+      for (char c : input) {
+        expected_hash = expected_hash * 31u + static_cast<uint8_t>(c);
+      }
+      EXPECT_EQ(expected_hash, ComputeModifiedUtf8Hash(input.c_str()));
+      EXPECT_EQ(expected_hash, ComputeModifiedUtf8Hash(std::string_view(input)));
+    }
+  }
+}
+
 TEST_F(UtfTest, NonAscii) {
   const char kNonAsciiCharacter = '\x80';
   const char input[] = { kNonAsciiCharacter, '\0' };
@@ -253,29 +253,33 @@ void* OpenNativeLibrary(JNIEnv* env, int32_t target_sdk_version, const char* pat
     return handle;
   }
 
-  std::lock_guard<std::mutex> guard(g_namespaces_mutex);
   NativeLoaderNamespace* ns;
-
-  if ((ns = g_namespaces->FindNamespaceByClassLoader(env, class_loader)) == nullptr) {
-    // This is the case where the classloader was not created by ApplicationLoaders
-    // In this case we create an isolated not-shared namespace for it.
-    Result<NativeLoaderNamespace*> isolated_ns =
-        CreateClassLoaderNamespaceLocked(env,
-                                         target_sdk_version,
-                                         class_loader,
-                                         /*is_shared=*/false,
-                                         /*dex_path=*/nullptr,
-                                         library_path,
-                                         /*permitted_path=*/nullptr,
-                                         /*uses_library_list=*/nullptr);
-    if (!isolated_ns.ok()) {
-      *error_msg = strdup(isolated_ns.error().message().c_str());
-      return nullptr;
-    } else {
-      ns = *isolated_ns;
+  {
+    std::lock_guard<std::mutex> guard(g_namespaces_mutex);
+    if ((ns = g_namespaces->FindNamespaceByClassLoader(env, class_loader)) == nullptr) {
+      // This is the case where the classloader was not created by ApplicationLoaders
+      // In this case we create an isolated not-shared namespace for it.
+      Result<NativeLoaderNamespace*> isolated_ns =
+          CreateClassLoaderNamespaceLocked(env,
+                                           target_sdk_version,
+                                           class_loader,
+                                           /*is_shared=*/false,
+                                           /*dex_path=*/nullptr,
+                                           library_path,
+                                           /*permitted_path=*/nullptr,
+                                           /*uses_library_list=*/nullptr);
+      if (!isolated_ns.ok()) {
+        *error_msg = strdup(isolated_ns.error().message().c_str());
+        return nullptr;
+      } else {
+        ns = *isolated_ns;
+      }
     }
   }
 
+  // Namespaces are only removed by ResetNativeLoader(), so `ns` stays valid without the lock.
+  // Loading the library runs its constructors, which must not block other threads looking up or
+  // creating namespaces.
   return OpenNativeLibraryInNamespace(ns, path, needs_native_bridge, error_msg);
 #else
   UNUSED(env, target_sdk_version, class_loader, caller_location);
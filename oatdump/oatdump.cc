@@ -17,12 +17,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -343,6 +346,7 @@ class OatDumperOptions {
                    bool list_methods,
                    bool dump_header_only,
                    const char* export_dex_location,
+                   const char* export_method_stats_location,
                    const char* app_image,
                    const char* app_oat,
                    uint32_t addr2instr)
@@ -356,6 +360,7 @@ class OatDumperOptions {
       list_methods_(list_methods),
       dump_header_only_(dump_header_only),
       export_dex_location_(export_dex_location),
+      export_method_stats_location_(export_method_stats_location),
       app_image_(app_image),
       app_oat_(app_oat),
       addr2instr_(addr2instr),
@@ -371,6 +376,7 @@ class OatDumperOptions {
   const bool list_methods_;
   const bool dump_header_only_;
   const char* const export_dex_location_;
+  const char* const export_method_stats_location_;
   const char* const app_image_;
   const char* const app_oat_;
   uint32_t addr2instr_;
@@ -692,6 +698,12 @@ class OatDumper {
       }
     }
 
+    if (options_.export_method_stats_location_ != nullptr) {
+      if (!ExportMethodStats(os)) {
+        success = false;
+      }
+    }
+
     {
       os << "OAT FILE STATS:\n";
       VariableIndentationOutputStream vios(&os);
@@ -938,6 +950,130 @@ class OatDumper {
     return success;
   }
 
+  // Writes one CSV row per compiled method to `options_.export_method_stats_location_`, with the
+  // code size and the size of each CodeInfo table. The dex files are processed in parallel and the
+  // rows are written in dex file order, so the output is the same for every run.
+  bool ExportMethodStats(std::ostream& os) {
+    std::string error_msg;
+    std::vector<const DexFile*> dex_files;
+    for (const OatDexFile* oat_dex_file : oat_dex_files_) {
+      const DexFile* dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        os << "Failed to open dex file '" << oat_dex_file->GetDexFileLocation() << "': "
+           << error_msg << "\n";
+        return false;
+      }
+      dex_files.push_back(dex_file);
+    }
+
+    std::vector<std::string> rows(dex_files.size());
+    std::atomic<size_t> next_dex_file(0u);
+    auto worker = [&]() {
+      for (size_t i = next_dex_file.fetch_add(1u, std::memory_order_relaxed);
+           i < dex_files.size();
+           i = next_dex_file.fetch_add(1u, std::memory_order_relaxed)) {
+        std::ostringstream oss;
+        CollectMethodStats(oss, *oat_dex_files_[i], *dex_files[i]);
+        rows[i] = oss.str();
+      }
+    };
+    size_t num_threads =
+        std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), dex_files.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    std::ofstream out(options_.export_method_stats_location_);
+    out << "dex_file,method,code_offset,code_size,code_info_bytes,stack_maps,inlined_frames";
+    for (const char* table_name : kCodeInfoTableNames) {
+      out << "," << table_name << "_bits";
+    }
+    out << "\n";
+    for (const std::string& dex_file_rows : rows) {
+      out << dex_file_rows;
+    }
+    out.close();
+    if (out.fail()) {
+      os << "Failed to write method stats to " << options_.export_method_stats_location_ << "\n";
+      return false;
+    }
+    os << "METHOD STATS EXPORTED TO:\n" << options_.export_method_stats_location_ << "\n\n";
+    return true;
+  }
+
+  // Names of the CodeInfo bit tables, in the order of the `--export-method-stats` columns.
+  static constexpr const char* kCodeInfoTableNames[] = {
+      "StackMap",
+      "RegisterMask",
+      "StackMask",
+      "InlineInfo",
+      "MethodInfo",
+      "DexRegisterMask",
+      "DexRegisterMapInfo",
+      "DexRegisterInfo",
+  };
+
+  // Called from worker threads, so this must only read the oat and dex files.
+  void CollectMethodStats(std::ostream& os,
+                          const OatDexFile& oat_dex_file,
+                          const DexFile& dex_file) const {
+    const std::string location = oat_dex_file.GetDexFileLocation();
+    for (ClassAccessor class_accessor : dex_file.GetClasses()) {
+      const char* descriptor = class_accessor.GetDescriptor();
+      if (DescriptorToDot(descriptor).find(options_.class_filter_) == std::string::npos) {
+        continue;
+      }
+      const OatFile::OatClass oat_class =
+          oat_dex_file.GetOatClass(class_accessor.GetClassDefIndex());
+      uint32_t class_method_index = 0;
+      for (const ClassAccessor::Method& method : class_accessor.GetMethods()) {
+        const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index++);
+        uint32_t code_size = oat_method.GetQuickCodeSize();
+        if (code_size == 0u) {
+          continue;
+        }
+        uint32_t dex_method_idx = method.GetIndex();
+        std::string method_name = dex_file.GetMethodName(dex_file.GetMethodId(dex_method_idx));
+        if (method_name.find(options_.method_filter_) == std::string::npos) {
+          continue;
+        }
+
+        Stats code_info_stats;
+        size_t num_stack_maps = 0u;
+        size_t num_inlined_frames = 0u;
+        CodeItemDataAccessor code_item_accessor(dex_file, method.GetCodeItem());
+        if (IsMethodGeneratedByOptimizingCompiler(oat_method, code_item_accessor)) {
+          CodeInfo::CollectSizeStats(oat_method.GetVmapTable(), code_info_stats);
+          CodeInfo code_info(oat_method.GetVmapTable());
+          for (const StackMap& stack_map : code_info.GetStackMaps()) {
+            ++num_stack_maps;
+            num_inlined_frames += code_info.GetInlineInfosOf(stack_map).size();
+          }
+        }
+
+        os << "\"" << location << "\",\"" << dex_file.PrettyMethod(dex_method_idx, true) << "\""
+           << StringPrintf(",0x%08x,%u,", oat_method.GetCodeOffset(), code_size)
+           << static_cast<size_t>(code_info_stats.Value()) << "," << num_stack_maps << ","
+           << num_inlined_frames;
+        for (const char* table_name : kCodeInfoTableNames) {
+          double table_bytes = 0.0;
+          for (const auto& it : code_info_stats.Children()) {
+            if (strcmp(it.first, table_name) == 0) {
+              table_bytes = it.second.Value();
+            }
+          }
+          os << "," << static_cast<size_t>(table_bytes * kBitsPerByte);
+        }
+        os << "\n";
+      }
+    }
+  }
+
   // Backwards compatible Dex file export. If dex_file is nullptr (valid Vdex file not present) the
   // Dex resource is extracted from the oat_dex_file and its checksum is repaired since it's not
   // unquickened. Otherwise the dex_file has been fully unquickened and is expected to verify the
@@ -3159,6 +3295,8 @@ struct OatdumpArgs : public CmdlineArgs {
       list_methods_ = true;
     } else if (StartsWith(option, "--export-dex-to=")) {
       export_dex_location_ = raw_option + strlen("--export-dex-to=");
+    } else if (StartsWith(option, "--export-method-stats=")) {
+      export_method_stats_location_ = raw_option + strlen("--export-method-stats=");
     } else if (StartsWith(option, "--addr2instr=")) {
       if (!android::base::ParseUint(raw_option + strlen("--addr2instr="), &addr2instr_)) {
         *error_msg = "Address conversion failed";
@@ -3265,6 +3403,11 @@ struct OatdumpArgs : public CmdlineArgs {
         "  --export-dex-to=<directory>: may be used to export oat embedded dex files.\n"
         "      Example: --export-dex-to=/data/local/tmp\n"
         "\n"
+        "  --export-method-stats=<file.csv>: write the code size, CodeInfo table sizes and\n"
+        "      number of inlined frames of each compiled method to a CSV file. Can be used\n"
+        "      with filters, and with --header-only to skip the text dump of the methods.\n"
+        "      Example: --export-method-stats=/data/local/tmp/boot_methods.csv\n"
+        "\n"
         "  --addr2instr=<address>: output matching method disassembled code from relative\n"
         "                          address (e.g. PC from crash dump)\n"
         "      Example: --addr2instr=0x00001a3b\n"
@@ -3302,6 +3445,7 @@ struct OatdumpArgs : public CmdlineArgs {
   bool imt_stat_dump_ = false;
   uint32_t addr2instr_ = 0;
   const char* export_dex_location_ = nullptr;
+  const char* export_method_stats_location_ = nullptr;
   const char* app_image_ = nullptr;
   const char* app_oat_ = nullptr;
 };
@@ -3324,6 +3468,7 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
         args_->list_methods_,
         args_->dump_header_only_,
         args_->export_dex_location_,
+        args_->export_method_stats_location_,
         args_->app_image_,
         args_->app_oat_,
         args_->addr2instr_));
@@ -109,4 +109,42 @@ TEST_F(OatDumpTest, TestExportDexStatic) {
   ASSERT_TRUE(Exec(Flavor::kStatic, kModeOat, {"--export-dex-to=" + tmp_dir_}, kListOnly));
 }
 
+TEST_F(OatDumpTest, TestExportMethodStats) {
+  ASSERT_TRUE(GenerateAppOdexFile(Flavor::kDynamic, {"--runtime-arg", "-Xmx64M"}));
+  const std::string stats_location = tmp_dir_ + "/method_stats.csv";
+  ASSERT_TRUE(Exec(Flavor::kDynamic,
+                   kModeOat,
+                   {"--export-method-stats=" + stats_location, "--header-only"},
+                   kListOnly));
+  std::string stats;
+  ASSERT_TRUE(android::base::ReadFileToString(stats_location, &stats));
+  std::vector<std::string> lines = android::base::Split(stats, "\n");
+  ASSERT_FALSE(lines.empty());
+  EXPECT_TRUE(android::base::StartsWith(lines[0], "dex_file,method,code_offset,code_size,"));
+  const size_t num_columns = android::base::Split(lines[0], ",").size();
+
+  // The dex file and method columns are quoted, since method signatures contain commas.
+  auto count_columns = [](const std::string& line) {
+    size_t columns = 1u;
+    bool in_quotes = false;
+    for (char c : line) {
+      if (c == '"') {
+        in_quotes = !in_quotes;
+      } else if (c == ',' && !in_quotes) {
+        ++columns;
+      }
+    }
+    return columns;
+  };
+  size_t num_rows = 0u;
+  for (size_t i = 1; i != lines.size(); ++i) {
+    if (lines[i].empty()) {
+      continue;
+    }
+    EXPECT_EQ(num_columns, count_columns(lines[i])) << lines[i];
+    ++num_rows;
+  }
+  EXPECT_NE(0u, num_rows);
+}
+
 }  // namespace art
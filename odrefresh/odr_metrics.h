@@ -180,7 +180,9 @@ class OdrMetrics final {
 
   BcpCompilationType secondary_bcp_compilation_type_ = BcpCompilationType::kUnknown;
 
-  // The total time spent on compiling system server.
+  // The total time spent on compiling system server. This is the sum of the times of the dex2oat
+  // invocations, which may exceed the wall time when they run in parallel. The time of each
+  // invocation is not recorded.
   int32_t system_server_compilation_millis_ = 0;
 
   // The result of the last dex2oat invocation for compiling system server, or `std::nullopt` if
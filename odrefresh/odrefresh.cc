@@ -28,6 +28,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
@@ -40,6 +41,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -47,6 +49,7 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -109,6 +112,7 @@ using ::android::base::Join;
 using ::android::base::ParseBool;
 using ::android::base::ParseBoolResult;
 using ::android::base::ParseInt;
+using ::android::base::ParseUint;
 using ::android::base::Result;
 using ::android::base::SetProperty;
 using ::android::base::Split;
@@ -128,6 +132,10 @@ constexpr time_t kMaximumExecutionSeconds = 480;
 // Maximum execution time for any child process spawned.
 constexpr time_t kMaxChildProcessSeconds = 120;
 
+// Maximum number of system server jars compiled at the same time. Each dex2oat invocation runs
+// multiple threads already, this only overlaps their serial phases.
+constexpr size_t kMaxParallelSystemServerCompilations = 2;
+
 constexpr mode_t kFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
 
 constexpr const char* kFirstBootImageBasename = "boot.art";
@@ -140,6 +148,33 @@ constexpr const char* kPrimaryCompilerFilter = "speed-profile";
 // jars, so we always use "verify".
 constexpr const char* kMainlineCompilerFilter = "verify";
 
+// Opens a file for reading. The FD is close-on-exec, so that it is not leaked into dex2oat
+// invocations that run concurrently. See `RunDex2oat` for how the FDs get passed to dex2oat.
+File* OpenFileForReadingCloexec(const std::string& path) {
+  return OS::OpenFileWithFlags(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+// Same as `OS::CreateEmptyFile`, but the FD is close-on-exec.
+File* CreateEmptyFileCloexec(const std::string& path) {
+  // In case the file exists, unlink it so we get a new file.
+  unlink(path.c_str());
+  return OS::OpenFileWithFlags(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC);
+}
+
+Result<void> SetCloseOnExec(const std::vector<std::unique_ptr<File>>& files, bool close_on_exec) {
+  for (const std::unique_ptr<File>& file : files) {
+    int flags = fcntl(file->Fd(), F_GETFD);
+    if (flags == -1) {
+      return ErrnoErrorf("Failed to get FD flags of '{}'", file->GetPath());
+    }
+    flags = close_on_exec ? (flags | FD_CLOEXEC) : (flags & ~FD_CLOEXEC);
+    if (fcntl(file->Fd(), F_SETFD, flags) == -1) {
+      return ErrnoErrorf("Failed to set FD flags of '{}'", file->GetPath());
+    }
+  }
+  return {};
+}
+
 void EraseFiles(const std::vector<std::unique_ptr<File>>& files) {
   for (auto& file : files) {
     file->Erase(/*unlink=*/true);
@@ -410,20 +445,14 @@ bool IsCpuSetSpecValid(const std::string& cpu_set) {
   return true;
 }
 
+// Adds the thread count and the CPU set for one of `num_jobs` dex2oat invocations that run at the
+// same time. The budget given by the system properties is split between the invocations, with
+// `job_index` selecting the share of this one, so that they don't oversubscribe the CPUs.
 Result<void> AddDex2OatConcurrencyArguments(/*inout*/ std::vector<std::string>& args,
-                                            bool is_compilation_os) {
-  std::string threads;
-  if (is_compilation_os) {
-    threads = GetProperty("dalvik.vm.background-dex2oat-threads", "");
-    if (threads.empty()) {
-      threads = GetProperty("dalvik.vm.dex2oat-threads", "");
-    }
-  } else {
-    threads = GetProperty("dalvik.vm.boot-dex2oat-threads", "");
-  }
-  if (!threads.empty()) {
-    args.push_back("-j" + threads);
-  }
+                                            bool is_compilation_os,
+                                            size_t job_index,
+                                            size_t num_jobs) {
+  DCHECK_LT(job_index, num_jobs);
 
   std::string cpu_set;
   if (is_compilation_os) {
@@ -434,10 +463,53 @@ Result<void> AddDex2OatConcurrencyArguments(/*inout*/ std::vector<std::string>&
   } else {
     cpu_set = GetProperty("dalvik.vm.boot-dex2oat-cpu-set", "");
   }
+  size_t num_cpus = std::thread::hardware_concurrency();
   if (!cpu_set.empty()) {
     if (!IsCpuSetSpecValid(cpu_set)) {
       return Errorf("Invalid CPU set spec '{}'", cpu_set);
     }
+    std::vector<std::string> cpus = Split(cpu_set, ",");
+    if (num_jobs > 1) {
+      if (cpus.size() >= num_jobs) {
+        // Give each job a contiguous, disjoint slice of the CPU set.
+        size_t begin = job_index * cpus.size() / num_jobs;
+        size_t end = (job_index + 1) * cpus.size() / num_jobs;
+        cpus = std::vector<std::string>(cpus.begin() + begin, cpus.begin() + end);
+      } else {
+        cpus = {cpus[job_index % cpus.size()]};
+      }
+      cpu_set = Join(cpus, ',');
+    }
+    num_cpus = cpus.size();
+  }
+
+  std::string threads;
+  if (is_compilation_os) {
+    threads = GetProperty("dalvik.vm.background-dex2oat-threads", "");
+    if (threads.empty()) {
+      threads = GetProperty("dalvik.vm.dex2oat-threads", "");
+    }
+  } else {
+    threads = GetProperty("dalvik.vm.boot-dex2oat-threads", "");
+  }
+  if (num_jobs > 1) {
+    if (!threads.empty()) {
+      unsigned int num_threads;
+      if (!ParseUint(threads, &num_threads)) {
+        return Errorf("Invalid dex2oat thread count '{}'", threads);
+      }
+      threads = std::to_string(std::max(num_threads / num_jobs, size_t{1}));
+    } else if (num_cpus > 0) {
+      // Without an explicit thread count, dex2oat runs one thread per CPU of the device, regardless
+      // of the CPU set. Limit it to the share of this job.
+      threads = std::to_string(cpu_set.empty() ? std::max(num_cpus / num_jobs, size_t{1}) :
+                                                 num_cpus);
+    }
+  }
+  if (!threads.empty()) {
+    args.push_back("-j" + threads);
+  }
+  if (!cpu_set.empty()) {
     args.push_back("--cpu-set=" + cpu_set);
   }
 
@@ -461,7 +533,7 @@ bool AddDex2OatProfile(
     const std::vector<std::string>& profile_paths) {
   bool has_any_profile = false;
   for (auto& path : profile_paths) {
-    std::unique_ptr<File> profile_file(OS::OpenFileForReading(path.c_str()));
+    std::unique_ptr<File> profile_file(OpenFileForReadingCloexec(path));
     if (profile_file && profile_file->IsOpened()) {
       args.emplace_back(StringPrintf("--profile-file-fd=%d", profile_file->Fd()));
       output_files.emplace_back(std::move(profile_file));
@@ -483,7 +555,7 @@ Result<void> AddBootClasspathFds(/*inout*/ std::vector<std::string>& args,
       bcp_fds.emplace_back("-1");
     } else {
       std::string actual_path = RewriteParentDirectoryIfNeeded(jar);
-      std::unique_ptr<File> jar_file(OS::OpenFileForReading(actual_path.c_str()));
+      std::unique_ptr<File> jar_file(OpenFileForReadingCloexec(actual_path));
       if (!jar_file || !jar_file->IsValid()) {
         return Errorf("Failed to open a BCP jar '{}'", actual_path);
       }
@@ -499,7 +571,7 @@ Result<void> AddBootClasspathFds(/*inout*/ std::vector<std::string>& args,
 Result<void> AddCacheInfoFd(/*inout*/ std::vector<std::string>& args,
                             /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii,
                             const std::string& cache_info_filename) {
-  std::unique_ptr<File> cache_info_file(OS::OpenFileForReading(cache_info_filename.c_str()));
+  std::unique_ptr<File> cache_info_file(OpenFileForReadingCloexec(cache_info_filename));
   if (cache_info_file == nullptr) {
     return ErrnoErrorf("Failed to open a cache info file '{}'", cache_info_file);
   }
@@ -543,7 +615,7 @@ void AddCompiledBootClasspathFdsIfAny(
     CHECK(!artifact_dir.empty());
     std::string image_path = artifact_dir + "/" + basename;
     image_path = GetSystemImageFilename(image_path.c_str(), isa);
-    std::unique_ptr<File> image_file(OS::OpenFileForReading(image_path.c_str()));
+    std::unique_ptr<File> image_file(OpenFileForReadingCloexec(image_path));
     if (image_file && image_file->IsValid()) {
       bcp_image_fds.push_back(std::to_string(image_file->Fd()));
       opened_files.push_back(std::move(image_file));
@@ -553,7 +625,7 @@ void AddCompiledBootClasspathFdsIfAny(
     }
 
     std::string oat_path = ReplaceFileExtension(image_path, "oat");
-    std::unique_ptr<File> oat_file(OS::OpenFileForReading(oat_path.c_str()));
+    std::unique_ptr<File> oat_file(OpenFileForReadingCloexec(oat_path));
     if (oat_file && oat_file->IsValid()) {
       bcp_oat_fds.push_back(std::to_string(oat_file->Fd()));
       opened_files.push_back(std::move(oat_file));
@@ -563,7 +635,7 @@ void AddCompiledBootClasspathFdsIfAny(
     }
 
     std::string vdex_path = ReplaceFileExtension(image_path, "vdex");
-    std::unique_ptr<File> vdex_file(OS::OpenFileForReading(vdex_path.c_str()));
+    std::unique_ptr<File> vdex_file(OpenFileForReadingCloexec(vdex_path));
     if (vdex_file && vdex_file->IsValid()) {
       bcp_vdex_fds.push_back(std::to_string(vdex_file->Fd()));
       opened_files.push_back(std::move(vdex_file));
@@ -1654,14 +1726,17 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
     const std::vector<std::string>& input_boot_images,
     const OdrArtifacts& artifacts,
     const std::vector<std::string>& extra_args,
-    /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii) const {
+    /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii,
+    size_t job_index,
+    size_t num_jobs) const {
   std::vector<std::string> args;
   args.push_back(config_.GetDex2Oat());
 
   AddDex2OatCommonOptions(args);
   AddDex2OatDebugInfo(args);
   AddDex2OatInstructionSet(args, isa);
-  Result<void> result = AddDex2OatConcurrencyArguments(args, config_.GetCompilationOsMode());
+  Result<void> result =
+      AddDex2OatConcurrencyArguments(args, config_.GetCompilationOsMode(), job_index, num_jobs);
   if (!result.ok()) {
     return CompilationResult::Error(OdrMetrics::Status::kUnknown, result.error().message());
   }
@@ -1675,7 +1750,7 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
   for (const std::string& dex_file : dex_files) {
     std::string actual_path = RewriteParentDirectoryIfNeeded(dex_file);
     args.emplace_back("--dex-file=" + dex_file);
-    std::unique_ptr<File> file(OS::OpenFileForReading(actual_path.c_str()));
+    std::unique_ptr<File> file(OpenFileForReadingCloexec(actual_path));
     args.emplace_back(StringPrintf("--dex-fd=%d", file->Fd()));
     readonly_files_raii.push_back(std::move(file));
   }
@@ -1701,7 +1776,7 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
   std::vector<std::unique_ptr<File>> staging_files;
   for (const auto& [location, kind] : location_kind_pairs) {
     std::string staging_location = GetStagingLocation(staging_dir, location);
-    std::unique_ptr<File> staging_file(OS::CreateEmptyFile(staging_location.c_str()));
+    std::unique_ptr<File> staging_file(CreateEmptyFileCloexec(staging_location));
     if (staging_file == nullptr) {
       return CompilationResult::Error(
           OdrMetrics::Status::kIoError,
@@ -1732,8 +1807,38 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
     return CompilationResult::Ok();
   }
 
+  // All FDs are opened with O_CLOEXEC, so that a dex2oat invocation running concurrently on
+  // another thread does not inherit them. Only the FDs of this invocation are made inheritable,
+  // and only until the child is forked. Concurrent forks are serialized so that they never see
+  // each other's inheritable FDs.
+  std::unique_lock<std::mutex> fork_lock(dex2oat_fork_lock_);
+  auto restore_close_on_exec = [&]() {
+    Result<void> restore_result = SetCloseOnExec(readonly_files_raii, /*close_on_exec=*/true);
+    if (restore_result.ok()) {
+      restore_result = SetCloseOnExec(staging_files, /*close_on_exec=*/true);
+    }
+    if (!restore_result.ok()) {
+      LOG(WARNING) << restore_result.error();
+    }
+    fork_lock.unlock();
+  };
+  result = SetCloseOnExec(readonly_files_raii, /*close_on_exec=*/false);
+  if (result.ok()) {
+    result = SetCloseOnExec(staging_files, /*close_on_exec=*/false);
+  }
+  if (!result.ok()) {
+    restore_close_on_exec();
+    return CompilationResult::Error(OdrMetrics::Status::kIoError, result.error().message());
+  }
+
   std::string error_msg;
-  ExecResult dex2oat_result = exec_utils_->ExecAndReturnResult(args, timeout, &error_msg);
+  ExecCallbacks callbacks{.on_start = [&](pid_t) { restore_close_on_exec(); }};
+  ExecResult dex2oat_result = exec_utils_->ExecAndReturnResult(
+      args, timeout, callbacks, /*stat=*/nullptr, &error_msg);
+  if (fork_lock.owns_lock()) {
+    // The child was never started.
+    restore_close_on_exec();
+  }
 
   if (dex2oat_result.exit_code != 0) {
     return CompilationResult::Dex2oatError(
@@ -1786,7 +1891,7 @@ OnDeviceRefresh::RunDex2oatForBootClasspath(const std::string& staging_dir,
 
     std::string dirty_image_objects_file(GetAndroidRoot() + "/etc/dirty-image-objects");
     if (OS::FileExists(dirty_image_objects_file.c_str())) {
-      std::unique_ptr<File> file(OS::OpenFileForReading(dirty_image_objects_file.c_str()));
+      std::unique_ptr<File> file(OpenFileForReadingCloexec(dirty_image_objects_file));
       args.emplace_back(StringPrintf("--dirty-image-objects-fd=%d", file->Fd()));
       readonly_files_raii.push_back(std::move(file));
     } else {
@@ -1795,7 +1900,7 @@ OnDeviceRefresh::RunDex2oatForBootClasspath(const std::string& staging_dir,
 
     std::string preloaded_classes_file(GetAndroidRoot() + "/etc/preloaded-classes");
     if (OS::FileExists(preloaded_classes_file.c_str())) {
-      std::unique_ptr<File> file(OS::OpenFileForReading(preloaded_classes_file.c_str()));
+      std::unique_ptr<File> file(OpenFileForReadingCloexec(preloaded_classes_file));
       args.emplace_back(StringPrintf("--preloaded-classes-fds=%d", file->Fd()));
       readonly_files_raii.push_back(std::move(file));
     } else {
@@ -1815,7 +1920,9 @@ OnDeviceRefresh::RunDex2oatForBootClasspath(const std::string& staging_dir,
       input_boot_images,
       OdrArtifacts::ForBootImage(output_path),
       args,
-      readonly_files_raii);
+      readonly_files_raii,
+      /*job_index=*/0,
+      /*num_jobs=*/1);
 }
 
 WARN_UNUSED CompilationResult
@@ -1917,7 +2024,9 @@ OnDeviceRefresh::CompileBootClasspath(const std::string& staging_dir,
 WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
     const std::string& staging_dir,
     const std::string& dex_file,
-    const std::vector<std::string>& classloader_context) const {
+    const std::vector<std::string>& classloader_context,
+    size_t job_index,
+    size_t num_jobs) const {
   std::vector<std::string> args;
   std::vector<std::unique_ptr<File>> readonly_files_raii;
   InstructionSet isa = config_.GetSystemServerIsa();
@@ -1947,7 +2056,7 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
     std::vector<int> fds;
     for (const std::string& path : classloader_context) {
       std::string actual_path = RewriteParentDirectoryIfNeeded(path);
-      std::unique_ptr<File> file(OS::OpenFileForReading(actual_path.c_str()));
+      std::unique_ptr<File> file(OpenFileForReadingCloexec(actual_path));
       if (!file->IsValid()) {
         return CompilationResult::Error(
             OdrMetrics::Status::kIoError,
@@ -1967,7 +2076,9 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
                     GetBestBootImages(isa, /*include_mainline_extension=*/true),
                     OdrArtifacts::ForSystemServer(output_path),
                     args,
-                    readonly_files_raii);
+                    readonly_files_raii,
+                    job_index,
+                    num_jobs);
 }
 
 WARN_UNUSED CompilationResult
@@ -1984,17 +2095,12 @@ OnDeviceRefresh::CompileSystemServer(const std::string& staging_dir,
     return CompilationResult::Error(OdrMetrics::Status::kNoSpace, "Insufficient space");
   }
 
+  // The class loader context of a jar only refers to the dex files of the jars before it, not to
+  // their compilation artifacts, so the jars can be compiled independently of each other.
+  std::vector<std::pair<std::string, std::vector<std::string>>> jobs;
   for (const std::string& jar : all_systemserver_jars_) {
     if (ContainsElement(system_server_jars_to_compile, jar)) {
-      CompilationResult current_result =
-          RunDex2oatForSystemServer(staging_dir, jar, classloader_context);
-      result.Merge(current_result);
-
-      if (current_result.IsOk()) {
-        on_dex2oat_success();
-      } else {
-        LOG(ERROR) << "Compilation of {} failed: {}"_format(Basename(jar), result.error_msg);
-      }
+      jobs.emplace_back(jar, classloader_context);
     }
 
     if (ContainsElement(systemserver_classpath_jars_, jar)) {
@@ -2002,6 +2108,48 @@ OnDeviceRefresh::CompileSystemServer(const std::string& staging_dir,
     }
   }
 
+  std::vector<std::optional<CompilationResult>> job_results(jobs.size());
+  std::atomic<size_t> next_job(0u);
+  std::mutex on_dex2oat_success_lock;
+  size_t num_threads = std::min(jobs.size(), kMaxParallelSystemServerCompilations);
+  // `thread_index` selects the share of the dex2oat thread and CPU budget that the jobs run by this
+  // thread get.
+  auto run_jobs = [&](size_t thread_index) {
+    while (true) {
+      size_t i = next_job.fetch_add(1u, std::memory_order_relaxed);
+      if (i >= jobs.size()) {
+        break;
+      }
+      const auto& [jar, context] = jobs[i];
+      job_results[i] =
+          RunDex2oatForSystemServer(staging_dir, jar, context, thread_index, num_threads);
+      // The metrics only record the total time of the stage, so log the time of each job.
+      LOG(INFO) << "Compiling {} took {}ms"_format(Basename(jar), job_results[i]->elapsed_time_ms);
+      if (job_results[i]->IsOk()) {
+        std::lock_guard<std::mutex> lock(on_dex2oat_success_lock);
+        on_dex2oat_success();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(run_jobs, i);
+  }
+  run_jobs(/*thread_index=*/0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Merge the results in the order of the jars, so that the first failure is reported.
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    CompilationResult& current_result = *job_results[i];
+    result.Merge(current_result);
+    if (!current_result.IsOk()) {
+      LOG(ERROR) << "Compilation of {} failed: {}"_format(Basename(jobs[i].first),
+                                                          current_result.error_msg);
+    }
+  }
+
   return result;
 }
 
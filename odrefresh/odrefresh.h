@@ -20,6 +20,7 @@
 #include <ctime>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -332,7 +333,9 @@ class OnDeviceRefresh final {
              const std::vector<std::string>& input_boot_images,
              const OdrArtifacts& artifacts,
              const std::vector<std::string>& extra_args,
-             /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii) const;
+             /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii,
+             size_t job_index,
+             size_t num_jobs) const;
 
   WARN_UNUSED CompilationResult
   RunDex2oatForBootClasspath(const std::string& staging_dir,
@@ -352,7 +355,9 @@ class OnDeviceRefresh final {
   WARN_UNUSED CompilationResult
   RunDex2oatForSystemServer(const std::string& staging_dir,
                             const std::string& dex_file,
-                            const std::vector<std::string>& classloader_context) const;
+                            const std::vector<std::string>& classloader_context,
+                            size_t job_index,
+                            size_t num_jobs) const;
 
   WARN_UNUSED CompilationResult
   CompileSystemServer(const std::string& staging_dir,
@@ -384,6 +389,9 @@ class OnDeviceRefresh final {
 
   std::unique_ptr<ExecUtils> exec_utils_;
 
+  // Serializes the forks of concurrent dex2oat invocations. See `RunDex2oat`.
+  mutable std::mutex dex2oat_fork_lock_;
+
   DISALLOW_COPY_AND_ASSIGN(OnDeviceRefresh);
 };
 
@@ -16,6 +16,7 @@
 
 #include "odrefresh.h"
 
+#include <fcntl.h>
 #include <unistd.h>
 
 #include <functional>
@@ -26,6 +27,7 @@
 
 #include "android-base/file.h"
 #include "android-base/parseint.h"
+#include "android-base/properties.h"
 #include "android-base/scopeguard.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
@@ -52,6 +54,7 @@ using ::android::base::Split;
 using ::android::modules::sdklevel::IsAtLeastU;
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::AnyOf;
 using ::testing::Contains;
 using ::testing::ElementsAre;
 using ::testing::Not;
@@ -84,6 +87,19 @@ class MockExecUtils : public ExecUtils {
     return {.status = ExecResult::kExited, .exit_code = DoExecAndReturnCode(arg_vector)};
   }
 
+  ExecResult ExecAndReturnResult(const std::vector<std::string>& arg_vector,
+                                 int,
+                                 const ExecCallbacks& callbacks,
+                                 ProcessStat*,
+                                 std::string*) const override {
+    // The arguments are matched before `on_start`, which is where the child would already have
+    // inherited the FDs.
+    int exit_code = DoExecAndReturnCode(arg_vector);
+    callbacks.on_start(0);
+    callbacks.on_end(0);
+    return {.status = ExecResult::kExited, .exit_code = exit_code};
+  }
+
   MOCK_METHOD(int, DoExecAndReturnCode, (const std::vector<std::string>& arg_vector), (const));
 };
 
@@ -121,6 +137,16 @@ MATCHER_P(FdOf, matcher, "") {
   return ExplainMatchResult(matcher, path_str, result_listener);
 }
 
+// Matches an FD that is inherited by child processes.
+MATCHER(InheritableFd, "") {
+  int fd;
+  if (!android::base::ParseInt(std::string{arg}, &fd)) {
+    return false;
+  }
+  int flags = fcntl(fd, F_GETFD);
+  return flags != -1 && (flags & FD_CLOEXEC) == 0;
+}
+
 void WriteFakeApexInfoList(const std::string& filename) {
   std::string content = R"xml(
 <?xml version="1.0" encoding="utf-8"?>
@@ -499,6 +525,43 @@ TEST_F(OdRefreshTest, PartialSystemServerJars) {
       ExitCode::kCompilationSuccess);
 }
 
+TEST_F(OdRefreshTest, ParallelSystemServerJars) {
+  std::string old_threads = android::base::GetProperty("dalvik.vm.boot-dex2oat-threads", "");
+  std::string old_cpu_set = android::base::GetProperty("dalvik.vm.boot-dex2oat-cpu-set", "");
+  auto restore_properties = android::base::make_scope_guard([&]() {
+    android::base::SetProperty("dalvik.vm.boot-dex2oat-threads", old_threads);
+    android::base::SetProperty("dalvik.vm.boot-dex2oat-cpu-set", old_cpu_set);
+  });
+  android::base::SetProperty("dalvik.vm.boot-dex2oat-threads", "4");
+  android::base::SetProperty("dalvik.vm.boot-dex2oat-cpu-set", "0,1,2,3");
+
+  // The jars are compiled by two concurrent jobs. Each of them gets half of the thread and CPU
+  // budget, and the FDs it receives are inheritable while those of the other job are not.
+  auto job_args = [](const std::string& jar) {
+    return AllOf(Contains(Flag("--dex-file=", jar)),
+                 Contains("-j2"),
+                 Contains(AnyOf("--cpu-set=0,1", "--cpu-set=2,3")),
+                 Contains(Flag("--dex-fd=", AllOf(FdOf(jar), InheritableFd()))),
+                 Contains(Flag("--oat-fd=", InheritableFd())),
+                 Contains(Flag("--cache-info-fd=", InheritableFd())));
+  };
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(job_args(location_provider_jar_)))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(job_args(services_jar_)))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(job_args(services_foo_jar_)))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(job_args(services_bar_jar_)))
+      .WillOnce(Return(0));
+
+  EXPECT_EQ(
+      odrefresh_->Compile(*metrics_,
+                          CompilationOptions{
+                              .system_server_jars_to_compile = odrefresh_->AllSystemServerJars(),
+                          }),
+      ExitCode::kCompilationSuccess);
+}
+
 // Verifies that odrefresh can run properly when the STANDALONE_SYSTEM_SERVER_JARS variable is
 // missing, which is expected on Android S.
 TEST_F(OdRefreshTest, MissingStandaloneSystemServerJars) {
@@ -34,7 +34,9 @@
 
 #include "jvmti_weak_table.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -328,6 +330,11 @@ jvmtiError JvmtiWeakTable<T>::GetTaggedObjects(jvmtiEnv* jvmti_env,
     return ERR(NULL_POINTER);
   }
 
+  // Sort the requested tags, so that each entry of the table can be matched with a binary search
+  // instead of a scan over all the requested tags. Do this before taking the lock.
+  std::vector<T> sorted_tags(tags, tags + tag_count);
+  std::sort(sorted_tags.begin(), sorted_tags.end());
+
   art::Thread* self = art::Thread::Current();
   art::MutexLock mu(self, allow_disallow_lock_);
   Wait(self);
@@ -350,19 +357,8 @@ jvmtiError JvmtiWeakTable<T>::GetTaggedObjects(jvmtiEnv* jvmti_env,
 
   size_t count = 0;
   for (auto& pair : tagged_objects_) {
-    bool select;
-    if (tag_count > 0) {
-      select = false;
-      for (size_t i = 0; i != static_cast<size_t>(tag_count); ++i) {
-        if (tags[i] == pair.second) {
-          select = true;
-          break;
-        }
-      }
-    } else {
-      select = true;
-    }
-
+    bool select = (tag_count == 0) ||
+                  std::binary_search(sorted_tags.begin(), sorted_tags.end(), pair.second);
     if (select) {
       art::ObjPtr<art::mirror::Object> obj = pair.first.template Read<art::kWithReadBarrier>();
       if (obj != nullptr) {
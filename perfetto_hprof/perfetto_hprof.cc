@@ -425,15 +425,19 @@ class ReferredObjectsFinder {
       return;
     }
     art::mirror::Object* ref = obj->GetFieldObject<art::mirror::Object>(offset);
-    art::ArtField* field;
-    if (is_static) {
-      field = art::ArtField::FindStaticFieldWithOffset(obj->AsClass(), offset.Uint32Value());
-    } else {
-      field = art::ArtField::FindInstanceFieldWithOffset(obj->GetClass(), offset.Uint32Value());
-    }
     std::string field_name = "";
-    if (field != nullptr && emit_field_ids_) {
-      field_name = field->PrettyField(/*with_type=*/true);
+    if (emit_field_ids_) {
+      // Only look up the field when its name is needed, the search walks the fields of the class
+      // and its superclasses.
+      art::ArtField* field;
+      if (is_static) {
+        field = art::ArtField::FindStaticFieldWithOffset(obj->AsClass(), offset.Uint32Value());
+      } else {
+        field = art::ArtField::FindInstanceFieldWithOffset(obj->GetClass(), offset.Uint32Value());
+      }
+      if (field != nullptr) {
+        field_name = field->PrettyField(/*with_type=*/true);
+      }
     }
     referred_objects_->emplace_back(std::move(field_name), ref);
   }
@@ -884,17 +888,27 @@ class HeapGraphDumper {
 
   // Returns true if `*obj` has a type that's supposed to be ignored.
   bool IsIgnored(art::mirror::Object* obj) const REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    if (obj->IsClass()) {
+    if (ignored_types_.empty() || obj->IsClass()) {
       return false;
     }
+    // This is called for every object and every reference, so remember the answer per class
+    // instead of building the descriptor each time.
     art::mirror::Class* klass = obj->GetClass();
-    std::string temp;
-    std::string_view name(klass->GetDescriptor(&temp));
-    return std::find(ignored_types_.begin(), ignored_types_.end(), name) != ignored_types_.end();
+    auto it = ignored_classes_.find(klass);
+    if (it == ignored_classes_.end()) {
+      std::string temp;
+      std::string_view name(klass->GetDescriptor(&temp));
+      bool ignored =
+          std::find(ignored_types_.begin(), ignored_types_.end(), name) != ignored_types_.end();
+      it = ignored_classes_.emplace(klass, ignored).first;
+    }
+    return it->second;
   }
 
   // Name of classes whose instances should be ignored.
   const std::vector<std::string> ignored_types_;
+  // Whether instances of a class are ignored, filled in lazily by `IsIgnored()`.
+  mutable std::map<art::mirror::Class*, bool> ignored_classes_;
 
   // Make sure that intern ID 0 (default proto value for a uint64_t) always maps to ""
   // (default proto value for a string) or to 0 (default proto value for a uint64).
@@ -16,6 +16,10 @@
 
 #include "profile_assistant.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 #include "base/os.h"
 #include "base/unix_file/fd_file.h"
 #include "profman/profman_result.h"
@@ -27,6 +31,9 @@ namespace art {
 static constexpr const uint32_t kMinNewMethodsForCompilation = 100;
 static constexpr const uint32_t kMinNewClassesForCompilation = 50;
 
+// Maximum number of current profiles loaded in parallel before merging them.
+static constexpr const size_t kMaxParallelProfileLoads = 8;
+
 ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
     const std::vector<ScopedFlock>& profile_files,
     const ScopedFlock& reference_profile_file,
@@ -49,28 +56,53 @@ ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   uint32_t number_of_methods = info.GetNumberOfMethods();
   uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
 
-  // Merge all current profiles.
-  for (size_t i = 0; i < profile_files.size(); i++) {
-    ProfileCompilationInfo cur_info(options.IsBootImageMerge());
-    if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
-      LOG(WARNING) << "Could not load profile file at index " << i;
-      if (options.IsForceMerge()) {
-        // If we have to merge forcefully, ignore load failures.
-        // This is useful for boot image profiles to ignore stale profiles which are
-        // cleared lazily.
-        continue;
-      }
-      // TODO: Do we really need to use a different error code for version mismatch?
-      ProfileCompilationInfo wrong_info(!options.IsBootImageMerge());
-      if (wrong_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
-        return ProfmanResult::kErrorDifferentVersions;
-      }
-      return ProfmanResult::kErrorBadProfiles;
+  // Merge all current profiles. Decompressing and parsing dominates the time spent on large
+  // numbers of profiles, so load them in batches on several threads. The merging is done in
+  // order, so that the result and the reported errors do not depend on the scheduling.
+  const size_t batch_size = std::clamp<size_t>(std::thread::hardware_concurrency(),
+                                               /*lo=*/ 1u,
+                                               kMaxParallelProfileLoads);
+  for (size_t batch_begin = 0; batch_begin < profile_files.size(); batch_begin += batch_size) {
+    const size_t batch_end = std::min(batch_begin + batch_size, profile_files.size());
+    std::vector<std::unique_ptr<ProfileCompilationInfo>> cur_infos;
+    std::unique_ptr<bool[]> loaded(new bool[batch_end - batch_begin]);
+    for (size_t i = batch_begin; i != batch_end; ++i) {
+      cur_infos.push_back(std::make_unique<ProfileCompilationInfo>(options.IsBootImageMerge()));
+    }
+    auto load = [&](size_t i) {
+      loaded[i - batch_begin] = cur_infos[i - batch_begin]->Load(
+          profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn);
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = batch_begin + 1u; i != batch_end; ++i) {
+      threads.emplace_back(load, i);
     }
+    load(batch_begin);
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t i = batch_begin; i != batch_end; ++i) {
+      if (!loaded[i - batch_begin]) {
+        LOG(WARNING) << "Could not load profile file at index " << i;
+        if (options.IsForceMerge()) {
+          // If we have to merge forcefully, ignore load failures.
+          // This is useful for boot image profiles to ignore stale profiles which are
+          // cleared lazily.
+          continue;
+        }
+        // TODO: Do we really need to use a different error code for version mismatch?
+        ProfileCompilationInfo wrong_info(!options.IsBootImageMerge());
+        if (wrong_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
+          return ProfmanResult::kErrorDifferentVersions;
+        }
+        return ProfmanResult::kErrorBadProfiles;
+      }
 
-    if (!info.MergeWith(cur_info)) {
-      LOG(WARNING) << "Could not merge profile file at index " << i;
-      return ProfmanResult::kErrorBadProfiles;
+      if (!info.MergeWith(*cur_infos[i - batch_begin])) {
+        LOG(WARNING) << "Could not merge profile file at index " << i;
+        return ProfmanResult::kErrorBadProfiles;
+      }
     }
   }
 
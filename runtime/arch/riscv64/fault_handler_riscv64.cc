@@ -18,13 +18,18 @@
 
 #include <sys/ucontext.h>
 
+#include "arch/instruction_set.h"
+#include "art_method.h"
 #include "base/logging.h"  // For VLOG.
+#include "base/macros.h"
 
 extern "C" void art_quick_throw_stack_overflow();
 extern "C" void art_quick_throw_null_pointer_exception_from_signal();
 extern "C" void art_quick_implicit_suspend();
 
-// RISCV64 specific fault handler functions (or stubs if unimplemented yet).
+//
+// RISCV64 specific fault handler functions.
+//
 
 namespace art {
 
@@ -44,9 +49,45 @@ uintptr_t FaultManager::GetFaultSp(void* context) {
   return mc->__gregs[REG_SP];
 }
 
-bool NullPointerHandler::Action(int, siginfo_t*, void*) {
-  LOG(FATAL) << "NullPointerHandler::Action is not implemented for RISC-V";
-  return false;
+// Returns the size of the instruction at `pc`, which is either a 32-bit instruction or
+// a 16-bit compressed instruction from the C extension.
+static size_t GetInstructionSize(uintptr_t pc) {
+  // Instructions are only 2-byte aligned with the C extension, read the first halfword.
+  uint16_t insn16 = *reinterpret_cast<const uint16_t*>(pc);
+  return ((insn16 & 3u) == 3u) ? 4u : 2u;
+}
+
+bool NullPointerHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info, void* context) {
+  uintptr_t fault_address = reinterpret_cast<uintptr_t>(info->si_addr);
+  if (!IsValidFaultAddress(fault_address)) {
+    return false;
+  }
+
+  // For null checks in compiled code we insert a stack map that is immediately
+  // after the load/store instruction that might cause the fault and we need to
+  // pass the return PC to the handler. For null checks in Nterp, we similarly
+  // need the return PC to recognize that this was a null check in Nterp, so
+  // that the handler can get the needed data from the Nterp frame.
+
+  ucontext_t* uc = reinterpret_cast<ucontext_t*>(context);
+  mcontext_t* mc = reinterpret_cast<mcontext_t*>(&uc->uc_mcontext);
+  ArtMethod** sp = reinterpret_cast<ArtMethod**>(mc->__gregs[REG_SP]);
+  uintptr_t pc = mc->__gregs[REG_PC];
+  uintptr_t return_pc = pc + GetInstructionSize(pc);
+  if (!IsValidMethod(*sp) || !IsValidReturnPc(sp, return_pc)) {
+    return false;
+  }
+
+  // Push the return PC to the stack and pass the fault address in RA.
+  mc->__gregs[REG_SP] -= sizeof(uintptr_t);
+  *reinterpret_cast<uintptr_t*>(mc->__gregs[REG_SP]) = return_pc;
+  mc->__gregs[REG_RA] = fault_address;
+
+  // Arrange for the signal handler to return to the NPE entrypoint.
+  mc->__gregs[REG_PC] =
+      reinterpret_cast<uintptr_t>(art_quick_throw_null_pointer_exception_from_signal);
+  VLOG(signals) << "Generating null pointer exception";
+  return true;
 }
 
 bool SuspensionHandler::Action(int, siginfo_t*, void*) {
@@ -54,9 +95,44 @@ bool SuspensionHandler::Action(int, siginfo_t*, void*) {
   return false;
 }
 
-bool StackOverflowHandler::Action(int, siginfo_t*, void*) {
-  LOG(FATAL) << "StackOverflowHandler::Action is not implemented for RISC-V";
-  return false;
+// A stack overflow check is done using the following instruction sequence at method entry,
+// before the frame is set up:
+//      li t6, -STACK_OVERFLOW_RESERVED_BYTES (or an equivalent sequence)
+//      add t6, t6, sp
+//      lw zero, 0(t6)
+// To check for a stack overflow, we compare the fault address with the probed address.
+bool StackOverflowHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info, void* context) {
+  ucontext_t* uc = reinterpret_cast<ucontext_t*>(context);
+  mcontext_t* mc = reinterpret_cast<mcontext_t*>(&uc->uc_mcontext);
+  VLOG(signals) << "stack overflow handler with sp at " << std::hex << &uc;
+  VLOG(signals) << "sigcontext: " << std::hex << mc;
+
+  uintptr_t sp = mc->__gregs[REG_SP];
+  VLOG(signals) << "sp: " << std::hex << sp;
+
+  uintptr_t fault_addr = reinterpret_cast<uintptr_t>(info->si_addr);
+  VLOG(signals) << "fault_addr: " << std::hex << fault_addr;
+  VLOG(signals) << "checking for stack overflow, sp: " << std::hex << sp <<
+      ", fault_addr: " << fault_addr;
+
+  uintptr_t overflow_addr = sp - GetStackOverflowReservedBytes(InstructionSet::kRiscv64);
+
+  // Check that the fault address is the value expected for a stack overflow.
+  if (fault_addr != overflow_addr) {
+    VLOG(signals) << "Not a stack overflow";
+    return false;
+  }
+
+  VLOG(signals) << "Stack overflow found";
+
+  // Now arrange for the signal handler to return to art_quick_throw_stack_overflow.
+  // The value of RA must be the same as it was when we entered the code that
+  // caused this fault.  This will be inserted into a callee save frame by
+  // the function to which this handler returns (art_quick_throw_stack_overflow).
+  mc->__gregs[REG_PC] = reinterpret_cast<uintptr_t>(art_quick_throw_stack_overflow);
+
+  // The kernel will now return to the address in `mc->__gregs[REG_PC]`.
+  return true;
 }
 
 }  // namespace art
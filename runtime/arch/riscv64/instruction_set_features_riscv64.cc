@@ -16,14 +16,22 @@
 
 #include "instruction_set_features_riscv64.h"
 
+#if defined(ART_TARGET_ANDROID) && defined(__riscv)
+#include <sys/auxv.h>
+#endif
+
 #include <fstream>
 #include <sstream>
+#include <string_view>
 
+#include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 #include "base/logging.h"
 
 namespace art {
 
+using android::base::StringPrintf;
+
 // Basic feature set is rv64gc, aka rv64imafdc.
 constexpr uint32_t BasicFeatures() {
   return Riscv64InstructionSetFeatures::kExtGeneric | Riscv64InstructionSetFeatures::kExtCompressed;
@@ -31,6 +39,14 @@ constexpr uint32_t BasicFeatures() {
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromVariant(
     const std::string& variant, std::string* error_msg ATTRIBUTE_UNUSED) {
+  if (variant == "sifive-u74") {
+    return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(
+        BasicFeatures() | kExtZba | kExtZbb, Core::kSiFiveU74));
+  }
+  if (variant == "spacemit-x60") {
+    return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(
+        BasicFeatures() | kExtVector | kExtZba | kExtZbb | kExtZbs, Core::kSpacemitX60));
+  }
   if (variant != "generic") {
     LOG(WARNING) << "Unexpected CPU variant for Riscv64 using defaults: " << variant;
   }
@@ -42,7 +58,20 @@ Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromBitmap(uint32_t bitm
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromCppDefines() {
-  return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(BasicFeatures()));
+  uint32_t bits = BasicFeatures();
+#ifdef __riscv_vector
+  bits |= kExtVector;
+#endif
+#ifdef __riscv_zba
+  bits |= kExtZba;
+#endif
+#ifdef __riscv_zbb
+  bits |= kExtZbb;
+#endif
+#ifdef __riscv_zbs
+  bits |= kExtZbs;
+#endif
+  return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(bits));
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromCpuInfo() {
@@ -51,8 +80,16 @@ Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromCpuInfo() {
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromHwcap() {
-  UNIMPLEMENTED(WARNING);
-  return FromCppDefines();
+  uint32_t bits = BasicFeatures();
+#if defined(ART_TARGET_ANDROID) && defined(__riscv)
+  // The kernel reports single-letter extensions as bits indexed by the letter.
+  uint64_t hwcaps = getauxval(AT_HWCAP);
+  if ((hwcaps & (UINT64_C(1) << ('V' - 'A'))) != 0u) {
+    bits |= kExtVector;
+  }
+  // Multi-letter extensions such as Zba, Zbb and Zbs are not reported in AT_HWCAP.
+#endif
+  return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(bits));
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromAssembly() {
@@ -69,6 +106,7 @@ bool Riscv64InstructionSetFeatures::Equals(const InstructionSetFeatures* other)
   if (InstructionSet::kRiscv64 != other->GetInstructionSet()) {
     return false;
   }
+  // The core does not affect the generated instructions, so it is not compared.
   return bits_ == other->AsRiscv64InstructionSetFeatures()->bits_;
 }
 
@@ -85,15 +123,51 @@ std::string Riscv64InstructionSetFeatures::GetFeatureString() const {
   if (bits_ & kExtVector) {
     result += "v";
   }
+  // Multi-letter extensions follow the single-letter ones, separated by underscores.
+  if (bits_ & kExtZba) {
+    result += "_zba";
+  }
+  if (bits_ & kExtZbb) {
+    result += "_zbb";
+  }
+  if (bits_ & kExtZbs) {
+    result += "_zbs";
+  }
   return result;
 }
 
 std::unique_ptr<const InstructionSetFeatures>
 Riscv64InstructionSetFeatures::AddFeaturesFromSplitString(
-    const std::vector<std::string>& features ATTRIBUTE_UNUSED,
-    std::string* error_msg ATTRIBUTE_UNUSED) const {
-  UNIMPLEMENTED(WARNING);
-  return std::unique_ptr<const InstructionSetFeatures>(new Riscv64InstructionSetFeatures(bits_));
+    const std::vector<std::string>& features, std::string* error_msg) const {
+  uint32_t bits = bits_;
+  for (const std::string& feature : features) {
+    DCHECK_EQ(android::base::Trim(feature), feature)
+        << "Feature name is not trimmed: '" << feature << "'";
+    bool disable = android::base::StartsWith(feature, "-");
+    std::string_view name = disable ? std::string_view(feature).substr(1u) : feature;
+    uint32_t extension;
+    if (name == "c") {
+      extension = kExtCompressed;
+    } else if (name == "v") {
+      extension = kExtVector;
+    } else if (name == "zba") {
+      extension = kExtZba;
+    } else if (name == "zbb") {
+      extension = kExtZbb;
+    } else if (name == "zbs") {
+      extension = kExtZbs;
+    } else {
+      *error_msg = StringPrintf("Unknown instruction set feature: '%s'", feature.c_str());
+      return nullptr;
+    }
+    if (disable) {
+      bits &= ~extension;
+    } else {
+      bits |= extension;
+    }
+  }
+  return std::unique_ptr<const InstructionSetFeatures>(
+      new Riscv64InstructionSetFeatures(bits, core_));
 }
 
 }  // namespace art
@@ -31,7 +31,19 @@ class Riscv64InstructionSetFeatures final : public InstructionSetFeatures {
   enum {
     kExtGeneric = (1 << 0),     // G extension covers the basic set IMAFD
     kExtCompressed = (1 << 1),  // C extension adds compressed instructions
-    kExtVector = (1 << 2)       // V extension adds vector instructions
+    kExtVector = (1 << 2),      // V extension adds vector instructions
+    kExtZba = (1 << 3),         // Zba (address generation) bit-manipulation instructions
+    kExtZbb = (1 << 4),         // Zbb (basic) bit-manipulation instructions
+    kExtZbs = (1 << 5)          // Zbs (single-bit) bit-manipulation instructions
+  };
+
+  // Cores with a known pipeline, selected by the CPU variant. The core only guides
+  // performance heuristics such as instruction scheduling; it does not change which
+  // instructions may be used and is therefore not part of the feature bitmap.
+  enum class Core : uint8_t {
+    kGeneric,      // Unknown core, use balanced heuristics.
+    kSiFiveU74,    // SiFive U74, dual-issue in-order, RV64GC with Zba and Zbb.
+    kSpacemitX60,  // SpacemiT X60, dual-issue in-order, RV64GCV with Zba, Zbb and Zbs.
   };
 
   static Riscv64FeaturesUniquePtr FromVariant(const std::string& variant, std::string* error_msg);
@@ -64,6 +76,20 @@ class Riscv64InstructionSetFeatures final : public InstructionSetFeatures {
 
   std::string GetFeatureString() const override;
 
+  // Is the C extension (compressed instructions) supported?
+  bool HasCompressed() const { return (bits_ & kExtCompressed) != 0; }
+
+  // Is the V extension (vector instructions) supported?
+  bool HasVector() const { return (bits_ & kExtVector) != 0; }
+
+  // Are the Zba, Zbb and Zbs bit-manipulation extensions supported?
+  bool HasZba() const { return (bits_ & kExtZba) != 0; }
+  bool HasZbb() const { return (bits_ & kExtZbb) != 0; }
+  bool HasZbs() const { return (bits_ & kExtZbs) != 0; }
+
+  // The core selected by the variant, `Core::kGeneric` if not created from a known variant.
+  Core GetCore() const { return core_; }
+
   virtual ~Riscv64InstructionSetFeatures() {}
 
  protected:
@@ -71,11 +97,15 @@ class Riscv64InstructionSetFeatures final : public InstructionSetFeatures {
       const std::vector<std::string>& features, std::string* error_msg) const override;
 
  private:
-  explicit Riscv64InstructionSetFeatures(uint32_t bits) : InstructionSetFeatures(), bits_(bits) {}
+  explicit Riscv64InstructionSetFeatures(uint32_t bits, Core core = Core::kGeneric)
+      : InstructionSetFeatures(), bits_(bits), core_(core) {}
 
   // Extension bitmap.
   const uint32_t bits_;
 
+  // The core for performance heuristics.
+  const Core core_;
+
   DISALLOW_COPY_AND_ASSIGN(Riscv64InstructionSetFeatures);
 };
 
@@ -35,4 +35,95 @@ TEST(Riscv64InstructionSetFeaturesTest, Riscv64FeaturesFromDefaultVariant) {
   EXPECT_EQ(riscv64_features->AsBitmap(), expected_extensions);  // rv64gc, aka rv64imafdc
 }
 
+TEST(Riscv64InstructionSetFeaturesTest, Riscv64FeaturesFromCoreVariants) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> generic_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kRiscv64, "generic", &error_msg));
+  ASSERT_TRUE(generic_features.get() != nullptr) << error_msg;
+  EXPECT_EQ(generic_features->AsRiscv64InstructionSetFeatures()->GetCore(),
+            Riscv64InstructionSetFeatures::Core::kGeneric);
+
+  std::unique_ptr<const InstructionSetFeatures> u74_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kRiscv64, "sifive-u74", &error_msg));
+  ASSERT_TRUE(u74_features.get() != nullptr) << error_msg;
+  EXPECT_EQ(u74_features->AsRiscv64InstructionSetFeatures()->GetCore(),
+            Riscv64InstructionSetFeatures::Core::kSiFiveU74);
+  EXPECT_STREQ("rv64gc_zba_zbb", u74_features->GetFeatureString().c_str());
+
+  std::unique_ptr<const InstructionSetFeatures> x60_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kRiscv64, "spacemit-x60", &error_msg));
+  ASSERT_TRUE(x60_features.get() != nullptr) << error_msg;
+  EXPECT_EQ(x60_features->AsRiscv64InstructionSetFeatures()->GetCore(),
+            Riscv64InstructionSetFeatures::Core::kSpacemitX60);
+  EXPECT_STREQ("rv64gcv_zba_zbb_zbs", x60_features->GetFeatureString().c_str());
+
+  // The core is kept when adding features, but it is not part of the bitmap.
+  std::unique_ptr<const InstructionSetFeatures> u74_no_zbb_features(
+      u74_features->AddFeaturesFromString("-zbb", &error_msg));
+  ASSERT_TRUE(u74_no_zbb_features.get() != nullptr) << error_msg;
+  EXPECT_EQ(u74_no_zbb_features->AsRiscv64InstructionSetFeatures()->GetCore(),
+            Riscv64InstructionSetFeatures::Core::kSiFiveU74);
+  std::unique_ptr<const InstructionSetFeatures> u74_from_bitmap(
+      InstructionSetFeatures::FromBitmap(InstructionSet::kRiscv64, u74_features->AsBitmap()));
+  EXPECT_TRUE(u74_from_bitmap->Equals(u74_features.get()));
+  EXPECT_EQ(u74_from_bitmap->AsRiscv64InstructionSetFeatures()->GetCore(),
+            Riscv64InstructionSetFeatures::Core::kGeneric);
+}
+
+TEST(Riscv64InstructionSetFeaturesTest, Riscv64FeaturesFromString) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> generic_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kRiscv64, "generic", &error_msg));
+  ASSERT_TRUE(generic_features.get() != nullptr) << error_msg;
+  EXPECT_FALSE(generic_features->AsRiscv64InstructionSetFeatures()->HasVector());
+  EXPECT_STREQ("rv64gc", generic_features->GetFeatureString().c_str());
+
+  // Enable the V extension.
+  std::unique_ptr<const InstructionSetFeatures> vector_features(
+      generic_features->AddFeaturesFromString("v", &error_msg));
+  ASSERT_TRUE(vector_features.get() != nullptr) << error_msg;
+  EXPECT_TRUE(vector_features->AsRiscv64InstructionSetFeatures()->HasVector());
+  EXPECT_FALSE(vector_features->Equals(generic_features.get()));
+  EXPECT_STREQ("rv64gcv", vector_features->GetFeatureString().c_str());
+  EXPECT_EQ(vector_features->AsBitmap(),
+            generic_features->AsBitmap() | Riscv64InstructionSetFeatures::kExtVector);
+
+  // Disable it again.
+  std::unique_ptr<const InstructionSetFeatures> no_vector_features(
+      vector_features->AddFeaturesFromString("-v", &error_msg));
+  ASSERT_TRUE(no_vector_features.get() != nullptr) << error_msg;
+  EXPECT_TRUE(no_vector_features->Equals(generic_features.get()));
+
+  // Disable the C extension.
+  std::unique_ptr<const InstructionSetFeatures> no_compressed_features(
+      generic_features->AddFeaturesFromString("-c", &error_msg));
+  ASSERT_TRUE(no_compressed_features.get() != nullptr) << error_msg;
+  EXPECT_TRUE(generic_features->AsRiscv64InstructionSetFeatures()->HasCompressed());
+  EXPECT_FALSE(no_compressed_features->AsRiscv64InstructionSetFeatures()->HasCompressed());
+  EXPECT_STREQ("rv64g", no_compressed_features->GetFeatureString().c_str());
+
+  // Enable the bit-manipulation extensions.
+  std::unique_ptr<const InstructionSetFeatures> bitmanip_features(
+      generic_features->AddFeaturesFromString("zba,zbb,zbs", &error_msg));
+  ASSERT_TRUE(bitmanip_features.get() != nullptr) << error_msg;
+  EXPECT_TRUE(bitmanip_features->AsRiscv64InstructionSetFeatures()->HasZba());
+  EXPECT_TRUE(bitmanip_features->AsRiscv64InstructionSetFeatures()->HasZbb());
+  EXPECT_TRUE(bitmanip_features->AsRiscv64InstructionSetFeatures()->HasZbs());
+  EXPECT_STREQ("rv64gc_zba_zbb_zbs", bitmanip_features->GetFeatureString().c_str());
+
+  // Disable one of them again.
+  std::unique_ptr<const InstructionSetFeatures> no_zbs_features(
+      bitmanip_features->AddFeaturesFromString("-zbs", &error_msg));
+  ASSERT_TRUE(no_zbs_features.get() != nullptr) << error_msg;
+  EXPECT_TRUE(no_zbs_features->AsRiscv64InstructionSetFeatures()->HasZbb());
+  EXPECT_FALSE(no_zbs_features->AsRiscv64InstructionSetFeatures()->HasZbs());
+  EXPECT_STREQ("rv64gc_zba_zbb", no_zbs_features->GetFeatureString().c_str());
+
+  // Unknown features are rejected.
+  std::unique_ptr<const InstructionSetFeatures> unknown_features(
+      generic_features->AddFeaturesFromString("zzz", &error_msg));
+  EXPECT_TRUE(unknown_features.get() == nullptr);
+  EXPECT_NE(error_msg.find("zzz"), std::string::npos);
+}
+
 }  // namespace art
@@ -31,6 +31,11 @@ static const char* kFRegisterNames[] = {"ft0", "ft1", "ft2",  "ft3",  "ft4", "ft
                                         "fa6", "fa7", "fs2",  "fs3",  "fs4", "fs5", "fs6",  "fs7",
                                         "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11"};
 
+static const char* kVRegisterNames[] = {"v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7",
+                                        "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15",
+                                        "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23",
+                                        "v24", "v25", "v26", "v27", "v28", "v29", "v30", "v31"};
+
 std::ostream& operator<<(std::ostream& os, const XRegister& rhs) {
   if (rhs >= Zero && rhs < kNumberOfXRegisters) {
     os << kXRegisterNames[rhs];
@@ -49,5 +54,14 @@ std::ostream& operator<<(std::ostream& os, const FRegister& rhs) {
   return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const VRegister& rhs) {
+  if (rhs >= V0 && rhs < kNumberOfVRegisters) {
+    os << kVRegisterNames[rhs];
+  } else {
+    os << "VRegister[" << static_cast<int>(rhs) << "]";
+  }
+  return os;
+}
+
 }  // namespace riscv64
 }  // namespace art
@@ -19,11 +19,13 @@
 #include <errno.h>
 #include <sys/time.h>
 
+#include <algorithm>
 #include <sstream>
 
 #include "android-base/stringprintf.h"
 
 #include "base/atomic.h"
+#include "base/bit_utils.h"
 #include "base/logging.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
@@ -170,10 +172,11 @@ class ScopedAllMutexesLock final {
 class ScopedContentionRecorder final : public ValueObject {
  public:
   ScopedContentionRecorder(BaseMutex* mutex, uint64_t blocked_tid, uint64_t owner_tid)
-      : mutex_(kLogLockContentions ? mutex : nullptr),
+      : mutex_(mutex),
         blocked_tid_(kLogLockContentions ? blocked_tid : 0),
         owner_tid_(kLogLockContentions ? owner_tid : 0),
-        start_nano_time_(kLogLockContentions ? NanoTime() : 0) {
+        profile_(MutexContentionProfiler::IsEnabled()),
+        start_nano_time_((kLogLockContentions || profile_) ? NanoTime() : 0) {
     if (ATraceEnabled()) {
       std::string msg = StringPrintf("Lock contention on %s (owner tid: %" PRIu64 ")",
                                      mutex->GetName(), owner_tid);
@@ -183,9 +186,14 @@ class ScopedContentionRecorder final : public ValueObject {
 
   ~ScopedContentionRecorder() {
     ATraceEnd();
-    if (kLogLockContentions) {
-      uint64_t end_nano_time = NanoTime();
-      mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
+    if (kLogLockContentions || profile_) {
+      uint64_t wait_ns = NanoTime() - start_nano_time_;
+      if (kLogLockContentions) {
+        mutex_->RecordContention(blocked_tid_, owner_tid_, wait_ns);
+      }
+      if (profile_) {
+        MutexContentionProfiler::Record(mutex_->level_, wait_ns);
+      }
     }
   }
 
@@ -193,9 +201,83 @@ class ScopedContentionRecorder final : public ValueObject {
   BaseMutex* const mutex_;
   const uint64_t blocked_tid_;
   const uint64_t owner_tid_;
+  // Whether the profiler was enabled when the contention started.
+  const bool profile_;
   const uint64_t start_nano_time_;
 };
 
+std::atomic<bool> MutexContentionProfiler::enabled_(false);
+MutexContentionProfiler::LevelData MutexContentionProfiler::level_data_[kLockLevelCount];
+
+void MutexContentionProfiler::SetEnabled(bool enabled) {
+  bool was_enabled = enabled_.exchange(enabled, std::memory_order_relaxed);
+  if (enabled && !was_enabled) {
+    Reset();
+  }
+}
+
+size_t MutexContentionProfiler::BucketIndex(uint64_t wait_ns) {
+  uint64_t wait_us = wait_ns / 1000u;
+  size_t index = (wait_us == 0u) ? 0u : MinimumBitsToStore(wait_us);
+  return std::min(index, kBucketCount - 1u);
+}
+
+void MutexContentionProfiler::Record(LockLevel level, uint64_t wait_ns) {
+  // The counters are updated independently of each other as this is only used for diagnostics.
+  LevelData& data = level_data_[level];
+  data.buckets[BucketIndex(wait_ns)].fetch_add(1u, std::memory_order_relaxed);
+  data.count.fetch_add(1u, std::memory_order_relaxed);
+  data.total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  uint64_t max_wait_ns = data.max_wait_ns.load(std::memory_order_relaxed);
+  while (wait_ns > max_wait_ns &&
+         !data.max_wait_ns.CompareAndSetWeakRelaxed(max_wait_ns, wait_ns)) {
+    max_wait_ns = data.max_wait_ns.load(std::memory_order_relaxed);
+  }
+}
+
+void MutexContentionProfiler::Reset() {
+  for (LevelData& data : level_data_) {
+    for (Atomic<uint64_t>& bucket : data.buckets) {
+      bucket.store(0u, std::memory_order_relaxed);
+    }
+    data.count.store(0u, std::memory_order_relaxed);
+    data.total_wait_ns.store(0u, std::memory_order_relaxed);
+    data.max_wait_ns.store(0u, std::memory_order_relaxed);
+  }
+}
+
+void MutexContentionProfiler::Dump(std::ostream& os) {
+  if (!IsEnabled()) {
+    return;
+  }
+  os << "Mutex contention profile:\n";
+  for (size_t level = 0; level != kLockLevelCount; ++level) {
+    const LevelData& data = level_data_[level];
+    uint64_t count = data.count.load(std::memory_order_relaxed);
+    if (count == 0u) {
+      continue;
+    }
+    uint64_t total_wait_ns = data.total_wait_ns.load(std::memory_order_relaxed);
+    os << static_cast<LockLevel>(level) << ": contentions=" << count
+       << " total=" << PrettyDuration(total_wait_ns)
+       << " mean=" << PrettyDuration(total_wait_ns / count)
+       << " max=" << PrettyDuration(data.max_wait_ns.load(std::memory_order_relaxed)) << "\n";
+    for (size_t i = 0; i != kBucketCount; ++i) {
+      uint64_t bucket_count = data.buckets[i].load(std::memory_order_relaxed);
+      if (bucket_count == 0u) {
+        continue;
+      }
+      os << "  ";
+      if (i == kBucketCount - 1u) {
+        os << ">=" << (UINT64_C(1) << (i - 1u)) << "us";
+      } else {
+        os << "<" << (UINT64_C(1) << i) << "us";
+      }
+      os << ": " << bucket_count << "\n";
+    }
+  }
+}
+
 BaseMutex::BaseMutex(const char* name, LockLevel level)
     : name_(name),
       level_(level),
@@ -220,6 +302,7 @@ BaseMutex::~BaseMutex() {
 }
 
 void BaseMutex::DumpAll(std::ostream& os) {
+  MutexContentionProfiler::Dump(os);
   if (kLogLockContentions) {
     os << "Mutex logging:\n";
     ScopedAllMutexesLock mu(reinterpret_cast<const BaseMutex*>(-1));
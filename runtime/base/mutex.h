@@ -72,6 +72,49 @@ constexpr size_t kContentionLogSize = 4;
 constexpr size_t kContentionLogDataSize = kLogLockContentions ? 1 : 0;
 constexpr size_t kAllMutexDataSize = kLogLockContentions ? 1 : 0;
 
+// Runtime switchable profile of the time spent waiting for contended mutexes, aggregated by
+// lock level. Unlike kLogLockContentions this does not need a rebuild, and while disabled it only
+// costs a load of a global flag on the already slow contended path. Each level keeps a log2
+// histogram of the wait times which is printed as part of the SIGQUIT dump. Besides the
+// -XX:MutexContentionProfiling option, the profiler follows the
+// debug.art.mutex_contention_profiling property, which is checked on each SIGQUIT.
+class MutexContentionProfiler {
+ public:
+  // Turn the profiler on or off. Turning it on discards the data of any earlier profiling period,
+  // so that the next dump covers only the waits since then.
+  static void SetEnabled(bool enabled);
+
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Record that a thread waited `wait_ns` nanoseconds for a mutex of the given level.
+  static void Record(LockLevel level, uint64_t wait_ns);
+
+  // Print the wait time histograms of the levels that have seen contention. Prints nothing
+  // while the profiler is disabled.
+  static void Dump(std::ostream& os);
+
+  // Clear the recorded data of all levels.
+  static void Reset();
+
+ private:
+  // Bucket `i` counts the waits of less than 2^i microseconds; the last bucket is open-ended.
+  static constexpr size_t kBucketCount = 24;
+
+  struct LevelData {
+    Atomic<uint64_t> buckets[kBucketCount];
+    Atomic<uint64_t> count;
+    Atomic<uint64_t> total_wait_ns;
+    Atomic<uint64_t> max_wait_ns;
+  };
+
+  static size_t BucketIndex(uint64_t wait_ns);
+
+  static std::atomic<bool> enabled_;
+  static LevelData level_data_[kLockLevelCount];
+};
+
 // Base class for all Mutex implementations
 class BaseMutex {
  public:
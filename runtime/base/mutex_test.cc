@@ -16,6 +16,9 @@
 
 #include "mutex-inl.h"
 
+#include <sstream>
+#include <thread>
+
 #include "common_runtime_test.h"
 #include "thread-current-inl.h"
 
@@ -179,4 +182,60 @@ TEST_F(MutexTest, SharedTryLockUnlock) {
   SharedTryLockUnlockTest();
 }
 
+TEST_F(MutexTest, ContentionProfilerDisabled) {
+  MutexContentionProfiler::SetEnabled(false);
+  MutexContentionProfiler::Record(kDefaultMutexLevel, 1000u);
+  std::ostringstream oss;
+  MutexContentionProfiler::Dump(oss);
+  EXPECT_EQ("", oss.str());
+}
+
+TEST_F(MutexTest, ContentionProfilerRecord) {
+  MutexContentionProfiler::SetEnabled(true);
+  MutexContentionProfiler::Record(kGenericBottomLock, 500u);
+  MutexContentionProfiler::Record(kGenericBottomLock, 3000u);
+  std::ostringstream oss;
+  MutexContentionProfiler::Dump(oss);
+  std::string dump = oss.str();
+  EXPECT_NE(std::string::npos, dump.find("Mutex contention profile:")) << dump;
+  EXPECT_NE(std::string::npos, dump.find("kGenericBottomLock: contentions=2")) << dump;
+  EXPECT_NE(std::string::npos, dump.find("  <1us: 1")) << dump;
+  EXPECT_NE(std::string::npos, dump.find("  <4us: 1")) << dump;
+
+  // Re-enabling the profiler starts a new profiling period.
+  MutexContentionProfiler::SetEnabled(false);
+  MutexContentionProfiler::SetEnabled(true);
+  std::ostringstream oss2;
+  MutexContentionProfiler::Dump(oss2);
+  EXPECT_EQ(std::string::npos, oss2.str().find("kGenericBottomLock")) << oss2.str();
+  MutexContentionProfiler::SetEnabled(false);
+}
+
+// GCC has trouble with our mutex tests, so we have to turn off thread safety analysis.
+static void ContentionProfilerContendedLockTest() NO_THREAD_SAFETY_ANALYSIS {
+  MutexContentionProfiler::SetEnabled(true);
+  Mutex mu("contended test mutex", kGenericBottomLock);
+  // The other thread may not reach the lock before it is released again, so retry a few times.
+  std::string dump;
+  for (size_t i = 0; i != 100u && dump.find("kGenericBottomLock") == std::string::npos; ++i) {
+    mu.Lock(Thread::Current());
+    std::thread waiter([&mu]() NO_THREAD_SAFETY_ANALYSIS {
+      mu.Lock(nullptr);
+      mu.Unlock(nullptr);
+    });
+    usleep(1000);
+    mu.Unlock(Thread::Current());
+    waiter.join();
+    std::ostringstream oss;
+    MutexContentionProfiler::Dump(oss);
+    dump = oss.str();
+  }
+  EXPECT_NE(std::string::npos, dump.find("kGenericBottomLock: contentions=")) << dump;
+  MutexContentionProfiler::SetEnabled(false);
+}
+
+TEST_F(MutexTest, ContentionProfilerContendedLock) {
+  ContentionProfilerContendedLockTest();
+}
+
 }  // namespace art
@@ -3787,6 +3787,11 @@ void ClassLinker::LoadClass(Thread* self,
     // Note: We cannot have thread suspension until the field and method arrays are setup or else
     // Class::VisitFieldRoots may miss some fields or methods.
     ScopedAssertNoThreadSuspension nts(__FUNCTION__);
+    // Note: The field and method arrays are materialized eagerly, even for methods that are never
+    // invoked. Linking stores `ArtMethod*` and `ArtField*` into vtables, IMTs, dex caches and
+    // the class itself, and all of them expect a stable address that is valid as long as the
+    // class is. Deferring the allocation would require an indirection on every such access.
+    //
     // Load static fields.
     // We allow duplicate definitions of the same field in a class_data_item
     // but ignore the repeated indexes here, b/21868015.
@@ -5663,7 +5668,11 @@ bool ClassLinker::InitializeClass(Thread* self,
     if (clinit != nullptr) {
       CHECK(can_init_statics);
       JValue result;
+      metrics::AutoTimer timer{GetMetrics()->ClassInitializationTotalTime()};
       clinit->Invoke(self, nullptr, 0, &result, "V");
+      uint64_t elapsed_time_microseconds = timer.Stop();
+      GetMetrics()->ClassInitializationCount()->AddOne();
+      GetMetrics()->ClassInitializationTime()->Add(elapsed_time_microseconds);
     }
   }
   self->AllowThreadSuspension();
@@ -80,6 +80,10 @@ class ImageSpace;
 }  // namespace space
 }  // namespace gc
 
+namespace jit {
+class Jit;
+}  // namespace jit
+
 namespace linker {
 struct CompilationHelper;
 class ImageWriter;
@@ -1387,6 +1391,7 @@ class ClassLinker {
 
   friend class AppImageLoadingHelper;
   friend class ImageDumper;  // for DexLock
+  friend class jit::Jit;  // for GetDexCachesData
   friend struct linker::CompilationHelper;  // For Compile in ImageTest.
   friend class linker::ImageWriter;  // for GetClassRoots
   friend class JniCompilerTest;  // for GetRuntimeQuickGenericJniStub
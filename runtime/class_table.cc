@@ -23,7 +23,9 @@
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      frozen_sets_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
@@ -36,6 +38,19 @@ void ClassTable::FreezeSnapshot() {
   const ClassSet& last_set = classes_.back();
   ClassSet new_set(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   classes_.push_back(std::move(new_set));
+  PublishFrozenSets();
+}
+
+void ClassTable::PublishFrozenSets() {
+  DCHECK(!classes_.empty());
+  auto frozen_sets = std::make_unique<FrozenClassSets>();
+  frozen_sets->reserve(classes_.size() - 1u);
+  for (auto it = std::next(classes_.rbegin()), end = classes_.rend(); it != end; ++it) {
+    frozen_sets->push_back(&*it);
+  }
+  // Make the contents of the frozen sets visible to the lock-free readers along with the list.
+  frozen_sets_.store(frozen_sets.get(), std::memory_order_release);
+  published_frozen_sets_.push_back(std::move(frozen_sets));
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
@@ -79,8 +94,8 @@ size_t ClassTable::CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defini
 size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    sum += CountDefiningLoaderClasses(defining_loader, *it);
   }
   return sum;
 }
@@ -93,8 +108,8 @@ size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_load
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].size();
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    sum += it->size();
   }
   return sum;
 }
@@ -106,7 +121,23 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  // Search the frozen tables without taking `lock_`, so that concurrent lookups of boot image and
+  // zygote classes, which are most of the lookups, do not contend on the lock's cache line.
+  const FrozenClassSets* frozen_sets = frozen_sets_.load(std::memory_order_acquire);
+  if (frozen_sets != nullptr) {
+    for (const ClassSet* class_set : *frozen_sets) {
+      auto it = class_set->FindWithHash(pair, hash);
+      if (it != class_set->end()) {
+        return it->Read();
+      }
+    }
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
+  if (LIKELY(frozen_sets_.load(std::memory_order_relaxed) == frozen_sets)) {
+    auto it = classes_.back().FindWithHash(pair, hash);
+    return it != classes_.back().end() ? it->Read() : nullptr;
+  }
+  // The tables were frozen or added to since we searched them, so the class may be in any of them.
   // Search from the last table, assuming that apps shall search for their own classes
   // more often than for boot image classes. For prebuilt boot images, this also helps
   // by searching the large table from the framework boot image extension compiled as
@@ -178,7 +209,8 @@ void ClassTable::AddClassSet(ClassSet&& set) {
   // the number of searched frozen tables and not search them again.
   // TODO: Make use of this in `ClassLinker::FindClass()`.
   DCHECK(!classes_.empty());
-  classes_.insert(classes_.end() - 1, std::move(set));
+  classes_.insert(std::prev(classes_.end()), std::move(set));
+  PublishFrozenSets();
 }
 
 void ClassTable::ClearStrongRoots() {
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <atomic>
+#include <list>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -287,10 +290,24 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Publish the current list of frozen class sets for lock-free lookups.
+  void PublishFrozenSets() REQUIRES(lock_);
+
+  // Frozen class sets in lookup order, i.e. from the most recently added one.
+  using FrozenClassSets = std::vector<const ClassSet*>;
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
-  // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // We have a list of sets to help prevent dirty pages after the zygote forks by calling
+  // FreezeSnapshot. All but the last set are frozen. A list is used so that the frozen sets never
+  // move, as Lookup() reads them without holding `lock_`.
+  std::list<ClassSet> classes_ GUARDED_BY(lock_);
+  // The frozen sets of `classes_`, read by Lookup() without holding `lock_`. Frozen sets are not
+  // modified anymore, other than by the GC updating the class roots in place.
+  std::atomic<const FrozenClassSets*> frozen_sets_;
+  // All the published frozen set lists. Lock-free readers may still be using the older ones, so
+  // they are only freed with the table. There is one per FreezeSnapshot() or AddClassSet() call.
+  std::vector<std::unique_ptr<const FrozenClassSets>> published_frozen_sets_ GUARDED_BY(lock_);
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
@@ -158,6 +158,14 @@ TEST_F(ClassTableTest, ClassTable) {
   EXPECT_OBJ_PTR_EQ(table2.LookupByDescriptor(h_X.Get()), h_X.Get());
   EXPECT_OBJ_PTR_EQ(table2.LookupByDescriptor(h_Y.Get()), h_Y.Get());
 
+  // Test that classes are still found after freezing again, now only in frozen sets.
+  table.FreezeSnapshot();
+  EXPECT_EQ(table.NumZygoteClasses(class_loader.Get()), 2u);
+  EXPECT_EQ(table.NumNonZygoteClasses(class_loader.Get()), 0u);
+  EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(h_X.Get()), h_X.Get());
+  EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(h_Y.Get()), h_Y.Get());
+  EXPECT_TRUE(table.Lookup("NOT_THERE", ComputeModifiedUtf8Hash("NOT_THERE")) == nullptr);
+
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
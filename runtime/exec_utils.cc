@@ -28,6 +28,7 @@
 #include <sys/pidfd.h>
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <climits>
 #include <condition_variable>
@@ -44,6 +45,7 @@
 #include "android-base/strings.h"
 #include "android-base/unique_fd.h"
 #include "base/macros.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "runtime.h"
 
@@ -140,6 +142,7 @@ ExecResult WaitChild(pid_t pid,
 ExecResult WaitChildWithTimeoutFallback(pid_t pid,
                                         const std::vector<std::string>& arg_vector,
                                         int timeout_ms,
+                                        const ExecCallbacks& callbacks,
                                         std::string* error_msg) {
   bool child_exited = false;
   bool timed_out = false;
@@ -148,9 +151,19 @@ ExecResult WaitChildWithTimeoutFallback(pid_t pid,
 
   std::thread wait_thread([&]() {
     std::unique_lock<std::mutex> lock(m);
-    if (!cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return child_exited; })) {
-      timed_out = true;
-      kill(pid, SIGKILL);
+    int64_t start_ms = static_cast<int64_t>(MilliTime());
+    int64_t deadline_ms = start_ms + timeout_ms;
+    while (!cv.wait_for(lock,
+                        std::chrono::milliseconds(deadline_ms - static_cast<int64_t>(MilliTime())),
+                        [&] { return child_exited; })) {
+      // The time the child process spent paused does not count towards the timeout.
+      int64_t new_deadline_ms = start_ms + timeout_ms + callbacks.get_paused_time_ms(pid);
+      if (new_deadline_ms <= deadline_ms) {
+        timed_out = true;
+        kill(pid, SIGKILL);
+        break;
+      }
+      deadline_ms = new_deadline_ms;
     }
   });
 
@@ -180,6 +193,7 @@ ExecResult WaitChildWithTimeout(pid_t pid,
                                 unique_fd pidfd,
                                 const std::vector<std::string>& arg_vector,
                                 int timeout_ms,
+                                const ExecCallbacks& callbacks,
                                 std::string* error_msg) {
   auto cleanup = android::base::make_scope_guard([&]() {
     kill(pid, SIGKILL);
@@ -190,7 +204,23 @@ ExecResult WaitChildWithTimeout(pid_t pid,
   struct pollfd pfd;
   pfd.fd = pidfd.get();
   pfd.events = POLLIN;
-  int poll_ret = TEMP_FAILURE_RETRY(poll(&pfd, /*nfds=*/1, timeout_ms));
+  int64_t start_ms = static_cast<int64_t>(MilliTime());
+  int64_t deadline_ms = start_ms + timeout_ms;
+  int poll_ret;
+  while (true) {
+    int64_t remaining_ms = std::max<int64_t>(deadline_ms - static_cast<int64_t>(MilliTime()), 0);
+    poll_ret = TEMP_FAILURE_RETRY(
+        poll(&pfd, /*nfds=*/1, static_cast<int>(std::min<int64_t>(remaining_ms, INT_MAX))));
+    if (poll_ret != 0) {
+      break;
+    }
+    // The time the child process spent paused does not count towards the timeout.
+    int64_t new_deadline_ms = start_ms + timeout_ms + callbacks.get_paused_time_ms(pid);
+    if (new_deadline_ms <= deadline_ms) {
+      break;
+    }
+    deadline_ms = new_deadline_ms;
+  }
 
   pidfd.reset();
 
@@ -273,12 +303,13 @@ ExecResult ExecUtils::ExecAndReturnResult(const std::vector<std::string>& arg_ve
   if (timeout_sec >= 0) {
     unique_fd pidfd = PidfdOpen(pid);
     if (pidfd.get() >= 0) {
-      result =
-          WaitChildWithTimeout(pid, std::move(pidfd), arg_vector, timeout_sec * 1000, error_msg);
+      result = WaitChildWithTimeout(
+          pid, std::move(pidfd), arg_vector, timeout_sec * 1000, callbacks, error_msg);
     } else {
       LOG(DEBUG) << StringPrintf(
           "pidfd_open failed for pid %d: %s, falling back", pid, strerror(errno));
-      result = WaitChildWithTimeoutFallback(pid, arg_vector, timeout_sec * 1000, error_msg);
+      result =
+          WaitChildWithTimeoutFallback(pid, arg_vector, timeout_sec * 1000, callbacks, error_msg);
     }
   } else {
     result = WaitChild(pid, arg_vector, /*no_wait=*/true, error_msg);
@@ -41,6 +41,10 @@ struct ExecCallbacks {
   // Called in the parent process after the child process exits while still in a waitable state, no
   // matter the child process succeeds or not.
   std::function<void(pid_t pid)> on_end = [](pid_t) {};
+  // Called in the parent process when the child process reaches its timeout. Returns the time, in
+  // milliseconds, that the caller has kept the child process paused (e.g., with SIGSTOP) since it
+  // started. That time does not count towards the timeout.
+  std::function<int64_t(pid_t pid)> get_paused_time_ms = [](pid_t) { return int64_t{0}; };
 };
 
 struct ExecResult {
@@ -192,6 +192,45 @@ TEST_P(ExecUtilsTest, ExecNoTimeout) {
       << error_msg;
 }
 
+TEST_P(ExecUtilsTest, ExecTimeoutExcludesPausedTime) {
+  static constexpr int kSleepSeconds = 2;
+  static constexpr int kWaitSeconds = 1;
+  std::vector<std::string> command = SleepCommand(kSleepSeconds);
+  std::string error_msg;
+  // Pretend that the process was paused for longer than it sleeps, so it does not time out.
+  EXPECT_EQ(exec_utils_
+                ->ExecAndReturnResult(command,
+                                      kWaitSeconds,
+                                      ExecCallbacks{
+                                          .get_paused_time_ms = [](pid_t) { return int64_t{2000}; },
+                                      },
+                                      /*stat=*/nullptr,
+                                      &error_msg)
+                .status,
+            ExecResult::kExited)
+      << error_msg;
+}
+
+TEST_P(ExecUtilsTest, ExecTimeoutAfterPausedTime) {
+  static constexpr int kSleepSeconds = 5;
+  static constexpr int kWaitSeconds = 1;
+  std::vector<std::string> command = SleepCommand(kSleepSeconds);
+  std::string error_msg;
+  // The timeout is extended by the paused time only once, since the paused time does not grow.
+  EXPECT_EQ(exec_utils_
+                ->ExecAndReturnResult(command,
+                                      kWaitSeconds,
+                                      ExecCallbacks{
+                                          .get_paused_time_ms = [](pid_t) { return int64_t{1000}; },
+                                      },
+                                      /*stat=*/nullptr,
+                                      &error_msg)
+                .status,
+            ExecResult::kTimedOut)
+      << error_msg;
+  EXPECT_THAT(error_msg, HasSubstr("timed out"));
+}
+
 TEST_P(ExecUtilsTest, ExecStat) {
   std::vector<std::string> command;
   command.push_back(GetBin("id"));
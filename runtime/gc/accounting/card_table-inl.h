@@ -67,12 +67,25 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
   CheckCardValid(card_end);
   size_t cards_scanned = 0;
 
+  // Contiguous runs of cards to scan are visited with a single bitmap visit.
+  uintptr_t run_begin = 0;
+  uintptr_t run_end = 0;
+  auto visit_card = [&](uint8_t* card) ALWAYS_INLINE {
+    uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card));
+    if (start != run_end) {
+      if (run_begin != run_end) {
+        bitmap->VisitMarkedRange(run_begin, run_end, visitor);
+      }
+      run_begin = start;
+    }
+    run_end = start + kCardSize;
+    ++cards_scanned;
+  };
+
   // Handle any unaligned cards at the start.
   while (!IsAligned<sizeof(intptr_t)>(card_cur) && card_cur < card_end) {
     if (*card_cur >= minimum_age) {
-      uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-      bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-      ++cards_scanned;
+      visit_card(card_cur);
     }
     ++card_cur;
   }
@@ -83,47 +96,50 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
         (reinterpret_cast<uintptr_t>(card_end) & (sizeof(uintptr_t) - 1));
     DCHECK_LE(card_cur, aligned_end);
 
+    // Number of words of clean cards skipped at a time.
+    static constexpr size_t kWordsPerSkip = 4;
+    static_assert(kWordsPerSkip == 4, "The clean word check below assumes 4 words.");
     uintptr_t* word_end = reinterpret_cast<uintptr_t*>(aligned_end);
     for (uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur); word_cur < word_end;
         ++word_cur) {
-      while (LIKELY(*word_cur == 0)) {
+      // Skip large clean ranges a few words at a time.
+      while (word_end - word_cur >= static_cast<ptrdiff_t>(kWordsPerSkip) &&
+             (word_cur[0] | word_cur[1] | word_cur[2] | word_cur[3]) == 0) {
+        word_cur += kWordsPerSkip;
+      }
+      // The skip above may have stopped at `word_end`, so check before reading.
+      while (word_cur < word_end && LIKELY(*word_cur == 0)) {
         ++word_cur;
-        if (UNLIKELY(word_cur >= word_end)) {
-          goto exit_for;
-        }
+      }
+      if (UNLIKELY(word_cur >= word_end)) {
+        break;
       }
 
       // Find the first dirty card.
       uintptr_t start_word = *word_cur;
-      uintptr_t start =
-          reinterpret_cast<uintptr_t>(AddrFromCard(reinterpret_cast<uint8_t*>(word_cur)));
-      // TODO: Investigate if processing continuous runs of dirty cards with
-      // a single bitmap visit is more efficient.
       for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
         if (static_cast<uint8_t>(start_word) >= minimum_age) {
           auto* card = reinterpret_cast<uint8_t*>(word_cur) + i;
           DCHECK(*card == static_cast<uint8_t>(start_word) || *card == kCardDirty)
               << "card " << static_cast<size_t>(*card) << " intptr_t " << (start_word & 0xFF);
-          bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-          ++cards_scanned;
+          visit_card(card);
         }
         start_word >>= 8;
-        start += kCardSize;
       }
     }
-    exit_for:
 
     // Handle any unaligned cards at the end.
     card_cur = reinterpret_cast<uint8_t*>(word_end);
     while (card_cur < card_end) {
       if (*card_cur >= minimum_age) {
-        uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-        bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-        ++cards_scanned;
+        visit_card(card_cur);
       }
       ++card_cur;
     }
   }
+  if (run_begin != run_end) {
+    bitmap->VisitMarkedRange(run_begin, run_end, visitor);
+  }
 
   if (kClearCard) {
     ClearCardRange(scan_begin, scan_end);
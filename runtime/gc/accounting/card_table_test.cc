@@ -16,11 +16,14 @@
 
 #include "card_table-inl.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
 #include "base/common_art_test.h"
 #include "base/utils.h"
+#include "gc/accounting/space_bitmap-inl.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
@@ -145,7 +148,107 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
-// TODO: Add test for CardTable::Scan.
+class ScanVisitor {
+ public:
+  explicit ScanVisitor(std::vector<const mirror::Object*>* visited) : visited_(visited) {}
+
+  void operator()(mirror::Object* obj) const {
+    visited_->push_back(obj);
+  }
+
+ private:
+  std::vector<const mirror::Object*>* const visited_;
+};
+
+// Scan() requires the heap bitmap lock, which the test doesn't need to hold as it has no runtime.
+static size_t ScanCardTable(CardTable* card_table,
+                            ContinuousSpaceBitmap* bitmap,
+                            uint8_t* begin,
+                            uint8_t* end,
+                            const ScanVisitor& visitor) NO_THREAD_SAFETY_ANALYSIS {
+  return card_table->Scan</*kClearCard=*/ false>(bitmap, begin, end, visitor);
+}
+
+TEST_F(CardTableTest, TestScan) {
+  CommonSetup();
+  ContinuousSpaceBitmap bitmap(
+      ContinuousSpaceBitmap::Create("test bitmap", HeapBegin(), HeapLimit() - HeapBegin()));
+  ASSERT_TRUE(bitmap.IsValid());
+  // Mark two objects in each card.
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    bitmap.Set(reinterpret_cast<mirror::Object*>(addr));
+    bitmap.Set(reinterpret_cast<mirror::Object*>(addr + CardTable::kCardSize / 2));
+  }
+  // Dirty isolated cards, runs of cards spanning several card words, and leave large clean ranges
+  // in between.
+  const size_t num_cards = (HeapLimit() - HeapBegin()) / CardTable::kCardSize;
+  auto is_dirty = [](size_t card_idx) {
+    return card_idx % 97 == 0 || (card_idx % 512 >= 100 && card_idx % 512 < 140);
+  };
+  std::vector<const mirror::Object*> expected;
+  size_t expected_cards = 0;
+  for (size_t i = 0; i < num_cards; ++i) {
+    uint8_t* addr = HeapBegin() + i * CardTable::kCardSize;
+    if (is_dirty(i)) {
+      card_table_->MarkCard(addr);
+      expected.push_back(reinterpret_cast<mirror::Object*>(addr));
+      expected.push_back(reinterpret_cast<mirror::Object*>(addr + CardTable::kCardSize / 2));
+      ++expected_cards;
+    }
+  }
+
+  std::vector<const mirror::Object*> visited;
+  size_t cards_scanned =
+      ScanCardTable(card_table_.get(), &bitmap, HeapBegin(), HeapLimit(), ScanVisitor(&visited));
+  EXPECT_EQ(cards_scanned, expected_cards);
+  EXPECT_EQ(visited, expected);
+
+  // Scan a range which doesn't start or end on a card word boundary.
+  uint8_t* begin = HeapBegin() + 3 * CardTable::kCardSize;
+  uint8_t* end = HeapLimit() - 5 * CardTable::kCardSize;
+  expected.erase(std::remove_if(expected.begin(),
+                                expected.end(),
+                                [&](const mirror::Object* obj) {
+                                  const uint8_t* addr = reinterpret_cast<const uint8_t*>(obj);
+                                  return addr < begin || addr >= end;
+                                }),
+                 expected.end());
+  visited.clear();
+  ScanCardTable(card_table_.get(), &bitmap, begin, end, ScanVisitor(&visited));
+  EXPECT_EQ(visited, expected);
+}
+
+// A range which ends right after four clean card words, which Scan() skips at once, must not
+// visit the card after its end.
+TEST_F(CardTableTest, TestScanEndsAfterCleanWords) {
+  CommonSetup();
+  ContinuousSpaceBitmap bitmap(
+      ContinuousSpaceBitmap::Create("test bitmap", HeapBegin(), HeapLimit() - HeapBegin()));
+  ASSERT_TRUE(bitmap.IsValid());
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    bitmap.Set(reinterpret_cast<mirror::Object*>(addr));
+  }
+  // Start at the first card which begins a card word.
+  uint8_t* begin = HeapBegin();
+  while (!IsAligned<sizeof(uintptr_t)>(card_table_->CardFromAddr(begin))) {
+    begin += CardTable::kCardSize;
+  }
+  // One card word with a dirty card followed by four clean card words.
+  const size_t cards_per_word = sizeof(uintptr_t);
+  uint8_t* end = begin + 5 * cards_per_word * CardTable::kCardSize;
+  ASSERT_LT(end, HeapLimit());
+  card_table_->MarkCard(begin);
+  // Dirty the card just after the end of the range.
+  card_table_->MarkCard(end);
+
+  std::vector<const mirror::Object*> visited;
+  size_t cards_scanned =
+      ScanCardTable(card_table_.get(), &bitmap, begin, end, ScanVisitor(&visited));
+  EXPECT_EQ(cards_scanned, 1u);
+  std::vector<const mirror::Object*> expected = {reinterpret_cast<mirror::Object*>(begin)};
+  EXPECT_EQ(visited, expected);
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
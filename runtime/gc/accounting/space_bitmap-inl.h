@@ -160,6 +160,13 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
 
     // Traverse the middle, full part.
     for (size_t i = index_start + 1; i < index_end; ++i) {
+      // Skip runs of empty words, which are common in sparse bitmaps, a few words at a time.
+      while (index_end - i >= kWordsPerSkip && IsEmptyRun(i)) {
+        i += kWordsPerSkip;
+      }
+      if (i == index_end) {
+        break;
+      }
       uintptr_t w = bitmap_begin_[i].load(std::memory_order_relaxed);
       if (w != 0) {
         const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
@@ -167,11 +174,12 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
         do {
           const size_t shift = CTZ(w);
           mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+          w ^= (static_cast<uintptr_t>(1)) << shift;
+          PrefetchNextObject(ptr_base, w);
           visitor(obj);
           if (kVisitOnce) {
             return;
           }
-          w ^= (static_cast<uintptr_t>(1)) << shift;
         } while (w != 0);
       }
     }
@@ -215,14 +223,18 @@ void SpaceBitmap<kAlignment>::Walk(Visitor&& visitor) {
   uintptr_t end = OffsetToIndex(HeapLimit() - heap_begin_ - 1);
   Atomic<uintptr_t>* bitmap_begin = bitmap_begin_;
   for (uintptr_t i = 0; i <= end; ++i) {
+    while (end - i >= kWordsPerSkip && IsEmptyRun(i)) {
+      i += kWordsPerSkip;
+    }
     uintptr_t w = bitmap_begin[i].load(std::memory_order_relaxed);
     if (w != 0) {
       uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
       do {
         const size_t shift = CTZ(w);
         mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-        visitor(obj);
         w ^= (static_cast<uintptr_t>(1)) << shift;
+        PrefetchNextObject(ptr_base, w);
+        visitor(obj);
       } while (w != 0);
     }
   }
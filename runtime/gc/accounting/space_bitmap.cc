@@ -158,18 +158,33 @@ template<size_t kAlignment>
 void SpaceBitmap<kAlignment>::ClearRange(const mirror::Object* begin, const mirror::Object* end) {
   uintptr_t begin_offset = reinterpret_cast<uintptr_t>(begin) - heap_begin_;
   uintptr_t end_offset = reinterpret_cast<uintptr_t>(end) - heap_begin_;
-  // Align begin and end to bitmap word boundaries.
-  while (begin_offset < end_offset && OffsetBitIndex(begin_offset) != 0) {
-    Clear(reinterpret_cast<mirror::Object*>(heap_begin_ + begin_offset));
-    begin_offset += kAlignment;
+  if (begin_offset >= end_offset) {
+    return;
+  }
+  uintptr_t start_index = OffsetToIndex(begin_offset);
+  const uintptr_t end_index = OffsetToIndex(end_offset);
+  const uintptr_t begin_bit = OffsetBitIndex(begin_offset);
+  const uintptr_t end_bit = OffsetBitIndex(end_offset);
+  // Clear the partial words at both ends with a single mask each, rather than bit by bit.
+  auto clear_bits = [this](uintptr_t index, uintptr_t mask) {
+    Atomic<uintptr_t>* atomic_entry = &bitmap_begin_[index];
+    atomic_entry->store(atomic_entry->load(std::memory_order_relaxed) & ~mask,
+                        std::memory_order_relaxed);
+  };
+  const uintptr_t begin_mask = ~((static_cast<uintptr_t>(1) << begin_bit) - 1);
+  const uintptr_t end_mask = (static_cast<uintptr_t>(1) << end_bit) - 1;
+  if (start_index == end_index) {
+    clear_bits(start_index, begin_mask & end_mask);
+    return;
+  }
+  if (begin_bit != 0) {
+    clear_bits(start_index, begin_mask);
+    ++start_index;
   }
-  while (begin_offset < end_offset && OffsetBitIndex(end_offset) != 0) {
-    end_offset -= kAlignment;
-    Clear(reinterpret_cast<mirror::Object*>(heap_begin_ + end_offset));
+  if (end_bit != 0) {
+    clear_bits(end_index, end_mask);
   }
   // Bitmap word boundaries.
-  const uintptr_t start_index = OffsetToIndex(begin_offset);
-  const uintptr_t end_index = OffsetToIndex(end_offset);
   ZeroAndReleasePages(reinterpret_cast<uint8_t*>(&bitmap_begin_[start_index]),
                       (end_index - start_index) * sizeof(*bitmap_begin_));
 }
@@ -23,6 +23,7 @@
 #include <set>
 #include <vector>
 
+#include "base/bit_utils.h"
 #include "base/locks.h"
 #include "base/mem_map.h"
 #include "runtime_globals.h"
@@ -249,6 +250,26 @@ class SpaceBitmap {
   template<bool kSetBit>
   bool Modify(const mirror::Object* obj);
 
+  // Number of bitmap words checked at once when skipping empty parts of the bitmap.
+  static constexpr size_t kWordsPerSkip = 4u;
+
+  // Return true if the `kWordsPerSkip` bitmap words starting at `index` are all zero.
+  ALWAYS_INLINE bool IsEmptyRun(size_t index) const {
+    uintptr_t w = 0u;
+    for (size_t i = 0; i < kWordsPerSkip; ++i) {
+      w |= bitmap_begin_[index + i].load(std::memory_order_relaxed);
+    }
+    return w == 0u;
+  }
+
+  // Prefetch the object corresponding to the lowest bit set in the remaining bits `w` of the word
+  // starting at `ptr_base`, so that its header is in the cache by the time it gets visited.
+  ALWAYS_INLINE static void PrefetchNextObject(uintptr_t ptr_base, uintptr_t w) {
+    if (w != 0u) {
+      __builtin_prefetch(reinterpret_cast<const void*>(ptr_base + CTZ(w) * kAlignment));
+    }
+  }
+
   // Backing storage for bitmap.
   MemMap mem_map_;
 
@@ -16,6 +16,7 @@
 
 #include "rosalloc-inl.h"
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <sstream>
@@ -1097,107 +1098,120 @@ size_t RosAlloc::BulkFree(Thread* self, void** ptrs, size_t num_ptrs) {
   // Now, iterate over the affected runs and update the alloc bit map
   // based on the bulk free bit map (for non-thread-local runs) and
   // union the bulk free bit map into the thread-local free bit map
-  // (for thread-local runs.)
-  for (Run* run : runs) {
+  // (for thread-local runs.) The runs are processed grouped by size
+  // bracket so that each bracket lock is acquired once per bracket
+  // rather than once per run.
 #ifdef ART_TARGET_ANDROID
-    DCHECK(run->to_be_bulk_freed_);
-    run->to_be_bulk_freed_ = false;
+  std::vector<Run*>& sorted_runs = runs;
+#else
+  std::vector<Run*> sorted_runs(runs.begin(), runs.end());
 #endif
-    size_t idx = run->size_bracket_idx_;
+  std::sort(sorted_runs.begin(), sorted_runs.end(), [](Run* a, Run* b) {
+    return a->size_bracket_idx_ < b->size_bracket_idx_;
+  });
+  for (auto it = sorted_runs.begin(); it != sorted_runs.end();) {
+    const size_t idx = (*it)->size_bracket_idx_;
     MutexLock brackets_mu(self, *size_bracket_locks_[idx]);
-    if (run->IsThreadLocal()) {
-      DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalSizeBrackets);
-      DCHECK(non_full_runs_[idx].find(run) == non_full_runs_[idx].end());
-      DCHECK(full_runs_[idx].find(run) == full_runs_[idx].end());
-      run->MergeBulkFreeListToThreadLocalFreeList();
-      if (kTraceRosAlloc) {
-        LOG(INFO) << "RosAlloc::BulkFree() : Freed slot(s) in a thread local run 0x"
-                  << std::hex << reinterpret_cast<intptr_t>(run);
-      }
-      DCHECK(run->IsThreadLocal());
-      // A thread local run will be kept as a thread local even if
-      // it's become all free.
-    } else {
-      bool run_was_full = run->IsFull();
-      run->MergeBulkFreeListToFreeList();
-      if (kTraceRosAlloc) {
-        LOG(INFO) << "RosAlloc::BulkFree() : Freed slot(s) in a run 0x" << std::hex
-                  << reinterpret_cast<intptr_t>(run);
-      }
-      // Check if the run should be moved to non_full_runs_ or
-      // free_page_runs_.
-      auto* non_full_runs = &non_full_runs_[idx];
-      auto* full_runs = kIsDebugBuild ? &full_runs_[idx] : nullptr;
-      if (run->IsAllFree()) {
-        // It has just become completely free. Free the pages of the
-        // run.
-        bool run_was_current = run == current_runs_[idx];
-        if (run_was_current) {
-          DCHECK(full_runs->find(run) == full_runs->end());
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-          // If it was a current run, reuse it.
-        } else if (run_was_full) {
-          // If it was full, remove it from the full run set (debug
-          // only.)
-          if (kIsDebugBuild) {
-            std::unordered_set<Run*, hash_run, eq_run>::iterator pos = full_runs->find(run);
-            DCHECK(pos != full_runs->end());
-            full_runs->erase(pos);
+    for (; it != sorted_runs.end() && (*it)->size_bracket_idx_ == idx; ++it) {
+      Run* run = *it;
+#ifdef ART_TARGET_ANDROID
+      DCHECK(run->to_be_bulk_freed_);
+      run->to_be_bulk_freed_ = false;
+#endif
+      if (run->IsThreadLocal()) {
+        DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalSizeBrackets);
+        DCHECK(non_full_runs_[idx].find(run) == non_full_runs_[idx].end());
+        DCHECK(full_runs_[idx].find(run) == full_runs_[idx].end());
+        run->MergeBulkFreeListToThreadLocalFreeList();
+        if (kTraceRosAlloc) {
+          LOG(INFO) << "RosAlloc::BulkFree() : Freed slot(s) in a thread local run 0x"
+                    << std::hex << reinterpret_cast<intptr_t>(run);
+        }
+        DCHECK(run->IsThreadLocal());
+        // A thread local run will be kept as a thread local even if
+        // it's become all free.
+      } else {
+        bool run_was_full = run->IsFull();
+        run->MergeBulkFreeListToFreeList();
+        if (kTraceRosAlloc) {
+          LOG(INFO) << "RosAlloc::BulkFree() : Freed slot(s) in a run 0x" << std::hex
+                    << reinterpret_cast<intptr_t>(run);
+        }
+        // Check if the run should be moved to non_full_runs_ or
+        // free_page_runs_.
+        auto* non_full_runs = &non_full_runs_[idx];
+        auto* full_runs = kIsDebugBuild ? &full_runs_[idx] : nullptr;
+        if (run->IsAllFree()) {
+          // It has just become completely free. Free the pages of the
+          // run.
+          bool run_was_current = run == current_runs_[idx];
+          if (run_was_current) {
+            DCHECK(full_runs->find(run) == full_runs->end());
+            DCHECK(non_full_runs->find(run) == non_full_runs->end());
+            // If it was a current run, reuse it.
+          } else if (run_was_full) {
+            // If it was full, remove it from the full run set (debug
+            // only.)
+            if (kIsDebugBuild) {
+              std::unordered_set<Run*, hash_run, eq_run>::iterator pos = full_runs->find(run);
+              DCHECK(pos != full_runs->end());
+              full_runs->erase(pos);
+              if (kTraceRosAlloc) {
+                LOG(INFO) << "RosAlloc::BulkFree() : Erased run 0x" << std::hex
+                          << reinterpret_cast<intptr_t>(run)
+                          << " from full_runs_";
+              }
+              DCHECK(full_runs->find(run) == full_runs->end());
+            }
+          } else {
+            // If it was in a non full run set, remove it from the set.
+            DCHECK(full_runs->find(run) == full_runs->end());
+            DCHECK(non_full_runs->find(run) != non_full_runs->end());
+            non_full_runs->erase(run);
             if (kTraceRosAlloc) {
               LOG(INFO) << "RosAlloc::BulkFree() : Erased run 0x" << std::hex
                         << reinterpret_cast<intptr_t>(run)
-                        << " from full_runs_";
+                        << " from non_full_runs_";
             }
-            DCHECK(full_runs->find(run) == full_runs->end());
+            DCHECK(non_full_runs->find(run) == non_full_runs->end());
           }
-        } else {
-          // If it was in a non full run set, remove it from the set.
-          DCHECK(full_runs->find(run) == full_runs->end());
-          DCHECK(non_full_runs->find(run) != non_full_runs->end());
-          non_full_runs->erase(run);
-          if (kTraceRosAlloc) {
-            LOG(INFO) << "RosAlloc::BulkFree() : Erased run 0x" << std::hex
-                      << reinterpret_cast<intptr_t>(run)
-                      << " from non_full_runs_";
+          if (!run_was_current) {
+            run->ZeroHeaderAndSlotHeaders();
+            MutexLock lock_mu(self, lock_);
+            FreePages(self, run, true);
           }
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-        }
-        if (!run_was_current) {
-          run->ZeroHeaderAndSlotHeaders();
-          MutexLock lock_mu(self, lock_);
-          FreePages(self, run, true);
-        }
-      } else {
-        // It is not completely free. If it wasn't the current run or
-        // already in the non-full run set (i.e., it was full) insert
-        // it into the non-full run set.
-        if (run == current_runs_[idx]) {
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-          DCHECK(full_runs->find(run) == full_runs->end());
-          // If it was a current run, keep it.
-        } else if (run_was_full) {
-          // If it was full, remove it from the full run set (debug
-          // only) and insert into the non-full run set.
-          DCHECK(full_runs->find(run) != full_runs->end());
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-          if (kIsDebugBuild) {
-            full_runs->erase(run);
+        } else {
+          // It is not completely free. If it wasn't the current run or
+          // already in the non-full run set (i.e., it was full) insert
+          // it into the non-full run set.
+          if (run == current_runs_[idx]) {
+            DCHECK(non_full_runs->find(run) == non_full_runs->end());
+            DCHECK(full_runs->find(run) == full_runs->end());
+            // If it was a current run, keep it.
+          } else if (run_was_full) {
+            // If it was full, remove it from the full run set (debug
+            // only) and insert into the non-full run set.
+            DCHECK(full_runs->find(run) != full_runs->end());
+            DCHECK(non_full_runs->find(run) == non_full_runs->end());
+            if (kIsDebugBuild) {
+              full_runs->erase(run);
+              if (kTraceRosAlloc) {
+                LOG(INFO) << "RosAlloc::BulkFree() : Erased run 0x" << std::hex
+                          << reinterpret_cast<intptr_t>(run)
+                          << " from full_runs_";
+              }
+            }
+            non_full_runs->insert(run);
             if (kTraceRosAlloc) {
-              LOG(INFO) << "RosAlloc::BulkFree() : Erased run 0x" << std::hex
+              LOG(INFO) << "RosAlloc::BulkFree() : Inserted run 0x" << std::hex
                         << reinterpret_cast<intptr_t>(run)
-                        << " from full_runs_";
+                        << " into non_full_runs_[" << std::dec << idx;
             }
+          } else {
+            // If it was not full, so leave it in the non full run set.
+            DCHECK(full_runs->find(run) == full_runs->end());
+            DCHECK(non_full_runs->find(run) != non_full_runs->end());
           }
-          non_full_runs->insert(run);
-          if (kTraceRosAlloc) {
-            LOG(INFO) << "RosAlloc::BulkFree() : Inserted run 0x" << std::hex
-                      << reinterpret_cast<intptr_t>(run)
-                      << " into non_full_runs_[" << std::dec << idx;
-          }
-        } else {
-          // If it was not full, so leave it in the non full run set.
-          DCHECK(full_runs->find(run) == full_runs->end());
-          DCHECK(non_full_runs->find(run) != non_full_runs->end());
         }
       }
     }
@@ -45,6 +45,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -66,6 +67,9 @@ static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 // Verify that there are no missing card marks.
 static constexpr bool kVerifyNoMissingCardMarks = kIsDebugBuild;
+// Minimum number of objects on the mark stack for processing it in parallel in the marking
+// phase.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
 
 ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                      bool young_gen,
@@ -104,6 +108,7 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       reclaimed_bytes_ratio_sum_(0.f),
       cumulative_bytes_moved_(0),
       cumulative_objects_moved_(0),
+      copy_depth_(0),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       measure_read_barrier_slow_path_(measure_read_barrier_slow_path),
       mark_from_read_barrier_measurements_(false),
@@ -778,8 +783,14 @@ void ConcurrentCopying::FlipThreadRoots() {
   ThreadFlipVisitor thread_flip_visitor(this, heap_->use_tlab_);
   FlipCallback flip_callback(this);
 
+  // The heap thread pool is idle at this point. Make sure its workers are attached before the
+  // threads get suspended, so that they can help with the flip.
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  if (thread_pool != nullptr) {
+    heap_->WaitForWorkersToBeCreated();
+  }
   size_t barrier_count = Runtime::Current()->GetThreadList()->FlipThreadRoots(
-      &thread_flip_visitor, &flip_callback, this, GetHeap()->GetGcPauseListener());
+      &thread_flip_visitor, &flip_callback, this, GetHeap()->GetGcPauseListener(), thread_pool);
 
   {
     ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
@@ -1074,14 +1085,69 @@ void ConcurrentCopying::CaptureThreadRootsForMarking() {
   }
 }
 
+// A task of the parallel marking phase, marking the objects reachable from its own mark
+// stack. When the stack overflows, half of it is given to the thread pool as a new task.
+class ConcurrentCopying::MarkingTask : public Task {
+ public:
+  MarkingTask(ThreadPool* thread_pool,
+              ConcurrentCopying* collector,
+              size_t mark_stack_size,
+              StackReference<mirror::Object>* mark_stack)
+      : collector_(collector),
+        thread_pool_(thread_pool),
+        mark_stack_pos_(mark_stack_size) {
+    DCHECK_LE(mark_stack_size, kMaxSize);
+    std::copy(mark_stack, mark_stack + mark_stack_size, mark_stack_);
+  }
+
+  static constexpr size_t kMaxSize = 1 * KB;
+
+  ALWAYS_INLINE void MarkStackPush(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (UNLIKELY(mark_stack_pos_ == kMaxSize)) {
+      // Mark stack overflow, give 1/2 the stack to the thread pool as a new work task.
+      mark_stack_pos_ /= 2;
+      auto* task = new MarkingTask(thread_pool_,
+                                   collector_,
+                                   kMaxSize - mark_stack_pos_,
+                                   mark_stack_ + mark_stack_pos_);
+      thread_pool_->AddTask(Thread::Current(), task);
+    }
+    DCHECK(obj != nullptr);
+    mark_stack_[mark_stack_pos_++].Assign(obj);
+  }
+
+  // No thread safety analysis since multiple threads will run marking tasks.
+  void Run(Thread* self ATTRIBUTE_UNUSED) override NO_THREAD_SAFETY_ANALYSIS {
+    while (mark_stack_pos_ != 0) {
+      mirror::Object* obj = mark_stack_[--mark_stack_pos_].AsMirrorPtr();
+      collector_->AddLiveBytesAndScanRef(obj, this);
+    }
+  }
+
+  void Finalize() override {
+    DCHECK_EQ(mark_stack_pos_, 0u);
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  ThreadPool* const thread_pool_;
+  StackReference<mirror::Object> mark_stack_[kMaxSize];
+  size_t mark_stack_pos_;
+
+  DISALLOW_COPY_AND_ASSIGN(MarkingTask);
+};
+
 // Used to scan ref fields of an object.
 template <bool kHandleInterRegionRefs>
 class ConcurrentCopying::ComputeLiveBytesAndMarkRefFieldsVisitor {
  public:
-  explicit ComputeLiveBytesAndMarkRefFieldsVisitor(ConcurrentCopying* collector,
-                                                   size_t obj_region_idx)
+  ComputeLiveBytesAndMarkRefFieldsVisitor(ConcurrentCopying* collector,
+                                          size_t obj_region_idx,
+                                          MarkingTask* task = nullptr)
       : collector_(collector),
       obj_region_idx_(obj_region_idx),
+      task_(task),
       contains_inter_region_idx_(false) {}
 
   void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */) const
@@ -1161,7 +1227,11 @@ class ConcurrentCopying::ComputeLiveBytesAndMarkRefFieldsVisitor {
       // Nothing to do.
       return;
     }
-    if (!collector_->TestAndSetMarkBitForRef(ref)) {
+    if (task_ != nullptr) {
+      if (!collector_->TestAndSetMarkBitForRef</*kAtomic=*/ true>(ref)) {
+        task_->MarkStackPush(ref);
+      }
+    } else if (!collector_->TestAndSetMarkBitForRef(ref)) {
       collector_->PushOntoLocalMarkStack(ref);
     }
     if (kHandleInterRegionRefs && !contains_inter_region_idx_) {
@@ -1177,10 +1247,11 @@ class ConcurrentCopying::ComputeLiveBytesAndMarkRefFieldsVisitor {
 
   ConcurrentCopying* const collector_;
   const size_t obj_region_idx_;
+  MarkingTask* const task_;
   mutable bool contains_inter_region_idx_;
 };
 
-void ConcurrentCopying::AddLiveBytesAndScanRef(mirror::Object* ref) {
+void ConcurrentCopying::AddLiveBytesAndScanRef(mirror::Object* ref, MarkingTask* task) {
   DCHECK(ref != nullptr);
   DCHECK(!immune_spaces_.ContainsObject(ref));
   DCHECK(TestMarkBitmapForRef(ref));
@@ -1193,11 +1264,15 @@ void ConcurrentCopying::AddLiveBytesAndScanRef(mirror::Object* ref) {
       // to update live_bytes_.
       size_t obj_size = ref->SizeOf<kDefaultVerifyFlags>();
       size_t alloc_size = RoundUp(obj_size, space::RegionSpace::kAlignment);
-      region_space_->AddLiveBytes(ref, alloc_size);
+      if (task != nullptr) {
+        region_space_->AddLiveBytesAtomic(ref, alloc_size);
+      } else {
+        region_space_->AddLiveBytes(ref, alloc_size);
+      }
     }
   }
   ComputeLiveBytesAndMarkRefFieldsVisitor</*kHandleInterRegionRefs*/ true>
-      visitor(this, obj_region_idx);
+      visitor(this, obj_region_idx, task);
   ref->VisitReferences</*kVisitNativeRoots=*/ true, kDefaultVerifyFlags, kWithoutReadBarrier>(
       visitor, visitor);
   // Mark the corresponding card dirty if the object contains any
@@ -1210,7 +1285,13 @@ void ConcurrentCopying::AddLiveBytesAndScanRef(mirror::Object* ref) {
       // only class object reference, which is either in some immune-space, or
       // in non-moving-space.
       DCHECK(heap_->non_moving_space_->HasAddress(ref));
-      non_moving_space_inter_region_bitmap_.Set(ref);
+      if (task != nullptr) {
+        non_moving_space_inter_region_bitmap_.AtomicTestAndSet(ref);
+      } else {
+        non_moving_space_inter_region_bitmap_.Set(ref);
+      }
+    } else if (task != nullptr) {
+      region_space_inter_region_bitmap_.AtomicTestAndSet(ref);
     } else {
       region_space_inter_region_bitmap_.Set(ref);
     }
@@ -1300,12 +1381,55 @@ void ConcurrentCopying::ProcessMarkStackForMarkingAndComputeLiveBytes() {
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
 
-  while (!gc_mark_stack_->IsEmpty()) {
-    mirror::Object* ref = gc_mark_stack_->PopBack();
-    AddLiveBytesAndScanRef(ref);
+  size_t thread_count = GetMarkingThreadCount();
+  if (thread_count > 1 && gc_mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+    ProcessMarkStackForMarkingParallel(thread_count);
+  } else {
+    while (!gc_mark_stack_->IsEmpty()) {
+      mirror::Object* ref = gc_mark_stack_->PopBack();
+      AddLiveBytesAndScanRef(ref);
+    }
   }
 }
 
+size_t ConcurrentCopying::GetMarkingThreadCount() const {
+  // Only use the concurrent GC threads when jank perceptible, to leave the CPUs to the
+  // foreground apps otherwise. The zygote must stay single threaded for forking.
+  Runtime* runtime = Runtime::Current();
+  if (heap_->GetConcGCThreadCount() == 0 ||
+      runtime->IsZygote() ||
+      !runtime->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  return heap_->GetConcGCThreadCount() + 1;
+}
+
+void ConcurrentCopying::ProcessMarkStackForMarkingParallel(size_t thread_count) {
+  TimingLogger::ScopedTiming split(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  if (heap_->GetThreadPool() == nullptr) {
+    heap_->CreateThreadPool();
+  }
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  const size_t chunk_size = std::min(gc_mark_stack_->Size() / thread_count + 1,
+                                     MarkingTask::kMaxSize);
+  // Split the mark stack up into work tasks. The objects the tasks reach are pushed onto the
+  // tasks' own stacks, so `gc_mark_stack_` is not used until all of them are done.
+  for (auto* it = gc_mark_stack_->Begin(), *end = gc_mark_stack_->End(); it < end; ) {
+    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
+    thread_pool->AddTask(self, new MarkingTask(thread_pool, this, delta, it));
+    it += delta;
+  }
+  // The pool is shared with other users, so restore its bound once marking is done.
+  const size_t old_max_active_workers = thread_pool->GetMaxActiveWorkers();
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+  thread_pool->SetMaxActiveWorkers(old_max_active_workers);
+  gc_mark_stack_->Reset();
+}
+
 class ConcurrentCopying::ImmuneSpaceCaptureRefsVisitor {
  public:
   explicit ImmuneSpaceCaptureRefsVisitor(ConcurrentCopying* cc) : collector_(cc) {}
@@ -3263,6 +3387,19 @@ inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset)
       new_ref,
       CASMode::kWeak,
       std::memory_order_release));
+  // If `to_ref` was just copied by this thread, it is on top of the GC mark stack. Process it
+  // right away, rather than once all the fields of `obj` have been visited, so that the objects
+  // it references get copied next to it. This yields a bounded depth-first copy order, which
+  // keeps linked structures (e.g. hash map entry chains) in adjacent cache lines.
+  if (copy_depth_ < kMaxDepthFirstCopyDepth &&
+      mark_stack_mode_.load(std::memory_order_relaxed) == kMarkStackModeThreadLocal &&
+      !gc_mark_stack_->IsEmpty() &&
+      (gc_mark_stack_->End() - 1)->AsMirrorPtr() == to_ref) {
+    gc_mark_stack_->PopBack();
+    ++copy_depth_;
+    ProcessMarkStackRef(to_ref);
+    --copy_depth_;
+  }
 }
 
 // Process some roots.
@@ -3521,16 +3658,15 @@ mirror::Object* ConcurrentCopying::Copy(Thread* const self,
 
   // Copy the object excluding the lock word since that is handled in the loop.
   to_ref->SetClass(klass);
-  const size_t kObjectHeaderSize = sizeof(mirror::Object);
-  DCHECK_GE(obj_size, kObjectHeaderSize);
-  static_assert(kObjectHeaderSize == sizeof(mirror::HeapReference<mirror::Class>) +
+  DCHECK_GE(obj_size, mirror::kObjectHeaderSize);
+  static_assert(mirror::kObjectHeaderSize == sizeof(mirror::HeapReference<mirror::Class>) +
                     sizeof(LockWord),
                 "Object header size does not match");
   // Memcpy can tear for words since it may do byte copy. It is only safe to do this since the
   // object in the from space is immutable other than the lock word. b/31423258
-  memcpy(reinterpret_cast<uint8_t*>(to_ref) + kObjectHeaderSize,
-         reinterpret_cast<const uint8_t*>(from_ref) + kObjectHeaderSize,
-         obj_size - kObjectHeaderSize);
+  memcpy(reinterpret_cast<uint8_t*>(to_ref) + mirror::kObjectHeaderSize,
+         reinterpret_cast<const uint8_t*>(from_ref) + mirror::kObjectHeaderSize,
+         obj_size - mirror::kObjectHeaderSize);
 
   // Attempt to install the forward pointer. This is in a loop as the
   // lock word atomic write can fail.
@@ -324,13 +324,22 @@ class ConcurrentCopying : public GarbageCollector {
   void ActivateReadBarrierEntrypoints();
 
   void CaptureThreadRootsForMarking() REQUIRES_SHARED(Locks::mutator_lock_);
-  void AddLiveBytesAndScanRef(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
+  class MarkingTask;
+  // Add the size of `ref` to the live bytes of its region and mark its references. When
+  // `task` is not null, we are marking in parallel and push the references onto its stack.
+  void AddLiveBytesAndScanRef(mirror::Object* ref, MarkingTask* task = nullptr)
+      REQUIRES_SHARED(Locks::mutator_lock_);
   bool TestMarkBitmapForRef(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
   template <bool kAtomic = false>
   bool TestAndSetMarkBitForRef(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
   void PushOntoLocalMarkStack(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
   void ProcessMarkStackForMarkingAndComputeLiveBytes() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Process `gc_mark_stack_` with `thread_count` threads, including the GC thread.
+  void ProcessMarkStackForMarkingParallel(size_t thread_count)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Return the number of threads to use for the marking phase.
+  size_t GetMarkingThreadCount() const;
 
   void RemoveThreadMarkStackMapping(Thread* thread, accounting::ObjectStack* tl_mark_stack)
       REQUIRES(mark_stack_lock_);
@@ -377,6 +386,8 @@ class ConcurrentCopying : public GarbageCollector {
       GUARDED_BY(mark_stack_lock_);
   static constexpr size_t kMarkStackSize = kPageSize;
   static constexpr size_t kMarkStackPoolSize = 256;
+  // Maximum nesting depth of the objects processed as soon as they are copied by the GC thread.
+  static constexpr size_t kMaxDepthFirstCopyDepth = 4;
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
   Thread* thread_running_gc_;
@@ -440,6 +451,8 @@ class ConcurrentCopying : public GarbageCollector {
   uint64_t bytes_scanned_;
   uint64_t cumulative_bytes_moved_;
   uint64_t cumulative_objects_moved_;
+  // Nesting depth of the objects processed directly from `Process()`, used only by the GC thread.
+  size_t copy_depth_;
 
   // The skipped blocks are memory blocks/chucks that were copies of
   // objects that were unused due to lost races (cas failures) at
@@ -291,6 +291,12 @@ static constexpr size_t kMaxNumUffdWorkers = 2;
 // phase. Using a lower number in debug builds to hopefully catch the issue
 // before it becomes a problem on user builds.
 static constexpr size_t kMutatorCompactionBufferCount = kIsDebugBuild ? 256 : 512;
+// Number of moving-space pages claimed at a time by the parallel compaction
+// workers in SIGBUS feature case.
+static constexpr size_t kParallelCompactionChunkPages = 64;
+// Minimum number of moving-space pages to be compacted for the parallel
+// compaction workers to be used. Smaller heaps are compacted by gc-thread alone.
+static constexpr size_t kMinPagesForParallelCompaction = 4 * kParallelCompactionChunkPages;
 // Minimum from-space chunk to be madvised (during concurrent compaction) in one go.
 static constexpr ssize_t kMinFromSpaceMadviseSize = 1 * MB;
 // Concurrent compaction termination logic is different (and slightly more efficient) if the
@@ -377,6 +383,7 @@ MarkCompact::MarkCompact(Heap* heap)
       uffd_(kFdUnused),
       sigbus_in_progress_count_(kSigbusCounterCompactionDoneMask),
       compaction_in_progress_count_(0),
+      parallel_compaction_page_idx_(0),
       thread_pool_counter_(0),
       compacting_(false),
       uffd_initialized_(false),
@@ -711,7 +718,7 @@ void MarkCompact::RunPhases() {
     ReclaimPhase();
     PrepareForCompaction();
   }
-  if (uffd_ != kFallbackMode && !use_uffd_sigbus_) {
+  if (uffd_ != kFallbackMode && (!use_uffd_sigbus_ || GetParallelCompactionWorkerCount() > 0)) {
     heap_->GetThreadPool()->WaitForWorkersToBeCreated();
   }
 
@@ -919,6 +926,31 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
   size_t index_;
 };
 
+class MarkCompact::ParallelCompactionGcTask : public SelfDeletingTask {
+ public:
+  explicit ParallelCompactionGcTask(MarkCompact* collector) : collector_(collector) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (collector_->CanCompactMovingSpaceWithMinorFault()) {
+      collector_->ParallelCompactMovingSpace<MarkCompact::kMinorFaultMode>();
+    } else {
+      collector_->ParallelCompactMovingSpace<MarkCompact::kCopyMode>();
+    }
+  }
+
+ private:
+  MarkCompact* const collector_;
+};
+
+size_t MarkCompact::GetParallelCompactionWorkerCount() const {
+  if (!use_uffd_sigbus_ || uffd_ == kFallbackMode) {
+    return 0;
+  }
+  // On devices with 2 cores, GetParallelGCThreadCount() will return 1, so that
+  // only one worker competes with gc-thread and mutators.
+  return std::min(heap_->GetParallelGCThreadCount(), kMaxNumUffdWorkers);
+}
+
 void MarkCompact::PrepareForCompaction() {
   uint8_t* space_begin = bump_pointer_space_->Begin();
   size_t vector_len = (black_allocations_begin_ - space_begin) / kOffsetChunkSize;
@@ -1023,6 +1055,11 @@ void MarkCompact::PrepareForCompaction() {
         pool->AddTask(thread_running_gc_, new ConcurrentCompactionGcTask(this, i + 1));
       }
       CHECK_EQ(pool->GetTaskCount(thread_running_gc_), num_threads);
+    } else if (GetParallelCompactionWorkerCount() > 0 && heap_->GetThreadPool() == nullptr) {
+      // The workers are used for compacting the moving space in parallel with
+      // gc-thread. The tasks are added in CompactionPhase() once the number of
+      // pages to be compacted is known.
+      heap_->CreateThreadPool(GetParallelCompactionWorkerCount());
     }
     /*
      * Possible scenarios for mappings:
@@ -3252,6 +3289,35 @@ void MarkCompact::ConcurrentlyProcessMovingPage(uint8_t* fault_page,
   }
 }
 
+template <int kMode>
+void MarkCompact::ParallelCompactMovingSpace() {
+  DCHECK(use_uffd_sigbus_);
+  size_t page_status_arr_len = moving_first_objs_count_ + black_page_count_;
+  Thread* self = Thread::Current();
+  while (true) {
+    size_t idx = parallel_compaction_page_idx_.fetch_add(kParallelCompactionChunkPages,
+                                                         std::memory_order_relaxed);
+    if (idx >= page_status_arr_len) {
+      break;
+    }
+    size_t end_idx = std::min(idx + kParallelCompactionChunkPages, page_status_arr_len);
+    for (; idx < end_idx; idx++) {
+      // Skip the pages which are already claimed by gc-thread or a mutator, as
+      // well as the unused ones, which gc-thread doesn't map either.
+      if (moving_pages_status_[idx].load(std::memory_order_relaxed) != PageState::kUnprocessed ||
+          first_objs_moving_space_[idx].IsNull()) {
+        continue;
+      }
+      // The compaction buffer is claimed by the first call and then reused for
+      // the rest of the compaction phase, like for mutators.
+      ConcurrentlyProcessMovingPage<kMode>(
+          bump_pointer_space_->Begin() + idx * kPageSize,
+          kMode == kCopyMode ? self->GetThreadLocalGcBuffer() : nullptr,
+          page_status_arr_len);
+    }
+  }
+}
+
 void MarkCompact::MapUpdatedLinearAllocPage(uint8_t* page,
                                             uint8_t* shadow_page,
                                             Atomic<PageState>& state,
@@ -3514,12 +3580,37 @@ void MarkCompact::CompactionPhase() {
     RecordFree(ObjectBytePair(freed_objects_, freed_bytes));
   }
 
+  // When using SIGBUS feature, workers compact the moving space from the lowest
+  // page upwards, while gc-thread does it from the highest page downwards. Both
+  // claim pages using moving_pages_status_ in the same way as mutators.
+  ThreadPool* pool = nullptr;
+  if (use_uffd_sigbus_ && moving_first_objs_count_ + black_page_count_ >=
+                              kMinPagesForParallelCompaction) {
+    pool = heap_->GetThreadPool();
+  }
+  if (pool != nullptr) {
+    parallel_compaction_page_idx_.store(0, std::memory_order_relaxed);
+    size_t num_threads = std::min(pool->GetThreadCount(), GetParallelCompactionWorkerCount());
+    for (size_t i = 0; i < num_threads; i++) {
+      pool->AddTask(thread_running_gc_, new ParallelCompactionGcTask(this));
+    }
+    pool->StartWorkers(thread_running_gc_);
+  }
+
   if (CanCompactMovingSpaceWithMinorFault()) {
     CompactMovingSpace<kMinorFaultMode>(/*page=*/nullptr);
   } else {
     CompactMovingSpace<kCopyMode>(compaction_buffers_map_.Begin());
   }
 
+  if (pool != nullptr) {
+    // Workers still working on a page are accounted for in
+    // compaction_in_progress_count_ below. Waiting here ensures that none of them
+    // is about to claim a page either.
+    pool->Wait(thread_running_gc_, /*do_work=*/false, /*may_hold_locks=*/true);
+    pool->StopWorkers(thread_running_gc_);
+  }
+
   // Make sure no mutator is reading from the from-space before unregistering
   // userfaultfd from moving-space and then zapping from-space. The mutator
   // and GC may race to set a page state to processing or further along. The two
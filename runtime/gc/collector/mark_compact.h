@@ -476,6 +476,15 @@ class MarkCompact final : public GarbageCollector {
                                      uint8_t* buf,
                                      size_t nr_moving_space_used_pages)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // Called by thread-pool workers, when using SIGBUS feature, to compact
+  // moving-space pages in chunks of kParallelCompactionChunkPages, starting
+  // from the lowest page, while the gc-thread compacts from the highest one.
+  // The pages are claimed in the same way a mutator claims a faulted page.
+  template <int kMode>
+  void ParallelCompactMovingSpace() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns the number of thread-pool workers to be used by
+  // ParallelCompactMovingSpace() in this GC cycle.
+  size_t GetParallelCompactionWorkerCount() const;
   // Called by thread-pool workers to process and copy/map the fault page in
   // linear-alloc.
   template <int kMode>
@@ -737,6 +746,9 @@ class MarkCompact final : public GarbageCollector {
   // When using SIGBUS feature, this counter is used by mutators to claim a page
   // out of compaction buffers to be used for the entire compaction cycle.
   std::atomic<uint16_t> compaction_buffer_counter_;
+  // Index of the next chunk of moving-space pages to be claimed by
+  // ParallelCompactMovingSpace() workers.
+  std::atomic<size_t> parallel_compaction_page_idx_;
   // Used to exit from compaction loop at the end of concurrent compaction
   uint8_t thread_pool_counter_;
   // True while compacting.
@@ -776,6 +788,7 @@ class MarkCompact final : public GarbageCollector {
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
   class ConcurrentCompactionGcTask;
+  class ParallelCompactionGcTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
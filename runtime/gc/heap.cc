@@ -16,10 +16,12 @@
 
 #include "heap.h"
 
+#include <algorithm>
 #include <limits>
 #include "android-base/thread_annotations.h"
 #if defined(__BIONIC__) || defined(__GLIBC__)
 #include <malloc.h>  // For mallinfo()
+#include <sched.h>
 #endif
 #include <memory>
 #include <random>
@@ -27,6 +29,7 @@
 #include <sys/types.h>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/stringprintf.h"
 
 #include "allocation_listener.h"
@@ -147,6 +150,8 @@ DEFINE_RUNTIME_DEBUG_FLAG(Heap, kStressCollectorTransition);
 // Minimum amount of remaining bytes before a concurrent GC is triggered.
 static constexpr size_t kMinConcurrentRemainingBytes = 128 * KB;
 static constexpr size_t kMaxConcurrentRemainingBytes = 512 * KB;
+// Maximum multiplier of the concurrent GC start headroom when trying to meet the pause target.
+static constexpr size_t kMaxPauseTargetHeadroomMultiplier = 8;
 // Sticky GC throughput adjustment, divided by 4. Increasing this causes sticky GC to occur more
 // relative to partial/full GC. This may be desirable since sticky GCs interfere less with mutator
 // threads (lower pauses, use less memory bandwidth).
@@ -282,6 +287,7 @@ Heap::Heap(size_t initial_size,
            bool low_memory_mode,
            size_t long_pause_log_threshold,
            size_t long_gc_log_threshold,
+           size_t pause_target,
            bool ignore_target_footprint,
            bool always_log_explicit_gcs,
            bool use_tlab,
@@ -312,6 +318,9 @@ Heap::Heap(size_t initial_size,
       low_memory_mode_(low_memory_mode),
       long_pause_log_threshold_(long_pause_log_threshold),
       long_gc_log_threshold_(long_gc_log_threshold),
+      pause_target_(pause_target),
+      pause_target_headroom_multiplier_(1),
+      non_sticky_gc_missed_pause_target_(false),
       process_cpu_start_time_ns_(ProcessCpuNanoTime()),
       pre_gc_last_process_cpu_time_ns_(process_cpu_start_time_ns_),
       post_gc_last_process_cpu_time_ns_(process_cpu_start_time_ns_),
@@ -338,12 +347,19 @@ Heap::Heap(size_t initial_size,
       process_state_update_lock_("process state update lock", kPostMonitorLock),
       min_foreground_target_footprint_(0),
       min_foreground_concurrent_start_bytes_(0),
+      gc_threads_cpu_affinity_(),
+      has_gc_threads_cpu_affinity_(false),
+      gc_threads_cpu_affinity_pool_(nullptr),
       concurrent_start_bytes_(std::numeric_limits<size_t>::max()),
       total_bytes_freed_ever_(0),
       total_objects_freed_ever_(0),
       num_bytes_allocated_(0),
       native_bytes_registered_(0),
       old_native_bytes_allocated_(0),
+      native_bytes_at_native_gc_(0),
+      new_native_bytes_at_native_gc_(0),
+      native_gc_num_(0),
+      native_reclaim_percent_(100),
       native_objects_notified_(0),
       num_bytes_freed_revoke_(0),
       num_bytes_alive_after_gc_(0),
@@ -392,6 +408,7 @@ Heap::Heap(size_t initial_size,
       max_gc_requested_(0u),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_monitor_deflation_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
       running_collection_is_blocking_(false),
@@ -486,6 +503,7 @@ Heap::Heap(size_t initial_size,
   // Load image space(s).
   std::vector<std::unique_ptr<space::ImageSpace>> boot_image_spaces;
   MemMap heap_reservation;
+  metrics::AutoTimer boot_image_timer{GetMetrics()->BootImageLoadTime()};
   if (space::ImageSpace::LoadBootImage(boot_class_path,
                                        boot_class_path_locations,
                                        boot_class_path_fds,
@@ -500,6 +518,7 @@ Heap::Heap(size_t initial_size,
                                        runtime->AllowInMemoryCompilation(),
                                        &boot_image_spaces,
                                        &heap_reservation)) {
+    boot_image_timer.Stop();
     DCHECK_EQ(heap_reservation_size, heap_reservation.IsValid() ? heap_reservation.Size() : 0u);
     DCHECK(!boot_image_spaces.empty());
     request_begin = boot_image_spaces.back()->GetImageHeader().GetOatFileEnd();
@@ -518,6 +537,7 @@ Heap::Heap(size_t initial_size,
       VerifyBootImagesContiguity(boot_image_spaces_);
     }
   } else {
+    boot_image_timer.Stop();
     if (foreground_collector_type_ == kCollectorTypeCC) {
       // Need to use a low address so that we can allocate a contiguous 2 * Xmx space
       // when there's no image (dex2oat for target).
@@ -981,6 +1001,20 @@ void Heap::DecrementDisableMovingGC(Thread* self) {
   --disable_moving_gc_count_;
 }
 
+bool Heap::CanPinObject(ObjPtr<mirror::Object> obj) const {
+  return gUseReadBarrier && region_space_ != nullptr && region_space_->HasAddress(obj.Ptr());
+}
+
+void Heap::PinObject(ObjPtr<mirror::Object> obj) {
+  DCHECK(CanPinObject(obj));
+  region_space_->PinObject(obj.Ptr());
+}
+
+void Heap::UnpinObject(ObjPtr<mirror::Object> obj) {
+  DCHECK(CanPinObject(obj));
+  region_space_->UnpinObject(obj.Ptr());
+}
+
 void Heap::IncrementDisableThreadFlip(Thread* self) {
   // Supposed to be called by mutators. If thread_flip_running_ is true, block. Otherwise, go ahead.
   bool is_nested = self->GetDisableThreadFlipCount() > 0;
@@ -1111,12 +1145,38 @@ void Heap::UpdateProcessState(ProcessState old_process_state, ProcessState new_p
   }
 }
 
+void Heap::SetGcThreadsCpuAffinity(const cpu_set_t& cpus) {
+  {
+    MutexLock mu(Thread::Current(), process_state_update_lock_);
+    gc_threads_cpu_affinity_ = cpus;
+    has_gc_threads_cpu_affinity_ = true;
+    // The heap thread pool is updated by the next GC.
+    gc_threads_cpu_affinity_pool_ = nullptr;
+  }
+  // The heap task daemon also runs the heap trims and the collector transitions.
+  Thread* daemon = task_processor_->GetRunningThread();
+  if (daemon != nullptr && sched_setaffinity(daemon->GetTid(), sizeof(cpus), &cpus) != 0) {
+    PLOG(WARNING) << "Failed to set the CPU affinity of the heap task daemon";
+  }
+}
+
+void Heap::ApplyGcThreadsCpuAffinityToThreadPool() {
+  MutexLock mu(Thread::Current(), process_state_update_lock_);
+  if (has_gc_threads_cpu_affinity_ &&
+      thread_pool_ != nullptr &&
+      thread_pool_.get() != gc_threads_cpu_affinity_pool_) {
+    thread_pool_->SetCpuAffinity(gc_threads_cpu_affinity_);
+    gc_threads_cpu_affinity_pool_ = thread_pool_.get();
+  }
+}
+
 void Heap::CreateThreadPool(size_t num_threads) {
   if (num_threads == 0) {
     num_threads = std::max(parallel_gc_threads_, conc_gc_threads_);
   }
   if (num_threads != 0) {
     thread_pool_.reset(new ThreadPool("Heap thread pool", num_threads));
+    ApplyGcThreadsCpuAffinityToThreadPool();
   }
 }
 
@@ -1596,6 +1656,16 @@ void Heap::Trim(Thread* self) {
   runtime->GetArenaPool()->TrimMaps();
 }
 
+void Heap::DeflateMonitorsConcurrently(Thread* self) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  // Avoid race conditions on the lock word for CC.
+  ScopedGCCriticalSection gcs(self, kGcCauseTrim, kCollectorTypeHeapTrim);
+  uint64_t start_time = NanoTime();
+  size_t count = Runtime::Current()->GetMonitorList()->DeflateMonitorsConcurrently(self);
+  VLOG(heap) << "Concurrently deflating " << count << " monitors took "
+      << PrettyDuration(NanoTime() - start_time);
+}
+
 class TrimIndirectReferenceTableClosure : public Closure {
  public:
   explicit TrimIndirectReferenceTableClosure(Barrier* barrier) : barrier_(barrier) {
@@ -2751,6 +2821,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
     collector_type_running_ = collector_type_;
     last_gc_cause_ = gc_cause;
   }
+  ApplyGcThreadsCpuAffinityToThreadPool();
   if (gc_cause == kGcCauseForAlloc && runtime->HasStatsEnabled()) {
     ++runtime->GetStats()->gc_for_alloc_count;
     ++self->GetStats()->gc_for_alloc_count;
@@ -2817,7 +2888,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       << static_cast<size_t>(collector_type_) << " and gc_type=" << gc_type;
   collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
   IncrementFreedEver();
-  RequestTrim(self);
+  RequestTrimAfterGc(self);
   // Collect cleared references.
   SelfDeletingTask* clear = reference_processor_->CollectClearedReferences(self);
   // Grow the heap so that we know when to perform the next GC.
@@ -3699,6 +3770,7 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   TraceHeapSize(bytes_allocated);
   uint64_t target_size, grow_bytes;
   collector::GcType gc_type = collector_ran->GetGcType();
+  const bool missed_pause_target = UpdatePauseTargetState(gc_type);
   MutexLock mu(Thread::Current(), process_state_update_lock_);
   // Use the multiplier to grow more for foreground.
   const double multiplier = HeapGrowthMultiplier();
@@ -3729,9 +3801,12 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     // concurrent_start_bytes in case of concurrent GCs, in order to prevent a
     // pathological case where dead objects which aren't reclaimed by sticky could get accumulated
     // if the sticky GC throughput always remained >= the full/partial throughput.
+    // With a pause target, also do another sticky collection if the last non sticky one missed
+    // the target while this one did not.
     size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
-    if (current_gc_iteration_.GetEstimatedThroughput() * sticky_gc_throughput_adjustment >=
-        non_sticky_collector->GetEstimatedMeanThroughput() &&
+    if ((current_gc_iteration_.GetEstimatedThroughput() * sticky_gc_throughput_adjustment >=
+             non_sticky_collector->GetEstimatedMeanThroughput() ||
+         (non_sticky_gc_missed_pause_target_ && !missed_pause_target)) &&
         non_sticky_collector->NumberOfIterations() > 0 &&
         bytes_allocated <= (IsGcConcurrent() ? concurrent_start_bytes_ : target_footprint)) {
       next_gc_type_ = collector::kGcTypeSticky;
@@ -3780,6 +3855,9 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       size_t remaining_bytes = bytes_allocated_during_gc;
       remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
       remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+      // Leave more headroom when trying to meet the pause target, so that mutators are less
+      // likely to block on a GC for alloc before the concurrent GC finishes.
+      remaining_bytes *= pause_target_headroom_multiplier_;
       size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
       if (UNLIKELY(remaining_bytes > target_footprint)) {
         // A never going to happen situation that from the estimated allocation rate we will exceed
@@ -3802,6 +3880,32 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   }
 }
 
+bool Heap::UpdatePauseTargetState(collector::GcType gc_type) {
+  if (pause_target_ == 0) {
+    return false;
+  }
+  const std::vector<uint64_t>& pause_times = current_gc_iteration_.GetPauseTimes();
+  uint64_t max_pause = pause_times.empty()
+      ? 0u
+      : *std::max_element(pause_times.begin(), pause_times.end());
+  if (current_gc_iteration_.GetGcCause() == kGcCauseForAlloc) {
+    // GC for alloc pauses the allocating thread for the whole collection.
+    max_pause = std::max(max_pause, current_gc_iteration_.GetDurationNs());
+  }
+  const bool missed_pause_target = max_pause > pause_target_;
+  if (missed_pause_target) {
+    pause_target_headroom_multiplier_ =
+        std::min(pause_target_headroom_multiplier_ * 2, kMaxPauseTargetHeadroomMultiplier);
+  } else if (max_pause < pause_target_ / 2) {
+    pause_target_headroom_multiplier_ =
+        std::max(pause_target_headroom_multiplier_ / 2, static_cast<size_t>(1));
+  }
+  if (gc_type != collector::kGcTypeSticky) {
+    non_sticky_gc_missed_pause_target_ = missed_pause_target;
+  }
+  return missed_pause_target;
+}
+
 void Heap::ClampGrowthLimit() {
   // Use heap bitmap lock to guard against races with BindLiveToMarkBitmap.
   ScopedObjectAccess soa(Thread::Current());
@@ -4006,7 +4110,49 @@ void Heap::ClearPendingTrim(Thread* self) {
   pending_heap_trim_ = nullptr;
 }
 
-void Heap::RequestTrim(Thread* self) {
+class Heap::MonitorDeflationTask : public HeapTask {
+ public:
+  MonitorDeflationTask() : HeapTask(NanoTime()) { }
+  void Run(Thread* self) override {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->DeflateMonitorsConcurrently(self);
+    heap->ClearPendingMonitorDeflation(self);
+  }
+};
+
+void Heap::ClearPendingMonitorDeflation(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_monitor_deflation_ = nullptr;
+}
+
+float Heap::GetMemoryPressure() {
+  std::string pressure;
+  float some_avg10;
+  if (!android::base::ReadFileToString("/proc/pressure/memory", &pressure) ||
+      sscanf(pressure.c_str(), "some avg10=%f", &some_avg10) != 1) {
+    return -1.0f;
+  }
+  return some_avg10;
+}
+
+void Heap::RequestTrimAfterGc(Thread* self) {
+  const float pressure = GetMemoryPressure();
+  if (pressure < 0.0f) {
+    // Pressure stall information is not available, trim unconditionally.
+    RequestTrim(self);
+  } else if (pressure >= kHighMemoryPressure) {
+    // The system is short on memory, give it back without waiting.
+    RequestTrim(self, /*delta_time=*/ 0u);
+  } else if (pressure >= kLowMemoryPressure || !CareAboutPauseTimes()) {
+    RequestTrim(self);
+  } else {
+    // No memory pressure and the process is jank perceptible: keep the pages, background
+    // transitions and explicit requests still trim the heap.
+    VLOG(heap) << "Skipping heap trim, memory pressure " << pressure << "%";
+  }
+}
+
+void Heap::RequestTrim(Thread* self, uint64_t delta_time) {
   if (!CanAddHeapTask(self)) {
     return;
   }
@@ -4029,12 +4175,29 @@ void Heap::RequestTrim(Thread* self) {
       // Already have a heap trim request in task processor, ignore this request.
       return;
     }
-    added_task = new HeapTrimTask(kHeapTrimWait);
+    added_task = new HeapTrimTask(delta_time);
     pending_heap_trim_ = added_task;
   }
   task_processor_->AddTask(self, added_task);
 }
 
+void Heap::RequestConcurrentMonitorDeflation(Thread* self) {
+  if (!CanAddHeapTask(self)) {
+    return;
+  }
+  MonitorDeflationTask* added_task = nullptr;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (pending_monitor_deflation_ != nullptr) {
+      // Already have a deflation request in task processor, ignore this request.
+      return;
+    }
+    added_task = new MonitorDeflationTask();
+    pending_monitor_deflation_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
 void Heap::IncrementNumberOfBytesFreedRevoke(size_t freed_bytes_revoke) {
   size_t previous_num_bytes_freed_revoke =
       num_bytes_freed_revoke_.fetch_add(freed_bytes_revoke, std::memory_order_relaxed);
@@ -4099,10 +4262,18 @@ static constexpr size_t kNewNativeDiscountFactor = 2;
 // running out of memory.
 static constexpr float kStopForNativeFactor = 4.0;
 
+// New native allocations are discounted by the fraction of them that recent GCs for native
+// allocations managed to free, but never below this percentage. This avoids repeatedly collecting
+// for native memory that is long lived, while still bounding how much later the GC happens.
+// A GC is never deferred past kStopForNativeFactor, where we would otherwise block for it.
+static constexpr uint32_t kMinNativeReclaimPercent = 25;
+
 // Return the ratio of the weighted native + java allocated bytes to its target value.
 // A return value > 1.0 means we should collect. Significantly larger values mean we're falling
-// behind.
-inline float Heap::NativeMemoryOverTarget(size_t current_native_bytes, bool is_gc_concurrent) {
+// behind. Only `reclaim_percent` of the new native bytes are counted.
+inline float Heap::NativeMemoryOverTarget(size_t current_native_bytes,
+                                          bool is_gc_concurrent,
+                                          uint32_t reclaim_percent) {
   // Collection check for native allocation. Does not enforce Java heap bounds.
   // With adj_start_bytes defined below, effectively checks
   // <java bytes allocd> + c1*<old native allocd> + c2*<new native allocd) >= adj_start_bytes,
@@ -4115,6 +4286,8 @@ inline float Heap::NativeMemoryOverTarget(size_t current_native_bytes, bool is_g
     return 0.0;
   } else {
     size_t new_native_bytes = UnsignedDifference(current_native_bytes, old_native_bytes);
+    DCHECK_LE(reclaim_percent, 100u);
+    new_native_bytes = new_native_bytes / 100u * reclaim_percent;
     size_t weighted_native_bytes = new_native_bytes / kNewNativeDiscountFactor
         + old_native_bytes / kOldNativeDiscountFactor;
     size_t add_bytes_allowed = static_cast<size_t>(
@@ -4129,15 +4302,53 @@ inline float Heap::NativeMemoryOverTarget(size_t current_native_bytes, bool is_g
   }
 }
 
+uint32_t Heap::UpdateNativeReclaimEstimate(size_t current_native_bytes, uint32_t gc_num) {
+  uint32_t reclaim_percent = native_reclaim_percent_.load(std::memory_order_relaxed);
+  uint32_t last_gc_num = native_gc_num_.load(std::memory_order_relaxed);
+  // Only one thread accounts for each GC, and only once it has completed.
+  if (last_gc_num == gc_num ||
+      !native_gc_num_.CompareAndSetStrongRelaxed(last_gc_num, gc_num)) {
+    return reclaim_percent;
+  }
+  size_t bytes_at_gc = native_bytes_at_native_gc_.load(std::memory_order_relaxed);
+  size_t new_bytes_at_gc = new_native_bytes_at_native_gc_.load(std::memory_order_relaxed);
+  size_t old_native_bytes = old_native_bytes_allocated_.load(std::memory_order_relaxed);
+  if (new_bytes_at_gc != 0u) {
+    size_t reclaimed_bytes = UnsignedDifference(bytes_at_gc, old_native_bytes);
+    uint32_t last_percent = static_cast<uint32_t>(
+        std::min<uint64_t>(100u, static_cast<uint64_t>(reclaimed_bytes) * 100u / new_bytes_at_gc));
+    reclaim_percent = (3u * reclaim_percent + last_percent) / 4u;
+    native_reclaim_percent_.store(reclaim_percent, std::memory_order_relaxed);
+    GetMetrics()->NativeGcReclaimedBytes()->Add(reclaimed_bytes);
+  }
+  native_bytes_at_native_gc_.store(current_native_bytes, std::memory_order_relaxed);
+  new_native_bytes_at_native_gc_.store(
+      UnsignedDifference(current_native_bytes, old_native_bytes), std::memory_order_relaxed);
+  return reclaim_percent;
+}
+
 inline void Heap::CheckGCForNative(Thread* self) {
   bool is_gc_concurrent = IsGcConcurrent();
   uint32_t starting_gc_num = GetCurrentGcNum();
   size_t current_native_bytes = GetNativeBytes();
   float gc_urgency = NativeMemoryOverTarget(current_native_bytes, is_gc_concurrent);
   if (UNLIKELY(gc_urgency >= 1.0)) {
+    uint32_t reclaim_percent = std::max(
+        UpdateNativeReclaimEstimate(current_native_bytes, starting_gc_num),
+        kMinNativeReclaimPercent);
+    if (reclaim_percent < 100u &&
+        gc_urgency <= kStopForNativeFactor &&
+        NativeMemoryOverTarget(current_native_bytes, is_gc_concurrent, reclaim_percent) < 1.0) {
+      // Not enough of the new native memory is expected to be freed to pay for the GC yet.
+      GetMetrics()->NativeGcDeferredCount()->AddOne();
+      return;
+    }
+    GetMetrics()->NativeGcRequestCount()->AddOne();
+    GetMetrics()->NativeGcExpectedReclaimPercentAvg()->Add(reclaim_percent);
     if (is_gc_concurrent) {
       bool requested =
           RequestConcurrentGC(self, kGcCauseForNativeAlloc, /*force_full=*/true, starting_gc_num);
+      // The decision to wait for the GC ignores the expected reclaim.
       if (requested && gc_urgency > kStopForNativeFactor
           && current_native_bytes > stop_for_native_allocs_) {
         // We're in danger of running out of memory due to rampant native allocation.
@@ -4385,6 +4596,28 @@ void Heap::AdjustSampleOffset(size_t adjustment) {
   GetHeapSampler().AdjustSampleOffset(adjustment);
 }
 
+size_t Heap::CalculatePartialTlabSize(Thread* self) {
+  uint32_t gc_num = GetCurrentGcNum();
+  size_t tlab_size = self->GetPartialTlabSize();
+  uint32_t gcs_since_reset = gc_num - self->GetTlabRefillsGcNum();
+  if (UNLIKELY(tlab_size == 0u)) {
+    tlab_size = kPartialTlabSize;
+    self->SetPartialTlabSize(tlab_size);
+    self->ResetTlabRefills(gc_num);
+  } else if (gcs_since_reset != 0u) {
+    uint32_t refills_per_gc = self->GetTlabRefills() / gcs_since_reset;
+    if (refills_per_gc > kTargetTlabRefillsPerGc) {
+      tlab_size = std::min(tlab_size * 2, kMaxPartialTlabSize);
+    } else if (refills_per_gc < kTargetTlabRefillsPerGc / 4) {
+      tlab_size = std::max(tlab_size / 2, kMinPartialTlabSize);
+    }
+    self->SetPartialTlabSize(tlab_size);
+    self->ResetTlabRefills(gc_num);
+  }
+  self->RecordTlabRefill();
+  return tlab_size;
+}
+
 void Heap::CheckGcStressMode(Thread* self, ObjPtr<mirror::Object>* obj) {
   DCHECK(gc_stress_mode_);
   auto* const runtime = Runtime::Current();
@@ -4484,7 +4717,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TLAB bytes.
     const size_t min_expand_size = alloc_size - self->TlabSize();
     size_t next_tlab_size = JHPCalculateNextTlabSize(self,
-                                                     kPartialTlabSize,
+                                                     CalculatePartialTlabSize(self),
                                                      alloc_size,
                                                      &take_sample,
                                                      &bytes_until_sample);
@@ -4531,7 +4764,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
         size_t def_pr_tlab_size = kUsePartialTlabs
-                                      ? kPartialTlabSize
+                                      ? CalculatePartialTlabSize(self)
                                       : gc::space::RegionSpace::kRegionSize;
         size_t next_pr_tlab_size = JHPCalculateNextTlabSize(self,
                                                             def_pr_tlab_size,
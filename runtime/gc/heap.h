@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_HEAP_H_
 #define ART_RUNTIME_GC_HEAP_H_
 
+#include <sched.h>
+
 #include <iosfwd>
 #include <string>
 #include <unordered_set>
@@ -130,8 +132,13 @@ static constexpr bool kUseThreadLocalAllocationStack = true;
 
 class Heap {
  public:
-  // How much we grow the TLAB if we can do it.
+  // How much we grow the TLAB if we can do it. This is the initial size, which is then adjusted
+  // for each thread based on its allocation rate, see CalculatePartialTlabSize().
   static constexpr size_t kPartialTlabSize = 16 * KB;
+  static constexpr size_t kMinPartialTlabSize = 4 * KB;
+  static constexpr size_t kMaxPartialTlabSize = 128 * KB;
+  // Number of partial TLAB refills per GC cycle that an adaptively sized TLAB aims for.
+  static constexpr uint32_t kTargetTlabRefillsPerGc = 32u;
   static constexpr bool kUsePartialTlabs = true;
 
   static constexpr size_t kDefaultStartingSize = kPageSize;
@@ -143,6 +150,8 @@ class Heap {
   static constexpr size_t kDefaultLongPauseLogThreshold = MsToNs(5);
   static constexpr size_t kDefaultLongPauseLogThresholdGcStress = MsToNs(50);
   static constexpr size_t kDefaultLongGCLogThreshold = MsToNs(100);
+  // No pause-time target by default.
+  static constexpr size_t kDefaultPauseTarget = 0;
   static constexpr size_t kDefaultLongGCLogThresholdGcStress = MsToNs(1000);
   static constexpr size_t kDefaultTLABSize = 32 * KB;
   static constexpr double kDefaultTargetUtilization = 0.75;
@@ -182,6 +191,12 @@ class Heap {
 
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
+  // Memory pressure, as the percentage of time some tasks were stalled on memory over the last
+  // 10 seconds, above which the heap is trimmed as soon as possible after a GC.
+  static constexpr float kHighMemoryPressure = 10.0f;
+  // Memory pressure below which a jank perceptible process keeps its free memory after a GC,
+  // to avoid paying for refaulting it in later.
+  static constexpr float kLowMemoryPressure = 0.1f;
   // Whether the transition-GC heap threshold condition applies or not for non-low memory devices.
   // Stressing GC will bypass the heap threshold condition.
   DECLARE_RUNTIME_DEBUG_FLAG(kStressCollectorTransition);
@@ -215,6 +230,7 @@ class Heap {
        bool low_memory_mode,
        size_t long_pause_threshold,
        size_t long_gc_threshold,
+       size_t pause_target,
        bool ignore_target_footprint,
        bool always_log_explicit_gcs,
        bool use_tlab,
@@ -381,6 +397,13 @@ class Heap {
   // Temporarily disable thread flip for JNI critical calls.
   void IncrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
   void DecrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
+
+  // Returns whether JNI critical calls can pin the object in place instead of disabling the
+  // thread flip. This is the case for objects in the region space of the CC collector, where
+  // pinning only keeps the region of the object from being evacuated.
+  bool CanPinObject(ObjPtr<mirror::Object> obj) const REQUIRES_SHARED(Locks::mutator_lock_);
+  void PinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+  void UnpinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
   void ThreadFlipBegin(Thread* self) REQUIRES(!*thread_flip_lock_);
   void ThreadFlipEnd(Thread* self) REQUIRES(!*thread_flip_lock_);
 
@@ -479,6 +502,11 @@ class Heap {
   void UpdateProcessState(ProcessState old_process_state, ProcessState new_process_state)
       REQUIRES(!*pending_task_lock_, !*gc_complete_lock_, !process_state_update_lock_);
 
+  // Restrict the GC threads, i.e. the heap task daemon and the heap thread pool, to the given set
+  // of CPUs. The heap thread pool picks up the new set at the start of the next GC, since it may
+  // only be touched by the thread running the GC.
+  void SetGcThreadsCpuAffinity(const cpu_set_t& cpus) REQUIRES(!process_state_update_lock_);
+
   bool HaveContinuousSpaces() const NO_THREAD_SAFETY_ANALYSIS {
     // No lock since vector empty is thread safe.
     return !continuous_spaces_.empty();
@@ -646,6 +674,10 @@ class Heap {
   // Deflate monitors, ... and trim the spaces.
   void Trim(Thread* self) REQUIRES(!*gc_complete_lock_);
 
+  // Deflate the idle monitors without suspending the mutators.
+  void DeflateMonitorsConcurrently(Thread* self)
+      REQUIRES(!*gc_complete_lock_, !Locks::mutator_lock_);
+
   void RevokeThreadLocalBuffers(Thread* thread);
   void RevokeRosAllocThreadLocalBuffers(Thread* thread);
   void RevokeAllThreadLocalBuffers();
@@ -771,7 +803,7 @@ class Heap {
 
   // Thread pool. Create either the given number of threads, or as per the
   // values of conc_gc_threads_ and parallel_gc_threads_.
-  void CreateThreadPool(size_t num_threads = 0);
+  void CreateThreadPool(size_t num_threads = 0) REQUIRES(!process_state_update_lock_);
   void WaitForWorkersToBeCreated();
   void DeleteThreadPool();
   ThreadPool* GetThreadPool() {
@@ -854,7 +886,13 @@ class Heap {
   }
 
   // Request an asynchronous trim.
-  void RequestTrim(Thread* self) REQUIRES(!*pending_task_lock_);
+  void RequestTrim(Thread* self) REQUIRES(!*pending_task_lock_) {
+    RequestTrim(self, kHeapTrimWait);
+  }
+  void RequestTrim(Thread* self, uint64_t delta_time) REQUIRES(!*pending_task_lock_);
+
+  // Request an asynchronous deflation of the idle monitors.
+  void RequestConcurrentMonitorDeflation(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // Retrieve the current GC number, i.e. the number n such that we completed n GCs so far.
   // Provides acquire ordering, so that if we read this first, and then check whether a GC is
@@ -915,6 +953,13 @@ class Heap {
   // Reduce the number of bytes to the next sample position by this adjustment.
   void AdjustSampleOffset(size_t adjustment);
 
+  // Returns the size of the next partial TLAB for `self` and records the refill. The size is
+  // doubled or halved, within [kMinPartialTlabSize, kMaxPartialTlabSize], when the thread refilled
+  // its TLAB more than kTargetTlabRefillsPerGc times, or less than a quarter of that, per GC cycle
+  // since the last adjustment. Fast allocating threads then refill less often, while idle ones
+  // keep less unused memory in their TLAB.
+  size_t CalculatePartialTlabSize(Thread* self);
+
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
   bool IsAllocTrackingEnabled() const {
@@ -997,6 +1042,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class MonitorDeflationTask;
   class TriggerPostForkCCGcTask;
   class ReduceTargetFootprintTask;
 
@@ -1053,7 +1099,12 @@ class Heap {
 
   // Checks whether we should garbage collect:
   ALWAYS_INLINE bool ShouldConcurrentGCForJava(size_t new_num_bytes_allocated);
-  float NativeMemoryOverTarget(size_t current_native_bytes, bool is_gc_concurrent);
+  float NativeMemoryOverTarget(size_t current_native_bytes,
+                               bool is_gc_concurrent,
+                               uint32_t reclaim_percent = 100u);
+  // Update the estimate of the native memory reclaimed by GCs for native allocations with the
+  // outcome of the previous one, and return the estimate as a percentage of the new native bytes.
+  uint32_t UpdateNativeReclaimEstimate(size_t current_native_bytes, uint32_t gc_num);
   void CheckGCForNative(Thread* self)
       REQUIRES(!*pending_task_lock_, !*gc_complete_lock_, !process_state_update_lock_);
 
@@ -1160,6 +1211,10 @@ class Heap {
       REQUIRES(!*gc_complete_lock_, !Locks::heap_bitmap_lock_, !Locks::thread_suspend_count_lock_,
                !*pending_task_lock_, !process_state_update_lock_);
 
+  // Apply the GC threads CPU affinity to the heap thread pool if it has not been done yet. Called
+  // by the thread running the GC.
+  void ApplyGcThreadsCpuAffinityToThreadPool() REQUIRES(!process_state_update_lock_);
+
   void PreGcVerification(collector::GarbageCollector* gc)
       REQUIRES(!Locks::mutator_lock_, !*gc_complete_lock_);
   void PreGcVerificationPaused(collector::GarbageCollector* gc)
@@ -1201,6 +1256,10 @@ class Heap {
                           size_t bytes_allocated_before_gc = 0)
       REQUIRES(!process_state_update_lock_);
 
+  // Updates the pause target state from the GC that just finished. Returns whether the GC paused
+  // mutators for longer than pause_target_.
+  bool UpdatePauseTargetState(collector::GcType gc_type);
+
   size_t GetPercentFree();
 
   // Swap the allocation stack with the live stack.
@@ -1227,6 +1286,14 @@ class Heap {
       REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
 
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
+  void ClearPendingMonitorDeflation(Thread* self) REQUIRES(!*pending_task_lock_);
+
+  // Request a trim after a GC, sooner or not at all depending on the system memory pressure.
+  void RequestTrimAfterGc(Thread* self) REQUIRES(!*pending_task_lock_);
+
+  // Return the system memory pressure reported by the kernel pressure stall information, or a
+  // negative value if it is not available.
+  static float GetMemoryPressure();
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
@@ -1362,6 +1429,17 @@ class Heap {
   // If we get a GC longer than long GC log threshold, then we print out the GC after it finishes.
   const size_t long_gc_log_threshold_;
 
+  // Soft target for the longest mutator pause of a GC, in nanoseconds, 0 if none. When set, the
+  // concurrent GCs are started earlier and sticky GCs are preferred while pauses exceed it.
+  const size_t pause_target_;
+
+  // Multiplier of the concurrent GC start headroom, doubled after each GC missing pause_target_
+  // and halved after each GC pausing for less than half of it. Only accessed by the GC.
+  size_t pause_target_headroom_multiplier_;
+
+  // Whether the last non-sticky GC paused for longer than pause_target_.
+  bool non_sticky_gc_missed_pause_target_;
+
   // Starting time of the new process; meant to be used for measuring total process CPU time.
   uint64_t process_cpu_start_time_ns_;
 
@@ -1452,6 +1530,12 @@ class Heap {
   size_t min_foreground_target_footprint_ GUARDED_BY(process_state_update_lock_);
   size_t min_foreground_concurrent_start_bytes_ GUARDED_BY(process_state_update_lock_);
 
+  // CPUs the GC threads are restricted to, see SetGcThreadsCpuAffinity(), and the heap thread
+  // pool they were last applied to.
+  cpu_set_t gc_threads_cpu_affinity_ GUARDED_BY(process_state_update_lock_);
+  bool has_gc_threads_cpu_affinity_ GUARDED_BY(process_state_update_lock_);
+  ThreadPool* gc_threads_cpu_affinity_pool_ GUARDED_BY(process_state_update_lock_);
+
   // When num_bytes_allocated_ exceeds this amount then a concurrent GC should be requested so that
   // it completes ahead of an allocation failing.
   // A multiple of this is also used to determine when to trigger a GC in response to native
@@ -1479,6 +1563,17 @@ class Heap {
   // Approximately the smallest value of GetNativeBytes() we've seen since the last GC.
   Atomic<size_t> old_native_bytes_allocated_;
 
+  // GetNativeBytes() and the new native bytes (above old_native_bytes_allocated_) when the last GC
+  // for native allocations was requested, and the GC number at that time.
+  Atomic<size_t> native_bytes_at_native_gc_;
+  Atomic<size_t> new_native_bytes_at_native_gc_;
+  Atomic<uint32_t> native_gc_num_;
+
+  // Decaying average of the percentage of new native bytes freed by a GC for native allocations.
+  // Native memory freed by a GC is only released by the cleaners running after it, so this is
+  // measured by the time the next one is requested.
+  Atomic<uint32_t> native_reclaim_percent_;
+
   // Total number of native objects of which we were notified since the beginning of time, mod 2^32.
   // Allows us to check for GC only roughly every kNotifyNativeInterval allocations.
   Atomic<uint32_t> native_objects_notified_;
@@ -1644,6 +1739,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  MonitorDeflationTask* pending_monitor_deflation_ GUARDED_BY(pending_task_lock_);
 
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
@@ -1733,6 +1829,8 @@ class Heap {
   friend class VerifyReferenceVisitor;
   friend class VerifyObjectVisitor;
 
+  ART_FRIEND_TEST(HeapTest, NativeGcDeferral);  // For the native reclaim estimate.
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(Heap);
 };
 
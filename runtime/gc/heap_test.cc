@@ -17,6 +17,7 @@
 #include <algorithm>
 
 #include "base/metrics/metrics.h"
+#include "base/metrics/metrics_test.h"
 #include "class_linker-inl.h"
 #include "common_runtime_test.h"
 #include "gc/accounting/card_table-inl.h"
@@ -31,6 +32,8 @@
 namespace art {
 namespace gc {
 
+using metrics::test::CounterValue;
+
 class HeapTest : public CommonRuntimeTest {
  public:
   HeapTest() {
@@ -254,6 +257,70 @@ TEST_F(HeapTest, GCMetrics) {
   }
 }
 
+TEST_F(HeapTest, NativeGcDeferral) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  JNIEnv* env = Thread::Current()->GetJniEnv();
+  bool is_gc_concurrent = heap->IsGcConcurrent();
+
+  // A GC that freed a quarter of the new native bytes lowers the estimate by a quarter of 75%.
+  uint32_t gc_num = heap->GetCurrentGcNum();
+  heap->native_gc_num_.store(gc_num - 1u);
+  heap->native_reclaim_percent_.store(100u);
+  heap->native_bytes_at_native_gc_.store(heap->old_native_bytes_allocated_.load() + 10 * MB);
+  heap->new_native_bytes_at_native_gc_.store(40 * MB);
+  uint64_t reclaimed_bytes = CounterValue(*metrics->NativeGcReclaimedBytes());
+  EXPECT_EQ(81u, heap->UpdateNativeReclaimEstimate(heap->GetNativeBytes(), gc_num));
+  EXPECT_EQ(reclaimed_bytes + 10 * MB, CounterValue(*metrics->NativeGcReclaimedBytes()));
+  // Each GC is accounted for only once.
+  EXPECT_EQ(81u, heap->UpdateNativeReclaimEstimate(heap->GetNativeBytes(), gc_num));
+  EXPECT_EQ(reclaimed_bytes + 10 * MB, CounterValue(*metrics->NativeGcReclaimedBytes()));
+
+  // The GC urgency grows linearly with the new native bytes, from the share of the Java heap
+  // target that is already in use. Find the new native bytes that take us over the target, but
+  // leave us below it when only the minimum share of 25% of them is counted.
+  size_t native_bytes = heap->GetNativeBytes();
+  float urgency = heap->NativeMemoryOverTarget(native_bytes, is_gc_concurrent);
+  ASSERT_LT(urgency, 1.0);
+  float java_urgency = heap->NativeMemoryOverTarget(
+      heap->old_native_bytes_allocated_.load(), is_gc_concurrent);
+  float urgency_per_mb =
+      heap->NativeMemoryOverTarget(native_bytes + 64 * MB, is_gc_concurrent) - urgency;
+  urgency_per_mb /= 64;
+  ASSERT_GT(urgency_per_mb, 0.0);
+  float target_urgency = java_urgency + 2.0 * (1.0 - java_urgency);
+  size_t new_native_bytes = static_cast<size_t>((target_urgency - urgency) / urgency_per_mb) * MB;
+
+  // With little of the native memory expected to be freed, the GC is deferred.
+  heap->native_gc_num_.store(heap->GetCurrentGcNum());
+  heap->native_reclaim_percent_.store(0u);
+  uint64_t deferred_count = CounterValue(*metrics->NativeGcDeferredCount());
+  uint64_t request_count = CounterValue(*metrics->NativeGcRequestCount());
+  heap->RegisterNativeAllocation(env, new_native_bytes);
+  EXPECT_EQ(deferred_count + 1u, CounterValue(*metrics->NativeGcDeferredCount()));
+  EXPECT_EQ(request_count, CounterValue(*metrics->NativeGcRequestCount()));
+  heap->RegisterNativeFree(env, new_native_bytes);
+
+  // When all of it is expected to be freed, the GC is requested right away.
+  heap->native_gc_num_.store(heap->GetCurrentGcNum());
+  heap->native_reclaim_percent_.store(100u);
+  heap->RegisterNativeAllocation(env, new_native_bytes);
+  EXPECT_EQ(deferred_count + 1u, CounterValue(*metrics->NativeGcDeferredCount()));
+  EXPECT_EQ(request_count + 1u, CounterValue(*metrics->NativeGcRequestCount()));
+  heap->RegisterNativeFree(env, new_native_bytes);
+
+  // Never defer past the point where the allocating thread would wait for the GC.
+  heap->native_gc_num_.store(heap->GetCurrentGcNum());
+  heap->native_reclaim_percent_.store(0u);
+  new_native_bytes = static_cast<size_t>((8.0 - urgency) / urgency_per_mb) * MB;
+  heap->RegisterNativeAllocation(env, new_native_bytes);
+  EXPECT_EQ(deferred_count + 1u, CounterValue(*metrics->NativeGcDeferredCount()));
+  EXPECT_EQ(request_count + 2u, CounterValue(*metrics->NativeGcRequestCount()));
+  heap->RegisterNativeFree(env, new_native_bytes);
+
+  heap->native_reclaim_percent_.store(100u);
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
  public:
   ZygoteHeapTest() {
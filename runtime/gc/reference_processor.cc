@@ -41,6 +41,10 @@ namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
 
+// Maximum number of times ForwardSoftReferences() forwards and marks from the SoftReferences
+// discovered by the previous round.
+static constexpr size_t kMaxForwardSoftReferencesRounds = 4;
+
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
@@ -171,17 +175,26 @@ uint32_t ReferenceProcessor::ForwardSoftReferences(TimingLogger* timings) {
   // We used to argue that we should be smarter about doing this conditionally, but it's unclear
   // that's actually better than the more predictable strategy of basically only clearing
   // SoftReferences just before we would otherwise run out of memory.
-  uint32_t non_null_refs = soft_reference_queue_.ForwardSoftReferences(collector_);
-  if (ATraceEnabled()) {
-    static constexpr size_t kBufSize = 80;
-    char buf[kBufSize];
-    snprintf(buf, kBufSize, "Marking for %" PRIu32 " SoftReferences", non_null_refs);
-    ATraceBegin(buf);
-    collector_->ProcessMarkStack();
-    ATraceEnd();
-  } else {
-    collector_->ProcessMarkStack();
-  }
+  uint32_t non_null_refs = 0;
+  // Marking from the forwarded referents can discover more SoftReferences, e.g. in caches made of
+  // SoftReferences to objects holding SoftReferences. Forward those in a bounded number of extra
+  // rounds, so that few of them are left for ProcessReferences(), which runs while GetReferent()
+  // blocks.
+  size_t rounds = 0;
+  do {
+    uint32_t round_refs = soft_reference_queue_.ForwardSoftReferences(collector_);
+    non_null_refs += round_refs;
+    if (ATraceEnabled()) {
+      static constexpr size_t kBufSize = 80;
+      char buf[kBufSize];
+      snprintf(buf, kBufSize, "Marking for %" PRIu32 " SoftReferences", round_refs);
+      ATraceBegin(buf);
+      collector_->ProcessMarkStack();
+      ATraceEnd();
+    } else {
+      collector_->ProcessMarkStack();
+    }
+  } while (++rounds < kMaxForwardSoftReferencesRounds && !soft_reference_queue_.IsEmpty());
   return non_null_refs;
 }
 
@@ -122,8 +122,15 @@ void LargeObjectSpace::CopyLiveToMarked() {
   mark_bitmap_.CopyFrom(&live_bitmap_);
 }
 
+// Maximum total size of the freed large object maps kept for reuse. They hold
+// no memory but some of the low 4GB address space.
+static constexpr size_t kMaxFreeMapsSize = 16 * MB;
+// Maximum size of a single freed large object map kept for reuse.
+static constexpr size_t kMaxFreeMapSize = kMaxFreeMapsSize / 4;
+
 LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name)
-    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock") {}
+    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock"),
+      free_maps_size_(0) {}
 
 LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name) {
   if (Runtime::Current()->IsRunningOnMemoryTool()) {
@@ -136,15 +143,22 @@ LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name) {
 mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
                                            size_t* bytes_allocated, size_t* usable_size,
                                            size_t* bytes_tl_bulk_allocated) {
-  std::string error_msg;
-  MemMap mem_map = MemMap::MapAnonymous("large object space allocation",
-                                        num_bytes,
-                                        PROT_READ | PROT_WRITE,
-                                        /*low_4gb=*/ true,
-                                        &error_msg);
-  if (UNLIKELY(!mem_map.IsValid())) {
-    LOG(WARNING) << "Large object allocation failed: " << error_msg;
-    return nullptr;
+  MemMap mem_map;
+  {
+    MutexLock mu(self, lock_);
+    mem_map = TakeFreeMap(num_bytes);
+  }
+  if (!mem_map.IsValid()) {
+    std::string error_msg;
+    mem_map = MemMap::MapAnonymous("large object space allocation",
+                                   num_bytes,
+                                   PROT_READ | PROT_WRITE,
+                                   /*low_4gb=*/ true,
+                                   &error_msg);
+    if (UNLIKELY(!mem_map.IsValid())) {
+      LOG(WARNING) << "Large object allocation failed: " << error_msg;
+      return nullptr;
+    }
   }
   mirror::Object* const obj = reinterpret_cast<mirror::Object*>(mem_map.Begin());
   const size_t allocation_size = mem_map.BaseSize();
@@ -201,10 +215,37 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
   size_t allocation_size = map_size;
   num_bytes_allocated_ -= allocation_size;
   --num_objects_allocated_;
+  CacheFreeMap(std::move(it->second.mem_map));
   large_objects_.erase(it);
   return allocation_size;
 }
 
+MemMap LargeObjectMapSpace::TakeFreeMap(size_t size) {
+  size = RoundUp(size, kPageSize);
+  auto it = free_maps_.lower_bound(size);
+  // Don't waste more than a quarter of the map.
+  if (it == free_maps_.end() || it->first > size + size / 4) {
+    return MemMap::Invalid();
+  }
+  MemMap mem_map = std::move(it->second);
+  free_maps_.erase(it);
+  DCHECK_GE(free_maps_size_, mem_map.BaseSize());
+  free_maps_size_ -= mem_map.BaseSize();
+  return mem_map;
+}
+
+void LargeObjectMapSpace::CacheFreeMap(MemMap&& mem_map) {
+  const size_t map_size = mem_map.BaseSize();
+  if (map_size > kMaxFreeMapSize || free_maps_size_ + map_size > kMaxFreeMapsSize) {
+    // Unmapped when `mem_map` goes out of scope in the caller.
+    return;
+  }
+  // Release the pages so that the map doesn't hold memory and is zeroed for its next use.
+  mem_map.MadviseDontNeedAndZero();
+  free_maps_size_ += map_size;
+  free_maps_.emplace(map_size, std::move(mem_map));
+}
+
 size_t LargeObjectMapSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
   MutexLock mu(Thread::Current(), lock_);
   auto it = large_objects_.find(obj);
@@ -24,6 +24,7 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -178,8 +179,26 @@ class LargeObjectMapSpace : public LargeObjectSpace {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns a cached map of freed large objects of at least `size` bytes, if any is close enough
+  // in size.
+  MemMap TakeFreeMap(size_t size) REQUIRES(lock_);
+  // Caches the map of a freed large object for reuse, if there is room enough.
+  void CacheFreeMap(MemMap&& mem_map) REQUIRES(lock_);
+
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
+
+  // Maps of freed large objects, by size, to avoid a munmap/mmap pair per large object when
+  // allocations of a similar size follow frees. Their pages are released, and therefore zeroed,
+  // when they are cached.
+  using FreeMaps = std::multimap<size_t,
+                                 MemMap,
+                                 std::less<size_t>,
+                                 TrackingAllocator<std::pair<const size_t, MemMap>,
+                                                   kAllocatorTagLOSMaps>>;
+  FreeMaps free_maps_ GUARDED_BY(lock_);
+  // Total size of the maps in free_maps_.
+  size_t free_maps_size_ GUARDED_BY(lock_);
 };
 
 // A continuous large object space with a free-list to handle holes.
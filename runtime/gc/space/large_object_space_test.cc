@@ -182,6 +182,32 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, MapSpaceReusesFreedMaps) {
+  Thread* const self = Thread::Current();
+  LargeObjectSpace* los = space::LargeObjectMapSpace::Create("large object space");
+  static constexpr size_t kRequestSize = 64 * KB;
+  size_t allocation_size, bytes_tl_bulk_allocated;
+  mirror::Object* obj = los->Alloc(self, kRequestSize, &allocation_size, nullptr,
+                                   &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  memset(obj, 0xFF, kRequestSize);
+  ASSERT_EQ(los->Free(self, obj), allocation_size);
+
+  // The freed map is reused, and its memory is zeroed.
+  mirror::Object* new_obj = los->Alloc(self, kRequestSize, &allocation_size, nullptr,
+                                       &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(new_obj != nullptr);
+  if (!Runtime::Current()->IsRunningOnMemoryTool()) {
+    EXPECT_EQ(new_obj, obj);
+  }
+  for (size_t i = 0; i < kRequestSize; ++i) {
+    ASSERT_EQ(reinterpret_cast<const uint8_t*>(new_obj)[i], 0u);
+  }
+  los->Free(self, new_obj);
+  EXPECT_EQ(0U, los->GetBytesAllocated());
+  delete los;
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -13,7 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <array>
 #include <deque>
+#include <limits>
 
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
@@ -32,6 +34,22 @@ namespace space {
 // value of the region size, evaculate the region.
 static constexpr uint kEvacuateLivePercentThreshold = 75U;
 
+// Same as `kEvacuateLivePercentThreshold`, for regions that survived at
+// least `kOldRegionAge` collections. Long-lived data is copied again only
+// if the region is fragmented enough to make it worthwhile.
+static constexpr uint kEvacuateOldLivePercentThreshold = 50U;
+static constexpr uint32_t kOldRegionAge = 4U;
+
+// Maximum amount of live bytes, as a percentage of the capacity of the
+// space, copied out of the regions evacuated based on their live ratio
+// in one collection. The regions with the fewest live bytes, i.e. the best
+// ratio of reclaimed bytes to copied bytes, are evacuated first.
+static constexpr size_t kMaxEvacuatedLivePercent = 25U;
+
+// Number of buckets of the live bytes histogram used to apply the limit
+// above.
+static constexpr size_t kNumLiveBytesBuckets = 32U;
+
 // Whether we protect the unused and cleared regions.
 static constexpr bool kProtectClearedRegions = kIsDebugBuild;
 
@@ -190,10 +208,10 @@ void RegionSpace::Region::SetAsUnevacFromSpace(bool clear_live_bytes) {
   type_ = RegionType::kRegionTypeUnevacFromSpace;
   if (IsNewlyAllocated()) {
     // A newly allocated region set as unevac from-space must be
-    // a large or large tail region.
-    DCHECK(IsLarge() || IsLargeTail()) << static_cast<uint>(state_);
-    // Always clear the live bytes of a newly allocated (large or
-    // large tail) region.
+    // a large, large tail or pinned region.
+    DCHECK(IsLarge() || IsLargeTail() || IsPinned()) << static_cast<uint>(state_);
+    // Always clear the live bytes of a newly allocated (large,
+    // large tail or pinned) region.
     clear_live_bytes = true;
     // Clear the "newly allocated" status here, as we do not want the
     // GC to see it when encountering (and processing) references in the
@@ -218,20 +236,27 @@ bool RegionSpace::Region::GetUseGenerationalCC() {
   return art::Runtime::Current()->GetHeap()->GetUseGenerationalCC();
 }
 
-inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
+inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode, uint32_t time) {
   // Evacuation mode `kEvacModeNewlyAllocated` is only used during sticky-bit CC collections.
   DCHECK(GetUseGenerationalCC() || (evac_mode != kEvacModeNewlyAllocated));
   DCHECK((IsAllocated() || IsLarge()) && IsInToSpace());
   // The region should be evacuated if:
+  // - the region is not pinned, and
   // - the evacuation is forced (!large && `evac_mode == kEvacModeForceAll`); or
   // - the region was allocated after the start of the previous GC (newly allocated region); or
-  // - !large and the live ratio is below threshold (`kEvacuateLivePercentThreshold`).
+  // - !large and the live ratio is below threshold (`kEvacuateLivePercentThreshold`, or
+  //   `kEvacuateOldLivePercentThreshold` for old regions).
   if (IsLarge()) {
     // It makes no sense to evacuate in the large case, since the region only contains zero or
     // one object. If the regions is completely empty, we'll reclaim it anyhow. If its one object
     // is live, we would just be moving around region-aligned memory.
     return false;
   }
+  if (UNLIKELY(IsPinned())) {
+    // Native code holds direct pointers into this region, leave it in place even when
+    // evacuation is forced.
+    return false;
+  }
   if (UNLIKELY(evac_mode == kEvacModeForceAll)) {
     return true;
   }
@@ -265,7 +290,11 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
       // Side node: live_percent == 0 does not necessarily mean
       // there's no live objects due to rounding (there may be a
       // few).
-      return live_bytes_ * 100U < kEvacuateLivePercentThreshold * bytes_allocated;
+      DCHECK_GE(time, alloc_time_);
+      const uint threshold = (time - alloc_time_ >= kOldRegionAge)
+          ? kEvacuateOldLivePercentThreshold
+          : kEvacuateLivePercentThreshold;
+      return live_bytes_ * 100U < threshold * bytes_allocated;
     }
   }
   return false;
@@ -306,6 +335,49 @@ void RegionSpace::ZeroLiveBytesForLargeObject(mirror::Object* obj) {
   }
 }
 
+size_t RegionSpace::ComputeMaxEvacuatedLiveBytes(size_t iter_limit) {
+  // Build a histogram of the live bytes of the regions that would be
+  // evacuated because of their live ratio.
+  std::array<size_t, kNumLiveBytesBuckets> live_bytes_histogram = {};
+  for (size_t i = 0; i < iter_limit; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsAllocated() &&
+        !r->IsNewlyAllocated() &&
+        r->ShouldBeEvacuated(kEvacModeLivePercentNewlyAllocated, time_)) {
+      const size_t live_bytes = r->LiveBytes();
+      const size_t bucket = std::min(live_bytes * kNumLiveBytesBuckets / kRegionSize,
+                                     kNumLiveBytesBuckets - 1);
+      live_bytes_histogram[bucket] += live_bytes;
+    }
+  }
+  const size_t budget = num_regions_ * kMaxEvacuatedLivePercent / 100U * kRegionSize;
+  size_t evacuated_live_bytes = 0;
+  for (size_t bucket = 0; bucket < kNumLiveBytesBuckets; ++bucket) {
+    if (evacuated_live_bytes + live_bytes_histogram[bucket] > budget) {
+      VLOG(heap) << "Limiting evacuation to regions with less than "
+                 << PrettySize(bucket * kRegionSize / kNumLiveBytesBuckets) << " live";
+      return bucket * kRegionSize / kNumLiveBytesBuckets;
+    }
+    evacuated_live_bytes += live_bytes_histogram[bucket];
+  }
+  return std::numeric_limits<size_t>::max();
+}
+
+void RegionSpace::PinObject(mirror::Object* obj) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  Region* r = RefToRegionLocked(obj);
+  DCHECK(!r->IsFree());
+  DCHECK(!r->IsInFromSpace());
+  ++r->pin_count_;
+}
+
+void RegionSpace::UnpinObject(mirror::Object* obj) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  Region* r = RefToRegionLocked(obj);
+  DCHECK(r->IsPinned());
+  --r->pin_count_;
+}
+
 // Determine which regions to evacuate and mark them as
 // from-space. Mark the rest as unevacuated from-space.
 void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
@@ -332,6 +404,11 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   const size_t iter_limit = kUseTableLookupReadBarrier
       ? num_regions_
       : std::min(num_regions_, non_free_region_index_limit_);
+  // Regions selected by their live ratio with at least this many live bytes are not evacuated.
+  size_t max_evacuated_live_bytes = std::numeric_limits<size_t>::max();
+  if (evac_mode == kEvacModeLivePercentNewlyAllocated) {
+    max_evacuated_live_bytes = ComputeMaxEvacuatedLiveBytes(iter_limit);
+  }
   for (size_t i = 0; i < iter_limit; ++i) {
     Region* r = &regions_[i];
     RegionState state = r->State();
@@ -342,8 +419,14 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
+        bool should_evacuate = r->ShouldBeEvacuated(evac_mode, time_);
         bool is_newly_allocated = r->IsNewlyAllocated();
+        if (should_evacuate &&
+            !is_newly_allocated &&
+            state == RegionState::kRegionStateAllocated &&
+            r->LiveBytes() >= max_evacuated_live_bytes) {
+          should_evacuate = false;
+        }
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
@@ -351,6 +434,17 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
           r->SetAsUnevacFromSpace(clear_live_bytes);
           DCHECK(r->IsInUnevacFromSpace());
         }
+        if (UNLIKELY(use_generational_cc_ &&
+                     !should_evacuate &&
+                     is_newly_allocated &&
+                     state == RegionState::kRegionStateAllocated)) {
+          // A newly allocated region is only kept in place when it is pinned. As for newly
+          // allocated large objects below, clear the mark bits that a preceding marking phase
+          // may have set, so that the live bytes of the region get counted during copying.
+          DCHECK(r->IsPinned());
+          GetMarkBitmap()->ClearRange(reinterpret_cast<mirror::Object*>(r->Begin()),
+                                      reinterpret_cast<mirror::Object*>(r->End()));
+        }
         if (UNLIKELY(state == RegionState::kRegionStateLarge &&
                      type == RegionType::kRegionTypeToSpace)) {
           prev_large_evacuated = should_evacuate;
@@ -906,7 +1000,8 @@ void RegionSpace::RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) {
     DCHECK_GE(r->End(), thread->GetTlabPos());
     DCHECK_LE(r->Begin(), thread->GetTlabPos());
     size_t remaining_bytes = r->End() - thread->GetTlabPos();
-    if (reuse && remaining_bytes >= gc::Heap::kPartialTlabSize) {
+    // Threads with a small adaptive TLAB size can still make use of small leftovers.
+    if (reuse && remaining_bytes >= gc::Heap::kMinPartialTlabSize) {
       partial_tlabs_.insert(std::make_pair(remaining_bytes, r));
     }
   }
@@ -1005,6 +1100,7 @@ size_t RegionSpace::AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable
 }
 
 void RegionSpace::Region::Clear(bool zero_and_release_pages) {
+  DCHECK_EQ(pin_count_, 0u);
   top_.store(begin_, std::memory_order_relaxed);
   state_ = RegionState::kRegionStateFree;
   type_ = RegionType::kRegionTypeNone;
@@ -301,6 +301,11 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // objects.
   void ZeroLiveBytesForLargeObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Pin the region containing `obj` so that it is not evacuated by subsequent collections until
+  // the matching `UnpinObject()`. The object itself must be kept reachable by the caller.
+  void PinObject(mirror::Object* obj) REQUIRES(!region_lock_);
+  void UnpinObject(mirror::Object* obj) REQUIRES(!region_lock_);
+
   // Determine which regions to evacuate and tag them as
   // from-space. Tag the rest as unevacuated from-space.
   void SetFromSpace(accounting::ReadBarrierTable* rb_table,
@@ -321,6 +326,12 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes, for threads marking in parallel.
+  void AddLiveBytesAtomic(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AddLiveBytesAtomic(alloc_size);
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -398,6 +409,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           end_(nullptr),
           objects_allocated_(0),
           alloc_time_(0),
+          pin_count_(0u),
           is_newly_allocated_(false),
           is_a_tlab_(false),
           state_(RegionState::kRegionStateAllocated),
@@ -413,6 +425,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       objects_allocated_.store(0, std::memory_order_relaxed);
       alloc_time_ = 0;
       live_bytes_ = static_cast<size_t>(-1);
+      pin_count_ = 0u;
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
@@ -499,6 +512,12 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       return is_newly_allocated_;
     }
 
+    // Whether the region holds objects that native code accesses directly and that must
+    // therefore not be evacuated.
+    bool IsPinned() const {
+      return pin_count_ != 0u;
+    }
+
     bool IsTlab() const {
       return is_a_tlab_;
     }
@@ -554,7 +573,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
 
     // Return whether this region should be evacuated. Used by RegionSpace::SetFromSpace.
-    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode);
+    // `time` is the current time of the space, used to compute the age of the region.
+    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode, uint32_t time);
 
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
@@ -565,6 +585,14 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       DCHECK_LE(live_bytes_, BytesAllocated());
     }
 
+    void AddLiveBytesAtomic(size_t live_bytes) {
+      DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      Atomic<size_t>* atomic_live_bytes = reinterpret_cast<Atomic<size_t>*>(&live_bytes_);
+      atomic_live_bytes->fetch_add(IsLarge() ? Top() - begin_ : live_bytes,
+                                   std::memory_order_relaxed);
+    }
+
     bool AllAllocatedBytesAreLive() const {
       return LiveBytes() == static_cast<size_t>(Top() - Begin());
     }
@@ -632,6 +660,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // are concurrent updates.
     Atomic<size_t> objects_allocated_;  // The number of objects allocated.
     uint32_t alloc_time_;               // The allocation time of the region.
+    uint32_t pin_count_;                // Number of pinned objects, guarded by `region_lock_`.
     // Note that newly allocated and evacuated regions use -1 as
     // special value for `live_bytes_`.
     bool is_newly_allocated_;           // True if it's allocated after the last collection.
@@ -702,6 +731,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     VerifyNonFreeRegionLimit();
   }
 
+  // Return the number of live bytes from which a region in the first `iter_limit` regions is not
+  // evacuated based on its live ratio, so that the bytes copied by a collection remain bounded.
+  size_t ComputeMaxEvacuatedLiveBytes(size_t iter_limit) REQUIRES(region_lock_);
+
   // Implementation of this invariant:
   // for all `i >= non_free_region_index_limit_`, `regions_[i].IsFree()` is true.
   void VerifyNonFreeRegionLimit() REQUIRES(region_lock_) {
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "region_space.h"
+
+#include "region_space-inl.h"
+#include "space_test.h"
+
+namespace art {
+namespace gc {
+namespace space {
+
+class RegionSpaceTest : public SpaceTest<CommonRuntimeTest> {
+ protected:
+  RegionSpaceTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+};
+
+TEST_F(RegionSpaceTest, PinnedRegionIsNotEvacuated) {
+  Thread* self = Thread::Current();
+  MemMap mem_map = RegionSpace::CreateMemMap(
+      "test region space", 4 * RegionSpace::kRegionSize, /*requested_begin=*/ nullptr);
+  ASSERT_TRUE(mem_map.IsValid());
+  std::unique_ptr<RegionSpace> space(
+      RegionSpace::Create("test region space", std::move(mem_map), /*use_generational_cc=*/ false));
+  ASSERT_TRUE(space != nullptr);
+
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Class> byte_array_class(hs.NewHandle(GetByteArrayClass(self)));
+  static constexpr size_t kObjectSize = 64u;
+  size_t bytes_allocated;
+  size_t usable_size;
+  size_t bytes_tl_bulk_allocated;
+  mirror::Object* obj =
+      space->Alloc(self, kObjectSize, &bytes_allocated, &usable_size, &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  InstallClass(obj, byte_array_class.Get(), kObjectSize);
+
+  // Even a collection that evacuates all regions leaves the pinned region in place. Mark the
+  // object live, as the collector would, since the caller of `PinObject()` keeps it reachable.
+  space->PinObject(obj);
+  space->SetFromSpace(
+      /*rb_table=*/ nullptr, RegionSpace::kEvacModeForceAll, /*clear_live_bytes=*/ true);
+  EXPECT_FALSE(space->IsInFromSpace(obj));
+  EXPECT_TRUE(space->IsInUnevacFromSpace(obj));
+  space->GetMarkBitmap()->Set(obj);
+  space->AddLiveBytes(obj, bytes_allocated);
+  uint64_t cleared_bytes;
+  uint64_t cleared_objects;
+  space->ClearFromSpace(&cleared_bytes, &cleared_objects, /*clear_bitmap=*/ false);
+  EXPECT_EQ(0u, cleared_objects);
+  EXPECT_TRUE(space->IsInToSpace(obj));
+  space->GetMarkBitmap()->Clear(obj);
+
+  // Once unpinned, the region is evacuated and freed by the next collection.
+  space->UnpinObject(obj);
+  space->SetFromSpace(
+      /*rb_table=*/ nullptr, RegionSpace::kEvacModeForceAll, /*clear_live_bytes=*/ true);
+  EXPECT_TRUE(space->IsInFromSpace(obj));
+  space->ClearFromSpace(&cleared_bytes, &cleared_objects, /*clear_bitmap=*/ false);
+  EXPECT_EQ(1u, cleared_objects);
+  EXPECT_EQ(RegionSpace::RegionType::kRegionTypeNone, space->GetRegionType(obj));
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
@@ -26,10 +26,12 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/time.h>
 #include <sys/uio.h>
+#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -41,6 +43,7 @@
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/array_ref.h"
+#include "base/fast_exit.h"
 #include "base/file_utils.h"
 #include "base/logging.h"
 #include "base/macros.h"
@@ -74,6 +77,12 @@ namespace hprof {
 
 static constexpr bool kDirectStream = true;
 
+// Whether dumps to a file are written by a forked child process, so that the threads of the
+// process are only suspended for the duration of the fork rather than for the whole dump.
+static constexpr bool kForkToDumpToFile = true;
+// Time after which a forked child that has not finished the dump is killed.
+static constexpr unsigned int kForkedDumpTimeoutSeconds = 10 * 60;
+
 static constexpr uint32_t kHprofTime = 0;
 static constexpr uint32_t kHprofNullThread = 0;
 
@@ -1598,17 +1607,55 @@ void Hprof::VisitRoot(mirror::Object* obj, const RootInfo& info) {
 // sent directly to DDMS.
 // If "fd" is >= 0, the output will be written to that file descriptor.
 // Otherwise, "filename" is used to create an output file.
+// A dump to a file is written by a forked child, which walks a copy-on-write snapshot of the
+// heap. The other threads are resumed as soon as the fork returns.
 void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
   CHECK(filename != nullptr);
   Thread* self = Thread::Current();
-  // Need to take a heap dump while GC isn't running. See the comment in Heap::VisitObjects().
-  // Also we need the critical section to avoid visiting the same object twice. See b/34967844
-  gc::ScopedGCCriticalSection gcs(self,
-                                  gc::kGcCauseHprof,
-                                  gc::kCollectorTypeHprof);
-  ScopedSuspendAll ssa(__FUNCTION__, true /* long suspend */);
-  Hprof hprof(filename, fd, direct_to_ddms);
-  hprof.Dump();
+  pid_t pid;
+  {
+    // Need to take a heap dump while GC isn't running. See the comment in Heap::VisitObjects().
+    // Also we need the critical section to avoid visiting the same object twice. See b/34967844
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseHprof,
+                                    gc::kCollectorTypeHprof);
+    ScopedSuspendAll ssa(__FUNCTION__, true /* long suspend */);
+    if (direct_to_ddms || !kForkToDumpToFile) {
+      Hprof hprof(filename, fd, direct_to_ddms);
+      hprof.Dump();
+      return;
+    }
+    pid = fork();
+    if (pid == 0) {
+      // The child only runs this thread, which holds the mutator lock exclusively. Make sure it
+      // goes away if it gets stuck, e.g. on a lock held by a thread that no longer exists.
+      signal(SIGALRM, SIG_DFL);
+      alarm(kForkedDumpTimeoutSeconds);
+      Hprof hprof(filename, fd, /*direct_to_ddms=*/ false);
+      hprof.Dump();
+      // Prevent the `atexit` handlers registered by the parent from running.
+      FastExit(self->IsExceptionPending() ? 1 : 0);
+    }
+    if (pid == -1) {
+      PLOG(WARNING) << "hprof: fork failed, dumping the heap in process";
+      Hprof hprof(filename, fd, direct_to_ddms);
+      hprof.Dump();
+      return;
+    }
+  }
+  int status;
+  while (waitpid(pid, &status, 0) == -1) {
+    if (errno != EINTR) {
+      PLOG(ERROR) << "hprof: waitpid";
+      return;
+    }
+  }
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    ScopedObjectAccess soa(self);
+    ThrowRuntimeException("Couldn't dump heap to \"%s\": dump process failed (status %d)",
+                          filename,
+                          status);
+  }
 }
 
 }  // namespace hprof
@@ -41,18 +41,23 @@ class ImtConflictTable {
 
  public:
   // Build a new table copying `other` and adding the new entry formed of
-  // the pair { `interface_method`, `implementation_method` }
+  // the pair { `interface_method`, `implementation_method` }.
+  // The new entry is placed first: tables only grow when the lookup in the
+  // conflict trampoline misses, so the new entry is the one being invoked and
+  // is likely to be invoked again soon. The stubs scan the table linearly from
+  // the start, so this keeps recently used entries ahead of stale ones.
   ImtConflictTable(ImtConflictTable* other,
                    ArtMethod* interface_method,
                    ArtMethod* implementation_method,
                    PointerSize pointer_size) {
     const size_t count = other->NumEntries(pointer_size);
+    SetInterfaceMethod(0, pointer_size, interface_method);
+    SetImplementationMethod(0, pointer_size, implementation_method);
     for (size_t i = 0; i < count; ++i) {
-      SetInterfaceMethod(i, pointer_size, other->GetInterfaceMethod(i, pointer_size));
-      SetImplementationMethod(i, pointer_size, other->GetImplementationMethod(i, pointer_size));
+      SetInterfaceMethod(i + 1, pointer_size, other->GetInterfaceMethod(i, pointer_size));
+      SetImplementationMethod(
+          i + 1, pointer_size, other->GetImplementationMethod(i, pointer_size));
     }
-    SetInterfaceMethod(count, pointer_size, interface_method);
-    SetImplementationMethod(count, pointer_size, implementation_method);
     // Add the null marker.
     SetInterfaceMethod(count + 1, pointer_size, nullptr);
     SetImplementationMethod(count + 1, pointer_size, nullptr);
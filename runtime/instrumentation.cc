@@ -107,6 +107,38 @@ class InstallStubsClassVisitor : public ClassVisitor {
   Instrumentation* const instrumentation_;
 };
 
+// Visits the invokable copies of a default method in the classes implementing its interface. The
+// copies have their own entrypoints, so they need to be updated along with the interface method.
+template <typename Visitor>
+class DefaultMethodCopiesVisitor : public ClassVisitor {
+ public:
+  DefaultMethodCopiesVisitor(ArtMethod* method, const Visitor& visitor)
+      : method_(method), visitor_(visitor) {}
+
+  bool operator()(ObjPtr<mirror::Class> klass) override REQUIRES(Locks::mutator_lock_) {
+    if (klass->IsResolved() && !klass->IsErroneousResolved() && !klass->IsInterface()) {
+      for (ArtMethod& copy : klass->GetCopiedMethods(kRuntimePointerSize)) {
+        if (copy.IsInvokable() && copy.GetCanonicalMethod() == method_) {
+          visitor_(&copy);
+        }
+      }
+    }
+    return true;  // we visit all classes.
+  }
+
+ private:
+  ArtMethod* const method_;
+  const Visitor& visitor_;
+};
+
+template <typename Visitor>
+static void VisitDefaultMethodCopies(ArtMethod* method, const Visitor& visitor)
+    REQUIRES(Locks::mutator_lock_) {
+  DCHECK(method->IsDefault());
+  DefaultMethodCopiesVisitor<Visitor> class_visitor(method, visitor);
+  Runtime::Current()->GetClassLinker()->VisitClasses(&class_visitor);
+}
+
 Instrumentation::Instrumentation()
     : run_exit_hooks_(false),
       instrumentation_level_(InstrumentationLevel::kInstrumentNothing),
@@ -1161,6 +1193,13 @@ void Instrumentation::Deoptimize(ArtMethod* method) {
   }
   if (!InterpreterStubsInstalled()) {
     UpdateEntryPoints(method, GetQuickToInterpreterBridge());
+    if (method->IsDefault()) {
+      // The copies of a default method are deoptimized along with it, see IsDeoptimized(). Copies
+      // created later pick up the interpreter bridge when their class gets linked.
+      VisitDefaultMethodCopies(method, [](ArtMethod* copy) REQUIRES(Locks::mutator_lock_) {
+        UpdateEntryPoints(copy, GetQuickToInterpreterBridge());
+      });
+    }
 
     // Instrument thread stacks to request a check if the caller needs a deoptimization.
     // This isn't a strong deopt. We deopt this method if it is still in the deopt methods list.
@@ -1186,6 +1225,20 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
     return;
   }
 
+  RestoreEntryPointsAfterDeoptimization(method);
+  if (method->IsDefault()) {
+    VisitDefaultMethodCopies(method, [this](ArtMethod* copy) REQUIRES(Locks::mutator_lock_) {
+      RestoreEntryPointsAfterDeoptimization(copy);
+    });
+  }
+
+  // If there is no deoptimized method left, we can restore the stack of each thread.
+  if (!EntryExitStubsInstalled()) {
+    MaybeRestoreInstrumentationStack();
+  }
+}
+
+void Instrumentation::RestoreEntryPointsAfterDeoptimization(ArtMethod* method) {
   if (method->IsObsolete()) {
     // Don't update entry points for obsolete methods. The entrypoint should
     // have been set to InvokeObsoleteMethoStub.
@@ -1203,11 +1256,6 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
   } else {
     UpdateEntryPoints(method, GetMaybeInstrumentedCodeForInvoke(method));
   }
-
-  // If there is no deoptimized method left, we can restore the stack of each thread.
-  if (!EntryExitStubsInstalled()) {
-    MaybeRestoreInstrumentationStack();
-  }
 }
 
 bool Instrumentation::IsDeoptimizedMethodsEmpty() const {
@@ -1216,7 +1264,12 @@ bool Instrumentation::IsDeoptimizedMethodsEmpty() const {
 
 bool Instrumentation::IsDeoptimized(ArtMethod* method) {
   DCHECK(method != nullptr);
-  return IsDeoptimizedMethod(method);
+  if (deoptimized_methods_.empty()) {
+    return false;
+  }
+  // Copies of a default method are deoptimized along with the interface method.
+  return IsDeoptimizedMethod(method) ||
+         (method->IsCopied() && IsDeoptimizedMethod(method->GetCanonicalMethod()));
 }
 
 void Instrumentation::DisableDeoptimization(const char* key) {
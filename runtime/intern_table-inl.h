@@ -138,14 +138,15 @@ inline void InternTable::Table::AddInternStrings(UnorderedSet&& intern_strings,
   // Keep the order of previous frozen tables unchanged, so that we can can remember
   // the number of searched frozen tables and not search them again.
   DCHECK(!tables_.empty());
-  tables_.insert(tables_.end() - 1, InternalTable(std::move(intern_strings), is_boot_image));
+  tables_.insert(std::prev(tables_.end()), InternalTable(std::move(intern_strings), is_boot_image));
+  PublishFrozenTables();
 }
 
 template <typename Visitor>
 inline void InternTable::VisitInterns(const Visitor& visitor,
                                       bool visit_boot_images,
                                       bool visit_non_boot_images) {
-  auto visit_tables = [&](dchecked_vector<Table::InternalTable>& tables)
+  auto visit_tables = [&](std::list<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags.
@@ -163,7 +164,7 @@ inline void InternTable::VisitInterns(const Visitor& visitor,
 
 inline size_t InternTable::CountInterns(bool visit_boot_images, bool visit_non_boot_images) const {
   size_t ret = 0u;
-  auto visit_tables = [&](const dchecked_vector<Table::InternalTable>& tables)
+  auto visit_tables = [&](const std::list<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (const Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags.
@@ -114,6 +114,11 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::St
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
+  ObjPtr<mirror::String> frozen =
+      strong_interns_.FindInFrozenTables(GcRoot<mirror::String>(s), hash);
+  if (frozen != nullptr) {
+    return frozen;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return strong_interns_.Find(s, hash);
 }
@@ -122,6 +127,11 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
                                                  uint32_t utf16_length,
                                                  const char* utf8_data) {
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
+  ObjPtr<mirror::String> frozen =
+      strong_interns_.FindInFrozenTables(Utf8String(utf16_length, utf8_data), hash);
+  if (frozen != nullptr) {
+    return frozen;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
 }
@@ -205,6 +215,12 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   DCHECK(s != nullptr);
   DCHECK_EQ(hash, static_cast<uint32_t>(s->GetStoredHashCode()));
   DCHECK_IMPLIES(hash == 0u, s->ComputeHashCode() == 0);
+  // Strings from the boot and app images are found without taking the lock.
+  ObjPtr<mirror::String> frozen =
+      strong_interns_.FindInFrozenTables(GcRoot<mirror::String>(s), hash);
+  if (frozen != nullptr) {
+    return frozen;
+  }
   Thread* const self = Thread::Current();
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking) {
@@ -252,6 +268,12 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
 ObjPtr<mirror::String> InternTable::InternStrong(uint32_t utf16_length, const char* utf8_data) {
   DCHECK(utf8_data != nullptr);
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
+  // Strings from the boot and app images are found without taking the lock.
+  ObjPtr<mirror::String> frozen =
+      strong_interns_.FindInFrozenTables(Utf8String(utf16_length, utf8_data), hash);
+  if (frozen != nullptr) {
+    return frozen;
+  }
   Thread* self = Thread::Current();
   ObjPtr<mirror::String> s;
   size_t num_searched_strong_frozen_tables;
@@ -336,7 +358,7 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
                                                 uint32_t hash,
                                                 size_t num_searched_frozen_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  auto mid = tables_.begin() + num_searched_frozen_tables;
+  auto mid = std::next(tables_.begin(), num_searched_frozen_tables);
   for (Table::InternalTable& table : MakeIterationRange(tables_.begin(), mid)) {
     DCHECK(table.set_.FindWithHash(GcRoot<mirror::String>(s), hash) == table.set_.end());
   }
@@ -372,6 +394,33 @@ void InternTable::Table::AddNewTable() {
   InternalTable new_table;
   new_table.set_.SetLoadFactor(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   tables_.push_back(std::move(new_table));
+  PublishFrozenTables();
+}
+
+void InternTable::Table::PublishFrozenTables() {
+  DCHECK(!tables_.empty());
+  auto frozen_tables = std::make_unique<FrozenTables>();
+  frozen_tables->reserve(tables_.size() - 1u);
+  for (auto it = std::next(tables_.rbegin()), end = tables_.rend(); it != end; ++it) {
+    frozen_tables->push_back(&it->set_);
+  }
+  // Make the contents of the frozen tables visible to the lock-free readers along with the list.
+  frozen_tables_.store(frozen_tables.get(), std::memory_order_release);
+  published_frozen_tables_.push_back(std::move(frozen_tables));
+}
+
+template <typename Key>
+ObjPtr<mirror::String> InternTable::Table::FindInFrozenTables(const Key& key, uint32_t hash) {
+  const FrozenTables* frozen_tables = frozen_tables_.load(std::memory_order_acquire);
+  if (frozen_tables != nullptr) {
+    for (const UnorderedSet* set : *frozen_tables) {
+      auto it = set->FindWithHash(key, hash);
+      if (it != set->end()) {
+        return it->Read();
+      }
+    }
+  }
+  return nullptr;
 }
 
 void InternTable::Table::Insert(ObjPtr<mirror::String> s, uint32_t hash) {
@@ -436,7 +485,7 @@ void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   }
 }
 
-InternTable::Table::Table() {
+InternTable::Table::Table() : frozen_tables_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   InternalTable initial_table;
   initial_table.set_.SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
@@ -17,6 +17,11 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <atomic>
+#include <list>
+#include <memory>
+#include <vector>
+
 #include "base/allocator.h"
 #include "base/dchecked_vector.h"
 #include "base/hash_set.h"
@@ -242,6 +247,12 @@ class InternTable {
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     ObjPtr<mirror::String> Find(const Utf8String& string, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+    // Search only the frozen tables, without holding the intern table lock. Only valid for tables
+    // whose frozen tables are not swept, i.e. the strong interns. A null result is not definitive,
+    // the string may be in the last table or may have been concurrently moved by an erase.
+    template <typename Key>
+    ObjPtr<mirror::String> FindInFrozenTables(const Key& key, uint32_t hash)
+        REQUIRES_SHARED(Locks::mutator_lock_);
     void Insert(ObjPtr<mirror::String> s, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     void Remove(ObjPtr<mirror::String> s, uint32_t hash)
@@ -269,9 +280,21 @@ class InternTable {
     void AddInternStrings(UnorderedSet&& intern_strings, bool is_boot_image)
         REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+    // Publish the current list of frozen tables for FindInFrozenTables().
+    void PublishFrozenTables() REQUIRES(Locks::intern_table_lock_);
+
+    // Sets of the frozen tables in lookup order, i.e. from the most recently added one.
+    using FrozenTables = std::vector<const UnorderedSet*>;
+
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
-    dchecked_vector<InternalTable> tables_;
+    // A list is used so that the frozen tables never move, as they are read without the lock.
+    std::list<InternalTable> tables_;
+    // The frozen tables of `tables_`, read by FindInFrozenTables() without holding the lock.
+    std::atomic<const FrozenTables*> frozen_tables_;
+    // All the published frozen table lists. Lock-free readers may still be using the older ones,
+    // so they are only freed with the table.
+    std::vector<std::unique_ptr<const FrozenTables>> published_frozen_tables_;
 
     friend class InternTable;
     friend class linker::ImageWriter;
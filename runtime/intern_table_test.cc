@@ -263,4 +263,30 @@ TEST_F(InternTableTest, InternStrongFrozenWeak) {
   ASSERT_TRUE(strong_foo == foo.Get());
 }
 
+TEST_F(InternTableTest, InternStrongFrozen) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable intern_table;
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::String> foo(hs.NewHandle(intern_table.InternStrong(3, "foo")));
+  ASSERT_TRUE(foo != nullptr);
+
+  // Strings in frozen tables are found without the lock, from both kinds of keys.
+  intern_table.AddNewTable();
+  EXPECT_OBJ_PTR_EQ(intern_table.InternStrong(3, "foo"), foo.Get());
+  EXPECT_OBJ_PTR_EQ(intern_table.LookupStrong(soa.Self(), 3, "foo"), foo.Get());
+  Handle<mirror::String> foo_2(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "foo")));
+  ASSERT_TRUE(foo_2 != nullptr);
+  EXPECT_OBJ_PTR_EQ(intern_table.InternStrong(foo_2.Get()), foo.Get());
+  EXPECT_OBJ_PTR_EQ(intern_table.LookupStrong(soa.Self(), foo_2.Get()), foo.Get());
+
+  // New strings still go to the last table.
+  intern_table.AddNewTable();
+  EXPECT_TRUE(intern_table.LookupStrong(soa.Self(), 3, "bar") == nullptr);
+  ObjPtr<mirror::String> bar = intern_table.InternStrong(3, "bar");
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_OBJ_PTR_EQ(intern_table.LookupStrong(soa.Self(), 3, "bar"), bar);
+  EXPECT_EQ(intern_table.StrongSize(), 2u);
+}
+
 }  // namespace art
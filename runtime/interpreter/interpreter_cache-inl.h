@@ -25,11 +25,28 @@ namespace art {
 
 inline bool InterpreterCache::Get(Thread* self, const void* key, /* out */ size_t* value) {
   DCHECK(self->GetInterpreterCache() == this) << "Must be called from owning thread";
-  Entry& entry = data_[IndexOf(key)];
+  size_t index = IndexOf(key);
+  Entry& entry = data_[index];
   if (LIKELY(entry.first == key)) {
+    if (kCollectStatistics) {
+      ++primary_hits_;
+    }
     *value = entry.second;
     return true;
   }
+  Entry& second = second_way_[index];
+  if (second.first == key) {
+    if (kCollectStatistics) {
+      ++second_way_hits_;
+    }
+    *value = second.second;
+    // Move the entry to the primary way so that the assembly fast paths find it.
+    std::swap(entry, second);
+    return true;
+  }
+  if (kCollectStatistics) {
+    ++misses_;
+  }
   return false;
 }
 
@@ -37,7 +54,12 @@ inline void InterpreterCache::Set(Thread* self, const void* key, size_t value) {
   DCHECK(self->GetInterpreterCache() == this) << "Must be called from owning thread";
   // Simple store works here as the cache is always read/written by the owning
   // thread only (or in a stop-the-world pause).
-  data_[IndexOf(key)] = Entry{key, value};
+  size_t index = IndexOf(key);
+  Entry& entry = data_[index];
+  if (entry.first != key && entry.first != nullptr) {
+    second_way_[index] = entry;
+  }
+  entry = Entry{key, value};
 }
 
 }  // namespace art
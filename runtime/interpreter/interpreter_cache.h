@@ -42,6 +42,11 @@ class Thread;
 // We ensure consistency of the cache by clearing it
 // whenever any dex file is unloaded.
 //
+// The cache is two-way set-associative. The assembly fast paths only probe the
+// primary way (`data_`), entries evicted from it are kept in the second way and
+// moved back to the primary way on the next lookup from C++ code, so that
+// conflicting instructions of big methods do not need to be resolved again.
+//
 // Aligned to 16-bytes to make it easier to get the address of the cache
 // from assembly (it ensures that the offset is valid immediate value).
 class ALIGNED(16) InterpreterCache {
@@ -49,14 +54,19 @@ class ALIGNED(16) InterpreterCache {
   // Aligned since we load the whole entry in single assembly instruction.
   using Entry ALIGNED(2 * sizeof(size_t)) = std::pair<const void*, size_t>;
 
+  // Number of sets. Must be a power of two.
   // 2x size increase/decrease corresponds to ~0.5% interpreter performance change.
   // Value of 256 has around 75% cache hit rate.
   static constexpr size_t kSize = 256;
 
+  // Whether to count lookups for debugging the hit rate of the cache.
+  static constexpr bool kCollectStatistics = false;
+
   InterpreterCache() {
     // We can not use the Clear() method since the constructor will not
     // be called from the owning thread.
     data_.fill(Entry{});
+    second_way_.fill(Entry{});
   }
 
   // Clear the whole cache. It requires the owning thread for DCHECKs.
@@ -66,10 +76,20 @@ class ALIGNED(16) InterpreterCache {
 
   ALWAYS_INLINE void Set(Thread* self, const void* key, size_t value);
 
+  // Returns the primary way, which is the one probed by the assembly fast paths.
   std::array<Entry, kSize>& GetArray() {
     return data_;
   }
 
+  std::array<Entry, kSize>& GetSecondWayArray() {
+    return second_way_;
+  }
+
+  // Lookups from C++ code. Only updated if `kCollectStatistics` is true.
+  size_t GetPrimaryHits() const { return primary_hits_; }
+  size_t GetSecondWayHits() const { return second_way_hits_; }
+  size_t GetMisses() const { return misses_; }
+
  private:
   static ALWAYS_INLINE size_t IndexOf(const void* key) {
     static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
@@ -79,6 +99,13 @@ class ALIGNED(16) InterpreterCache {
   }
 
   std::array<Entry, kSize> data_;
+
+  // Entries evicted from `data_`, at the same index.
+  std::array<Entry, kSize> second_way_;
+
+  size_t primary_hits_ = 0u;
+  size_t second_way_hits_ = 0u;
+  size_t misses_ = 0u;
 };
 
 }  // namespace art
@@ -139,6 +139,9 @@ class InstructionHandler {
 
   // Code to run before each dex instruction.
   HANDLER_ATTRIBUTES bool Preamble() {
+    if (LIKELY(!shadow_frame_.GetForcePopFrameOrNotifyDexPcMoveEvents())) {
+      return true;
+    }
     /* We need to put this before & after the instrumentation to avoid having to put in a */
     /* post-script macro.                                                                 */
     if (!CheckForceReturn()) {
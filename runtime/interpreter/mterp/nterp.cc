@@ -50,6 +50,13 @@ inline void UpdateCache(Thread* self, const uint16_t* dex_pc_ptr, T* value) {
   UpdateCache(self, dex_pc_ptr, reinterpret_cast<size_t>(value));
 }
 
+// The assembly fast paths only look at the primary way of the cache. Check the
+// second way before resolving again: the cached values are the ones the slow
+// paths below would return.
+inline bool LookupCache(Thread* self, const uint16_t* dex_pc_ptr, /* out */ size_t* value) {
+  return self->GetInterpreterCache()->Get(self, dex_pc_ptr, value);
+}
+
 #ifdef __arm__
 
 extern "C" void NterpStoreArm32Fprs(const char* shorty,
@@ -235,6 +242,10 @@ FLATTEN
 extern "C" size_t NterpGetMethod(Thread* self, ArtMethod* caller, const uint16_t* dex_pc_ptr)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (LookupCache(self, dex_pc_ptr, &cached_value)) {
+    return cached_value;
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   Instruction::Code opcode = inst->Opcode();
   DCHECK(IsUint<8>(static_cast<std::underlying_type_t<Instruction::Code>>(opcode)));
@@ -310,6 +321,10 @@ extern "C" size_t NterpGetStaticField(Thread* self,
                                       size_t resolve_field_type)  // Resolve if not zero
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (LookupCache(self, dex_pc_ptr, &cached_value)) {
+    return cached_value;
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   uint16_t field_index = inst->VRegB_21c();
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -365,6 +380,10 @@ extern "C" uint32_t NterpGetInstanceFieldOffset(Thread* self,
                                                 size_t resolve_field_type)  // Resolve if not zero
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (LookupCache(self, dex_pc_ptr, &cached_value)) {
+    return dchecked_integral_cast<uint32_t>(cached_value);
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   uint16_t field_index = inst->VRegC_22c();
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -404,6 +423,10 @@ extern "C" uint32_t NterpGetInstanceFieldOffset(Thread* self,
 extern "C" mirror::Object* NterpGetClass(Thread* self, ArtMethod* caller, uint16_t* dex_pc_ptr)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (LookupCache(self, dex_pc_ptr, &cached_value)) {
+    return reinterpret_cast<mirror::Class*>(cached_value);
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   Instruction::Code opcode = inst->Opcode();
   DCHECK(opcode == Instruction::CHECK_CAST ||
@@ -474,6 +497,10 @@ extern "C" mirror::Object* NterpLoadObject(Thread* self, ArtMethod* caller, uint
     case Instruction::CONST_STRING:
     case Instruction::CONST_STRING_JUMBO: {
       UpdateHotness(caller);
+      size_t cached_value;
+      if (LookupCache(self, dex_pc_ptr, &cached_value)) {
+        return reinterpret_cast<mirror::String*>(cached_value);
+      }
       dex::StringIndex string_index(
           (inst->Opcode() == Instruction::CONST_STRING)
               ? inst->VRegB_21c()
@@ -625,7 +652,8 @@ extern "C" jit::OsrData* NterpHotMethod(ArtMethod* method, uint16_t* dex_pc_ptr,
         return osr_data;
       }
     }
-    jit->MaybeEnqueueCompilation(method, Thread::Current());
+    bool from_back_edge = dex_pc_ptr != nullptr;
+    jit->MaybeEnqueueCompilation(method, Thread::Current(), from_back_edge);
   }
   return nullptr;
 }
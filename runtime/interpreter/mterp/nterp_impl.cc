@@ -27,8 +27,7 @@ namespace art {
 namespace interpreter {
 
 bool IsNterpSupported() {
-  return !kPoisonHeapReferences && kReserveMarkingRegister &&
-         kRuntimeISA != InstructionSet::kRiscv64;
+  return !kPoisonHeapReferences && kReserveMarkingRegister;
 }
 
 bool CanRuntimeUseNterp() REQUIRES_SHARED(Locks::mutator_lock_) {
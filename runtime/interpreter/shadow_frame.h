@@ -388,6 +388,13 @@ class ShadowFrame {
     UpdateFrameFlag(enable, FrameFlags::kNotifyDexPcMoveEvents);
   }
 
+  // Returns whether the interpreter needs to check for a forced pop or send a dex pc move event
+  // before the next instruction. Both flags are tested with a single load and branch.
+  bool GetForcePopFrameOrNotifyDexPcMoveEvents() const {
+    return (frame_flags_ & (static_cast<uint32_t>(FrameFlags::kForcePopFrame) |
+                            static_cast<uint32_t>(FrameFlags::kNotifyDexPcMoveEvents))) != 0u;
+  }
+
   void CheckConsistentVRegs() const {
     if (kIsDebugBuild) {
       // A shadow frame visible to GC requires the following rule: for a given vreg,
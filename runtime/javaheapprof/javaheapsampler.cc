@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 
+#include <random>
+
 #include "base/atomic.h"
 #include "base/locks.h"
+#include "base/utils.h"
 #include "gc/heap.h"
 #include "javaheapprof/javaheapsampler.h"
 #ifdef ART_TARGET_ANDROID
@@ -26,9 +29,17 @@
 namespace art {
 
 size_t HeapSampler::NextGeoDistRandSample() {
-  // Make sure that rng_ and geo_dist are thread safe by acquiring a lock to access.
-  art::MutexLock mu(art::Thread::Current(), geo_dist_rng_lock_);
-  size_t nsample = geo_dist_(rng_);
+  // Seed each thread differently so that threads do not sample in lockstep.
+  thread_local std::minstd_rand rng(/*seed=*/std::minstd_rand::default_seed + art::GetTid());
+  thread_local std::geometric_distribution</*result_type=*/size_t> geo_dist;
+  thread_local int geo_dist_interval = 0;
+  int sampling_interval = GetSamplingInterval();
+  if (UNLIKELY(geo_dist_interval != sampling_interval)) {
+    // The sampling interval changed since this thread last took a sample.
+    geo_dist.param(std::geometric_distribution<size_t>::param_type(1.0 / sampling_interval));
+    geo_dist_interval = sampling_interval;
+  }
+  size_t nsample = geo_dist(rng);
   if (nsample == 0) {
     // Geometric distribution results in +ve values but could have zero.
     // In the zero case, return 1.
@@ -140,10 +151,8 @@ int HeapSampler::GetSamplingInterval() {
 }
 
 void HeapSampler::SetSamplingInterval(int sampling_interval) {
-  // Make sure that rng_ and geo_dist are thread safe by acquiring a lock to access.
-  art::MutexLock mu(art::Thread::Current(), geo_dist_rng_lock_);
+  // Threads pick up the new interval the next time they take a sample.
   p_sampling_interval_.store(sampling_interval, std::memory_order_release);
-  geo_dist_.param(std::geometric_distribution<size_t>::param_type(1.0/p_sampling_interval_));
 }
 
 }  // namespace art
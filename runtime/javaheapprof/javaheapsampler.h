@@ -17,19 +17,14 @@
 #ifndef ART_RUNTIME_JAVAHEAPPROF_JAVAHEAPSAMPLER_H_
 #define ART_RUNTIME_JAVAHEAPPROF_JAVAHEAPSAMPLER_H_
 
-#include <random>
-#include "base/locks.h"
-#include "base/mutex.h"
+#include <atomic>
 #include "mirror/object.h"
 
 namespace art {
 
 class HeapSampler {
  public:
-  HeapSampler() : rng_(/*seed=*/std::minstd_rand::default_seed),
-                  geo_dist_(1.0 / /*expected value=4KB*/ 4096),
-                  geo_dist_rng_lock_("Heap Sampler RNG Geometric Dist lock",
-                                     art::LockLevel::kGenericBottomLock) {}
+  HeapSampler() {}
 
   // Set the bytes until sample.
   void SetBytesUntilSample(size_t bytes) {
@@ -63,35 +58,29 @@ class HeapSampler {
   size_t GetSampleOffset(size_t alloc_size,
                          size_t tlab_used,
                          bool* take_sample,
-                         size_t* temp_bytes_until_sample) REQUIRES(!geo_dist_rng_lock_);
+                         size_t* temp_bytes_until_sample);
   // Adjust the sample offset value with the adjustment usually (pos - start)
   // of new Tlab after Reset.
   void AdjustSampleOffset(size_t adjustment);
   // Is heap sampler enabled?
   bool IsEnabled();
   // Set the sampling interval.
-  void SetSamplingInterval(int sampling_interval) REQUIRES(!geo_dist_rng_lock_);
+  void SetSamplingInterval(int sampling_interval);
   // Return the sampling interval.
   int GetSamplingInterval();
 
  private:
-  size_t NextGeoDistRandSample() REQUIRES(!geo_dist_rng_lock_);
+  // Pick a sample interval from a geometric distribution. The random number generator and the
+  // distribution are thread local, so that taking a sample does not contend on a lock.
+  size_t NextGeoDistRandSample();
   // Choose, save, and return the number of bytes until the next sample,
   // possibly decreasing sample intervals by sample_adj_bytes.
-  size_t PickAndAdjustNextSample(size_t sample_adj_bytes = 0) REQUIRES(!geo_dist_rng_lock_);
+  size_t PickAndAdjustNextSample(size_t sample_adj_bytes = 0);
 
   std::atomic<bool> enabled_;
   // Default sampling interval is 4kb.
-  // Writes guarded by geo_dist_rng_lock_.
   std::atomic<int> p_sampling_interval_{4 * 1024};
   uint32_t perfetto_heap_id_ = 0;
-  // std random number generator.
-  std::minstd_rand rng_ GUARDED_BY(geo_dist_rng_lock_);  // Holds the state
-  // std geometric distribution
-  std::geometric_distribution</*result_type=*/size_t> geo_dist_ GUARDED_BY(geo_dist_rng_lock_);
-  // Multiple threads can access the geometric distribution and the random number
-  // generator concurrently and thus geo_dist_rng_lock_ is used for thread safety.
-  art::Mutex geo_dist_rng_lock_;
 };
 
 }  // namespace art
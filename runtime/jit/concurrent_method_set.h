@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_CONCURRENT_METHOD_SET_H_
+#define ART_RUNTIME_JIT_CONCURRENT_METHOD_SET_H_
+
+#include <array>
+#include <stdint.h>
+
+#include <android-base/logging.h>
+
+#include "base/atomic.h"
+#include "base/bit_utils.h"
+#include "base/macros.h"
+#include "compilation_kind.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace jit {
+
+// A fixed size open addressing hash set of (method, compilation kind) pairs, which can be
+// queried without holding a lock. Insertions and removals must be serialized by the caller,
+// but can race with `Contains`.
+//
+// The set may fail to record an element when it is too crowded, so a `false` answer from
+// `Contains` is not authoritative: users keep the exact set under a lock and only use this
+// one to avoid taking the lock in the common case of a positive answer.
+class ConcurrentMethodSet {
+ public:
+  ConcurrentMethodSet() {
+    for (Atomic<uintptr_t>& slot : slots_) {
+      slot.store(kEmpty, std::memory_order_relaxed);
+    }
+  }
+
+  // Return whether the pair was recorded.
+  bool Insert(ArtMethod* method, CompilationKind kind) {
+    uintptr_t key = MakeKey(method, kind);
+    size_t index = Hash(key);
+    for (size_t i = 0; i != kMaxProbes; ++i, index = (index + 1u) & (kCapacity - 1u)) {
+      uintptr_t value = slots_[index].load(std::memory_order_relaxed);
+      DCHECK_NE(value, key);
+      if (value == kEmpty || value == kRemoved) {
+        slots_[index].store(key, std::memory_order_release);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Remove(ArtMethod* method, CompilationKind kind) {
+    uintptr_t key = MakeKey(method, kind);
+    size_t index = Hash(key);
+    for (size_t i = 0; i != kMaxProbes; ++i, index = (index + 1u) & (kCapacity - 1u)) {
+      uintptr_t value = slots_[index].load(std::memory_order_relaxed);
+      if (value == key) {
+        slots_[index].store(kRemoved, std::memory_order_release);
+        return;
+      }
+      if (value == kEmpty) {
+        return;
+      }
+    }
+  }
+
+  bool Contains(ArtMethod* method, CompilationKind kind) const {
+    uintptr_t key = MakeKey(method, kind);
+    size_t index = Hash(key);
+    for (size_t i = 0; i != kMaxProbes; ++i, index = (index + 1u) & (kCapacity - 1u)) {
+      uintptr_t value = slots_[index].load(std::memory_order_acquire);
+      if (value == key) {
+        return true;
+      }
+      if (value == kEmpty) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+ private:
+  static constexpr size_t kCapacity = 1024u;
+  static constexpr size_t kMaxProbes = 16u;
+  static constexpr uintptr_t kEmpty = 0u;
+  static constexpr uintptr_t kRemoved = 1u;
+  static_assert(IsPowerOfTwo(kCapacity));
+  static_assert(static_cast<uintptr_t>(CompilationKind::kOptimized) < 4u);
+
+  // The compilation kind is stored in the low bits of the method pointer, which are zero as
+  // ArtMethods are at least 4-byte aligned.
+  static uintptr_t MakeKey(ArtMethod* method, CompilationKind kind) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(method);
+    DCHECK_NE(address, 0u);
+    DCHECK_ALIGNED(address, 4u);
+    return address | static_cast<uintptr_t>(kind);
+  }
+
+  static size_t Hash(uintptr_t key) {
+    // Fibonacci hashing, the low bits of the method pointers are not well distributed.
+    return static_cast<size_t>((key * UINT64_C(0x9e3779b97f4a7c15)) >> 32) & (kCapacity - 1u);
+  }
+
+  std::array<Atomic<uintptr_t>, kCapacity> slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentMethodSet);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_CONCURRENT_METHOD_SET_H_
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/concurrent_method_set.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace art {
+namespace jit {
+
+// The set never dereferences the methods, fake ones are enough.
+static ArtMethod* FakeMethod(size_t index) {
+  return reinterpret_cast<ArtMethod*>(static_cast<uintptr_t>(0x10000u + index * 32u));
+}
+
+TEST(ConcurrentMethodSet, InsertAndRemove) {
+  ConcurrentMethodSet set;
+  ArtMethod* method = FakeMethod(1u);
+  EXPECT_FALSE(set.Contains(method, CompilationKind::kBaseline));
+
+  EXPECT_TRUE(set.Insert(method, CompilationKind::kBaseline));
+  EXPECT_TRUE(set.Contains(method, CompilationKind::kBaseline));
+  EXPECT_FALSE(set.Contains(method, CompilationKind::kOptimized));
+  EXPECT_FALSE(set.Contains(method, CompilationKind::kOsr));
+  EXPECT_FALSE(set.Contains(FakeMethod(2u), CompilationKind::kBaseline));
+
+  EXPECT_TRUE(set.Insert(method, CompilationKind::kOsr));
+  set.Remove(method, CompilationKind::kBaseline);
+  EXPECT_FALSE(set.Contains(method, CompilationKind::kBaseline));
+  EXPECT_TRUE(set.Contains(method, CompilationKind::kOsr));
+}
+
+TEST(ConcurrentMethodSet, ManyMethods) {
+  ConcurrentMethodSet set;
+  static constexpr size_t kNumberOfMethods = 2048u;
+  std::vector<bool> inserted(kNumberOfMethods);
+  size_t number_inserted = 0u;
+  for (size_t i = 0; i != kNumberOfMethods; ++i) {
+    inserted[i] = set.Insert(FakeMethod(i), CompilationKind::kOptimized);
+    number_inserted += inserted[i] ? 1u : 0u;
+  }
+  // The set is bounded, but records most of the methods that fit.
+  EXPECT_GT(number_inserted, kNumberOfMethods / 4u);
+  EXPECT_LT(number_inserted, kNumberOfMethods);
+  for (size_t i = 0; i != kNumberOfMethods; ++i) {
+    EXPECT_EQ(inserted[i], set.Contains(FakeMethod(i), CompilationKind::kOptimized));
+  }
+
+  // Removed entries can be reused.
+  for (size_t i = 0; i != kNumberOfMethods; ++i) {
+    if (inserted[i]) {
+      set.Remove(FakeMethod(i), CompilationKind::kOptimized);
+      EXPECT_FALSE(set.Contains(FakeMethod(i), CompilationKind::kOptimized));
+    }
+  }
+  for (size_t i = 0; i != kNumberOfMethods / 16u; ++i) {
+    EXPECT_TRUE(set.Insert(FakeMethod(i), CompilationKind::kBaseline));
+    EXPECT_TRUE(set.Contains(FakeMethod(i), CompilationKind::kBaseline));
+  }
+}
+
+}  // namespace jit
+}  // namespace art
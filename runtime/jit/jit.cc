@@ -18,6 +18,9 @@
 
 #include <dlfcn.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
@@ -26,10 +29,13 @@
 #include "base/memory_tool.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "gc/space/image_space.h"
 #include "entrypoints/entrypoint_utils-inl.h"
@@ -91,6 +97,16 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_profiled_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseProfiledJitCompilation);
 
+  jit_options->precompile_app_profile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPrecompileAppProfile);
+  jit_options->verify_app_profile_classes_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITVerifyAppProfileClasses);
+  jit_options->adaptive_optimize_threshold_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITAdaptiveOptimizeThreshold);
+  if (options.Exists(RuntimeArgumentMap::JITZygoteAppProfiles)) {
+    jit_options->zygote_app_profiles_ = *options.Get(RuntimeArgumentMap::JITZygoteAppProfiles);
+  }
+
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
   jit_options->code_cache_max_capacity_ =
@@ -103,6 +119,14 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  if (options.Exists(RuntimeArgumentMap::JITPoolThreads)) {
+    jit_options->thread_pool_size_ =
+        std::max(*options.Get(RuntimeArgumentMap::JITPoolThreads), 1u);
+  } else {
+    // Use a quarter of the cores, leaving most of them to the application threads.
+    jit_options->thread_pool_size_ = std::clamp<size_t>(
+        std::thread::hardware_concurrency() / 4u, 1u, kJitMaxDefaultPoolThreads);
+  }
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ =
@@ -324,12 +348,17 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
+  uint64_t start_ns = ThreadCpuNanoTime();
   bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, compilation_kind);
+  uint64_t compile_time_ns = ThreadCpuNanoTime() - start_ns;
   code_cache_->DoneCompiling(method_to_compile, self);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
               << " kind=" << compilation_kind;
+  } else if (compilation_kind == CompilationKind::kBaseline &&
+             options_->UseAdaptiveOptimizeThreshold()) {
+    UpdateOptimizeThreshold(method_to_compile, self, compile_time_ns);
   }
   if (kIsDebugBuild) {
     if (self->IsExceptionPending()) {
@@ -457,8 +486,10 @@ OsrData* Jit::PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs)
   }
 
   // Cheap check if the method has been compiled already. That's an indicator that we should
-  // osr into it.
-  if (!GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+  // osr into it. The OSR code of a method first hot in a loop can also be ready before its
+  // regular compiled code, see `MaybeEnqueueCompilation()`.
+  if (!GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode()) &&
+      !GetCodeCache()->IsOsrCompiled(method)) {
     return nullptr;
   }
 
@@ -764,6 +795,11 @@ class ScopedCompilation {
         method_(method),
         compilation_kind_(compilation_kind),
         owns_compilation_(true) {
+    // Avoid contending on the jit lock when many threads find the same method hot.
+    if (jit_->GetCodeCache()->IsMethodKnownToBeCompiled(method_, compilation_kind_)) {
+      owns_compilation_ = false;
+      return;
+    }
     MutexLock mu(Thread::Current(), *Locks::jit_lock_);
     // We don't want to enqueue any new tasks when thread pool has stopped. This simplifies
     // the implementation of redefinition feature in jvmti.
@@ -808,11 +844,36 @@ class JitCompileTask final : public Task {
       : method_(method),
         kind_(task_kind),
         compilation_kind_(compilation_kind),
-        scoped_compilation_(std::move(sc)) {
+        scoped_compilation_(std::move(sc)),
+        requests_(1u) {
     DCHECK(scoped_compilation_.OwnsCompilation());
     DCHECK(!sc.OwnsCompilation());
   }
 
+  ArtMethod* GetMethod() const {
+    return method_;
+  }
+
+  CompilationKind GetCompilationKind() const {
+    return compilation_kind_;
+  }
+
+  // Records that the method became hot again while waiting to be compiled.
+  void AddRequest() {
+    ++requests_;
+  }
+
+  // Returns whether this task should run before `other`. OSR compilations come first, as a
+  // thread is executing a loop of the method in the interpreter, then the hottest methods.
+  bool HasPriorityOver(const JitCompileTask& other) const {
+    bool is_osr = compilation_kind_ == CompilationKind::kOsr;
+    bool other_is_osr = other.compilation_kind_ == CompilationKind::kOsr;
+    if (is_osr != other_is_osr) {
+      return is_osr;
+    }
+    return requests_ > other.requests_;
+  }
+
   void Run(Thread* self) override {
     {
       ScopedObjectAccess soa(self);
@@ -840,10 +901,47 @@ class JitCompileTask final : public Task {
   const TaskKind kind_;
   const CompilationKind compilation_kind_;
   ScopedCompilation scoped_compilation_;
+  // Number of times the method was requested to be compiled, used as a measure of its hotness.
+  uint32_t requests_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
+/**
+ * A thread pool task running the pending compile task with the highest priority. This lets
+ * the bursts of compilation requests, e.g. at startup, be reordered while they wait.
+ */
+class JitPendingCompileTask final : public Task {
+ public:
+  explicit JitPendingCompileTask(Jit* jit) : jit_(jit), has_run_(false) {}
+
+  void Run(Thread* self) override {
+    has_run_ = true;
+    JitCompileTask* task = jit_->TakeHottestCompileTask(self);
+    if (task != nullptr) {
+      task->Run(self);
+      task->Finalize();
+    }
+  }
+
+  void Finalize() override {
+    if (!has_run_) {
+      // The thread pool is discarding its tasks, discard a pending compile task as well.
+      JitCompileTask* task = jit_->TakeHottestCompileTask(Thread::Current());
+      if (task != nullptr) {
+        task->Finalize();
+      }
+    }
+    delete this;
+  }
+
+ private:
+  Jit* const jit_;
+  bool has_run_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitPendingCompileTask);
+};
+
 static std::string GetProfileFile(const std::string& dex_location) {
   // Hardcoded assumption where the profile file is.
   // TODO(ngeoffray): this is brittle and we would need to change change if we
@@ -986,6 +1084,23 @@ class ZygoteTask final : public Task {
             self, boot_class_path, profile_file, null_handle, /* add_to_queue= */ true);
       }
     }
+    if (runtime->IsPrimaryZygote()) {
+      // Also compile the boot classpath methods recorded in the startup profiles of the most
+      // launched apps, so that the children find them in the shared zygote map instead of
+      // compiling them right after fork, competing with the app startup.
+      const std::vector<const DexFile*>& boot_class_path =
+          runtime->GetClassLinker()->GetBootClassPath();
+      ScopedNullHandle<mirror::ClassLoader> null_handle;
+      for (const std::string& profile_file : runtime->GetJit()->GetZygoteAppProfiles()) {
+        LOG(INFO) << "JIT Zygote looking at app profile " << profile_file;
+        added_to_queue += runtime->GetJit()->CompileMethodsFromProfile(self,
+                                                                       boot_class_path,
+                                                                       profile_file,
+                                                                       null_handle,
+                                                                       /* add_to_queue= */ true,
+                                                                       /* is_app_profile= */ true);
+      }
+    }
     DCHECK(runtime->GetJit()->InZygoteUsingJit());
     runtime->GetJit()->AddPostBootTask(self, new JitZygoteDoneCompilingTask());
 
@@ -1062,6 +1177,222 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+std::vector<const DexFile*> Jit::FindAppDexFiles(Thread* self,
+                                                 const std::vector<std::string>& code_paths) {
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  std::vector<const DexFile*> app_dex_files;
+  ReaderMutexLock mu(self, *Locks::dex_lock_);
+  for (const auto& entry : class_linker->GetDexCachesData()) {
+    const DexFile* dex_file = entry.first;
+    std::string base_location = DexFileLoader::GetBaseLocation(dex_file->GetLocation());
+    if (ContainsElement(code_paths, base_location)) {
+      app_dex_files.push_back(dex_file);
+    }
+  }
+  return app_dex_files;
+}
+
+size_t Jit::VerifyLoadedClasses(Thread* self,
+                                const DexFile& dex_file,
+                                const std::vector<dex::TypeIndex>& class_types,
+                                Handle<mirror::ClassLoader> class_loader) {
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  StackHandleScope<2> hs(self);
+  Handle<mirror::DexCache> dex_cache = hs.NewHandle(class_linker->FindDexCache(self, dex_file));
+  MutableHandle<mirror::Class> klass = hs.NewHandle<mirror::Class>(nullptr);
+  size_t number_of_classes = 0u;
+  for (dex::TypeIndex type_index : class_types) {
+    // Do not load classes from a JIT thread, this would run class loader code and define classes
+    // on the wrong thread. Classes the app has not loaded yet are left for the mutator.
+    klass.Assign(class_linker->LookupResolvedType(type_index, dex_cache.Get(), class_loader.Get()));
+    if (klass == nullptr || !klass->IsResolved() || klass->IsVerified() || klass->IsErroneous()) {
+      continue;
+    }
+    if (class_linker->VerifyClass(self, /* verifier_deps= */ nullptr, klass) ==
+            verifier::FailureKind::kHardFailure) {
+      // The class is now erroneous, initializing it will throw.
+      DCHECK(self->IsExceptionPending());
+      self->ClearException();
+    } else {
+      ++number_of_classes;
+    }
+    DCHECK(!self->IsExceptionPending());
+  }
+  return number_of_classes;
+}
+
+/**
+ * A JIT task to compile the methods of the profile recorded by the profile saver
+ * during the previous runs of an app, so that a restarted app does not have to warm
+ * up the JIT again.
+ */
+class JitAppProfileTask final : public SelfDeletingTask {
+ public:
+  JitAppProfileTask(const std::string& profile_filename,
+                    const std::vector<std::string>& code_paths)
+      : profile_filename_(profile_filename), code_paths_(code_paths) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    std::vector<const DexFile*> app_dex_files = Jit::FindAppDexFiles(self, code_paths_);
+
+    // Split APKs may be loaded by different class loaders, compile the dex files of
+    // each class loader together.
+    Jit* jit = Runtime::Current()->GetJit();
+    StackHandleScope<1> hs(self);
+    MutableHandle<mirror::ClassLoader> loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+    while (!app_dex_files.empty()) {
+      loader.Assign(GetClassLoader(self, class_linker, app_dex_files.back()));
+      std::vector<const DexFile*> dex_files;
+      for (auto it = app_dex_files.begin(); it != app_dex_files.end();) {
+        if (GetClassLoader(self, class_linker, *it) == loader.Get()) {
+          dex_files.push_back(*it);
+          it = app_dex_files.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      if (loader != nullptr) {
+        // The profile references the dex files with their checksums, so a profile of an
+        // older version of the app does not match the dex files and is ignored.
+        jit->CompileMethodsFromProfile(
+            self, dex_files, profile_filename_, loader, /* add_to_queue= */ true);
+      }
+    }
+  }
+
+ private:
+  static ObjPtr<mirror::ClassLoader> GetClassLoader(Thread* self,
+                                                    ClassLinker* class_linker,
+                                                    const DexFile* dex_file)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    return class_linker->FindDexCache(self, *dex_file)->GetClassLoader();
+  }
+
+  const std::string profile_filename_;
+  const std::vector<std::string> code_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitAppProfileTask);
+};
+
+/**
+ * A JIT task to verify the classes of a dex file that the profile of the app
+ * recorded during its previous runs, so that the threads initializing them at
+ * startup find them already verified.
+ */
+class JitVerifyClassesTask final : public SelfDeletingTask {
+ public:
+  JitVerifyClassesTask(const DexFile* dex_file,
+                       std::vector<dex::TypeIndex>&& class_types,
+                       jobject class_loader)
+      : dex_file_(dex_file), class_types_(std::move(class_types)), class_loader_(class_loader) {}
+
+  void Run(Thread* self) override {
+    // Like for the zygote verification, give up if the thread cannot load classes.
+    if (!self->CanLoadClasses()) {
+      return;
+    }
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(self);
+    Handle<mirror::ClassLoader> loader =
+        hs.NewHandle(soa.Decode<mirror::ClassLoader>(class_loader_));
+    uint64_t start_ns = ThreadCpuNanoTime();
+    size_t number_of_classes = Jit::VerifyLoadedClasses(self, *dex_file_, class_types_, loader);
+    VLOG(jit) << "Background verification of " << number_of_classes << " classes of "
+              << dex_file_->GetLocation() << " took "
+              << PrettyDuration(ThreadCpuNanoTime() - start_ns);
+  }
+
+  ~JitVerifyClassesTask() {
+    ScopedObjectAccess soa(Thread::Current());
+    soa.Vm()->DeleteGlobalRef(soa.Self(), class_loader_);
+  }
+
+ private:
+  const DexFile* const dex_file_;
+  const std::vector<dex::TypeIndex> class_types_;
+  const jobject class_loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitVerifyClassesTask);
+};
+
+/**
+ * A JIT task to read the classes of the profile recorded by the profile saver during
+ * the previous runs of an app, and spread their verification over the JIT thread pool,
+ * one task per dex file.
+ */
+class JitAppVerificationTask final : public SelfDeletingTask {
+ public:
+  JitAppVerificationTask(const std::string& profile_filename,
+                         const std::vector<std::string>& code_paths)
+      : profile_filename_(profile_filename), code_paths_(code_paths) {}
+
+  void Run(Thread* self) override {
+    ProfileCompilationInfo profile_info;
+    if (!profile_info.Load(profile_filename_, /* clear_if_invalid= */ false)) {
+      return;
+    }
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    ThreadPool* thread_pool = Runtime::Current()->GetJit()->GetThreadPool();
+    ScopedObjectAccess soa(self);
+    for (const DexFile* dex_file : Jit::FindAppDexFiles(self, code_paths_)) {
+      // The profile references the dex files with their checksums, so a profile of an
+      // older version of the app does not match the dex files and is ignored.
+      const ArenaSet<dex::TypeIndex>* classes = profile_info.GetClasses(*dex_file);
+      if (classes == nullptr || classes->empty()) {
+        continue;
+      }
+      std::vector<dex::TypeIndex> class_types;
+      for (dex::TypeIndex type_index : *classes) {
+        // Skip the classes the profile references by descriptor only.
+        if (type_index.index_ < dex_file->NumTypeIds()) {
+          class_types.push_back(type_index);
+        }
+      }
+      ObjPtr<mirror::ClassLoader> loader =
+          class_linker->FindDexCache(self, *dex_file)->GetClassLoader();
+      if (loader == nullptr || class_types.empty()) {
+        continue;
+      }
+      jobject class_loader = soa.Vm()->AddGlobalRef(self, loader);
+      thread_pool->AddTask(
+          self, new JitVerifyClassesTask(dex_file, std::move(class_types), class_loader));
+    }
+  }
+
+ private:
+  const std::string profile_filename_;
+  const std::vector<std::string> code_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitAppVerificationTask);
+};
+
+void Jit::PrecompileMethodsFromAppProfile(const std::string& profile_filename,
+                                          const std::vector<std::string>& code_paths) {
+  Runtime* runtime = Runtime::Current();
+  if (!options_->PrecompileAppProfile() ||
+      thread_pool_ == nullptr ||
+      runtime->IsZygote() ||
+      runtime->IsJavaDebuggable()) {
+    return;
+  }
+  thread_pool_->AddTask(Thread::Current(), new JitAppProfileTask(profile_filename, code_paths));
+}
+
+void Jit::VerifyClassesFromAppProfile(const std::string& profile_filename,
+                                      const std::vector<std::string>& code_paths) {
+  Runtime* runtime = Runtime::Current();
+  if (!options_->VerifyAppProfileClasses() ||
+      thread_pool_ == nullptr ||
+      runtime->IsZygote() ||
+      runtime->IsJavaDebuggable()) {
+    return;
+  }
+  thread_pool_->AddTask(Thread::Current(),
+                        new JitAppVerificationTask(profile_filename, code_paths));
+}
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1203,9 +1534,11 @@ void Jit::CreateThreadPool() {
 
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(
+      new ThreadPool("Jit thread pool", options_->GetThreadPoolSize(), kJitPoolNeedsPeers));
 
   Runtime* runtime = Runtime::Current();
+  thread_pool_->SetMaxActiveWorkers(GetNumberOfActiveWorkers());
   thread_pool_->SetPthreadPriority(
       runtime->IsZygote()
           ? options_->GetZygoteThreadPoolPthreadPriority()
@@ -1336,13 +1669,51 @@ void Jit::AddCompileTask(Thread* self,
                          bool precompile) {
   ScopedCompilation sc(this, method, compilation_kind);
   if (!sc.OwnsCompilation()) {
+    // The method may already be waiting for a jit thread, mark it hotter. This is only a
+    // scheduling hint, so do not wait for the lock if other threads are holding it.
+    if (!lock_.ExclusiveTryLock(self)) {
+      return;
+    }
+    for (JitCompileTask* task : pending_compile_tasks_) {
+      if (task->GetMethod() == method && task->GetCompilationKind() == compilation_kind) {
+        task->AddRequest();
+        break;
+      }
+    }
+    lock_.ExclusiveUnlock(self);
     return;
   }
   JitCompileTask::TaskKind task_kind = precompile
       ? JitCompileTask::TaskKind::kPreCompile
       : JitCompileTask::TaskKind::kCompile;
-  thread_pool_->AddTask(
-      self, new JitCompileTask(method, task_kind, compilation_kind, std::move(sc)));
+  {
+    MutexLock mu(self, lock_);
+    pending_compile_tasks_.push_back(
+        new JitCompileTask(method, task_kind, compilation_kind, std::move(sc)));
+  }
+  thread_pool_->AddTask(self, new JitPendingCompileTask(this));
+}
+
+JitCompileTask* Jit::TakeHottestCompileTask(Thread* self) {
+  MutexLock mu(self, lock_);
+  if (pending_compile_tasks_.empty()) {
+    return nullptr;
+  }
+  // Ties keep the order of the requests.
+  auto it = pending_compile_tasks_.begin();
+  for (auto current = it + 1; current != pending_compile_tasks_.end(); ++current) {
+    if ((*current)->HasPriorityOver(**it)) {
+      it = current;
+    }
+  }
+  JitCompileTask* task = *it;
+  pending_compile_tasks_.erase(it);
+  return task;
+}
+
+size_t Jit::GetNumberOfActiveWorkers() const {
+  // The zygote compiles in the background, keep its jit thread alone.
+  return Runtime::Current()->IsZygote() ? 1u : options_->GetThreadPoolSize();
 }
 
 bool Jit::CompileMethodFromProfile(Thread* self,
@@ -1444,7 +1815,8 @@ uint32_t Jit::CompileMethodsFromProfile(
     const std::vector<const DexFile*>& dex_files,
     const std::string& profile_file,
     Handle<mirror::ClassLoader> class_loader,
-    bool add_to_queue) {
+    bool add_to_queue,
+    bool is_app_profile) {
 
   if (profile_file.empty()) {
     LOG(WARNING) << "Expected a profile file in JIT zygote mode";
@@ -1460,8 +1832,19 @@ uint32_t Jit::CompileMethodsFromProfile(
     return 0u;
   }
 
-  ProfileCompilationInfo profile_info(/* for_boot_image= */ class_loader.IsNull());
-  if (!profile_info.Load(profile.Fd())) {
+  ProfileCompilationInfo profile_info(
+      /* for_boot_image= */ class_loader.IsNull() && !is_app_profile);
+  // Only keep the data of the dex files we compile for. Boot profiles cover the whole boot
+  // class path, while we are usually called for a subset of it.
+  auto filter_fn = [&dex_files](const std::string& profile_key ATTRIBUTE_UNUSED,
+                                uint32_t checksum) {
+    return std::any_of(dex_files.begin(),
+                       dex_files.end(),
+                       [checksum](const DexFile* dex_file) {
+                         return dex_file->GetLocationChecksum() == checksum;
+                       });
+  };
+  if (!profile_info.Load(profile.Fd(), /* merge_classes= */ true, filter_fn)) {
     LOG(ERROR) << "Could not load profile file";
     return 0u;
   }
@@ -1524,6 +1907,32 @@ bool Jit::IgnoreSamplesForMethod(ArtMethod* method) REQUIRES_SHARED(Locks::mutat
   return false;
 }
 
+void Jit::UpdateOptimizeThreshold(ArtMethod* method, Thread* self, uint64_t compile_time_ns) {
+  // Wait for a few compilations before trusting the average.
+  static constexpr uint64_t kMinCompilationsForAverage = 16u;
+  // Hot methods still need to reach a fraction of the default threshold.
+  static constexpr uint32_t kMaxThresholdReduction = 8u;
+  uint64_t average_ns;
+  {
+    MutexLock mu(self, lock_);
+    baseline_compile_time_ns_ += compile_time_ns;
+    ++baseline_compile_count_;
+    if (baseline_compile_count_ < kMinCompilationsForAverage) {
+      return;
+    }
+    average_ns = baseline_compile_time_ns_ / baseline_compile_count_;
+  }
+  // The cost of the optimized compilation grows with the cost of the baseline one, while the
+  // benefit grows with the hotness. The default threshold is already the maximum, so only
+  // methods cheaper than average get their threshold lowered.
+  uint32_t default_threshold = options_->GetOptimizeThreshold();
+  uint64_t threshold = (average_ns == 0u)
+      ? default_threshold
+      : std::min<uint64_t>(default_threshold, default_threshold * compile_time_ns / average_ns);
+  threshold = std::max<uint64_t>(threshold, default_threshold / kMaxThresholdReduction);
+  GetCodeCache()->SetOptimizeThreshold(method, self, dchecked_integral_cast<uint16_t>(threshold));
+}
+
 void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // Reset the hotness counter so the baseline compiled code doesn't call this
   // method repeatedly.
@@ -1716,6 +2125,7 @@ void Jit::PostZygoteFork() {
     CHECK(code_cache_->GetZygoteMap()->IsCompilationNotified());
   }
   thread_pool_->CreateThreads();
+  thread_pool_->SetMaxActiveWorkers(GetNumberOfActiveWorkers());
   thread_pool_->SetPthreadPriority(
       runtime->IsZygote()
           ? options_->GetZygoteThreadPoolPthreadPriority()
@@ -1773,7 +2183,7 @@ bool Jit::CanAssumeInitialized(ObjPtr<mirror::Class> cls, bool is_for_shared_reg
   }
 }
 
-void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
+void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self, bool from_back_edge) {
   if (thread_pool_ == nullptr) {
     return;
   }
@@ -1832,6 +2242,13 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
   } else {
     AddCompileTask(self, method, CompilationKind::kOptimized);
   }
+
+  if (kEnableOnStackReplacement && from_back_edge && !method->IsNative()) {
+    // The interpreter is running a hot loop of a method that has no compiled code yet, and
+    // may stay in that loop for a long time. Compile for OSR right away instead of
+    // waiting for the loop to become hot again once the method is compiled.
+    AddCompileTask(self, method, CompilationKind::kOsr);
+  }
 }
 
 bool Jit::CompileMethod(ArtMethod* method,
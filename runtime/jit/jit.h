@@ -25,6 +25,7 @@
 #include "base/runtime_debug.h"
 #include "base/timing_logger.h"
 #include "compilation_kind.h"
+#include "dex/dex_file_types.h"
 #include "handle.h"
 #include "offsets.h"
 #include "interpreter/mterp/nterp.h"
@@ -55,6 +56,7 @@ namespace jit {
 class JitCodeCache;
 class JitCompileTask;
 class JitMemoryRegion;
+class JitPendingCompileTask;
 class JitOptions;
 
 static constexpr int16_t kJitCheckForOSR = -1;
@@ -66,6 +68,8 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// Maximum number of jit threads when their number is not specified.
+static constexpr size_t kJitMaxDefaultPoolThreads = 4;
 
 class JitOptions {
  public:
@@ -115,6 +119,10 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  size_t GetThreadPoolSize() const {
+    return thread_pool_size_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -123,6 +131,23 @@ class JitOptions {
     return use_profiled_jit_compilation_;
   }
 
+  bool PrecompileAppProfile() const {
+    return precompile_app_profile_;
+  }
+
+  bool VerifyAppProfileClasses() const {
+    return verify_app_profile_classes_;
+  }
+
+  bool UseAdaptiveOptimizeThreshold() const {
+    return adaptive_optimize_threshold_;
+  }
+
+  // App profiles whose boot classpath methods the zygote compiles before forking apps.
+  const std::vector<std::string>& GetZygoteAppProfiles() const {
+    return zygote_app_profiles_;
+  }
+
   void SetUseJitCompilation(bool b) {
     use_jit_compilation_ = b;
   }
@@ -155,6 +180,9 @@ class JitOptions {
 
   bool use_jit_compilation_;
   bool use_profiled_jit_compilation_;
+  bool precompile_app_profile_;
+  bool verify_app_profile_classes_;
+  bool adaptive_optimize_threshold_;
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
@@ -165,11 +193,16 @@ class JitOptions {
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  size_t thread_pool_size_;
+  std::vector<std::string> zygote_app_profiles_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
       : use_jit_compilation_(false),
         use_profiled_jit_compilation_(false),
+        precompile_app_profile_(false),
+        verify_app_profile_classes_(false),
+        adaptive_optimize_threshold_(false),
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
@@ -179,7 +212,8 @@ class JitOptions {
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        thread_pool_size_(1u) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -301,6 +335,10 @@ class Jit {
     return options_->GetSaveProfilingInfo();
   }
 
+  const std::vector<std::string>& GetZygoteAppProfiles() const {
+    return options_->GetZygoteAppProfiles();
+  }
+
   // Wait until there is no more pending compilation tasks.
   void WaitForCompilationToFinish(Thread* self);
 
@@ -333,6 +371,29 @@ class Jit {
                          const std::string& ref_profile_filename);
   void StopProfileSaver();
 
+  // Compile, in the background, the methods of the profile written by the profile saver
+  // during the previous runs of the app, if enabled with -Xjitprecompileappprofile.
+  void PrecompileMethodsFromAppProfile(const std::string& profile_filename,
+                                       const std::vector<std::string>& code_paths);
+
+  // Verify, in the background, the classes of the profile written by the profile saver
+  // during the previous runs of the app, if enabled with -Xjitverifyappprofileclasses.
+  void VerifyClassesFromAppProfile(const std::string& profile_filename,
+                                   const std::vector<std::string>& code_paths);
+
+  // Returns the registered dex files whose base location is one of `code_paths`.
+  static std::vector<const DexFile*> FindAppDexFiles(Thread* self,
+                                                     const std::vector<std::string>& code_paths)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::dex_lock_);
+
+  // Verifies the classes of `class_types` that `class_loader` has already loaded and that are not
+  // verified yet. Classes that are not loaded are skipped. Returns the number of classes verified.
+  static size_t VerifyLoadedClasses(Thread* self,
+                                    const DexFile& dex_file,
+                                    const std::vector<dex::TypeIndex>& class_types,
+                                    Handle<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void DumpForSigQuit(std::ostream& os) REQUIRES(!lock_);
 
   static void NewTypeLoadedIfUsingJit(mirror::Class* type)
@@ -397,13 +458,15 @@ class Jit {
 
   // Compile methods from the given profile (.prof extension). If `add_to_queue`
   // is true, methods in the profile are added to the JIT queue. Otherwise they are compiled
-  // directly.
+  // directly. If `is_app_profile` is true, the profile is an app profile even if
+  // `class_loader` is null, in which case only the methods of `dex_files` are compiled.
   // Return the number of methods added to the queue.
   uint32_t CompileMethodsFromProfile(Thread* self,
                                      const std::vector<const DexFile*>& dex_files,
                                      const std::string& profile_path,
                                      Handle<mirror::ClassLoader> class_loader,
-                                     bool add_to_queue);
+                                     bool add_to_queue,
+                                     bool is_app_profile = false);
 
   // Compile methods from the given boot profile (.bprof extension). If `add_to_queue`
   // is true, methods in the profile are added to the JIT queue. Otherwise they are compiled
@@ -440,7 +503,15 @@ class Jit {
 
   void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
 
-  void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
+  // Scale the baseline hotness threshold at which `method` gets compiled optimized by how
+  // its baseline compilation time compares to the average, so that methods that are cheap
+  // to compile get optimized earlier. Only done with -Xjitadaptivethreshold.
+  void UpdateOptimizeThreshold(ArtMethod* method, Thread* self, uint64_t compile_time_ns)
+      REQUIRES(!lock_);
+
+  // Enqueue a compilation of `method` if it is hot. `from_back_edge` tells whether the
+  // interpreter reached the hotness threshold on a loop back edge of the method.
+  void MaybeEnqueueCompilation(ArtMethod* method, Thread* self, bool from_back_edge = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
@@ -468,6 +539,12 @@ class Jit {
                       CompilationKind compilation_kind,
                       bool precompile = false);
 
+  // Returns the pending compile task to run next, or null if there is none.
+  JitCompileTask* TakeHottestCompileTask(Thread* self) REQUIRES(!lock_);
+
+  // Returns the number of jit threads compiling at the same time.
+  size_t GetNumberOfActiveWorkers() const;
+
   bool CompileMethodInternal(ArtMethod* method,
                              Thread* self,
                              CompilationKind compilation_kind,
@@ -496,6 +573,10 @@ class Jit {
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
+  // Thread CPU time spent in successful baseline compilations, and their number.
+  uint64_t baseline_compile_time_ns_ GUARDED_BY(lock_) = 0u;
+  uint64_t baseline_compile_count_ GUARDED_BY(lock_) = 0u;
+
   // In the JIT zygote configuration, after all compilation is done, the zygote
   // will copy its contents of the boot image to the zygote_mapping_methods_,
   // which will be picked up by processes that will map the memory
@@ -520,7 +601,12 @@ class Jit {
   // between the zygote and apps.
   std::map<ArtMethod*, uint16_t> shared_method_counters_;
 
+  // Compile tasks waiting for a jit thread. Each one has a matching task in the thread pool,
+  // which runs the hottest pending task once a thread is available, rather than the oldest.
+  std::vector<JitCompileTask*> pending_compile_tasks_ GUARDED_BY(lock_);
+
   friend class art::jit::JitCompileTask;
+  friend class art::jit::JitPendingCompileTask;
 
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
@@ -455,6 +455,10 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
           mirror::Class* new_klass = down_cast<mirror::Class*>(visitor->IsMarked(klass));
           if (new_klass != klass) {
             cache->classes_[j] = GcRoot<mirror::Class>(new_klass);
+            if (new_klass == nullptr) {
+              // The entry can be reused by another class, forget the old count.
+              cache->counts_[j] = 0u;
+            }
           }
         }
       }
@@ -613,17 +617,22 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 
 void JitCodeCache::CopyInlineCacheInto(
     const InlineCache& ic,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts) {
   static_assert(arraysize(ic.classes_) == InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->NumberOfReferences(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->RemainingSlots(), InlineCache::kIndividualCacheSize);
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (const GcRoot<mirror::Class>& root : ic.classes_) {
-    mirror::Class* object = root.Read();
+  for (size_t i = 0; i != InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* object = ic.classes_[i].Read();
     if (object != nullptr) {
       DCHECK_NE(classes->RemainingSlots(), 0u);
+      if (counts != nullptr) {
+        // Keep the counts aligned with the handles, skipping cleared entries.
+        (*counts)[InlineCache::kIndividualCacheSize - classes->RemainingSlots()] = ic.counts_[i];
+      }
       classes->NewHandle(object);
     }
   }
@@ -1257,6 +1266,7 @@ void JitCodeCache::SetGarbageCollectCode(bool value) {
 void JitCodeCache::RemoveMethodBeingCompiled(ArtMethod* method, CompilationKind kind) {
   ScopedDebugDisallowReadBarriers sddrb(Thread::Current());
   DCHECK(IsMethodBeingCompiled(method, kind));
+  current_compilations_cache_.Remove(method, kind);
   switch (kind) {
     case CompilationKind::kOsr:
       current_osr_compilations_.erase(method);
@@ -1273,6 +1283,8 @@ void JitCodeCache::RemoveMethodBeingCompiled(ArtMethod* method, CompilationKind
 void JitCodeCache::AddMethodBeingCompiled(ArtMethod* method, CompilationKind kind) {
   ScopedDebugDisallowReadBarriers sddrb(Thread::Current());
   DCHECK(!IsMethodBeingCompiled(method, kind));
+  // Failing to record the method only means mutators will need the jit lock to find it.
+  current_compilations_cache_.Insert(method, kind);
   switch (kind) {
     case CompilationKind::kOsr:
       current_osr_compilations_.insert(method);
@@ -1325,6 +1337,26 @@ void JitCodeCache::ResetHotnessCounter(ArtMethod* method, Thread* self) {
   it->second->ResetCounter();
 }
 
+void JitCodeCache::RecordDeoptimization(ArtMethod* method,
+                                        Thread* self,
+                                        DeoptimizationKind kind) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it != profiling_infos_.end()) {
+    it->second->AddDeoptimization(kind);
+  }
+}
+
+void JitCodeCache::SetOptimizeThreshold(ArtMethod* method, Thread* self, uint16_t threshold) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it != profiling_infos_.end()) {
+    it->second->SetOptimizeThreshold(threshold);
+  }
+}
+
 
 void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
   ScopedTrace trace(__FUNCTION__);
@@ -1400,7 +1432,46 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
 
   if (collect_profiling_info) {
     // TODO: Collect unused profiling infos.
+    MaybeEvictFragmentedCode(self);
+  }
+}
+
+void JitCodeCache::MaybeEvictFragmentedCode(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  size_t used_memory = private_region_.GetUsedMemoryForCode();
+  size_t free_memory = private_region_.GetResidentMemoryForCode() - used_memory;
+  if (free_memory * kFragmentedFreeCodeRatio < private_region_.GetResidentMemoryForCode()) {
+    return;
+  }
+  size_t largest_free_chunk = private_region_.GetLargestFreeCodeChunk();
+  if (largest_free_chunk * kFragmentedFreeChunkRatio >= free_memory) {
+    return;
+  }
+
+  // Live code could fit below `limit` if there were no holes.
+  const uint8_t* limit = private_region_.GetExecPages()->Begin() + used_memory;
+  uint16_t warmup_threshold = Runtime::Current()->GetJITOptions()->GetWarmupThreshold();
+  instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+  size_t evicted = 0u;
+  for (const auto& it : method_code_map_) {
+    const void* code_ptr = it.first;
+    ArtMethod* method = it.second;
+    if (IsInZygoteExecSpace(code_ptr) ||
+        reinterpret_cast<const uint8_t*>(FromCodeToAllocation(code_ptr)) < limit) {
+      continue;
+    }
+    const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    if (method_header->GetEntryPoint() == method->GetEntryPointFromQuickCompiledCode()) {
+      method->ResetCounter(warmup_threshold);
+      instrumentation->InitializeMethodsCode(method, /*aot_code=*/ nullptr);
+      ++evicted;
+    }
   }
+  VLOG(jit) << "JIT code cache fragmented, free=" << PrettySize(free_memory)
+            << ", largest free chunk=" << PrettySize(largest_free_chunk)
+            << ", evicted " << evicted << " methods";
 }
 
 OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod* method) {
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 #define ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 
+#include <array>
 #include <iosfwd>
 #include <memory>
 #include <set>
@@ -33,6 +34,7 @@
 #include "base/mutex.h"
 #include "base/safe_map.h"
 #include "compilation_kind.h"
+#include "concurrent_method_set.h"
 #include "jit_memory_region.h"
 #include "profiling_info.h"
 
@@ -188,6 +190,12 @@ class JitCodeCache {
   // By default, do not GC until reaching 256KB.
   static constexpr size_t kReservedCapacity = kInitialCapacity * 4;
 
+  // The code space is considered fragmented when at least 1/kFragmentedFreeCodeRatio of its
+  // footprint is free, and the largest free chunk holds less than 1/kFragmentedFreeChunkRatio
+  // of the free memory.
+  static constexpr size_t kFragmentedFreeCodeRatio = 4;
+  static constexpr size_t kFragmentedFreeChunkRatio = 4;
+
   // Create the code cache with a code + data capacity equal to "capacity", error message is passed
   // in the out arg error_msg.
   static JitCodeCache* Create(bool used_only_for_profile_data,
@@ -309,8 +317,12 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy the classes of `ic` into `classes` and, if `counts` is not null, the number of times
+  // each of them has been seen into the corresponding entries of `counts`.
   void CopyInlineCacheInto(const InlineCache& ic,
-                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+                           /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts =
+                               nullptr)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -404,6 +416,9 @@ class JitCodeCache {
 
   ProfilingInfo* GetProfilingInfo(ArtMethod* method, Thread* self);
   void ResetHotnessCounter(ArtMethod* method, Thread* self);
+  void SetOptimizeThreshold(ArtMethod* method, Thread* self, uint16_t threshold);
+  // Record in the profiling info of `method` that its compiled code deoptimized for `kind`.
+  void RecordDeoptimization(ArtMethod* method, Thread* self, DeoptimizationKind kind);
 
   void VisitRoots(RootVisitor* visitor);
 
@@ -419,6 +434,12 @@ class JitCodeCache {
   void AddMethodBeingCompiled(ArtMethod* method, CompilationKind compilation_kind)
       REQUIRES(Locks::jit_lock_);
 
+  // Return whether `method` is known to be compiled with the given mode, without taking the
+  // jit lock. A `false` answer must be confirmed with `IsMethodBeingCompiled`.
+  bool IsMethodKnownToBeCompiled(ArtMethod* method, CompilationKind compilation_kind) const {
+    return current_compilations_cache_.Contains(method, compilation_kind);
+  }
+
  private:
   JitCodeCache();
 
@@ -491,6 +512,13 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // If the code space is fragmented, reset to the interpreter the methods whose code lies above
+  // the memory used by all the live code. Their code is freed by the next collection, and they
+  // get compiled again in the free chunks of the space when they become hot again.
+  void MaybeEvictFragmentedCode(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void MarkCompiledCodeOnThreadStacks(Thread* self)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -561,6 +589,10 @@ class JitCodeCache {
   std::set<ArtMethod*> current_osr_compilations_ GUARDED_BY(Locks::jit_lock_);
   std::set<ArtMethod*> current_baseline_compilations_ GUARDED_BY(Locks::jit_lock_);
 
+  // Lock-free view of the sets above, for the mutators requesting compilations of methods
+  // that are already being compiled. Updated with the sets, under the jit lock.
+  ConcurrentMethodSet current_compilations_cache_;
+
   // Methods that the zygote has compiled and can be shared across processes
   // forked from the zygote.
   ZygoteMap zygote_map_;
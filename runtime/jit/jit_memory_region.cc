@@ -16,6 +16,8 @@
 
 #include "jit_memory_region.h"
 
+#include <algorithm>
+
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -483,6 +485,22 @@ void JitMemoryRegion::FreeCode(const uint8_t* code) {
   mspace_free(exec_mspace_, const_cast<uint8_t*>(code));
 }
 
+static void LargestFreeChunkCallback(void* start, void* end, size_t used_bytes, void* arg) {
+  if (used_bytes == 0u) {
+    size_t* largest_free_chunk = reinterpret_cast<size_t*>(arg);
+    size_t size = reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start);
+    *largest_free_chunk = std::max(*largest_free_chunk, size);
+  }
+}
+
+size_t JitMemoryRegion::GetLargestFreeCodeChunk() {
+  size_t largest_free_chunk = 0u;
+  if (exec_mspace_ != nullptr) {
+    mspace_inspect_all(exec_mspace_, LargestFreeChunkCallback, &largest_free_chunk);
+  }
+  return largest_free_chunk;
+}
+
 const uint8_t* JitMemoryRegion::AllocateData(size_t data_size) {
   void* result = mspace_malloc(data_mspace_, data_size);
   if (UNLIKELY(result == nullptr)) {
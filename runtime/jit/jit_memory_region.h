@@ -172,6 +172,9 @@ class JitMemoryRegion {
     return exec_end_;
   }
 
+  // Return the size in bytes of the largest free chunk of the code portion of the region.
+  size_t GetLargestFreeCodeChunk() REQUIRES(Locks::jit_lock_);
+
   size_t GetUsedMemoryForData() const REQUIRES(Locks::jit_lock_) {
     return used_memory_for_data_;
   }
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "compiler_callbacks.h"
+#include "dex/dex_file.h"
+#include "handle_scope-inl.h"
+#include "jit/jit.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace jit {
+
+class JitVerifyClassesTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    // Verify the classes as a running app would, not as the compiler.
+    callbacks_.reset();
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+  }
+
+  static dex::TypeIndex GetTypeIndex(const DexFile& dex_file, const char* descriptor) {
+    const dex::TypeId* type_id = dex_file.FindTypeId(descriptor);
+    CHECK(type_id != nullptr) << descriptor;
+    return dex_file.GetIndexForTypeId(*type_id);
+  }
+};
+
+TEST_F(JitVerifyClassesTest, VerifiesOnlyLoadedClasses) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject jclass_loader = LoadDex("XandY");
+  const DexFile* dex_file = GetFirstDexFile(jclass_loader);
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
+
+  // Load X without initializing it. Y, a subclass of X, is not loaded.
+  Handle<mirror::Class> x(
+      hs.NewHandle(class_linker_->FindClass(soa.Self(), "LX;", class_loader)));
+  ASSERT_TRUE(x != nullptr);
+  ASSERT_TRUE(x->IsResolved());
+  ASSERT_FALSE(x->IsVerified());
+  ASSERT_TRUE(class_linker_->LookupClass(soa.Self(), "LY;", class_loader.Get()) == nullptr);
+
+  std::vector<dex::TypeIndex> class_types = {GetTypeIndex(*dex_file, "LX;"),
+                                             GetTypeIndex(*dex_file, "LY;")};
+  EXPECT_EQ(Jit::VerifyLoadedClasses(soa.Self(), *dex_file, class_types, class_loader), 1u);
+  EXPECT_FALSE(soa.Self()->IsExceptionPending());
+  EXPECT_TRUE(x->IsVerified());
+  EXPECT_FALSE(x->IsInitialized());
+  // The JIT thread must not load the classes that the app has not loaded yet.
+  EXPECT_TRUE(class_linker_->LookupClass(soa.Self(), "LY;", class_loader.Get()) == nullptr);
+
+  // Classes that are already verified are skipped.
+  EXPECT_EQ(Jit::VerifyLoadedClasses(soa.Self(), *dex_file, class_types, class_loader), 0u);
+}
+
+}  // namespace jit
+}  // namespace art
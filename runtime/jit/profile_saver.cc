@@ -174,9 +174,6 @@ void ProfileSaver::Run() {
           period_condition_.Wait(self);
         } else {
           period_condition_.TimedWait(self, cur_wait_without_jit, 0);
-          if (cur_wait_without_jit < max_wait_without_jit) {
-            cur_wait_without_jit *= 2;
-          }
         }
         sleep_time = NanoTime() - sleep_start;
       }
@@ -220,6 +217,14 @@ void ProfileSaver::Run() {
     // Reset the flag, so we can continue on the normal schedule.
     force_early_first_save = false;
 
+    // Adapt the period to the rate of new methods: keep waking up at the minimum period
+    // while we find enough new methods to save, and back off while there is nothing new.
+    if (profile_saved_to_disk) {
+      cur_wait_without_jit = options_.GetMinSavePeriodMs();
+    } else if (cur_wait_without_jit < max_wait_without_jit) {
+      cur_wait_without_jit *= 2;
+    }
+
     // Update the notification counter based on result. Note that there might be contention on this
     // but we don't care about to be 100% precise.
     if (!profile_saved_to_disk) {
@@ -866,6 +871,15 @@ bool ProfileSaver::ProcessProfilingInfo(
       jit_code_cache_->GetProfiledMethods(locations, profile_methods);
       total_number_of_code_cache_queries_++;
     }
+    if (!force_save && profile_methods.empty()) {
+      // If there is nothing to add, do not read the profile just to find that it is up to date.
+      MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+      if (profile_cache_.find(filename) == profile_cache_.end()) {
+        VLOG(profiler) << "No new information to save to: " << filename;
+        total_number_of_skipped_writes_++;
+        continue;
+      }
+    }
     {
       ProfileCompilationInfo info(Runtime::Current()->GetArenaPool(),
                                   /*for_boot_image=*/options_.GetProfileBootClassPath());
@@ -27,6 +27,8 @@ namespace art {
 
 ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
       : baseline_hotness_count_(GetOptimizeThreshold()),
+        optimize_threshold_(baseline_hotness_count_),
+        deoptimization_kinds_(0u),
         method_(method),
         number_of_inline_caches_(entries.size()),
         current_inline_uses_(0) {
@@ -86,7 +88,8 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just count it.
+      ++cache->counts_[i];
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -101,7 +104,8 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         // entry in case the entry contains `cls`.
         --i;
       } else {
-        // We successfully set `cls`, just return.
+        // We successfully set `cls`, count it and return.
+        ++cache->counts_[i];
         return;
       }
     }
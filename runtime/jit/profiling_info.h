@@ -21,6 +21,7 @@
 
 #include "base/macros.h"
 #include "base/value_object.h"
+#include "deoptimization_kind.h"
 #include "gc_root.h"
 #include "interpreter/mterp/nterp.h"
 #include "offsets.h"
@@ -50,9 +51,18 @@ class InlineCache {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Number of times the receiver in the corresponding `classes_` entry has been seen. The
+  // counts are updated without synchronization, so they are only an approximation. Once the
+  // cache is megamorphic, the last entry keeps being replaced and its count accumulates all
+  // the receivers that did not fit in the other entries.
+  uint32_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -108,17 +118,36 @@ class ProfilingInfo {
   }
 
   void ResetCounter() {
-    baseline_hotness_count_ = GetOptimizeThreshold();
+    baseline_hotness_count_ = optimize_threshold_;
   }
 
   bool CounterHasChanged() const {
-    return baseline_hotness_count_ != GetOptimizeThreshold();
+    return baseline_hotness_count_ != optimize_threshold_;
+  }
+
+  // Set the baseline hotness count at which this method gets compiled optimized.
+  void SetOptimizeThreshold(uint16_t threshold) {
+    if (!CounterHasChanged() || baseline_hotness_count_ > threshold) {
+      baseline_hotness_count_ = threshold;
+    }
+    optimize_threshold_ = threshold;
   }
 
   uint16_t GetBaselineHotnessCount() const {
     return baseline_hotness_count_;
   }
 
+  // Record that compiled code of the method deoptimized because a speculation of `kind` failed.
+  void AddDeoptimization(DeoptimizationKind kind) {
+    deoptimization_kinds_ |= 1u << static_cast<size_t>(kind);
+  }
+
+  // Return whether compiled code of the method deoptimized because a speculation of `kind`
+  // failed. The compiler should then not speculate the same way again.
+  bool HasDeoptimized(DeoptimizationKind kind) const {
+    return (deoptimization_kinds_ & (1u << static_cast<size_t>(kind))) != 0u;
+  }
+
  private:
   ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
 
@@ -129,6 +158,14 @@ class ProfilingInfo {
   // JIT compile optimized the method.
   uint16_t baseline_hotness_count_;
 
+  // Value the baseline hotness count is reset to, the process-wide optimize threshold unless
+  // adapted for this method.
+  uint16_t optimize_threshold_;
+
+  // Bit set of the `DeoptimizationKind`s the compiled code of the method deoptimized for.
+  uint16_t deoptimization_kinds_;
+  static_assert(static_cast<size_t>(DeoptimizationKind::kLast) < 16u);
+
   // Method this profiling info is for.
   // Not 'const' as JVMTI introduces obsolete methods that we implement by creating new ArtMethods.
   // See JitCodeCache::MoveObsoleteMethod.
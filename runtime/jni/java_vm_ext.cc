@@ -33,6 +33,7 @@
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "fault_handler.h"
 #include "gc/allocation_record.h"
+#include "gc/collector/concurrent_copying.h"
 #include "gc/heap.h"
 #include "gc_root-inl.h"
 #include "indirect_reference_table-inl.h"
@@ -503,6 +504,7 @@ JavaVMExt::JavaVMExt(Runtime* runtime, const RuntimeArgumentMap& runtime_options
       force_copy_(runtime_options.Exists(RuntimeArgumentMap::JniOptsForceCopy)),
       tracing_enabled_(runtime_options.Exists(RuntimeArgumentMap::JniTrace)
                        || VLOG_IS_ON(third_party_jni)),
+      leaf_natives_enabled_(runtime_options.Exists(RuntimeArgumentMap::JniOptsLeafNatives)),
       trace_(runtime_options.GetOrDefault(RuntimeArgumentMap::JniTrace)),
       globals_(kGlobal),
       libraries_(new Libraries),
@@ -858,14 +860,38 @@ ObjPtr<mirror::Object> JavaVMExt::DecodeWeakGlobalLocked(Thread* self, IndirectR
   if (kDebugLocking) {
     Locks::jni_weak_globals_lock_->AssertHeld(self);
   }
-  // TODO: Handle the already null case without waiting.
   // TODO: Otherwise we should just wait for kInitMarkingDone, and track which weak globals were
   // marked at that point. We would only need one mark bit per entry in the weak_globals_ table,
   // and a quick pass over that early on during reference processing.
+  if (UNLIKELY(!MayAccessWeakGlobals(self))) {
+    ObjPtr<mirror::Object> result = DecodeWeakGlobalWithoutAccess(ref);
+    if (result != nullptr) {
+      return result;
+    }
+  }
   WaitForWeakGlobalsAccess(self);
   return weak_globals_.Get(ref);
 }
 
+ObjPtr<mirror::Object> JavaVMExt::DecodeWeakGlobalWithoutAccess(IndirectRef ref) {
+  // A read barrier may be unsafe here, and we use the result only when it's cleared or marked.
+  ObjPtr<mirror::Object> obj = weak_globals_.Get<kWithoutReadBarrier>(ref);
+  Runtime* runtime = Runtime::Current();
+  if (runtime->IsClearedJniWeakGlobal(obj)) {
+    // There is no scenario where a cleared weak global gets a referent again.
+    return obj;
+  }
+  if (gUseReadBarrier) {
+    // Marked objects are kept alive by the sweeping of the weak globals, so the to-space
+    // reference is the correct value. The other collectors may move objects after marking.
+    gc::collector::ConcurrentCopying* collector = runtime->GetHeap()->ConcurrentCopyingCollector();
+    if (collector != nullptr && collector->IsActive()) {
+      return collector->IsMarked(obj.Ptr());
+    }
+  }
+  return nullptr;
+}
+
 ObjPtr<mirror::Object> JavaVMExt::DecodeWeakGlobalAsStrong(IndirectRef ref) {
   // The target is known to be alive. Simple `Get()` with read barrier is enough.
   return weak_globals_.Get(ref);
@@ -887,6 +913,12 @@ ObjPtr<mirror::Object> JavaVMExt::DecodeWeakGlobalDuringShutdown(Thread* self, I
 bool JavaVMExt::IsWeakGlobalCleared(Thread* self, IndirectRef ref) {
   DCHECK_EQ(IndirectReferenceTable::GetIndirectRefKind(ref), kWeakGlobal);
   MutexLock mu(self, *Locks::jni_weak_globals_lock_);
+  if (UNLIKELY(!MayAccessWeakGlobals(self))) {
+    ObjPtr<mirror::Object> result = DecodeWeakGlobalWithoutAccess(ref);
+    if (result != nullptr) {
+      return Runtime::Current()->IsClearedJniWeakGlobal(result);
+    }
+  }
   WaitForWeakGlobalsAccess(self);
   // When just checking a weak ref has been cleared, avoid triggering the read barrier in decode
   // (DecodeWeakGlobal) so that we won't accidentally mark the object alive. Since the cleared
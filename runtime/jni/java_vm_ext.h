@@ -71,6 +71,12 @@ class JavaVMExt : public JavaVM {
     return tracing_enabled_;
   }
 
+  // Whether native methods registered with a '!' signature prefix are treated as leaf natives,
+  // i.e. get the @FastNative calling convention without the annotation.
+  bool AreLeafNativesEnabled() const {
+    return leaf_natives_enabled_;
+  }
+
   Runtime* GetRuntime() const {
     return runtime_;
   }
@@ -239,6 +245,13 @@ class JavaVMExt : public JavaVM {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::jni_weak_globals_lock_);
 
+  // Return the value of the weak global `ref` if it can be determined while self may not access
+  // weak globals, i.e. if it is already cleared or, with read barriers, its referent is already
+  // marked by the GC. Return null otherwise.
+  ObjPtr<mirror::Object> DecodeWeakGlobalWithoutAccess(IndirectRef ref)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::jni_weak_globals_lock_);
+
   void CheckGlobalRefAllocationTracking();
 
   inline void MaybeTraceGlobals() REQUIRES(Locks::jni_globals_lock_);
@@ -254,6 +267,7 @@ class JavaVMExt : public JavaVM {
   bool check_jni_;
   const bool force_copy_;
   const bool tracing_enabled_;
+  const bool leaf_natives_enabled_;
 
   // Extra diagnostics.
   const std::string trace_;
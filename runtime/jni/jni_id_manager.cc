@@ -254,12 +254,12 @@ uintptr_t JniIdManager::GetNextId<ArtMethod>(JniIdType type) {
   return res;
 }
 template <>
-std::vector<ArtField*>& JniIdManager::GetGenericMap<ArtField>() {
+JniIdTable<ArtField>& JniIdManager::GetGenericMap<ArtField>() {
   return field_id_map_;
 }
 
 template <>
-std::vector<ArtMethod*>& JniIdManager::GetGenericMap<ArtMethod>() {
+JniIdTable<ArtMethod>& JniIdManager::GetGenericMap<ArtMethod>() {
   return method_id_map_;
 }
 template <>
@@ -353,34 +353,21 @@ uintptr_t JniIdManager::EncodeGenericId(ReflectiveHandle<ArtType> t) {
         << "deferred_allocation_refcount_: " << deferred_allocation_refcount_
         << " t: " << PrettyGeneric(t);
     // Check to see if we raced and lost to another thread.
-    const std::vector<ArtType*>& vec = GetGenericMap<ArtType>();
-    bool found = false;
-    // simple count-while.
-    size_t search_start_index = IdToIndex(GetLinearSearchStartId(t));
-    size_t index = std::count_if(vec.cbegin() + search_start_index,
-                                 vec.cend(),
-                                 [&found, &self, t](const ArtType* candidate) {
-                                   Locks::mutator_lock_->AssertSharedHeld(self);
-                                   found = found || candidate == t.Get();
-                                   return !found;
-                                 }) +
-                   search_start_index;
-    if (found) {
+    const JniIdTable<ArtType>& table = GetGenericMap<ArtType>();
+    size_t index = IdToIndex(GetLinearSearchStartId(t));
+    while (index < table.size() && table.Get(index) != t.Get()) {
+      ++index;
+    }
+    if (index < table.size()) {
       // We were either racing some other thread and lost or this thread was asked to encode the
       // same method multiple times while holding the mutator lock.
-      DCHECK_EQ(vec[index], t.Get())
-          << "Expected: " << PrettyGeneric(vec[index]) << " got " << PrettyGeneric(t)
-          << " at index " << index << " (id: " << IndexToId(index) << ").";
       return IndexToId(index);
     }
   }
   cur_id = GetNextId<ArtType>(id_type);
   DCHECK_EQ(cur_id % 2, 1u);
   size_t cur_index = IdToIndex(cur_id);
-  std::vector<ArtType*>& vec = GetGenericMap<ArtType>();
-  vec.reserve(cur_index + 1);
-  vec.resize(std::max(vec.size(), cur_index + 1), nullptr);
-  vec[cur_index] = t.Get();
+  GetGenericMap<ArtType>().Set(cur_index, t.Get());
   if (ids.IsNull()) {
     if (kIsDebugBuild && CanUseIdArrays(t)) {
       CHECK_NE(deferred_allocation_refcount_, 0u)
@@ -444,13 +431,13 @@ void JniIdManager::Init(Thread* self) {
 
 void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
   art::WriterMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
-  for (auto it = field_id_map_.begin(); it != field_id_map_.end(); ++it) {
-    ArtField* old_field = *it;
-    uintptr_t id = IndexToId(std::distance(field_id_map_.begin(), it));
+  for (size_t index = 0, size = field_id_map_.size(); index != size; ++index) {
+    ArtField* old_field = field_id_map_.Get(index);
+    uintptr_t id = IndexToId(index);
     ArtField* new_field =
         rvv->VisitField(old_field, JniIdReflectiveSourceInfo(reinterpret_cast<jfieldID>(id)));
     if (old_field != new_field) {
-      *it = new_field;
+      field_id_map_.Set(index, new_field);
       ObjPtr<mirror::Class> old_class(old_field->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_field->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -497,13 +484,13 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
       }
     }
   }
-  for (auto it = method_id_map_.begin(); it != method_id_map_.end(); ++it) {
-    ArtMethod* old_method = *it;
-    uintptr_t id = IndexToId(std::distance(method_id_map_.begin(), it));
+  for (size_t index = 0, size = method_id_map_.size(); index != size; ++index) {
+    ArtMethod* old_method = method_id_map_.Get(index);
+    uintptr_t id = IndexToId(index);
     ArtMethod* new_method =
         rvv->VisitMethod(old_method, JniIdReflectiveSourceInfo(reinterpret_cast<jmethodID>(id)));
     if (old_method != new_method) {
-      *it = new_method;
+      method_id_map_.Set(index, new_method);
       ObjPtr<mirror::Class> old_class(old_method->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_method->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -532,10 +519,10 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
 
 template <typename ArtType> ArtType* JniIdManager::DecodeGenericId(uintptr_t t) {
   if (Runtime::Current()->GetJniIdType() == JniIdType::kIndices && (t % 2) == 1) {
-    ReaderMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
+    // No lock needed, ids are only handed out after their table entry has been published.
     size_t index = IdToIndex(t);
     DCHECK_GT(GetGenericMap<ArtType>().size(), index);
-    return GetGenericMap<ArtType>().at(index);
+    return GetGenericMap<ArtType>().Get(index);
   } else {
     DCHECK_EQ((t % 2), 0u) << "id: " << t;
     return reinterpret_cast<ArtType*>(t);
@@ -685,7 +672,7 @@ void JniIdManager::EndDefer() {
   {
     ReaderMutexLock mu(self, *Locks::jni_id_lock_);
     ScopedAssertNoThreadSuspension sants(__FUNCTION__);
-    jidsrs.Initialize(method_id_map_, field_id_map_);
+    jidsrs.Initialize(method_id_map_.ToVector(), field_id_map_.ToVector());
     method_start_id = deferred_allocation_method_id_start_;
     field_start_id = deferred_allocation_field_id_start_;
   }
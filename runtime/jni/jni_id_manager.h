@@ -24,6 +24,7 @@
 
 #include "art_field.h"
 #include "art_method.h"
+#include "base/bit_utils.h"
 #include "base/mutex.h"
 #include "gc_root.h"
 #include "jni_id_type.h"
@@ -39,6 +40,75 @@ template<typename RT> class ReflectiveHandle;
 namespace jni {
 
 class ScopedEnableSuspendAllJniIdQueries;
+
+// Table from JNI id index to the ArtField or ArtMethod it names. Entries are set with
+// `Locks::jni_id_lock_` held exclusively but can be read without it, since the entries live in
+// segments of doubling size that are never moved or freed while the table is alive.
+template <typename ArtType>
+class JniIdTable {
+ public:
+  JniIdTable() {}
+
+  ~JniIdTable() {
+    for (std::atomic<std::atomic<ArtType*>*>& segment : segments_) {
+      delete[] segment.load(std::memory_order_relaxed);
+    }
+  }
+
+  size_t size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  ArtType* Get(size_t index) const {
+    size_t segment = SegmentOf(index);
+    std::atomic<ArtType*>* entries = segments_[segment].load(std::memory_order_acquire);
+    DCHECK(entries != nullptr) << "index: " << index;
+    return entries[index - SegmentBegin(segment)].load(std::memory_order_acquire);
+  }
+
+  // Sets the entry at `index`, growing the table if needed.
+  void Set(size_t index, ArtType* value) REQUIRES(Locks::jni_id_lock_) {
+    size_t segment = SegmentOf(index);
+    std::atomic<ArtType*>* entries = segments_[segment].load(std::memory_order_relaxed);
+    if (entries == nullptr) {
+      entries = new std::atomic<ArtType*>[kFirstSegmentSize << segment]();
+      segments_[segment].store(entries, std::memory_order_release);
+    }
+    entries[index - SegmentBegin(segment)].store(value, std::memory_order_release);
+    if (index >= size_.load(std::memory_order_relaxed)) {
+      size_.store(index + 1u, std::memory_order_release);
+    }
+  }
+
+  std::vector<ArtType*> ToVector() const REQUIRES_SHARED(Locks::jni_id_lock_) {
+    std::vector<ArtType*> result;
+    result.reserve(size());
+    for (size_t i = 0, size = this->size(); i != size; ++i) {
+      result.push_back(Get(i));
+    }
+    return result;
+  }
+
+ private:
+  static constexpr size_t kFirstSegmentSize = 1024u;
+  static constexpr size_t kMaxSegments = BitSizeOf<size_t>() - WhichPowerOf2(kFirstSegmentSize);
+
+  // Segment `s` holds the `kFirstSegmentSize << s` indices starting at
+  // `kFirstSegmentSize * (2^s - 1)`.
+  static size_t SegmentOf(size_t index) {
+    return MostSignificantBit(index / kFirstSegmentSize + 1u);
+  }
+
+  static size_t SegmentBegin(size_t segment) {
+    return kFirstSegmentSize * ((static_cast<size_t>(1u) << segment) - 1u);
+  }
+
+  std::atomic<std::atomic<ArtType*>*> segments_[kMaxSegments] = {};
+  std::atomic<size_t> size_{0u};
+
+  DISALLOW_COPY_AND_ASSIGN(JniIdTable);
+};
+
 class JniIdManager {
  public:
   template <typename T,
@@ -74,8 +144,7 @@ class JniIdManager {
       REQUIRES_SHARED(Locks::mutator_lock_);
   template <typename ArtType>
   ArtType* DecodeGenericId(uintptr_t input) REQUIRES(!Locks::jni_id_lock_);
-  template <typename ArtType> std::vector<ArtType*>& GetGenericMap()
-      REQUIRES(Locks::jni_id_lock_);
+  template <typename ArtType> JniIdTable<ArtType>& GetGenericMap();
   template <typename ArtType> uintptr_t GetNextId(JniIdType id)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::jni_id_lock_);
@@ -88,9 +157,10 @@ class JniIdManager {
   void EndDefer() REQUIRES(!Locks::jni_id_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
   uintptr_t next_method_id_ GUARDED_BY(Locks::jni_id_lock_) = 1u;
-  std::vector<ArtMethod*> method_id_map_ GUARDED_BY(Locks::jni_id_lock_);
+  // Entries are only set with `Locks::jni_id_lock_` held, decoding does not need the lock.
+  JniIdTable<ArtMethod> method_id_map_;
   uintptr_t next_field_id_ GUARDED_BY(Locks::jni_id_lock_) = 1u;
-  std::vector<ArtField*> field_id_map_ GUARDED_BY(Locks::jni_id_lock_);
+  JniIdTable<ArtField> field_id_map_;
 
   // If non-zero indicates that some thread is trying to allocate ids without being able to update
   // the method->id mapping (due to not being able to allocate or something). In this case decode
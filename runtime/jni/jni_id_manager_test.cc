@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni_id_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jni {
+
+class JniIdTableTest : public CommonRuntimeTest {
+ protected:
+  JniIdTableTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+
+  // The entries are never dereferenced, so any distinct non-null value will do.
+  static ArtField* FakeField(size_t index) {
+    return reinterpret_cast<ArtField*>(static_cast<uintptr_t>(index + 1u) * kObjectAlignment);
+  }
+};
+
+TEST_F(JniIdTableTest, SegmentBoundaries) {
+  Thread* self = Thread::Current();
+  JniIdTable<ArtField> table;
+  EXPECT_EQ(0u, table.size());
+
+  // The first segment holds 1024 entries and each following one twice as many as the previous.
+  const std::vector<size_t> indices = { 0u, 1u, 1023u, 1024u, 3071u, 3072u, 7167u, 7168u, 15360u };
+  {
+    WriterMutexLock mu(self, *Locks::jni_id_lock_);
+    for (size_t index : indices) {
+      table.Set(index, FakeField(index));
+      EXPECT_EQ(index + 1u, table.size());
+    }
+    // Setting an entry below the current size does not shrink the table.
+    table.Set(2u, FakeField(2u));
+    EXPECT_EQ(indices.back() + 1u, table.size());
+  }
+
+  for (size_t index : indices) {
+    EXPECT_EQ(FakeField(index), table.Get(index)) << index;
+  }
+  EXPECT_EQ(FakeField(2u), table.Get(2u));
+  // Entries that were not set in an allocated segment read as null.
+  EXPECT_EQ(nullptr, table.Get(3u));
+  EXPECT_EQ(nullptr, table.Get(1025u));
+  EXPECT_EQ(nullptr, table.Get(7169u));
+
+  ReaderMutexLock mu(self, *Locks::jni_id_lock_);
+  std::vector<ArtField*> entries = table.ToVector();
+  ASSERT_EQ(indices.back() + 1u, entries.size());
+  for (size_t i = 0; i != entries.size(); ++i) {
+    bool is_set = (i == 2u) || std::find(indices.begin(), indices.end(), i) != indices.end();
+    EXPECT_EQ(is_set ? FakeField(i) : nullptr, entries[i]) << i;
+  }
+}
+
+TEST_F(JniIdTableTest, DecodeWhileAllocating) {
+  Thread* self = Thread::Current();
+  JniIdTable<ArtField> table;
+  // Large enough to allocate several segments while the readers are running.
+  static constexpr size_t kNumEntries = 40000u;
+  static constexpr size_t kNumReaders = 4u;
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> num_mismatches(0u);
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i != kNumReaders; ++i) {
+    readers.emplace_back([&table, &done, &num_mismatches]() {
+      // Decoding does not take `Locks::jni_id_lock_`. Every index below the published size
+      // must be readable, without waiting for the writer.
+      bool last_pass = false;
+      while (!last_pass) {
+        last_pass = done.load(std::memory_order_acquire);
+        for (size_t index = 0, size = table.size(); index != size; ++index) {
+          if (table.Get(index) != FakeField(index)) {
+            num_mismatches.fetch_add(1u, std::memory_order_relaxed);
+          }
+        }
+      }
+    });
+  }
+
+  for (size_t index = 0; index != kNumEntries; ++index) {
+    WriterMutexLock mu(self, *Locks::jni_id_lock_);
+    table.Set(index, FakeField(index));
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0u, num_mismatches.load());
+  EXPECT_EQ(kNumEntries, table.size());
+}
+
+}  // namespace jni
+}  // namespace art
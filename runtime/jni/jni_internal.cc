@@ -36,6 +36,7 @@
 #include "class_root-inl.h"
 #include "dex/dex_file-inl.h"
 #include "dex/utf-inl.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
 #include "fault_handler.h"
 #include "handle_scope.h"
 #include "hidden_api.h"
@@ -63,7 +64,9 @@
 #include "reflection.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stack.h"
 #include "thread.h"
+#include "thread_list.h"
 #include "well_known_classes-inl.h"
 
 namespace art {
@@ -381,6 +384,70 @@ static void ReportInvalidJNINativeMethod(const ScopedObjectAccess& soa,
                                  idx);
 }
 
+// Give a native method registered as a leaf native the @FastNative calling convention.
+// This is only possible while nothing has been compiled for or called through the normal
+// convention, i.e. the native code has never been bound and the method has no AOT or JIT
+// stub, since the JNI stubs and the generic JNI trampoline rely on matching access flags.
+static bool CanMakeLeafNative(ClassLinker* class_linker, ArtMethod* m)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (m->IsSynchronized() ||
+      m->IsFastNative() ||
+      m->IsCriticalNative() ||
+      m->IsIntrinsic() ||
+      m->GetEntryPointFromJni() != GetJniDlsymLookupStub() ||
+      m->GetOatMethodQuickCode(class_linker->GetImagePointerSize()) != nullptr) {
+    return false;
+  }
+  const void* quick_code = m->GetEntryPointFromQuickCompiledCode();
+  return class_linker->IsQuickGenericJniStub(quick_code) ||
+         class_linker->IsQuickResolutionStub(quick_code);
+}
+
+// The generic JNI trampoline reads the access flags when the call starts and again when it
+// ends, and the dlsym lookup stub reads them in between, so the flags must not change while
+// any thread is inside a call to the method. Flip them with all threads suspended, and only
+// if no thread has the method on its stack. A thread in native code cannot return to managed
+// code while suspended, and the generic JNI trampoline has no suspend point between reading
+// the flags and publishing the frame that the stack walk finds.
+static bool TryMakeLeafNative(Thread* self, ClassLinker* class_linker, ArtMethod* m)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (!CanMakeLeafNative(class_linker, m)) {
+    return false;
+  }
+  ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+  ScopedSuspendAll ssa(__FUNCTION__);
+  // Check again, another thread may have bound or compiled the method in the meantime.
+  if (!CanMakeLeafNative(class_linker, m)) {
+    return false;
+  }
+  bool in_call = false;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    // We hold the mutator lock exclusively, so the stacks of all threads can be walked.
+    Runtime::Current()->GetThreadList()->ForEach([&](Thread* thread) NO_THREAD_SAFETY_ANALYSIS {
+      if (in_call) {
+        return;
+      }
+      StackVisitor::WalkStack(
+          [&](const StackVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+            if (visitor->GetMethod() == m) {
+              in_call = true;
+              return false;
+            }
+            return true;
+          },
+          thread,
+          /*context=*/ nullptr,
+          StackVisitor::StackWalkKind::kSkipInlinedFrames);
+    });
+  }
+  if (in_call) {
+    return false;
+  }
+  m->SetAccessFlags(m->GetAccessFlags() | kAccFastNative);
+  return true;
+}
+
 template<bool kEnableIndexIds>
 static jmethodID FindMethodID(ScopedObjectAccess& soa, jclass jni_class,
                               const char* name, const char* sig, bool is_static)
@@ -2369,9 +2436,15 @@ class JNI {
     if (heap->IsMovableObject(array)) {
       if (!gUseReadBarrier && !gUseUserfaultfd) {
         heap->IncrementDisableMovingGC(soa.Self());
+      } else if (heap->CanPinObject(array)) {
+        // Keep only the region of the array in place, so that native code can hold on to the
+        // elements without delaying the next GC. We hold the mutator lock, so no flip can
+        // happen before the region is pinned and the decoded reference remains valid.
+        heap->PinObject(array);
       } else {
-        // For the CC and CMC collector, we only need to wait for the thread flip rather
-        // than the whole GC to occur thanks to the to-space invariant.
+        // For the CMC collector (and CC objects outside the region space), we only need to
+        // wait for the thread flip rather than the whole GC to occur thanks to the to-space
+        // invariant.
         heap->IncrementDisableThreadFlip(soa.Self());
       }
       // Re-decode in case the object moved since IncrementDisableGC waits for GC to complete.
@@ -2671,6 +2744,14 @@ class JNI {
 
       VLOG(jni) << "[Registering JNI native method " << m->PrettyMethod() << "]";
 
+      if (UNLIKELY(is_fast) &&
+          soa.Vm()->AreLeafNativesEnabled() &&
+          TryMakeLeafNative(soa.Self(), class_linker, m)) {
+        // The JIT compiles a @FastNative stub for the method once it gets hot, until then
+        // the generic JNI trampoline picks the convention from the access flags.
+        VLOG(jni) << "[Registered " << m->PrettyMethod() << " as leaf native]";
+        is_fast = false;
+      }
       if (UNLIKELY(is_fast)) {
         // There are a few reasons to switch:
         // 1) We don't support !bang JNI anymore, it will turn to a hard error later.
@@ -2976,9 +3057,12 @@ class JNI {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
       } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
+        // Non copy to a movable object must means that we had disabled the moving GC
+        // or pinned the array.
         if (!gUseReadBarrier && !gUseUserfaultfd) {
           heap->DecrementDisableMovingGC(soa.Self());
+        } else if (heap->CanPinObject(array)) {
+          heap->UnpinObject(array);
         } else {
           heap->DecrementDisableThreadFlip(soa.Self());
         }
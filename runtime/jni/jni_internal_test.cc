@@ -2678,4 +2678,101 @@ TEST_F(JniInternalTest, NonAttachedThread) {
   check_jni_abort_catcher.Check("is making JNI calls without being attached");
 }
 
+static jint Java_MyClassNatives_sbar_leaf(JNIEnv*, jclass, jint count) {
+  return count + 1;
+}
+
+class JniInternalLeafNativesTest : public JniInternalTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    JniInternalTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-Xjniopts:leafnatives", nullptr));
+  }
+
+  bool IsFastNative(jmethodID method) {
+    ScopedObjectAccess soa(Thread::Current());
+    return jni::DecodeArtMethod(method)->IsFastNative();
+  }
+};
+
+// Register a leaf native while other threads keep calling it. The calls go through the
+// generic JNI trampoline, which must not see the calling convention change mid-call.
+TEST_F(JniInternalLeafNativesTest, RegisterLeafNativeDuringCalls) {
+  // This test leads to UnsatisfiedLinkErrors and warnings in the log.
+  ScopedLogSeverity sls(LogSeverity::FATAL);
+
+  // Leave the method unregistered, calls throw UnsatisfiedLinkError until it gets registered.
+  SetUpForTest(true, "sbar", "(I)I", nullptr);
+  ASSERT_FALSE(IsFastNative(jmethod_));
+
+  static constexpr size_t kNumCallers = 2u;
+  static constexpr size_t kSuccessfulCalls = 1000u;
+  struct CallerArgs {
+    JavaVMExt* vm;
+    jclass klass;
+    jmethodID method;
+    std::atomic<size_t> calls;
+    std::atomic<size_t> bad_results;
+  };
+  CallerArgs args;
+  args.vm = vm_;
+  args.klass = reinterpret_cast<jclass>(env_->NewGlobalRef(jklass_));
+  args.method = jmethod_;
+  args.calls = 0u;
+  args.bad_results = 0u;
+
+  auto caller = [](void* arg) -> void* {
+    CallerArgs* caller_args = reinterpret_cast<CallerArgs*>(arg);
+    JNIEnv* env;
+    CHECK_EQ(caller_args->vm->AttachCurrentThread(&env, nullptr), JNI_OK);
+    size_t successful_calls = 0u;
+    for (jint i = 0; successful_calls != kSuccessfulCalls; ++i) {
+      jint result = env->CallStaticIntMethod(caller_args->klass, caller_args->method, i);
+      if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+      } else {
+        if (result != i + 1) {
+          ++caller_args->bad_results;
+        }
+        ++successful_calls;
+      }
+      ++caller_args->calls;
+    }
+    CHECK_EQ(caller_args->vm->DetachCurrentThread(), JNI_OK);
+    return nullptr;
+  };
+
+  pthread_t pthreads[kNumCallers];
+  for (pthread_t& pthread : pthreads) {
+    int pthread_create_result = pthread_create(&pthread,
+                                               /* pthread_attr */ nullptr,
+                                               caller,
+                                               reinterpret_cast<void*>(&args));
+    CHECK_EQ(pthread_create_result, 0);
+  }
+  // Register the method while the callers are running.
+  while (args.calls.load() < 100u) {
+    sched_yield();
+  }
+  void* native_fnptr = reinterpret_cast<void*>(&Java_MyClassNatives_sbar_leaf);
+  JNINativeMethod methods[] = { { "sbar", "!(I)I", native_fnptr } };
+  ASSERT_EQ(JNI_OK, env_->RegisterNatives(jklass_, methods, 1));
+  for (pthread_t& pthread : pthreads) {
+    int pthread_join_result = pthread_join(pthread, /* thread_return */ nullptr);
+    CHECK_EQ(pthread_join_result, 0);
+  }
+  EXPECT_EQ(0u, args.bad_results.load());
+  env_->DeleteGlobalRef(args.klass);
+
+  // The registration above falls back to the normal convention if a call was in progress.
+  // Without concurrent calls, the method becomes a leaf native.
+  if (!IsFastNative(jmethod_)) {
+    env_->UnregisterNatives(jklass_);
+    ASSERT_EQ(JNI_OK, env_->RegisterNatives(jklass_, methods, 1));
+  }
+  EXPECT_TRUE(IsFastNative(jmethod_));
+  EXPECT_EQ(43, env_->CallStaticIntMethod(jklass_, jmethod_, 42));
+  EXPECT_FALSE(env_->ExceptionCheck());
+}
+
 }  // namespace art
@@ -164,6 +164,15 @@ bool LocalReferenceTable::Initialize(size_t max_count, std::string* error_msg) {
     max_count *= kCheckJniEntriesPerReference;
   }
 
+  // Most native calls create only a few local references, if any, and many threads never
+  // create any at all. Defer the allocation of the first table to the first `Add()`.
+  return (max_count <= kSmallLrtEntries) || Resize(max_count, error_msg);
+}
+
+bool LocalReferenceTable::AllocateSmallTable(std::string* error_msg) {
+  DCHECK_EQ(max_entries_, 0u);
+  DCHECK(small_table_ == nullptr);
+  DCHECK(tables_.empty());
   SmallLrtAllocator* small_lrt_allocator = Runtime::Current()->GetSmallLrtAllocator();
   LrtEntry* first_table = small_lrt_allocator->Allocate(kSmallLrtEntries, error_msg);
   if (first_table == nullptr) {
@@ -173,7 +182,7 @@ bool LocalReferenceTable::Initialize(size_t max_count, std::string* error_msg) {
   DCHECK_ALIGNED(first_table, kCheckJniEntriesPerReference * sizeof(LrtEntry));
   small_table_ = first_table;
   max_entries_ = kSmallLrtEntries;
-  return (max_count <= kSmallLrtEntries) || Resize(max_count, error_msg);
+  return true;
 }
 
 LocalReferenceTable::~LocalReferenceTable() {
@@ -191,6 +200,14 @@ LocalReferenceTable::~LocalReferenceTable() {
 }
 
 bool LocalReferenceTable::Resize(size_t new_size, std::string* error_msg) {
+  if (UNLIKELY(max_entries_ == 0u)) {
+    if (!AllocateSmallTable(error_msg)) {
+      return false;
+    }
+    if (new_size <= kSmallLrtEntries) {
+      return true;
+    }
+  }
   DCHECK_GE(max_entries_, kSmallLrtEntries);
   DCHECK(IsPowerOfTwo(max_entries_));
   DCHECK_GT(new_size, max_entries_);
@@ -274,7 +291,8 @@ IndirectRef LocalReferenceTable::Add(LRTSegmentState previous_state,
   VerifyObject(obj);
 
   DCHECK_LE(previous_state.top_index, segment_state_.top_index);
-  DCHECK(max_entries_ == kSmallLrtEntries ? small_table_ != nullptr : !tables_.empty());
+  DCHECK(max_entries_ == 0u ||
+         (max_entries_ == kSmallLrtEntries ? small_table_ != nullptr : !tables_.empty()));
 
   auto store_obj = [obj, this](LrtEntry* free_entry, const char* tag)
       REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -379,7 +397,8 @@ IndirectRef LocalReferenceTable::Add(LRTSegmentState previous_state,
     }
 
     std::string inner_error_msg;
-    if (!Resize(max_entries_ * 2u, &inner_error_msg)) {
+    size_t new_size = (max_entries_ != 0u) ? max_entries_ * 2u : kSmallLrtEntries;
+    if (!Resize(new_size, &inner_error_msg)) {
       std::ostringstream oss;
       oss << "JNI ERROR (app bug): " << kLocal << " table overflow "
           << "(max=" << max_entries_ << ")" << std::endl
@@ -457,7 +476,8 @@ bool LocalReferenceTable::Remove(LRTSegmentState previous_state, IndirectRef ire
   }
 
   DCHECK_LE(previous_state.top_index, segment_state_.top_index);
-  DCHECK(max_entries_ == kSmallLrtEntries ? small_table_ != nullptr : !tables_.empty());
+  DCHECK(max_entries_ == 0u ||
+         (max_entries_ == kSmallLrtEntries ? small_table_ != nullptr : !tables_.empty()));
   DCheckValidReference(iref);
 
   LrtEntry* entry = ToLrtEntry(iref);
@@ -258,7 +258,8 @@ class LocalReferenceTable {
   // Initialize the `LocalReferenceTable`.
   //
   // Max_count is the requested minimum initial capacity (resizable). The actual initial
-  // capacity can be higher to utilize all allocated memory.
+  // capacity can be higher to utilize all allocated memory. If the requested capacity fits
+  // in a small table, the allocation is deferred until the first reference is added.
   //
   // Returns true on success.
   // On failure, returns false and reports error in `*error_msg`.
@@ -438,6 +439,9 @@ class LocalReferenceTable {
   // Debug mode check that the reference is valid.
   void DCheckValidReference(IndirectRef iref) const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Allocate the first small table. Called on first use if `Initialize()` deferred it.
+  bool AllocateSmallTable(std::string* error_msg);
+
   // Resize the backing table to be at least `new_size` elements long. The `new_size`
   // must be larger than the current size. After return max_entries_ >= new_size.
   bool Resize(size_t new_size, std::string* error_msg);
@@ -1010,5 +1010,35 @@ TEST_F(LocalReferenceTableTest, PruneBeforeTrim) {
   ASSERT_EQ(new_ref, refs[0]);
 }
 
+TEST_F(LocalReferenceTableTest, DeferredAllocation) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> c = GetClassRoot<mirror::Object>();
+  for (bool check_jni : {false, true}) {
+    LocalReferenceTable lrt(check_jni);
+    std::string error_msg;
+    bool success = lrt.Initialize(/*max_count=*/ 1u, &error_msg);
+    ASSERT_TRUE(success) << error_msg;
+
+    // No table is allocated until the first reference is added.
+    ASSERT_EQ(0u, lrt.FreeCapacity());
+    ASSERT_EQ(0u, lrt.Capacity());
+
+    const LRTSegmentState cookie0 = kLRTFirstSegment;
+    IndirectRef ref = lrt.Add(cookie0, c, &error_msg);
+    ASSERT_TRUE(ref != nullptr) << error_msg;
+    EXPECT_OBJ_PTR_EQ(c, lrt.Get(ref));
+    ASSERT_EQ(1u, lrt.Capacity());
+    ASSERT_TRUE(lrt.Remove(cookie0, ref));
+  }
+
+  // Reserving capacity also allocates the deferred table.
+  LocalReferenceTable lrt(/*check_jni=*/ false);
+  std::string error_msg;
+  bool success = lrt.Initialize(/*max_count=*/ 1u, &error_msg);
+  ASSERT_TRUE(success) << error_msg;
+  ASSERT_TRUE(lrt.EnsureFreeCapacity(1u, &error_msg)) << error_msg;
+  ASSERT_EQ(kSmallLrtEntries, lrt.FreeCapacity());
+}
+
 }  // namespace jni
 }  // namespace art
@@ -192,6 +192,25 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
       return std::make_optional(
           statsd::
               ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_GC_FULL_HEAP_COLLECTION_DURATION_MS);
+    // Not reported to statsd yet.
+    case DatumId::kClassVerificationTime:
+    case DatumId::kClassInitializationTotalTime:
+    case DatumId::kClassInitializationCount:
+    case DatumId::kClassInitializationTime:
+    case DatumId::kOpenDexFilesFromOatTotalTime:
+    case DatumId::kOpenDexFilesFromOatCount:
+    case DatumId::kAppImageLoadTotalTime:
+    case DatumId::kBootImageLoadTime:
+    case DatumId::kJitBaselineCompileTotalTime:
+    case DatumId::kJitOptimizedCompileTotalTime:
+    case DatumId::kJitOsrCompileTotalTime:
+    case DatumId::kTimeToSafepoint:
+    case DatumId::kLongTimeToSafepointCount:
+    case DatumId::kNativeGcRequestCount:
+    case DatumId::kNativeGcDeferredCount:
+    case DatumId::kNativeGcReclaimedBytes:
+    case DatumId::kNativeGcExpectedReclaimPercentAvg:
+      return std::nullopt;
   }
 }
 
@@ -98,21 +98,25 @@ inline T* DexCachePair<T>::GetObjectForIndex(uint32_t idx) {
 
 template <typename T>
 inline void DexCachePair<T>::Initialize(std::atomic<DexCachePair<T>>* dex_cache) {
-  DexCachePair<T> first_elem;
-  first_elem.object = GcRoot<T>(nullptr);
-  first_elem.index = InvalidIndexForSlot(0);
-  dex_cache[0].store(first_elem, std::memory_order_relaxed);
+  for (uint32_t slot = 0; slot != kDexCachePairWays; ++slot) {
+    DexCachePair<T> first_elem;
+    first_elem.object = GcRoot<T>(nullptr);
+    first_elem.index = InvalidIndexForSlot(slot);
+    dex_cache[slot].store(first_elem, std::memory_order_relaxed);
+  }
 }
 
 template <typename T>
 inline void NativeDexCachePair<T>::Initialize(std::atomic<NativeDexCachePair<T>>* dex_cache) {
-  NativeDexCachePair<T> first_elem;
-  first_elem.object = nullptr;
-  first_elem.index = InvalidIndexForSlot(0);
-
   auto* array = reinterpret_cast<std::atomic<AtomicPair<uintptr_t>>*>(dex_cache);
-  AtomicPair<uintptr_t> v(reinterpret_cast<size_t>(first_elem.object), first_elem.index);
-  AtomicPairStoreRelease(&array[0], v);
+  for (uint32_t slot = 0; slot != kDexCachePairWays; ++slot) {
+    NativeDexCachePair<T> first_elem;
+    first_elem.object = nullptr;
+    first_elem.index = InvalidIndexForSlot(slot);
+
+    AtomicPair<uintptr_t> v(reinterpret_cast<size_t>(first_elem.object), first_elem.index);
+    AtomicPairStoreRelease(&array[slot], v);
+  }
 }
 
 template <typename T>
@@ -52,6 +52,11 @@ class DexCache;
 class MethodType;
 class String;
 
+// Number of slots an index can be cached in. The pair arrays are split in sets of
+// consecutive slots, an index being cached in any slot of the set its primary slot
+// belongs to.
+static constexpr size_t kDexCachePairWays = 2;
+
 template <typename T> struct PACKED(8) DexCachePair {
   GcRoot<T> object;
   uint32_t index;
@@ -81,9 +86,9 @@ template <typename T> struct PACKED(8) DexCachePair {
   static void Initialize(std::atomic<DexCachePair<T>>* dex_cache);
 
   static uint32_t InvalidIndexForSlot(uint32_t slot) {
-    // Since the cache size is a power of two, 0 will always map to slot 0.
-    // Use 1 for slot 0 and 0 for all other slots.
-    return (slot == 0) ? 1u : 0u;
+    // Since the cache size is a power of two, 0 will always map to the first set.
+    // Use the first index of the second set for the first set and 0 for all other slots.
+    return (slot < kDexCachePairWays) ? kDexCachePairWays : 0u;
   }
 
   T* GetObjectForIndex(uint32_t idx) REQUIRES_SHARED(Locks::mutator_lock_);
@@ -104,9 +109,9 @@ template <typename T> struct PACKED(2 * __SIZEOF_POINTER__) NativeDexCachePair {
   static void Initialize(std::atomic<NativeDexCachePair<T>>* dex_cache);
 
   static uint32_t InvalidIndexForSlot(uint32_t slot) {
-    // Since the cache size is a power of two, 0 will always map to slot 0.
-    // Use 1 for slot 0 and 0 for all other slots.
-    return (slot == 0) ? 1u : 0u;
+    // Since the cache size is a power of two, 0 will always map to the first set.
+    // Use the first index of the second set for the first set and 0 for all other slots.
+    return (slot < kDexCachePairWays) ? kDexCachePairWays : 0u;
   }
 
   T* GetObjectForIndex(uint32_t idx) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -123,13 +128,23 @@ template <typename T, size_t size> class NativeDexCachePairArray {
   NativeDexCachePairArray() {}
 
   T* Get(uint32_t index) REQUIRES_SHARED(Locks::mutator_lock_) {
-    auto pair = GetNativePair(entries_, SlotIndex(index));
-    return pair.GetObjectForIndex(index);
+    uint32_t slot = SlotIndex(index);
+    auto pair = GetNativePair(entries_, slot);
+    if (LIKELY(pair.index == index)) {
+      return pair.GetObjectForIndex(index);
+    }
+    return GetNativePair(entries_, OtherSlot(slot)).GetObjectForIndex(index);
   }
 
   void Set(uint32_t index, T* value) {
+    uint32_t slot = SlotIndex(index);
+    NativeDexCachePair<T> previous = GetNativePair(entries_, slot);
+    if (previous.object != nullptr && previous.index != index) {
+      // Keep the entry we replace in the other way of the set.
+      SetNativePair(entries_, OtherSlot(slot), previous);
+    }
     NativeDexCachePair<T> pair(value, index);
-    SetNativePair(entries_, SlotIndex(index), pair);
+    SetNativePair(entries_, slot, pair);
   }
 
   NativeDexCachePair<T> GetNativePair(uint32_t index) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -159,6 +174,11 @@ template <typename T, size_t size> class NativeDexCachePairArray {
     return index % size;
   }
 
+  static uint32_t OtherSlot(uint32_t slot) {
+    static_assert(kDexCachePairWays == 2u);
+    return slot ^ 1u;
+  }
+
   std::atomic<NativeDexCachePair<T>> entries_[0];
 
   NativeDexCachePairArray(const NativeDexCachePairArray<T, size>&) = delete;
@@ -170,11 +190,22 @@ template <typename T, size_t size> class DexCachePairArray {
   DexCachePairArray() {}
 
   T* Get(uint32_t index) REQUIRES_SHARED(Locks::mutator_lock_) {
-    return GetPair(index).GetObjectForIndex(index);
+    uint32_t slot = SlotIndex(index);
+    DexCachePair<T> pair = entries_[slot].load(std::memory_order_relaxed);
+    if (LIKELY(pair.index == index)) {
+      return pair.GetObjectForIndex(index);
+    }
+    return entries_[OtherSlot(slot)].load(std::memory_order_relaxed).GetObjectForIndex(index);
   }
 
   void Set(uint32_t index, T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
-    SetPair(index, DexCachePair<T>(value, index));
+    uint32_t slot = SlotIndex(index);
+    DexCachePair<T> previous = entries_[slot].load(std::memory_order_relaxed);
+    if (!previous.object.IsNull() && previous.index != index) {
+      // Keep the entry we replace in the other way of the set.
+      entries_[OtherSlot(slot)].store(previous, std::memory_order_relaxed);
+    }
+    entries_[slot].store(DexCachePair<T>(value, index), std::memory_order_relaxed);
   }
 
   DexCachePair<T> GetPair(uint32_t index) {
@@ -186,11 +217,12 @@ template <typename T, size_t size> class DexCachePairArray {
   }
 
   void Clear(uint32_t index) {
-    uint32_t slot = SlotIndex(index);
     // This is racy but should only be called from the transactional interpreter.
-    if (entries_[slot].load(std::memory_order_relaxed).index == index) {
-      DexCachePair<T> cleared(nullptr, DexCachePair<T>::InvalidIndexForSlot(slot));
-      entries_[slot].store(cleared, std::memory_order_relaxed);
+    for (uint32_t slot : {SlotIndex(index), OtherSlot(SlotIndex(index))}) {
+      if (entries_[slot].load(std::memory_order_relaxed).index == index) {
+        DexCachePair<T> cleared(nullptr, DexCachePair<T>::InvalidIndexForSlot(slot));
+        entries_[slot].store(cleared, std::memory_order_relaxed);
+      }
     }
   }
 
@@ -199,6 +231,11 @@ template <typename T, size_t size> class DexCachePairArray {
     return index % size;
   }
 
+  static uint32_t OtherSlot(uint32_t slot) {
+    static_assert(kDexCachePairWays == 2u);
+    return slot ^ 1u;
+  }
+
   std::atomic<DexCachePair<T>> entries_[0];
 
   DexCachePairArray(const DexCachePairArray<T, size>&) = delete;
@@ -387,9 +424,11 @@ class MANAGED DexCache final : public Object {
   void UnlinkStartupCaches() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Returns whether we should allocate a full array given the number of elements.
+  // A full array entry is half the size of a pair, so a full array up to twice the
+  // size of the pair array does not use more memory.
   // Note: update the image version in image.cc if changing this method.
   static bool ShouldAllocateFullArray(size_t number_of_elements, size_t dex_cache_size) {
-    return number_of_elements <= dex_cache_size;
+    return number_of_elements <= 2u * dex_cache_size;
   }
 
 
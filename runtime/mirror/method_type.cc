@@ -121,10 +121,18 @@ size_t MethodType::NumberOfVRegs() {
 }
 
 bool MethodType::IsExactMatch(ObjPtr<MethodType> target) {
+  // Method handle invocations commonly compare a type with itself, or with a type sharing its
+  // parameter array, check for these first.
+  if (this == target.Ptr()) {
+    return true;
+  }
   const ObjPtr<ObjectArray<Class>> p_types = GetPTypes();
   const int32_t params_length = p_types->GetLength();
 
   const ObjPtr<ObjectArray<Class>> target_p_types = target->GetPTypes();
+  if (p_types == target_p_types) {
+    return GetRType() == target->GetRType();
+  }
   if (params_length != target_p_types->GetLength()) {
     return false;
   }
@@ -194,6 +202,9 @@ static bool IsParameterInPlaceConvertible(ObjPtr<Class> from, ObjPtr<Class> to)
 }
 
 bool MethodType::IsInPlaceConvertible(ObjPtr<MethodType> target) {
+  if (this == target.Ptr()) {
+    return true;
+  }
   const ObjPtr<ObjectArray<Class>> ptypes = GetPTypes();
   const ObjPtr<ObjectArray<Class>> target_ptypes = target->GetPTypes();
   const int32_t ptypes_length = ptypes->GetLength();
@@ -86,6 +86,14 @@ TEST_F(MethodTypeTest, IsExactMatch) {
     ASSERT_TRUE(mt1->IsExactMatch(mt2.Get()));
   }
 
+  // Same object.
+  {
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::MethodType> mt = hs.NewHandle(CreateMethodType("String", { "Integer" }));
+    ASSERT_TRUE(mt->IsExactMatch(mt.Get()));
+    ASSERT_TRUE(mt->IsInPlaceConvertible(mt.Get()));
+  }
+
   // Mismatched return type.
   {
     StackHandleScope<2> hs(soa.Self());
@@ -217,7 +217,12 @@ int32_t Object::IdentityHashCode() {
         // Already inflated, return the hash stored in the monitor.
         Monitor* monitor = lw.FatLockMonitor();
         DCHECK(monitor != nullptr);
-        return monitor->GetHashCode();
+        int32_t hash_code = monitor->GetHashCode();
+        if (LIKELY(hash_code != Monitor::kDeflatedHashCode)) {
+          return hash_code;
+        }
+        // The monitor is being deflated concurrently, use the new lock word.
+        break;
       }
       case LockWord::kHashCode: {
         return lw.GetHashCode();
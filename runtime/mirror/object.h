@@ -70,7 +70,9 @@ class Throwable;
 // Checks that we don't do field assignments which violate the typing system.
 static constexpr bool kCheckFieldAssignments = false;
 
-// Size of Object.
+// Size of Object: the class reference followed by the lock word. The header layout is also
+// hard-coded in the compilers, the assembly entrypoints and the GCs, which should refer to this
+// constant (or to the offsets of `klass_` and `monitor_`) rather than assume its value.
 static constexpr uint32_t kObjectHeaderSize = 8;
 
 // C++ mirror of java.lang.Object
@@ -803,6 +805,8 @@ class MANAGED LOCKABLE Object {
   DISALLOW_IMPLICIT_CONSTRUCTORS(Object);
 };
 
+static_assert(sizeof(Object) == kObjectHeaderSize, "Object header size does not match");
+
 }  // namespace mirror
 }  // namespace art
 
@@ -16,11 +16,14 @@
 
 #include "monitor-inl.h"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex.h"
 #include "base/quasi_atomic.h"
@@ -32,6 +35,7 @@
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction-inl.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "gc/heap.h"
 #include "lock_word-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -53,6 +57,16 @@ using android::base::StringPrintf;
 static constexpr uint64_t kDebugThresholdFudgeFactor = kIsDebugBuild ? 10 : 1;
 static constexpr uint64_t kLongWaitMs = 100 * kDebugThresholdFudgeFactor;
 
+// Number of times a thread re-reads a contended thin lock word before it starts yielding.
+static constexpr size_t kThinLockSpinIters = 100;
+// Minimum number of sched_yield() calls a thread does for a contended thin lock before inflating.
+static constexpr size_t kMinThinLockYields = 4;
+
+// Number of sched_yield() calls this thread does for a contended thin lock before inflating it.
+// Halved when the thread had to inflate, since the locks it contends on are held for a long time,
+// and doubled when it got the lock while yielding. Capped by -XX:MaxSpinsBeforeThinLockInflation.
+static thread_local size_t thin_lock_yield_budget = std::numeric_limits<size_t>::max();
+
 /*
  * Every Object has a monitor associated with it, but not every Object is actually locked.  Even
  * the ones that are locked do not need a full-fledged monitor until a) there is actual contention
@@ -1033,6 +1047,52 @@ bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj) {
   return true;
 }
 
+bool Monitor::DeflateConcurrently(Thread* self, ObjPtr<mirror::Object> obj) {
+  DCHECK(obj != nullptr);
+  LockWord lw(obj->GetLockWord(true));
+  if (lw.GetState() != LockWord::kFatLocked) {
+    return false;
+  }
+  Monitor* monitor = lw.FatLockMonitor();
+  DCHECK(monitor != nullptr);
+  // Can't deflate if we have anybody waiting on the CV or trying to acquire the monitor. Nobody
+  // else can own the monitor while we hold monitor_lock_, so the owner is not needed for that.
+  if (monitor->num_waiters_.load(std::memory_order_relaxed) > 0 ||
+      !monitor->monitor_lock_.ExclusiveTryLock(self)) {
+    return false;
+  }
+  // A thread may have started contending after the first check. It is not a problem if we miss
+  // it: it re-checks the lock word once it got the monitor, see MonitorEnter().
+  if (monitor->num_waiters_.load(std::memory_order_relaxed) > 0) {
+    monitor->monitor_lock_.ExclusiveUnlock(self);
+    return false;
+  }
+  DCHECK_EQ(monitor->lock_count_, 0u);
+  DCHECK_EQ(monitor->owner_.load(std::memory_order_relaxed), static_cast<Thread*>(nullptr));
+  // Threads that read the lock word before we replace it can still store a hash code in the
+  // monitor. Prevent that, so that the hash code we put in the lock word is the only one.
+  monitor->hash_code_.CompareAndSetStrongRelaxed(0, kDeflatedHashCode);
+  int32_t hash_code = monitor->hash_code_.load(std::memory_order_relaxed);
+  while (true) {
+    LockWord new_lw = (hash_code != kDeflatedHashCode)
+        ? LockWord::FromHashCode(hash_code, lw.GCState())
+        : LockWord::FromDefault(lw.GCState());
+    // Mutators may not change a fat lock word, but we still need to preserve the GC state.
+    if (obj->CasLockWord(lw, new_lw, CASMode::kStrong, std::memory_order_release)) {
+      break;
+    }
+    lw = obj->GetLockWord(true);
+    DCHECK_EQ(lw.GetState(), LockWord::kFatLocked);
+    DCHECK_EQ(lw.FatLockMonitor(), monitor);
+  }
+  VLOG(monitor) << "Concurrently deflated " << obj << " with hash code " << hash_code;
+  // The monitor is deflated, mark the object as null so that MonitorList knows to delete it once
+  // nobody can be using it anymore.
+  monitor->obj_ = GcRoot<mirror::Object>(nullptr);
+  monitor->monitor_lock_.ExclusiveUnlock(self);
+  return true;
+}
+
 void Monitor::Inflate(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_t hash_code) {
   DCHECK(self != nullptr);
   DCHECK(obj != nullptr);
@@ -1100,6 +1160,15 @@ static ObjPtr<mirror::Object> FakeUnlock(ObjPtr<mirror::Object> obj)
   return obj;
 }
 
+// Return whether the thread owning a thin lock is runnable, and thus likely to release the lock
+// soon.
+static bool IsThinLockOwnerRunnable(Thread* self, uint32_t owner_thread_id)
+    REQUIRES(!Locks::thread_list_lock_) {
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  Thread* owner = Runtime::Current()->GetThreadList()->FindThreadByThreadId(owner_thread_id);
+  return owner != nullptr && owner->GetState() == ThreadState::kRunnable;
+}
+
 ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
                                              ObjPtr<mirror::Object> obj,
                                              bool trylock) {
@@ -1109,7 +1178,6 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
   obj = FakeLock(obj);
   uint32_t thread_id = self->GetThreadId();
   size_t contention_count = 0;
-  constexpr size_t kExtraSpinIters = 100;
   StackHandleScope<1> hs(self);
   Handle<mirror::Object> h_obj(hs.NewHandle(obj));
   while (true) {
@@ -1122,6 +1190,11 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
         // No ordering required for preceding lockword read, since we retest.
         LockWord thin_locked(LockWord::FromThinLockId(thread_id, 0, lock_word.GCState()));
         if (h_obj->CasLockWord(lock_word, thin_locked, CASMode::kWeak, std::memory_order_acquire)) {
+          if (UNLIKELY(contention_count > kThinLockSpinIters)) {
+            // Yielding paid off, be willing to yield longer next time.
+            size_t max_yields = Runtime::Current()->GetMaxSpinsBeforeThinLockInflation();
+            thin_lock_yield_budget = std::min(max_yields, 2 * thin_lock_yield_budget);
+          }
           AtraceMonitorLock(self, h_obj.Get(), /* is_wait= */ false);
           return h_obj.Get();  // Success!
         }
@@ -1165,16 +1238,24 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
           // Contention.
           contention_count++;
           Runtime* runtime = Runtime::Current();
-          if (contention_count
-              <= kExtraSpinIters + runtime->GetMaxSpinsBeforeThinLockInflation()) {
+          size_t yield_budget =
+              std::min(thin_lock_yield_budget, runtime->GetMaxSpinsBeforeThinLockInflation());
+          if (contention_count <= kThinLockSpinIters) {
+            // Critical sections are usually short, just re-read the lock word.
+          } else if (contention_count <= kThinLockSpinIters + yield_budget &&
+                     (contention_count != kThinLockSpinIters + 1u ||
+                      IsThinLockOwnerRunnable(self, owner_thread_id))) {
             // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
             // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much longer
             // than the parameter you pass in. This can cause thread suspension to take excessively
             // long and make long pauses. See b/16307460.
-            if (contention_count > kExtraSpinIters) {
-              sched_yield();
-            }
+            // Do not bother yielding if the owner is blocked or suspended, as it is not going to
+            // release the lock any time soon.
+            sched_yield();
           } else {
+            if (contention_count > kThinLockSpinIters + yield_budget) {
+              thin_lock_yield_budget = std::max(kMinThinLockYields, yield_budget / 2u);
+            }
             contention_count = 0;
             // No ordering required for initial lockword read. Install rereads it anyway.
             InflateThinLocked(self, h_obj, lock_word, 0);
@@ -1188,12 +1269,22 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
         std::atomic_thread_fence(std::memory_order_acquire);
         Monitor* mon = lock_word.FatLockMonitor();
         if (trylock) {
-          return mon->TryLock(self) ? h_obj.Get() : nullptr;
+          if (!mon->TryLock(self)) {
+            return nullptr;
+          }
         } else {
           mon->Lock(self);
-          DCHECK(mon->monitor_lock_.IsExclusiveHeld(self));
-          return h_obj.Get();  // Success!
         }
+        DCHECK(mon->monitor_lock_.IsExclusiveHeld(self));
+        // The monitor may have been deflated concurrently before we got it, in which case the
+        // object's lock has to be acquired again through its new lock word.
+        LockWord new_lock_word = h_obj->GetLockWord(true);
+        if (UNLIKELY(new_lock_word.GetState() != LockWord::kFatLocked ||
+                     new_lock_word.FatLockMonitor() != mon)) {
+          mon->Unlock(self);
+          continue;  // Go again.
+        }
+        return h_obj.Get();  // Success!
       }
       case LockWord::kHashCode:
         // Inflate with the existing hashcode.
@@ -1600,7 +1691,9 @@ uint32_t Monitor::GetOwnerThreadId() {
 
 MonitorList::MonitorList()
     : allow_new_monitors_(true), monitor_list_lock_("MonitorList lock", kMonitorListLock),
-      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_) {
+      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_),
+      concurrent_deflation_threshold_(kMinConcurrentDeflationThreshold),
+      num_deflated_monitors_(0u) {
 }
 
 MonitorList::~MonitorList() {
@@ -1634,17 +1727,29 @@ void MonitorList::BroadcastForNewMonitors() {
 
 void MonitorList::Add(Monitor* m) {
   Thread* self = Thread::Current();
-  MutexLock mu(self, monitor_list_lock_);
-  // CMS needs this to block for concurrent reference processing because an object allocated during
-  // the GC won't be marked and concurrent reference processing would incorrectly clear the JNI weak
-  // ref. But CC (gUseReadBarrier == true) doesn't because of the to-space invariant.
-  while (!gUseReadBarrier && UNLIKELY(!allow_new_monitors_)) {
-    // Check and run the empty checkpoint before blocking so the empty checkpoint will work in the
-    // presence of threads blocking for weak ref access.
-    self->CheckEmptyCheckpointFromWeakRefAccess(&monitor_list_lock_);
-    monitor_add_condition_.WaitHoldingLocks(self);
-  }
-  list_.push_front(m);
+  bool request_deflation;
+  {
+    MutexLock mu(self, monitor_list_lock_);
+    // CMS needs this to block for concurrent reference processing because an object allocated
+    // during the GC won't be marked and concurrent reference processing would incorrectly clear
+    // the JNI weak ref. But CC (gUseReadBarrier == true) doesn't because of the to-space
+    // invariant.
+    while (!gUseReadBarrier && UNLIKELY(!allow_new_monitors_)) {
+      // Check and run the empty checkpoint before blocking so the empty checkpoint will work in
+      // the presence of threads blocking for weak ref access.
+      self->CheckEmptyCheckpointFromWeakRefAccess(&monitor_list_lock_);
+      monitor_add_condition_.WaitHoldingLocks(self);
+    }
+    list_.push_front(m);
+    // Deflated monitors waiting to be freed do not count, they cannot be deflated again.
+    request_deflation =
+        list_.size() - num_deflated_monitors_ >= concurrent_deflation_threshold_;
+  }
+  if (UNLIKELY(request_deflation)) {
+    // Monitors are otherwise only deflated by heap trims in the background, don't let transient
+    // contention grow the monitor pool until then.
+    Runtime::Current()->GetHeap()->RequestConcurrentMonitorDeflation(self);
+  }
 }
 
 void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor) {
@@ -1656,9 +1761,22 @@ void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor) {
     ObjPtr<mirror::Object> obj = m->GetObject<kWithoutReadBarrier>();
     // The object of a monitor can be null if we have deflated it.
     ObjPtr<mirror::Object> new_obj = obj != nullptr ? visitor->IsMarked(obj.Ptr()) : nullptr;
-    if (new_obj == nullptr) {
+    if (obj == nullptr &&
+        (!Locks::mutator_lock_->IsExclusiveHeld(self) ||
+         m->num_waiters_.load(std::memory_order_relaxed) != 0 ||
+         m->GetOwner() != nullptr)) {
+      // Deflated concurrently. A thread that was about to lock the monitor is still using it
+      // until it finds out that the object has a new lock word, and may still be releasing the
+      // monitor lock after it cleared the owner. Without the mutators suspended, leave it to
+      // DeflateMonitorsConcurrently() to free it after a checkpoint.
+      ++it;
+    } else if (new_obj == nullptr) {
       VLOG(monitor) << "freeing monitor " << m << " belonging to unmarked object "
                     << obj;
+      if (obj == nullptr) {
+        DCHECK_NE(num_deflated_monitors_, 0u);
+        --num_deflated_monitors_;
+      }
       MonitorPool::ReleaseMonitor(self, m);
       it = list_.erase(it);
     } else {
@@ -1700,6 +1818,81 @@ size_t MonitorList::DeflateMonitors() {
   return visitor.deflate_count_;
 }
 
+class MonitorDeflationCheckpoint : public Closure {
+ public:
+  explicit MonitorDeflationCheckpoint(Barrier* barrier) : barrier_(barrier) {}
+
+  void Run([[maybe_unused]] Thread* thread) override {
+    // If thread is a running mutator, then act on behalf of the deflating thread.
+    // See the code in ThreadList::RunCheckpoint.
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  Barrier* const barrier_;
+};
+
+size_t MonitorList::DeflateMonitorsConcurrently(Thread* self) {
+  size_t deflate_count = 0;
+  {
+    ScopedObjectAccess soa(self);
+    MutexLock mu(self, monitor_list_lock_);
+    for (Monitor* m : list_) {
+      ObjPtr<mirror::Object> obj = m->GetObject();
+      if (obj != nullptr && Monitor::DeflateConcurrently(self, obj)) {
+        ++deflate_count;
+      }
+    }
+    num_deflated_monitors_ += deflate_count;
+    // Wait for the live monitors to double before trying again, so that deflation does not run
+    // for every inflation of a busy app.
+    concurrent_deflation_threshold_ = std::max(kMinConcurrentDeflationThreshold,
+                                               2u * (list_.size() - num_deflated_monitors_));
+  }
+  if (deflate_count != 0u) {
+    // Threads that read the lock word of an object before it got deflated may still be about to
+    // use its monitor without having registered as a waiter. They do so without passing a
+    // suspend point, so once every thread has passed one, they are known to other threads.
+    RunDeflationCheckpoint(self);
+  }
+  // Free the deflated monitors that nobody owns or waits for. A thread that just found out
+  // about the deflation may still be inside Unlock() after it cleared the owner, and only
+  // passes a suspend point once it is done with the monitor.
+  Monitors to_free;
+  {
+    ScopedObjectAccess soa(self);
+    MutexLock mu(self, monitor_list_lock_);
+    for (auto it = list_.begin(); it != list_.end(); ) {
+      Monitor* m = *it;
+      if (m->GetObject<kWithoutReadBarrier>() == nullptr &&
+          m->num_waiters_.load(std::memory_order_relaxed) == 0 &&
+          m->GetOwner() == nullptr) {
+        to_free.splice(to_free.end(), list_, it++);
+      } else {
+        ++it;
+      }
+    }
+    DCHECK_LE(to_free.size(), num_deflated_monitors_);
+    num_deflated_monitors_ -= to_free.size();
+  }
+  if (!to_free.empty()) {
+    RunDeflationCheckpoint(self);
+    VLOG(monitor) << "freeing " << to_free.size() << " concurrently deflated monitors";
+    MonitorPool::ReleaseMonitors(self, &to_free);
+  }
+  return deflate_count;
+}
+
+void MonitorList::RunDeflationCheckpoint(Thread* self) {
+  Barrier barrier(0);
+  MonitorDeflationCheckpoint closure(&barrier);
+  ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+  size_t barrier_count = Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+  if (barrier_count != 0) {
+    barrier.Increment(self, barrier_count);
+  }
+}
+
 MonitorInfo::MonitorInfo(ObjPtr<mirror::Object> obj) : owner_(nullptr), entry_count_(0) {
   DCHECK(obj != nullptr);
   LockWord lock_word = obj->GetLockWord(true);
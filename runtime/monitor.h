@@ -164,6 +164,14 @@ class Monitor {
   static bool Deflate(Thread* self, ObjPtr<mirror::Object> obj)
       REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
 
+  // Deflate the monitor of obj while mutators are running, if nobody owns, waits on or contends
+  // for it. Returns whether the monitor was deflated. Must be called with the GC blocked so that
+  // the read barrier state of the lock word does not change; threads that read the lock word
+  // before it was deflated may still use the monitor until they pass a suspend point.
+  // NO_THREAD_SAFETY_ANALYSIS for monitor->monitor_lock_.
+  static bool DeflateConcurrently(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
+
 #ifndef __LP64__
   void* operator new(size_t size) {
     // Align Monitor* as per the monitor ID field size in the lock word.
@@ -348,6 +356,11 @@ class Monitor {
   // Stored object hash code, generated lazily by GetHashCode.
   AtomicInteger hash_code_;
 
+  // Hash code stored in a monitor deflated concurrently without a hash code, so that a thread
+  // still using the monitor cannot give the object a hash code the lock word does not record.
+  // Not a valid identity hash code as these are limited to LockWord::kHashMask.
+  static constexpr int32_t kDeflatedHashCode = -1;
+
   // Data structure used to remember the method and dex pc of a recent holder of the
   // lock. Used for tracing and contention reporting. Setting these is expensive, since it
   // involves a partial stack walk. We set them only as follows, to minimize the cost:
@@ -450,11 +463,23 @@ class MonitorList {
   void BroadcastForNewMonitors() REQUIRES(!monitor_list_lock_);
   // Returns how many monitors were deflated.
   size_t DeflateMonitors() REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
+  // Deflate the idle monitors without suspending the mutators, and free the deflated monitors
+  // once no thread can still be using them. Must be called with the GC blocked. Returns how many
+  // monitors were deflated.
+  size_t DeflateMonitorsConcurrently(Thread* self)
+      REQUIRES(!monitor_list_lock_, !Locks::mutator_lock_);
   size_t Size() REQUIRES(!monitor_list_lock_);
 
   using Monitors = std::list<Monitor*, TrackingAllocator<Monitor*, kAllocatorTagMonitorList>>;
 
  private:
+  // Minimum number of live monitors in the list before a concurrent deflation is requested.
+  static constexpr size_t kMinConcurrentDeflationThreshold = 1024;
+
+  // Wait until every thread has passed a suspend point.
+  void RunDeflationCheckpoint(Thread* self)
+      REQUIRES(!monitor_list_lock_, !Locks::mutator_lock_);
+
   // During sweeping we may free an object and on a separate thread have an object created using
   // the newly freed memory. That object may then have its lock-word inflated and a monitor created.
   // If we allow new monitor registration during sweeping this monitor may be incorrectly freed as
@@ -463,6 +488,10 @@ class MonitorList {
   Mutex monitor_list_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable monitor_add_condition_ GUARDED_BY(monitor_list_lock_);
   Monitors list_ GUARDED_BY(monitor_list_lock_);
+  // Number of live monitors above which a concurrent deflation is requested from the heap.
+  size_t concurrent_deflation_threshold_ GUARDED_BY(monitor_list_lock_);
+  // Number of monitors in the list that were deflated concurrently and are not freed yet.
+  size_t num_deflated_monitors_ GUARDED_BY(monitor_list_lock_);
 
   friend class Monitor;
   DISALLOW_COPY_AND_ASSIGN(MonitorList);
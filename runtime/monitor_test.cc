@@ -391,5 +391,130 @@ TEST_F(MonitorTest, TestTryLock) {
   thread_pool.StopWorkers(self);
 }
 
+TEST_F(MonitorTest, DeflateMonitorsConcurrently) {
+  Thread* const self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<3> hs(self);
+  Handle<mirror::Object> hashed(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hashed")));
+  Handle<mirror::Object> unhashed(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "unhashed")));
+  Handle<mirror::Object> held(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "held")));
+  int32_t hash_code;
+  {
+    // Taking the identity hash code of a thin locked object inflates it.
+    ObjectLock<mirror::Object> lock(self, hashed);
+    hash_code = hashed->IdentityHashCode();
+  }
+  {
+    ObjectLock<mirror::Object> lock(self, unhashed);
+    Monitor::InflateThinLocked(self, unhashed, unhashed->GetLockWord(true), 0);
+  }
+  ObjectLock<mirror::Object> held_lock(self, held);
+  Monitor::InflateThinLocked(self, held, held->GetLockWord(true), 0);
+  ASSERT_EQ(hashed->GetLockWord(true).GetState(), LockWord::kFatLocked);
+  ASSERT_EQ(unhashed->GetLockWord(true).GetState(), LockWord::kFatLocked);
+  ASSERT_EQ(held->GetLockWord(true).GetState(), LockWord::kFatLocked);
+
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    Runtime::Current()->GetHeap()->DeflateMonitorsConcurrently(self);
+  }
+
+  EXPECT_EQ(hashed->GetLockWord(true).GetState(), LockWord::kHashCode);
+  EXPECT_EQ(hashed->IdentityHashCode(), hash_code);
+  EXPECT_EQ(unhashed->GetLockWord(true).GetState(), LockWord::kUnlocked);
+  // Monitors that are held cannot be deflated.
+  EXPECT_EQ(held->GetLockWord(true).GetState(), LockWord::kFatLocked);
+  {
+    // The deflated objects can be locked again.
+    ObjectLock<mirror::Object> lock(self, unhashed);
+    EXPECT_EQ(unhashed->GetLockWord(true).GetState(), LockWord::kThinLocked);
+  }
+}
+
+class ContendedLockTask : public Task {
+ public:
+  ContendedLockTask(jobject obj, size_t* counter, Atomic<size_t>* finished)
+      : obj_(obj), counter_(counter), finished_(finished) {}
+
+  void Run(Thread* self) override {
+    {
+      ScopedObjectAccess soa(self);
+      StackHandleScope<1u> hs(self);
+      Handle<mirror::Object> obj = hs.NewHandle(soa.Decode<mirror::Object>(obj_));
+      for (size_t i = 0; i != kIterations; ++i) {
+        ObjectLock<mirror::Object> lock(self, obj);
+        // The object has a hash code, so this lock is always inflated.
+        ++*counter_;
+      }
+    }
+    finished_->fetch_add(1u, std::memory_order_release);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+  static constexpr size_t kIterations = 20000;
+
+ private:
+  jobject obj_;
+  size_t* const counter_;
+  Atomic<size_t>* const finished_;
+};
+
+// Test that concurrent deflations and GCs do not break contended locking.
+TEST_F(MonitorTest, ContendedLockingWithConcurrentDeflation) {
+  static constexpr size_t kNumThreads = 4;
+  Thread* const self = Thread::Current();
+  ThreadPool thread_pool("contended lock pool", kNumThreads);
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "contended")));
+  // Inflate the lock each time it is taken after being deflated.
+  obj->IdentityHashCode();
+  jobject g_obj = soa.Vm()->AddGlobalRef(self, obj.Get());
+  ASSERT_TRUE(g_obj != nullptr);
+  size_t counter = 0u;
+  Atomic<size_t> finished(0u);
+  for (size_t i = 0; i != kNumThreads; ++i) {
+    thread_pool.AddTask(self, new ContendedLockTask(g_obj, &counter, &finished));
+  }
+  thread_pool.StartWorkers(self);
+  for (size_t round = 0; finished.load(std::memory_order_acquire) != kNumThreads; ++round) {
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kNative);
+      Runtime::Current()->GetHeap()->DeflateMonitorsConcurrently(self);
+    }
+    if (round % 8 == 0) {
+      // Let the GC sweep the monitor list while the deflated monitors may be in use.
+      Runtime::Current()->GetHeap()->CollectGarbage(/*clear_soft_references=*/ false);
+    }
+  }
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+    thread_pool.Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  }
+  thread_pool.StopWorkers(self);
+  EXPECT_EQ(counter, kNumThreads * ContendedLockTask::kIterations);
+
+  // The last monitor of the object is deflated and freed without waiting for a GC.
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+  }
+  MonitorList* monitor_list = Runtime::Current()->GetMonitorList();
+  ASSERT_EQ(obj->GetLockWord(true).GetState(), LockWord::kFatLocked);
+  size_t monitors_before = monitor_list->Size();
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    Runtime::Current()->GetHeap()->DeflateMonitorsConcurrently(self);
+  }
+  EXPECT_EQ(obj->GetLockWord(true).GetState(), LockWord::kHashCode);
+  EXPECT_LT(monitor_list->Size(), monitors_before);
+  soa.Vm()->DeleteGlobalRef(self, g_obj);
+}
 
 }  // namespace art
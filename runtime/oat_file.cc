@@ -1127,6 +1127,14 @@ class DlOpenOatFile final : public OatFileBase {
         shared_objects_before_(0) {
   }
 
+  // Returns whether dlopen can be used for an oat file opened with these flags. Checked before
+  // creating a DlOpenOatFile, so that a doomed attempt does not pay for PreLoad()'s walk over
+  // all the loaded shared objects.
+  static bool CanLoad(bool writable,
+                      bool executable,
+                      bool low_4gb,
+                      /*out*/std::string* error_msg);
+
   ~DlOpenOatFile() {
     if (dlopen_handle_ != nullptr) {
       if (!kIsTargetBuild) {
@@ -1225,12 +1233,10 @@ void DlOpenOatFile::PreLoad() {
 #endif
 }
 
-bool DlOpenOatFile::Load(const std::string& elf_filename,
-                         bool writable,
-                         bool executable,
-                         bool low_4gb,
-                         /*inout*/MemMap* reservation,  // Where to load if not null.
-                         /*out*/std::string* error_msg) {
+bool DlOpenOatFile::CanLoad(bool writable,
+                            bool executable,
+                            bool low_4gb,
+                            /*out*/std::string* error_msg) {
   // Use dlopen only when flagged to do so, and when it's OK to load things executable.
   // TODO: Also try when not executable? The issue here could be re-mapping as writable (as
   //       !executable is a sign that we may want to patch), which may not be allowed for
@@ -1262,6 +1268,18 @@ bool DlOpenOatFile::Load(const std::string& elf_filename,
       return false;
     }
   }
+  return true;
+}
+
+bool DlOpenOatFile::Load(const std::string& elf_filename,
+                         bool writable,
+                         bool executable,
+                         bool low_4gb,
+                         /*inout*/MemMap* reservation,  // Where to load if not null.
+                         /*out*/std::string* error_msg) {
+  if (!CanLoad(writable, executable, low_4gb, error_msg)) {
+    return false;
+  }
 
   bool success = Dlopen(elf_filename, reservation, error_msg);
   DCHECK_IMPLIES(dlopen_handle_ == nullptr, !success);
@@ -1918,21 +1936,23 @@ OatFile* OatFile::Open(int zip_fd,
     return nullptr;
   }
 
-  // Try dlopen first, as it is required for native debuggability. This will fail fast if dlopen is
-  // disabled.
-  OatFile* with_dlopen = OatFileBase::OpenOatFile<DlOpenOatFile>(zip_fd,
-                                                                 vdex_filename,
-                                                                 oat_filename,
-                                                                 oat_location,
-                                                                 /*writable=*/false,
-                                                                 executable,
-                                                                 low_4gb,
-                                                                 dex_filenames,
-                                                                 dex_fds,
-                                                                 reservation,
-                                                                 error_msg);
-  if (with_dlopen != nullptr) {
-    return with_dlopen;
+  // Try dlopen first, as it is required for native debuggability. Skip it entirely if dlopen
+  // cannot be used, e.g. for the non-executable opens done when checking the status of oat files.
+  if (DlOpenOatFile::CanLoad(/*writable=*/false, executable, low_4gb, error_msg)) {
+    OatFile* with_dlopen = OatFileBase::OpenOatFile<DlOpenOatFile>(zip_fd,
+                                                                   vdex_filename,
+                                                                   oat_filename,
+                                                                   oat_location,
+                                                                   /*writable=*/false,
+                                                                   executable,
+                                                                   low_4gb,
+                                                                   dex_filenames,
+                                                                   dex_fds,
+                                                                   reservation,
+                                                                   error_msg);
+    if (with_dlopen != nullptr) {
+      return with_dlopen;
+    }
   }
   if (kPrintDlOpenErrorMessage) {
     LOG(ERROR) << "Failed to dlopen: " << oat_filename << " with error " << *error_msg;
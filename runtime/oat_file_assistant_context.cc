@@ -177,6 +177,51 @@ const std::vector<std::string>* OatFileAssistantContext::GetBcpChecksums(size_t
   return &bcp_checksums;
 }
 
+static bool IsSameFile(const struct stat& lhs, const struct stat& rhs) {
+  return lhs.st_dev == rhs.st_dev &&
+         lhs.st_ino == rhs.st_ino &&
+         lhs.st_size == rhs.st_size &&
+         lhs.st_mtim.tv_sec == rhs.st_mtim.tv_sec &&
+         lhs.st_mtim.tv_nsec == rhs.st_mtim.tv_nsec;
+}
+
+bool OatFileAssistantContext::GetDexChecksums(const std::string& dex_location,
+                                              int zip_fd,
+                                              std::vector<uint32_t>* checksums,
+                                              bool* only_contains_uncompressed_dex,
+                                              std::string* error_msg) {
+  struct stat file_stat;
+  int stat_result =
+      zip_fd >= 0 ? fstat(zip_fd, &file_stat) : stat(dex_location.c_str(), &file_stat);
+  bool has_stat = stat_result == 0;
+  if (has_stat) {
+    std::lock_guard<std::mutex> lock(dex_checksums_lock_);
+    auto it = dex_checksums_by_location_.find(dex_location);
+    if (it != dex_checksums_by_location_.end() && IsSameFile(it->second.file_stat, file_stat)) {
+      *checksums = it->second.checksums;
+      *only_contains_uncompressed_dex = it->second.only_contains_uncompressed_dex;
+      return true;
+    }
+  }
+
+  std::vector<std::string> dex_locations_ignored;
+  if (!ArtDexFileLoader::GetMultiDexChecksums(dex_location.c_str(),
+                                              checksums,
+                                              &dex_locations_ignored,
+                                              error_msg,
+                                              zip_fd,
+                                              only_contains_uncompressed_dex)) {
+    return false;
+  }
+
+  if (has_stat) {
+    std::lock_guard<std::mutex> lock(dex_checksums_lock_);
+    dex_checksums_by_location_.insert_or_assign(
+        dex_location, DexChecksumsEntry{file_stat, *checksums, *only_contains_uncompressed_dex});
+  }
+  return true;
+}
+
 const std::string& OatFileAssistantContext::GetApexVersions() {
   if (apex_versions_.has_value()) {
     return apex_versions_.value();
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_OAT_FILE_ASSISTANT_CONTEXT_H_
 #define ART_RUNTIME_OAT_FILE_ASSISTANT_CONTEXT_H_
 
+#include <sys/stat.h>
+
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -30,7 +33,7 @@ namespace art {
 // A helper class for OatFileAssistant that fetches and caches information including boot image
 // checksums, bootclasspath checksums, and APEX versions. The same instance can be reused across
 // OatFileAssistant calls on different dex files for different instruction sets.
-// This class is not thread-safe until `FetchAll` is called.
+// This class is not thread-safe until `FetchAll` is called, except for `GetDexChecksums`.
 class OatFileAssistantContext {
  public:
   // Options that a runtime would take.
@@ -76,12 +79,28 @@ class OatFileAssistantContext {
   // Returns a string that represents the apex versions of boot classpath jars. See
   // `Runtime::apex_versions_` for the encoding format.
   const std::string& GetApexVersions();
+  // Fetches the checksums of the dex files in `dex_location` (or `zip_fd` if valid), like
+  // `ArtDexFileLoader::GetMultiDexChecksums`. The result is cached and reused for as long as the
+  // device, inode, size and modification time of the file do not change. Thread-safe.
+  bool GetDexChecksums(const std::string& dex_location,
+                       int zip_fd,
+                       std::vector<uint32_t>* checksums,
+                       bool* only_contains_uncompressed_dex,
+                       std::string* error_msg);
 
  private:
+  struct DexChecksumsEntry {
+    struct stat file_stat;
+    std::vector<uint32_t> checksums;
+    bool only_contains_uncompressed_dex;
+  };
+
   std::unique_ptr<RuntimeOptions> runtime_options_;
   std::unordered_map<InstructionSet, std::vector<BootImageInfo>> boot_image_info_list_by_isa_;
   std::unordered_map<size_t, std::vector<std::string>> bcp_checksums_by_index_;
   std::optional<std::string> apex_versions_;
+  std::mutex dex_checksums_lock_;
+  std::unordered_map<std::string, DexChecksumsEntry> dex_checksums_by_location_;
 };
 
 }  // namespace art
@@ -19,7 +19,9 @@
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <sys/param.h>
+#include <sys/stat.h>
 
+#include <fstream>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -37,6 +39,7 @@
 #include "class_linker.h"
 #include "class_loader_context.h"
 #include "common_runtime_test.h"
+#include "dex/art_dex_file_loader.h"
 #include "dexopt_test.h"
 #include "oat.h"
 #include "oat_file.h"
@@ -1012,6 +1015,82 @@ TEST_P(OatFileAssistantTest, MultiDexNonMainOutOfDate) {
   ExpectHasDexFiles(&oat_file_assistant, true);
 }
 
+// Case: The same OatFileAssistantContext is asked for the dex checksums of an unchanged file.
+// Expect: The cached checksums are returned without reading the file again.
+TEST_P(OatFileAssistantTest, DexChecksumsCacheHit) {
+  std::string dex_location = GetScratchDir() + "/DexChecksumsCacheHit.jar";
+  Copy(GetMultiDexSrc1(), dex_location);
+
+  std::vector<uint32_t> checksums;
+  bool only_contains_uncompressed_dex = false;
+  std::string error_msg;
+  ASSERT_TRUE(ofa_context_->GetDexChecksums(
+      dex_location, /*zip_fd=*/-1, &checksums, &only_contains_uncompressed_dex, &error_msg))
+      << error_msg;
+  ASSERT_EQ(2u, checksums.size());
+
+  // Overwrite the file in place with garbage of the same size and restore its timestamps, so
+  // that it looks unchanged to the cache but can no longer be parsed as a zip file.
+  struct stat file_stat;
+  ASSERT_EQ(0, stat(dex_location.c_str(), &file_stat));
+  {
+    std::ofstream stream(dex_location, std::ios::binary | std::ios::in | std::ios::out);
+    stream << std::string(file_stat.st_size, '\0');
+  }
+  const struct timespec times[] = {file_stat.st_atim, file_stat.st_mtim};
+  ASSERT_EQ(0, utimensat(AT_FDCWD, dex_location.c_str(), times, /*flags=*/0));
+
+  std::vector<uint32_t> cached_checksums;
+  bool cached_only_contains_uncompressed_dex = !only_contains_uncompressed_dex;
+  ASSERT_TRUE(ofa_context_->GetDexChecksums(dex_location,
+                                            /*zip_fd=*/-1,
+                                            &cached_checksums,
+                                            &cached_only_contains_uncompressed_dex,
+                                            &error_msg))
+      << error_msg;
+  EXPECT_EQ(checksums, cached_checksums);
+  EXPECT_EQ(only_contains_uncompressed_dex, cached_only_contains_uncompressed_dex);
+}
+
+// Case: The dex file is rewritten after its checksums have been cached.
+// Expect: The cache entry is invalidated and the new checksums are returned.
+TEST_P(OatFileAssistantTest, DexChecksumsCacheInvalidatedOnRewrite) {
+  std::string dex_location = GetScratchDir() + "/DexChecksumsCacheInvalidatedOnRewrite.jar";
+  Copy(GetMultiDexSrc1(), dex_location);
+
+  std::vector<uint32_t> old_checksums;
+  bool only_contains_uncompressed_dex = false;
+  std::string error_msg;
+  ASSERT_TRUE(ofa_context_->GetDexChecksums(
+      dex_location, /*zip_fd=*/-1, &old_checksums, &only_contains_uncompressed_dex, &error_msg))
+      << error_msg;
+
+  // GetMultiDexSrc2 has a different checksum for the secondary dex file. File timestamps can be
+  // coarser than the time it takes to rewrite the file, so move the modification time forward
+  // explicitly rather than relying on the clock.
+  struct stat file_stat;
+  ASSERT_EQ(0, stat(dex_location.c_str(), &file_stat));
+  Copy(GetMultiDexSrc2(), dex_location);
+  struct timespec times[] = {file_stat.st_atim, file_stat.st_mtim};
+  times[1].tv_sec += 1;
+  ASSERT_EQ(0, utimensat(AT_FDCWD, dex_location.c_str(), times, /*flags=*/0));
+
+  std::vector<uint32_t> expected_checksums;
+  std::vector<std::string> dex_locations_ignored;
+  ASSERT_TRUE(ArtDexFileLoader::GetMultiDexChecksums(dex_location.c_str(),
+                                                     &expected_checksums,
+                                                     &dex_locations_ignored,
+                                                     &error_msg))
+      << error_msg;
+  ASSERT_NE(old_checksums, expected_checksums);
+
+  std::vector<uint32_t> new_checksums;
+  ASSERT_TRUE(ofa_context_->GetDexChecksums(
+      dex_location, /*zip_fd=*/-1, &new_checksums, &only_contains_uncompressed_dex, &error_msg))
+      << error_msg;
+  EXPECT_EQ(expected_checksums, new_checksums);
+}
+
 // Case: We have a DEX file and an OAT file out of date with respect to the
 // dex checksum.
 TEST_P(OatFileAssistantTest, OatDexOutOfDate) {
@@ -29,6 +29,7 @@
 #include "base/bit_vector-inl.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
+#include "base/metrics/metrics.h"
 #include "base/mutex-inl.h"
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
@@ -181,6 +182,8 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     const OatFile** out_oat_file,
     std::vector<std::string>* error_msgs) {
   ScopedTrace trace(StringPrintf("%s(%s)", __FUNCTION__, dex_location));
+  metrics::AutoTimer timer{GetMetrics()->OpenDexFilesFromOatTotalTime()};
+  GetMetrics()->OpenDexFilesFromOatCount()->AddOne();
   CHECK(dex_location != nullptr);
   CHECK(error_msgs != nullptr);
 
@@ -261,6 +264,7 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
       }
 
       ScopedTrace app_image_timing("AppImage:Loading");
+      metrics::AutoTimer app_image_timer{GetMetrics()->AppImageLoadTotalTime()};
 
       // We need to throw away the image space if we are debuggable but the oat-file source of the
       // image is not otherwise we might get classes with inlined methods or other such things.
@@ -342,6 +346,7 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
           }
         }
       }
+      app_image_timer.Stop();
       if (!added_image_space) {
         DCHECK(dex_files.empty());
 
@@ -195,6 +195,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::BootClassPathLocations)
       .Define("-Xjniopts:forcecopy")
           .IntoKey(M::JniOptsForceCopy)
+      .Define("-Xjniopts:leafnatives")
+          .IntoKey(M::JniOptsLeafNatives)
       .Define("-XjdwpProvider:_")
           .WithType<JdwpProvider>()
           .IntoKey(M::JdwpProvider)
@@ -212,6 +214,16 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ConcGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ConcGCThreads)
+      .Define("-XX:RuntimeThreadsForegroundCpus=_")
+          .WithMetavar("CPU[-CPU][,CPU[-CPU]...]")
+          .WithHelp("CPUs the GC and JIT threads run on in the foreground.")
+          .WithType<std::string>()
+          .IntoKey(M::RuntimeThreadsForegroundCpus)
+      .Define("-XX:RuntimeThreadsBackgroundCpus=_")
+          .WithMetavar("CPU[-CPU][,CPU[-CPU]...]")
+          .WithHelp("CPUs the GC and JIT threads run on in the background.")
+          .WithType<std::string>()
+          .IntoKey(M::RuntimeThreadsBackgroundCpus)
       .Define("-XX:FinalizerTimeoutMs=_")
           .WithType<unsigned int>()
           .IntoKey(M::FinalizerTimeoutMs)
@@ -224,6 +236,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:LongGCLogThreshold=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::LongGCLogThreshold)
+      .Define("-XX:GcPauseTargetMs=_")
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::GcPauseTarget)
       .Define("-XX:DumpGCPerformanceOnShutdown")
           .IntoKey(M::DumpGCPerformanceOnShutdown)
       .Define("-XX:DumpRegionInfoBeforeGC")
@@ -271,6 +286,21 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::UseProfiledJitCompilation)
+      .Define("-Xjitprecompileappprofile:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITPrecompileAppProfile)
+      .Define("-Xjitverifyappprofileclasses:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITVerifyAppProfileClasses)
+      .Define("-Xjitadaptivethreshold:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITAdaptiveOptimizeThreshold)
+      .Define("-Xjitzygoteappprofiles:_")
+          .WithType<ParseStringList<':'>>()  // std::vector<std::string>, split by :
+          .IntoKey(M::JITZygoteAppProfiles)
       .Define("-Xjitinitialsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheInitialCapacity)
@@ -292,6 +322,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitpoolthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITPoolThreads)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -347,6 +380,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xstackdumplockprofthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::StackDumpLockProfThreshold)
+      .Define("-XX:MutexContentionProfiling:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::MutexContentionProfiling)
       .Define("-Xmethod-trace")
           .IntoKey(M::MethodTrace)
       .Define("-Xmethod-trace-file:_")
@@ -124,6 +124,12 @@ class CatchBlockStackVisitor final : public StackVisitor {
       REQUIRES_SHARED(Locks::mutator_lock_) {
     uint32_t dex_pc = dex::kDexNoIndex;
     if (!method->IsNative()) {
+      // A method without try items cannot catch the exception, so avoid decoding the dex pc of its
+      // frame. It is still needed to clean up a shadow frame prepared for the debugger.
+      if (method->DexInstructionData().TriesSize() == 0u &&
+          LIKELY(!GetThread()->HasDebuggerShadowFrames())) {
+        return true;  // Continue stack walk.
+      }
       dex_pc = GetDexPc();
     }
     if (dex_pc != dex::kDexNoIndex) {
@@ -708,7 +714,10 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
   // can be reused when debugging support (like breakpoints) are no longer
   // needed fot this method.
   if (Runtime::Current()->UseJitCompilation() && (kind != DeoptimizationKind::kDebugging)) {
-    Runtime::Current()->GetJit()->GetCodeCache()->InvalidateCompiledCodeFor(
+    jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
+    // Let the next compilation of the method know not to speculate the same way again.
+    code_cache->RecordDeoptimization(deopt_method, self_, kind);
+    code_cache->InvalidateCompiledCodeFor(
         deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader());
   } else {
     Runtime::Current()->GetInstrumentation()->InitializeMethodsCode(
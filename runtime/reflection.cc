@@ -259,15 +259,17 @@ class ArgArray {
         }
       }
 
-#define DO_FIRST_ARG(match_descriptor, get_fn, append) { \
-          if (LIKELY(arg != nullptr && \
-              arg->GetClass()->DescriptorEquals(match_descriptor))) { \
+      // The boxed classes are identified by pointer, this avoids comparing the descriptor of
+      // the argument's class with each candidate.
+#define BOXED_CLASS(box) WellKnownClasses::java_lang_ ## box ## _valueOf->GetDeclaringClass()
+
+#define DO_FIRST_ARG(box, get_fn, append) { \
+          if (LIKELY(arg != nullptr && arg->GetClass() == BOXED_CLASS(box))) { \
             ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
-#define DO_ARG(match_descriptor, get_fn, append) \
-          } else if (LIKELY(arg != nullptr && \
-                            arg->GetClass<>()->DescriptorEquals(match_descriptor))) { \
+#define DO_ARG(box, get_fn, append) \
+          } else if (LIKELY(arg != nullptr && arg->GetClass() == BOXED_CLASS(box))) { \
             ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
@@ -293,54 +295,54 @@ class ArgArray {
           Append(arg.Get());
           break;
         case 'Z':
-          DO_FIRST_ARG("Ljava/lang/Boolean;", GetBoolean, Append)
+          DO_FIRST_ARG(Boolean, GetBoolean, Append)
           DO_FAIL("boolean")
           break;
         case 'B':
-          DO_FIRST_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Byte, GetByte, Append)
           DO_FAIL("byte")
           break;
         case 'C':
-          DO_FIRST_ARG("Ljava/lang/Character;", GetChar, Append)
+          DO_FIRST_ARG(Character, GetChar, Append)
           DO_FAIL("char")
           break;
         case 'S':
-          DO_FIRST_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Short, GetShort, Append)
+          DO_ARG(Byte, GetByte, Append)
           DO_FAIL("short")
           break;
         case 'I':
-          DO_FIRST_ARG("Ljava/lang/Integer;", GetInt, Append)
-          DO_ARG("Ljava/lang/Character;", GetChar, Append)
-          DO_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Integer, GetInt, Append)
+          DO_ARG(Character, GetChar, Append)
+          DO_ARG(Short, GetShort, Append)
+          DO_ARG(Byte, GetByte, Append)
           DO_FAIL("int")
           break;
         case 'J':
-          DO_FIRST_ARG("Ljava/lang/Long;", GetLong, AppendWide)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendWide)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendWide)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendWide)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendWide)
+          DO_FIRST_ARG(Long, GetLong, AppendWide)
+          DO_ARG(Integer, GetInt, AppendWide)
+          DO_ARG(Character, GetChar, AppendWide)
+          DO_ARG(Short, GetShort, AppendWide)
+          DO_ARG(Byte, GetByte, AppendWide)
           DO_FAIL("long")
           break;
         case 'F':
-          DO_FIRST_ARG("Ljava/lang/Float;", GetFloat, AppendFloat)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendFloat)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendFloat)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendFloat)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendFloat)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendFloat)
+          DO_FIRST_ARG(Float, GetFloat, AppendFloat)
+          DO_ARG(Long, GetLong, AppendFloat)
+          DO_ARG(Integer, GetInt, AppendFloat)
+          DO_ARG(Character, GetChar, AppendFloat)
+          DO_ARG(Short, GetShort, AppendFloat)
+          DO_ARG(Byte, GetByte, AppendFloat)
           DO_FAIL("float")
           break;
         case 'D':
-          DO_FIRST_ARG("Ljava/lang/Double;", GetDouble, AppendDouble)
-          DO_ARG("Ljava/lang/Float;", GetFloat, AppendDouble)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendDouble)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendDouble)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendDouble)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendDouble)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendDouble)
+          DO_FIRST_ARG(Double, GetDouble, AppendDouble)
+          DO_ARG(Float, GetFloat, AppendDouble)
+          DO_ARG(Long, GetLong, AppendDouble)
+          DO_ARG(Integer, GetInt, AppendDouble)
+          DO_ARG(Character, GetChar, AppendDouble)
+          DO_ARG(Short, GetShort, AppendDouble)
+          DO_ARG(Byte, GetByte, AppendDouble)
           DO_FAIL("double")
           break;
 #ifndef NDEBUG
@@ -352,6 +354,7 @@ class ArgArray {
 #undef DO_FIRST_ARG
 #undef DO_ARG
 #undef DO_FAIL
+#undef BOXED_CLASS
     }
     return true;
   }
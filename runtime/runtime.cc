@@ -39,6 +39,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "android-base/parseint.h"
 #include "android-base/strings.h"
 
 #include "aot_class_linker.h"
@@ -174,6 +175,7 @@
 #include "signal_set.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "ti/agent.h"
 #include "trace.h"
 #include "transaction.h"
@@ -235,6 +237,32 @@ void CheckConstants() {
   CHECK_EQ(mirror::Array::kFirstElementOffset, mirror::Array::FirstElementOffset());
 }
 
+// Parse a list of CPUs such as "0-3,6" given to the runtime option `option`.
+std::optional<cpu_set_t> ParseCpuList(const char* option, const std::string& list) {
+  if (list.empty()) {
+    return std::nullopt;
+  }
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (const std::string& range : android::base::Split(list, ",")) {
+    std::vector<std::string> bounds = android::base::Split(range, "-");
+    unsigned int first;
+    unsigned int last;
+    if (bounds.size() > 2u ||
+        !android::base::ParseUint(bounds.front(), &first) ||
+        !android::base::ParseUint(bounds.back(), &last) ||
+        first > last ||
+        last >= CPU_SETSIZE) {
+      LOG(WARNING) << "Ignoring invalid CPU list for " << option << ": " << list;
+      return std::nullopt;
+    }
+    for (unsigned int cpu = first; cpu <= last; ++cpu) {
+      CPU_SET(cpu, &cpus);
+    }
+  }
+  return cpus;
+}
+
 }  // namespace
 
 Runtime::Runtime()
@@ -1466,6 +1494,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   Thread::SetSensitiveThreadHook(runtime_options.GetOrDefault(Opt::HookIsSensitiveThread));
   Monitor::Init(runtime_options.GetOrDefault(Opt::LockProfThreshold),
                 runtime_options.GetOrDefault(Opt::StackDumpLockProfThreshold));
+  MutexContentionProfiler::SetEnabled(runtime_options.GetOrDefault(Opt::MutexContentionProfiling));
 
   image_locations_ = runtime_options.ReleaseOrDefault(Opt::Image);
 
@@ -1498,6 +1527,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   class_path_string_ = runtime_options.ReleaseOrDefault(Opt::ClassPath);
   properties_ = runtime_options.ReleaseOrDefault(Opt::PropertiesList);
+  runtime_threads_foreground_cpus_ =
+      ParseCpuList("-XX:RuntimeThreadsForegroundCpus",
+                   runtime_options.GetOrDefault(Opt::RuntimeThreadsForegroundCpus));
+  runtime_threads_background_cpus_ =
+      ParseCpuList("-XX:RuntimeThreadsBackgroundCpus",
+                   runtime_options.GetOrDefault(Opt::RuntimeThreadsBackgroundCpus));
 
   compiler_callbacks_ = runtime_options.GetOrDefault(Opt::CompilerCallbacksPtr);
   must_relocate_ = runtime_options.GetOrDefault(Opt::Relocate);
@@ -1651,6 +1686,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.Exists(Opt::LowMemoryMode),
                        runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
                        runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                       runtime_options.GetOrDefault(Opt::GcPauseTarget),
                        runtime_options.Exists(Opt::IgnoreMaxFootprint),
                        runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
                        runtime_options.GetOrDefault(Opt::UseTLAB),
@@ -1748,6 +1784,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
       FALLTHROUGH_INTENDED;
     case InstructionSet::kArm:
     case InstructionSet::kThumb2:
+    case InstructionSet::kRiscv64:
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
       implicit_null_checks_ = true;
@@ -2788,6 +2825,9 @@ void Runtime::RegisterAppInfo(const std::string& package_name,
   }
 
   jit_->StartProfileSaver(profile_output_filename, code_paths, ref_profile_filename);
+  // Queue the verification first, so that it starts before the precompilation.
+  jit_->VerifyClassesFromAppProfile(profile_output_filename, code_paths);
+  jit_->PrecompileMethodsFromAppProfile(profile_output_filename, code_paths);
 }
 
 // Transaction support.
@@ -3203,6 +3243,16 @@ void Runtime::UpdateProcessState(ProcessState process_state) {
   ProcessState old_process_state = process_state_;
   process_state_ = process_state;
   GetHeap()->UpdateProcessState(old_process_state, process_state);
+  // Keep the GC and JIT threads off the big cores while the app is in the background.
+  const std::optional<cpu_set_t>& cpus = (process_state == kProcessStateJankPerceptible)
+      ? runtime_threads_foreground_cpus_
+      : runtime_threads_background_cpus_;
+  if (cpus.has_value()) {
+    GetHeap()->SetGcThreadsCpuAffinity(*cpus);
+    if (jit_ != nullptr && jit_->GetThreadPool() != nullptr) {
+      jit_->GetThreadPool()->SetCpuAffinity(*cpus);
+    }
+  }
 }
 
 void Runtime::RegisterSensitiveThread() const {
@@ -18,11 +18,13 @@
 #define ART_RUNTIME_RUNTIME_H_
 
 #include <jni.h>
+#include <sched.h>
 #include <stdio.h>
 
 #include <forward_list>
 #include <iosfwd>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -1518,6 +1520,11 @@ class Runtime {
   // Whether or not we currently care about pause times.
   ProcessState process_state_;
 
+  // CPUs the GC and JIT threads are restricted to in the foreground and in the background, as
+  // given by -XX:RuntimeThreadsForegroundCpus and -XX:RuntimeThreadsBackgroundCpus.
+  std::optional<cpu_set_t> runtime_threads_foreground_cpus_;
+  std::optional<cpu_set_t> runtime_threads_background_cpus_;
+
   // Whether zygote code is in a section that should not start threads.
   bool zygote_no_threads_;
 
@@ -40,6 +40,7 @@
 #include "dex/class_accessor-inl.h"
 #include "gc/space/image_space.h"
 #include "image.h"
+#include "jit/jit.h"
 #include "mirror/object-inl.h"
 #include "mirror/object-refvisitor-inl.h"
 #include "mirror/object_array-alloc-inl.h"
@@ -50,6 +51,7 @@
 #include "oat.h"
 #include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 #include "vdex_file.h"
 
 namespace art {
@@ -1841,26 +1843,12 @@ static bool EnsureDirectoryExists(const std::string& directory, std::string* err
   return true;
 }
 
-bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
-  gc::Heap* heap = Runtime::Current()->GetHeap();
-  if (!heap->HasBootImageSpace()) {
-    *error_msg = "Cannot generate an app image without a boot image";
-    return false;
-  }
-  std::string oat_path = GetOatPath();
-  if (!oat_path.empty() && !EnsureDirectoryExists(oat_path, error_msg)) {
-    return false;
-  }
-
-  ScopedTrace generate_image_trace("Generating runtime image");
-  std::unique_ptr<RuntimeImageHelper> image(new RuntimeImageHelper(heap));
-  if (!image->Generate(error_msg)) {
-    return false;
-  }
-
+// Compresses and writes a generated image to its final location. This only
+// reads the data owned by `image`, so it does not need the mutator lock.
+static bool WriteImage(RuntimeImageHelper* image, std::string* error_msg) {
   ScopedTrace write_image_trace("Writing runtime image to disk");
 
-  const std::string path = GetRuntimeImagePath(image->GetDexLocation());
+  const std::string path = RuntimeImage::GetRuntimeImagePath(image->GetDexLocation());
   if (!EnsureDirectoryExists(android::base::Dirname(path), error_msg)) {
     return false;
   }
@@ -1912,4 +1900,57 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   return true;
 }
 
+// Task for compressing and writing a generated image on the JIT thread pool,
+// which runs at a lower priority than the app threads.
+class WriteRuntimeImageTask final : public SelfDeletingTask {
+ public:
+  explicit WriteRuntimeImageTask(std::unique_ptr<RuntimeImageHelper>&& image)
+      : image_(std::move(image)) {}
+
+  void Run([[maybe_unused]] Thread* self) override {
+    std::string error_msg;
+    if (!WriteImage(image_.get(), &error_msg)) {
+      LOG(DEBUG) << "Could not write temporary image to disk " << error_msg;
+    }
+  }
+
+ private:
+  std::unique_ptr<RuntimeImageHelper> image_;
+
+  DISALLOW_COPY_AND_ASSIGN(WriteRuntimeImageTask);
+};
+
+bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
+  Runtime* runtime = Runtime::Current();
+  gc::Heap* heap = runtime->GetHeap();
+  if (!heap->HasBootImageSpace()) {
+    *error_msg = "Cannot generate an app image without a boot image";
+    return false;
+  }
+  std::string oat_path = GetOatPath();
+  if (!oat_path.empty() && !EnsureDirectoryExists(oat_path, error_msg)) {
+    return false;
+  }
+
+  // Generating the image copies the objects and native data of the app classes
+  // into buffers owned by the helper, so the result is a snapshot that can be
+  // written out without holding the mutator lock.
+  std::unique_ptr<RuntimeImageHelper> image;
+  {
+    ScopedTrace generate_image_trace("Generating runtime image");
+    image.reset(new RuntimeImageHelper(heap));
+    if (!image->Generate(error_msg)) {
+      return false;
+    }
+  }
+
+  jit::Jit* jit = runtime->GetJit();
+  if (jit != nullptr && jit->GetThreadPool() != nullptr) {
+    // Compression and I/O take most of the time: do them in the background.
+    jit->GetThreadPool()->AddTask(Thread::Current(), new WriteRuntimeImageTask(std::move(image)));
+    return true;
+  }
+  return WriteImage(image.get(), error_msg);
+}
+
 }  // namespace art
@@ -23,7 +23,9 @@ namespace art {
 
 class RuntimeImage {
  public:
-    // Writes an app image for the currently running process.
+  // Writes an app image for the currently running process. The image is
+  // generated on the calling thread, but it is written to disk from the JIT
+  // thread pool if there is one.
   static bool WriteImageToDisk(std::string* error_msg);
 
   // Gets the path where a runtime-generated app image is stored.
@@ -28,10 +28,13 @@
 #include <sstream>
 
 #include <android-base/file.h>
+#include <android-base/parsebool.h>
+#include <android-base/properties.h>
 #include <android-base/stringprintf.h>
 
 #include "arch/instruction_set.h"
 #include "base/logging.h"  // For GetCmdLine.
+#include "base/mutex.h"
 #include "base/os.h"
 #include "base/time_utils.h"
 #include "base/utils.h"
@@ -130,6 +133,15 @@ void SignalCatcher::HandleSigQuit() {
 
   os << "Build type: " << (kIsDebugBuild ? "debug" : "optimized") << "\n";
 
+  // Let the mutex contention profiler be switched on and off without restarting the process.
+  // Enabling it clears the old data, so the next SIGQUIT dumps the contentions in between.
+  android::base::ParseBoolResult profile_contentions = android::base::ParseBool(
+      android::base::GetProperty("debug.art.mutex_contention_profiling", ""));
+  if (profile_contentions != android::base::ParseBoolResult::kError) {
+    MutexContentionProfiler::SetEnabled(
+        profile_contentions == android::base::ParseBoolResult::kTrue);
+  }
+
   runtime->DumpForSigQuit(os);
 
   if ((false)) {
@@ -72,7 +72,7 @@ StackVisitor::StackVisitor(Thread* thread,
       cur_oat_quick_method_header_(nullptr),
       num_frames_(num_frames),
       cur_depth_(0),
-      cur_inline_info_(nullptr, CodeInfo()),
+      cur_inline_info_index_(0u),
       cur_stack_map_(0, StackMap()),
       context_(context),
       check_suspended_(check_suspended) {
@@ -84,10 +84,16 @@ StackVisitor::StackVisitor(Thread* thread,
 CodeInfo* StackVisitor::GetCurrentInlineInfo() const {
   DCHECK(!(*cur_quick_frame_)->IsNative());
   const OatQuickMethodHeader* header = GetCurrentOatQuickMethodHeader();
-  if (cur_inline_info_.first != header) {
-    cur_inline_info_ = std::make_pair(header, CodeInfo::DecodeInlineInfoOnly(header));
+  if (inline_info_cache_[cur_inline_info_index_].first != header) {
+    static_assert(kInlineInfoCacheSize == 2u);
+    cur_inline_info_index_ ^= 1u;
+    if (inline_info_cache_[cur_inline_info_index_].first != header) {
+      // Replace the least recently used entry.
+      inline_info_cache_[cur_inline_info_index_] =
+          std::make_pair(header, CodeInfo::DecodeInlineInfoOnly(header));
+    }
   }
-  return &cur_inline_info_.second;
+  return &inline_info_cache_[cur_inline_info_index_].second;
 }
 
 StackMap* StackVisitor::GetCurrentStackMap() const {
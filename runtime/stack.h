@@ -396,10 +396,15 @@ class StackVisitor {
   // We keep poping frames from the end as we visit the frames.
   BitTableRange<InlineInfo> current_inline_frames_;
 
-  // Cache the most recently decoded inline info data.
+  // Cache the two most recently decoded inline info data, so that walking through methods
+  // calling each other back and forth does not decode the same code info on every frame.
   // The 'current_inline_frames_' refers to this data, so we need to keep it alive anyway.
+  // Entries are replaced in place and never moved while they are in use.
   // Marked mutable since the cache fields are updated from const getters.
-  mutable std::pair<const OatQuickMethodHeader*, CodeInfo> cur_inline_info_;
+  static constexpr size_t kInlineInfoCacheSize = 2u;
+  mutable std::pair<const OatQuickMethodHeader*, CodeInfo> inline_info_cache_[kInlineInfoCacheSize];
+  // Index of the most recently used entry of `inline_info_cache_`.
+  mutable size_t cur_inline_info_index_;
   mutable std::pair<uintptr_t, StackMap> cur_stack_map_;
 
   uint8_t* GetShouldDeoptimizeFlagAddr() const REQUIRES_SHARED(Locks::mutator_lock_);
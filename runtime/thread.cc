@@ -32,6 +32,7 @@
 #include <sstream>
 
 #include "android-base/file.h"
+#include "android-base/scopeguard.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 
@@ -1566,6 +1567,10 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
     AtomicClearFlag(ThreadFlag::kActiveSuspendBarrier);
   }
 
+  // Record the arrival time for the time-to-safepoint diagnostics of the requesting thread. This is
+  // only used for reporting, so a slightly stale value is acceptable.
+  suspend_barrier_pass_time_ns_.store(NanoTime(), std::memory_order_relaxed);
+
   uint32_t barrier_count = 0;
   for (uint32_t i = 0; i < kMaxSuspendBarriers; i++) {
     AtomicInteger* pending_threads = pass_barriers[i];
@@ -2654,6 +2659,8 @@ Thread::~Thread() {
     delete[] tlsPtr_.method_trace_buffer;
   }
 
+  delete[] tlsPtr_.stack_trace_frames_buffer;
+
   Runtime::Current()->GetHeap()->AssertThreadLocalBuffersAreRevoked(this);
 
   TearDownAlternateSignalStack();
@@ -3030,7 +3037,20 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
 jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa) const {
   // Compute depth of stack, save frames if possible to avoid needing to recompute many.
   constexpr size_t kMaxSavedFrames = 256;
-  std::unique_ptr<ArtMethodDexPcPair[]> saved_frames(new ArtMethodDexPcPair[kMaxSavedFrames]);
+  // Reuse the buffer of the current thread to save the frames, so that exception storms do not
+  // allocate it for every throw. The buffer is taken from the thread while in use, as allocating
+  // the trace below can throw an OutOfMemoryError, which creates its own stack trace.
+  Thread* self = soa.Self();
+  std::unique_ptr<ArtMethodDexPcPair[]> saved_frames(self->tlsPtr_.stack_trace_frames_buffer);
+  self->tlsPtr_.stack_trace_frames_buffer = nullptr;
+  if (saved_frames == nullptr) {
+    saved_frames.reset(new ArtMethodDexPcPair[kMaxSavedFrames]);
+  }
+  auto release_saved_frames = android::base::make_scope_guard([&]() {
+    if (self->tlsPtr_.stack_trace_frames_buffer == nullptr) {
+      self->tlsPtr_.stack_trace_frames_buffer = saved_frames.release();
+    }
+  });
   FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this),
                                        &saved_frames[0],
                                        kMaxSavedFrames);
@@ -4524,6 +4544,9 @@ void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
   for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
     SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
   }
+  for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetSecondWayArray()) {
+    SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
+  }
 }
 
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
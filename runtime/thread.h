@@ -838,6 +838,13 @@ class Thread {
         OFFSETOF_MEMBER(tls_32bit_sized_values, shared_method_hotness));
   }
 
+  template<PointerSize pointer_size>
+  static constexpr ThreadOffset<pointer_size> InlineCacheSampleCountdownOffset() {
+    return ThreadOffset<pointer_size>(
+        OFFSETOF_MEMBER(Thread, tls32_) +
+        OFFSETOF_MEMBER(tls_32bit_sized_values, inline_cache_sample_countdown));
+  }
+
   // Deoptimize the Java stack.
   void DeoptimizeWithDeoptimizationException(JValue* result) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -1291,6 +1298,30 @@ class Thread {
   uint8_t* GetTlabEnd() {
     return tlsPtr_.thread_local_end;
   }
+
+  // Size of the partial TLABs to be handed out to this thread, or 0 if not computed yet.
+  // See Heap::CalculatePartialTlabSize().
+  size_t GetPartialTlabSize() const {
+    return partial_tlab_size_;
+  }
+  void SetPartialTlabSize(size_t size) {
+    partial_tlab_size_ = size;
+  }
+
+  // Number of partial TLAB refills since the GC `GetTlabRefillsGcNum()` completed.
+  uint32_t GetTlabRefills() const {
+    return tlab_refills_;
+  }
+  uint32_t GetTlabRefillsGcNum() const {
+    return tlab_refills_gc_num_;
+  }
+  void RecordTlabRefill() {
+    tlab_refills_++;
+  }
+  void ResetTlabRefills(uint32_t gc_num) {
+    tlab_refills_ = 0u;
+    tlab_refills_gc_num_ = gc_num;
+  }
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
   // equal to a valid pointer.
   // TODO: does this need to atomic?  I don't think so.
@@ -1793,7 +1824,8 @@ class Thread {
           make_visibly_initialized_counter(0),
           define_class_counter(0),
           num_name_readers(0),
-          shared_method_hotness(kSharedMethodHotnessThreshold)
+          shared_method_hotness(kSharedMethodHotnessThreshold),
+          inline_cache_sample_countdown(1u)
         {}
 
     // The state and flags field must be changed atomically so that flag values aren't lost.
@@ -1902,6 +1934,11 @@ class Thread {
     // There is a second level counter in `Jit::shared_method_counters_` to make
     // sure we at least have a few samples before compiling a method.
     uint32_t shared_method_hotness;
+
+    // Thread-local countdown for the inline cache updates of baseline compiled code, when
+    // compiled with an inline cache sampling interval. The compiled code decrements it and
+    // updates the inline cache when hitting zero, resetting it to the sampling interval.
+    uint32_t inline_cache_sample_countdown;
   } tls32_;
 
   struct PACKED(8) tls_64bit_sized_values {
@@ -1954,7 +1991,8 @@ class Thread {
                                async_exception(nullptr),
                                top_reflective_handle_scope(nullptr),
                                method_trace_buffer(nullptr),
-                               method_trace_buffer_index(0) {
+                               method_trace_buffer_index(0),
+                               stack_trace_frames_buffer(nullptr) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -2119,6 +2157,10 @@ class Thread {
 
     // The index of the next free entry in method_trace_buffer.
     size_t method_trace_buffer_index;
+
+    // Buffer for the frames collected by CreateInternalStackTrace, reused across throws.
+    // Null while a stack trace is being created or before the first one.
+    std::pair<ArtMethod*, uint32_t>* stack_trace_frames_buffer;
   } tlsPtr_;
 
   // Small thread-local cache to be used from the interpreter.
@@ -2165,6 +2207,15 @@ class Thread {
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // Adaptive partial TLAB sizing state, only accessed by the thread itself.
+  size_t partial_tlab_size_ = 0;
+  uint32_t tlab_refills_ = 0;
+  uint32_t tlab_refills_gc_num_ = 0;
+
+  // Time at which this thread last passed a suspend barrier. Read by the thread requesting the
+  // suspension to find the threads that delayed it the most.
+  std::atomic<uint64_t> suspend_barrier_pass_time_ns_{0};
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
@@ -31,6 +31,7 @@
 #include "unwindstack/AndroidUnwinder.h"
 
 #include "art_field-inl.h"
+#include "art_method-inl.h"
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
@@ -51,6 +52,7 @@
 #include "obj_ptr-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -72,6 +74,14 @@ static constexpr useconds_t kThreadSuspendInitialSleepUs = 0;
 static constexpr useconds_t kThreadSuspendMaxYieldUs = 3000;
 static constexpr useconds_t kThreadSuspendMaxSleepUs = 5000;
 
+// Number of times SuspendAll yields to the threads that are still runnable before it sleeps on the
+// suspend barrier.
+static constexpr size_t kSuspendAllMaxYields = 10;
+
+// Minimum number of threads left suspended after a thread flip for their flip functions to be
+// run in parallel, when the collector provides a thread pool.
+static constexpr size_t kMinThreadsForParallelFlip = 32;
+
 // Whether we should try to dump the native stack of unattached threads. See commit ed8b723 for
 // some history.
 static constexpr bool kDumpUnattachedThreadNativeStackForSigQuit = true;
@@ -515,6 +525,32 @@ void ThreadList::RunEmptyCheckpoint() {
   }
 }
 
+// Runs the pending flip functions of the suspended threads, claiming the
+// threads one at a time so that several of these tasks can run in parallel.
+class FlipThreadsTask : public Task {
+ public:
+  FlipThreadsTask(const std::vector<Thread*>* threads, std::atomic<size_t>* next_index)
+      : threads_(threads), next_index_(next_index) {}
+
+  // Runs on behalf of the thread running `FlipThreadRoots()`, which holds the
+  // mutator lock exclusively.
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = next_index_->fetch_add(1, std::memory_order_relaxed);
+         i < threads_->size();
+         i = next_index_->fetch_add(1, std::memory_order_relaxed)) {
+      (*threads_)[i]->EnsureFlipFunctionStarted(self);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::vector<Thread*>* const threads_;
+  std::atomic<size_t>* const next_index_;
+};
+
 // A checkpoint/suspend-all hybrid to switch thread roots from
 // from-space to to-space refs. Used to synchronize threads at a point
 // to mark the initiation of marking while maintaining the to-space
@@ -522,7 +558,8 @@ void ThreadList::RunEmptyCheckpoint() {
 size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
                                    Closure* flip_callback,
                                    gc::collector::GarbageCollector* collector,
-                                   gc::GcPauseListener* pause_listener) {
+                                   gc::GcPauseListener* pause_listener,
+                                   ThreadPool* thread_pool) {
   TimingLogger::ScopedTiming split("ThreadListFlip", collector->GetTimings());
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotHeld(self);
@@ -599,6 +636,17 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   // Try to run the closure on the other threads.
   {
     TimingLogger::ScopedTiming split3("FlipOtherThreads", collector->GetTimings());
+    if (thread_pool != nullptr && other_threads.size() >= kMinThreadsForParallelFlip) {
+      // Split the work between the pool workers and this thread.
+      std::atomic<size_t> next_index(0);
+      for (size_t i = 0; i < thread_pool->GetThreadCount(); ++i) {
+        thread_pool->AddTask(self, new FlipThreadsTask(&other_threads, &next_index));
+      }
+      thread_pool->StartWorkers(self);
+      FlipThreadsTask(&other_threads, &next_index).Run(self);
+      thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+      thread_pool->StopWorkers(self);
+    }
     for (Thread* thread : other_threads) {
       thread->EnsureFlipFunctionStarted(self);
       DCHECK(!thread->ReadFlag(ThreadFlag::kPendingFlipFunction));
@@ -636,7 +684,10 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     ScopedTrace trace("Suspending mutator threads");
     const uint64_t start_time = NanoTime();
 
-    SuspendAllInternal(self, self);
+    Thread* slowest_thread = nullptr;
+    uint64_t slowest_time = 0u;
+    SuspendAllInternal(
+        self, self, nullptr, SuspendReason::kInternal, &slowest_thread, &slowest_time);
     // All threads are known to have suspended (but a thread may still own the mutator lock)
     // Make sure this thread grabs exclusive access to the mutator lock and its protected data.
 #if HAVE_TIMED_RWLOCK
@@ -662,7 +713,23 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     const uint64_t suspend_time = end_time - start_time;
     suspend_all_historam_.AdjustAndAddValue(suspend_time);
     if (suspend_time > kLongThreadSuspendThreshold) {
-      LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
+      GetMetrics()->LongTimeToSafepointCount()->AddOne();
+      std::ostringstream oss;
+      if (slowest_thread != nullptr) {
+        // The slowest thread is suspended and cannot go away while we hold the mutator lock.
+        // Report where it finally reached a suspend point, which is usually right after the code
+        // that delayed it, e.g. a long-running loop without suspend checks.
+        uint32_t dex_pc = dex::kDexNoIndex;
+        ArtMethod* method = slowest_thread->GetCurrentMethod(&dex_pc,
+                                                              /*check_suspended=*/ false,
+                                                              /*abort_on_error=*/ false);
+        std::string thread_name;
+        slowest_thread->GetThreadName(thread_name);
+        oss << ", slowest thread \"" << thread_name << "\" took "
+            << PrettyDuration(slowest_time) << " at " << ArtMethod::PrettyMethod(method)
+            << " dex pc 0x" << std::hex << dex_pc;
+      }
+      LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time) << oss.str();
     }
 
     if (kDebugLocking) {
@@ -683,7 +750,9 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
 void ThreadList::SuspendAllInternal(Thread* self,
                                     Thread* ignore1,
                                     Thread* ignore2,
-                                    SuspendReason reason) {
+                                    SuspendReason reason,
+                                    Thread** slowest_thread,
+                                    uint64_t* slowest_time_ns) {
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
   Locks::thread_suspend_count_lock_->AssertNotHeld(self);
@@ -699,6 +768,7 @@ void ThreadList::SuspendAllInternal(Thread* self,
   //    kNative) and will never begin executing Java code without first checking
   //    the suspend-request flag.
 
+  const uint64_t request_time = NanoTime();
   // The atomic counter for number of threads that need to pass the barrier.
   AtomicInteger pending_threads;
   uint32_t num_ignored = 0;
@@ -734,6 +804,15 @@ void ThreadList::SuspendAllInternal(Thread* self,
     }
   }
 
+  // Runnable threads usually reach a suspend point within a few microseconds. Give them the CPU
+  // instead of sleeping right away, so that the pause does not also include our own wake-up from
+  // the futex when the last one passes the barrier.
+  for (size_t i = 0;
+       i != kSuspendAllMaxYields && pending_threads.load(std::memory_order_relaxed) > 0;
+       ++i) {
+    sched_yield();
+  }
+
   // Wait for the barrier to be passed by all runnable threads. This wait
   // is done with a timeout so that we can detect problems.
 #if ART_USE_FUTEXES
@@ -781,6 +860,29 @@ void ThreadList::SuspendAllInternal(Thread* self,
       break;
     }
   }
+  const uint64_t time_to_safepoint = NanoTime() - request_time;
+  GetMetrics()->TimeToSafepoint()->Add(NsToUs(time_to_safepoint));
+  ATraceIntegerValue("Time to safepoint (us)", static_cast<int32_t>(NsToUs(time_to_safepoint)));
+
+  if (slowest_thread != nullptr) {
+    // Threads that were already suspended did not pass the barrier for this request, so their
+    // pass time predates `request_time`.
+    Thread* slowest = nullptr;
+    uint64_t slowest_pass_time = request_time;
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    for (const auto& thread : list_) {
+      if (thread == ignore1 || thread == ignore2) {
+        continue;
+      }
+      uint64_t pass_time = thread->suspend_barrier_pass_time_ns_.load(std::memory_order_relaxed);
+      if (pass_time > slowest_pass_time) {
+        slowest = thread;
+        slowest_pass_time = pass_time;
+      }
+    }
+    *slowest_thread = slowest;
+    *slowest_time_ns = slowest_pass_time - request_time;
+  }
 }
 
 void ThreadList::ResumeAll() {
@@ -40,6 +40,7 @@ class Closure;
 class IsMarkedVisitor;
 class RootVisitor;
 class Thread;
+class ThreadPool;
 class TimingLogger;
 enum VisitRootFlags : uint8_t;
 
@@ -127,11 +128,14 @@ class ThreadList {
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   // Flip thread roots from from-space refs to to-space refs. Used by
-  // the concurrent moving collectors.
+  // the concurrent moving collectors. If `thread_pool` is not null, its
+  // (idle and already created) workers help running the flip function of
+  // the threads that remain suspended after the pause.
   size_t FlipThreadRoots(Closure* thread_flip_visitor,
                          Closure* flip_callback,
                          gc::collector::GarbageCollector* collector,
-                         gc::GcPauseListener* pause_listener)
+                         gc::GcPauseListener* pause_listener,
+                         ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::mutator_lock_,
                !Locks::thread_list_lock_,
                !Locks::thread_suspend_count_lock_);
@@ -199,10 +203,14 @@ class ThreadList {
   void SuspendAllDaemonThreadsForShutdown()
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // If `slowest_thread` is not null, it receives the last thread that passed the suspend barrier
+  // (or null if no thread had to) and `slowest_time_ns` the time it took from the request.
   void SuspendAllInternal(Thread* self,
                           Thread* ignore1,
                           Thread* ignore2 = nullptr,
-                          SuspendReason reason = SuspendReason::kInternal)
+                          SuspendReason reason = SuspendReason::kInternal,
+                          Thread** slowest_thread = nullptr,
+                          uint64_t* slowest_time_ns = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   void AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread* ignore2 = nullptr)
@@ -22,6 +22,7 @@
 #include <sys/time.h>
 
 #include <pthread.h>
+#include <sched.h>
 
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
@@ -98,6 +99,17 @@ void ThreadPoolWorker::SetPthreadPriority(int priority) {
 #endif
 }
 
+void ThreadPoolWorker::SetCpuAffinity(const cpu_set_t& cpus) {
+#if defined(ART_TARGET_ANDROID)
+  int result = sched_setaffinity(pthread_gettid_np(pthread_), sizeof(cpus), &cpus);
+  if (result != 0) {
+    PLOG(ERROR) << "Failed to set the CPU affinity of " << name_;
+  }
+#else
+  UNUSED(cpus);
+#endif
+}
+
 int ThreadPoolWorker::GetPthreadPriority() {
 #if defined(ART_TARGET_ANDROID)
   return getpriority(PRIO_PROCESS, pthread_gettid_np(pthread_));
@@ -235,6 +247,11 @@ void ThreadPool::SetMaxActiveWorkers(size_t max_workers) {
   max_active_workers_ = max_workers;
 }
 
+size_t ThreadPool::GetMaxActiveWorkers() {
+  MutexLock mu(Thread::Current(), task_queue_lock_);
+  return max_active_workers_;
+}
+
 ThreadPool::~ThreadPool() {
   DeleteThreads();
   RemoveAllTasks(Thread::Current());
@@ -335,6 +352,12 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+void ThreadPool::SetCpuAffinity(const cpu_set_t& cpus) {
+  for (ThreadPoolWorker* worker : threads_) {
+    worker->SetCpuAffinity(cpus);
+  }
+}
+
 void ThreadPool::CheckPthreadPriority(int priority) {
 #if defined(ART_TARGET_ANDROID)
   for (ThreadPoolWorker* worker : threads_) {
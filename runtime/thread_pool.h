@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_THREAD_POOL_H_
 #define ART_RUNTIME_THREAD_POOL_H_
 
+#include <sched.h>
+
 #include <deque>
 #include <functional>
 #include <vector>
@@ -86,6 +88,9 @@ class ThreadPoolWorker {
   // Set the "nice" priority for this worker.
   void SetPthreadPriority(int priority);
 
+  // Restrict this worker to run on the given set of CPUs.
+  void SetCpuAffinity(const cpu_set_t& cpus);
+
   // Get the "nice" priority for this worker.
   int GetPthreadPriority();
 
@@ -166,9 +171,15 @@ class ThreadPool {
   // thread count of the thread pool.
   void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_);
 
+  // Returns the bound set by `SetMaxActiveWorkers`, or the thread count if none was set.
+  size_t GetMaxActiveWorkers() REQUIRES(!task_queue_lock_);
+
   // Set the "nice" priority for threads in the pool.
   void SetPthreadPriority(int priority);
 
+  // Restrict the threads in the pool to run on the given set of CPUs.
+  void SetCpuAffinity(const cpu_set_t& cpus);
+
   // CHECK that the "nice" priority of threads in the pool is the given
   // `priority`.
   void CheckPthreadPriority(int priority);
@@ -188,6 +188,15 @@ class NoPeerTask : public Task {
   }
 };
 
+TEST_F(ThreadPoolTest, MaxActiveWorkers) {
+  ThreadPool thread_pool("Thread pool test thread pool", num_threads);
+  EXPECT_EQ(static_cast<size_t>(num_threads), thread_pool.GetMaxActiveWorkers());
+  thread_pool.SetMaxActiveWorkers(1);
+  EXPECT_EQ(1u, thread_pool.GetMaxActiveWorkers());
+  thread_pool.SetMaxActiveWorkers(num_threads);
+  EXPECT_EQ(static_cast<size_t>(num_threads), thread_pool.GetMaxActiveWorkers());
+}
+
 // Tests for create_peer functionality.
 TEST_F(ThreadPoolTest, PeerTest) {
   Thread* self = Thread::Current();
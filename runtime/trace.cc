@@ -23,6 +23,7 @@
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/os.h"
@@ -50,6 +51,7 @@
 #include "stack.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 
 namespace art {
 
@@ -73,7 +75,7 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
+Atomic<std::vector<ArtMethod*>*> Trace::temp_stack_trace_(nullptr);
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -226,13 +228,13 @@ uint32_t Trace::EncodeTraceMethod(ArtMethod* method) {
 }
 
 std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
+  std::vector<ArtMethod*>* stack_trace = temp_stack_trace_.exchange(nullptr);
+  return (stack_trace != nullptr) ? stack_trace : new std::vector<ArtMethod*>();
 }
 
 void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
   stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
+  delete temp_stack_trace_.exchange(stack_trace);
 }
 
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
@@ -338,6 +340,38 @@ static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_
   the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
 }
 
+// Takes a stack trace sample of each thread at its next suspend point, so that sampling doesn't
+// need to suspend all threads. The samples of threads that are already suspended are taken by the
+// sampling thread.
+class SamplingCheckpoint final : public Closure {
+ public:
+  explicit SamplingCheckpoint(Trace* trace) : barrier_(0), trace_(trace) {}
+
+  void Run(Thread* thread) override {
+    // Note thread and self may not be equal if thread was already suspended at
+    // the point of the request.
+    Thread* self = Thread::Current();
+    {
+      ScopedObjectAccess soa(self);
+      GetSample(thread, trace_);
+    }
+    barrier_.Pass(self);
+  }
+
+  void WaitForThreadsToRunThroughCheckpoint(size_t threads_running_checkpoint) {
+    Thread* self = Thread::Current();
+    ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+    barrier_.Increment(self, threads_running_checkpoint);
+  }
+
+ private:
+  // The barrier to be passed through and for the requestor to wait upon.
+  Barrier barrier_;
+  Trace* const trace_;
+
+  DISALLOW_COPY_AND_ASSIGN(SamplingCheckpoint);
+};
+
 static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
   thread->SetTraceClockBase(0);
   std::vector<ArtMethod*>* stack_trace = thread->GetStackTraceSample();
@@ -347,7 +381,6 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUT
 
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -403,15 +436,11 @@ void* Trace::RunSamplingThread(void* arg) {
       }
     }
     {
-      // Avoid a deadlock between a thread doing garbage collection
-      // and the profile sampling thread, by blocking GC when sampling
-      // thread stacks (see b/73624630).
-      gc::ScopedGCCriticalSection gcs(self,
-                                      art::gc::kGcCauseInstrumentation,
-                                      art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      SamplingCheckpoint checkpoint(the_trace);
+      size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+      if (threads_running_checkpoint != 0) {
+        checkpoint.WaitForThreadsToRunThroughCheckpoint(threads_running_checkpoint);
+      }
     }
   }
 
@@ -510,6 +539,15 @@ void Trace::Start(std::unique_ptr<File>&& trace_file_in,
   // Enable count of allocs if specified in the flags.
   bool enable_stats = false;
 
+  // In streaming mode the per-thread buffers are written out by a separate thread. Create it before
+  // suspending all threads since the worker needs to attach to the runtime.
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (output_mode == TraceOutputMode::kStreaming) {
+    thread_pool.reset(new ThreadPool("Trace writer pool", /* num_threads= */ 1));
+    thread_pool->StartWorkers(self);
+    thread_pool->WaitForWorkersToBeCreated();
+  }
+
   // Create Trace object.
   {
     // Suspend JIT here since we are switching runtime to debuggable. Debuggable runtimes cannot use
@@ -526,7 +564,12 @@ void Trace::Start(std::unique_ptr<File>&& trace_file_in,
       LOG(ERROR) << "Trace already in progress, ignoring this request";
     } else {
       enable_stats = (flags & kTraceCountAllocs) != 0;
-      the_trace_ = new Trace(trace_file.release(), buffer_size, flags, output_mode, trace_mode);
+      the_trace_ = new Trace(trace_file.release(),
+                             buffer_size,
+                             flags,
+                             output_mode,
+                             trace_mode,
+                             std::move(thread_pool));
       if (trace_mode == TraceMode::kSampling) {
         CHECK_PTHREAD_CALL(pthread_create, (&sampling_pthread_, nullptr, &RunSamplingThread,
                                             reinterpret_cast<void*>(interval_us)),
@@ -643,7 +686,7 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
       MutexLock tl_lock(Thread::Current(), *Locks::thread_list_lock_);
       for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
         if (thread->GetMethodTraceBuffer() != nullptr) {
-          the_trace_->FlushStreamingBuffer(thread);
+          the_trace_->FlushStreamingBuffer(thread, /* release= */ true);
           thread->ResetMethodTraceBuffer();
         }
         // Record threads here before resetting the_trace_ to prevent any races between
@@ -652,6 +695,12 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
       }
     }
 
+    // Wait for the trace writer to write out all the flushed buffers. The writer doesn't need the
+    // mutator lock, so it can make progress while all threads are suspended.
+    if (the_trace->thread_pool_ != nullptr) {
+      the_trace->thread_pool_->Wait(self, /* do_work= */ false, /* may_hold_locks= */ true);
+    }
+
     // Reset the_trace_ by taking a trace_lock
     MutexLock mu(self, *Locks::trace_lock_);
     the_trace_ = nullptr;
@@ -687,7 +736,7 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
 
 void Trace::FlushThreadBuffer(Thread* self) {
   MutexLock mu(self, *Locks::trace_lock_);
-  the_trace_->FlushStreamingBuffer(self);
+  the_trace_->FlushStreamingBuffer(self, /* release= */ true);
 }
 
 void Trace::Abort() {
@@ -727,6 +776,8 @@ static constexpr size_t kMinBufSize = 18U;  // Trace header is up to 18B.
 // should be greater than kMinBufSize.
 static constexpr size_t kPerThreadBufSize = 512 * 1024;
 static_assert(kPerThreadBufSize > kMinBufSize);
+// The maximum number of per-thread buffers queued to the trace writer in streaming mode.
+static constexpr size_t kMaxQueuedStreamingBuffers = 8;
 
 namespace {
 
@@ -750,7 +801,8 @@ Trace::Trace(File* trace_file,
              size_t buffer_size,
              int flags,
              TraceOutputMode output_mode,
-             TraceMode trace_mode)
+             TraceMode trace_mode,
+             std::unique_ptr<ThreadPool>&& thread_pool)
     : trace_file_(trace_file),
       buf_(new uint8_t[std::max(kMinBufSize, buffer_size)]()),
       flags_(flags),
@@ -763,8 +815,12 @@ Trace::Trace(File* trace_file,
       overflow_(false),
       interval_us_(0),
       stop_tracing_(false),
-      tracing_lock_("tracing lock", LockLevel::kTracingStreamingLock) {
+      tracing_lock_("tracing lock", LockLevel::kTracingStreamingLock),
+      thread_pool_(std::move(thread_pool)),
+      buffer_pool_lock_("trace buffer pool lock", LockLevel::kGenericBottomLock),
+      buffer_pool_cond_("trace buffer pool condition", buffer_pool_lock_) {
   CHECK_IMPLIES(trace_file == nullptr, output_mode == TraceOutputMode::kDDMS);
+  CHECK_EQ(thread_pool_ != nullptr, output_mode == TraceOutputMode::kStreaming);
 
   uint16_t trace_version = GetTraceVersion(clock_source_);
   if (output_mode == TraceOutputMode::kStreaming) {
@@ -1045,12 +1101,13 @@ void Trace::RecordStreamingMethodEvent(Thread* thread,
     }
   }
 
-  size_t required_entries = (clock_source_ == TraceClockSource::kDual) ? 4 : 3;
+  size_t required_entries = GetNumEntriesPerEvent();
   if (*current_offset + required_entries >= kPerThreadBufSize) {
-    // We don't have space for further entries. Flush the contents of the buffer and reuse the
-    // buffer to store contents. Reset the index to the start of the buffer.
-    FlushStreamingBuffer(thread);
-    *current_offset = 0;
+    // We don't have space for further entries. Hand the contents of the buffer over to the trace
+    // writer and continue recording into a fresh buffer.
+    FlushStreamingBuffer(thread, /* release= */ false);
+    method_trace_buffer = thread->GetMethodTraceBuffer();
+    DCHECK_EQ(*current_offset, 0u);
   }
 
   // Record entry in per-thread trace buffer.
@@ -1098,20 +1155,154 @@ void Trace::WriteToBuf(uint8_t* header,
   }
 }
 
-void Trace::FlushStreamingBuffer(Thread* thread) {
-  // Take a tracing_lock_ to serialize writes across threads. We also need to allocate a unique
-  // method id for each method. We do that by maintaining a map from id to method for each newly
-  // seen method. tracing_lock_ is required to serialize these.
-  MutexLock mu(Thread::Current(), tracing_lock_);
+size_t Trace::GetNumEntriesPerEvent() {
+  // The method and the action take one entry each.
+  size_t num_entries = 2;
+  if (UseThreadCpuClock()) {
+    num_entries++;
+  }
+  if (UseWallClock()) {
+    // On 32-bit architectures the timestamp counter is stored as two 32-bit values.
+    num_entries += (art::kRuntimePointerSize == PointerSize::k32) ? 2 : 1;
+  }
+  return num_entries;
+}
+
+// Encodes the events of a per-thread trace buffer and writes them to the trace file, off the traced
+// thread. Owns the buffer and gives it back to the buffer pool once written.
+class TraceWriterTask final : public SelfDeletingTask {
+ public:
+  TraceWriterTask(Trace* trace,
+                  uintptr_t* method_trace_buffer,
+                  size_t num_entries,
+                  pid_t tid,
+                  std::vector<std::string>&& method_lines)
+      : trace_(trace),
+        method_trace_buffer_(method_trace_buffer),
+        num_entries_(num_entries),
+        tid_(tid),
+        method_lines_(std::move(method_lines)) {}
+
+  void Run(Thread* self) override {
+    {
+      MutexLock mu(self, trace_->tracing_lock_);
+      trace_->WriteStreamingBuffer(method_trace_buffer_.get(), num_entries_, tid_, method_lines_);
+    }
+    trace_->ReleaseStreamingBuffer(self, std::move(method_trace_buffer_));
+  }
+
+ private:
+  Trace* const trace_;
+  std::unique_ptr<uintptr_t[]> method_trace_buffer_;
+  const size_t num_entries_;
+  const pid_t tid_;
+  const std::vector<std::string> method_lines_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceWriterTask);
+};
+
+uintptr_t* Trace::AcquireStreamingBuffer(Thread* self) {
+  MutexLock mu(self, buffer_pool_lock_);
+  // The caller may hold the mutator lock. This is fine since the trace writer doesn't need it to
+  // make progress and release a buffer.
+  while (num_queued_buffers_ >= kMaxQueuedStreamingBuffers) {
+    buffer_pool_cond_.WaitHoldingLocks(self);
+  }
+  ++num_queued_buffers_;
+  if (free_buffers_.empty()) {
+    return new uintptr_t[std::max(kMinBufSize, kPerThreadBufSize)]();
+  }
+  uintptr_t* buffer = free_buffers_.back().release();
+  free_buffers_.pop_back();
+  return buffer;
+}
+
+void Trace::ReleaseStreamingBuffer(Thread* self, std::unique_ptr<uintptr_t[]>&& buffer) {
+  MutexLock mu(self, buffer_pool_lock_);
+  DCHECK_NE(num_queued_buffers_, 0u);
+  --num_queued_buffers_;
+  if (free_buffers_.size() < kMaxQueuedStreamingBuffers) {
+    free_buffers_.push_back(std::move(buffer));
+  }
+  buffer_pool_cond_.Signal(self);
+}
+
+void Trace::FlushStreamingBuffer(Thread* thread, bool release) {
+  Thread* self = Thread::Current();
+  // Get the buffer to continue recording into before taking the tracing_lock_, which the trace
+  // writer needs to make room. Releasing threads don't record any further events and must not
+  // block, as they may hold the trace_lock_ or have all other threads suspended.
+  uintptr_t* new_buffer = nullptr;
+  if (release) {
+    MutexLock mu(self, buffer_pool_lock_);
+    ++num_queued_buffers_;
+  } else {
+    new_buffer = AcquireStreamingBuffer(self);
+  }
   uintptr_t* method_trace_buffer = thread->GetMethodTraceBuffer();
+  size_t* current_offset = thread->GetMethodTraceIndexPtr();
+  size_t num_entries = *current_offset;
+
+  // Take a tracing_lock_ to allocate a unique method id for each method. We do that by maintaining
+  // a map from id to method for each newly seen method. The method lines have to be computed here
+  // since the trace writer cannot look at the methods. The task is queued under the same lock so
+  // that the writer sees the methods in the order in which they were assigned ids.
+  MutexLock mu(self, tracing_lock_);
+  std::vector<std::string> method_lines;
+  const size_t entries_per_event = GetNumEntriesPerEvent();
+  for (size_t entry_index = 0; entry_index < num_entries; entry_index += entries_per_event) {
+    ArtMethod* method = reinterpret_cast<ArtMethod*>(method_trace_buffer[entry_index]);
+    auto it = art_method_id_map_.find(method);
+    uint32_t method_index = 0;
+    // If we haven't seen this method before record information about the method.
+    if (it == art_method_id_map_.end()) {
+      art_method_id_map_.emplace(method, current_method_index_);
+      method_index = current_method_index_;
+      current_method_index_++;
+      method_lines.push_back(GetMethodLine(method, method_index));
+    } else {
+      method_index = it->second;
+    }
+    method_trace_buffer[entry_index] = method_index;
+  }
+  thread_pool_->AddTask(self,
+                        new TraceWriterTask(this,
+                                            method_trace_buffer,
+                                            num_entries,
+                                            thread->GetTid(),
+                                            std::move(method_lines)));
+
+  thread->SetMethodTraceBuffer(new_buffer);
+  *current_offset = 0;
+}
+
+void Trace::WriteStreamingBuffer(const uintptr_t* method_trace_buffer,
+                                 size_t num_entries,
+                                 pid_t tid,
+                                 const std::vector<std::string>& method_lines) {
   // Create a temporary buffer to encode the trace events from the specified thread.
   size_t buffer_size = kPerThreadBufSize;
   size_t current_index = 0;
   std::unique_ptr<uint8_t[]> buffer(new uint8_t[std::max(kMinBufSize, buffer_size)]);
 
-  size_t num_entries = *(thread->GetMethodTraceIndexPtr());
+  // Write a special block with the name of each method seen for the first time.
+  for (const std::string& method_line : method_lines) {
+    static constexpr size_t kMethodNameHeaderSize = 5;
+    uint8_t method_header[kMethodNameHeaderSize];
+    DCHECK_LT(kMethodNameHeaderSize, kPerThreadBufSize);
+    Append2LE(method_header, 0);
+    method_header[2] = kOpNewMethod;
+    Append2LE(method_header + 3, static_cast<uint16_t>(method_line.length()));
+    WriteToBuf(method_header,
+               kMethodNameHeaderSize,
+               method_line,
+               &current_index,
+               buffer.get(),
+               buffer_size);
+  }
+
   for (size_t entry_index = 0; entry_index < num_entries;) {
-    ArtMethod* method = reinterpret_cast<ArtMethod*>(method_trace_buffer[entry_index++]);
+    uint32_t method_index = static_cast<uint32_t>(method_trace_buffer[entry_index++]);
     TraceAction action = DecodeTraceAction(method_trace_buffer[entry_index++]);
     uint32_t thread_time = 0;
     uint32_t wall_time = 0;
@@ -1127,36 +1318,11 @@ void Trace::FlushStreamingBuffer(Thread* thread) {
       wall_time = GetMicroTime(timestamp) - start_time_;
     }
 
-    auto it = art_method_id_map_.find(method);
-    uint32_t method_index = 0;
-    // If we haven't seen this method before record information about the method.
-    if (it == art_method_id_map_.end()) {
-      art_method_id_map_.emplace(method, current_method_index_);
-      method_index = current_method_index_;
-      current_method_index_++;
-      // Write a special block with the name.
-      std::string method_line(GetMethodLine(method, method_index));
-      static constexpr size_t kMethodNameHeaderSize = 5;
-      uint8_t method_header[kMethodNameHeaderSize];
-      DCHECK_LT(kMethodNameHeaderSize, kPerThreadBufSize);
-      Append2LE(method_header, 0);
-      method_header[2] = kOpNewMethod;
-      Append2LE(method_header + 3, static_cast<uint16_t>(method_line.length()));
-      WriteToBuf(method_header,
-                 kMethodNameHeaderSize,
-                 method_line,
-                 &current_index,
-                 buffer.get(),
-                 buffer_size);
-    } else {
-      method_index = it->second;
-    }
-
     const size_t record_size = GetRecordSize(clock_source_);
     DCHECK_LT(record_size, kPerThreadBufSize);
     EnsureSpace(buffer.get(), &current_index, buffer_size, record_size);
     EncodeEventEntry(
-        buffer.get() + current_index, thread, method_index, action, thread_time, wall_time);
+        buffer.get() + current_index, tid, method_index, action, thread_time, wall_time);
     current_index += record_size;
   }
 
@@ -1204,7 +1370,7 @@ void Trace::RecordMethodEvent(Thread* thread,
   uint32_t wall_clock_diff = GetMicroTime(timestamp_counter) - start_time_;
   MutexLock mu(Thread::Current(), tracing_lock_);
   EncodeEventEntry(
-      ptr, thread, EncodeTraceMethod(method), action, thread_clock_diff, wall_clock_diff);
+      ptr, thread->GetTid(), EncodeTraceMethod(method), action, thread_clock_diff, wall_clock_diff);
 }
 
 void Trace::LogMethodTraceEvent(Thread* thread,
@@ -1213,8 +1379,9 @@ void Trace::LogMethodTraceEvent(Thread* thread,
                                 uint32_t thread_clock_diff,
                                 uint64_t timestamp_counter) {
   // This method is called in both tracing modes (method and sampling). In sampling mode, this
-  // method is only called by the sampling thread. In method tracing mode, it can be called
-  // concurrently.
+  // method is called from the sampling checkpoint, either by the sampled thread or by the sampling
+  // thread while the sampled thread is suspended, so the events of a thread are never recorded
+  // concurrently. In both modes, it can be called concurrently for different threads.
 
   // Ensure we always use the non-obsolete version of the method so that entry/exit events have the
   // same pointer value.
@@ -1228,14 +1395,14 @@ void Trace::LogMethodTraceEvent(Thread* thread,
 }
 
 void Trace::EncodeEventEntry(uint8_t* ptr,
-                             Thread* thread,
+                             pid_t tid,
                              uint32_t method_index,
                              TraceAction action,
                              uint32_t thread_clock_diff,
                              uint32_t wall_clock_diff) {
   static constexpr size_t kPacketSize = 14U;  // The maximum size of data in a packet.
   uint32_t method_value = (method_index << TraceActionBits) | action;
-  Append2LE(ptr, thread->GetTid());
+  Append2LE(ptr, tid);
   Append4LE(ptr + 2, method_value);
   ptr += 6;
 
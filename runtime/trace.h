@@ -46,6 +46,7 @@ class ArtMethod;
 class DexFile;
 class ShadowFrame;
 class Thread;
+class ThreadPool;
 
 using DexIndexBitSet = std::bitset<65536>;
 
@@ -100,7 +101,8 @@ enum TraceAction {
 
 // Class for recording event traces. Trace data is either collected
 // synchronously during execution (TracingMode::kMethodTracingActive),
-// or by a separate sampling thread (TracingMode::kSampleProfilingActive).
+// or by a separate sampling thread that has each thread sample its own
+// stack via a checkpoint (TracingMode::kSampleProfilingActive).
 class Trace final : public instrumentation::InstrumentationListener {
  public:
   enum TraceFlag {
@@ -241,7 +243,8 @@ class Trace final : public instrumentation::InstrumentationListener {
         size_t buffer_size,
         int flags,
         TraceOutputMode output_mode,
-        TraceMode trace_mode);
+        TraceMode trace_mode,
+        std::unique_ptr<ThreadPool>&& thread_pool);
 
   // The sampling interval in microseconds is passed as an argument.
   static void* RunSamplingThread(void* arg) REQUIRES(!Locks::trace_lock_);
@@ -279,7 +282,7 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Encodes event in non-streaming mode. This assumes that there is enough space reserved to
   // encode the entry.
   void EncodeEventEntry(uint8_t* ptr,
-                        Thread* thread,
+                        pid_t tid,
                         uint32_t method_index,
                         TraceAction action,
                         uint32_t thread_clock_diff,
@@ -296,13 +299,32 @@ class Trace final : public instrumentation::InstrumentationListener {
                                   uint32_t thread_clock_diff,
                                   uint64_t timestamp) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!tracing_lock_);
-  // This encodes all the events in the per-thread trace buffer and writes it to the trace file.
-  // This acquires streaming lock to prevent any other threads writing concurrently. It is required
-  // to serialize these since each method is encoded with a unique id which is assigned when the
-  // method is seen for the first time in the recoreded events. So we need to serialize these
-  // flushes across threads.
-  void FlushStreamingBuffer(Thread* thread) REQUIRES_SHARED(Locks::mutator_lock_)
-      REQUIRES(!tracing_lock_);
+  // This hands the events in the per-thread trace buffer over to the trace writer thread, which
+  // encodes them and writes them to the trace file. Each method is encoded with a unique id which
+  // is assigned here, under the streaming lock, when the method is seen for the first time in the
+  // recorded events. The writer tasks are queued under the same lock and run in order, so a method
+  // is always described in the trace file before the events that refer to it. The thread gets a
+  // fresh buffer, unless `release` is true in which case it is left without one.
+  void FlushStreamingBuffer(Thread* thread, bool release) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!tracing_lock_, !buffer_pool_lock_);
+  // Reserves a slot for one more buffer queued to the trace writer and returns a buffer to record
+  // into in its place. This blocks while kMaxQueuedStreamingBuffers buffers are queued, so that a
+  // thread recording events faster than they can be written is slowed down instead of the queued
+  // buffers growing without bound.
+  uintptr_t* AcquireStreamingBuffer(Thread* self) REQUIRES(!tracing_lock_, !buffer_pool_lock_);
+  // Called by the trace writer once `buffer` is written, frees its slot and keeps the buffer for
+  // reuse.
+  void ReleaseStreamingBuffer(Thread* self, std::unique_ptr<uintptr_t[]>&& buffer)
+      REQUIRES(!tracing_lock_, !buffer_pool_lock_);
+  // Encodes the events of a per-thread trace buffer, whose methods were already replaced by their
+  // ids, and writes them to the trace file after the descriptions of the newly seen methods. This
+  // is called on the trace writer thread and doesn't touch any runtime data structures.
+  void WriteStreamingBuffer(const uintptr_t* method_trace_buffer,
+                            size_t num_entries,
+                            pid_t tid,
+                            const std::vector<std::string>& method_lines) REQUIRES(tracing_lock_);
+  // Returns the number of per-thread buffer entries used to record one event.
+  size_t GetNumEntriesPerEvent();
   // Ensures there is sufficient space in the buffer to record the requested_size. If there is not
   // enough sufficient space the current contents of the buffer are written to the file and
   // current_index is reset to 0. This doesn't check if buffer_size is big enough to hold the
@@ -339,8 +361,9 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
+  // Used to remember an unused stack trace to avoid re-allocation during sampling. Atomic since
+  // threads sample their own stacks concurrently.
+  static Atomic<std::vector<ArtMethod*>*> temp_stack_trace_;
 
   // File to write trace data out to, null if direct to ddms.
   std::unique_ptr<File> trace_file_;
@@ -410,10 +433,23 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Streaming mode data.
   Mutex tracing_lock_;
 
+  // Single worker pool that writes the per-thread buffers to the trace file in streaming mode, so
+  // that traced threads don't stall on encoding and file I/O. Null in other modes.
+  std::unique_ptr<ThreadPool> thread_pool_;
+
+  // The buffers queued to the trace writer in streaming mode and the written buffers kept for
+  // reuse. See AcquireStreamingBuffer().
+  Mutex buffer_pool_lock_;
+  ConditionVariable buffer_pool_cond_ GUARDED_BY(buffer_pool_lock_);
+  size_t num_queued_buffers_ GUARDED_BY(buffer_pool_lock_) = 0;
+  std::vector<std::unique_ptr<uintptr_t[]>> free_buffers_ GUARDED_BY(buffer_pool_lock_);
+
   // Map from ArtMethod* to index.
   std::unordered_map<ArtMethod*, uint32_t> art_method_id_map_ GUARDED_BY(tracing_lock_);
   uint32_t current_method_index_ = 0;
 
+  friend class TraceWriterTask;
+
   DISALLOW_COPY_AND_ASSIGN(Trace);
 };
 
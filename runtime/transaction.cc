@@ -51,6 +51,10 @@ Transaction::Transaction(bool strict,
       intern_string_logs_(allocator_.Adapter(kArenaAllocTransaction)),
       resolve_string_logs_(allocator_.Adapter(kArenaAllocTransaction)),
       resolve_method_type_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+      last_object_(nullptr),
+      last_object_log_(nullptr),
+      last_array_(nullptr),
+      last_array_log_(nullptr),
       aborted_(false),
       rolling_back_(false),
       heap_(Runtime::Current()->GetHeap()),
@@ -167,7 +171,20 @@ bool Transaction::ReadConstraint(ObjPtr<mirror::Object> obj) const {
 }
 
 inline Transaction::ObjectLog& Transaction::GetOrCreateObjectLog(mirror::Object* obj) {
-  return object_logs_.GetOrCreate(obj, [&]() { return ObjectLog(&allocator_); });
+  // Class initializers typically write several fields of the same object in a row.
+  if (obj != last_object_) {
+    last_object_log_ = &object_logs_.GetOrCreate(obj, [&]() { return ObjectLog(&allocator_); });
+    last_object_ = obj;
+  }
+  return *last_object_log_;
+}
+
+inline Transaction::ArrayLog& Transaction::GetOrCreateArrayLog(mirror::Array* array) {
+  if (array != last_array_) {
+    last_array_log_ = &array_logs_.GetOrCreate(array, [&]() { return ArrayLog(&allocator_); });
+    last_array_ = array;
+  }
+  return *last_array_log_;
 }
 
 void Transaction::RecordWriteFieldBoolean(mirror::Object* obj,
@@ -247,7 +264,7 @@ void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t
   DCHECK(array->IsArrayInstance());
   DCHECK(!array->IsObjectArray());
   DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ArrayLog& array_log = array_logs_.GetOrCreate(array, [&]() { return ArrayLog(&allocator_); });
+  ArrayLog& array_log = GetOrCreateArrayLog(array);
   array_log.LogValue(index, value);
 }
 
@@ -314,6 +331,7 @@ void Transaction::UndoObjectModifications() {
     it.second.Undo(it.first);
   }
   object_logs_.clear();
+  last_object_ = nullptr;
 }
 
 void Transaction::UndoArrayModifications() {
@@ -323,6 +341,7 @@ void Transaction::UndoArrayModifications() {
     it.second.Undo(it.first);
   }
   array_logs_.clear();
+  last_array_ = nullptr;
 }
 
 void Transaction::UndoInternStringTableModifications() {
@@ -400,6 +419,7 @@ void Transaction::VisitObjectLogs(RootVisitor* visitor, ArenaStack* arena_stack)
 
   // Update object logs with moving roots.
   UpdateKeys(moving_roots, object_logs_);
+  last_object_ = nullptr;
 }
 
 void Transaction::VisitArrayLogs(RootVisitor* visitor, ArenaStack* arena_stack) {
@@ -419,6 +439,7 @@ void Transaction::VisitArrayLogs(RootVisitor* visitor, ArenaStack* arena_stack)
 
   // Update array logs with moving roots.
   UpdateKeys(moving_roots, array_logs_);
+  last_array_ = nullptr;
 }
 
 void Transaction::VisitInternStringLogs(RootVisitor* visitor) {
@@ -473,13 +494,14 @@ void Transaction::ObjectLog::LogValue(ObjectLog::FieldValueKind kind,
                                       MemberOffset offset,
                                       uint64_t value,
                                       bool is_volatile) {
-  auto it = field_values_.find(offset.Uint32Value());
-  if (it == field_values_.end()) {
+  // Only the first write needs to be recorded, to restore the original value on rollback.
+  auto lb = field_values_.lower_bound(offset.Uint32Value());
+  if (lb == field_values_.end() || lb->first != offset.Uint32Value()) {
     ObjectLog::FieldValue field_value;
     field_value.value = value;
     field_value.is_volatile = is_volatile;
     field_value.kind = kind;
-    field_values_.emplace(offset.Uint32Value(), std::move(field_value));
+    field_values_.PutBefore(lb, offset.Uint32Value(), std::move(field_value));
   }
 }
 
@@ -685,7 +707,10 @@ Transaction::InternStringLog::InternStringLog(ObjPtr<mirror::String> s,
 
 void Transaction::ArrayLog::LogValue(size_t index, uint64_t value) {
   // Add a mapping if there is none yet.
-  array_values_.FindOrAdd(index, value);
+  auto lb = array_values_.lower_bound(index);
+  if (lb == array_values_.end() || lb->first != index) {
+    array_values_.PutBefore(lb, index, value);
+  }
 }
 
 void Transaction::ArrayLog::Undo(mirror::Array* array) const {
@@ -317,6 +317,7 @@ class Transaction final {
   const std::string& GetAbortMessage() const;
 
   ObjectLog& GetOrCreateObjectLog(mirror::Object* obj);
+  ArrayLog& GetOrCreateArrayLog(mirror::Array* array);
 
   // The top-level transaction creates an `ArenaStack` which is then
   // passed down to nested transactions.
@@ -329,6 +330,11 @@ class Transaction final {
   ScopedArenaForwardList<InternStringLog> intern_string_logs_;
   ScopedArenaForwardList<ResolveStringLog> resolve_string_logs_;
   ScopedArenaForwardList<ResolveMethodTypeLog> resolve_method_type_logs_;
+  // The log of the last object and array written, reset when the keys of the logs change.
+  mirror::Object* last_object_;
+  ObjectLog* last_object_log_;
+  mirror::Array* last_array_;
+  ArrayLog* last_array_log_;
   bool aborted_;
   bool rolling_back_;  // Single thread, no race.
   gc::Heap* const heap_;
@@ -123,8 +123,8 @@ class VdexFile {
     static constexpr uint8_t kVdexMagic[] = { 'v', 'd', 'e', 'x' };
 
     // The format version of the verifier deps header and the verifier deps.
-    // Last update: Introduce vdex sections.
-    static constexpr uint8_t kVdexVersion[] = { '0', '2', '7', '\0' };
+    // Last update: Halve the load factor of the type lookup tables.
+    static constexpr uint8_t kVdexVersion[] = { '0', '2', '8', '\0' };
 
     uint8_t magic_[4];
     uint8_t vdex_version_[4];
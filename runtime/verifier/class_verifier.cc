@@ -175,6 +175,7 @@ FailureKind ClassVerifier::VerifyClass(Thread* self,
                  << ", class: " << PrettyDescriptor(dex_file->GetClassDescriptor(class_def));
 
   GetMetrics()->ClassVerificationCount()->AddOne();
+  GetMetrics()->ClassVerificationTime()->Add(elapsed_time_microseconds);
 
   GetMetrics()->ClassVerificationTotalTimeDelta()->Add(elapsed_time_microseconds);
   GetMetrics()->ClassVerificationCountDelta()->AddOne();
@@ -184,7 +184,19 @@ inline const RegType& RegTypeCache::JavaLangObject(bool precise) {
 template <class RegTypeType>
 inline RegTypeType& RegTypeCache::AddEntry(RegTypeType* new_entry) {
   DCHECK(new_entry != nullptr);
+  DCHECK_EQ(new_entry->GetId(), entries_.size());
   entries_.push_back(new_entry);
+  next_same_descriptor_.push_back(0u);
+  if (!new_entry->descriptor_.empty()) {
+    uint16_t id = new_entry->GetId();
+    auto it = descriptor_entries_.find(new_entry->descriptor_);
+    if (it == descriptor_entries_.end()) {
+      descriptor_entries_.emplace(new_entry->descriptor_, DescriptorChain{id, id});
+    } else {
+      next_same_descriptor_[it->second.last] = id;
+      it->second.last = id;
+    }
+  }
   if (new_entry->HasClass()) {
     ObjPtr<mirror::Class> klass = new_entry->GetClass();
     DCHECK(!klass->IsPrimitive());
@@ -187,9 +187,12 @@ const RegType& RegTypeCache::From(ObjPtr<mirror::ClassLoader> loader,
   std::string_view sv_descriptor(descriptor);
   // Try looking up the class in the cache first. We use a std::string_view to avoid
   // repeated strlen operations on the descriptor.
-  for (size_t i = primitive_count_; i < entries_.size(); i++) {
-    if (MatchDescriptor(i, sv_descriptor, precise)) {
-      return *(entries_[i]);
+  auto it = descriptor_entries_.find(sv_descriptor);
+  if (it != descriptor_entries_.end()) {
+    for (uint16_t i = it->second.first; i != 0u; i = next_same_descriptor_[i]) {
+      if (MatchDescriptor(i, sv_descriptor, precise)) {
+        return *(entries_[i]);
+      }
     }
   }
   // Class not found in the cache, will create a new type for that.
@@ -288,6 +291,8 @@ RegTypeCache::RegTypeCache(ClassLinker* class_linker,
                            bool can_suspend)
     : entries_(allocator.Adapter(kArenaAllocVerifier)),
       klass_entries_(allocator.Adapter(kArenaAllocVerifier)),
+      descriptor_entries_(allocator.Adapter(kArenaAllocVerifier)),
+      next_same_descriptor_(allocator.Adapter(kArenaAllocVerifier)),
       allocator_(allocator),
       class_linker_(class_linker),
       can_load_classes_(can_load_classes) {
@@ -303,6 +308,9 @@ RegTypeCache::RegTypeCache(ClassLinker* class_linker,
   // constants.
   entries_.reserve(kNumReserveEntries + kNumPrimitivesAndSmallConstants);
   FillPrimitiveAndSmallConstantTypes();
+  // The primitives and small constants are not looked up by descriptor.
+  next_same_descriptor_.reserve(entries_.capacity());
+  next_same_descriptor_.resize(entries_.size(), 0u);
 }
 
 RegTypeCache::~RegTypeCache() {
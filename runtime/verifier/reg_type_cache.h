@@ -211,6 +211,18 @@ class RegTypeCache {
   // Fast lookup for quickly finding entries that have a matching class.
   ScopedArenaVector<std::pair<GcRoot<mirror::Class>, const RegType*>> klass_entries_;
 
+  // First and last ids of the entries with a given descriptor.
+  struct DescriptorChain {
+    uint16_t first;
+    uint16_t last;
+  };
+
+  // Fast lookup for the entries with a matching descriptor. The entries with the same
+  // descriptor are linked in insertion order through `next_same_descriptor_`, indexed
+  // by id, where 0 (the undefined type) marks the end of the chain.
+  ScopedArenaUnorderedMap<std::string_view, DescriptorChain> descriptor_entries_;
+  ScopedArenaVector<uint16_t> next_same_descriptor_;
+
   // Arena allocator.
   ScopedArenaAllocator& allocator_;
 
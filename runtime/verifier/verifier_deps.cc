@@ -26,7 +26,10 @@
 #include "base/mutex-inl.h"
 #include "compiler_callbacks.h"
 #include "dex/class_accessor-inl.h"
+#include "dex/code_item_accessors-inl.h"
 #include "dex/dex_file-inl.h"
+#include "dex/dex_file_exception_helpers.h"
+#include "dex/dex_instruction-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "oat_file.h"
@@ -703,7 +706,7 @@ static ObjPtr<mirror::Class> FindClassAndClearException(ClassLinker* class_linke
 
 bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
                                        const DexFile& dex_file,
-                                       const std::vector<std::set<TypeAssignability>>& assignables,
+                                       ArrayRef<const std::set<TypeAssignability>> assignables,
                                        Thread* self,
                                        /* out */ std::string* error_msg) const {
   StackHandleScope<2> hs(self);
@@ -752,7 +755,305 @@ bool VerifierDeps::VerifyDexFile(Handle<mirror::ClassLoader> class_loader,
                                  const DexFileDeps& deps,
                                  Thread* self,
                                  /* out */ std::string* error_msg) const {
-  return VerifyAssignability(class_loader, dex_file, deps.assignable_types_, self, error_msg);
+  return VerifyAssignability(class_loader,
+                             dex_file,
+                             ArrayRef<const std::set<TypeAssignability>>(deps.assignable_types_),
+                             self,
+                             error_msg);
+}
+
+namespace {
+
+// Compares the class definitions of two versions of a dex file. The indices used by the class
+// data shift between the versions as soon as a string, type or member is added or removed, so
+// the comparison is done on what the indices refer to.
+class ClassDefComparator {
+ public:
+  ClassDefComparator(const DexFile& lhs, const DexFile& rhs) : lhs_(lhs), rhs_(rhs) {}
+
+  bool Equals(const dex::ClassDef& lhs_def, const dex::ClassDef& rhs_def) const {
+    if (lhs_def.access_flags_ != rhs_def.access_flags_ ||
+        !SameType(lhs_def.class_idx_, rhs_def.class_idx_) ||
+        lhs_def.superclass_idx_.IsValid() != rhs_def.superclass_idx_.IsValid() ||
+        (lhs_def.superclass_idx_.IsValid() &&
+            !SameType(lhs_def.superclass_idx_, rhs_def.superclass_idx_)) ||
+        !SameTypeList(lhs_.GetInterfacesList(lhs_def), rhs_.GetInterfacesList(rhs_def))) {
+      return false;
+    }
+    ClassAccessor lhs_accessor(lhs_, lhs_def);
+    ClassAccessor rhs_accessor(rhs_, rhs_def);
+    if (lhs_accessor.NumStaticFields() != rhs_accessor.NumStaticFields() ||
+        lhs_accessor.NumInstanceFields() != rhs_accessor.NumInstanceFields() ||
+        lhs_accessor.NumDirectMethods() != rhs_accessor.NumDirectMethods() ||
+        lhs_accessor.NumVirtualMethods() != rhs_accessor.NumVirtualMethods()) {
+      return false;
+    }
+    auto rhs_fields = rhs_accessor.GetFields();
+    auto rhs_field = rhs_fields.begin();
+    for (const ClassAccessor::Field& lhs_field : lhs_accessor.GetFields()) {
+      if (lhs_field.GetAccessFlags() != rhs_field->GetAccessFlags() ||
+          !SameField(lhs_field.GetIndex(), rhs_field->GetIndex())) {
+        return false;
+      }
+      ++rhs_field;
+    }
+    auto rhs_methods = rhs_accessor.GetMethods();
+    auto rhs_method = rhs_methods.begin();
+    for (const ClassAccessor::Method& lhs_method : lhs_accessor.GetMethods()) {
+      if (lhs_method.GetAccessFlags() != rhs_method->GetAccessFlags() ||
+          !SameMethod(lhs_method.GetIndex(), rhs_method->GetIndex()) ||
+          !SameCode(lhs_method.GetInstructionsAndData(), rhs_method->GetInstructionsAndData())) {
+        return false;
+      }
+      ++rhs_method;
+    }
+    return true;
+  }
+
+ private:
+  bool SameString(dex::StringIndex lhs_idx, dex::StringIndex rhs_idx) const {
+    return lhs_.StringViewByIdx(lhs_idx) == rhs_.StringViewByIdx(rhs_idx);
+  }
+
+  bool SameType(dex::TypeIndex lhs_idx, dex::TypeIndex rhs_idx) const {
+    return lhs_.GetTypeDescriptorView(lhs_.GetTypeId(lhs_idx)) ==
+           rhs_.GetTypeDescriptorView(rhs_.GetTypeId(rhs_idx));
+  }
+
+  bool SameTypeList(const dex::TypeList* lhs_list, const dex::TypeList* rhs_list) const {
+    uint32_t size = (lhs_list != nullptr) ? lhs_list->Size() : 0u;
+    if (size != ((rhs_list != nullptr) ? rhs_list->Size() : 0u)) {
+      return false;
+    }
+    for (uint32_t i = 0; i != size; ++i) {
+      if (!SameType(lhs_list->GetTypeItem(i).type_idx_, rhs_list->GetTypeItem(i).type_idx_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool SameField(uint32_t lhs_idx, uint32_t rhs_idx) const {
+    const dex::FieldId& lhs_id = lhs_.GetFieldId(lhs_idx);
+    const dex::FieldId& rhs_id = rhs_.GetFieldId(rhs_idx);
+    return SameType(lhs_id.class_idx_, rhs_id.class_idx_) &&
+           SameString(lhs_id.name_idx_, rhs_id.name_idx_) &&
+           SameType(lhs_id.type_idx_, rhs_id.type_idx_);
+  }
+
+  bool SameMethod(uint32_t lhs_idx, uint32_t rhs_idx) const {
+    const dex::MethodId& lhs_id = lhs_.GetMethodId(lhs_idx);
+    const dex::MethodId& rhs_id = rhs_.GetMethodId(rhs_idx);
+    return SameType(lhs_id.class_idx_, rhs_id.class_idx_) &&
+           SameString(lhs_id.name_idx_, rhs_id.name_idx_) &&
+           lhs_.GetMethodSignature(lhs_id) == rhs_.GetMethodSignature(rhs_id);
+  }
+
+  bool SameProto(uint32_t lhs_idx, uint32_t rhs_idx) const {
+    return lhs_.GetProtoSignature(lhs_.GetProtoId(dex::ProtoIndex(lhs_idx))) ==
+           rhs_.GetProtoSignature(rhs_.GetProtoId(dex::ProtoIndex(rhs_idx)));
+  }
+
+  bool SameIndex(Instruction::IndexType index_type, uint32_t lhs_idx, uint32_t rhs_idx) const {
+    switch (index_type) {
+      case Instruction::kIndexTypeRef:
+        return SameType(dex::TypeIndex(lhs_idx), dex::TypeIndex(rhs_idx));
+      case Instruction::kIndexStringRef:
+        return SameString(dex::StringIndex(lhs_idx), dex::StringIndex(rhs_idx));
+      case Instruction::kIndexMethodRef:
+      case Instruction::kIndexMethodAndProtoRef:
+        return SameMethod(lhs_idx, rhs_idx);
+      case Instruction::kIndexFieldRef:
+        return SameField(lhs_idx, rhs_idx);
+      case Instruction::kIndexProtoRef:
+        return SameProto(lhs_idx, rhs_idx);
+      default:
+        // Call sites and method handles are not compared, consider the code changed.
+        return false;
+    }
+  }
+
+  bool SameCode(const CodeItemDataAccessor& lhs_code, const CodeItemDataAccessor& rhs_code) const {
+    if (lhs_code.HasCodeItem() != rhs_code.HasCodeItem()) {
+      return false;
+    }
+    if (!lhs_code.HasCodeItem()) {
+      return true;
+    }
+    if (lhs_code.RegistersSize() != rhs_code.RegistersSize() ||
+        lhs_code.InsSize() != rhs_code.InsSize() ||
+        lhs_code.OutsSize() != rhs_code.OutsSize() ||
+        lhs_code.TriesSize() != rhs_code.TriesSize() ||
+        lhs_code.InsnsSizeInCodeUnits() != rhs_code.InsnsSizeInCodeUnits()) {
+      return false;
+    }
+    const uint16_t* lhs_insns = lhs_code.Insns();
+    const uint16_t* rhs_insns = rhs_code.Insns();
+    for (const DexInstructionPcPair& inst : lhs_code) {
+      uint32_t dex_pc = inst.DexPc();
+      const uint16_t* lhs_units = lhs_insns + dex_pc;
+      const uint16_t* rhs_units = rhs_insns + dex_pc;
+      // Code units holding an index, which are compared separately.
+      uint32_t first_index_unit = 0u;
+      uint32_t last_index_unit = 0u;
+      uint32_t proto_unit = 0u;
+      switch (Instruction::FormatOf(inst->Opcode())) {
+        case Instruction::k21c:
+        case Instruction::k22c:
+        case Instruction::k35c:
+        case Instruction::k3rc:
+          first_index_unit = last_index_unit = 1u;
+          break;
+        case Instruction::k31c:
+          first_index_unit = 1u;
+          last_index_unit = 2u;
+          break;
+        case Instruction::k45cc:
+        case Instruction::k4rcc:
+          first_index_unit = last_index_unit = 1u;
+          proto_unit = 3u;
+          break;
+        default:
+          break;
+      }
+      for (size_t i = 0, size = inst->SizeInCodeUnits(); i != size; ++i) {
+        bool is_index = (i != 0u) &&
+                        ((i >= first_index_unit && i <= last_index_unit) || i == proto_unit);
+        if (!is_index && lhs_units[i] != rhs_units[i]) {
+          return false;
+        }
+      }
+      if (first_index_unit != 0u) {
+        Instruction::IndexType index_type = Instruction::IndexTypeOf(inst->Opcode());
+        uint32_t lhs_idx = lhs_units[first_index_unit];
+        uint32_t rhs_idx = rhs_units[first_index_unit];
+        if (last_index_unit != first_index_unit) {
+          lhs_idx |= static_cast<uint32_t>(lhs_units[last_index_unit]) << 16;
+          rhs_idx |= static_cast<uint32_t>(rhs_units[last_index_unit]) << 16;
+        }
+        if (!SameIndex(index_type, lhs_idx, rhs_idx) ||
+            (proto_unit != 0u && !SameProto(lhs_units[proto_unit], rhs_units[proto_unit]))) {
+          return false;
+        }
+      }
+    }
+    auto rhs_tries = rhs_code.TryItems();
+    const dex::TryItem* rhs_try = rhs_tries.begin();
+    for (const dex::TryItem& lhs_try : lhs_code.TryItems()) {
+      if (lhs_try.start_addr_ != rhs_try->start_addr_ ||
+          lhs_try.insn_count_ != rhs_try->insn_count_) {
+        return false;
+      }
+      CatchHandlerIterator lhs_handlers(lhs_code, lhs_try);
+      CatchHandlerIterator rhs_handlers(rhs_code, *rhs_try);
+      for (; lhs_handlers.HasNext(); lhs_handlers.Next(), rhs_handlers.Next()) {
+        if (!rhs_handlers.HasNext() ||
+            lhs_handlers.GetHandlerAddress() != rhs_handlers.GetHandlerAddress()) {
+          return false;
+        }
+        dex::TypeIndex lhs_type_idx = lhs_handlers.GetHandlerTypeIndex();
+        dex::TypeIndex rhs_type_idx = rhs_handlers.GetHandlerTypeIndex();
+        if (lhs_type_idx.IsValid() != rhs_type_idx.IsValid() ||
+            (lhs_type_idx.IsValid() && !SameType(lhs_type_idx, rhs_type_idx))) {
+          return false;
+        }
+      }
+      if (rhs_handlers.HasNext()) {
+        return false;
+      }
+      ++rhs_try;
+    }
+    return true;
+  }
+
+  const DexFile& lhs_;
+  const DexFile& rhs_;
+};
+
+}  // namespace
+
+size_t VerifierDeps::ReuseUnchangedClasses(const DexFile& dex_file,
+                                           const DexFile& old_dex_file,
+                                           const VerifierDeps& old_deps) {
+  DexFileDeps* deps = GetDexFileDeps(dex_file);
+  const DexFileDeps* old_dex_deps = old_deps.GetDexFileDeps(old_dex_file);
+  DCHECK(deps != nullptr);
+  DCHECK(old_dex_deps != nullptr);
+
+  // The strings of the old dependencies are either in `dex_file` or become extra strings.
+  // This runs before verification, so there is no need to go through the main `VerifierDeps`.
+  auto get_id = [&](const std::string& str) {
+    const dex::StringId* string_id = dex_file.FindStringId(str.c_str());
+    if (string_id != nullptr) {
+      return dex_file.GetIndexForStringId(*string_id);
+    }
+    uint32_t found_id;
+    if (!FindExistingStringId(deps->strings_, str, &found_id)) {
+      found_id = deps->strings_.size();
+      deps->strings_.push_back(str);
+    }
+    return dex::StringIndex(dex_file.NumStringIds() + found_id);
+  };
+
+  ClassDefComparator comparator(dex_file, old_dex_file);
+  size_t num_reused = 0u;
+  for (ClassAccessor old_accessor : old_dex_file.GetClasses()) {
+    uint32_t old_index = old_accessor.GetClassDefIndex();
+    if (!old_dex_deps->verified_classes_[old_index]) {
+      // Classes that failed verification get another chance.
+      continue;
+    }
+    const dex::TypeId* type_id = dex_file.FindTypeId(old_accessor.GetDescriptor());
+    if (type_id == nullptr) {
+      continue;
+    }
+    const dex::ClassDef* class_def = dex_file.FindClassDef(dex_file.GetIndexForTypeId(*type_id));
+    if (class_def == nullptr || !comparator.Equals(*class_def, old_accessor.GetClassDef())) {
+      continue;
+    }
+    uint16_t index = dex_file.GetIndexForClassDef(*class_def);
+    std::set<TypeAssignability>& assignable_types = deps->assignable_types_[index];
+    for (const TypeAssignability& entry : old_dex_deps->assignable_types_[old_index]) {
+      std::string destination = old_deps.GetStringFromId(old_dex_file, entry.GetDestination());
+      std::string source = old_deps.GetStringFromId(old_dex_file, entry.GetSource());
+      assignable_types.emplace(get_id(destination), get_id(source));
+    }
+    deps->verified_classes_[index] = true;
+    deps->reused_classes_[index] = true;
+    ++num_reused;
+  }
+  return num_reused;
+}
+
+size_t VerifierDeps::ValidateReusedClasses(Thread* self,
+                                           Handle<mirror::ClassLoader> class_loader,
+                                           const std::vector<const DexFile*>& dex_files) {
+  size_t num_reused = 0u;
+  for (const DexFile* dex_file : dex_files) {
+    DexFileDeps* deps = GetDexFileDeps(*dex_file);
+    for (size_t i = 0, size = deps->reused_classes_.size(); i != size; ++i) {
+      if (!deps->reused_classes_[i]) {
+        continue;
+      }
+      std::string error_msg;
+      if (!VerifyAssignability(class_loader,
+                               *dex_file,
+                               ArrayRef<const std::set<TypeAssignability>>(
+                                   &deps->assignable_types_[i], 1u),
+                               self,
+                               &error_msg)) {
+        VLOG(verifier) << "Cannot reuse verification of "
+                       << dex_file->GetClassDescriptor(dex_file->GetClassDef(i)) << ": "
+                       << error_msg;
+        deps->assignable_types_[i].clear();
+        deps->verified_classes_[i] = false;
+        deps->reused_classes_[i] = false;
+        continue;
+      }
+      ++num_reused;
+    }
+  }
+  return num_reused;
 }
 
 }  // namespace verifier
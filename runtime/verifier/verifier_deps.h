@@ -140,6 +140,26 @@ class VerifierDeps {
   // Resets the data related to the given dex files.
   void ClearData(const std::vector<const DexFile*>& dex_files);
 
+  // Takes over the dependencies recorded in `old_deps` for `old_dex_file`, a previous version
+  // of `dex_file`, for the verified classes whose definition did not change. Returns the number
+  // of classes reused.
+  size_t ReuseUnchangedClasses(const DexFile& dex_file,
+                               const DexFile& old_dex_file,
+                               const VerifierDeps& old_deps);
+
+  // Verify the dependencies of the reused classes are still valid, and stop reusing the
+  // classes for which they are not. Returns the number of classes still reused.
+  size_t ValidateReusedClasses(Thread* self,
+                               Handle<mirror::ClassLoader> class_loader,
+                               const std::vector<const DexFile*>& dex_files)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Whether the verification of the class was taken over from a previous version of the dex file.
+  bool IsReusedClass(const DexFile& dex_file, uint16_t class_def_index) const {
+    const DexFileDeps* deps = GetDexFileDeps(dex_file);
+    return deps != nullptr && deps->reused_classes_[class_def_index];
+  }
+
   // Parses raw VerifierDeps data to extract bitvectors of which class def indices
   // were verified or not. The given `dex_files` must match the order and count of
   // dex files used to create the VerifierDeps.
@@ -165,7 +185,8 @@ class VerifierDeps {
   struct DexFileDeps {
     explicit DexFileDeps(size_t num_class_defs)
         : assignable_types_(num_class_defs),
-          verified_classes_(num_class_defs) {}
+          verified_classes_(num_class_defs),
+          reused_classes_(num_class_defs) {}
 
     // Vector of strings which are not present in the corresponding DEX file.
     // These are referred to with ids starting with `NumStringIds()` of that DexFile.
@@ -179,6 +200,10 @@ class VerifierDeps {
     // class was successfully verified.
     std::vector<bool> verified_classes_;
 
+    // Bit vector indexed by class def indices indicating whether the verification of the
+    // corresponding class was reused from a previous version of the DEX file. Not encoded.
+    std::vector<bool> reused_classes_;
+
     bool Equals(const DexFileDeps& rhs) const;
   };
 
@@ -245,7 +270,7 @@ class VerifierDeps {
 
   bool VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
                            const DexFile& dex_file,
-                           const std::vector<std::set<TypeAssignability>>& assignables,
+                           ArrayRef<const std::set<TypeAssignability>> assignables,
                            Thread* self,
                            /* out */ std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -262,6 +287,7 @@ class VerifierDeps {
   ART_FRIEND_TEST(VerifierDepsTest, EncodeDecodeMulti);
   ART_FRIEND_TEST(VerifierDepsTest, VerifyDeps);
   ART_FRIEND_TEST(VerifierDepsTest, CompilerDriver);
+  ART_FRIEND_TEST(VerifierDepsTest, ReuseUnchangedClasses);
 };
 
 }  // namespace verifier
@@ -17,6 +17,7 @@
 #include "code_simulator.h"
 
 #include "code_simulator_arm64.h"
+#include "code_simulator_riscv64.h"
 
 namespace art {
 
@@ -24,6 +25,8 @@ CodeSimulator* CodeSimulator::CreateCodeSimulator(InstructionSet target_isa) {
   switch (target_isa) {
     case InstructionSet::kArm64:
       return arm64::CodeSimulatorArm64::CreateCodeSimulatorArm64();
+    case InstructionSet::kRiscv64:
+      return riscv64::CodeSimulatorRiscv64::CreateCodeSimulatorRiscv64();
     default:
       return nullptr;
   }
@@ -0,0 +1,1230 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_simulator_riscv64.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/globals.h"
+#include "base/logging.h"  // For VLOG.
+
+namespace art {
+namespace riscv64 {
+
+// The return address set up for the simulated code. Returning to it ends the simulation.
+static constexpr uint64_t kEndOfSimulationPc = UINT64_C(0xfffffffffffffff0);
+static constexpr uint64_t kNoReservation = std::numeric_limits<uint64_t>::max();
+static constexpr size_t kStackSize = 1 * MB;
+static constexpr size_t kStackAlignment = 16u;
+
+static constexpr uint32_t kRa = 1u;
+static constexpr uint32_t kSp = 2u;
+static constexpr uint32_t kA0 = 10u;
+
+static constexpr uint64_t kNaNBox = UINT64_C(0xffffffff00000000);
+static constexpr uint32_t kSignBitS = UINT32_C(0x80000000);
+static constexpr uint64_t kSignBitD = UINT64_C(0x8000000000000000);
+
+static inline uint32_t Bits(uint32_t value, uint32_t hi, uint32_t lo) {
+  return (value >> lo) & ((UINT32_C(1) << (hi - lo + 1u)) - 1u);
+}
+
+static inline int64_t SignExtendBits(uint64_t value, uint32_t bits) {
+  uint32_t shift = 64u - bits;
+  return static_cast<int64_t>(value << shift) >> shift;
+}
+
+static inline uint64_t SignExtend32(uint64_t value) {
+  return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(value)));
+}
+
+static inline int64_t ImmI(uint32_t insn) {
+  return static_cast<int32_t>(insn) >> 20;
+}
+
+static inline int64_t ImmS(uint32_t insn) {
+  return static_cast<int32_t>((insn & UINT32_C(0xfe000000)) | (Bits(insn, 11, 7) << 20)) >> 20;
+}
+
+static inline int64_t ImmB(uint32_t insn) {
+  uint32_t imm = (Bits(insn, 31, 31) << 12) | (Bits(insn, 7, 7) << 11) |
+                 (Bits(insn, 30, 25) << 5) | (Bits(insn, 11, 8) << 1);
+  return SignExtendBits(imm, 13u);
+}
+
+static inline int64_t ImmU(uint32_t insn) {
+  return static_cast<int32_t>(insn & UINT32_C(0xfffff000));
+}
+
+static inline int64_t ImmJ(uint32_t insn) {
+  uint32_t imm = (Bits(insn, 31, 31) << 20) | (Bits(insn, 19, 12) << 12) |
+                 (Bits(insn, 20, 20) << 11) | (Bits(insn, 30, 21) << 1);
+  return SignExtendBits(imm, 21u);
+}
+
+// The simulated code uses host addresses, so memory accesses go straight to the host memory.
+template <typename T>
+static inline T Load(uint64_t address) {
+  T value;
+  memcpy(&value, reinterpret_cast<const void*>(address), sizeof(T));
+  return value;
+}
+
+template <typename T>
+static inline void Store(uint64_t address, T value) {
+  memcpy(reinterpret_cast<void*>(address), &value, sizeof(T));
+}
+
+template <typename T>
+static inline T Div(T dividend, T divisor) {
+  static_assert(std::is_signed_v<T>);
+  if (divisor == 0) {
+    return static_cast<T>(-1);
+  }
+  if (dividend == std::numeric_limits<T>::min() && divisor == -1) {
+    return dividend;
+  }
+  return dividend / divisor;
+}
+
+template <typename T>
+static inline T Rem(T dividend, T divisor) {
+  static_assert(std::is_signed_v<T>);
+  if (divisor == 0) {
+    return dividend;
+  }
+  if (dividend == std::numeric_limits<T>::min() && divisor == -1) {
+    return 0;
+  }
+  return dividend % divisor;
+}
+
+template <typename T>
+static inline T DivU(T dividend, T divisor) {
+  static_assert(std::is_unsigned_v<T>);
+  return (divisor == 0u) ? std::numeric_limits<T>::max() : dividend / divisor;
+}
+
+template <typename T>
+static inline T RemU(T dividend, T divisor) {
+  static_assert(std::is_unsigned_v<T>);
+  return (divisor == 0u) ? dividend : dividend % divisor;
+}
+
+template <typename T>
+static inline T CanonicalizeNaN(T value) {
+  // The quiet NaN of the host is the RISC-V canonical NaN.
+  return std::isnan(value) ? std::numeric_limits<T>::quiet_NaN() : value;
+}
+
+// FMIN and FMAX return the non-NaN operand and order -0.0 before +0.0.
+template <typename T>
+static inline T FMin(T lhs, T rhs) {
+  if (std::isnan(lhs) || std::isnan(rhs)) {
+    return std::isnan(lhs) ? CanonicalizeNaN(rhs) : lhs;
+  }
+  if (lhs == rhs) {
+    return std::signbit(lhs) ? lhs : rhs;
+  }
+  return (lhs < rhs) ? lhs : rhs;
+}
+
+template <typename T>
+static inline T FMax(T lhs, T rhs) {
+  if (std::isnan(lhs) || std::isnan(rhs)) {
+    return std::isnan(lhs) ? CanonicalizeNaN(rhs) : lhs;
+  }
+  if (lhs == rhs) {
+    return std::signbit(lhs) ? rhs : lhs;
+  }
+  return (lhs > rhs) ? lhs : rhs;
+}
+
+template <typename T, typename U>
+static inline uint64_t FClass(U bits) {
+  T value = bit_cast<T>(bits);
+  bool negative = std::signbit(value);
+  switch (std::fpclassify(value)) {
+    case FP_INFINITE:
+      return negative ? (1u << 0) : (1u << 7);
+    case FP_NORMAL:
+      return negative ? (1u << 1) : (1u << 6);
+    case FP_SUBNORMAL:
+      return negative ? (1u << 2) : (1u << 5);
+    case FP_ZERO:
+      return negative ? (1u << 3) : (1u << 4);
+    default: {
+      constexpr U kQuietBit = static_cast<U>(1u) << (std::numeric_limits<T>::digits - 2);
+      return ((bits & kQuietBit) != 0u) ? (1u << 9) : (1u << 8);
+    }
+  }
+}
+
+static inline double RoundToIntegral(double value, uint32_t rm) {
+  switch (rm) {
+    case 0u:  // RNE, the host default rounding mode.
+      return std::nearbyint(value);
+    case 1u:  // RTZ
+      return std::trunc(value);
+    case 2u:  // RDN
+      return std::floor(value);
+    case 3u:  // RUP
+      return std::ceil(value);
+    default:  // RMM
+      DCHECK_EQ(rm, 4u);
+      return std::round(value);
+  }
+}
+
+// FCVT to an integer saturates out of range values and converts NaN to the maximum value.
+template <typename T>
+static inline T ConvertFpToInt(double value, uint32_t rm) {
+  if (std::isnan(value)) {
+    return std::numeric_limits<T>::max();
+  }
+  double rounded = RoundToIntegral(value, rm);
+  if (rounded >= static_cast<double>(std::numeric_limits<T>::max()) + 1.0) {
+    return std::numeric_limits<T>::max();
+  }
+  if (rounded < static_cast<double>(std::numeric_limits<T>::min())) {
+    return std::numeric_limits<T>::min();
+  }
+  return static_cast<T>(rounded);
+}
+
+// `type` is the `rs2` field of FCVT: W, WU, L or LU.
+static inline uint64_t ConvertFpToInt(double value, uint32_t type, uint32_t rm) {
+  switch (type) {
+    case 0u:
+      return SignExtend32(static_cast<uint32_t>(ConvertFpToInt<int32_t>(value, rm)));
+    case 1u:
+      return SignExtend32(ConvertFpToInt<uint32_t>(value, rm));
+    case 2u:
+      return static_cast<uint64_t>(ConvertFpToInt<int64_t>(value, rm));
+    default:
+      DCHECK_EQ(type, 3u);
+      return ConvertFpToInt<uint64_t>(value, rm);
+  }
+}
+
+template <typename T>
+static inline T ConvertIntToFp(uint64_t value, uint32_t type) {
+  switch (type) {
+    case 0u:
+      return static_cast<T>(static_cast<int32_t>(value));
+    case 1u:
+      return static_cast<T>(static_cast<uint32_t>(value));
+    case 2u:
+      return static_cast<T>(static_cast<int64_t>(value));
+    default:
+      DCHECK_EQ(type, 3u);
+      return static_cast<T>(value);
+  }
+}
+
+// Computes the value stored by an AMO instruction. Returns false for unknown operations.
+template <typename T>
+static inline bool ComputeAmo(uint32_t funct5, T old_value, T operand, /*out*/ T* new_value) {
+  using U = std::make_unsigned_t<T>;
+  switch (funct5) {
+    case 0x00u:  // AMOADD
+      *new_value = static_cast<T>(static_cast<U>(old_value) + static_cast<U>(operand));
+      return true;
+    case 0x01u:  // AMOSWAP
+      *new_value = operand;
+      return true;
+    case 0x04u:  // AMOXOR
+      *new_value = old_value ^ operand;
+      return true;
+    case 0x08u:  // AMOOR
+      *new_value = old_value | operand;
+      return true;
+    case 0x0cu:  // AMOAND
+      *new_value = old_value & operand;
+      return true;
+    case 0x10u:  // AMOMIN
+      *new_value = std::min(old_value, operand);
+      return true;
+    case 0x14u:  // AMOMAX
+      *new_value = std::max(old_value, operand);
+      return true;
+    case 0x18u:  // AMOMINU
+      *new_value = static_cast<T>(std::min(static_cast<U>(old_value), static_cast<U>(operand)));
+      return true;
+    case 0x1cu:  // AMOMAXU
+      *new_value = static_cast<T>(std::max(static_cast<U>(old_value), static_cast<U>(operand)));
+      return true;
+    default:
+      return false;
+  }
+}
+
+static inline uint32_t UnboxS(uint64_t value) {
+  // Values which are not properly NaN-boxed read as the canonical NaN.
+  return ((value & kNaNBox) == kNaNBox)
+      ? static_cast<uint32_t>(value)
+      : bit_cast<uint32_t>(std::numeric_limits<float>::quiet_NaN());
+}
+
+CodeSimulatorRiscv64* CodeSimulatorRiscv64::CreateCodeSimulatorRiscv64() {
+  if (kCanSimulate) {
+    return new CodeSimulatorRiscv64();
+  } else {
+    return nullptr;
+  }
+}
+
+CodeSimulatorRiscv64::CodeSimulatorRiscv64()
+    : CodeSimulator(),
+      xregs_(),
+      fregs_(),
+      frm_(0u),
+      pc_(0u),
+      next_pc_(0u),
+      reservation_(kNoReservation),
+      stack_(new uint8_t[kStackSize]),
+      cost_model_(),
+      instruction_count_(0u),
+      cycle_count_(0u) {
+  DCHECK(kCanSimulate);
+}
+
+CodeSimulatorRiscv64::~CodeSimulatorRiscv64() {
+  DCHECK(kCanSimulate);
+}
+
+void CodeSimulatorRiscv64::RunFrom(intptr_t code_buffer) {
+  DCHECK(kCanSimulate);
+  std::fill_n(xregs_, arraysize(xregs_), 0u);
+  std::fill_n(fregs_, arraysize(fregs_), 0u);
+  frm_ = 0u;
+  reservation_ = kNoReservation;
+  instruction_count_ = 0u;
+  cycle_count_ = 0u;
+  xregs_[kRa] = kEndOfSimulationPc;
+  xregs_[kSp] = RoundDown(reinterpret_cast<uint64_t>(stack_.get()) + kStackSize, kStackAlignment);
+
+  pc_ = static_cast<uint64_t>(code_buffer);
+  while (pc_ != kEndOfSimulationPc) {
+    uint16_t low_half = Load<uint16_t>(pc_);
+    if ((low_half & 3u) != 3u) {
+      next_pc_ = pc_ + 2u;
+      ExecuteCompressed(low_half);
+    } else {
+      uint32_t insn = low_half | (static_cast<uint32_t>(Load<uint16_t>(pc_ + 2u)) << 16);
+      next_pc_ = pc_ + 4u;
+      Execute(insn);
+    }
+    ++instruction_count_;
+    pc_ = next_pc_;
+  }
+  VLOG(simulator) << "Simulated " << instruction_count_ << " riscv64 instructions in an estimated "
+                  << cycle_count_ << " cycles";
+}
+
+bool CodeSimulatorRiscv64::GetCReturnBool() const {
+  DCHECK(kCanSimulate);
+  return static_cast<bool>(xregs_[kA0]);
+}
+
+int32_t CodeSimulatorRiscv64::GetCReturnInt32() const {
+  DCHECK(kCanSimulate);
+  return static_cast<int32_t>(xregs_[kA0]);
+}
+
+int64_t CodeSimulatorRiscv64::GetCReturnInt64() const {
+  DCHECK(kCanSimulate);
+  return static_cast<int64_t>(xregs_[kA0]);
+}
+
+void CodeSimulatorRiscv64::Unsupported(uint32_t insn) const {
+  LOG(FATAL) << "Unsupported riscv64 instruction 0x" << std::hex << insn << " at 0x" << pc_;
+  UNREACHABLE();
+}
+
+float CodeSimulatorRiscv64::GetFS(uint32_t reg) const {
+  return bit_cast<float>(UnboxS(fregs_[reg]));
+}
+
+double CodeSimulatorRiscv64::GetFD(uint32_t reg) const {
+  return bit_cast<double>(fregs_[reg]);
+}
+
+void CodeSimulatorRiscv64::SetFS(uint32_t reg, float value) {
+  fregs_[reg] = kNaNBox | bit_cast<uint32_t>(CanonicalizeNaN(value));
+}
+
+void CodeSimulatorRiscv64::SetFD(uint32_t reg, double value) {
+  fregs_[reg] = bit_cast<uint64_t>(CanonicalizeNaN(value));
+}
+
+void CodeSimulatorRiscv64::Branch(bool condition, int64_t offset) {
+  Charge(cost_model_.branch);
+  if (condition) {
+    Charge(cost_model_.taken_branch_penalty);
+    next_pc_ = pc_ + offset;
+  }
+}
+
+void CodeSimulatorRiscv64::Jump(uint64_t target) {
+  Charge(cost_model_.branch + cost_model_.taken_branch_penalty);
+  next_pc_ = target;
+}
+
+void CodeSimulatorRiscv64::Execute(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t funct3 = Bits(insn, 14, 12);
+  uint32_t rs1 = Bits(insn, 19, 15);
+  uint32_t rs2 = Bits(insn, 24, 20);
+  switch (Bits(insn, 6, 0)) {
+    case 0x37u:  // LUI
+      SetX(rd, ImmU(insn));
+      Charge(cost_model_.alu);
+      break;
+    case 0x17u:  // AUIPC
+      SetX(rd, pc_ + ImmU(insn));
+      Charge(cost_model_.alu);
+      break;
+    case 0x6fu: {  // JAL
+      uint64_t target = pc_ + ImmJ(insn);
+      SetX(rd, next_pc_);
+      Jump(target);
+      break;
+    }
+    case 0x67u: {  // JALR
+      if (funct3 != 0u) {
+        Unsupported(insn);
+      }
+      uint64_t target = (GetX(rs1) + ImmI(insn)) & ~UINT64_C(1);
+      SetX(rd, next_pc_);
+      Jump(target);
+      break;
+    }
+    case 0x63u: {  // BRANCH
+      uint64_t lhs = GetX(rs1);
+      uint64_t rhs = GetX(rs2);
+      bool condition;
+      switch (funct3) {
+        case 0u: condition = (lhs == rhs); break;
+        case 1u: condition = (lhs != rhs); break;
+        case 4u: condition = (static_cast<int64_t>(lhs) < static_cast<int64_t>(rhs)); break;
+        case 5u: condition = (static_cast<int64_t>(lhs) >= static_cast<int64_t>(rhs)); break;
+        case 6u: condition = (lhs < rhs); break;
+        case 7u: condition = (lhs >= rhs); break;
+        default: Unsupported(insn);
+      }
+      Branch(condition, ImmB(insn));
+      break;
+    }
+    case 0x03u: {  // LOAD
+      uint64_t address = GetX(rs1) + ImmI(insn);
+      uint64_t value;
+      switch (funct3) {
+        case 0u: value = static_cast<uint64_t>(static_cast<int64_t>(Load<int8_t>(address))); break;
+        case 1u: value = static_cast<uint64_t>(static_cast<int64_t>(Load<int16_t>(address))); break;
+        case 2u: value = SignExtend32(Load<uint32_t>(address)); break;
+        case 3u: value = Load<uint64_t>(address); break;
+        case 4u: value = Load<uint8_t>(address); break;
+        case 5u: value = Load<uint16_t>(address); break;
+        case 6u: value = Load<uint32_t>(address); break;
+        default: Unsupported(insn);
+      }
+      SetX(rd, value);
+      Charge(cost_model_.load);
+      break;
+    }
+    case 0x23u: {  // STORE
+      uint64_t address = GetX(rs1) + ImmS(insn);
+      uint64_t value = GetX(rs2);
+      switch (funct3) {
+        case 0u: Store<uint8_t>(address, static_cast<uint8_t>(value)); break;
+        case 1u: Store<uint16_t>(address, static_cast<uint16_t>(value)); break;
+        case 2u: Store<uint32_t>(address, static_cast<uint32_t>(value)); break;
+        case 3u: Store<uint64_t>(address, value); break;
+        default: Unsupported(insn);
+      }
+      Charge(cost_model_.store);
+      break;
+    }
+    case 0x13u:
+      ExecuteOpImm(insn);
+      break;
+    case 0x1bu:
+      ExecuteOpImm32(insn);
+      break;
+    case 0x33u:
+      ExecuteOp(insn);
+      break;
+    case 0x3bu:
+      ExecuteOp32(insn);
+      break;
+    case 0x0fu:  // FENCE and FENCE.I, there is nothing to order in the simulator.
+      if (funct3 > 1u) {
+        Unsupported(insn);
+      }
+      Charge(cost_model_.system);
+      break;
+    case 0x73u:
+      ExecuteSystem(insn);
+      break;
+    case 0x2fu:
+      ExecuteAmo(insn);
+      break;
+    case 0x07u: {  // LOAD-FP
+      uint64_t address = GetX(rs1) + ImmI(insn);
+      if (funct3 == 2u) {
+        fregs_[rd] = kNaNBox | Load<uint32_t>(address);
+      } else if (funct3 == 3u) {
+        fregs_[rd] = Load<uint64_t>(address);
+      } else {
+        Unsupported(insn);  // Vector loads.
+      }
+      Charge(cost_model_.load);
+      break;
+    }
+    case 0x27u: {  // STORE-FP
+      uint64_t address = GetX(rs1) + ImmS(insn);
+      if (funct3 == 2u) {
+        Store<uint32_t>(address, static_cast<uint32_t>(fregs_[rs2]));
+      } else if (funct3 == 3u) {
+        Store<uint64_t>(address, fregs_[rs2]);
+      } else {
+        Unsupported(insn);  // Vector stores.
+      }
+      Charge(cost_model_.store);
+      break;
+    }
+    case 0x43u:
+    case 0x47u:
+    case 0x4bu:
+    case 0x4fu:
+      ExecuteFma(insn);
+      break;
+    case 0x53u:
+      ExecuteOpFp(insn);
+      break;
+    default:
+      Unsupported(insn);
+  }
+}
+
+void CodeSimulatorRiscv64::ExecuteOpImm(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint64_t value = GetX(Bits(insn, 19, 15));
+  int64_t imm = ImmI(insn);
+  uint32_t shamt = Bits(insn, 25, 20);
+  uint32_t funct6 = Bits(insn, 31, 26);
+  uint64_t bit = UINT64_C(1) << shamt;
+  uint64_t result;
+  switch (Bits(insn, 14, 12)) {
+    case 0u: result = value + imm; break;                                            // ADDI
+    case 2u: result = (static_cast<int64_t>(value) < imm) ? 1u : 0u; break;          // SLTI
+    case 3u: result = (value < static_cast<uint64_t>(imm)) ? 1u : 0u; break;         // SLTIU
+    case 4u: result = value ^ imm; break;                                            // XORI
+    case 6u: result = value | imm; break;                                            // ORI
+    case 7u: result = value & imm; break;                                            // ANDI
+    case 1u:
+      if (funct6 == 0x00u) {
+        result = value << shamt;  // SLLI
+      } else if (funct6 == 0x0au) {
+        result = value | bit;  // BSETI
+      } else if (funct6 == 0x12u) {
+        result = value & ~bit;  // BCLRI
+      } else if (funct6 == 0x1au) {
+        result = value ^ bit;  // BINVI
+      } else if (funct6 == 0x18u) {
+        switch (shamt) {
+          case 0u: result = (value == 0u) ? 64u : CLZ(value); break;  // CLZ
+          case 1u: result = (value == 0u) ? 64u : CTZ(value); break;  // CTZ
+          case 2u: result = POPCOUNT(value); break;                   // CPOP
+          case 4u: result = static_cast<uint64_t>(SignExtendBits(value, 8u)); break;   // SEXT.B
+          case 5u: result = static_cast<uint64_t>(SignExtendBits(value, 16u)); break;  // SEXT.H
+          default: Unsupported(insn);
+        }
+      } else {
+        Unsupported(insn);
+      }
+      break;
+    case 5u:
+      if (Bits(insn, 31, 20) == 0x287u) {
+        // ORC.B
+        result = 0u;
+        for (uint32_t i = 0; i != 64u; i += 8u) {
+          if (((value >> i) & 0xffu) != 0u) {
+            result |= UINT64_C(0xff) << i;
+          }
+        }
+      } else if (Bits(insn, 31, 20) == 0x6b8u) {
+        result = __builtin_bswap64(value);  // REV8
+      } else if (funct6 == 0x00u) {
+        result = value >> shamt;  // SRLI
+      } else if (funct6 == 0x10u) {
+        result = static_cast<uint64_t>(static_cast<int64_t>(value) >> shamt);  // SRAI
+      } else if (funct6 == 0x12u) {
+        result = (value >> shamt) & 1u;  // BEXTI
+      } else if (funct6 == 0x18u) {
+        result = (value >> shamt) | (value << ((64u - shamt) & 63u));  // RORI
+      } else {
+        Unsupported(insn);
+      }
+      break;
+    default:
+      Unsupported(insn);
+  }
+  SetX(rd, result);
+  Charge(cost_model_.alu);
+}
+
+void CodeSimulatorRiscv64::ExecuteOpImm32(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint64_t value = GetX(Bits(insn, 19, 15));
+  uint32_t value32 = static_cast<uint32_t>(value);
+  uint32_t shamt = Bits(insn, 24, 20);
+  uint32_t funct7 = Bits(insn, 31, 25);
+  uint64_t result;
+  switch (Bits(insn, 14, 12)) {
+    case 0u:
+      result = SignExtend32(value + ImmI(insn));  // ADDIW
+      break;
+    case 1u:
+      if (funct7 == 0x00u) {
+        result = SignExtend32(value32 << shamt);  // SLLIW
+      } else if (Bits(insn, 31, 26) == 0x02u) {
+        result = static_cast<uint64_t>(value32) << Bits(insn, 25, 20);  // SLLI.UW
+      } else if (funct7 == 0x30u) {
+        switch (shamt) {
+          case 0u: result = (value32 == 0u) ? 32u : CLZ(value32); break;  // CLZW
+          case 1u: result = (value32 == 0u) ? 32u : CTZ(value32); break;  // CTZW
+          case 2u: result = POPCOUNT(value32); break;                     // CPOPW
+          default: Unsupported(insn);
+        }
+      } else {
+        Unsupported(insn);
+      }
+      break;
+    case 5u:
+      if (funct7 == 0x00u) {
+        result = SignExtend32(value32 >> shamt);  // SRLIW
+      } else if (funct7 == 0x20u) {
+        result = SignExtend32(static_cast<uint32_t>(static_cast<int32_t>(value32) >> shamt));
+      } else if (funct7 == 0x30u) {
+        result = SignExtend32((value32 >> shamt) | (value32 << ((32u - shamt) & 31u)));  // RORIW
+      } else {
+        Unsupported(insn);
+      }
+      break;
+    default:
+      Unsupported(insn);
+  }
+  SetX(rd, result);
+  Charge(cost_model_.alu);
+}
+
+void CodeSimulatorRiscv64::ExecuteOp(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t funct3 = Bits(insn, 14, 12);
+  uint64_t lhs = GetX(Bits(insn, 19, 15));
+  uint64_t rhs = GetX(Bits(insn, 24, 20));
+  int64_t slhs = static_cast<int64_t>(lhs);
+  int64_t srhs = static_cast<int64_t>(rhs);
+  uint32_t shamt = rhs & 63u;
+  uint32_t cost = cost_model_.alu;
+  uint64_t result;
+  switch ((Bits(insn, 31, 25) << 3) | funct3) {
+    case (0x00u << 3) | 0u: result = lhs + rhs; break;                     // ADD
+    case (0x00u << 3) | 1u: result = lhs << shamt; break;                  // SLL
+    case (0x00u << 3) | 2u: result = (slhs < srhs) ? 1u : 0u; break;       // SLT
+    case (0x00u << 3) | 3u: result = (lhs < rhs) ? 1u : 0u; break;         // SLTU
+    case (0x00u << 3) | 4u: result = lhs ^ rhs; break;                     // XOR
+    case (0x00u << 3) | 5u: result = lhs >> shamt; break;                  // SRL
+    case (0x00u << 3) | 6u: result = lhs | rhs; break;                     // OR
+    case (0x00u << 3) | 7u: result = lhs & rhs; break;                     // AND
+    case (0x20u << 3) | 0u: result = lhs - rhs; break;                     // SUB
+    case (0x20u << 3) | 4u: result = ~(lhs ^ rhs); break;                  // XNOR
+    case (0x20u << 3) | 5u: result = static_cast<uint64_t>(slhs >> shamt); break;  // SRA
+    case (0x20u << 3) | 6u: result = lhs | ~rhs; break;                    // ORN
+    case (0x20u << 3) | 7u: result = lhs & ~rhs; break;                    // ANDN
+    case (0x01u << 3) | 0u:                                                // MUL
+      result = lhs * rhs;
+      cost = cost_model_.mul;
+      break;
+    case (0x01u << 3) | 1u:                                                // MULH
+      result = static_cast<uint64_t>(
+          (static_cast<__int128>(slhs) * static_cast<__int128>(srhs)) >> 64);
+      cost = cost_model_.mul;
+      break;
+    case (0x01u << 3) | 2u:                                                // MULHSU
+      result = static_cast<uint64_t>(
+          (static_cast<__int128>(slhs) * static_cast<__int128>(rhs)) >> 64);
+      cost = cost_model_.mul;
+      break;
+    case (0x01u << 3) | 3u:                                                // MULHU
+      result = static_cast<uint64_t>(
+          (static_cast<unsigned __int128>(lhs) * static_cast<unsigned __int128>(rhs)) >> 64);
+      cost = cost_model_.mul;
+      break;
+    case (0x01u << 3) | 4u:                                                // DIV
+      result = static_cast<uint64_t>(Div(slhs, srhs));
+      cost = cost_model_.div;
+      break;
+    case (0x01u << 3) | 5u:                                                // DIVU
+      result = DivU(lhs, rhs);
+      cost = cost_model_.div;
+      break;
+    case (0x01u << 3) | 6u:                                                // REM
+      result = static_cast<uint64_t>(Rem(slhs, srhs));
+      cost = cost_model_.div;
+      break;
+    case (0x01u << 3) | 7u:                                                // REMU
+      result = RemU(lhs, rhs);
+      cost = cost_model_.div;
+      break;
+    case (0x10u << 3) | 2u: result = (lhs << 1) + rhs; break;              // SH1ADD
+    case (0x10u << 3) | 4u: result = (lhs << 2) + rhs; break;              // SH2ADD
+    case (0x10u << 3) | 6u: result = (lhs << 3) + rhs; break;              // SH3ADD
+    case (0x05u << 3) | 4u: result = static_cast<uint64_t>(std::min(slhs, srhs)); break;  // MIN
+    case (0x05u << 3) | 5u: result = std::min(lhs, rhs); break;            // MINU
+    case (0x05u << 3) | 6u: result = static_cast<uint64_t>(std::max(slhs, srhs)); break;  // MAX
+    case (0x05u << 3) | 7u: result = std::max(lhs, rhs); break;            // MAXU
+    case (0x30u << 3) | 1u:                                                // ROL
+      result = (lhs << shamt) | (lhs >> ((64u - shamt) & 63u));
+      break;
+    case (0x30u << 3) | 5u:                                                // ROR
+      result = (lhs >> shamt) | (lhs << ((64u - shamt) & 63u));
+      break;
+    case (0x24u << 3) | 1u: result = lhs & ~(UINT64_C(1) << shamt); break;  // BCLR
+    case (0x24u << 3) | 5u: result = (lhs >> shamt) & 1u; break;            // BEXT
+    case (0x34u << 3) | 1u: result = lhs ^ (UINT64_C(1) << shamt); break;  // BINV
+    case (0x14u << 3) | 1u: result = lhs | (UINT64_C(1) << shamt); break;  // BSET
+    default:
+      Unsupported(insn);
+  }
+  SetX(rd, result);
+  Charge(cost);
+}
+
+void CodeSimulatorRiscv64::ExecuteOp32(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t funct3 = Bits(insn, 14, 12);
+  uint64_t lhs = GetX(Bits(insn, 19, 15));
+  uint64_t rhs = GetX(Bits(insn, 24, 20));
+  uint32_t lhs32 = static_cast<uint32_t>(lhs);
+  uint32_t rhs32 = static_cast<uint32_t>(rhs);
+  int32_t slhs32 = static_cast<int32_t>(lhs32);
+  int32_t srhs32 = static_cast<int32_t>(rhs32);
+  uint32_t shamt = rhs32 & 31u;
+  uint32_t cost = cost_model_.alu;
+  uint64_t result;
+  switch ((Bits(insn, 31, 25) << 3) | funct3) {
+    case (0x00u << 3) | 0u: result = SignExtend32(lhs32 + rhs32); break;     // ADDW
+    case (0x00u << 3) | 1u: result = SignExtend32(lhs32 << shamt); break;    // SLLW
+    case (0x00u << 3) | 5u: result = SignExtend32(lhs32 >> shamt); break;    // SRLW
+    case (0x20u << 3) | 0u: result = SignExtend32(lhs32 - rhs32); break;     // SUBW
+    case (0x20u << 3) | 5u:                                                 // SRAW
+      result = SignExtend32(static_cast<uint32_t>(slhs32 >> shamt));
+      break;
+    case (0x01u << 3) | 0u:                                                 // MULW
+      result = SignExtend32(lhs32 * rhs32);
+      cost = cost_model_.mul;
+      break;
+    case (0x01u << 3) | 4u:                                                 // DIVW
+      result = SignExtend32(static_cast<uint32_t>(Div(slhs32, srhs32)));
+      cost = cost_model_.div;
+      break;
+    case (0x01u << 3) | 5u:                                                 // DIVUW
+      result = SignExtend32(DivU(lhs32, rhs32));
+      cost = cost_model_.div;
+      break;
+    case (0x01u << 3) | 6u:                                                 // REMW
+      result = SignExtend32(static_cast<uint32_t>(Rem(slhs32, srhs32)));
+      cost = cost_model_.div;
+      break;
+    case (0x01u << 3) | 7u:                                                 // REMUW
+      result = SignExtend32(RemU(lhs32, rhs32));
+      cost = cost_model_.div;
+      break;
+    case (0x04u << 3) | 0u: result = static_cast<uint64_t>(lhs32) + rhs; break;  // ADD.UW
+    case (0x04u << 3) | 4u:                                                 // ZEXT.H
+      if (Bits(insn, 24, 20) != 0u) {
+        Unsupported(insn);
+      }
+      result = lhs & 0xffffu;
+      break;
+    case (0x10u << 3) | 2u: result = (static_cast<uint64_t>(lhs32) << 1) + rhs; break;  // SH1ADD.UW
+    case (0x10u << 3) | 4u: result = (static_cast<uint64_t>(lhs32) << 2) + rhs; break;  // SH2ADD.UW
+    case (0x10u << 3) | 6u: result = (static_cast<uint64_t>(lhs32) << 3) + rhs; break;  // SH3ADD.UW
+    case (0x30u << 3) | 1u:                                                 // ROLW
+      result = SignExtend32((lhs32 << shamt) | (lhs32 >> ((32u - shamt) & 31u)));
+      break;
+    case (0x30u << 3) | 5u:                                                 // RORW
+      result = SignExtend32((lhs32 >> shamt) | (lhs32 << ((32u - shamt) & 31u)));
+      break;
+    default:
+      Unsupported(insn);
+  }
+  SetX(rd, result);
+  Charge(cost);
+}
+
+void CodeSimulatorRiscv64::ExecuteAmo(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t funct3 = Bits(insn, 14, 12);
+  uint32_t funct5 = Bits(insn, 31, 27);
+  uint64_t address = GetX(Bits(insn, 19, 15));
+  uint64_t operand = GetX(Bits(insn, 24, 20));
+  if (funct3 != 2u && funct3 != 3u) {
+    Unsupported(insn);
+  }
+  bool is_word = (funct3 == 2u);
+  // The simulator is single-threaded, so the aq and rl bits can be ignored.
+  uint64_t old_value =
+      is_word ? SignExtend32(Load<uint32_t>(address)) : Load<uint64_t>(address);
+  if (funct5 == 0x02u) {  // LR
+    reservation_ = address;
+    SetX(rd, old_value);
+  } else if (funct5 == 0x03u) {  // SC
+    bool success = (reservation_ == address);
+    if (success) {
+      if (is_word) {
+        Store<uint32_t>(address, static_cast<uint32_t>(operand));
+      } else {
+        Store<uint64_t>(address, operand);
+      }
+    }
+    reservation_ = kNoReservation;
+    SetX(rd, success ? 0u : 1u);
+  } else if (is_word) {
+    int32_t new_value;
+    if (!ComputeAmo(funct5,
+                    static_cast<int32_t>(old_value),
+                    static_cast<int32_t>(operand),
+                    &new_value)) {
+      Unsupported(insn);
+    }
+    Store<int32_t>(address, new_value);
+    SetX(rd, old_value);
+  } else {
+    int64_t new_value;
+    if (!ComputeAmo(funct5,
+                    static_cast<int64_t>(old_value),
+                    static_cast<int64_t>(operand),
+                    &new_value)) {
+      Unsupported(insn);
+    }
+    Store<int64_t>(address, new_value);
+    SetX(rd, old_value);
+  }
+  Charge(cost_model_.atomic);
+}
+
+void CodeSimulatorRiscv64::ExecuteSystem(uint32_t insn) {
+  static constexpr uint32_t kCsrFflags = 0x001u;
+  static constexpr uint32_t kCsrFrm = 0x002u;
+  static constexpr uint32_t kCsrFcsr = 0x003u;
+
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t funct3 = Bits(insn, 14, 12);
+  uint32_t rs1 = Bits(insn, 19, 15);
+  uint32_t csr = Bits(insn, 31, 20);
+  if (funct3 == 0u || funct3 == 4u) {
+    Unsupported(insn);  // ECALL, EBREAK and privileged instructions.
+  }
+  // Floating point exception flags are not tracked and always read as zero.
+  uint64_t old_value;
+  switch (csr) {
+    case kCsrFflags: old_value = 0u; break;
+    case kCsrFrm: old_value = frm_; break;
+    case kCsrFcsr: old_value = frm_ << 5; break;
+    default: Unsupported(insn);  // Including UNIMP which writes the read-only `cycle` CSR.
+  }
+  uint64_t operand = ((funct3 & 4u) != 0u) ? rs1 : GetX(rs1);
+  uint64_t new_value;
+  switch (funct3 & 3u) {
+    case 1u: new_value = operand; break;                // CSRRW(I)
+    case 2u: new_value = old_value | operand; break;    // CSRRS(I)
+    default: new_value = old_value & ~operand; break;   // CSRRC(I)
+  }
+  if ((funct3 & 3u) == 1u || rs1 != 0u) {
+    if (csr == kCsrFrm) {
+      frm_ = new_value & 7u;
+    } else if (csr == kCsrFcsr) {
+      frm_ = (new_value >> 5) & 7u;
+    }
+  }
+  SetX(rd, old_value);
+  Charge(cost_model_.system);
+}
+
+void CodeSimulatorRiscv64::ExecuteFma(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t rs1 = Bits(insn, 19, 15);
+  uint32_t rs2 = Bits(insn, 24, 20);
+  uint32_t rs3 = Bits(insn, 31, 27);
+  uint32_t opcode = Bits(insn, 6, 0);
+  // FMADD: rs1 * rs2 + rs3, FMSUB: rs1 * rs2 - rs3,
+  // FNMSUB: -(rs1 * rs2) + rs3, FNMADD: -(rs1 * rs2) - rs3.
+  bool negate_product = (opcode == 0x4bu || opcode == 0x4fu);
+  bool negate_addend = (opcode == 0x47u || opcode == 0x4fu);
+  switch (Bits(insn, 26, 25)) {
+    case 0u: {
+      float lhs = negate_product ? -GetFS(rs1) : GetFS(rs1);
+      float addend = negate_addend ? -GetFS(rs3) : GetFS(rs3);
+      SetFS(rd, std::fma(lhs, GetFS(rs2), addend));
+      break;
+    }
+    case 1u: {
+      double lhs = negate_product ? -GetFD(rs1) : GetFD(rs1);
+      double addend = negate_addend ? -GetFD(rs3) : GetFD(rs3);
+      SetFD(rd, std::fma(lhs, GetFD(rs2), addend));
+      break;
+    }
+    default:
+      Unsupported(insn);
+  }
+  Charge(cost_model_.fp);
+}
+
+void CodeSimulatorRiscv64::ExecuteOpFp(uint32_t insn) {
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t funct3 = Bits(insn, 14, 12);
+  uint32_t rs1 = Bits(insn, 19, 15);
+  uint32_t rs2 = Bits(insn, 24, 20);
+  uint32_t cost = cost_model_.fp;
+  switch (Bits(insn, 31, 25)) {
+    case 0x00u: SetFS(rd, GetFS(rs1) + GetFS(rs2)); break;  // FADD.S
+    case 0x01u: SetFD(rd, GetFD(rs1) + GetFD(rs2)); break;  // FADD.D
+    case 0x04u: SetFS(rd, GetFS(rs1) - GetFS(rs2)); break;  // FSUB.S
+    case 0x05u: SetFD(rd, GetFD(rs1) - GetFD(rs2)); break;  // FSUB.D
+    case 0x08u: SetFS(rd, GetFS(rs1) * GetFS(rs2)); break;  // FMUL.S
+    case 0x09u: SetFD(rd, GetFD(rs1) * GetFD(rs2)); break;  // FMUL.D
+    case 0x0cu:                                             // FDIV.S
+      SetFS(rd, GetFS(rs1) / GetFS(rs2));
+      cost = cost_model_.fp_div;
+      break;
+    case 0x0du:                                             // FDIV.D
+      SetFD(rd, GetFD(rs1) / GetFD(rs2));
+      cost = cost_model_.fp_div;
+      break;
+    case 0x2cu:                                             // FSQRT.S
+      SetFS(rd, std::sqrt(GetFS(rs1)));
+      cost = cost_model_.fp_div;
+      break;
+    case 0x2du:                                             // FSQRT.D
+      SetFD(rd, std::sqrt(GetFD(rs1)));
+      cost = cost_model_.fp_div;
+      break;
+    case 0x10u: {                                           // FSGNJ(N/X).S
+      uint32_t lhs = UnboxS(fregs_[rs1]);
+      uint32_t rhs = UnboxS(fregs_[rs2]);
+      uint32_t result;
+      switch (funct3) {
+        case 0u: result = (lhs & ~kSignBitS) | (rhs & kSignBitS); break;
+        case 1u: result = (lhs & ~kSignBitS) | (~rhs & kSignBitS); break;
+        case 2u: result = lhs ^ (rhs & kSignBitS); break;
+        default: Unsupported(insn);
+      }
+      fregs_[rd] = kNaNBox | result;
+      break;
+    }
+    case 0x11u: {                                           // FSGNJ(N/X).D
+      uint64_t lhs = fregs_[rs1];
+      uint64_t rhs = fregs_[rs2];
+      switch (funct3) {
+        case 0u: fregs_[rd] = (lhs & ~kSignBitD) | (rhs & kSignBitD); break;
+        case 1u: fregs_[rd] = (lhs & ~kSignBitD) | (~rhs & kSignBitD); break;
+        case 2u: fregs_[rd] = lhs ^ (rhs & kSignBitD); break;
+        default: Unsupported(insn);
+      }
+      break;
+    }
+    case 0x14u:                                             // FMIN.S, FMAX.S
+      if (funct3 > 1u) {
+        Unsupported(insn);
+      }
+      SetFS(rd, (funct3 == 0u) ? FMin(GetFS(rs1), GetFS(rs2)) : FMax(GetFS(rs1), GetFS(rs2)));
+      break;
+    case 0x15u:                                             // FMIN.D, FMAX.D
+      if (funct3 > 1u) {
+        Unsupported(insn);
+      }
+      SetFD(rd, (funct3 == 0u) ? FMin(GetFD(rs1), GetFD(rs2)) : FMax(GetFD(rs1), GetFD(rs2)));
+      break;
+    case 0x20u:                                             // FCVT.S.D
+      if (rs2 != 1u) {
+        Unsupported(insn);
+      }
+      SetFS(rd, static_cast<float>(GetFD(rs1)));
+      break;
+    case 0x21u:                                             // FCVT.D.S
+      if (rs2 != 0u) {
+        Unsupported(insn);
+      }
+      SetFD(rd, static_cast<double>(GetFS(rs1)));
+      break;
+    case 0x50u:                                             // FLE.S, FLT.S, FEQ.S
+    case 0x51u: {                                           // FLE.D, FLT.D, FEQ.D
+      bool is_double = (Bits(insn, 25, 25) != 0u);
+      double lhs = is_double ? GetFD(rs1) : static_cast<double>(GetFS(rs1));
+      double rhs = is_double ? GetFD(rs2) : static_cast<double>(GetFS(rs2));
+      bool result;
+      switch (funct3) {
+        case 0u: result = (lhs <= rhs); break;
+        case 1u: result = (lhs < rhs); break;
+        case 2u: result = (lhs == rhs); break;
+        default: Unsupported(insn);
+      }
+      SetX(rd, result ? 1u : 0u);
+      break;
+    }
+    case 0x60u:                                             // FCVT.{W,WU,L,LU}.S
+    case 0x61u: {                                           // FCVT.{W,WU,L,LU}.D
+      uint32_t rm = (funct3 == 7u) ? frm_ : funct3;
+      if (rs2 > 3u || rm > 4u) {
+        Unsupported(insn);
+      }
+      double value = (Bits(insn, 25, 25) != 0u) ? GetFD(rs1) : static_cast<double>(GetFS(rs1));
+      SetX(rd, ConvertFpToInt(value, rs2, rm));
+      break;
+    }
+    case 0x68u:                                             // FCVT.S.{W,WU,L,LU}
+      if (rs2 > 3u) {
+        Unsupported(insn);
+      }
+      SetFS(rd, ConvertIntToFp<float>(GetX(rs1), rs2));
+      break;
+    case 0x69u:                                             // FCVT.D.{W,WU,L,LU}
+      if (rs2 > 3u) {
+        Unsupported(insn);
+      }
+      SetFD(rd, ConvertIntToFp<double>(GetX(rs1), rs2));
+      break;
+    case 0x70u:                                             // FMV.X.W, FCLASS.S
+      if (funct3 == 0u) {
+        SetX(rd, SignExtend32(fregs_[rs1]));
+      } else if (funct3 == 1u) {
+        SetX(rd, FClass<float>(UnboxS(fregs_[rs1])));
+      } else {
+        Unsupported(insn);
+      }
+      break;
+    case 0x71u:                                             // FMV.X.D, FCLASS.D
+      if (funct3 == 0u) {
+        SetX(rd, fregs_[rs1]);
+      } else if (funct3 == 1u) {
+        SetX(rd, FClass<double>(fregs_[rs1]));
+      } else {
+        Unsupported(insn);
+      }
+      break;
+    case 0x78u:                                             // FMV.W.X
+      fregs_[rd] = kNaNBox | static_cast<uint32_t>(GetX(rs1));
+      break;
+    case 0x79u:                                             // FMV.D.X
+      fregs_[rd] = GetX(rs1);
+      break;
+    default:
+      Unsupported(insn);
+  }
+  Charge(cost);
+}
+
+void CodeSimulatorRiscv64::ExecuteCompressed(uint16_t insn16) {
+  uint32_t insn = insn16;
+  // Full register fields and the x8-x15 register fields of the compact formats.
+  uint32_t rd = Bits(insn, 11, 7);
+  uint32_t rs2 = Bits(insn, 6, 2);
+  uint32_t rs1_c = Bits(insn, 9, 7) + 8u;
+  uint32_t rs2_c = Bits(insn, 4, 2) + 8u;
+  // The 6-bit immediate of the CI and CB formats.
+  uint32_t uimm6 = (Bits(insn, 12, 12) << 5) | Bits(insn, 6, 2);
+  int64_t imm6 = SignExtendBits(uimm6, 6u);
+  // Offsets scaled by 4 and 8 used by the CL, CS, CSS and CI stack formats.
+  uint32_t offset_w = (Bits(insn, 12, 10) << 3) | (Bits(insn, 6, 6) << 2) | (Bits(insn, 5, 5) << 6);
+  uint32_t offset_d = (Bits(insn, 12, 10) << 3) | (Bits(insn, 6, 5) << 6);
+  uint32_t sp_load_offset_w =
+      (Bits(insn, 12, 12) << 5) | (Bits(insn, 6, 4) << 2) | (Bits(insn, 3, 2) << 6);
+  uint32_t sp_load_offset_d =
+      (Bits(insn, 12, 12) << 5) | (Bits(insn, 6, 5) << 3) | (Bits(insn, 4, 2) << 6);
+  uint32_t sp_store_offset_w = (Bits(insn, 12, 9) << 2) | (Bits(insn, 8, 7) << 6);
+  uint32_t sp_store_offset_d = (Bits(insn, 12, 10) << 3) | (Bits(insn, 9, 7) << 6);
+  uint64_t sp = GetX(kSp);
+
+  // Switch on the quadrant and funct3.
+  switch ((Bits(insn, 1, 0) << 3) | Bits(insn, 15, 13)) {
+    case (0u << 3) | 0u: {  // C.ADDI4SPN
+      if (insn == 0u) {
+        Unsupported(insn);  // Defined illegal instruction.
+      }
+      uint32_t imm = (Bits(insn, 12, 11) << 4) | (Bits(insn, 10, 7) << 6) |
+                     (Bits(insn, 6, 6) << 2) | (Bits(insn, 5, 5) << 3);
+      SetX(rs2_c, sp + imm);
+      Charge(cost_model_.alu);
+      break;
+    }
+    case (0u << 3) | 1u:  // C.FLD
+      fregs_[rs2_c] = Load<uint64_t>(GetX(rs1_c) + offset_d);
+      Charge(cost_model_.load);
+      break;
+    case (0u << 3) | 2u:  // C.LW
+      SetX(rs2_c, SignExtend32(Load<uint32_t>(GetX(rs1_c) + offset_w)));
+      Charge(cost_model_.load);
+      break;
+    case (0u << 3) | 3u:  // C.LD
+      SetX(rs2_c, Load<uint64_t>(GetX(rs1_c) + offset_d));
+      Charge(cost_model_.load);
+      break;
+    case (0u << 3) | 5u:  // C.FSD
+      Store<uint64_t>(GetX(rs1_c) + offset_d, fregs_[rs2_c]);
+      Charge(cost_model_.store);
+      break;
+    case (0u << 3) | 6u:  // C.SW
+      Store<uint32_t>(GetX(rs1_c) + offset_w, static_cast<uint32_t>(GetX(rs2_c)));
+      Charge(cost_model_.store);
+      break;
+    case (0u << 3) | 7u:  // C.SD
+      Store<uint64_t>(GetX(rs1_c) + offset_d, GetX(rs2_c));
+      Charge(cost_model_.store);
+      break;
+    case (1u << 3) | 0u:  // C.ADDI, C.NOP
+      SetX(rd, GetX(rd) + imm6);
+      Charge(cost_model_.alu);
+      break;
+    case (1u << 3) | 1u:  // C.ADDIW
+      if (rd == 0u) {
+        Unsupported(insn);
+      }
+      SetX(rd, SignExtend32(GetX(rd) + imm6));
+      Charge(cost_model_.alu);
+      break;
+    case (1u << 3) | 2u:  // C.LI
+      SetX(rd, imm6);
+      Charge(cost_model_.alu);
+      break;
+    case (1u << 3) | 3u:
+      if (rd == kSp) {
+        // C.ADDI16SP
+        uint32_t imm = (Bits(insn, 12, 12) << 9) | (Bits(insn, 6, 6) << 4) |
+                       (Bits(insn, 5, 5) << 6) | (Bits(insn, 4, 3) << 7) | (Bits(insn, 2, 2) << 5);
+        SetX(kSp, sp + SignExtendBits(imm, 10u));
+      } else {
+        SetX(rd, static_cast<uint64_t>(imm6) << 12);  // C.LUI
+      }
+      Charge(cost_model_.alu);
+      break;
+    case (1u << 3) | 4u: {
+      uint64_t lhs = GetX(rs1_c);
+      uint64_t rhs = GetX(rs2_c);
+      uint64_t result;
+      switch (Bits(insn, 11, 10)) {
+        case 0u:  // C.SRLI
+          result = lhs >> uimm6;
+          break;
+        case 1u:  // C.SRAI
+          result = static_cast<uint64_t>(static_cast<int64_t>(lhs) >> uimm6);
+          break;
+        case 2u:  // C.ANDI
+          result = lhs & imm6;
+          break;
+        default:
+          switch ((Bits(insn, 12, 12) << 2) | Bits(insn, 6, 5)) {
+            case 0u: result = lhs - rhs; break;                // C.SUB
+            case 1u: result = lhs ^ rhs; break;                // C.XOR
+            case 2u: result = lhs | rhs; break;                // C.OR
+            case 3u: result = lhs & rhs; break;                // C.AND
+            case 4u: result = SignExtend32(lhs - rhs); break;  // C.SUBW
+            case 5u: result = SignExtend32(lhs + rhs); break;  // C.ADDW
+            default: Unsupported(insn);
+          }
+          break;
+      }
+      SetX(rs1_c, result);
+      Charge(cost_model_.alu);
+      break;
+    }
+    case (1u << 3) | 5u: {  // C.J
+      uint32_t offset = (Bits(insn, 12, 12) << 11) | (Bits(insn, 11, 11) << 4) |
+                        (Bits(insn, 10, 9) << 8) | (Bits(insn, 8, 8) << 10) |
+                        (Bits(insn, 7, 7) << 6) | (Bits(insn, 6, 6) << 7) |
+                        (Bits(insn, 5, 3) << 1) | (Bits(insn, 2, 2) << 5);
+      Jump(pc_ + SignExtendBits(offset, 12u));
+      break;
+    }
+    case (1u << 3) | 6u:    // C.BEQZ
+    case (1u << 3) | 7u: {  // C.BNEZ
+      uint32_t offset = (Bits(insn, 12, 12) << 8) | (Bits(insn, 11, 10) << 3) |
+                        (Bits(insn, 6, 5) << 6) | (Bits(insn, 4, 3) << 1) | (Bits(insn, 2, 2) << 5);
+      bool is_zero = (GetX(rs1_c) == 0u);
+      Branch((Bits(insn, 13, 13) == 0u) ? is_zero : !is_zero, SignExtendBits(offset, 9u));
+      break;
+    }
+    case (2u << 3) | 0u:  // C.SLLI
+      SetX(rd, GetX(rd) << uimm6);
+      Charge(cost_model_.alu);
+      break;
+    case (2u << 3) | 1u:  // C.FLDSP
+      fregs_[rd] = Load<uint64_t>(sp + sp_load_offset_d);
+      Charge(cost_model_.load);
+      break;
+    case (2u << 3) | 2u:  // C.LWSP
+      SetX(rd, SignExtend32(Load<uint32_t>(sp + sp_load_offset_w)));
+      Charge(cost_model_.load);
+      break;
+    case (2u << 3) | 3u:  // C.LDSP
+      SetX(rd, Load<uint64_t>(sp + sp_load_offset_d));
+      Charge(cost_model_.load);
+      break;
+    case (2u << 3) | 4u:
+      if (rs2 != 0u) {
+        // C.MV, C.ADD
+        SetX(rd, (Bits(insn, 12, 12) == 0u) ? GetX(rs2) : GetX(rd) + GetX(rs2));
+        Charge(cost_model_.alu);
+      } else if (rd == 0u) {
+        Unsupported(insn);  // C.EBREAK
+      } else {
+        // C.JR, C.JALR
+        uint64_t target = GetX(rd) & ~UINT64_C(1);
+        if (Bits(insn, 12, 12) != 0u) {
+          SetX(kRa, next_pc_);
+        }
+        Jump(target);
+      }
+      break;
+    case (2u << 3) | 5u:  // C.FSDSP
+      Store<uint64_t>(sp + sp_store_offset_d, fregs_[rs2]);
+      Charge(cost_model_.store);
+      break;
+    case (2u << 3) | 6u:  // C.SWSP
+      Store<uint32_t>(sp + sp_store_offset_w, static_cast<uint32_t>(GetX(rs2)));
+      Charge(cost_model_.store);
+      break;
+    case (2u << 3) | 7u:  // C.SDSP
+      Store<uint64_t>(sp + sp_store_offset_d, GetX(rs2));
+      Charge(cost_model_.store);
+      break;
+    default:
+      Unsupported(insn);
+  }
+}
+
+}  // namespace riscv64
+}  // namespace art
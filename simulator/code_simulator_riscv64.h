@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_SIMULATOR_CODE_SIMULATOR_RISCV64_H_
+#define ART_SIMULATOR_CODE_SIMULATOR_RISCV64_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "arch/instruction_set.h"
+#include "code_simulator.h"
+
+namespace art {
+namespace riscv64 {
+
+// A simple interpreter for the RV64GC code emitted by the optimizing compiler, together with the
+// Zba, Zbb and Zbs extensions. Vector instructions are not supported.
+//
+// The generated code accesses the host memory directly, so the simulator is only available on
+// 64-bit hosts. Each executed instruction is charged a number of cycles from a `CostModel`, which
+// gives an approximate cycle count for the simulated code.
+class CodeSimulatorRiscv64 : public CodeSimulator {
+ public:
+  // Approximate number of cycles charged for each class of instructions.
+  struct CostModel {
+    uint32_t alu = 1u;
+    uint32_t mul = 3u;
+    uint32_t div = 20u;
+    uint32_t load = 3u;
+    uint32_t store = 1u;
+    uint32_t branch = 1u;
+    // Additional cycles for taken branches and jumps.
+    uint32_t taken_branch_penalty = 2u;
+    uint32_t fp = 4u;
+    uint32_t fp_div = 20u;
+    uint32_t atomic = 10u;
+    // Fences and CSR accesses.
+    uint32_t system = 5u;
+  };
+
+  static CodeSimulatorRiscv64* CreateCodeSimulatorRiscv64();
+  virtual ~CodeSimulatorRiscv64();
+
+  void RunFrom(intptr_t code_buffer) override;
+
+  bool GetCReturnBool() const override;
+  int32_t GetCReturnInt32() const override;
+  int64_t GetCReturnInt64() const override;
+
+  void SetCostModel(const CostModel& cost_model) {
+    cost_model_ = cost_model;
+  }
+
+  // Number of instructions executed by the last `RunFrom()`.
+  uint64_t GetInstructionCount() const {
+    return instruction_count_;
+  }
+
+  // Number of cycles estimated by the cost model for the last `RunFrom()`.
+  uint64_t GetCycleCount() const {
+    return cycle_count_;
+  }
+
+ private:
+  CodeSimulatorRiscv64();
+
+  void Execute(uint32_t insn);
+  void ExecuteCompressed(uint16_t insn);
+
+  void ExecuteOpImm(uint32_t insn);
+  void ExecuteOpImm32(uint32_t insn);
+  void ExecuteOp(uint32_t insn);
+  void ExecuteOp32(uint32_t insn);
+  void ExecuteAmo(uint32_t insn);
+  void ExecuteSystem(uint32_t insn);
+  void ExecuteFma(uint32_t insn);
+  void ExecuteOpFp(uint32_t insn);
+
+  NO_RETURN void Unsupported(uint32_t insn) const;
+
+  uint64_t GetX(uint32_t reg) const {
+    return xregs_[reg];
+  }
+
+  void SetX(uint32_t reg, uint64_t value) {
+    if (reg != 0u) {
+      xregs_[reg] = value;
+    }
+  }
+
+  float GetFS(uint32_t reg) const;
+  double GetFD(uint32_t reg) const;
+  void SetFS(uint32_t reg, float value);
+  void SetFD(uint32_t reg, double value);
+
+  void Branch(bool condition, int64_t offset);
+  void Jump(uint64_t target);
+
+  void Charge(uint32_t cycles) {
+    cycle_count_ += cycles;
+  }
+
+  uint64_t xregs_[32];
+  // Single precision values are NaN-boxed in the upper 32 bits.
+  uint64_t fregs_[32];
+  uint32_t frm_;
+  uint64_t pc_;
+  uint64_t next_pc_;
+
+  // Address reserved by the last LR instruction, or `kNoReservation`.
+  uint64_t reservation_;
+
+  std::unique_ptr<uint8_t[]> stack_;
+
+  CostModel cost_model_;
+  uint64_t instruction_count_;
+  uint64_t cycle_count_;
+
+  static constexpr bool kCanSimulate = (kRuntimeISA == InstructionSet::kX86_64);
+
+  DISALLOW_COPY_AND_ASSIGN(CodeSimulatorRiscv64);
+};
+
+}  // namespace riscv64
+}  // namespace art
+
+#endif  // ART_SIMULATOR_CODE_SIMULATOR_RISCV64_H_
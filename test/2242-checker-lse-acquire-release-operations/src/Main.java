@@ -81,6 +81,9 @@ public class Main {
             $noinline$testMonitorOperationSetAndMergeValuesBlocking(new TestClass(), true), 1);
     assertEquals(
             $noinline$testMonitorOperationSetAndMergeValuesBlocking(new TestClass(), false), 2);
+
+    // Monitor Operations - Thread-local lock.
+    assertEquals($noinline$testMonitorOperationThreadLocalNotBlocking(new TestClass()), 2);
   }
 
   public static void assertEquals(int expected, int result) {
@@ -483,14 +486,13 @@ public class Main {
 
   // Unrelated monitor operations shouldn't block LSE.
   static int $noinline$testMonitorOperationDifferentFields(TestClass obj1, TestClass obj2) {
-    Main m = new Main();
-    synchronized (m) {}
+    synchronized (sLock) {}
 
     obj1.i = 1;
     obj2.j = 2;
     int result = obj1.i + obj2.j;
 
-    synchronized (m) {}
+    synchronized (sLock) {}
 
     return result;
   }
@@ -513,11 +515,9 @@ public class Main {
 
   // A synchronized operation blocks loads.
   static int $noinline$testMonitorOperationDifferentFieldsBlocking(TestClass obj1, TestClass obj2) {
-    Main m = new Main();
-
     obj1.i = 1;
     obj2.j = 2;
-    synchronized (m) {
+    synchronized (sLock) {
       return obj1.i + obj2.j;
     }
   }
@@ -539,8 +539,7 @@ public class Main {
   /// CHECK-NOT: InstanceFieldGet
 
   static int $noinline$testMonitorOperationRedundantStore(TestClass obj) {
-    Main m = new Main();
-    synchronized (m) {
+    synchronized (sLock) {
       obj.j = 1;
       obj.j = 2;
     }
@@ -565,11 +564,9 @@ public class Main {
   /// CHECK-NOT: InstanceFieldGet
 
   static int $noinline$testMonitorOperationRedundantStoreBlocking(TestClass obj) {
-    Main m = new Main();
-
     // This store must be kept due to the monitor operation.
     obj.j = 1;
-    synchronized (m) {}
+    synchronized (sLock) {}
     obj.j = 2;
 
     return obj.j;
@@ -592,12 +589,10 @@ public class Main {
   /// CHECK: InstanceFieldGet
 
   static int $noinline$testMonitorOperationRedundantStoreBlockingOnlyLoad(TestClass obj) {
-    Main m = new Main();
-
     // This store can be safely removed.
     obj.j = 1;
     obj.j = 2;
-    synchronized (m) {}
+    synchronized (sLock) {}
 
     // This load remains due to the monitor operation.
     return obj.j;
@@ -622,9 +617,7 @@ public class Main {
   /// CHECK-NOT: InstanceFieldGet
 
   static int $noinline$testMonitorOperationRedundantStoreBlockingExit(TestClass obj) {
-    Main m = new Main();
-
-    synchronized (m) {
+    synchronized (sLock) {
       // This store can be removed.
       obj.j = 0;
       // This store must be kept due to the monitor exit operation.
@@ -658,13 +651,11 @@ public class Main {
   /// CHECK-NOT: InstanceFieldGet
 
   static int $noinline$testMonitorOperationSetAndMergeValues(TestClass obj, boolean b) {
-    Main m = new Main();
-
     if (b) {
-      synchronized (m) {}
+      synchronized (sLock) {}
       obj.i = 1;
     } else {
-      synchronized (m) {}
+      synchronized (sLock) {}
       obj.i = 2;
     }
     return obj.i;
@@ -690,14 +681,45 @@ public class Main {
   /// CHECK: InstanceFieldGet
 
   static int $noinline$testMonitorOperationSetAndMergeValuesBlocking(TestClass obj, boolean b) {
-    Main m = new Main();
-
     if (b) {
       obj.i = 1;
     } else {
       obj.i = 2;
     }
-    synchronized (m) {}
+    synchronized (sLock) {}
     return obj.i;
   }
+
+  /// CHECK-START: int Main.$noinline$testMonitorOperationThreadLocalNotBlocking(TestClass) load_store_elimination (before)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.$noinline$testMonitorOperationThreadLocalNotBlocking(TestClass) load_store_elimination (before)
+  /// CHECK: MonitorOperation kind:enter
+  /// CHECK: MonitorOperation kind:exit
+
+  /// CHECK-START: int Main.$noinline$testMonitorOperationThreadLocalNotBlocking(TestClass) load_store_elimination (after)
+  /// CHECK-NOT: MonitorOperation
+
+  /// CHECK-START: int Main.$noinline$testMonitorOperationThreadLocalNotBlocking(TestClass) load_store_elimination (after)
+  /// CHECK:     InstanceFieldSet
+  /// CHECK-NOT: InstanceFieldSet
+
+  /// CHECK-START: int Main.$noinline$testMonitorOperationThreadLocalNotBlocking(TestClass) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+
+  // No other thread can lock an object that does not escape, so its monitor operations are
+  // removed and do not block LSE.
+  static int $noinline$testMonitorOperationThreadLocalNotBlocking(TestClass obj) {
+    Object m = new Object();
+
+    obj.j = 1;
+    synchronized (m) {}
+    obj.j = 2;
+
+    return obj.j;
+  }
+
+  static Object sLock = new Object();
 }
@@ -46,6 +46,15 @@ public class Main {
         $noinline$testStaticFieldSetsMultipleReceivers(new Object(), new Object(), new Object());
         $noinline$testArraySetsMultipleReceiversSameRTI();
 
+        // Card marks are also reused across blocks, as long as every path to the set goes through
+        // the dominating card mark and nothing in between can trigger GC.
+        $noinline$testInstanceFieldSetsAcrossBlocks(
+                new Main(), new Object(), new Object(), new Object(), true);
+        $noinline$testInstanceFieldSetsAcrossBlocks(
+                new Main(), new Object(), new Object(), new Object(), false);
+        $noinline$testStaticFieldSetsAcrossBlocks(new Object(), new Object(), new Object(), true);
+        $noinline$testStaticFieldSetsAcrossBlocks(new Object(), new Object(), new Object(), false);
+
         // The write barrier elimination optimization is blocked by invokes, suspend checks, and
         // instructions that can throw.
         $noinline$testInstanceFieldSetsBlocked(
@@ -248,6 +257,41 @@ public class Main {
         return array_of_arrays;
     }
 
+    /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsAcrossBlocks(Main, java.lang.Object, java.lang.Object, java.lang.Object, boolean) disassembly (after)
+    /// CHECK: InstanceFieldSet field_name:Main.inner field_type:Reference write_barrier_kind:EmitNoNullCheck
+    /// CHECK: InstanceFieldSet field_name:Main.inner2 field_type:Reference write_barrier_kind:DontEmit
+    /// CHECK: InstanceFieldSet field_name:Main.inner3 field_type:Reference write_barrier_kind:DontEmit
+
+    /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsAcrossBlocks(Main, java.lang.Object, java.lang.Object, java.lang.Object, boolean) disassembly (after)
+    /// CHECK: ; card_table
+    /// CHECK-NOT: ; card_table
+    private static Main $noinline$testInstanceFieldSetsAcrossBlocks(
+            Main m, Object o, Object o2, Object o3, boolean cond) {
+        m.inner = o;
+        if (cond) {
+            m.inner2 = o2;
+        }
+        m.inner3 = o3;
+        return m;
+    }
+
+    /// CHECK-START: void Main.$noinline$testStaticFieldSetsAcrossBlocks(java.lang.Object, java.lang.Object, java.lang.Object, boolean) disassembly (after)
+    /// CHECK: StaticFieldSet field_name:Main.inner_static field_type:Reference write_barrier_kind:EmitNoNullCheck
+    /// CHECK: StaticFieldSet field_name:Main.inner_static2 field_type:Reference write_barrier_kind:DontEmit
+    /// CHECK: StaticFieldSet field_name:Main.inner_static3 field_type:Reference write_barrier_kind:DontEmit
+
+    /// CHECK-START: void Main.$noinline$testStaticFieldSetsAcrossBlocks(java.lang.Object, java.lang.Object, java.lang.Object, boolean) disassembly (after)
+    /// CHECK: ; card_table
+    /// CHECK-NOT: ; card_table
+    private static void $noinline$testStaticFieldSetsAcrossBlocks(
+            Object o, Object o2, Object o3, boolean cond) {
+        inner_static = o;
+        if (cond) {
+            inner_static2 = o2;
+        }
+        inner_static3 = o3;
+    }
+
     private static void $noinline$emptyMethod() {}
 
     /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsBlocked(Main, java.lang.Object, java.lang.Object, java.lang.Object) disassembly (after)
@@ -289,8 +333,8 @@ public class Main {
         inner_static = o;
         $noinline$emptyMethod();
         inner_static2 = o2;
-        Main m = new Main();
-        synchronized (m) {
+        // Lock an object that escapes, the monitor operations of a thread-local one are removed.
+        synchronized (o) {
             inner_static3 = o3;
         }
     }
@@ -312,8 +356,8 @@ public class Main {
         arr[0] = inner_static;
         $noinline$emptyMethod();
         arr[1] = inner_static2;
-        Main m = new Main();
-        synchronized (m) {
+        // Lock an object that escapes, the monitor operations of a thread-local one are removed.
+        synchronized (arr) {
             arr[2] = inner_static3;
         }
         return arr;
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    public static void main(String[] args) {
+        int[] array = {1, 2, 3, 4, 5, 6, 7, 8};
+        assertEquals(4, $noinline$search(array, 5, array.length));
+        assertEquals(-1, $noinline$search(array, 9, array.length));
+        assertEquals(-1, $noinline$search(array, 5, 0));
+        assertEquals(-1, $noinline$search(array, 8, 7));
+
+        // Out of bounds accesses are still reported, by the original loop.
+        try {
+            $noinline$search(array, 9, 9);
+            throw new Error("Expected ArrayIndexOutOfBoundsException");
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+        try {
+            $noinline$search(null, 9, 1);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException expected) {
+        }
+        assertEquals(-1, $noinline$search(null, 9, 0));
+    }
+
+    // The early exit makes BCE keep the bounds check.
+
+    /// CHECK-START-ARM64: int Main.$noinline$search(int[], int, int) loop_optimization (before)
+    /// CHECK:     BoundsCheck
+    /// CHECK-NOT: BoundsCheck
+
+    /// CHECK-START-ARM64: int Main.$noinline$search(int[], int, int) loop_optimization (after)
+    /// CHECK-DAG: <<Null:l\d+>> NullConstant                        loop:none
+    /// CHECK-DAG:               Equal [<<Array:l\d+>>,<<Null>>]      loop:none
+    /// CHECK-DAG: <<Len:i\d+>>  ArrayLength [<<Array>>]              loop:none
+    /// CHECK-DAG:               AboveOrEqual [{{i\d+}},<<Len>>]      loop:none
+    //
+    /// CHECK-START-ARM64: int Main.$noinline$search(int[], int, int) loop_optimization (after)
+    /// CHECK:     BoundsCheck
+    /// CHECK-NOT: BoundsCheck
+    private static int $noinline$search(int[] array, int value, int n) {
+        for (int i = 0; i < n; i++) {
+            if (array[i] == value) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    private static void assertEquals(int expected, int result) {
+        if (expected != result) {
+            throw new Error("Expected: " + expected + ", found: " + result);
+        }
+    }
+}
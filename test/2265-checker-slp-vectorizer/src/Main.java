@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    public static void main(String[] args) {
+        int[] a = {1, 2, 3, 4};
+        int[] b = {10, 20, 30, 40};
+        int[] c = new int[4];
+        $noinline$add4(a, b, c);
+        assertEquals(11, c[0]);
+        assertEquals(22, c[1]);
+        assertEquals(33, c[2]);
+        assertEquals(44, c[3]);
+
+        // The result overlaps the inputs.
+        $noinline$add4(a, b, a);
+        assertEquals(11, a[0]);
+        assertEquals(22, a[1]);
+        assertEquals(33, a[2]);
+        assertEquals(44, a[3]);
+
+        int[] d = {1, 2, 3, 4, 5};
+        $noinline$propagate(d);
+        assertEquals(1, d[0]);
+        assertEquals(1, d[1]);
+        assertEquals(1, d[2]);
+        assertEquals(1, d[3]);
+        assertEquals(1, d[4]);
+
+        try {
+            $noinline$add4(a, b, new int[3]);
+            throw new Error("Expected ArrayIndexOutOfBoundsException");
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+    }
+
+    /// CHECK-START-ARM64: void Main.$noinline$add4(int[], int[], int[]) slp_vectorizer (before)
+    /// CHECK-NOT: VecStore
+    //
+    /// CHECK-START-ARM64: void Main.$noinline$add4(int[], int[], int[]) slp_vectorizer (after)
+    /// CHECK-DAG: <<LoadA:d\d+>> VecLoad                    packed_type:Int32
+    /// CHECK-DAG: <<LoadB:d\d+>> VecLoad                    packed_type:Int32
+    /// CHECK-DAG: <<Add:d\d+>>   VecAdd [<<LoadA>>,<<LoadB>>] packed_type:Int32
+    /// CHECK-DAG:                VecStore [{{l\d+}},{{i\d+}},<<Add>>] packed_type:Int32
+    //
+    /// CHECK-START-ARM64: void Main.$noinline$add4(int[], int[], int[]) slp_vectorizer (after)
+    /// CHECK-NOT: ArraySet
+    private static void $noinline$add4(int[] a, int[] b, int[] c) {
+        if (a.length < 4 || b.length < 4 || c.length < 4) {
+            throw new ArrayIndexOutOfBoundsException();
+        }
+        c[0] = a[0] + b[0];
+        c[1] = a[1] + b[1];
+        c[2] = a[2] + b[2];
+        c[3] = a[3] + b[3];
+    }
+
+    // Each store writes the element loaded next.
+    private static void $noinline$propagate(int[] d) {
+        if (d.length < 5) {
+            return;
+        }
+        d[1] = d[0];
+        d[2] = d[1];
+        d[3] = d[2];
+        d[4] = d[3];
+    }
+
+    private static void assertEquals(int expected, int result) {
+        if (expected != result) {
+            throw new Error("Expected: " + expected + ", found: " + result);
+        }
+    }
+}
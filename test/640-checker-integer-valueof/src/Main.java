@@ -48,6 +48,23 @@ public class Main {
     return Integer.valueOf(55555);
   }
 
+  /// CHECK-START: int Main.roundTrip(int) instruction_simplifier$after_inlining (before)
+  /// CHECK:                      InvokeStaticOrDirect method_name:java.lang.Integer.valueOf intrinsic:IntegerValueOf
+  /// CHECK:                      InstanceFieldGet field_name:java.lang.Integer.value
+
+  /// CHECK-START: int Main.roundTrip(int) instruction_simplifier$after_inlining (after)
+  /// CHECK: <<Arg:i\d+>>         ParameterValue
+  /// CHECK:                      Return [<<Arg>>]
+
+  /// CHECK-START: int Main.roundTrip(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-NOT:                  InstanceFieldGet field_name:java.lang.Integer.value
+
+  /// CHECK-START: int Main.roundTrip(int) dead_code_elimination$after_inlining (after)
+  /// CHECK-NOT:                  InvokeStaticOrDirect method_name:java.lang.Integer.valueOf
+  public static int roundTrip(int a) {
+    return Integer.valueOf(a).intValue();
+  }
+
   public static void main(String[] args) {
     assertEqual("42", foo(intField));
     assertEqual(foo(intField), foo(intField2));
@@ -65,6 +82,8 @@ public class Main {
     assertEqual("127", foo(intField127));
     assertEqual(foo(intField127), foo(intField127));
     assertEqual("128", foo(intField128));
+    assertEqual(42, roundTrip(intField));
+    assertEqual(55555, roundTrip(intField3));
   }
 
   static void assertEqual(String a, Integer b) {
@@ -73,6 +92,12 @@ public class Main {
     }
   }
 
+  static void assertEqual(int a, int b) {
+    if (a != b) {
+      throw new Error("Expected " + a + ", got " + b);
+    }
+  }
+
   static void assertEqual(Integer a, Integer b) {
     if (a != b) {
       throw new Error("Expected " + a + ", got " + b);
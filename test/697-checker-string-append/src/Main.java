@@ -25,6 +25,7 @@ public class Main {
         testMiscelaneous();
         testNoArgs();
         testInline();
+        testConstructors();
         testEquals();
         System.out.println("passed");
     }
@@ -405,8 +406,73 @@ public class Main {
         return $inline$testInlineInner(sb, s, i);
     }
 
+    public static void $inline$appendIf(StringBuilder sb, String s, boolean append) {
+        if (append) {
+            sb.append(s);
+        }
+    }
+
+    // The inlined method leaves the appends and the toString() in two blocks.
+    /// CHECK-START: java.lang.String Main.$noinline$testInlineAcrossBlocks(java.lang.String, int) instruction_simplifier$after_inlining (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$testInlineAcrossBlocks(java.lang.String, int) instruction_simplifier$after_inlining (before)
+    /// CHECK-DAG:              InvokeVirtual block:<<AppendBlock:B\d+>> intrinsic:StringBuilderAppendString
+    /// CHECK-DAG:              InvokeVirtual block:<<ToStringBlock:B\d+>> intrinsic:StringBuilderToString
+    /// CHECK-EVAL:             "<<AppendBlock>>" != "<<ToStringBlock>>"
+
+    /// CHECK-START: java.lang.String Main.$noinline$testInlineAcrossBlocks(java.lang.String, int) instruction_simplifier$after_inlining (after)
+    /// CHECK:                  StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$testInlineAcrossBlocks(java.lang.String, int) instruction_simplifier$after_inlining (after)
+    /// CHECK-NOT:              InvokeVirtual intrinsic:StringBuilderToString
+    public static String $noinline$testInlineAcrossBlocks(String s, int i) {
+        StringBuilder sb = new StringBuilder();
+        $inline$appendIf(sb, s, true);
+        return sb.append(i).toString();
+    }
+
     public static void testInline() {
         assertEquals("x42", $noinline$testInlineOuter("x", 42));
+        assertEquals("x42", $noinline$testInlineAcrossBlocks("x", 42));
+        assertEquals("null42", $noinline$testInlineAcrossBlocks(null, 42));
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendWithCapacity(java.lang.String, int) instruction_simplifier (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendWithCapacity(java.lang.String, int) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$appendWithCapacity(String s, int i) {
+        return new StringBuilder(64).append(s).append(i).toString();
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendWithInitialString(int) instruction_simplifier (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendWithInitialString(int) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$appendWithInitialString(int i) {
+        return new StringBuilder("x").append(i).toString();
+    }
+
+    // The argument may be null, in which case the constructor throws.
+    /// CHECK-START: java.lang.String Main.$noinline$appendWithNullableInitialString(java.lang.String, int) instruction_simplifier (after)
+    /// CHECK-NOT:              StringBuilderAppend
+    public static String $noinline$appendWithNullableInitialString(String s, int i) {
+        return new StringBuilder(s).append(i).toString();
+    }
+
+    public static void testConstructors() {
+        assertEquals("x42", $noinline$appendWithCapacity("x", 42));
+        assertEquals("null42", $noinline$appendWithCapacity(null, 42));
+        assertEquals("x42", $noinline$appendWithInitialString(42));
+        assertEquals("x42", $noinline$appendWithNullableInitialString("x", 42));
+        try {
+            $noinline$appendWithNullableInitialString(null, 42);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException expected) {
+        }
     }
 
     /// CHECK-START: java.lang.String Main.$noinline$appendNothing() instruction_simplifier (before)